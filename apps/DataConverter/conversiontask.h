@@ -8,6 +8,7 @@ namespace dataconverter {
 
 class ConversionTask {
 public:
+    virtual ~ConversionTask() = default;
     virtual void perform(const std::function<void(float)>& onProgress) = 0;
 };
 
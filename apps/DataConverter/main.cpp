@@ -23,14 +23,20 @@
  ****************************************************************************************/
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <glm/glm.hpp>
 
 #include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/cmdparser/commandlineparser.h>
+#include <ghoul/cmdparser/singlecommand.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/io/texture/texturereaderdevil.h>
 #include <ghoul/io/texture/texturereaderfreeimage.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/lua/ghoul_lua.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/dictionary.h>
 #include <ghoul/ghoul.h>
 
 #include <openspace/util/progressbar.h>
@@ -38,6 +44,21 @@
 #include <apps/DataConverter/milkywayconversiontask.h>
 #include <apps/DataConverter/milkywaypointsconversiontask.h>
 
+namespace {
+    const std::string KeyType = "Type";
+
+    const std::string KeyInFilename = "InFilename";
+    const std::string KeyInFilenamePrefix = "InFilenamePrefix";
+    const std::string KeyInFilenameSuffix = "InFilenameSuffix";
+    const std::string KeyInFirstIndex = "InFirstIndex";
+    const std::string KeyInNSlices = "InNSlices";
+    const std::string KeyOutFilename = "OutFilename";
+    const std::string KeyOutDimensions = "OutDimensions";
+
+    const std::string TypeMilkyWay = "MilkyWayConversionTask";
+    const std::string TypeMilkyWayPoints = "MilkyWayPointsConversionTask";
+}
+
 int main(int argc, char** argv) {
     using namespace openspace;
     using namespace dataconverter;
@@ -51,33 +72,87 @@ int main(int argc, char** argv) {
         ghoul::io::TextureReader::ref().addReader(std::make_shared<ghoul::io::TextureReaderFreeImage>());
     #endif // GHOUL_USE_FREEIMAGE
 
+    std::string taskFile;
+    int nThreads = 0;
+
+    ghoul::cmdparser::CommandlineParser parser(
+        "DataConverter", ghoul::cmdparser::CommandlineParser::AllowUnknownCommands::No
+    );
+    parser.addCommand(std::make_unique<ghoul::cmdparser::SingleCommand<std::string>>(
+        &taskFile, "-task", "-t",
+        "Provides the path to the Lua file describing the conversion task"
+    ));
+    parser.addCommand(std::make_unique<ghoul::cmdparser::SingleCommand<int>>(
+        &nThreads, "-threads", "-j",
+        "Sets the number of worker threads. Defaults to the number of hardware threads"
+    ));
+
+    std::vector<std::string> args(argv, argv + argc);
+    parser.setCommandLine(args);
+    bool showHelp = parser.execute();
+    if (showHelp || taskFile.empty()) {
+        parser.displayHelp();
+        return showHelp ? 0 : 1;
+    }
+
+    // A task file returns a table, for example:
+    // return {
+    //     Type = "MilkyWayConversionTask",
+    //     InFilenamePrefix = "volumeslices/cam2_main.",
+    //     InFilenameSuffix = ".exr",
+    //     InFirstIndex = 1385,
+    //     InNSlices = 512,
+    //     OutFilename = "mw_512_512_64.rawvolume",
+    //     OutDimensions = {512, 512, 64}
+    // }
+    ghoul::Dictionary task;
+    try {
+        ghoul::lua::loadDictionaryFromFile(absPath(taskFile), task);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        std::cout << "Could not load task file '" << taskFile << "': " <<
+            e.message << std::endl;
+        return 1;
+    }
+
     openspace::ProgressBar pb(100);
     std::function<void(float)> onProgress = [&](float progress) {
         pb.print(progress * 100);
     };
 
-    // TODO: Make the converter configurable using either
-    // config files (json, lua dictionaries),
-    // lua scripts,
-    // or at the very least: a command line interface.
- 
-    MilkyWayConversionTask mwConversionTask(
-        "F:/mw_june2016/volumeslices/img/comp/v003/frames/primary/0100/cam2_main.",
-        ".exr",
-        1385,
-        512,
-        "F:/mw_june2016/mw_512_512_64_june.rawvolume", 
-        glm::vec3(512, 512, 64));
-    
-    //MilkyWayPointsConversionTask mwpConversionTask("F:/mw_june2016/points.off", "F:/mw_june2016/points.off.binary");
-
-
-    mwConversionTask.perform(onProgress);
-    //mwpConversionTask.perform(onProgress);
+    std::unique_ptr<ConversionTask> conversionTask;
+    try {
+        std::string type = task.value<std::string>(KeyType);
+        if (type == TypeMilkyWay) {
+            conversionTask = std::make_unique<MilkyWayConversionTask>(
+                task.value<std::string>(KeyInFilenamePrefix),
+                task.value<std::string>(KeyInFilenameSuffix),
+                static_cast<size_t>(task.value<double>(KeyInFirstIndex)),
+                static_cast<size_t>(task.value<double>(KeyInNSlices)),
+                task.value<std::string>(KeyOutFilename),
+                glm::ivec3(task.value<glm::vec3>(KeyOutDimensions)),
+                nThreads
+            );
+        }
+        else if (type == TypeMilkyWayPoints) {
+            conversionTask = std::make_unique<MilkyWayPointsConversionTask>(
+                task.value<std::string>(KeyInFilename),
+                task.value<std::string>(KeyOutFilename)
+            );
+        }
+        else {
+            std::cout << "Unknown task type '" << type << "'" << std::endl;
+            return 1;
+        }
+    }
+    catch (const ghoul::RuntimeError& e) {
+        std::cout << "Invalid task file '" << taskFile << "': " <<
+            e.message << std::endl;
+        return 1;
+    }
 
+    conversionTask->perform(onProgress);
 
     std::cout << "Done." << std::endl;
-
-    std::cin.get();
     return 0;
 };
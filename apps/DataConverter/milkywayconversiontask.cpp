@@ -1,7 +1,11 @@
 #include <apps/DataConverter/milkywayconversiontask.h>
-#include <modules/volume/textureslicevolumereader.h>
-#include <modules/volume/rawvolumewriter.h>
-#include <modules/volume/volumesampler.h>
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/slicestackresampler.h>
+
+#include <ghoul/io/texture/texturereader.h>
+#include <ghoul/opengl/texture.h>
+
+#include <iostream>
 
 namespace openspace {
 namespace dataconverter {
@@ -12,13 +16,15 @@ MilkyWayConversionTask::MilkyWayConversionTask(
     size_t inFirstIndex,
     size_t inNSlices, 
     const std::string& outFilename,
-    const glm::ivec3& outDimensions)
+    const glm::ivec3& outDimensions,
+    int nThreads)
     : _inFilenamePrefix(inFilenamePrefix)
     , _inFilenameSuffix(inFilenameSuffix)
     , _inFirstIndex(inFirstIndex)
     , _inNSlices(inNSlices)
     , _outFilename(outFilename)
-    , _outDimensions(outDimensions) {}
+    , _outDimensions(outDimensions)
+    , _nThreads(nThreads) {}
 
     
 void MilkyWayConversionTask::perform(const std::function<void(float)>& onProgress) {
@@ -27,23 +33,60 @@ void MilkyWayConversionTask::perform(const std::function<void(float)>& onProgres
         filenames.push_back(_inFilenamePrefix + std::to_string(i + _inFirstIndex) + _inFilenameSuffix);
     }
     
-    TextureSliceVolumeReader<glm::tvec4<GLfloat>> sliceReader(filenames, _inNSlices, 10);
-    sliceReader.initialize();
+    using VoxelType = glm::tvec4<GLfloat>;
 
-    RawVolumeWriter<glm::tvec4<GLfloat>> rawWriter(_outFilename);
-    rawWriter.setDimensions(_outDimensions);
+    std::unique_ptr<ghoul::opengl::Texture> firstSlice =
+        ghoul::io::TextureReader::ref().loadTexture(filenames[0]);
+    if (!firstSlice) {
+        std::cout << "Failed to load slice " << filenames[0] << std::endl;
+        return;
+    }
+    glm::ivec2 sliceDimensions = firstSlice->dimensions().xy();
+    firstSlice = nullptr;
 
-    glm::vec3 resolutionRatio =
-        static_cast<glm::vec3>(sliceReader.dimensions()) / static_cast<glm::vec3>(rawWriter.dimensions());
+    // Slices are copied out of the decoded textures, so that the texture memory is
+    // released right away and only the slices in the sampler footprint are kept
+    auto loadSlice = [&filenames](size_t sliceIndex) {
+        std::unique_ptr<RawVolume<VoxelType>> slice;
+        std::unique_ptr<ghoul::opengl::Texture> texture =
+            ghoul::io::TextureReader::ref().loadTexture(filenames[sliceIndex]);
+        if (!texture) {
+            std::cout << "Failed to load slice " << filenames[sliceIndex] << std::endl;
+            return slice;
+        }
 
-    VolumeSampler<TextureSliceVolumeReader<glm::tvec4<GLfloat>>> sampler(sliceReader, resolutionRatio);
-    std::function<glm::tvec4<GLfloat>(glm::ivec3)> sampleFunction = [&](glm::ivec3 outCoord) {
-        glm::vec3 inCoord = ((glm::vec3(outCoord) + glm::vec3(0.5)) * resolutionRatio) - glm::vec3(0.5);
-        glm::tvec4<GLfloat> value = sampler.sample(inCoord);
-        return value;
+        glm::ivec2 dims = texture->dimensions().xy();
+        slice = std::make_unique<RawVolume<VoxelType>>(glm::ivec3(dims, 1));
+        for (int y = 0; y < dims.y; y++) {
+            for (int x = 0; x < dims.x; x++) {
+                slice->set(glm::ivec3(x, y, 0), texture->texel<VoxelType>(glm::ivec2(x, y)));
+            }
+        }
+        return slice;
     };
 
-    rawWriter.write(sampleFunction, onProgress);
+    SliceStackResampler<VoxelType> resampler(
+        loadSlice,
+        sliceDimensions,
+        filenames.size(),
+        _outDimensions
+    );
+    SliceStackResampler<VoxelType>::Statistics stats =
+        resampler.resample(_outFilename, _nThreads, onProgress);
+
+    const size_t nVoxels = static_cast<size_t>(_outDimensions.x) *
+        static_cast<size_t>(_outDimensions.y) *
+        static_cast<size_t>(_outDimensions.z);
+    if (stats.nVoxelsWritten < nVoxels) {
+        std::cout << "Conversion aborted after " << stats.nVoxelsWritten << " of " <<
+            nVoxels << " voxels." << std::endl;
+    }
+
+    std::cout << std::endl << "Resampled " << stats.nSlicesLoaded << " slices into " <<
+        stats.nVoxelsWritten << " voxels in " << stats.seconds << " s using " <<
+        stats.nThreads << " threads (" <<
+        stats.nVoxelsWritten / stats.seconds / 1e6 << " MVoxels/s, " <<
+        stats.nSlicesLoaded / stats.seconds << " slices/s)" << std::endl;
 }
 
 }
@@ -23,7 +23,8 @@ public:
                            size_t inFirstIndex,
                            size_t inNSlices, 
                            const std::string& outFilename,
-                           const glm::ivec3& outDimensions);
+                           const glm::ivec3& outDimensions,
+                           int nThreads = 0);
     
     void perform(const std::function<void(float)>& onProgress) override;
 private:
@@ -33,6 +34,7 @@ private:
     size_t _inNSlices;
     std::string _outFilename;
     glm::ivec3 _outDimensions;
+    int _nThreads;
 };
 
 }
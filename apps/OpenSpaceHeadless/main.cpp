@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/headlesswindowwrapper.h>
+
+#include <ghoul/cmdparser/commandlineparser.h>
+#include <ghoul/cmdparser/singlecommand.h>
+#include <ghoul/logging/logmanager.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::string _loggerCat = "main";
+}
+
+// Runs the OpenSpaceEngine without a window and without an OpenGL context, for example
+// to benchmark the update paths on a build server. The usual OpenSpace commandline
+// arguments are supported as well, so a recorded session can be played back with
+// -playback and -timings, in which case the application exits at the end of the session
+int main(int argc, char** argv) {
+    int nFrames = 0;
+    double deltaTime = 1.0 / 60.0;
+
+    // The remaining arguments are parsed by the OpenSpaceEngine
+    using ghoul::cmdparser::CommandlineParser;
+    CommandlineParser parser(
+        "OpenSpaceHeadless",
+        CommandlineParser::AllowUnknownCommands::Yes
+    );
+    parser.addCommand(std::make_unique<ghoul::cmdparser::SingleCommand<int>>(
+        &nFrames, "-frames", "-n",
+        "Sets the number of frames that are run. If it is 0, which is the default, the "
+        "frames are run until the application is closed, for example at the end of a "
+        "playback"
+    ));
+    parser.addCommand(std::make_unique<ghoul::cmdparser::SingleCommand<double>>(
+        &deltaTime, "-deltaTime", "-dt",
+        "Sets the synthetic duration of every frame in seconds. Defaults to 1/60"
+    ));
+
+    std::vector<std::string> args(argv, argv + argc);
+    parser.setCommandLine(args);
+    parser.execute();
+    if (nFrames < 0 || deltaTime <= 0.0) {
+        parser.displayHelp();
+        return EXIT_FAILURE;
+    }
+
+    auto windowWrapper = std::make_unique<openspace::HeadlessWindowWrapper>(
+        glm::ivec2(1280, 720),
+        deltaTime
+    );
+    openspace::HeadlessWindowWrapper* window = windowWrapper.get();
+
+    std::vector<std::string> remainingArguments;
+    const bool success = openspace::OpenSpaceEngine::create(
+        argc, argv,
+        std::move(windowWrapper),
+        remainingArguments
+    );
+    if (!success)
+        return EXIT_FAILURE;
+
+    // There is no cluster, so this is always the master node
+    OsEng.setMaster(true);
+    if (!OsEng.initialize() || !OsEng.initializeGL()) {
+        LFATAL("Initializing OpenSpaceEngine failed");
+        openspace::OpenSpaceEngine::destroy();
+        return EXIT_FAILURE;
+    }
+
+    LDEBUG("Starting headless loop");
+    int nRunFrames = window->run(nFrames);
+    LINFO("Finished after " << nRunFrames << " frames");
+
+    LDEBUG("Destroying OpenSpaceEngine");
+    openspace::OpenSpaceEngine::destroy();
+    return EXIT_SUCCESS;
+}
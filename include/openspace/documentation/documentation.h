@@ -286,6 +286,23 @@ struct Documentation {
 TestResult testSpecification(const Documentation& documentation,
     const ghoul::Dictionary& dictionary);
 
+/**
+ * This method tests whether the table that is stored at the \p location in the
+ * \p dictionary adheres to the specification \p documentation and adds all offenses and
+ * warnings to the \p result. TestResult::success of the \p result is set to \c false if
+ * an offense was found, but is never set to \c true. The table is accessed in place
+ * through fully qualified keys instead of being copied, so all offenders are reported
+ * with their fully qualified keys. This method is used by the Verifier%s that test
+ * nested tables.
+ * \param documentation The Documentation that the table is tested against
+ * \param dictionary The ghoul::Dictionary that contains the table
+ * \param location The fully qualified key of the table inside the \p dictionary, or the
+ * empty string if the \p dictionary itself is tested
+ * \param result The TestResult to which the offenses and warnings are added
+ */
+void testSpecification(const Documentation& documentation,
+    const ghoul::Dictionary& dictionary, const std::string& location, TestResult& result);
+
 /**
 * This method tests whether a provided ghoul::Dictionary \p dictionary adheres to the
 * specification \p documentation. If the \p dictionary does not adhere to the
@@ -30,6 +30,8 @@
 #include <ghoul/designpattern/singleton.h>
 #include <ghoul/misc/exception.h>
 
+#include <unordered_map>
+
 namespace openspace {
 namespace documentation {
 
@@ -83,6 +85,16 @@ public:
      */
     std::vector<Documentation> documentations() const;
 
+    /**
+     * Returns the registered Documentation with the provided \p identifier without
+     * copying it. The returned pointer is invalidated by the next call to
+     * addDocumentation.
+     * \param identifier The identifier of the requested Documentation
+     * \return The Documentation with the \p identifier, or \c nullptr if no such
+     * Documentation has been registered
+     */
+    const Documentation* documentation(const std::string& identifier) const;
+
     /**
      * Returns a static reference to the main singleton DocumentationEngine
      * \return A static reference to the main singleton DocumentationEngine
@@ -92,6 +104,8 @@ public:
 private:
     /// The list of all Documentation%s that are stored by the DocumentationEngine
     std::vector<Documentation> _documentations;
+    /// The indices into _documentations of all Documentation%s with an identifier
+    std::unordered_map<std::string, size_t> _documentationIndices;
 };
 
 } // namespace documentation
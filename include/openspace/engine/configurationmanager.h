@@ -67,6 +67,8 @@ public:
     static const std::string KeyDocumentation;
     /// The key that stores the factory documentation values
     static const std::string KeyFactoryDocumentation;
+    /// The key that stores the file to which the startup timeline is written
+    static const std::string KeyStartupTimeline;
     /// The key that stores the location of the scene file that is initially loaded
     static const std::string KeyConfigScene;
     /// The key that stores the subdirectory containing a list of all startup scripts to
@@ -64,6 +64,12 @@ public:
         size_t size;
         std::string format;
         bool corrupted;
+        // The validators of the response, which can be passed to a conditional request
+        std::string etag;
+        std::string lastModified;
+        // false if a conditional request found the file unchanged; buffer is empty then
+        bool isModified;
+        std::string errorMessage;
     };
 
     using DownloadProgressCallback = std::function<void(const FileFuture&)>;
@@ -96,6 +102,21 @@ public:
     const std::string& url,
     SuccessCallback successCallback = SuccessCallback(), ErrorCallback errorCallback = ErrorCallback());
 
+    /**
+     * Downloads the file at \p url into memory on the calling thread. If the \p etag or
+     * the \p lastModified value of a previous response are passed, the server is asked
+     * to only send the file if it has changed since then. If it has not changed, the
+     * returned MemoryFile has <code>isModified</code> set to <code>false</code> and an
+     * empty buffer. The buffer has to be released with <code>free</code>.
+     * \param url The URL of the file that is downloaded
+     * \param etag The <code>ETag</code> header of a previous response, or empty
+     * \param lastModified The <code>Last-Modified</code> header of a previous response,
+     * or empty
+     * \return The downloaded file, which is <code>corrupted</code> if the download failed
+     */
+    static MemoryFile fetchFileBlocking(const std::string& url,
+        const std::string& etag = "", const std::string& lastModified = "");
+
     std::vector<std::shared_ptr<FileFuture>> downloadRequestFiles(const std::string& identifier,
         const ghoul::filesystem::Directory& destination, int version,
         bool overrideFiles = true,
@@ -33,6 +33,9 @@
 
 namespace openspace {
 
+class JobManager;
+class StartupTimeline;
+
 /**
  * The ModuleEngine is the central repository for registering and accessing
  * OpenSpaceModule for the current application run. By initializing (#initialize) the
@@ -40,37 +43,75 @@ namespace openspace {
  * <code>moduleregistration.h</code> file is automatically registered and created.
  * Additional OpenSpaceModule%s can be registered with the #registerModule function, which
  * will internally call the OpenSpaceModule::initialize method.
+ *
+ * OpenSpaceModule%s declare the modules they depend on through
+ * OpenSpaceModule::requiredModules. When a set of modules is registered at once, each
+ * module is prepared (OpenSpaceModule::prepare) on a worker thread as soon as all of its
+ * required modules are initialized, and it is then initialized
+ * (OpenSpaceModule::initialize) on the main thread. Independent modules are thus
+ * prepared concurrently, while all initializations happen on the main thread in a fixed
+ * order that respects the dependencies.
  */
 class ModuleEngine {
 public:
     /**
      * Registers all of the OpenSpaceModule%s which are created by the CMake configuration
      * and stored in the <code>moduleregistration.h</code> file. For all of those modules
-     * the OpenSpaceModule::initialize method with will called.
+     * the OpenSpaceModule::prepare and OpenSpaceModule::initialize methods will be called
+     * as described in #registerModules.
+     * \param jobManager The JobManager whose workers prepare the modules
+     * \param timeline If this is not <code>nullptr</code>, the duration of each module's
+     * preparation and initialization is recorded in this StartupTimeline
      * \throw ghoul::RuntimeError If two modules in the default modules have the same
-     * name
+     * name or if the dependencies between the modules cannot be resolved
     */
-    void initialize();
+    void initialize(JobManager& jobManager, StartupTimeline* timeline = nullptr);
     
     /**
      * Deinitializes all of the contained OpenSpaceModule%s by calling the
-     * OpenSpaceModule::deinitialize methods.
+     * OpenSpaceModule::deinitialize methods in the reverse order of their
+     * initialization.
      */
     void deinitialize();
 
     /**
-     * Registers the passed \p module with this ModuleEngine. The OpenSpaceModule::create
-     * method will be called on the \p module in the process.
+     * Registers the passed \p module with this ModuleEngine. The
+     * OpenSpaceModule::prepare and OpenSpaceModule::initialize methods will be called on
+     * the \p module in the process on the calling thread.
      * \param module The OpenSpaceModule that is to be registered
      * \throw ghoul::RuntimeError If the name of the \p module was already registered 
-     * previously
+     * previously or if one of its required modules has not been registered
      * \pre \p module must not be nullptr
      */
     void registerModule(std::unique_ptr<OpenSpaceModule> module);
+
+    /**
+     * Registers all passed \p modules with this ModuleEngine. The required modules of
+     * each module have to be either part of the \p modules or registered previously.
+     * Each module is prepared on one of the workers of the \p jobManager as soon as all
+     * of its required modules are initialized and is initialized on the calling thread
+     * after its preparation has finished. The modules are initialized in the order in
+     * which they are passed, except that a module is moved behind the modules it
+     * requires; this order does not depend on how long the preparations take. This
+     * method returns after all \p modules are initialized.
+     * \param modules The OpenSpaceModule%s that are to be registered
+     * \param jobManager The JobManager whose workers prepare the modules
+     * \param timeline If this is not <code>nullptr</code>, the duration of each module's
+     * preparation and initialization is recorded in this StartupTimeline
+     * \throw ghoul::RuntimeError If the name of a module was registered before, if a
+     * required module is not available, or if the modules depend on each other
+     * cyclically. In these cases, none of the \p modules are registered
+     * \throw ghoul::RuntimeError If the preparation or initialization of a module
+     * failed. The modules that were initialized before the error are kept registered
+     * \pre No element of \p modules must be nullptr
+     */
+    void registerModules(std::vector<std::unique_ptr<OpenSpaceModule>> modules,
+        JobManager& jobManager, StartupTimeline* timeline = nullptr);
     
     /**
      * Returns a list of all registered OpenSpaceModule%s that have been registered with
-     * this ModuleEngine. All returned OpenSpaceModule%s are guaranteed to be initialized.
+     * this ModuleEngine. All returned OpenSpaceModule%s are guaranteed to be initialized
+     * and are returned in the order in which they were initialized.
      * \return A list of all registered OpenSpaceModule%s
      */
     std::vector<OpenSpaceModule*> modules() const;
@@ -82,7 +123,10 @@ public:
     static scripting::LuaLibrary luaLibrary();
 
 private:
-    /// The list of all registered OpenSpaceModule%s
+    /// Returns whether a module with the \p name has been registered
+    bool isRegistered(const std::string& name) const;
+
+    /// The list of all registered OpenSpaceModule%s in the order of their initialization
     std::vector<std::unique_ptr<OpenSpaceModule>> _modules;
 };
 
@@ -30,6 +30,7 @@
 
 #include <ghoul/glm.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -44,6 +45,7 @@ namespace openspace {
 
 class ConfigurationManager;
 class DownloadManager;
+class JobManager;
 class LuaConsole;
 class NetworkEngine;
 class GUI;
@@ -51,9 +53,12 @@ class RenderEngine;
 class ModuleEngine;
 class WindowWrapper;
 class SettingsEngine;
+class StartupTimeline;
 class SyncEngine;
+class TextureCache;
 
 namespace interaction { class InteractionHandler; }
+namespace interaction { class SessionRecording; }
 namespace gui { class GUI; }
 //namespace scripting { class ScriptEngine; }
 namespace network { class ParallelConnection; }
@@ -79,6 +84,7 @@ public:
     // Guaranteed to return a valid pointer
     ConfigurationManager& configurationManager();
     interaction::InteractionHandler& interactionHandler();
+    interaction::SessionRecording& sessionRecording();
     RenderEngine& renderEngine();
     scripting::ScriptEngine& scriptEngine();
     scripting::ScriptScheduler& scriptScheduler();
@@ -90,6 +96,8 @@ public:
     WindowWrapper& windowWrapper();
     ghoul::fontrendering::FontManager& fontManager();
     DownloadManager& downloadManager();
+    JobManager& jobManager();
+    TextureCache& textureCache();
 
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
     gui::GUI& gui();
@@ -141,6 +149,7 @@ private:
     // Components
     std::unique_ptr<ConfigurationManager> _configurationManager;
     std::unique_ptr<interaction::InteractionHandler> _interactionHandler;
+    std::unique_ptr<interaction::SessionRecording> _sessionRecording;
     std::unique_ptr<RenderEngine> _renderEngine;
     std::unique_ptr<scripting::ScriptEngine> _scriptEngine;
     std::unique_ptr<scripting::ScriptScheduler> _scriptScheduler;
@@ -151,6 +160,8 @@ private:
     std::unique_ptr<ModuleEngine> _moduleEngine;
     std::unique_ptr<SettingsEngine> _settingsEngine;
     std::unique_ptr<DownloadManager> _downloadManager;
+    std::unique_ptr<JobManager> _jobManager;
+    std::unique_ptr<TextureCache> _textureCache;
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
     std::unique_ptr<gui::GUI> _gui;
 #endif
@@ -158,6 +169,10 @@ private:
     std::unique_ptr<WindowWrapper> _windowWrapper;
     std::unique_ptr<ghoul::fontrendering::FontManager> _fontManager;
 
+    // Records the startup phases until the first frame has been rendered and is reset
+    // after the timeline was written to disk
+    std::unique_ptr<StartupTimeline> _startupTimeline;
+
     // Others
     std::unique_ptr<properties::PropertyOwner> _globalPropertyNamespace;
     
@@ -172,9 +187,15 @@ private:
     // The current state of the countdown; if it reaches '0', the application will close
     float _shutdownCountdown;
 
+    // Whether the session playback was requested on the commandline, in which case the
+    // application is closed once the playback has finished
+    bool _terminateAfterPlayback;
+
     // The first frame might take some more time in the update loop, so we need to know to
     // disable the synchronization; otherwise a hardware sync will kill us after 1 sec
     bool _isFirstRenderingFirstFrame;
+    // The time at which the first frame started; used for the startup timeline
+    std::chrono::steady_clock::time_point _firstFrameStart;
 
     static OpenSpaceEngine* _engine;
 };
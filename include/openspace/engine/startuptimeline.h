@@ -0,0 +1,123 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __STARTUPTIMELINE_H__
+#define __STARTUPTIMELINE_H__
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The StartupTimeline records how long each phase of the application startup took and on
+ * which thread it was executed. Phases can be recorded from any thread; all times are
+ * measured relative to the creation of the StartupTimeline, which is considered to be
+ * the main thread. The timeline can be written to disk as a JSON file so that startup
+ * times can be compared between launches.
+ */
+class StartupTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        /// The name of the phase, for example the name of a module
+        std::string name;
+        /// The category of the phase, for example <code>Module Initialization</code>
+        std::string category;
+        /// Whether the phase was executed on the thread that created the timeline
+        bool isMainThread;
+        /// The start time relative to the creation of the timeline
+        std::chrono::microseconds start;
+        /// The duration of the phase
+        std::chrono::microseconds duration;
+    };
+
+    /**
+     * Records the lifetime of this object as a single phase in the StartupTimeline. If
+     * the StartupTimeline is <code>nullptr</code>, nothing is recorded.
+     */
+    class ScopedPhase {
+    public:
+        ScopedPhase(StartupTimeline* timeline, std::string name, std::string category);
+        ~ScopedPhase();
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+        StartupTimeline* _timeline;
+        std::string _name;
+        std::string _category;
+        Clock::time_point _begin;
+    };
+
+    /// Creates an empty StartupTimeline, whose origin is the current time
+    StartupTimeline();
+
+    /**
+     * Adds a phase that was executed on the calling thread between \p begin and
+     * \p end. This method is thread-safe.
+     * \param name The name of the phase
+     * \param category The category to which the phase belongs
+     * \param begin The time at which the phase started
+     * \param end The time at which the phase finished
+     * \pre \p begin must not be later than \p end
+     */
+    void addPhase(std::string name, std::string category, Clock::time_point begin,
+        Clock::time_point end);
+
+    /**
+     * Returns all phases that have been recorded so far, sorted by their start time.
+     * This method is thread-safe.
+     */
+    std::vector<Entry> entries() const;
+
+    /// Returns the time that passed since the creation of this StartupTimeline
+    std::chrono::microseconds elapsed() const;
+
+    /**
+     * Writes the recorded phases as a JSON object to the file \p filename, replacing
+     * any previous file. The object contains the total elapsed time and one object per
+     * phase with its <code>name</code>, <code>category</code>, <code>thread</code>,
+     * <code>start</code>, and <code>duration</code>; all times are in microseconds.
+     * \param filename The file to which the timeline is written
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    void writeJson(const std::string& filename) const;
+
+private:
+    Clock::time_point _origin;
+    std::thread::id _mainThread;
+
+    mutable std::mutex _mutex;
+    std::vector<Entry> _entries;
+};
+
+} // namespace openspace
+
+#endif // __STARTUPTIMELINE_H__
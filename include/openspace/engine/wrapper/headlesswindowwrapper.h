@@ -0,0 +1,102 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __HEADLESSWINDOWWRAPPER_H__
+#define __HEADLESSWINDOWWRAPPER_H__
+
+#include <openspace/engine/wrapper/windowwrapper.h>
+
+#include <functional>
+
+namespace openspace {
+
+/**
+ * WindowWrapper subclass that neither opens a window nor creates an OpenGL context. The
+ * OpenSpaceEngine skips all OpenGL work while it is running with a headless window,
+ * which allows the update, synchronization, and I/O paths to run on machines without a
+ * display or a GPU. In place of the windowing framework, the HeadlessWindowWrapper also
+ * drives the frames of the engine, using a synthetic, fixed frame time instead of the
+ * wall-clock time so that runs are reproducible.
+ */
+class HeadlessWindowWrapper : public WindowWrapper {
+public:
+    /// Called before each frame with the number of the frame
+    using FrameCallback = std::function<void(int)>;
+
+    /**
+     * Creates a headless window with a virtual framebuffer of size \p resolution, whose
+     * frames all take \p deltaTime seconds.
+     * \param resolution The resolution of the virtual framebuffer
+     * \param deltaTime The synthetic frame time in seconds
+     * \pre \p deltaTime must be positive
+     */
+    explicit HeadlessWindowWrapper(glm::ivec2 resolution = glm::ivec2(1280, 720),
+        double deltaTime = 1.0 / 60.0);
+
+    /**
+     * Runs the frames of the OpenSpaceEngine in the same order in which SGCT calls them
+     * on a master node: preSynchronization, encode, postSynchronizationPreDraw, render,
+     * and postDraw. The runtime of the engine advances by the synthetic frame time in
+     * every frame. The engine has to be initialized before this method is called.
+     * \param nFrames The number of frames to run. If it is <code>0</code>, frames are
+     *        run until #terminate is called, for example at the end of a playback
+     * \param beforeFrame If set, this callback is invoked before every frame, for
+     *        example to place the camera. If it calls #terminate, the frame is not run
+     * \return The number of frames that were run
+     * \pre \p nFrames must not be negative
+     */
+    int run(int nFrames, FrameCallback beforeFrame = FrameCallback());
+
+    /// Returns the number of frames that have been run so far
+    int frameNumber() const;
+
+    /// Returns whether #terminate has been called
+    bool isTerminated() const;
+
+    void terminate() override;
+
+    double averageDeltaTime() const override;
+    double deltaTime() const override;
+    glm::ivec2 currentWindowSize() const override;
+
+    bool isHeadless() const override;
+
+    glm::mat4 viewProjectionMatrix() const override;
+    void setNearFarClippingPlane(float near, float far) override;
+
+private:
+    glm::mat4 projectionMatrix() const;
+
+    glm::ivec2 _resolution;
+    double _deltaTime;
+    float _nearClippingPlane;
+    float _farClippingPlane;
+
+    int _frameNumber;
+    bool _isTerminated;
+};
+
+} // namespace openspace
+
+#endif // __HEADLESSWINDOWWRAPPER_H__
@@ -179,6 +179,14 @@ public:
     */
     virtual bool isSwapGroupMaster() const;
 
+    /**
+     * Returns <code>true</code> if there is neither a window nor an OpenGL context, in
+     * which case all OpenGL work has to be skipped. On default, this method returns
+     * <code>false</code>.
+     * \return Whether the application is running without an OpenGL context
+     */
+    virtual bool isHeadless() const;
+
     /**
      * Returns the currently employed view-projection matrix. On default, this method will
      * return the identity matrix.
@@ -28,6 +28,7 @@
 #include <openspace/scripting/scriptengine.h>
 
 #include <openspace/util/keys.h>
+#include <openspace/util/prefixindex.h>
 
 #include <string>
 #include <vector>
@@ -51,14 +52,44 @@ public:
     bool isVisible() const;
     void setVisible(bool visible);
     void toggleVisibility();
+
+    /// Returns the query of the reverse history search, which is empty if no search is
+    /// active
+    const std::string& historySearchQuery() const;
         
     static scripting::LuaLibrary luaLibrary();
 
 
 private:
+    enum class CompletionType {
+        LuaFunction,
+        PropertyUri
+    };
+
     void addToCommand(std::string c);
     std::string UnicodeToUTF8(unsigned int codepoint);
 
+    /**
+     * Replaces the current command with the next completion of the token that starts at
+     * \p tokenStart in the value that was entered before the autocompletion started.
+     * Entries of the \p index that have been used in previous presses of TAB are
+     * skipped.
+     */
+    void autoComplete(const PrefixIndex& index, size_t tokenStart, CompletionType type);
+
+    /// Returns the index of all property URIs, rebuilding it if the scene has changed
+    const PrefixIndex& propertyIndex();
+
+    /**
+     * Handles the \p key while the reverse history search is active.
+     * \return <code>true</code> if the key was consumed by the search,
+     * <code>false</code> if it should be handled as a regular key
+     */
+    bool historySearchKeyboardCallback(Key key, KeyModifier modifier);
+
+    /// Searches the history for the query, starting at \p start and going backwards
+    void updateHistorySearch(int start);
+
     size_t _inputPosition;
     std::vector<std::string> _commandsHistory;
     size_t _activeCommand;
@@ -72,6 +103,17 @@ private:
         std::string initialValue;
     } _autoCompleteInfo;
 
+    PrefixIndex _propertyIndex;
+    uint64_t _propertyIndexVersion;
+    bool _hasPropertyIndex;
+
+    struct {
+        bool isActive;
+        std::string query;
+        // The index into _commandsHistory of the current match or NoMatch
+        int match;
+    } _historySearch;
+
     bool _isVisible;
 };
 
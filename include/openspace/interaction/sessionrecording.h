@@ -0,0 +1,224 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __SESSIONRECORDING_H__
+#define __SESSIONRECORDING_H__
+
+#include <ghoul/glm.h>
+#include <ghoul/misc/exception.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+namespace scripting { struct LuaLibrary; }
+
+namespace interaction {
+
+/**
+ * The SessionRecording records the state that determines the content of a frame, namely
+ * the camera pose, the simulation time, the simulation delta time, and the scripts that
+ * were executed, into a compact binary session file. A recorded session can be played
+ * back frame-locked, that is, every recorded frame drives exactly one rendered frame,
+ * independent of how long the frames take on the machine that plays the session back.
+ * This makes a performance scenario reproducible between different builds.
+ *
+ * While a session is played back, components can report how long their stages took in
+ * every frame using the StageTimer; these timings are written to a CSV file with one row
+ * per frame and one column per stage when the playback ends.
+ *
+ * The session file starts with the magic number <code>OSSR</code> and a version,
+ * followed by the frames, which are appended while the session is being recorded. A
+ * frame that was only partially written, for example because the application crashed,
+ * is dropped when the file is loaded.
+ */
+class SessionRecording {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct SessionRecordingError : public ghoul::RuntimeError {
+        explicit SessionRecordingError(std::string msg);
+    };
+
+    enum class State {
+        Idle = 0,
+        Recording,
+        Playback
+    };
+
+    struct Frame {
+        /// The simulation time in seconds past the J2000 epoch
+        double simulationTime = 0.0;
+        /// The number of simulation seconds that pass per real-time second
+        double simulationDeltaTime = 0.0;
+        /// The wall-clock duration of the frame when it was recorded, in seconds
+        double frameTime = 0.0;
+        glm::dvec3 cameraPosition;
+        glm::dquat cameraRotation;
+        /// The scripts that were executed in this frame
+        std::vector<std::string> scripts;
+    };
+
+    /**
+     * Records the lifetime of this object as the duration of the stage \p stage in the
+     * current playback frame. If the SessionRecording is not playing back a session,
+     * nothing is measured.
+     */
+    class StageTimer {
+    public:
+        /**
+         * \param recording The SessionRecording that receives the measured time
+         * \param stage The name of the stage, which is used as the column in the timing
+         *        file. It has to outlive this StageTimer and is usually a literal
+         */
+        StageTimer(SessionRecording& recording, const char* stage);
+        ~StageTimer();
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        SessionRecording* _recording;
+        const char* _stage;
+        Clock::time_point _begin;
+    };
+
+    SessionRecording();
+    ~SessionRecording();
+
+    State state() const;
+    bool isRecording() const;
+    bool isPlayingBack() const;
+
+    /**
+     * Starts recording a new session into the file \p filename, replacing any previous
+     * file. Each call to #recordFrame appends one frame to the file.
+     * \param filename The file into which the session is recorded
+     * \pre The SessionRecording must be State::Idle
+     * \throw SessionRecordingError If the file could not be created
+     */
+    void startRecording(const std::string& filename);
+
+    /**
+     * Appends the \p frame to the session that is currently being recorded. Scripts
+     * that control the session recording itself are not recorded, as they would start or
+     * stop a recording or playback when the session is played back.
+     * \pre The SessionRecording must be State::Recording
+     */
+    void recordFrame(const Frame& frame);
+
+    /// Closes the session file that is being recorded; does nothing if not recording
+    void stopRecording();
+
+    /**
+     * Loads the session from \p filename and starts playing it back. If \p timingsFile
+     * is not empty, the timings of each played back frame are written to that file as
+     * CSV when the playback ends.
+     * \param filename The session file that is played back
+     * \param timingsFile The CSV file that receives the per-frame timings
+     * \pre The SessionRecording must be State::Idle
+     * \throw SessionRecordingError If the session could not be loaded or is empty
+     */
+    void startPlayback(const std::string& filename, std::string timingsFile = "");
+
+    /**
+     * Starts the next frame of the playback and returns its recorded state. Every call
+     * has to be followed by a call to #endPlaybackFrame.
+     * \return The recorded state that has to be applied to this frame
+     * \pre The SessionRecording must be State::Playback
+     */
+    const Frame& beginPlaybackFrame();
+
+    /// Returns the index of the frame that was last returned by #beginPlaybackFrame
+    size_t playbackFrameIndex() const;
+
+    /**
+     * Finishes the current playback frame and records its total duration. After the last
+     * frame has been finished, the playback stops as if #stopPlayback was called. This
+     * method does nothing if no playback frame has been started.
+     */
+    void endPlaybackFrame();
+
+    /**
+     * Stops the playback and writes the timings of all finished frames into the timings
+     * file, if one was specified. Does nothing if no session is played back.
+     */
+    void stopPlayback();
+
+    /**
+     * Adds \p duration to the time of the \p stage in the current playback frame. A stage
+     * that is reported multiple times in the same frame, for example once per renderable,
+     * accumulates its durations. Does nothing if no playback frame has been started.
+     */
+    void addStageTime(const std::string& stage, std::chrono::nanoseconds duration);
+
+    /**
+     * Loads all complete frames of the session stored in \p filename.
+     * \param filename The session file that is loaded
+     * \return The frames of the session in the order in which they were recorded
+     * \throw SessionRecordingError If the file could not be opened or is not a session
+     *        file
+     */
+    static std::vector<Frame> loadSession(const std::string& filename);
+
+    /**
+     * Returns the Lua library that contains all Lua functions available to record and
+     * play back sessions.
+     */
+    static scripting::LuaLibrary luaLibrary();
+
+private:
+    struct FrameTiming {
+        double simulationTime;
+        std::chrono::nanoseconds total;
+        // Indexed by the position of the stage in _stages
+        std::vector<std::chrono::nanoseconds> stages;
+    };
+
+    void writeTimings() const;
+
+    State _state;
+
+    std::ofstream _recordingFile;
+    std::vector<char> _frameBuffer;
+
+    std::vector<Frame> _frames;
+    size_t _currentFrame;
+    bool _isInFrame;
+    Clock::time_point _frameBegin;
+
+    std::string _timingsFile;
+    std::vector<std::string> _stages;
+    std::vector<FrameTiming> _timings;
+};
+
+} // namespace interaction
+} // namespace openspace
+
+#endif // __SESSIONRECORDING_H__
@@ -0,0 +1,164 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MESSAGEBUFFER_H__
+#define __MESSAGEBUFFER_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace openspace {
+namespace network {
+
+/// The types of messages that are exchanged with the parallel server
+enum MessageTypes {
+    Authentication = 0,
+    Initialization,
+    Data,
+    Script, // obsolete now
+    HostInfo,
+    InitializationRequest,
+    HostshipRequest,
+    InitializationCompleted
+};
+
+/// The size of the header (<code>'O', 'S', major, minor, type</code>) of every message
+const size_t MessageHeaderSize = 4 * sizeof(uint8_t) + sizeof(uint32_t);
+
+/// The size of the data type and payload length that follow the header of data messages
+const size_t DataMessageHeaderSize = 2 * sizeof(uint16_t);
+
+/**
+ * Appends binary values to the end of a message buffer. Every value is copied into the
+ * buffer with a single <code>memcpy</code> after the buffer has been grown to fit it.
+ * Values are written in host byte order, as the parallel server forwards them unchanged.
+ */
+class MessageWriter {
+public:
+    /**
+     * Creates a writer that appends to the \p buffer. The \p buffer has to outlive the
+     * writer.
+     */
+    explicit MessageWriter(std::vector<char>& buffer);
+
+    /// Appends the bytes of the \p value, which must not contain pointers
+    template <typename T>
+    void encode(const T& value);
+
+    /// Appends the length of \p value as a <code>uint16_t</code>, followed by its
+    /// characters. Strings longer than 65535 characters are truncated.
+    void encode(const std::string& value);
+
+    /// Appends \p size bytes starting at \p data
+    void encode(const char* data, size_t size);
+
+private:
+    std::vector<char>& _buffer;
+};
+
+/**
+ * Reads the binary values that a MessageWriter has written from a message buffer. Every
+ * read is checked against the size of the buffer; a read that would pass the end of the
+ * buffer fails and leaves the reader in a failed state, so that the result of a sequence
+ * of reads can be checked once with #good.
+ */
+class MessageReader {
+public:
+    /**
+     * Creates a reader for the \p size bytes starting at \p data. The data has to outlive
+     * the reader.
+     */
+    MessageReader(const char* data, size_t size);
+
+    /// Creates a reader for the contents of the \p buffer
+    explicit MessageReader(const std::vector<char>& buffer);
+
+    /**
+     * Reads a \p value that was written by MessageWriter::encode.
+     * \return <code>true</code> if enough bytes were left in the buffer
+     */
+    template <typename T>
+    bool decode(T& value);
+
+    /**
+     * Reads a string that was written by MessageWriter::encode.
+     * \return <code>true</code> if the full string was left in the buffer
+     */
+    bool decode(std::string& value);
+
+    /**
+     * Reads \p size bytes into \p data.
+     * \return <code>true</code> if enough bytes were left in the buffer
+     */
+    bool decode(char* data, size_t size);
+
+    /// Returns the number of bytes that have not been read yet
+    size_t remaining() const;
+
+    /// Returns whether all reads so far have succeeded
+    bool good() const;
+
+private:
+    const char* _data;
+    size_t _size;
+    size_t _offset;
+    bool _good;
+};
+
+/**
+ * Appends the header of a message of type \p messageType to the \p buffer. The header
+ * contains the characters <code>'O'</code> and <code>'S'</code>, the major and minor
+ * version of OpenSpace, and the type.
+ */
+void writeMessageHeader(std::vector<char>& buffer, uint32_t messageType);
+
+/**
+ * Reads the type of a message from its \p header, which has to be MessageHeaderSize bytes
+ * long.
+ * \return <code>true</code> if the \p header was written by the same version of OpenSpace
+ */
+bool readMessageHeader(const char* header, uint32_t& messageType);
+
+/**
+ * Appends the header of a data message of type \p dataType to the \p buffer, followed by
+ * a placeholder for the length of the payload. The payload is appended afterwards, after
+ * which finishDataMessage writes its length.
+ * \return The offset of the length placeholder that is passed to finishDataMessage
+ */
+size_t beginDataMessage(std::vector<char>& buffer, uint16_t dataType);
+
+/**
+ * Writes the length of the payload that was appended to the \p buffer after the call to
+ * beginDataMessage that returned \p lengthOffset.
+ * \return <code>false</code> if the payload is too long to be described in a data message
+ */
+bool finishDataMessage(std::vector<char>& buffer, size_t lengthOffset);
+
+} // namespace network
+} // namespace openspace
+
+#include "messagebuffer.inl"
+
+#endif // __MESSAGEBUFFER_H__
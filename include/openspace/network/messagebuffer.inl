@@ -22,60 +22,29 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#ifndef __THREAD_POOL_H__
-#define __THREAD_POOL_H__
-
-#include <glm/glm.hpp>
-#include <memory>
-#include <ostream>
-#include <thread>
-#include <queue>
-
-#include <modules/globebrowsing/other/concurrentqueue.h>
-
-#include <ghoul/misc/assert.h>
-
-
-
-// Implementatin based on http://progsch.net/wordpress/?p=81
+#include <cstring>
+#include <type_traits>
 
 namespace openspace {
-    
-
-    class ThreadPool;
-
-    class Worker {
-    public: 
-        Worker(ThreadPool& pool);
-        void operator()();
-    private:
-        ThreadPool& pool;
-    };
-
-    class ThreadPool {
-    public:
-        ThreadPool(size_t numThreads);
-        ~ThreadPool();
-
-        void enqueue(std::function<void()> f);
-        void clearTasks();
-
-    private:
-        friend class Worker;
-
-        std::vector<std::thread> workers;
-
-        std::deque<std::function<void()>> tasks;
-
-        std::mutex queue_mutex;
-        std::condition_variable condition;
-
-        bool stop;
-    };
-
-
+namespace network {
+
+template <typename T>
+void MessageWriter::encode(const T& value) {
+    static_assert(
+        std::is_standard_layout<T>::value,
+        "Only standard layout values can be written as raw bytes"
+    );
+    encode(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool MessageReader::decode(T& value) {
+    static_assert(
+        std::is_standard_layout<T>::value,
+        "Only standard layout values can be read from raw bytes"
+    );
+    return decode(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+} // namespace network
 } // namespace openspace
-
-
-
-#endif // __THREAD_POOL_H__
\ No newline at end of file
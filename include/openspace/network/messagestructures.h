@@ -26,6 +26,7 @@
 #define __MESSAGESTRUCTURES_H__
 
 //std includes
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -33,6 +34,7 @@
 #include <glm/gtx/quaternion.hpp>
 
 //openspace includes
+#include <openspace/network/messagebuffer.h>
 #include <openspace/util/powerscaledcoordinate.h>
 
 namespace openspace{
@@ -43,7 +45,9 @@ namespace openspace{
             enum type{
                 PositionData = 0,
                 TimeData,
-                ScriptData
+                ScriptData,
+                PropertyIdentifierData,
+                PropertyValueData
             };
         
             struct PositionKeyframe{
@@ -51,34 +55,22 @@ namespace openspace{
                 psc _position;
                 double _timeStamp;
                 
-                void serialize(std::vector<char> &buffer){
-                    //add position
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_position), reinterpret_cast<char*>(&_position) + sizeof(_position));
-                    
-                    //add orientation
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_viewRotationQuat), reinterpret_cast<char*>(&_viewRotationQuat) + sizeof(_viewRotationQuat));
-                    
-                    //add timestamp
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_timeStamp), reinterpret_cast<char*>(&_timeStamp) + sizeof(_timeStamp));
+                void serialize(std::vector<char> &buffer) const{
+                    MessageWriter writer(buffer);
+                    //a psc is written as the glm::vec4 it consists of
+                    writer.encode(_position.vec4());
+                    writer.encode(_viewRotationQuat);
+                    writer.encode(_timeStamp);
                 };
                 
-                void deserialize(const std::vector<char> &buffer){
-                    int offset = 0;
-                    int size = 0;
-                    
-                    //position
-                    size = sizeof(_position);
-                    memcpy(&_position, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //orientation
-                    size = sizeof(_viewRotationQuat);
-                    memcpy(&_viewRotationQuat, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //timestamp
-                    size = sizeof(_timeStamp);
-                    memcpy(&_timeStamp, buffer.data() + offset, size);
+                bool deserialize(const std::vector<char> &buffer){
+                    MessageReader reader(buffer);
+                    glm::vec4 position;
+                    reader.decode(position);
+                    reader.decode(_viewRotationQuat);
+                    reader.decode(_timeStamp);
+                    _position = psc(position);
+                    return reader.good();
                 };
             };
             
@@ -89,70 +81,105 @@ namespace openspace{
                 bool _paused;
                 bool _requiresTimeJump;
                 
-                void serialize(std::vector<char> &buffer){
-                    //add current time
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_time), reinterpret_cast<char*>(&_time) + sizeof(_time));
-                    
-                    //add delta time
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_dt), reinterpret_cast<char*>(&_dt) + sizeof(_dt));
-                    
-                    //add wether time is paused or not
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_paused), reinterpret_cast<char*>(&_paused) + sizeof(_paused));
-                    
-                    //add wether a time jump is necessary (recompute paths etc)
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_requiresTimeJump), reinterpret_cast<char*>(&_requiresTimeJump) + sizeof(_requiresTimeJump));
+                void serialize(std::vector<char> &buffer) const{
+                    MessageWriter writer(buffer);
+                    writer.encode(_time);
+                    writer.encode(_dt);
+                    //wether time is paused or not
+                    writer.encode(_paused);
+                    //wether a time jump is necessary (recompute paths etc)
+                    writer.encode(_requiresTimeJump);
                 };
                 
-                void deserialize(const std::vector<char> &buffer){
-                    int offset = 0;
-                    int size = 0;
-                    
-                    //current time
-                    size = sizeof(_time);
-                    memcpy(&_time, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //delta time
-                    size = sizeof(_dt);
-                    memcpy(&_dt, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //is time paused?
-                    size = sizeof(_paused);
-                    memcpy(&_paused, buffer.data() + offset, size);
-                    offset += sizeof(_paused);
-    
-                    //is a time jump required?
-                    size = sizeof(_requiresTimeJump);
-                    memcpy(&_requiresTimeJump, buffer.data() + offset, size);
+                bool deserialize(const std::vector<char> &buffer){
+                    MessageReader reader(buffer);
+                    reader.decode(_time);
+                    reader.decode(_dt);
+                    reader.decode(_paused);
+                    reader.decode(_requiresTimeJump);
+                    return reader.good();
                 };
             };
             
             struct ScriptMessage{
                 
-                uint16_t _scriptlen;
                 std::string _script;
                 
-                void serialize(std::vector<char> &buffer){
-                    //add script length
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_scriptlen), reinterpret_cast<char*>(&_scriptlen) + sizeof(_scriptlen));
-                    
-                    //add script
-                    buffer.insert(buffer.end(), _script.begin(), _script.end());
-                    
+                void serialize(std::vector<char> &buffer) const{
+                    //the script is written after its length
+                    MessageWriter writer(buffer);
+                    writer.encode(_script);
                 };
                 
-                void deserialize(const std::vector<char> &buffer){
-                    int offset = 0;
-                    int size = 0;
-                    
-                    //size of script
-                    size = sizeof(uint16_t);
-                    memcpy(&_scriptlen, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //actual script
-                    _script.assign(buffer.begin() + offset, buffer.end());
+                bool deserialize(const std::vector<char> &buffer){
+                    MessageReader reader(buffer);
+                    reader.decode(_script);
+                    return reader.good();
+                };
+            };
+
+            //binds the URI of a property to the id that PropertyValue messages use
+            struct PropertyIdentifier{
+
+                uint32_t _id;
+                std::string _uri;
+
+                void serialize(std::vector<char> &buffer) const{
+                    MessageWriter writer(buffer);
+                    writer.encode(_id);
+                    writer.encode(_uri);
+                };
+
+                bool deserialize(const std::vector<char> &buffer){
+                    MessageReader reader(buffer);
+                    reader.decode(_id);
+                    reader.decode(_uri);
+                    return reader.good();
+                };
+            };
+
+            //the new value of the property with the id _id. Values of the listed types
+            //are sent as their raw bytes, all other values as the string that
+            //Property::getStringValue returns
+            struct PropertyValue{
+
+                enum class Type : uint8_t{
+                    Bool = 0,
+                    Int,
+                    Float,
+                    Double,
+                    Vec2,
+                    Vec3,
+                    Vec4,
+                    DVec2,
+                    DVec3,
+                    DVec4,
+                    IVec2,
+                    IVec3,
+                    IVec4,
+                    String,
+                    LuaString
+                };
+
+                uint32_t _id;
+                Type _type;
+                std::vector<char> _value;
+
+                void serialize(std::vector<char> &buffer) const{
+                    MessageWriter writer(buffer);
+                    writer.encode(_id);
+                    writer.encode(_type);
+                    writer.encode(_value.data(), _value.size());
+                };
+
+                bool deserialize(const std::vector<char> &buffer){
+                    MessageReader reader(buffer);
+                    reader.decode(_id);
+                    reader.decode(_type);
+                    //the value fills the rest of the message
+                    _value.resize(reader.remaining());
+                    reader.decode(_value.data(), _value.size());
+                    return reader.good() && _type <= Type::LuaString;
                 };
             };
             
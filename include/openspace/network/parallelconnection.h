@@ -28,7 +28,10 @@
 //openspace includes
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/powerscaledcoordinate.h>
+#include <openspace/network/messagebuffer.h>
 #include <openspace/network/messagestructures.h>
+#include <openspace/network/sendqueue.h>
+#include <openspace/network/socket.h>
 
 //glm includes
 #include <glm/gtx/quaternion.hpp>
@@ -41,25 +44,14 @@
 #include <sstream>
 #include <mutex>
 #include <map>
+#include <unordered_map>
 #include <condition_variable>
 
-#ifdef WIN32
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <winsock2.h>
-#include <windows.h>
-#include <ws2tcpip.h>
-#endif
-
-#if defined(WIN32) || defined(__MING32__) || defined(__MING64__)
-typedef size_t _SOCKET;
-#else
-typedef int _SOCKET;
-#include <netdb.h>
-#endif
-
 namespace openspace{
+
+    namespace properties{
+        class Property;
+    } // namespace properties
     
     namespace network{
         
@@ -88,18 +80,33 @@ namespace openspace{
             
             void preSynchronization();
             
-            void scriptMessage(const std::string propIdentifier, const std::string propValue);
-            
-            enum MessageTypes{
-                Authentication=0,
-                Initialization,
-                Data,
-                Script, //obsolete now 
-                HostInfo,
-                InitializationRequest,
-                HostshipRequest,
-                InitializationCompleted
-            };
+            /**
+             * Records the current value of the \p property as part of the state that is
+             * sent to clients that join the session and, if this node is the host, sends
+             * the value to all clients. Values are sent as typed binary deltas that refer
+             * to the property by an id, which is bound to the property's URI the first
+             * time the property is sent after a client has joined.
+             * \param property The property whose value has changed
+             */
+            void propertyMessage(const properties::Property& property);
+
+            /**
+             * Encodes the current value of the \p property into \p value. Values of the
+             * types listed in PropertyValue::Type are encoded as their raw bytes, all
+             * other values as the string that Property::getStringValue returns.
+             */
+            static void encodePropertyValue(const properties::Property& property,
+                datamessagestructures::PropertyValue& value);
+
+            /**
+             * Returns the script that sets the property with the URI \p uri to the
+             * received \p value. Received values are queued as scripts, so that they are
+             * synchronized to all nodes of a cluster and are applied in the same order
+             * as the scripts that were received before and after them.
+             * \return The script, or an empty string if the \p value is malformed
+             */
+            static std::string scriptFromPropertyValue(const std::string& uri,
+                const datamessagestructures::PropertyValue& value);
             
             /**
              * Returns the Lua library that contains all Lua functions available to affect the
@@ -131,15 +138,14 @@ namespace openspace{
                 return hashVal;
             };
             
-            void queueMessage(std::vector<char> message);
+            void queueMessage(const std::vector<char>& message,
+                uint32_t coalescingKey = SendQueue::NoCoalescing);
+
+            template <typename T>
+            void queueDataMessage(datamessagestructures::type type, const T& data,
+                uint32_t coalescingKey = SendQueue::NoCoalescing);
             
             void disconnect();
-            
-            void writeHeader(std::vector<char> &buffer, uint32_t messageType);
-
-            void closeSocket();
-
-            bool initNetworkAPI();
 
             void establishConnection(addrinfo *info);
 
@@ -157,11 +163,9 @@ namespace openspace{
             
             void initializationRequestMessageReceived();
 
-            void broadcast();
-            
-            int headerSize();
+            void propertyValueReceived(const std::vector<char>& buffer);
 
-            int receiveData(_SOCKET & socket, std::vector<char> &buffer, int length, int flags);
+            void broadcast();
             
             void sendFunc();
             
@@ -191,15 +195,29 @@ namespace openspace{
             std::condition_variable _disconnectCondition;
             std::mutex _disconnectMutex;
             
-            std::vector<std::vector<char>> _sendBuffer;
-            std::mutex _sendBufferMutex;
-            std::condition_variable _sendCondition;
+            SendQueue _sendQueue;
+
+            //wakes the broadcast thread when it has to stop before its next keyframe
+            std::condition_variable _broadcastCondition;
+            std::mutex _broadcastMutex;
+
+            //buffer for the payload of received data messages, only used by listen thread
+            std::vector<char> _receiveBuffer;
             
             network::datamessagestructures::TimeKeyframe _latestTimeKeyframe;
             std::mutex _timeKeyframeMutex;
             std::atomic<bool> _latestTimeKeyframeValid;
             std::map<std::string, std::string> _currentState;
             std::mutex _currentStateMutex;
+
+            //host: the interned ids of all sent properties and whether the current
+            //clients have received the URI that an id is bound to
+            std::unordered_map<std::string, uint32_t> _propertyIds;
+            std::vector<bool> _isPropertyIdAnnounced;
+            std::mutex _propertyIdMutex;
+
+            //client: the URIs that the host has bound to ids, only used by listen thread
+            std::unordered_map<uint32_t, std::string> _propertyUris;
         };
     } // namespace network
     
@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __SENDQUEUE_H__
+#define __SENDQUEUE_H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace openspace {
+namespace network {
+
+/**
+ * A queue of serialized messages that are handed from the threads that create them to the
+ * thread that sends them. The messages are stored in a ring buffer whose slots keep their
+ * allocations, so that queueing and sending messages does not allocate memory once the
+ * queue has grown to its working size. The sending thread sleeps on a condition variable
+ * until a message is queued or the queue is closed.
+ *
+ * A message can be queued with a coalescing key. If the most recently queued message that
+ * has not been sent yet has the same key, it is replaced by the new message instead. This
+ * is used for keyframes, of which only the newest is of interest if the connection cannot
+ * keep up.
+ */
+class SendQueue {
+public:
+    /// Messages that are queued with this key are never coalesced
+    static const uint32_t NoCoalescing = 0;
+
+    /**
+     * Creates a closed queue with room for \p capacity messages before it has to grow.
+     * \pre \p capacity must be bigger than 0
+     */
+    explicit SendQueue(size_t capacity = 64);
+
+    /// Opens the queue, after which messages can be pushed
+    void open();
+
+    /**
+     * Closes the queue and discards all messages that have not been sent. Threads that
+     * are waiting in #pop return immediately.
+     */
+    void close();
+
+    /**
+     * Queues a copy of the \p message, or replaces the most recently queued message if it
+     * has the same, non-zero \p coalescingKey. The message is dropped if the queue is
+     * closed.
+     * \return <code>true</code> if the \p message was queued or replaced another message
+     */
+    bool push(const std::vector<char>& message, uint32_t coalescingKey = NoCoalescing);
+
+    /**
+     * Waits until a message is queued, or the queue is closed, and swaps the oldest
+     * queued message with \p message. The previous contents of \p message are reused for
+     * a later message.
+     * \return <code>false</code> if the queue was closed
+     */
+    bool pop(std::vector<char>& message);
+
+    /// Returns the number of messages that have not been popped yet
+    size_t size() const;
+
+private:
+    struct Slot {
+        std::vector<char> message;
+        uint32_t coalescingKey;
+    };
+
+    /// Doubles the number of slots, keeping the queued messages in order
+    void grow();
+
+    std::vector<Slot> _slots;
+    size_t _head;
+    size_t _size;
+    bool _isOpen;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+};
+
+} // namespace network
+} // namespace openspace
+
+#endif // __SENDQUEUE_H__
@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __SOCKET_H__
+#define __SOCKET_H__
+
+#include <cstddef>
+
+#ifdef WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <windows.h>
+#include <ws2tcpip.h>
+#endif
+
+#if defined(WIN32) || defined(__MING32__) || defined(__MING64__)
+typedef size_t _SOCKET;
+#else
+typedef int _SOCKET;
+#include <netdb.h>
+#endif
+
+#ifdef WIN32
+#ifndef _ERRNO
+#define _ERRNO WSAGetLastError()
+#endif
+#else //Use BSD sockets
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#ifndef SOCKET_ERROR
+#define SOCKET_ERROR (-1)
+#endif
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (_SOCKET)(~0)
+#endif
+
+#ifndef NO_ERROR
+#define NO_ERROR 0L
+#endif
+
+#ifndef _ERRNO
+#define _ERRNO errno
+#endif
+#endif
+
+namespace openspace {
+namespace network {
+
+/**
+ * Initializes the socket API of the operating system, which is only necessary on Windows.
+ * \return <code>true</code> if the socket API can be used
+ */
+bool initializeSocketApi();
+
+/**
+ * Sends all \p length bytes starting at \p data through the \p socket, repeating the send
+ * for as long as only parts of the data were sent.
+ * \return The number of bytes sent, or <code>SOCKET_ERROR</code> if the send failed
+ */
+int sendAll(_SOCKET socket, const char* data, size_t length);
+
+/**
+ * Receives exactly \p length bytes from the \p socket into \p data, repeating the receive
+ * until all bytes have arrived.
+ * \return The number of bytes received, 0 if the connection was closed, or a negative
+ * value if the receive failed
+ */
+int receiveAll(_SOCKET socket, char* data, size_t length);
+
+/**
+ * Shuts down both directions of the \p socket, closes it, and sets it to
+ * <code>INVALID_SOCKET</code>.
+ */
+void closeSocket(_SOCKET& socket);
+
+} // namespace network
+} // namespace openspace
+
+#endif // __SOCKET_H__
@@ -26,33 +26,116 @@
 #define __PERFORMANCELAYOUT_H__
 
 #include <cstdint>
+#include <ostream>
 
 namespace openspace {
 namespace performance {
 
 struct PerformanceLayout {
-    static const int8_t Version = 0;
+    static const int8_t Version = 1;
     static const int LengthName = 256;
     static const int NumberValues = 256;
     static const int MaxValues = 256;
 
     PerformanceLayout();
 
+    /**
+     * A window of the last NumberValues samples of a single measurement. The samples are
+     * stored in a ring buffer alongside a sorted copy of the window, which is updated
+     * incrementally whenever a value is added, so that the minimum, maximum, mean, and
+     * percentiles of the window can be retrieved in constant time by the reader. As this
+     * struct lives in shared memory, it must not contain any pointers and a
+     * zero-initialized instance is an empty series.
+     */
+    struct Series {
+        /**
+         * Adds the \p value to the series, evicting the oldest value if the window is
+         * full. This function is <code>O(NumberValues)</code> in the worst case due to
+         * the shifting of the sorted window.
+         * \param value The value that is added to the series
+         */
+        void addValue(float value);
+
+        /// Returns the number of values that are stored in the series
+        int nValues() const;
+
+        /// Returns the last value that was added or <code>0</code> if there is none
+        float latest() const;
+
+        /// Returns the smallest value in the window or <code>0</code> if it is empty
+        float minimum() const;
+
+        /// Returns the largest value in the window or <code>0</code> if it is empty
+        float maximum() const;
+
+        /// Returns the mean of the window or <code>0</code> if it is empty
+        float average() const;
+
+        /**
+         * Returns the <code>p</code>-th percentile of the values in the window using the
+         * nearest-rank method, or <code>0</code> if the window is empty.
+         * \param p The requested percentile in the range <code>[0, 100]</code>
+         * \return The <code>p</code>-th percentile of the window
+         */
+        float percentile(float p) const;
+
+        /**
+         * Returns the value that was added \p age frames ago, where <code>0</code> is
+         * the latest value.
+         * \pre \p age must be smaller than nValues()
+         */
+        float value(int age) const;
+
+        /**
+         * Fills the \p bins with the number of values in the window that fall into
+         * \p nBins equally sized bins between the minimum() and the maximum().
+         * \param bins The destination that must be able to hold \p nBins values
+         * \param nBins The number of bins that are computed
+         */
+        void histogram(float* bins, int nBins) const;
+
+        /// The ring buffer of values, the oldest value is stored at #head
+        float values[NumberValues];
+        /// The first #count values of the window in ascending order
+        float sortedValues[NumberValues];
+        /// The sum of the window, kept in double precision to avoid drift
+        double sum;
+        /// The location in #values that will be overwritten by the next value
+        int16_t head;
+        /// The number of valid values in the window
+        int16_t count;
+    };
+
     struct SceneGraphPerformanceLayout {
         char name[LengthName];
-        float renderTime[NumberValues];
-        float updateRenderable[NumberValues];
-        float updateEphemeris[NumberValues];
+        Series renderTime;
+        Series updateRenderable;
+        Series updateEphemeris;
     };
     SceneGraphPerformanceLayout sceneGraphEntries[MaxValues];
     int16_t nScaleGraphEntries;
 
     struct FunctionPerformanceLayout {
         char name[LengthName];
-        float time[NumberValues];
+        Series time;
     };
     FunctionPerformanceLayout functionEntries[MaxValues];
     int16_t nFunctionEntries;
+
+    /// The duration of each frame in microseconds
+    Series frameTime;
+
+    /// The number of frames that have been stored since the last reset
+    uint32_t nFrames;
+
+    /**
+     * Writes the windows of all series into the \p stream as comma-separated values. Each
+     * series is a column and each row is a frame, starting with the oldest. Series that
+     * contain fewer values than the longest series are padded with empty cells at the
+     * start.
+     * \param stream The stream to which the values are written
+     */
+    void writeCsv(std::ostream& stream) const;
 };
 
 } // namespace performance
@@ -26,6 +26,7 @@
 #define __PERFORMANCEMANAGER_H__
 
 #include <openspace/performance/performancelayout.h>
+#include <openspace/util/jobmanager.h>
 
 #include <ghoul/misc/sharedmemory.h>
 
@@ -57,10 +58,14 @@ public:
 
     void storeIndividualPerformanceMeasurement(std::string identifier, long long nanoseconds);
     void storeScenePerformanceMeasurements(const std::vector<SceneGraphNode*>& sceneNodes);
+    void storeJobManagerStatistics(const JobManager::Statistics& statistics);
+    void storeFrameTime(double seconds);
     
     PerformanceLayout* performanceData();
 
 private:
+    void storeFunctionValue(const std::string& identifier, float value);
+
     bool _doPerformanceMeasurements;
     
     std::map<std::string, size_t> individualPerformanceLocations;
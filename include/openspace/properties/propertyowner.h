@@ -26,6 +26,7 @@
 #define __PROPERTYOWNER_H__
 
 #include <openspace/properties/property.h>
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
@@ -206,7 +207,19 @@ public:
     /// \see PropertyOwner::removePropertySubOwner(PropertyOwner*)
     void removePropertySubOwner(PropertyOwner& owner);
 
+    /**
+     * Returns a number that changes whenever a Property or a sub-owner is added to or
+     * removed from any PropertyOwner, or whenever a PropertyOwner is renamed or
+     * destroyed. Caches of the Property hierarchy can compare it against the value at
+     * the time they were built to find out whether they have to be rebuilt.
+     * \return The current version of the structure of all PropertyOwners
+     */
+    static uint64_t structureVersion();
+
 private:
+    /// Incremented by every structural change to any PropertyOwner
+    static std::atomic<uint64_t> _structureVersion;
+
     /// The name of this PropertyOwner
     std::string _name;
     /// The owner of this PropertyOwner
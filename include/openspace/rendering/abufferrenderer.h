@@ -39,6 +39,7 @@
 #include <openspace/rendering/volume.h>
 #include <openspace/rendering/renderer.h>
 #include <openspace/rendering/raycasterlistener.h>
+#include <openspace/rendering/raycasterregistry.h>
 #include <openspace/util/updatestructures.h>
 
 namespace ghoul {
@@ -90,6 +91,7 @@ private:
     void updateResolution();
     void updateRaycastData();
     void updateResolveDictionary();
+    void updateResolveUniformLocations();
     
     Camera* _camera;
     Scene* _scene;
@@ -101,17 +103,28 @@ private:
     bool _dirtyResolveDictionary;
     
     std::unique_ptr<ghoul::opengl::ProgramObject> _resolveProgram;
+
+    /// The uniform locations of the resolve program, updated whenever it is rebuilt
+    struct {
+        GLint mainColorTexture;
+        GLint mainDepthTexture;
+        GLint blackoutFactor;
+        GLint nAaSamples;
+        GLint gamma;
+    } _resolveUniforms;
     
     /**
-     * When a volume is attached or detached from the scene graph,
-     * the resolve program needs to be recompiled.
-     * The _volumes map keeps track of which volumes that can
-     * be rendered using the current resolve program, along with their raycast data
-     * (id, namespace, etc)
+     * Keeps track of which volumes that can be rendered using the current resolve
+     * program, along with their raycast data (id, namespace, etc). The resolve program
+     * only needs to be recompiled when the slots that are reserved for the volumes
+     * change, not every time a volume is attached or detached from the scene graph.
      */ 
-    std::map<VolumeRaycaster*, RaycastData> _raycastData;
+    RaycasterRegistry _raycasterRegistry;
     std::map<VolumeRaycaster*, std::unique_ptr<ghoul::opengl::ProgramObject>> _boundsPrograms;
-    std::vector<std::string> _helperPaths;
+
+    /// The per-slot data of the RaycasterUniforms block in the resolve program
+    std::vector<glm::vec4> _raycasterUniformData;
+    GLuint _raycasterUniformBuffer;
 
     ghoul::Dictionary _resolveDictionary;
 
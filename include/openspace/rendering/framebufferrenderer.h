@@ -33,6 +33,7 @@
 #include <map>
 
 #include <openspace/rendering/raycasterlistener.h>
+#include <openspace/rendering/raycasterregistry.h>
 #include <openspace/rendering/renderer.h>
 #include <openspace/util/updatestructures.h>
 
@@ -81,14 +82,35 @@ public:
 
     virtual void raycastersChanged(VolumeRaycaster& raycaster, bool attached) override;
 private:
-
-    std::map<VolumeRaycaster*, RaycastData> _raycastData;
+    /// The uniform locations of a raycast program, updated whenever it is rebuilt
+    struct RaycastUniforms {
+        GLint insideRaycaster;
+        GLint cameraPosInRaycaster;
+        GLint exitColorTexture;
+        GLint exitDepthTexture;
+        GLint mainDepthTexture;
+        GLint nAaSamples;
+    };
+
+    void updateRaycastUniformLocations(ghoul::opengl::ProgramObject& program);
+    void updateResolveUniformLocations();
+
+    /// Raycasters keep their id while attached, so only new raycasters need programs
+    RaycasterRegistry _raycasterRegistry;
     std::map<VolumeRaycaster*, std::unique_ptr<ghoul::opengl::ProgramObject>> _exitPrograms;
     std::map<VolumeRaycaster*, std::unique_ptr<ghoul::opengl::ProgramObject>> _raycastPrograms;
     std::map<VolumeRaycaster*, std::unique_ptr<ghoul::opengl::ProgramObject>> _insideRaycastPrograms;
+    std::map<ghoul::opengl::ProgramObject*, RaycastUniforms> _raycastUniforms;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _resolveProgram;
 
+    /// The uniform locations of the resolve program, updated whenever it is rebuilt
+    struct {
+        GLint mainColorTexture;
+        GLint blackoutFactor;
+        GLint nAaSamples;
+    } _resolveUniforms;
+
     GLuint _screenQuad;
     GLuint _vertexPositionBuffer;
     GLuint _mainColorTexture;
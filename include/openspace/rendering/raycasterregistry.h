@@ -0,0 +1,141 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __RAYCASTERREGISTRY_H__
+#define __RAYCASTERREGISTRY_H__
+
+#include <openspace/util/updatestructures.h>
+
+#include <ghoul/misc/dictionary.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+class VolumeRaycaster;
+
+/**
+ * The RaycasterRegistry assigns stable integer slots to the VolumeRaycaster%s that are
+ * attached to a renderer. A raycaster keeps its slot, and thus its RaycastData::id, for
+ * as long as it is attached, so that programs that were generated for a raycaster do not
+ * have to be rebuilt when other raycasters are attached or detached.
+ *
+ * Raycasters that share the same raycast and helper paths are of the same <i>type</i>.
+ * The first raycaster of a type reserves a group of slots for that type, so that
+ * programs that include the code of all slots, such as the ABuffer resolve program,
+ * only have to be rebuilt when the reserved slots change. This happens when a new type
+ * is attached, when the reserved slots of a type are exhausted, or when the last
+ * raycaster of a type is detached.
+ *
+ * This class does not perform any OpenGL calls.
+ */
+class RaycasterRegistry {
+public:
+    /// The result of a call to update
+    struct Changes {
+        /// The raycasters that have been assigned a slot
+        std::vector<VolumeRaycaster*> added;
+        /// The raycasters that have lost their slot
+        std::vector<VolumeRaycaster*> removed;
+        /// <code>true</code> if the set of reserved slots has changed
+        bool reservationsChanged = false;
+    };
+
+    /**
+     * Creates an empty registry.
+     * \param nSlots The total number of slots that are available
+     * \param nSlotsPerType The number of slots that are reserved at once when a type of
+     * raycaster runs out of free slots
+     * \pre \p nSlots must be positive
+     * \pre \p nSlotsPerType must be positive
+     */
+    RaycasterRegistry(int nSlots, int nSlotsPerType);
+
+    /**
+     * Synchronizes the registry with the list of currently attached \p raycasters. New
+     * raycasters are assigned a free slot of their type, raycasters that are no longer
+     * in the list release their slot. If no slot is available for a raycaster, it is
+     * ignored and a warning is logged.
+     * \param raycasters The raycasters that are currently attached
+     * \return The changes that were applied to the registry
+     */
+    Changes update(const std::vector<VolumeRaycaster*>& raycasters);
+
+    /**
+     * Returns the RaycastData for the \p raycaster or <code>nullptr</code> if the
+     * raycaster does not have a slot.
+     */
+    const RaycastData* raycastData(VolumeRaycaster* raycaster) const;
+
+    /// Returns the RaycastData of all raycasters that currently have a slot
+    const std::map<VolumeRaycaster*, RaycastData>& raycastData() const;
+
+    /**
+     * Returns the number of slots that programs have to provide, which is one more than
+     * the highest reserved slot, or <code>0</code> if no slots are reserved.
+     */
+    int nReservedSlots() const;
+
+    /**
+     * Returns the shader preprocessor dictionary describing all reserved slots. It
+     * contains the keys <code>raycasters</code>, with the <code>id</code>,
+     * <code>namespace</code>, <code>bitmask</code>, and <code>raycastPath</code> of
+     * each reserved slot, <code>helperPaths</code>, <code>raycastingEnabled</code>, and
+     * <code>nRaycasters</code>. The dictionary only changes when update reports that
+     * the reservations have changed.
+     * \pre The number of slots must not exceed the number of bits in the bitmask
+     */
+    ghoul::Dictionary resolveDictionary() const;
+
+private:
+    struct Type {
+        std::string raycastPath;
+        std::string helperPath;
+        std::string namespaceName;
+        std::vector<int> slots;
+        int nRaycasters;
+    };
+
+    int reserveSlots(int typeIndex, Type& type);
+
+    int _nSlotsPerType;
+
+    /// The type index for each slot, or -1 if the slot is not reserved
+    std::vector<int> _slotTypes;
+    /// The raycaster occupying each slot
+    std::vector<VolumeRaycaster*> _slotRaycasters;
+
+    std::map<int, Type> _types;
+    int _nextTypeIndex;
+    std::map<std::string, std::string> _helperNamespaces;
+    int _nextNamespaceIndex;
+
+    std::map<VolumeRaycaster*, RaycastData> _raycastData;
+};
+
+} // namespace openspace
+
+#endif // __RAYCASTERREGISTRY_H__
@@ -72,6 +72,17 @@ public:
     virtual bool isReady() const = 0;
     bool isEnabled() const;
 
+    /**
+     * Returns whether this Renderable can be used without an OpenGL context. While the
+     * WindowWrapper is headless, such a Renderable is initialized, updated, and rendered
+     * as usual, but it must neither create nor use any OpenGL objects. All other
+     * Renderables are not added to a headless scene. The constructor and the destructor
+     * of a Renderable must not use OpenGL in either case.
+     * \return <code>true</code> if this Renderable can be used without an OpenGL
+     * context; the default implementation returns <code>false</code>
+     */
+    virtual bool isHeadlessCapable() const;
+
     void setBoundingSphere(PowerScaledScalar boundingSphere);
     PowerScaledScalar getBoundingSphere();
 
@@ -91,7 +102,7 @@ public:
     
     void onEnabledChange(std::function<void(bool)> callback);
 
-    static void setPscUniforms(ghoul::opengl::ProgramObject& program, const Camera& camera, const PowerScaledCoordinate& position);
+    static void setPscUniforms(ghoul::opengl::ProgramObject& program, const Camera::Snapshot& camera, const PowerScaledCoordinate& position);
 
     static openspace::Documentation Documentation();
 
@@ -104,7 +104,7 @@ protected:
 
     GLuint _quad;
     GLuint _vertexPositionBuffer;
-    std::unique_ptr<ghoul::opengl::Texture>  _texture;
+    std::shared_ptr<ghoul::opengl::Texture>  _texture;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shader;
 
     bool _useEuclideanCoordinates;
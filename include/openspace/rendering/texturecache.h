@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __TEXTURECACHE_H__
+#define __TEXTURECACHE_H__
+
+#include <openspace/util/jobmanager.h>
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/texture.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The TextureCache loads images from disk or from http(s) URLs and shares the resulting
+ * textures between all users of the same source, which is the absolute path or the URL.
+ * Reading, downloading, and decoding happen on the worker threads of the JobManager into
+ * CPU-side Images that are uploaded to the GPU in #update, which is called once per frame
+ * and stops after a time budget. Sources are reference counted through #acquire and
+ * #release. URL sources can be refreshed, in which case the <code>ETag</code> and
+ * <code>Last-Modified</code> headers of the previous response are sent along, so that
+ * unchanged content is neither downloaded nor decoded again. All member functions have to
+ * be called from the main thread.
+ */
+class TextureCache {
+public:
+    /// The pixels of a decoded image that have not been uploaded to the GPU yet
+    struct Image {
+        std::unique_ptr<char[]> data;
+        glm::uvec3 dimensions;
+        ghoul::opengl::Texture::Format format;
+        GLint internalFormat;
+        GLenum dataType;
+    };
+
+    /**
+     * A Decoder converts the encoded contents of an image file into an Image. It is
+     * called on a worker thread and returns <code>nullptr</code> if the contents cannot
+     * be decoded. The <code>format</code> is the file extension or the subtype of the
+     * MIME type of the downloaded file.
+     */
+    using Decoder = std::function<
+        std::unique_ptr<Image>(const char* data, size_t size, const std::string& format)
+    >;
+
+    struct Statistics {
+        /// The number of files that were read or downloaded
+        uint64_t nLoads;
+        /// The number of refreshes that found the content unchanged
+        uint64_t nUnchanged;
+        /// The number of decoded images
+        uint64_t nDecodes;
+        /// The number of textures that were uploaded to the GPU
+        uint64_t nUploads;
+    };
+
+    /**
+     * Returns the Decoder that decodes images with FreeImage. If Ghoul was compiled
+     * without FreeImage, an empty Decoder is returned, in which case the images are
+     * decoded on the main thread by the ghoul::io::TextureReader during #update.
+     */
+    static Decoder defaultDecoder();
+
+    /**
+     * Creates a TextureCache that executes its loads on the \p jobManager.
+     * \param jobManager The JobManager that reads, downloads, and decodes the images
+     * \param decoder The Decoder that is used on the worker threads
+     */
+    explicit TextureCache(JobManager& jobManager, Decoder decoder = defaultDecoder());
+
+    /// Discards all pending loads and releases all textures
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * Registers an interest in the image at \p source, which is either a path on disk or
+     * an http(s) URL. The first call for a \p source starts loading it; further calls
+     * share the same image and texture.
+     * \pre \p source must not be empty
+     */
+    void acquire(const std::string& source);
+
+    /**
+     * Removes an interest in the image at \p source. When the last interest is removed,
+     * a pending load is discarded and the texture is released.
+     */
+    void release(const std::string& source);
+
+    /**
+     * Loads the \p source again. For URLs, the server is asked whether the content has
+     * changed since the last response and the image is only replaced if it has. If a
+     * load of the \p source is already in progress, this function does nothing.
+     * \pre \p source must have been acquired
+     */
+    void refresh(const std::string& source);
+
+    /**
+     * Returns the most recently uploaded texture of the \p source, or
+     * <code>nullptr</code> if no texture has been uploaded yet.
+     */
+    std::shared_ptr<ghoul::opengl::Texture> texture(const std::string& source) const;
+
+    /**
+     * Returns the decoded Image of the \p source that has not been uploaded yet, or
+     * <code>nullptr</code> if there is none.
+     */
+    const Image* image(const std::string& source) const;
+
+    /**
+     * Returns how often the content of the \p source has been replaced, starting with
+     * <code>1</code> for the first successful load and <code>0</code> before that.
+     */
+    int version(const std::string& source) const;
+
+    /**
+     * Uploads the decoded images to the GPU, in the order in which they arrived, until
+     * the \p budget has been exceeded. At least one image is uploaded per call.
+     * \return The number of uploaded textures
+     */
+    int update(std::chrono::microseconds budget);
+
+    /// Returns the counters of the loads, decodes, and uploads so far
+    Statistics statistics() const;
+
+private:
+    /// The result of a load that is passed from the worker thread to the main thread
+    struct LoadResult {
+        bool isValid = false;
+        bool isModified = true;
+        std::unique_ptr<Image> image;
+        // The encoded contents if there is no Decoder
+        std::vector<char> encoded;
+        std::string format;
+        std::string etag;
+        std::string lastModified;
+        std::string errorMessage;
+    };
+
+    struct Entry {
+        int nReferences = 0;
+        int version = 0;
+        // Identifies the most recent load, so that results of older loads are discarded
+        int loadId = 0;
+        bool isLoading = false;
+        bool hasPendingUpload = false;
+        std::string etag;
+        std::string lastModified;
+        std::unique_ptr<Image> image;
+        std::vector<char> encoded;
+        std::string format;
+        std::shared_ptr<ghoul::opengl::Texture> texture;
+        JobManager::CancellationToken token;
+    };
+
+    void load(const std::string& source, Entry& entry);
+    void finishLoad(const std::string& source, int loadId, LoadResult result);
+
+    JobManager& _jobManager;
+    Decoder _decoder;
+    std::map<std::string, Entry> _entries;
+    std::deque<std::string> _pendingUploads;
+    Statistics _statistics;
+};
+
+} // namespace openspace
+
+#endif // __TEXTURECACHE_H__
@@ -26,6 +26,7 @@
 #define __SCRIPTENGINE_H__
 
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/util/prefixindex.h>
 #include <openspace/util/syncdata.h>
 
 #include <ghoul/lua/ghoul_lua.h>
@@ -81,11 +82,25 @@ public:
 
     void queueScript(const std::string &script);
 
+    /**
+     * Returns the script that the master selected for execution in this frame during
+     * #presync, or an empty string if there is none. The script is cleared once it has
+     * been encoded for the other nodes.
+     */
+    const std::string& currentSyncedScript() const;
+
     void setLogFile(const std::string& filename, const std::string& type);
 
     std::vector<std::string> cachedScripts();
 
     std::vector<std::string> allLuaFunctions() const;
+
+    /**
+     * Returns an index of the fully qualified names of all registered Lua functions, as
+     * they are returned by #allLuaFunctions. The index is only rebuilt when a library
+     * has been added since the last call.
+     */
+    const PrefixIndex& luaFunctionIndex() const;
     
     //parallel functions
     bool parseLibraryAndFunctionNames(std::string &library, std::string &function, const std::string &script);
@@ -104,6 +119,9 @@ private:
     
     lua_State* _state = nullptr;
     std::set<LuaLibrary> _registeredLibraries;
+
+    mutable PrefixIndex _luaFunctionIndex;
+    mutable bool _luaFunctionIndexIsDirty = true;
     
     //sync variables
     std::mutex _mutex;
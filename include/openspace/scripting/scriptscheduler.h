@@ -29,7 +29,10 @@
 
 #include <openspace/scripting/lualibrary.h>
 
+#include <map>
 #include <queue>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace {
@@ -43,6 +46,50 @@ struct ReversibleLuaScript {
     std::string backwardScript;
 };
 
+/**
+ * A value that a <code>ScheduledScript</code> establishes for a property. It is converted
+ * from the schedule once when the schedule is loaded, so that setting the property does
+ * not require any Lua code to be compiled.
+ */
+struct PropertyValue {
+    enum class Type {
+        Boolean,
+        Number,
+        String,
+        Vector
+    };
+
+    Type type = Type::Number;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<double> vector;
+
+    /**
+     * Pushes the value onto the stack of \p L, in the form that
+     * <code>Property::setLuaValue</code> expects
+     */
+    void push(lua_State* L) const;
+
+    bool operator==(const PropertyValue& other) const;
+};
+
+/**
+ * The value that a property has to be set to after the <code>ScriptScheduler</code> has
+ * progressed to a new time
+ */
+struct PropertyState {
+    std::string uri;
+    PropertyValue value;
+};
+
+/**
+ * An entry of the schedule. Its <code>Time</code> is either a date string or a j2000
+ * time in seconds. It runs the scripts of its <code>ReversibleLuaScript</code> and
+ * establishes the values of its optional <code>State</code>, a list of tables with a
+ * <code>Property</code> URI and a <code>Forward</code> and/or <code>Backward</code>
+ * value, when the time passes it in the respective direction.
+ */
 struct ScheduledScript {
     ScheduledScript() : time(-DBL_MAX) { }
     ScheduledScript(const ghoul::Dictionary& dict);
@@ -50,16 +97,37 @@ struct ScheduledScript {
     double time;
     ReversibleLuaScript script;
 
+    /// The property values, keyed by their URI, that the script establishes when the
+    /// time passes it going forward
+    std::map<std::string, PropertyValue> forwardState;
+    /// The property values, keyed by their URI, that the script establishes when the
+    /// time passes it going backward
+    std::map<std::string, PropertyValue> backwardState;
+
     static bool CompareByTime(const ScheduledScript& s1, const ScheduledScript& s2);
 };
 
 
 /**
  * Maintains an ordered list of <code>ScheduledScript</code>s and provides a simple 
- * interface for retrieveing scheduled scripts
+ * interface for retrieveing scheduled scripts.
+ *
+ * Besides its scripts, every <code>ScheduledScript</code> can declare the state that it
+ * establishes as a list of property values. As these values are idempotent, a jump in
+ * time does not have to replay the entries in between; instead, the final value of each
+ * property that was touched by the jump is determined by a binary search in the entries
+ * that set this property. The state of a property at a time <code>t</code> is the
+ * forward value of the last entry at or before <code>t</code> that sets it or, if there
+ * is no such entry, the backward value of the first entry after <code>t</code>.
  */
 class ScriptScheduler {
 public:
+    ScriptScheduler() = default;
+    ~ScriptScheduler();
+
+    // The scheduler owns the Lua state that is used to apply the declared state
+    ScriptScheduler(const ScriptScheduler&) = delete;
+    ScriptScheduler& operator=(const ScriptScheduler&) = delete;
 
     /**
     * Load a schedule from a Lua-file
@@ -89,7 +157,8 @@ public:
     /**
     * Progresses the script schedulers time and returns all scripts that has been 
     * scheduled to run between \param newTime and the time provided in the last invocation 
-    * of this method.
+    * of this method. The property values that the scheduled scripts in between establish
+    * are available through #stateChanges afterwards.
     *
     * \param newTime A j2000 time value specifying the new time stamp that
     * the script scheduler should progress to.
@@ -106,7 +175,17 @@ public:
     */
     std::queue<std::string> progressTo(const std::string& timeStr);
 
+    /**
+    * Returns the final value of every property that was touched by the scheduled scripts
+    * that the last invocation of #progressTo passed. Each property occurs at most once.
+    */
+    const std::vector<PropertyState>& stateChanges() const;
 
+    /**
+    * Sets the properties to the values returned by #stateChanges. Properties that do not
+    * exist or that do not accept the type of their value are skipped with an error.
+    */
+    void applyStateChanges();
 
     /**
     * Returns the the j2000 time value that the script scheduler is currently at 
@@ -122,12 +201,40 @@ public:
     static LuaLibrary luaLibrary();
 
 private:
+    /// The indices of the scheduled scripts that set a single property, in time order,
+    /// together with the values they set it to
+    struct PropertyTimeline {
+        std::string uri;
+        std::vector<size_t> scripts;
+        std::vector<size_t> forwardScripts;
+        std::vector<PropertyValue> forwardValues;
+        std::vector<size_t> backwardScripts;
+        std::vector<PropertyValue> backwardValues;
+    };
+
+    void buildIndices();
+
+    /// Determines the state of \p timeline when \p index scripts have been passed
+    void resolveState(const PropertyTimeline& timeline, size_t index);
 
     std::vector<ScheduledScript> _scheduledScripts;
+    // The indices of the scheduled scripts that have a non-empty forward or backward
+    // script, so that a jump does not have to visit the scripts that only declare state
+    std::vector<size_t> _forwardScriptIndices;
+    std::vector<size_t> _backwardScriptIndices;
+    std::vector<PropertyTimeline> _propertyTimelines;
+    std::unordered_map<std::string, size_t> _timelineIndices;
 
     size_t _currentIndex = 0;
-    double _currentTime;
+    double _currentTime = -DBL_MAX;
+
+    std::vector<PropertyState> _stateChanges;
+    // Marks the property timelines that have been resolved in the current progression
+    std::vector<unsigned int> _resolvedGeneration;
+    unsigned int _generation = 0;
 
+    // Used to convert the property values when applying state changes
+    lua_State* _state = nullptr;
 };
 
 } // namespace scripting
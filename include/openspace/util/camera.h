@@ -25,7 +25,9 @@
 #ifndef __CAMERA_H__
 #define __CAMERA_H__
 
-#include <mutex>
+#include <array>
+#include <atomic>
+#include <memory>
 
 // open space includes
 #include <openspace/util/powerscaledcoordinate.h>
@@ -84,10 +86,116 @@ namespace openspace {
         static const Vec3 _VIEW_DIRECTION_CAMERA_SPACE;
         static const Vec3 _LOOKUP_VECTOR_CAMERA_SPACE;
     public:
+        /**
+        An immutable copy of the camera state, including all derived matrices and the
+        world space frustum planes, which are computed once when the snapshot is
+        published. Renderables and culling read only from snapshots, so they always see
+        a consistent camera even if the live camera is modified at the same time. The
+        accessors mirror the ones of the Camera.
+        */
+        class Snapshot {
+        public:
+            /// Planes are stored as (normal, distance) with normals pointing inwards
+            enum FrustumPlane {
+                Left = 0, Right, Bottom, Top, Near, Far
+            };
+
+            Snapshot();
+
+            const Vec3& positionVec3() const;
+            const Vec3& unsynchedPositionVec3() const;
+            const Vec3& focusPositionVec3() const;
+            const Vec3& viewDirectionWorldSpace() const;
+            const Vec3& lookUpVectorCameraSpace() const;
+            const Vec3& lookUpVectorWorldSpace() const;
+            const glm::vec2& scaling() const;
+            const Mat4& viewRotationMatrix() const;
+            const Quat& rotationQuaternion() const;
+            float maxFov() const;
+            float sinMaxFov() const;
+            const Mat4& combinedViewMatrix() const;
+
+            const glm::mat4& viewMatrix() const;
+            const glm::mat4& projectionMatrix() const;
+            const glm::mat4& viewProjectionMatrix() const;
+
+            /// Returns the projection matrix times the combined view matrix
+            const Mat4& combinedViewProjectionMatrix() const;
+
+            /// Returns the six frustum planes in world space, indexed by FrustumPlane
+            const std::array<glm::dvec4, 6>& frustumPlanes() const;
+
+            /// Returns a number that increases with every snapshot a camera publishes
+            uint64_t version() const;
+
+            psc position() const;
+            psc unsynchedPosition() const;
+            psc focusPosition() const;
+
+        private:
+            friend class Camera;
+
+            Vec3 _position;
+            Vec3 _focusPosition;
+            Vec3 _viewDirection;
+            Vec3 _lookUpVector;
+            Quat _rotation;
+            glm::vec2 _scaling;
+            float _maxFov;
+            float _sinMaxFov;
+            Mat4 _viewRotationMatrix;
+            Mat4 _combinedViewMatrix;
+            Mat4 _combinedViewProjectionMatrix;
+            glm::mat4 _viewMatrix;
+            glm::mat4 _projectionMatrix;
+            glm::mat4 _viewProjectionMatrix;
+            std::array<glm::dvec4, 6> _frustumPlanes;
+            uint64_t _version;
+        };
+
+        /**
+        Keeps a published Snapshot alive for as long as the reference exists. The camera
+        will never overwrite a snapshot that is referenced, so references should only be
+        held for the duration of a frame.
+        */
+        class SnapshotReference {
+        public:
+            SnapshotReference(SnapshotReference&& other);
+            ~SnapshotReference();
+
+            SnapshotReference(const SnapshotReference&) = delete;
+            SnapshotReference& operator=(const SnapshotReference&) = delete;
+            SnapshotReference& operator=(SnapshotReference&&) = delete;
+
+            const Snapshot& operator*() const;
+            const Snapshot* operator->() const;
+
+        private:
+            friend class Camera;
+            SnapshotReference(const Snapshot* snapshot, std::atomic<int>* nReaders);
+
+            const Snapshot* _snapshot;
+            std::atomic<int>* _nReaders;
+        };
+
         Camera();
         Camera(const Camera& o);
         ~Camera();
 
+        /**
+        Computes a new Snapshot from the current state of the camera and makes it the
+        one that is returned by subsequent calls to #snapshot. Has to be called from the
+        thread that owns the camera, after the SGCT matrices for the upcoming render
+        call have been set. Readers are never blocked by this.
+        */
+        void publishSnapshot();
+
+        /**
+        Returns the most recently published Snapshot. This function is lock-free and can
+        be called from any thread.
+        */
+        SnapshotReference snapshot() const;
+
         // Mutators
         void setPositionVec3(Vec3 pos);
         void setFocusPositionVec3(Vec3 pos);
@@ -152,7 +260,6 @@ namespace openspace {
 
             // Cache
             mutable Cached<glm::mat4> _cachedViewProjectionMatrix;
-            mutable std::mutex _mutex;
         } sgctInternal;
 
         // Deprecated
@@ -196,7 +303,14 @@ namespace openspace {
         mutable Cached<Mat4> _cachedCombinedViewMatrix;
         mutable Cached<float> _cachedSinMaxFov;
 
-        mutable std::mutex _mutex;
+        // Published snapshots. The live state above is only touched by the thread that
+        // owns the camera; other threads read one of these slots. A slot is only
+        // rewritten if it is neither the current one nor referenced by any reader
+        static const int NumberOfSnapshots = 3;
+        std::array<Snapshot, NumberOfSnapshots> _snapshots;
+        mutable std::array<std::atomic<int>, NumberOfSnapshots> _nSnapshotReaders;
+        std::atomic<int> _currentSnapshot;
+        uint64_t _snapshotVersion;
     };
 } // namespace openspace
 
@@ -0,0 +1,218 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __JOBMANAGER_H__
+#define __JOBMANAGER_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The JobManager owns a fixed set of worker threads that execute jobs submitted from any
+ * thread. Every worker has its own queue per priority; jobs that are submitted from a
+ * worker are placed in that worker's queue, all other jobs are distributed between the
+ * workers. A worker that runs out of work steals jobs from the other workers, always
+ * taking the highest priority job that is available. Results that have to be consumed
+ * on the main thread (for example to upload data to the GPU) are passed to
+ * continuations that are only executed when #drainMainThreadQueue is called, which the
+ * OpenSpaceEngine does once per frame.
+ */
+class JobManager {
+public:
+    enum class Priority {
+        Low = 0,
+        Normal,
+        High
+    };
+
+    /**
+     * A CancellationToken is shared between the owner of a set of jobs and the jobs
+     * themselves. Jobs and continuations whose token has been cancelled are discarded
+     * before they are executed; long running jobs can poll #isCancelled to stop early.
+     * Copies of a token refer to the same cancellation state.
+     */
+    class CancellationToken {
+    public:
+        CancellationToken();
+
+        void cancel();
+        bool isCancelled() const;
+
+    private:
+        std::shared_ptr<std::atomic_bool> _isCancelled;
+    };
+
+    struct Statistics {
+        /// The number of worker threads
+        int nWorkers;
+        /// The number of jobs that have been enqueued but not yet started
+        size_t nQueuedJobs;
+        /// The number of continuations waiting for the main thread
+        size_t nQueuedContinuations;
+        /// The total number of jobs that have been executed
+        uint64_t nFinishedJobs;
+        /// The total number of jobs that were discarded due to their cancellation
+        uint64_t nCancelledJobs;
+        /**
+         * The fraction of the available worker time that was spent executing jobs since
+         * the previous call to JobManager::statistics
+         */
+        double utilization;
+    };
+
+    /**
+     * Creates the JobManager and starts its workers.
+     * \param nWorkers The number of worker threads. If this value is <code>0</code>,
+     * one thread less than the number of hardware threads is used, leaving one for the
+     * main thread
+     */
+    explicit JobManager(int nWorkers = 0);
+
+    /**
+     * Stops the workers after the jobs that are currently executing have finished. Jobs
+     * that have not been started and pending continuations are discarded.
+     */
+    ~JobManager();
+
+    JobManager(const JobManager&) = delete;
+    JobManager& operator=(const JobManager&) = delete;
+
+    /**
+     * Enqueues the \p job for execution on one of the worker threads.
+     * \param job The function that is executed on a worker thread
+     * \param priority The priority of the job; higher priority jobs are always started
+     * before lower priority jobs
+     * \param token The token that can be used to discard the job before it starts
+     */
+    void enqueue(std::function<void()> job, Priority priority = Priority::Normal,
+        CancellationToken token = CancellationToken());
+
+    /**
+     * Enqueues the \p job for execution on one of the worker threads and passes its
+     * return value to the \p continuation, which is executed on the main thread in
+     * #drainMainThreadQueue. The continuation is not executed if the \p token was
+     * cancelled in the meantime. As both cancellation and the continuation happen on the
+     * main thread, the continuation can safely refer to the object that cancels the
+     * token on destruction.
+     * \param job The function that is executed on a worker thread. It must not return
+     * <code>void</code>
+     * \param continuation The function that receives the result on the main thread
+     * \param priority The priority of the job
+     * \param token The token that can be used to discard the job and its continuation
+     */
+    template <typename Job, typename Continuation>
+    void enqueueWithContinuation(Job job, Continuation continuation,
+        Priority priority = Priority::Normal,
+        CancellationToken token = CancellationToken());
+
+    /**
+     * Enqueues the function \p f for execution on the main thread in the next call to
+     * #drainMainThreadQueue. This function can be called from any thread.
+     */
+    void enqueueOnMainThread(std::function<void()> f,
+        CancellationToken token = CancellationToken());
+
+    /**
+     * Executes the continuations that have been queued for the main thread, in the
+     * order in which they were queued. Once the \p budget has been exceeded, the
+     * remaining continuations are left for the next call. At least one continuation is
+     * executed per call, so that every continuation eventually runs.
+     * \return The number of continuations that were executed
+     */
+    int drainMainThreadQueue(
+        std::chrono::microseconds budget = std::chrono::microseconds::max());
+
+    /**
+     * Blocks the calling thread until all enqueued jobs have either been executed or
+     * discarded. Must not be called from a worker thread.
+     */
+    void waitForIdle();
+
+    /// Returns the number of worker threads
+    int nWorkers() const;
+
+    /**
+     * Returns the current queue depths and counters. The utilization is measured since
+     * the previous call to this function.
+     */
+    Statistics statistics();
+
+private:
+    static const int NumberPriorities = 3;
+
+    struct Task {
+        std::function<void()> function;
+        CancellationToken token;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, NumberPriorities> tasks;
+    };
+
+    void work(int workerIndex);
+    bool popTask(int workerIndex, Task& task);
+    void finishTask();
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::atomic_bool _shouldStop;
+    std::atomic<unsigned int> _nextQueue;
+
+    // Jobs that were enqueued but not started yet
+    std::atomic<int64_t> _nQueuedTasks;
+    // Jobs that were enqueued but not yet executed or discarded
+    std::atomic<int64_t> _nUnfinishedTasks;
+    std::atomic<uint64_t> _nFinishedTasks;
+    std::atomic<uint64_t> _nCancelledTasks;
+    std::atomic<uint64_t> _busyNanoseconds;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _allTasksFinished;
+
+    std::mutex _mainThreadMutex;
+    std::deque<Task> _mainThreadTasks;
+
+    std::chrono::steady_clock::time_point _lastStatisticsTime;
+};
+
+} // namespace openspace
+
+#include <openspace/util/jobmanager.inl>
+
+#endif // __JOBMANAGER_H__
@@ -0,0 +1,54 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+namespace openspace {
+
+template <typename Job, typename Continuation>
+void JobManager::enqueueWithContinuation(Job job, Continuation continuation,
+                                         Priority priority, CancellationToken token)
+{
+    using Result = typename std::result_of<Job()>::type;
+    static_assert(
+        !std::is_void<Result>::value,
+        "Jobs with a continuation must return the value that is passed to it"
+    );
+
+    enqueue(
+        [this, job, continuation, token]() mutable {
+            // The result is shared as std::function requires copyable function objects
+            auto result = std::make_shared<Result>(job());
+            if (token.isCancelled()) {
+                return;
+            }
+            enqueueOnMainThread(
+                [result, continuation]() mutable { continuation(std::move(*result)); },
+                token
+            );
+        },
+        priority,
+        token
+    );
+}
+
+} // namespace openspace
@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MEMORYMAPPEDFILE_H__
+#define __MEMORYMAPPEDFILE_H__
+
+#include <ghoul/misc/exception.h>
+
+#include <string>
+
+namespace openspace {
+
+/**
+ * This class maps the full contents of a file into the address space of the process.
+ * The pages are only read from disk when they are accessed, which makes it possible to
+ * randomly access parts of very large files without reading the whole file. The
+ * mapping is released when the object is destroyed.
+ */
+class MemoryMappedFile {
+public:
+    /// The exception that is thrown if a file could not be mapped
+    struct MemoryMappedFileError : public ghoul::RuntimeError {
+        explicit MemoryMappedFileError(std::string msg);
+    };
+
+    enum class Access {
+        /// The mapped memory must not be written to
+        ReadOnly = 0,
+        /// Writes are allowed, but are private to the process and never reach the file
+        CopyOnWrite
+    };
+
+    /**
+     * Maps the file at \p filename into memory.
+     * \param filename The path to the file that is mapped
+     * \param access The way the mapped memory is going to be accessed
+     * \throw MemoryMappedFileError If the file could not be opened or mapped
+     */
+    MemoryMappedFile(std::string filename, Access access = Access::ReadOnly);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /// Returns the path of the mapped file
+    const std::string& filename() const;
+
+    /// Returns the number of bytes that are mapped
+    size_t size() const;
+
+    /// Returns a pointer to the first byte of the mapped file
+    const char* data() const;
+
+    /**
+     * Returns a writable pointer to the first byte of the mapped file. Only valid for
+     * files that were mapped with Access::CopyOnWrite
+     */
+    char* data();
+
+    /**
+     * Hints to the operating system that the specified range is going to be accessed
+     * sequentially in the near future, so that it can be read ahead.
+     */
+    void prefetch(size_t offset, size_t length) const;
+
+private:
+    std::string _filename;
+    Access _access;
+    size_t _size;
+    char* _data;
+
+#ifdef WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#else
+    int _fileDescriptor;
+#endif
+};
+
+} // namespace openspace
+
+#endif // __MEMORYMAPPEDFILE_H__
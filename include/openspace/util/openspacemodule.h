@@ -53,10 +53,24 @@ public:
     virtual ~OpenSpaceModule() = default;
 
     /**
-     * Initialization method that will register a token of the form
-     * <code>${MODULE_\<\<NAME\>\>}</code> for a specific <code>\<\<NAME\>\></code> that
-     * is set in the OpenSpaceModule constructor. This method will call the
-     * internalInitialize method for further customization for each subclass.
+     * Registers a token of the form <code>${MODULE_\<\<NAME\>\>}</code> for a specific
+     * <code>\<\<NAME\>\></code> that is set in the OpenSpaceModule constructor. This
+     * method is called on the main thread before the prepare method.
+     */
+    void registerPathToken();
+
+    /**
+     * Preparation method that will call the internalPrepare method. This method might be
+     * called on a worker thread, concurrently with the preparation or initialization of
+     * other modules, but it is only called after all #requiredModules have been
+     * initialized.
+     */
+    void prepare();
+
+    /**
+     * Initialization method that will call the internalInitialize method for further
+     * customization for each subclass. This method is always called on the main thread
+     * after the prepare method has finished.
      */
     void initialize();
     
@@ -68,7 +82,23 @@ public:
 
     virtual std::vector<Documentation> documentations() const;
 
+    /**
+     * Returns the names of the OpenSpaceModule%s that have to be initialized before this
+     * module can be prepared, for example because this module registers classes with a
+     * factory that is created by another module.
+     * \return The names of the modules that this module depends on
+     */
+    virtual std::vector<std::string> requiredModules() const;
+
 protected:
+    /**
+     * Customization point for work that is expensive, but neither requires an OpenGL
+     * context nor modifies state that is shared with other modules, such as reading
+     * catalogs from disk. The internalPrepare method is called by the prepare method and
+     * might be executed on a worker thread.
+     */
+    virtual void internalPrepare();
+
     /**
      * Customization point for each derived class. The internalInitialize method is called
      * by the initiailze method.
@@ -0,0 +1,89 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __PREFIXINDEX_H__
+#define __PREFIXINDEX_H__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A sorted index of strings that answers case-insensitive prefix queries in logarithmic
+ * time. The index is immutable between calls to #set, which is meant to be called only
+ * when the indexed set of strings changes, for example when a new Lua library is
+ * registered. All matches for a prefix are stored consecutively, so a query returns a
+ * range of indices into the index.
+ */
+class PrefixIndex {
+public:
+    /// A half-open range <code>[first, second)</code> of indices into the index
+    using Range = std::pair<size_t, size_t>;
+
+    PrefixIndex() = default;
+
+    /**
+     * Creates an index of the provided \p entries.
+     * \see PrefixIndex::set
+     */
+    explicit PrefixIndex(std::vector<std::string> entries);
+
+    /**
+     * Replaces the indexed strings with \p entries. The entries are sorted
+     * case-insensitively and duplicates are removed.
+     * \param entries The strings that are indexed
+     */
+    void set(std::vector<std::string> entries);
+
+    /**
+     * Returns the range of indices of all entries that start with \p prefix, ignoring
+     * the case of both. The range is empty if no entry starts with the \p prefix.
+     * \param prefix The prefix that is searched for
+     * \return The range of matching indices
+     */
+    Range matches(const std::string& prefix) const;
+
+    /**
+     * Returns the entry at position \p index in the sorted index.
+     * \pre \p index must be smaller than #size
+     */
+    const std::string& operator[](size_t index) const;
+
+    /// Returns the number of indexed entries
+    size_t size() const;
+
+    /// Returns whether no entries are indexed
+    bool empty() const;
+
+private:
+    // The entries sorted by their lower case version
+    std::vector<std::string> _entries;
+    // The lower case versions of _entries, which are used for the searches
+    std::vector<std::string> _keys;
+};
+
+} // namespace openspace
+
+#endif // __PREFIXINDEX_H__
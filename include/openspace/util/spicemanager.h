@@ -40,6 +40,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <tuple>
 
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
@@ -659,7 +660,10 @@ public:
     /**
      * Returns the matrix that transforms position vectors from the source reference frame
      * \p sourceFrame to the destination reference frame \p destinationFrame at the
-     * specific \p ephemerisTime.
+     * specific \p ephemerisTime. The result is cached, so that all callers that ask for
+     * the same \p sourceFrame, \p destinationFrame, and \p ephemerisTime combination
+     * in the same frame share a single SPICE query; the cache is emptied by
+     * #clearTransformCache and whenever a kernel is loaded or unloaded.
      * \param sourceFrame The name of the source reference frame
      * \param destinationFrame The name of the destination reference frame
      * \param ephemerisTime The time at which the transformation matrix is to be queried
@@ -674,6 +678,15 @@ public:
     glm::dmat3 positionTransformMatrix(const std::string& sourceFrame,
         const std::string& destinationFrame, double ephemerisTime) const;
 
+    /**
+     * Removes all cached results of the #positionTransformMatrix method. This method is
+     * called once at the beginning of every frame, before the scene graph is updated.
+     */
+    void clearTransformCache();
+
+    /// Returns the number of transformation matrices that are currently cached
+    size_t numberOfCachedTransforms() const;
+
     /**
      * Returns the transformation matrix that transforms position vectors from the
      * \p sourceFrame at the time \p ephemerisTimeFrom to the \p destinationFrame at the
@@ -913,6 +926,12 @@ private:
     
     /// The last assigned kernel-id, used to determine the next free kernel id
     KernelHandle _lastAssignedKernel = KernelHandle(0);
+
+    /// Key: Source frame, destination frame, ephemeris time
+    using TransformCacheKey = std::tuple<std::string, std::string, double>;
+    /// The cached results of #positionTransformMatrix. The transparent comparator makes
+    /// it possible to look up entries without copying the frame names
+    mutable std::map<TransformCacheKey, glm::dmat3, std::less<>> _transformCache;
 };
 
 } // namespace openspace
@@ -52,7 +52,7 @@ struct UpdateData {
 
 
 struct RenderData {
-    const Camera& camera;
+    const Camera::Snapshot& camera;
     // psc position to be removed in favor of the double precision position defined in
     // the translation in transform.
     psc position;
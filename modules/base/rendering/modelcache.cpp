@@ -0,0 +1,546 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/rendering/modelcache.h>
+
+#include <openspace/util/powerscaledcoordinate.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/stat.h>
+#ifdef WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    const std::string _loggerCat = "ModelCache";
+
+    // "OSMC" in little endian, followed by the version of the cache layout
+    const uint32_t CacheMagic = 0x434D534F;
+
+    // All blocks in the file start at a multiple of this many bytes
+    const size_t BlockAlignment = 16;
+
+    // The number of grid cells along the bounding sphere's diameter that are used for
+    // the first simplified level; every following level halves the resolution
+    const int InitialResolution = 256;
+    const int MinimumResolution = 4;
+    const int MaximumLods = 6;
+    // A simplified level is only kept if it has at most this fraction of the indices
+    // of the previous level
+    const float MinimumReduction = 0.75f;
+    // The fraction of the viewport height that a grid cell may cover before the next
+    // finer level is used; roughly two pixels on a 1080 pixel high viewport
+    const float ScreenSizePerCell = 0.002f;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexFormat;
+        uint32_t flags;
+        uint64_t fileSize;
+        uint64_t sourceSize;
+        int64_t sourceModificationTime;
+        float boundingRadius;
+        uint32_t nLods;
+    };
+
+    struct LodEntry {
+        uint64_t vertexOffset;
+        uint64_t nVertices;
+        uint64_t indexOffset;
+        uint64_t nIndices;
+        float maxScreenSize;
+        uint32_t padding;
+    };
+
+    enum HeaderFlags : uint32_t {
+        GeneratedLods = 1 << 0
+    };
+
+    size_t align(size_t offset) {
+        return (offset + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+    }
+
+    void stampFile(const std::string& path, uint64_t& size, int64_t& modificationTime) {
+        size = 0;
+        modificationTime = 0;
+#ifdef WIN32
+        struct _stat64 s;
+        if (_stat64(path.c_str(), &s) == 0) {
+#else
+        struct stat s;
+        if (stat(path.c_str(), &s) == 0) {
+#endif
+            size = static_cast<uint64_t>(s.st_size);
+            modificationTime = static_cast<int64_t>(s.st_mtime);
+        }
+    }
+
+    // Returns a name next to \p filename that no other process or thread writing the
+    // same cache file at the same time will use
+    std::string temporaryName(const std::string& filename) {
+#ifdef WIN32
+        const int processId = _getpid();
+#else
+        const int processId = static_cast<int>(getpid());
+#endif
+        const size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+        return filename + "." + std::to_string(processId) + "." +
+            std::to_string(threadId) + ".tmp";
+    }
+} // namespace
+
+namespace openspace {
+namespace modelgeometry {
+
+static_assert(sizeof(int) == sizeof(int32_t), "Indices are stored as 32 bit integers");
+static_assert(
+    sizeof(ModelCache::Vertex) == 36 && sizeof(ModelCache::CompressedVertex) == 28,
+    "The vertex layouts must not contain padding"
+);
+
+namespace {
+    // The locations are power-scaled coordinates whose exponent differs between the
+    // vertices of a mesh, so all distances are measured between the rendered positions
+    glm::dvec3 position(const ModelCache::Vertex& v) {
+        return PowerScaledCoordinate(
+            v.location[0], v.location[1], v.location[2], v.location[3]
+        ).dvec3();
+    }
+} // namespace
+
+ModelCache::ModelCache()
+    : _data(nullptr)
+    , _size(0)
+    , _vertexFormat(VertexFormat::Full)
+    , _hasGeneratedLods(false)
+    , _boundingRadius(0.f)
+{}
+
+ModelCache::~ModelCache() {}
+
+std::unique_ptr<ModelCache> ModelCache::create(const Mesh& mesh, VertexFormat format,
+                                               bool generateLods)
+{
+    if (mesh.vertices.empty() || mesh.indices.empty()) {
+        return nullptr;
+    }
+
+    const float radius = computeBoundingRadius(mesh);
+
+    // The first level is always the unchanged mesh
+    std::vector<Mesh> simplified;
+    std::vector<float> maxScreenSizes = { std::numeric_limits<float>::max() };
+    if (generateLods && (mesh.indices.size() % 3 == 0) && (radius > 0.f)) {
+        size_t nPreviousIndices = mesh.indices.size();
+        for (int resolution = InitialResolution;
+             resolution >= MinimumResolution &&
+             static_cast<int>(maxScreenSizes.size()) < MaximumLods;
+             resolution /= 2)
+        {
+            Mesh level = simplify(mesh, 2.f * radius / resolution);
+            if (level.indices.empty()) {
+                break;
+            }
+            if (level.indices.size() > MinimumReduction * nPreviousIndices) {
+                continue;
+            }
+            nPreviousIndices = level.indices.size();
+            maxScreenSizes.push_back(resolution * ScreenSizePerCell);
+            simplified.push_back(std::move(level));
+        }
+    }
+
+    std::vector<const Mesh*> levels = { &mesh };
+    for (const Mesh& m : simplified) {
+        levels.push_back(&m);
+    }
+
+    const size_t vertexSize = format == VertexFormat::Full ?
+        sizeof(Vertex) :
+        sizeof(CompressedVertex);
+
+    std::vector<LodEntry> entries(levels.size());
+    size_t offset = align(sizeof(Header) + levels.size() * sizeof(LodEntry));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        LodEntry& e = entries[i];
+        e.nVertices = levels[i]->vertices.size();
+        e.nIndices = levels[i]->indices.size();
+        e.maxScreenSize = maxScreenSizes[i];
+        e.padding = 0;
+        e.vertexOffset = offset;
+        offset = align(offset + e.nVertices * vertexSize);
+        e.indexOffset = offset;
+        offset = align(offset + e.nIndices * sizeof(int32_t));
+    }
+
+    std::unique_ptr<ModelCache> cache(new ModelCache);
+    std::vector<char>& buffer = cache->_buffer;
+    buffer.resize(offset, 0);
+
+    Header header;
+    header.magic = CacheMagic;
+    header.version = CurrentVersion;
+    header.vertexFormat = static_cast<uint32_t>(format);
+    header.flags = generateLods ? GeneratedLods : 0;
+    header.fileSize = buffer.size();
+    header.sourceSize = 0;
+    header.sourceModificationTime = 0;
+    header.boundingRadius = radius;
+    header.nLods = static_cast<uint32_t>(levels.size());
+    std::memcpy(buffer.data(), &header, sizeof(Header));
+    std::memcpy(
+        buffer.data() + sizeof(Header),
+        entries.data(),
+        entries.size() * sizeof(LodEntry)
+    );
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const Mesh& level = *levels[i];
+        char* vertices = buffer.data() + entries[i].vertexOffset;
+        if (format == VertexFormat::Full) {
+            std::memcpy(
+                vertices,
+                level.vertices.data(),
+                level.vertices.size() * sizeof(Vertex)
+            );
+        }
+        else {
+            CompressedVertex* out = reinterpret_cast<CompressedVertex*>(vertices);
+            for (const Vertex& v : level.vertices) {
+                std::copy(v.location, v.location + 4, out->location);
+                out->tex[0] = glm::packHalf1x16(v.tex[0]);
+                out->tex[1] = glm::packHalf1x16(v.tex[1]);
+                for (int c = 0; c < 3; ++c) {
+                    uint16_t normal = glm::packSnorm1x16(v.normal[c]);
+                    out->normal[c] = static_cast<int16_t>(normal);
+                }
+                out->normal[3] = 0;
+                ++out;
+            }
+        }
+
+        std::memcpy(
+            buffer.data() + entries[i].indexOffset,
+            level.indices.data(),
+            level.indices.size() * sizeof(int32_t)
+        );
+    }
+
+    cache->_data = buffer.data();
+    cache->_size = buffer.size();
+    bool success = cache->parse();
+    ghoul_assert(success, "A newly created cache must be valid");
+    return cache;
+}
+
+std::unique_ptr<ModelCache> ModelCache::open(const std::string& filename,
+                                             const std::string& sourceFile)
+{
+    std::unique_ptr<MemoryMappedFile> file;
+    try {
+        file = std::make_unique<MemoryMappedFile>(filename);
+    }
+    catch (const MemoryMappedFile::MemoryMappedFileError&) {
+        // A missing cache file is the common case on the first run
+        return nullptr;
+    }
+
+    const MemoryMappedFile& mapping = *file;
+    if (mapping.size() < sizeof(Header)) {
+        return nullptr;
+    }
+    Header header;
+    std::memcpy(&header, mapping.data(), sizeof(Header));
+    if (header.magic != CacheMagic || header.version != CurrentVersion) {
+        LDEBUG("Model cache '" << filename << "' has an outdated format");
+        return nullptr;
+    }
+
+    uint64_t sourceSize;
+    int64_t sourceModificationTime;
+    stampFile(sourceFile, sourceSize, sourceModificationTime);
+    if (header.sourceSize != sourceSize ||
+        header.sourceModificationTime != sourceModificationTime)
+    {
+        LDEBUG("Model cache '" << filename << "' is stale; '" << sourceFile <<
+            "' has changed");
+        return nullptr;
+    }
+
+    // The header was validated, which makes sure that the whole file is read ahead
+    // instead of paging it in piece by piece while it is being validated
+    mapping.prefetch(0, mapping.size());
+
+    std::unique_ptr<ModelCache> cache(new ModelCache);
+    cache->_data = mapping.data();
+    cache->_size = mapping.size();
+    cache->_file = std::move(file);
+    if (!cache->parse()) {
+        LWARNING("Model cache '" << filename << "' is corrupt");
+        return nullptr;
+    }
+    return cache;
+}
+
+bool ModelCache::readBoundingRadius(const std::string& filename, float& radius) {
+    std::ifstream file(filename, std::ifstream::binary);
+    Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+    if (!file.good() || header.magic != CacheMagic || header.version != CurrentVersion) {
+        return false;
+    }
+    radius = header.boundingRadius;
+    return true;
+}
+
+bool ModelCache::parse() {
+    Header header;
+    std::memcpy(&header, _data, sizeof(Header));
+    if (header.fileSize != _size ||
+        header.vertexFormat > static_cast<uint32_t>(VertexFormat::Compressed) ||
+        header.nLods == 0 ||
+        header.nLods > (_size - sizeof(Header)) / sizeof(LodEntry))
+    {
+        return false;
+    }
+
+    _vertexFormat = static_cast<VertexFormat>(header.vertexFormat);
+    _hasGeneratedLods = (header.flags & GeneratedLods) != 0;
+    _boundingRadius = header.boundingRadius;
+
+    const size_t vSize = vertexSize();
+    std::vector<LodEntry> entries(header.nLods);
+    std::memcpy(entries.data(), _data + sizeof(Header), header.nLods * sizeof(LodEntry));
+
+    _lods.clear();
+    _lods.reserve(entries.size());
+    for (const LodEntry& e : entries) {
+        bool isValid =
+            (e.vertexOffset % BlockAlignment == 0) &&
+            (e.indexOffset % BlockAlignment == 0) &&
+            (e.vertexOffset <= _size) &&
+            (e.indexOffset <= _size) &&
+            (e.nVertices > 0) &&
+            (e.nIndices > 0) &&
+            (e.nVertices <= (_size - e.vertexOffset) / vSize) &&
+            (e.nIndices <= (_size - e.indexOffset) / sizeof(int32_t));
+        if (!isValid) {
+            return false;
+        }
+
+        Lod lod;
+        lod.vertices = _data + e.vertexOffset;
+        lod.nVertices = e.nVertices;
+        lod.indices = reinterpret_cast<const int32_t*>(_data + e.indexOffset);
+        lod.nIndices = e.nIndices;
+        lod.maxScreenSize = e.maxScreenSize;
+
+        // An index out of range would make the GPU read outside of the vertex buffer
+        for (uint64_t i = 0; i < lod.nIndices; ++i) {
+            const int32_t index = lod.indices[i];
+            if (index < 0 || static_cast<uint64_t>(index) >= lod.nVertices) {
+                return false;
+            }
+        }
+        _lods.push_back(lod);
+    }
+    return true;
+}
+
+bool ModelCache::save(const std::string& filename, const std::string& sourceFile) const {
+    Header header;
+    std::memcpy(&header, _data, sizeof(Header));
+    stampFile(sourceFile, header.sourceSize, header.sourceModificationTime);
+
+    // Write into a temporary file first so that a crash can never leave a truncated
+    // cache file behind that would be mapped the next time
+    std::string temporaryFile = temporaryName(filename);
+    {
+        std::ofstream file(temporaryFile, std::ofstream::binary);
+        if (!file.good()) {
+            LWARNING("Could not create model cache '" << filename << "'");
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(_data + sizeof(Header), _size - sizeof(Header));
+        if (!file.good()) {
+            LWARNING("Could not write model cache '" << filename << "'");
+            return false;
+        }
+    }
+    std::remove(filename.c_str());
+    if (std::rename(temporaryFile.c_str(), filename.c_str()) != 0) {
+        LWARNING("Could not move model cache into place at '" << filename << "'");
+        std::remove(temporaryFile.c_str());
+        return false;
+    }
+    return true;
+}
+
+ModelCache::Mesh ModelCache::simplify(const Mesh& mesh, float cellSize) {
+    ghoul_assert(cellSize > 0.f, "The cell size must be positive");
+    ghoul_assert(mesh.indices.size() % 3 == 0, "The mesh must consist of triangles");
+
+    // The grid is anchored at the minimum corner of the bounding box so that all cell
+    // coordinates are positive and fit into 21 bits each
+    std::vector<glm::dvec3> positions(mesh.vertices.size());
+    glm::dvec3 minimum(std::numeric_limits<double>::max());
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        positions[i] = position(mesh.vertices[i]);
+        minimum = glm::min(minimum, positions[i]);
+    }
+
+    const uint64_t CellMask = (1 << 21) - 1;
+    auto cellKey = [&](size_t i) -> uint64_t {
+        glm::dvec3 p = positions[i] - minimum;
+        uint64_t key = 0;
+        for (int c = 0; c < 3; ++c) {
+            uint64_t cell = static_cast<uint64_t>(p[c] / cellSize);
+            key = (key << 21) | std::min(cell, CellMask);
+        }
+        return key;
+    };
+
+    // The first vertex that falls into a cell represents all vertices of that cell
+    std::unordered_map<uint64_t, int> cellRepresentatives;
+    cellRepresentatives.reserve(mesh.vertices.size());
+    std::vector<int> representative(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        auto it = cellRepresentatives.emplace(
+            cellKey(i),
+            static_cast<int>(i)
+        ).first;
+        representative[i] = it->second;
+    }
+
+    // Only representatives that are used by a remaining triangle are kept
+    Mesh result;
+    std::vector<int> newIndex(mesh.vertices.size(), -1);
+    auto mapIndex = [&](int i) {
+        int& n = newIndex[i];
+        if (n == -1) {
+            n = static_cast<int>(result.vertices.size());
+            result.vertices.push_back(mesh.vertices[i]);
+        }
+        return n;
+    };
+
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        int a = representative[mesh.indices[t]];
+        int b = representative[mesh.indices[t + 1]];
+        int c = representative[mesh.indices[t + 2]];
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+        result.indices.push_back(mapIndex(a));
+        result.indices.push_back(mapIndex(b));
+        result.indices.push_back(mapIndex(c));
+    }
+    return result;
+}
+
+float ModelCache::computeBoundingRadius(const Mesh& mesh) {
+    double maxDistSquared = 0.0;
+    for (const Vertex& v : mesh.vertices) {
+        glm::dvec3 p = position(v);
+        maxDistSquared = std::max(maxDistSquared, glm::dot(p, p));
+    }
+    return static_cast<float>(std::sqrt(maxDistSquared));
+}
+
+ModelCache::VertexFormat ModelCache::vertexFormat() const {
+    return _vertexFormat;
+}
+
+size_t ModelCache::vertexSize() const {
+    return _vertexFormat == VertexFormat::Full ?
+        sizeof(Vertex) :
+        sizeof(CompressedVertex);
+}
+
+bool ModelCache::hasGeneratedLods() const {
+    return _hasGeneratedLods;
+}
+
+float ModelCache::boundingRadius() const {
+    return _boundingRadius;
+}
+
+const std::vector<ModelCache::Lod>& ModelCache::lods() const {
+    return _lods;
+}
+
+size_t ModelCache::selectLod(float screenSize) const {
+    for (size_t i = _lods.size() - 1; i > 0; --i) {
+        if (screenSize <= _lods[i].maxScreenSize) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+ModelCache::Mesh ModelCache::decode(size_t lod) const {
+    ghoul_assert(lod < _lods.size(), "Level of detail out of range");
+    const Lod& l = _lods[lod];
+
+    Mesh mesh;
+    mesh.vertices.resize(l.nVertices);
+    if (_vertexFormat == VertexFormat::Full) {
+        std::memcpy(mesh.vertices.data(), l.vertices, l.nVertices * sizeof(Vertex));
+    }
+    else {
+        auto in = reinterpret_cast<const CompressedVertex*>(l.vertices);
+        for (Vertex& v : mesh.vertices) {
+            std::copy(in->location, in->location + 4, v.location);
+            v.tex[0] = glm::unpackHalf1x16(in->tex[0]);
+            v.tex[1] = glm::unpackHalf1x16(in->tex[1]);
+            for (int c = 0; c < 3; ++c) {
+                v.normal[c] = glm::unpackSnorm1x16(static_cast<uint16_t>(in->normal[c]));
+            }
+            ++in;
+        }
+    }
+    mesh.indices.assign(l.indices, l.indices + l.nIndices);
+    return mesh;
+}
+
+}  // namespace modelgeometry
+}  // namespace openspace
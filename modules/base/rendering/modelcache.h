@@ -0,0 +1,189 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MODELCACHE_H__
+#define __MODELCACHE_H__
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openspace {
+namespace modelgeometry {
+
+/**
+ * The ModelCache is the binary representation of a model geometry that is stored in the
+ * cache directory. The file starts with a header and a table of levels of detail, which
+ * are followed by the vertex and index blocks of every level. All blocks are aligned so
+ * that a cache file can be memory mapped by #open and passed to the GPU without any
+ * parsing. The first level always contains the full geometry, the following levels are
+ * simplified versions (see #simplify) that are used when the model only covers a small
+ * part of the screen. Optionally, the texture coordinates and normals are stored in a
+ * compressed form (see CompressedVertex) that OpenGL can consume directly.
+ */
+class ModelCache {
+public:
+    /// The vertex layout of the full precision vertices
+    struct Vertex {
+        float location[4];
+        float tex[2];
+        float normal[3];
+    };
+
+    /**
+     * The vertex layout of the compressed vertices. The position is unchanged, the
+     * texture coordinates are stored as half floats and the normal as normalized 16 bit
+     * integers, the fourth component of which is unused padding
+     */
+    struct CompressedVertex {
+        float location[4];
+        uint16_t tex[2];
+        int16_t normal[4];
+    };
+
+    enum class VertexFormat : uint32_t {
+        Full = 0,
+        Compressed = 1
+    };
+
+    /// An indexed triangle mesh in the layout that is used by the ModelGeometry
+    struct Mesh {
+        std::vector<Vertex> vertices;
+        std::vector<int> indices;
+    };
+
+    /// One level of detail inside the cache. The pointers refer to the cache's storage
+    struct Lod {
+        /// The vertices of this level, in the vertex format of the cache
+        const void* vertices;
+        uint64_t nVertices;
+        const int32_t* indices;
+        uint64_t nIndices;
+        /**
+         * The largest screen size (the fraction of the viewport height covered by the
+         * bounding sphere) at which this level is used
+         */
+        float maxScreenSize;
+    };
+
+    static const uint32_t CurrentVersion = 4;
+
+    /**
+     * Creates a cache in memory from the \p mesh. If \p generateLods is
+     * <code>true</code>, simplified levels of detail are generated for triangle meshes.
+     * \param mesh The full resolution geometry
+     * \param format The format in which the vertices are stored
+     * \param generateLods Whether simplified levels of detail should be generated
+     * \return The cache, or <code>nullptr</code> if the \p mesh is empty
+     */
+    static std::unique_ptr<ModelCache> create(const Mesh& mesh, VertexFormat format,
+        bool generateLods = true);
+
+    /**
+     * Memory maps the cache file \p filename and validates its contents. The pages of
+     * the file are touched during validation so that no page faults occur when the
+     * data is used later; this function is meant to be called on a worker thread.
+     * \param filename The path of the cache file
+     * \param sourceFile The model file from which the cache was created
+     * \return The cache, or <code>nullptr</code> if the file does not exist, has been
+     * written with a different version, is corrupted, or if \p sourceFile has changed
+     * since the cache was saved
+     */
+    static std::unique_ptr<ModelCache> open(const std::string& filename,
+        const std::string& sourceFile);
+
+    /**
+     * Reads only the bounding radius from the header of the cache file \p filename.
+     * \return <code>true</code> if the file is a cache file of the current version
+     */
+    static bool readBoundingRadius(const std::string& filename, float& radius);
+
+    /**
+     * Simplifies the \p mesh by vertex clustering. All vertices whose rendered position
+     * (the power-scaled location) falls into the same cell of a regular grid with the
+     * spacing \p cellSize are replaced by the first of them, triangles that become
+     * degenerate are removed, and vertices that are no longer used are dropped.
+     * \pre \p cellSize must be positive
+     * \pre The number of indices of \p mesh must be a multiple of 3
+     */
+    static Mesh simplify(const Mesh& mesh, float cellSize);
+
+    /// Returns the largest distance of a rendered vertex position to the origin
+    static float computeBoundingRadius(const Mesh& mesh);
+
+    ~ModelCache();
+
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    /**
+     * Writes the cache to \p filename so that it can be opened with #open. The size and
+     * modification time of \p sourceFile are stored to detect stale caches.
+     */
+    bool save(const std::string& filename, const std::string& sourceFile) const;
+
+    VertexFormat vertexFormat() const;
+    /// Returns the size in bytes of a single vertex in the cache's vertex format
+    size_t vertexSize() const;
+    /// Returns whether simplified levels of detail were requested for this cache
+    bool hasGeneratedLods() const;
+    float boundingRadius() const;
+    const std::vector<Lod>& lods() const;
+
+    /**
+     * Returns the index of the coarsest level whose maximum screen size is not exceeded
+     * by \p screenSize.
+     */
+    size_t selectLod(float screenSize) const;
+
+    /// Decodes the level \p lod into full precision vertices
+    Mesh decode(size_t lod) const;
+
+private:
+    ModelCache();
+
+    // Parses and validates the table of levels of detail in _data
+    bool parse();
+
+    // Used if the cache was created in memory
+    std::vector<char> _buffer;
+    // Used if the cache was memory mapped
+    std::unique_ptr<MemoryMappedFile> _file;
+
+    const char* _data;
+    size_t _size;
+
+    VertexFormat _vertexFormat;
+    bool _hasGeneratedLods;
+    float _boundingRadius;
+    std::vector<Lod> _lods;
+};
+
+}  // namespace modelgeometry
+}  // namespace openspace
+
+#endif  // __MODELCACHE_H__
@@ -23,19 +23,21 @@
  ****************************************************************************************/
 
 #include <modules/base/rendering/modelgeometry.h>
+#include <openspace/engine/openspaceengine.h>
 #include <openspace/util/factorymanager.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 
-#include <fstream>
+#include <array>
 
 namespace {
     const std::string _loggerCat = "ModelGeometry";
     const std::string keyGeomModelFile = "GeometryFile";
-    const int8_t CurrentCacheVersion = 3;
     const std::string keyType = "Type";
     const std::string keyName = "Name";
     const std::string keySize = "Magnification";
+    const std::string keyCompressAttributes = "CompressVertexAttributes";
+    const std::string keyGenerateLods = "GenerateLevelsOfDetail";
 }
 
 namespace openspace {
@@ -62,10 +64,18 @@ ModelGeometry* ModelGeometry::createFromDictionary(const ghoul::Dictionary& dict
     return result;
 }
 
-ModelGeometry::ModelGeometry(const ghoul::Dictionary& dictionary)
+ModelGeometry::ModelGeometry(const ghoul::Dictionary& dictionary, ModelLoader loader)
     : _parent(nullptr)
     , _magnification("magnification", "Magnification", 1.f, 0.f, 10.f)
+    , _compressAttributes(false)
+    , _generateLods(true)
     , _mode(GL_TRIANGLES)
+    , _placeholder({ 0, 0, 0, 0, 0.f })
+    , _currentLevel(0)
+    , _boundingRadius(0.f)
+    , _isLoaded(false)
+    , _setsBoundingSphere(false)
+    , _loader(std::move(loader))
 {
     setName("ModelGeometry");
 
@@ -76,6 +86,12 @@ ModelGeometry::ModelGeometry(const ghoul::Dictionary& dictionary)
     if (dictionary.hasKeyAndValue<double>(keySize))
         _magnification = static_cast<float>(dictionary.value<double>(keySize));
 
+    if (dictionary.hasKeyAndValue<bool>(keyCompressAttributes))
+        _compressAttributes = dictionary.value<bool>(keyCompressAttributes);
+
+    if (dictionary.hasKeyAndValue<bool>(keyGenerateLods))
+        _generateLods = dictionary.value<bool>(keyGenerateLods);
+
     success = dictionary.getValue(keyGeomModelFile, _file);
     if (!success) {
         LERROR("Geometric Model file of '" << name << "' did not provide a key '"
@@ -106,154 +122,274 @@ double ModelGeometry::boundingRadius() const {
 
 
 ModelGeometry::~ModelGeometry() {
+    stopLoading();
 }
 
 void ModelGeometry::render() {
-    glBindVertexArray(_vaoID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
-    glDrawElements(_mode, static_cast<GLsizei>(_indices.size()), GL_UNSIGNED_INT, 0);
+    const LevelOfDetail& lod = _isLoaded ? _levelsOfDetail[_currentLevel] : _placeholder;
+    if (lod.vaoID == 0) {
+        // The model could not be loaded
+        return;
+    }
+
+    glBindVertexArray(lod.vaoID);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod.ibo);
+    glDrawElements(_isLoaded ? _mode : GL_TRIANGLES, lod.nIndices, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
+void ModelGeometry::selectLevelOfDetail(const glm::dmat4& modelViewTransform,
+                                        const glm::mat4& projectionTransform)
+{
+    _currentLevel = 0;
+    // The simplified levels only exist for triangle meshes
+    if (!_isLoaded || _levelsOfDetail.size() < 2 || _mode != GL_TRIANGLES) {
+        return;
+    }
+
+    glm::dvec3 center = glm::dvec3(modelViewTransform * glm::dvec4(0.0, 0.0, 0.0, 1.0));
+    double scale = glm::length(glm::dvec3(modelViewTransform[0]));
+    double radius = _boundingRadius * std::pow(10.0, _magnification.value()) * scale;
+    double distance = glm::length(center);
+    if (distance <= radius) {
+        return;
+    }
+
+    // The fraction of the viewport height that the bounding sphere's diameter covers
+    float screenSize = static_cast<float>(radius * projectionTransform[1][1] / distance);
+    for (size_t i = _levelsOfDetail.size() - 1; i > 0; --i) {
+        if (screenSize <= _levelsOfDetail[i].maxScreenSize) {
+            _currentLevel = i;
+            return;
+        }
+    }
+}
+
+bool ModelGeometry::isLoaded() const {
+    return _isLoaded;
+}
+
 void ModelGeometry::changeRenderMode(const GLenum mode) {
     _mode = mode;
 }
 
 bool ModelGeometry::initialize(Renderable* parent) {
     _parent = parent;
-    float maximumDistanceSquared = 0;
-    for (auto v: _vertices)
-    {
-        maximumDistanceSquared = glm::max(
-            glm::pow(v.location[0], 2.f) +
-            glm::pow(v.location[1], 2.f) +
-            glm::pow(v.location[2], 2.f), maximumDistanceSquared);
-    }
-    _parent->setBoundingSphere(PowerScaledScalar(glm::sqrt(maximumDistanceSquared), 0.0));
-
-    if (_vertices.empty())
-        return false;
-    glGenVertexArrays(1, &_vaoID);
-    glGenBuffers(1, &_vbo);
-    glGenBuffers(1, &_ibo);
-
-    glBindVertexArray(_vaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, _vertices.size() * sizeof(Vertex), _vertices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        reinterpret_cast<const GLvoid*>(offsetof(Vertex, location)));
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        reinterpret_cast<const GLvoid*>(offsetof(Vertex, tex)));
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        reinterpret_cast<const GLvoid*>(offsetof(Vertex, normal)));
+    _setsBoundingSphere = (_parent->getBoundingSphere().lengthf() == 0.f);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indices.size() * sizeof(int), _indices.data(), GL_STATIC_DRAW);
+    _cachedFile = FileSys.cacheManager()->cachedFilename(
+        _file,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
 
-    glBindVertexArray(0);
+    // If the model was cached before, the placeholder already gets the right size
+    float radius = 1.f;
+    if (ModelCache::readBoundingRadius(_cachedFile, radius) && _setsBoundingSphere) {
+        _parent->setBoundingSphere(PowerScaledScalar(radius, 0.0));
+    }
+    createPlaceholder(radius);
 
+    startLoading();
     return true;
 }
 
 void ModelGeometry::deinitialize() {
-    glDeleteBuffers(1, &_vbo);
-    glDeleteVertexArrays(1, &_vaoID);
-    glDeleteBuffers(1, &_ibo);
+    stopLoading();
+
+    for (LevelOfDetail& lod : _levelsOfDetail) {
+        release(lod);
+    }
+    _levelsOfDetail.clear();
+    release(_placeholder);
+    _currentLevel = 0;
+    _isLoaded = false;
 }
 
-bool ModelGeometry::loadObj(const std::string& filename) {
-    std::string cachedFile = FileSys.cacheManager()->cachedFilename(
-        filename,
-        ghoul::filesystem::CacheManager::Persistent::Yes
-        );
+void ModelGeometry::startLoading() {
+    _loadToken = JobManager::CancellationToken();
+
+    // The job only works on copies, so that it never refers to this object, which might
+    // be destroyed while the job is still running
+    JobManager::CancellationToken token = _loadToken;
+    ModelLoader loader = _loader;
+    std::string file = _file;
+    std::string cachedFile = _cachedFile;
+    ModelCache::VertexFormat format = _compressAttributes ?
+        ModelCache::VertexFormat::Compressed :
+        ModelCache::VertexFormat::Full;
+    bool generateLods = _generateLods;
+
+    OsEng.jobManager().enqueueWithContinuation(
+        [token, loader, file, cachedFile, format, generateLods]() {
+            LoadResult result;
+            result.cache = ModelCache::open(cachedFile, file);
+            bool isUsable =
+                result.cache &&
+                result.cache->vertexFormat() == format &&
+                result.cache->hasGeneratedLods() == generateLods;
+            if (isUsable) {
+                LINFO("Cached file '" << cachedFile << "' used for Model file '" <<
+                    file << "'");
+                result.mesh = result.cache->decode(0);
+                return result;
+            }
+
+            LINFO("Loading Model file '" << file << "'");
+            ModelCache::Mesh mesh;
+            if (token.isCancelled() || !loader(file, mesh)) {
+                result.cache = nullptr;
+                return result;
+            }
+            result.cache = ModelCache::create(mesh, format, generateLods);
+            if (result.cache) {
+                result.cache->save(cachedFile, file);
+            }
+            result.mesh = std::move(mesh);
+            return result;
+        },
+        [this](LoadResult result) { uploadGeometry(std::move(result)); },
+        JobManager::Priority::Normal,
+        _loadToken
+    );
+}
 
-    bool hasCachedFile = FileSys.fileExists(cachedFile);
-    if (hasCachedFile) {
-        LINFO("Cached file '" << cachedFile << "' used for Model file '" << filename << "'");
-
-        bool success = loadCachedFile(cachedFile);
-        if (success)
-            return true;
-        else
-            FileSys.cacheManager()->removeCacheFile(filename);
-        // Intentional fall-through to the 'else' computation to generate the cache
-        // file for the next run
-    }
-    else {
-        LINFO("Cached file '" << cachedFile << "' used for Model file '" << filename << "' not found");
-    }
+void ModelGeometry::stopLoading() {
+    // A running job finishes on its own, but its result is discarded
+    _loadToken.cancel();
+}
 
-    LINFO("Loading Model file '" << filename << "'");
-    bool success = loadModel(filename);
+void ModelGeometry::uploadGeometry(LoadResult result) {
+    // The placeholder is not shown for models that failed to load either
+    release(_placeholder);
+    if (!result.cache) {
+        LERROR("Could not load the geometric model file '" << _file << "'");
+        return;
+    }
 
-    if (!success)
-        return false;
+    const ModelCache& cache = *result.cache;
+    for (const ModelCache::Lod& l : cache.lods()) {
+        LevelOfDetail lod = upload(
+            l.vertices,
+            l.nVertices,
+            cache.vertexFormat(),
+            l.indices,
+            l.nIndices
+        );
+        lod.maxScreenSize = l.maxScreenSize;
+        _levelsOfDetail.push_back(lod);
+    }
 
-    LINFO("Saving cache");
-    success = saveCachedFile(cachedFile);
+    _vertices = std::move(result.mesh.vertices);
+    _indices = std::move(result.mesh.indices);
+    _boundingRadius = cache.boundingRadius();
+    if (_setsBoundingSphere) {
+        _parent->setBoundingSphere(PowerScaledScalar(_boundingRadius, 0.0));
+    }
+    _isLoaded = true;
+}
 
-    return success;
+void ModelGeometry::createPlaceholder(float radius) {
+    // An octahedron that covers the model is shown until the model is loaded
+    const std::array<glm::vec3, 6> directions = {
+        glm::vec3(1.f, 0.f, 0.f), glm::vec3(-1.f, 0.f, 0.f),
+        glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, -1.f, 0.f),
+        glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 0.f, -1.f)
+    };
+    std::array<Vertex, 6> vertices;
+    for (size_t i = 0; i < directions.size(); ++i) {
+        const glm::vec3& d = directions[i];
+        vertices[i] = {
+            { radius * d.x, radius * d.y, radius * d.z, 1.f },
+            { 0.5f, 0.5f },
+            { d.x, d.y, d.z }
+        };
+    }
+    const std::array<int32_t, 24> indices = {
+        0, 2, 4,   2, 1, 4,   1, 3, 4,   3, 0, 4,
+        2, 0, 5,   1, 2, 5,   3, 1, 5,   0, 3, 5
+    };
+
+    _placeholder = upload(
+        vertices.data(),
+        vertices.size(),
+        ModelCache::VertexFormat::Full,
+        indices.data(),
+        indices.size()
+    );
 }
 
-bool ModelGeometry::saveCachedFile(const std::string& filename) {
-    std::ofstream fileStream(filename, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t));
+ModelGeometry::LevelOfDetail ModelGeometry::upload(const void* vertices,
+                                                   size_t nVertices,
+                                                   ModelCache::VertexFormat format,
+                                                   const int32_t* indices,
+                                                   size_t nIndices)
+{
+    LevelOfDetail lod;
+    lod.nIndices = static_cast<GLsizei>(nIndices);
+    lod.maxScreenSize = 0.f;
 
-        int64_t vSize = _vertices.size();
-        fileStream.write(reinterpret_cast<const char*>(&vSize), sizeof(int64_t));
-        int64_t iSize = _indices.size();
-        fileStream.write(reinterpret_cast<const char*>(&iSize), sizeof(int64_t));
+    glGenVertexArrays(1, &lod.vaoID);
+    glGenBuffers(1, &lod.vbo);
+    glGenBuffers(1, &lod.ibo);
 
-        fileStream.write(reinterpret_cast<const char*>(_vertices.data()), sizeof(Vertex) * vSize);
-        fileStream.write(reinterpret_cast<const char*>(_indices.data()), sizeof(int) * iSize);
+    glBindVertexArray(lod.vaoID);
+    glBindBuffer(GL_ARRAY_BUFFER, lod.vbo);
 
-        return fileStream.good();
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    if (format == ModelCache::VertexFormat::Full) {
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            nVertices * sizeof(Vertex),
+            vertices,
+            GL_STATIC_DRAW
+        );
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+            reinterpret_cast<const GLvoid*>(offsetof(Vertex, location)));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+            reinterpret_cast<const GLvoid*>(offsetof(Vertex, tex)));
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+            reinterpret_cast<const GLvoid*>(offsetof(Vertex, normal)));
     }
     else {
-        LERROR("Error opening file '" << filename << "' for save cache file");
-        return false;
+        // The normalized shorts are converted to [-1, 1] by OpenGL, so the shaders do
+        // not depend on the vertex format
+        using CompressedVertex = ModelCache::CompressedVertex;
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            nVertices * sizeof(CompressedVertex),
+            vertices,
+            GL_STATIC_DRAW
+        );
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(CompressedVertex),
+            reinterpret_cast<const GLvoid*>(offsetof(CompressedVertex, location)));
+        glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompressedVertex),
+            reinterpret_cast<const GLvoid*>(offsetof(CompressedVertex, tex)));
+        glVertexAttribPointer(2, 3, GL_SHORT, GL_TRUE, sizeof(CompressedVertex),
+            reinterpret_cast<const GLvoid*>(offsetof(CompressedVertex, normal)));
     }
-}
-
-bool ModelGeometry::loadCachedFile(const std::string& filename) {
-    std::ifstream fileStream(filename, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed, deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(filename);
-            return false;
-        }
 
-        int64_t vSize, iSize;
-        fileStream.read(reinterpret_cast<char*>(&vSize), sizeof(int64_t));
-        fileStream.read(reinterpret_cast<char*>(&iSize), sizeof(int64_t));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod.ibo);
+    glBufferData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        nIndices * sizeof(int32_t),
+        indices,
+        GL_STATIC_DRAW
+    );
 
-        if (vSize == 0 || iSize == 0) {
-            LERROR("Error opening file '" << filename << "' for loading cache file");
-            return false;
-        }
-
-        _vertices.resize(vSize);
-        _indices.resize(iSize);
-
-        fileStream.read(reinterpret_cast<char*>(_vertices.data()), sizeof(Vertex) * vSize);
-        fileStream.read(reinterpret_cast<char*>(_indices.data()), sizeof(int) * iSize);
+    glBindVertexArray(0);
+    return lod;
+}
 
-        return fileStream.good();
-    }
-    else {
-        LERROR("Error opening file '" << filename << "' for loading cache file");
-        return false;
+void ModelGeometry::release(LevelOfDetail& lod) {
+    if (lod.vaoID == 0) {
+        return;
     }
+    glDeleteBuffers(1, &lod.vbo);
+    glDeleteVertexArrays(1, &lod.vaoID);
+    glDeleteBuffers(1, &lod.ibo);
+    lod = { 0, 0, 0, 0, 0.f };
 }
 
 bool ModelGeometry::getVertices(std::vector<Vertex>* vertexList) {
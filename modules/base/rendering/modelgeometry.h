@@ -28,29 +28,55 @@
 #include <openspace/properties/propertyowner.h>
 
 #include <openspace/properties/scalarproperty.h>
+#include <openspace/util/jobmanager.h>
+#include <modules/base/rendering/modelcache.h>
 #include <modules/base/rendering/renderablemodel.h>
 #include <ghoul/misc/dictionary.h>
 
+#include <functional>
+
 namespace openspace {
 
 namespace modelgeometry {
 
+/**
+ * The ModelGeometry loads its model file on a worker thread of the JobManager and
+ * renders a placeholder until the geometry has been uploaded. The geometry is stored in
+ * a ModelCache next to the model file's cache, so that subsequent runs only have to map
+ * the cache file instead of parsing the model. If the cache contains several levels of
+ * detail, #selectLevelOfDetail chooses the level that is drawn by #render.
+ */
 class ModelGeometry : public properties::PropertyOwner {
 public:
     static ModelGeometry* createFromDictionary(const ghoul::Dictionary& dictionary);
 
-    struct Vertex {
-        GLfloat location[4];
-        GLfloat tex[2];
-        GLfloat normal[3];
-    };
+    using Vertex = ModelCache::Vertex;
 
-    ModelGeometry(const ghoul::Dictionary& dictionary);
+    /**
+     * Reads the model file that is passed as the first argument into the mesh that is
+     * passed as the second argument and returns whether this succeeded. The loader is
+     * called on a worker thread, which can still be running after the ModelGeometry has
+     * been destroyed, so it must not refer to the ModelGeometry.
+     */
+    using ModelLoader = std::function<bool(const std::string&, ModelCache::Mesh&)>;
+
+    ModelGeometry(const ghoul::Dictionary& dictionary, ModelLoader loader);
     virtual ~ModelGeometry();
     virtual bool initialize(Renderable* parent);
     virtual void deinitialize();
     void render();
-    virtual bool loadModel(const std::string& filename) = 0;
+
+    /**
+     * Selects the level of detail that is rendered based on the fraction of the screen
+     * that the bounding sphere of the model covers. Without a call to this function, the
+     * full resolution geometry is rendered.
+     */
+    void selectLevelOfDetail(const glm::dmat4& modelViewTransform,
+        const glm::mat4& projectionTransform);
+
+    /// Returns whether the geometry has been loaded and uploaded to the GPU
+    bool isLoaded() const;
+
     void changeRenderMode(const GLenum mode);
     bool getVertices(std::vector<Vertex>* vertexList);
     bool getIndices(std::vector<int>* indexList);
@@ -60,21 +86,51 @@ public:
     virtual void setUniforms(ghoul::opengl::ProgramObject& program);
 
 protected:
+    struct LevelOfDetail {
+        GLuint vaoID;
+        GLuint vbo;
+        GLuint ibo;
+        GLsizei nIndices;
+        float maxScreenSize;
+    };
+
+    struct LoadResult {
+        std::unique_ptr<ModelCache> cache;
+        ModelCache::Mesh mesh;
+    };
+
     Renderable* _parent;
 
-    bool loadObj(const std::string& filename);
-    bool loadCachedFile(const std::string& filename);
-    bool saveCachedFile(const std::string& filename);
+    void startLoading();
+    void stopLoading();
+    void uploadGeometry(LoadResult result);
+    void createPlaceholder(float radius);
+    static LevelOfDetail upload(const void* vertices, size_t nVertices,
+        ModelCache::VertexFormat format, const int32_t* indices, size_t nIndices);
+    static void release(LevelOfDetail& lod);
+
     properties::FloatProperty _magnification;
 
-    GLuint _vaoID;
-    GLuint _vbo;
-    GLuint _ibo;
+    bool _compressAttributes;
+    bool _generateLods;
+
     GLenum _mode;
 
+    LevelOfDetail _placeholder;
+    std::vector<LevelOfDetail> _levelsOfDetail;
+    size_t _currentLevel;
+    float _boundingRadius;
+    bool _isLoaded;
+    // Renderables that specify their own bounding sphere keep it
+    bool _setsBoundingSphere;
+
+    ModelLoader _loader;
+    JobManager::CancellationToken _loadToken;
+
     std::vector<Vertex> _vertices;
     std::vector<int> _indices;
     std::string _file;
+    std::string _cachedFile;
 };
 
 }  // namespace modelgeometry
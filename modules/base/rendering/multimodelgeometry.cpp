@@ -38,10 +38,8 @@ namespace openspace {
     namespace modelgeometry {
 
         MultiModelGeometry::MultiModelGeometry(const ghoul::Dictionary& dictionary)
-            : ModelGeometry(dictionary)
-        {
-            loadObj(_file);
-        }
+            : ModelGeometry(dictionary, &MultiModelGeometry::loadModel)
+        {}
 
         bool MultiModelGeometry::initialize(Renderable* parent)
         {
@@ -54,7 +52,8 @@ namespace openspace {
             ModelGeometry::deinitialize();
         }
 
-        bool MultiModelGeometry::loadModel(const std::string& filename) 
+        bool MultiModelGeometry::loadModel(const std::string& filename,
+                                           ModelCache::Mesh& mesh)
         {
             try {
                 ghoul::io::ModelReaderMultiFormat modelReader;
@@ -64,7 +63,7 @@ namespace openspace {
 
                 modelReader.loadModel(filename, vertices, indices);
          
-                _vertices.reserve(vertices.size());
+                mesh.vertices.reserve(vertices.size());
                 for (const auto & v : vertices)
                 {
                     psc p = PowerScaledCoordinate::CreatePowerScaledCoordinate(
@@ -79,11 +78,11 @@ namespace openspace {
                     //memcpy(vv.location, glm::value_ptr(p.vec4()), sizeof(GLfloat) * 4);
                     memcpy(vv.tex, v.tex, sizeof(GLfloat) * 2);
                     memcpy(vv.normal, v.normal, sizeof(GLfloat) * 3);
-                    _vertices.push_back(vv);
+                    mesh.vertices.push_back(vv);
                 }
 
-                _indices.resize(indices.size());                
-                std::copy(indices.begin(), indices.end(), _indices.begin());
+                mesh.indices.resize(indices.size());
+                std::copy(indices.begin(), indices.end(), mesh.indices.begin());
             }
             catch (ghoul::io::ModelReaderBase::ModelReaderException & e)
             {
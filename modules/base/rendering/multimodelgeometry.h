@@ -42,7 +42,8 @@ namespace openspace {
             void deinitialize() override;
 
         private:
-            bool loadModel(const std::string& filename);
+            static bool loadModel(const std::string& filename,
+                ModelCache::Mesh& mesh);
         };
 
     }  // namespace modelgeometry
@@ -233,6 +233,7 @@ void RenderableModel::render(const RenderData& data) {
     _texture->bind();
     _programObject->setUniform("texture1", unit);
 
+    _geometry->selectLevelOfDetail(modelViewTransform, data.camera.projectionMatrix());
     _geometry->render();
 
     // disable shader
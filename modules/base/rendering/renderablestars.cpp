@@ -27,8 +27,10 @@
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/jobmanager.h>
 
 #include <ghoul/filesystem/filesystem>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/opengl/textureunit.h>
@@ -82,6 +84,167 @@ namespace {
 
 namespace openspace {
 
+namespace {
+    struct StarData {
+        std::vector<float> values;
+        int nValuesPerStar = 0;
+    };
+
+    bool readSpeckFile(const std::string& speckFile, StarData& starData) {
+        std::string _file = speckFile;
+        std::ifstream file(_file);
+        if (!file.good()) {
+            LERROR("Failed to open Speck file '" << _file << "'");
+            return false;
+        }
+
+        starData.nValuesPerStar = 0;
+
+        // The beginning of the speck file has a header that either contains comments
+        // (signaled by a preceding '#') or information about the structure of the file
+        // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
+        std::string line = "";
+        while (true) {
+            std::ifstream::streampos position = file.tellg();
+            std::getline(file, line);
+
+            if (line[0] == '#' || line.empty())
+                continue;
+
+            if (line.substr(0, 7) != "datavar" &&
+                line.substr(0, 10) != "texturevar" &&
+                line.substr(0, 7) != "texture")
+            {
+                // we read a line that doesn't belong to the header, so we have to jump back
+                // before the beginning of the current line
+                file.seekg(position);
+                break;
+            }
+
+            if (line.substr(0, 7) == "datavar") {
+                // datavar lines are structured as follows:
+                // datavar # description
+                // where # is the index of the data variable; so if we repeatedly overwrite
+                // the 'nValues' variable with the latest index, we will end up with the total
+                // number of values (+3 since X Y Z are not counted in the Speck file index)
+                std::stringstream str(line);
+
+                std::string dummy;
+                str >> dummy;
+                str >> starData.nValuesPerStar;
+                starData.nValuesPerStar += 1; // We want the number, but the index is 0 based
+            }
+        }
+
+        starData.nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
+
+        do {
+            std::vector<float> values(starData.nValuesPerStar);
+
+            std::getline(file, line);
+            std::stringstream str(line);
+
+            for (int i = 0; i < starData.nValuesPerStar; ++i)
+                str >> values[i];
+
+            starData.values.insert(starData.values.end(), values.begin(), values.end());
+        } while (!file.eof());
+
+        return true;
+    }
+
+    bool loadCachedFile(const std::string& file, StarData& starData) {
+        std::ifstream fileStream(file, std::ifstream::binary);
+        if (fileStream.good()) {
+            int8_t version = 0;
+            fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+            if (version != CurrentCacheVersion) {
+                LINFO("The format of the cached file has changed, deleting old cache");
+                fileStream.close();
+                FileSys.deleteFile(file);
+                return false;
+            }
+
+            int32_t nValues = 0;
+            fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
+            fileStream.read(reinterpret_cast<char*>(&starData.nValuesPerStar), sizeof(int32_t));
+
+            starData.values.resize(nValues);
+            fileStream.read(reinterpret_cast<char*>(&starData.values[0]),
+                nValues * sizeof(starData.values[0]));
+
+            bool success = fileStream.good();
+            return success;
+        }
+        else {
+            LERROR("Error opening file '" << file << "' for loading cache file");
+            return false;
+        }
+    }
+
+    bool saveCachedFile(const std::string& file, const StarData& starData) {
+        std::ofstream fileStream(file, std::ofstream::binary);
+        if (fileStream.good()) {
+            fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
+                sizeof(int8_t));
+
+            int32_t nValues = static_cast<int32_t>(starData.values.size());
+            if (nValues == 0) {
+                LERROR("Error writing cache: No values were loaded");
+                return false;
+            }
+            fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
+
+            int32_t nValuesPerStar = static_cast<int32_t>(starData.nValuesPerStar);
+            fileStream.write(reinterpret_cast<const char*>(&nValuesPerStar), sizeof(int32_t));
+
+            size_t nBytes = nValues * sizeof(starData.values[0]);
+            fileStream.write(reinterpret_cast<const char*>(&starData.values[0]), nBytes);
+
+            bool success = fileStream.good();
+            return success;
+        }
+        else {
+            LERROR("Error opening file '" << file << "' for save cache file");
+            return false;
+        }
+    }
+    // Executed on a worker thread. The name of the cache file is passed in, as the cache
+    // manager must only be accessed from the main thread
+    bool loadData(const std::string& speckFile, const std::string& cachedFile,
+                  StarData& starData)
+    {
+        std::string _file = speckFile;
+
+        bool hasCachedFile = FileSys.fileExists(cachedFile);
+        if (hasCachedFile) {
+            LINFO("Cached file '" << cachedFile << "' used for Speck file '" << _file << "'");
+
+            bool success = loadCachedFile(cachedFile, starData);
+            if (success)
+                return true;
+            else if (FileSys.fileExists(cachedFile))
+                FileSys.deleteFile(cachedFile);
+                // Intentional fall-through to the 'else' computation to generate the cache
+                // file for the next run
+        }
+        else {
+            LINFO("Cache for Speck file '" << _file << "' not found");
+        }
+        LINFO("Loading Speck file '" << _file << "'");
+
+        starData = StarData();
+        bool success = readSpeckFile(speckFile, starData);
+        if (!success)
+            return false;
+
+        LINFO("Saving cache");
+        success = saveCachedFile(cachedFile, starData);
+
+        return success;
+    }
+} // namespace
+
 RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
     : Renderable(dictionary)
     , _pointSpreadFunctionTexturePath("psfTexture", "Point Spread Function Texture")
@@ -139,6 +302,7 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
 }
 
 RenderableStars::~RenderableStars() {
+    _loadingToken.cancel();
     delete _psfTextureFile;
     delete _colorTextureFile;
 }
@@ -158,13 +322,50 @@ bool RenderableStars::initialize() {
 
     if (!_program)
         return false;
-    completeSuccess &= loadData();
+
+    // Reading the Speck file takes several seconds for the large catalogs, so it is done
+    // in the background; the stars are not rendered until the data has arrived
+    std::string speckFile = _speckFile;
+    std::string cachedFile = FileSys.cacheManager()->cachedFilename(
+        _speckFile,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+    // A missing file is reported right away; all other errors can only be detected
+    // while reading and are logged by the continuation
+    if (!FileSys.fileExists(speckFile) && !FileSys.fileExists(cachedFile)) {
+        LERROR("Speck file '" << speckFile << "' does not exist");
+        return false;
+    }
+    OsEng.jobManager().enqueueWithContinuation(
+        [speckFile, cachedFile]() {
+            StarData starData;
+            bool success = loadData(speckFile, cachedFile, starData);
+            return std::make_pair(success, std::move(starData));
+        },
+        [this](std::pair<bool, StarData> result) {
+            if (!result.first) {
+                LERROR("Error loading star data from '" << _speckFile << "'");
+            }
+            if (result.second.values.empty()) {
+                return;
+            }
+            _fullData = std::move(result.second.values);
+            _nValuesPerStar = result.second.nValuesPerStar;
+            _dataIsDirty = true;
+        },
+        JobManager::Priority::Normal,
+        _loadingToken
+    );
+
     completeSuccess &= (_pointSpreadFunctionTexture != nullptr);
 
     return completeSuccess;
 }
 
 bool RenderableStars::deinitialize() {
+    _loadingToken.cancel();
+    _loadingToken = JobManager::CancellationToken();
+
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
     glDeleteVertexArrays(1, &_vao);
@@ -234,7 +435,7 @@ void RenderableStars::render(const RenderData& data) {
 }
 
 void RenderableStars::update(const UpdateData& data) {
-    if (_dataIsDirty) {
+    if (_dataIsDirty && !_fullData.empty()) {
         const int value = _colorOption;
         LDEBUG("Regenerating data");
 
@@ -348,160 +549,6 @@ void RenderableStars::update(const UpdateData& data) {
     }
 }
 
-bool RenderableStars::loadData() {
-    std::string _file = _speckFile;
-    std::string cachedFile = FileSys.cacheManager()->cachedFilename(
-        _file,
-        ghoul::filesystem::CacheManager::Persistent::Yes
-    );
-
-    bool hasCachedFile = FileSys.fileExists(cachedFile);
-    if (hasCachedFile) {
-        LINFO("Cached file '" << cachedFile << "' used for Speck file '" << _file << "'");
-
-        bool success = loadCachedFile(cachedFile);
-        if (success)
-            return true;
-        else
-            FileSys.cacheManager()->removeCacheFile(_file);
-            // Intentional fall-through to the 'else' computation to generate the cache
-            // file for the next run
-    }
-    else {
-        LINFO("Cache for Speck file '" << _file << "' not found");
-    }
-    LINFO("Loading Speck file '" << _file << "'");
-
-    bool success = readSpeckFile();
-    if (!success)
-        return false;
-
-    LINFO("Saving cache");
-    success = saveCachedFile(cachedFile);
-
-    return success;
-}
-
-bool RenderableStars::readSpeckFile() {
-    std::string _file = _speckFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR("Failed to open Speck file '" << _file << "'");
-        return false;
-    }
-
-    _nValuesPerStar = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::ifstream::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty())
-            continue;
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerStar;
-            _nValuesPerStar += 1; // We want the number, but the index is 0 based
-        }
-    }
-
-    _nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerStar);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerStar; ++i)
-            str >> values[i];
-
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
-
-    return true;
-}
-
-bool RenderableStars::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed, deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
-            return false;
-        }
-
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_nValuesPerStar), sizeof(int32_t));
-
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(&_fullData[0]),
-            nValues * sizeof(_fullData[0]));
-
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR("Error opening file '" << file << "' for loading cache file");
-        return false;
-    }
-}
-
-bool RenderableStars::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t));
-
-        int32_t nValues = static_cast<int32_t>(_fullData.size());
-        if (nValues == 0) {
-            LERROR("Error writing cache: No values were loaded");
-            return false;
-        }
-        fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-        int32_t nValuesPerStar = static_cast<int32_t>(_nValuesPerStar);
-        fileStream.write(reinterpret_cast<const char*>(&nValuesPerStar), sizeof(int32_t));
-
-        size_t nBytes = nValues * sizeof(_fullData[0]);
-        fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
-
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR("Error opening file '" << file << "' for save cache file");
-        return false;
-    }
-}
-
 void RenderableStars::createDataSlice(ColorOption option) {
     _slicedData.clear();
 
@@ -29,6 +29,7 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/vectorproperty.h>
+#include <openspace/util/jobmanager.h>
 
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
@@ -57,11 +58,6 @@ private:
 
     void createDataSlice(ColorOption option);
 
-    bool loadData();
-    bool readSpeckFile();
-    bool loadCachedFile(const std::string& file);
-    bool saveCachedFile(const std::string& file) const;
-
     properties::StringProperty _pointSpreadFunctionTexturePath;
     std::unique_ptr<ghoul::opengl::Texture> _pointSpreadFunctionTexture;
     bool _pointSpreadFunctionTextureIsDirty;
@@ -80,6 +76,7 @@ private:
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
 
     std::string _speckFile;
+    JobManager::CancellationToken _loadingToken;
 
     std::vector<float> _slicedData;
     std::vector<float> _fullData;
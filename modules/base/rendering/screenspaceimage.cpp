@@ -27,9 +27,9 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/texturecache.h>
 
 #include <ghoul/opengl/programobject.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/filesystem/filesystem>
 
 namespace {
@@ -61,7 +61,7 @@ ScreenSpaceImage::ScreenSpaceImage(const ghoul::Dictionary& dictionary)
     std::string texturePath;
     if (dictionary.getValue(KeyTexturePath, texturePath)) {
         _texturePath = texturePath;
-        _texturePath.onChange([this](){ loadTexture(); });
+        _texturePath.onChange([this](){ updateTexture(); });
     }
 
     if (dictionary.getValue(KeyUrl, _url)) {
@@ -90,6 +90,7 @@ bool ScreenSpaceImage::deinitialize() {
     _vertexPositionBuffer = 0;
 
     _texturePath = "";
+    setSource("");
     _texture = nullptr;
 
     if (_shader) {
@@ -105,9 +106,11 @@ void ScreenSpaceImage::render() {
 }
 
 void ScreenSpaceImage::update() {
-    bool download = _downloadImage ? (_futureImage.valid() && DownloadManager::futureReady(_futureImage)) : true;
-    if (download) {
-        loadTexture();
+    // The previous texture is shown until the texture of the new source is uploaded
+    std::shared_ptr<ghoul::opengl::Texture> texture =
+        OsEng.textureCache().texture(_source);
+    if (texture) {
+        _texture = std::move(texture);
     }
 }
 
@@ -115,72 +118,37 @@ bool ScreenSpaceImage::isReady() const {
     return _shader && _texture;
 }
 
-void ScreenSpaceImage::loadTexture() {
-    std::unique_ptr<ghoul::opengl::Texture> texture = nullptr;
-    if (!_downloadImage)
-        texture = std::move(loadFromDisk());
-    else
-        texture = std::move(loadFromMemory());
-
-    if (texture) {
-        // LDEBUG("Loaded texture from '" << absPath(_texturePath) << "'");
-        texture->uploadTexture();
-
-        // Textures of planets looks much smoother with AnisotropicMipMap rather than linear
-        texture->setFilter(ghoul::opengl::Texture::FilterMode::Linear);
-
-        _texture = std::move(texture);
+void ScreenSpaceImage::updateTexture() {
+    if (_downloadImage) {
+        setSource(_url);
+    }
+    else {
+        const std::string& path = _texturePath.value();
+        setSource(path.empty() ? "" : absPath(path));
     }
 }
 
-void ScreenSpaceImage::updateTexture() {
-    if (!_downloadImage) {
-        loadTexture();
-    } else {
-        if (_futureImage.valid())
-            return;
-
-        std::future<DownloadManager::MemoryFile> future = downloadImageToMemory(_url);
-        if (future.valid()) {
-            _futureImage = std::move(future);
-        }
+void ScreenSpaceImage::refreshTexture() {
+    if (!_source.empty()) {
+        OsEng.textureCache().refresh(_source);
     }
 }
 
- std::unique_ptr<ghoul::opengl::Texture> ScreenSpaceImage::loadFromDisk() {
-    if (_texturePath.value() != "")
-        return (ghoul::io::TextureReader::ref().loadTexture(absPath(_texturePath.value())));
-    return nullptr;
- }
-
- std::unique_ptr<ghoul::opengl::Texture> ScreenSpaceImage::loadFromMemory() {
-    if (_futureImage.valid() && DownloadManager::futureReady(_futureImage)) {
-        DownloadManager::MemoryFile imageFile = _futureImage.get();
-
-        if (imageFile.corrupted)
-            return nullptr;
-
-        return (ghoul::io::TextureReader::ref().loadTexture(
-            reinterpret_cast<void*>(imageFile.buffer), 
-            imageFile.size, 
-            imageFile.format)
-        );
-
+void ScreenSpaceImage::setSource(const std::string& source) {
+    if (source == _source) {
+        return;
     }
- }
 
-std::future<DownloadManager::MemoryFile> ScreenSpaceImage::downloadImageToMemory(
-    std::string url)
-{
-    return std::move(OsEng.downloadManager().fetchFile(
-        url,
-        [url](const DownloadManager::MemoryFile& file) {
-            LDEBUG("Download to memory finished for screen space image");
-        },
-        [url](const std::string& err) {
-            LDEBUG("Download to memory failer for screen space image: " +err);
-        }
-    ));
+    // Acquire before releasing, so that switching between sources that share an image
+    // does not reload it
+    TextureCache& cache = OsEng.textureCache();
+    if (!source.empty()) {
+        cache.acquire(source);
+    }
+    if (!_source.empty()) {
+        cache.release(_source);
+    }
+    _source = source;
 }
 
 } // namespace openspace
@@ -27,7 +27,6 @@
 
 #include <openspace/rendering/screenspacerenderable.h>
 
-#include <openspace/engine/downloadmanager.h>
 #include <openspace/properties/stringproperty.h>
 
 #include <ghoul/opengl/texture.h>
@@ -46,19 +45,21 @@ public:
     bool isReady() const override;
 
 protected:
-    void loadTexture();
+    /// Requests the image from the URL or the texture path from the TextureCache
     void updateTexture();
+    /// Asks the TextureCache to check whether the current image has changed
+    void refreshTexture();
 
     std::string _url;
     bool _downloadImage;
-    std::future<DownloadManager::MemoryFile> _futureImage;
     
 private:
-    std::future<DownloadManager::MemoryFile> downloadImageToMemory(std::string url);
-    std::unique_ptr<ghoul::opengl::Texture> loadFromDisk();
-    std::unique_ptr<ghoul::opengl::Texture> loadFromMemory();
+    /// Acquires the \p source in the TextureCache and releases the previous source
+    void setSource(const std::string& source);
 
     properties::StringProperty _texturePath;
+    // The image that is currently acquired in the TextureCache
+    std::string _source;
 };
 
 } //namespace openspace
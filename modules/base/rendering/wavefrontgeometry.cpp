@@ -35,10 +35,8 @@ namespace openspace {
 namespace modelgeometry {
 
 WavefrontGeometry::WavefrontGeometry(const ghoul::Dictionary& dictionary)
-    : ModelGeometry(dictionary) 
-{
-    loadObj(_file);
-}
+    : ModelGeometry(dictionary, &WavefrontGeometry::loadModel) 
+{}
 
 bool WavefrontGeometry::initialize(Renderable* parent) {
     bool success = ModelGeometry::initialize(parent);
@@ -49,7 +47,9 @@ void WavefrontGeometry::deinitialize() {
     ModelGeometry::deinitialize();
 }
 
-bool WavefrontGeometry::loadModel(const std::string& filename) {
+bool WavefrontGeometry::loadModel(const std::string& filename,
+                                  ModelCache::Mesh& mesh)
+{
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::string err;
@@ -68,7 +68,7 @@ bool WavefrontGeometry::loadModel(const std::string& filename) {
     size_t totalSizeVertex = 0;
     for (int i = 0; i < shapes.size(); ++i) {
         totalSizeIndex += shapes[i].mesh.indices.size();
-        totalSizeVertex += shapes[i].mesh.positions.size();
+        totalSizeVertex += shapes[i].mesh.positions.size() / 3;
 
         if (shapes[i].mesh.positions.size() != shapes[i].mesh.normals.size())
             LERROR(
@@ -77,10 +77,12 @@ bool WavefrontGeometry::loadModel(const std::string& filename) {
             );
     }
 
-    _vertices.resize(totalSizeVertex);
-    std::memset(_vertices.data(), 0, _vertices.size() * sizeof(Vertex));
-    _indices.resize(totalSizeIndex);
-    std::memset(_indices.data(), 0, _indices.size() * sizeof(int));
+    std::vector<Vertex>& vertices = mesh.vertices;
+    vertices.resize(totalSizeVertex);
+    std::memset(vertices.data(), 0, vertices.size() * sizeof(Vertex));
+    std::vector<int>& indices = mesh.indices;
+    indices.resize(totalSizeIndex);
+    std::memset(indices.data(), 0, indices.size() * sizeof(int));
 
     // We add all shapes of the model into the same vertex array, one after the other
     // The _shapeCounts array stores for each shape, how many vertices that shape has
@@ -94,18 +96,18 @@ bool WavefrontGeometry::loadModel(const std::string& filename) {
                 shapes[i].mesh.positions[3 * j + 2]
                 );
 
-            _vertices[j + currentPosition].location[0] = tmp[0];
-            _vertices[j + currentPosition].location[1] = tmp[1];
-            _vertices[j + currentPosition].location[2] = tmp[2];
-            _vertices[j + currentPosition].location[3] = tmp[3];
+            vertices[j + currentPosition].location[0] = tmp[0];
+            vertices[j + currentPosition].location[1] = tmp[1];
+            vertices[j + currentPosition].location[2] = tmp[2];
+            vertices[j + currentPosition].location[3] = tmp[3];
 
-            _vertices[j + currentPosition].normal[0] = shapes[i].mesh.normals[3 * j + 0];
-            _vertices[j + currentPosition].normal[1] = shapes[i].mesh.normals[3 * j + 1];
-            _vertices[j + currentPosition].normal[2] = shapes[i].mesh.normals[3 * j + 2];
+            vertices[j + currentPosition].normal[0] = shapes[i].mesh.normals[3 * j + 0];
+            vertices[j + currentPosition].normal[1] = shapes[i].mesh.normals[3 * j + 1];
+            vertices[j + currentPosition].normal[2] = shapes[i].mesh.normals[3 * j + 2];
 
             if (2 * j + 1 < shapes[i].mesh.texcoords.size()) {
-                _vertices[j + currentPosition].tex[0] = shapes[i].mesh.texcoords[2 * j + 0];
-                _vertices[j + currentPosition].tex[1] = shapes[i].mesh.texcoords[2 * j + 1];
+                vertices[j + currentPosition].tex[0] = shapes[i].mesh.texcoords[2 * j + 0];
+                vertices[j + currentPosition].tex[1] = shapes[i].mesh.texcoords[2 * j + 1];
             }
             
         }
@@ -114,7 +116,7 @@ bool WavefrontGeometry::loadModel(const std::string& filename) {
         std::copy(
             shapes[i].mesh.indices.begin(),
             shapes[i].mesh.indices.end(),
-            _indices.begin() + p
+            indices.begin() + p
             );
         p += shapes[i].mesh.indices.size();
     }
@@ -41,8 +41,12 @@ namespace modelgeometry {
         bool initialize(Renderable* parent) override;
         void deinitialize() override;
 
-    private:
-        bool loadModel(const std::string& filename);
+        /**
+         * Loads the Wavefront OBJ file \p filename into \p mesh, storing the vertex
+         * locations as power-scaled coordinates.
+         * \return <code>true</code> if the file could be loaded
+         */
+        static bool loadModel(const std::string& filename, ModelCache::Mesh& mesh);
     };
 
 }  // namespace modelgeometry
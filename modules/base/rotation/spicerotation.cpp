@@ -27,6 +27,9 @@
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace {
     const std::string _loggerCat = "SpiceRotation";
     //const std::string keyGhosting = "EphmerisGhosting";
@@ -34,6 +37,13 @@ namespace {
     const std::string KeySourceFrame = "SourceFrame";
     const std::string KeyDestinationFrame = "DestinationFrame";
     const std::string KeyKernels = "Kernels";
+    const std::string KeyTimeStep = "TimeStep";
+    const std::string KeyTolerance = "Tolerance";
+
+    // Default maximum interpolation error in radians (about 0.01 degrees)
+    const double DefaultTolerance = 1.75e-4;
+    // The number of times the time step may be halved to fulfill the tolerance
+    const int MaximumSubdivisions = 10;
 }
 
 namespace openspace {
@@ -43,6 +53,12 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     , _destinationFrame("")
     , _rotationMatrix(1.0)
     , _kernelsLoadedSuccessfully(true)
+    , _timeStep(0.0)
+    , _tolerance(DefaultTolerance)
+    , _currentTimeStep(0.0)
+    , _previousSample({ 0.0, glm::dquat() })
+    , _nextSample({ 0.0, glm::dquat() })
+    , _hasSamples(false)
 {
     const bool hasSourceFrame = dictionary.getValue(KeySourceFrame, _sourceFrame);
     if (!hasSourceFrame)
@@ -69,6 +85,18 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
             _kernelsLoadedSuccessfully = false;
         }
     }
+
+    if (dictionary.hasKeyAndValue<double>(KeyTimeStep)) {
+        dictionary.getValue(KeyTimeStep, _timeStep);
+        if (_timeStep < 0.0) {
+            LERROR("'" << KeyTimeStep << "' must not be negative");
+            _timeStep = 0.0;
+        }
+        _currentTimeStep = _timeStep;
+    }
+    if (dictionary.hasKeyAndValue<double>(KeyTolerance)) {
+        dictionary.getValue(KeyTolerance, _tolerance);
+    }
 }
     
 const glm::dmat3& SpiceRotation::matrix() const {
@@ -78,16 +106,86 @@ const glm::dmat3& SpiceRotation::matrix() const {
 void SpiceRotation::update(const UpdateData& data) {
     if (!_kernelsLoadedSuccessfully)
         return;
+
+    if (_timeStep == 0.0) {
+        try {
+            _rotationMatrix = SpiceManager::ref().positionTransformMatrix(
+                _sourceFrame,
+                _destinationFrame,
+                data.time);
+        }
+        catch (const ghoul::RuntimeError&) {
+            // In case of missing coverage
+            _rotationMatrix = glm::dmat3(1);
+        }
+        return;
+    }
+
+    bool isInInterval = _hasSamples &&
+        data.time >= _previousSample.time && data.time <= _nextSample.time;
+    if (!isInInterval) {
+        resample(data.time);
+    }
+
+    double t = (data.time - _previousSample.time) /
+        (_nextSample.time - _previousSample.time);
+    _rotationMatrix = glm::mat3_cast(glm::slerp(
+        _previousSample.orientation,
+        _nextSample.orientation,
+        glm::clamp(t, 0.0, 1.0)
+    ));
+}
+
+glm::dquat SpiceRotation::orientation(double time) const {
     try {
-        _rotationMatrix = SpiceManager::ref().positionTransformMatrix(
+        return glm::quat_cast(SpiceManager::ref().positionTransformMatrix(
             _sourceFrame,
             _destinationFrame,
-            data.time);
+            time
+        ));
     }
     catch (const ghoul::RuntimeError&) {
         // In case of missing coverage
-        _rotationMatrix = glm::dmat3(1);
+        return glm::dquat();
+    }
+}
+
+void SpiceRotation::resample(double time) {
+    // Start with a coarser time step, in case the previous interval needed a finer one
+    double timeStep = std::min(2.0 * _currentTimeStep, _timeStep);
+    const double minimumTimeStep = _timeStep / std::pow(2.0, MaximumSubdivisions);
+
+    while (true) {
+        double start = std::floor(time / timeStep) * timeStep;
+
+        // Consecutive intervals share the sample at their common end point
+        if (_hasSamples && _nextSample.time == start) {
+            _previousSample = _nextSample;
+        }
+        else {
+            _previousSample = { start, orientation(start) };
+        }
+        _nextSample = { start + timeStep, orientation(start + timeStep) };
+        _hasSamples = true;
+
+        if (timeStep <= minimumTimeStep) {
+            break;
+        }
+
+        // The interpolation error is estimated in the middle of the interval
+        glm::dquat interpolated = glm::slerp(
+            _previousSample.orientation,
+            _nextSample.orientation,
+            0.5
+        );
+        glm::dquat actual = orientation(start + 0.5 * timeStep);
+        double cosHalfAngle = std::min(std::abs(glm::dot(interpolated, actual)), 1.0);
+        if (2.0 * std::acos(cosHalfAngle) <= _tolerance) {
+            break;
+        }
+        timeStep *= 0.5;
     }
+    _currentTimeStep = timeStep;
 }
 
 } // namespace openspace
\ No newline at end of file
@@ -27,8 +27,19 @@
 
 #include <openspace/scene/rotation.h>
 
+#include <ghoul/glm.h>
+#include <glm/gtc/quaternion.hpp>
+
 namespace openspace {
-    
+
+/**
+ * A Rotation that is retrieved from SPICE as the transformation between a source and a
+ * destination reference frame. If a <code>TimeStep</code> is provided, the orientation
+ * is only sampled at multiples of the time step and spherically interpolated in between,
+ * which is smooth and cheap when the time passes quickly. The time step is halved until
+ * the interpolation error in the middle of a sample interval is below the
+ * <code>Tolerance</code> (in radians).
+ */
 class SpiceRotation : public Rotation {
 public:
     SpiceRotation(const ghoul::Dictionary& dictionary);
@@ -36,10 +47,32 @@ public:
     void update(const UpdateData& data) override;
 
 private:
+    /// An orientation that was retrieved from SPICE at a specific time
+    struct Sample {
+        double time;
+        glm::dquat orientation;
+    };
+
+    /// Returns the orientation at the \p time or the identity if there is no coverage
+    glm::dquat orientation(double time) const;
+
+    /// Retrieves the samples surrounding the \p time using the current time step
+    void resample(double time);
+
     std::string _sourceFrame;
     std::string _destinationFrame;
     glm::dmat3 _rotationMatrix;
     bool _kernelsLoadedSuccessfully;
+
+    /// The time step between samples, or 0 if the orientation is queried every frame
+    double _timeStep;
+    /// The maximum angle in radians between the interpolated and the real orientation
+    double _tolerance;
+    /// The time step that fulfills the tolerance for the current sample interval
+    double _currentTimeStep;
+    Sample _previousSample;
+    Sample _nextSample;
+    bool _hasSamples;
 };
     
 } // namespace openspace
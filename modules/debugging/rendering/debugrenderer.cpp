@@ -186,7 +186,7 @@ namespace openspace {
         DebugRenderer::ref().renderVertices(clippingSpaceBoxCorners, GL_POINTS, rgba);
     }
 
-    void DebugRenderer::renderCameraFrustum(const RenderData& data, const Camera& otherCamera, RGBA rgba) const {
+    void DebugRenderer::renderCameraFrustum(const RenderData& data, const Camera::Snapshot& otherCamera, RGBA rgba) const {
         using namespace glm;
         dmat4 modelTransform = translate(dmat4(1), data.position.dvec3());
         dmat4 viewTransform = dmat4(data.camera.combinedViewMatrix());
@@ -126,10 +126,10 @@ namespace openspace {
          *  Input arguments:
          *  1. const RenderData& data:     defines position and camera that we will see the 
          *                                 other cameras view frustum from
-         *  2. const Camera& otherCamera:  The camera who's view frustum is to be rendered
+         *  2. const Camera::Snapshot& otherCamera:  The camera who's view frustum is to be rendered
          *  3. RGBA rgba                   Color to draw the view frustum with
          */
-        void renderCameraFrustum(const RenderData& data, const Camera& otherCamera, RGBA rgba = { 1, 1, 1, 0.3 }) const;
+        void renderCameraFrustum(const RenderData& data, const Camera::Snapshot& otherCamera, RGBA rgba = { 1, 1, 1, 0.3 }) const;
 
         /**
          *  Renders a screen space AABB2 to the screen with the provided color
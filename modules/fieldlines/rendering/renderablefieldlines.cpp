@@ -34,6 +34,10 @@
 #include <ghoul/misc/assert.h>
 
 #include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <tuple>
 
 namespace {
     std::string _loggerCat = "RenderableFieldlines";
@@ -68,6 +72,10 @@ namespace {
 
     const int SeedPointSourceFile = 0;
     const int SeedPointSourceTable = 1;
+
+    // The number of traced lines that are kept in the cache even though their seed
+    // points are no longer in use
+    const size_t MaxUnusedCachedLines = 4096;
 }
 
 namespace openspace {
@@ -90,6 +98,8 @@ RenderableFieldlines::RenderableFieldlines(const ghoul::Dictionary& dictionary)
     , _fieldLinesAreDirty(true)
     , _fieldlineVAO(0)
     , _vertexPositionBuffer(0)
+    , _bufferCapacity(0)
+    , _bufferSize(0)
 {
     ghoul_assert(
         dictionary.hasKeyAndValue<std::string>(SceneGraphNode::KeyName),
@@ -219,14 +229,57 @@ bool RenderableFieldlines::initialize() {
     if (!_program)
         return false;
 
+    // The buffer storage is (re)allocated in uploadFieldlines, which keeps the attribute
+    // bindings of the vertex array intact
+    glGenVertexArrays(1, &_fieldlineVAO);
+    glBindVertexArray(_fieldlineVAO);
+    glGenBuffers(1, &_vertexPositionBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
+
+    GLuint vertexLocation = 0;
+    glEnableVertexAttribArray(vertexLocation);
+    glVertexAttribPointer(
+        vertexLocation,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(LinePoint),
+        reinterpret_cast<void*>(0)
+    );
+
+    GLuint colorLocation = 1;
+    glEnableVertexAttribArray(colorLocation);
+    glVertexAttribPointer(
+        colorLocation,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(LinePoint),
+        reinterpret_cast<void*>(sizeof(glm::vec3))
+    );
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
     return true;
 }
 
 bool RenderableFieldlines::deinitialize() {
+    _tracingToken.cancel();
+    _tracingToken = JobManager::CancellationToken();
+    // A job that is still tracing keeps its own reference to the model
+    _kameleonModel = nullptr;
+    _fieldLinesAreDirty = true;
+
     glDeleteVertexArrays(1, &_fieldlineVAO);
     _fieldlineVAO = 0;
     glDeleteBuffers(1, &_vertexPositionBuffer);
     _vertexPositionBuffer = 0;
+    _bufferCapacity = 0;
+    _bufferSize = 0;
+    _uploadedLines.clear();
+    _lineStart.clear();
+    _lineCount.clear();
 
     RenderEngine& renderEngine = OsEng.renderEngine();
     if (_program) {
@@ -238,6 +291,10 @@ bool RenderableFieldlines::deinitialize() {
 }
 
 void RenderableFieldlines::render(const RenderData& data) {
+    // Nothing has been traced yet
+    if (_lineStart.empty())
+        return;
+
     _program->activate();
     _program->setUniform("modelViewProjection", data.camera.viewProjectionMatrix());
     _program->setUniform("modelTransform", glm::mat4(1.0));
@@ -272,43 +329,8 @@ void RenderableFieldlines::update(const UpdateData&) {
     }
 
     if (_fieldLinesAreDirty) {
-        std::vector<Line> fieldlines = generateFieldlines();
-
-        if (fieldlines.empty())
-            return ;
-
-        int prevEnd = 0;
-        std::vector<LinePoint> vertexData;
-        // Arrange data for glMultiDrawArrays
-        for (int j = 0; j < fieldlines.size(); ++j) {
-            _lineStart.push_back(prevEnd);
-            _lineCount.push_back(static_cast<int>(fieldlines[j].size()));
-            prevEnd = prevEnd + static_cast<int>(fieldlines[j].size());
-            vertexData.insert(vertexData.end(), fieldlines[j].begin(), fieldlines[j].end());
-        }
-        LDEBUG("Number of vertices : " << vertexData.size());
-
-        if (_fieldlineVAO == 0)
-            glGenVertexArrays(1, &_fieldlineVAO);
-        glBindVertexArray(_fieldlineVAO);
-
-        if (_vertexPositionBuffer == 0)
-            glGenBuffers(1, &_vertexPositionBuffer);
-        glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
-
-        glBufferData(GL_ARRAY_BUFFER, vertexData.size()*sizeof(LinePoint), &vertexData.front(), GL_STATIC_DRAW);
-
-        GLuint vertexLocation = 0;
-        glEnableVertexAttribArray(vertexLocation);
-        glVertexAttribPointer(vertexLocation, 3, GL_FLOAT, GL_FALSE, sizeof(LinePoint), reinterpret_cast<void*>(0));
-
-        GLuint colorLocation = 1;
-        glEnableVertexAttribArray(colorLocation);
-        glVertexAttribPointer(colorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(LinePoint), (void*)(sizeof(glm::vec3)));
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-
+        // The previous lines keep being rendered until the new ones have been traced
+        generateFieldlines();
         _fieldLinesAreDirty = false;
     }
 }
@@ -358,41 +380,56 @@ void RenderableFieldlines::loadSeedPointsFromTable() {
     }
 }
 
-std::vector<RenderableFieldlines::Line> RenderableFieldlines::generateFieldlines() {
+bool RenderableFieldlines::SeedPointLess::operator()(const glm::vec3& lhs,
+                                                     const glm::vec3& rhs) const
+{
+    return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+}
+
+std::string RenderableFieldlines::TraceSettings::identifier() const {
+    std::stringstream s;
+    s << std::setprecision(9) << filename << '|' << xVariable << '|' << yVariable <<
+        '|' << zVariable << '|' << lorentzForce << '|' << stepSize;
+    return s.str();
+}
+
+void RenderableFieldlines::generateFieldlines() {
     std::string type;
     bool success = _vectorFieldInfo.getValue(keyVectorFieldType, type);
     if (!success) {
         LERROR(keyVectorField << " does not contain a '" <<
             keyVectorFieldType << "' key");
-        return {};
+        return;
     }
 
+    TraceSettings settings;
     if (type == vectorFieldTypeVolumeKameleon)
-        return generateFieldlinesVolumeKameleon();
+        success = traceSettingsVolumeKameleon(settings);
     else {
         LERROR(keyVectorField << "." << keyVectorFieldType <<
             " does not name a valid type");
-        return {};
+        return;
     }
+
+    if (success)
+        traceFieldlines(std::move(settings));
 }
 
-std::vector<RenderableFieldlines::Line>
-RenderableFieldlines::generateFieldlinesVolumeKameleon()
-{
+bool RenderableFieldlines::traceSettingsVolumeKameleon(TraceSettings& settings) {
     std::string model;
     bool success = _vectorFieldInfo.getValue(keyVectorFieldVolumeModel, model);
     if (!success) {
         LERROR(keyVectorField << " does not name a model");
-        return {};
+        return false;
     }
 
     std::string fileName;
     success = _vectorFieldInfo.getValue(keyVectorFieldFile, fileName);
     if (!success) {
         LERROR(keyVectorField << " does not name a file");
-        return {};
+        return false;
     }
-    fileName = absPath(fileName);
+    settings.filename = absPath(fileName);
 
     //KameleonWrapper::Model modelType;
     if (model != vectorFieldKameleonModelBATSRUS) {
@@ -400,7 +437,7 @@ RenderableFieldlines::generateFieldlinesVolumeKameleon()
     //else {
         LERROR(keyVectorField << "." << keyVectorFieldVolumeModel << " model '" << 
             model << "' not supported");
-        return {};
+        return false;
     }
 
     std::string v1 = keyVectorFieldVolumeVariable + ".1";
@@ -418,26 +455,228 @@ RenderableFieldlines::generateFieldlinesVolumeKameleon()
 
     if (!threeVariables && !lorentzForce) {
         LERROR(keyVectorField << " does not name variables");
-        return {};
+        return false;
     }
 
     if (threeVariables) {
-        std::string xVariable, yVariable, zVariable;
-        _vectorFieldInfo.getValue(v1, xVariable);
-        _vectorFieldInfo.getValue(v2, yVariable);
-        _vectorFieldInfo.getValue(v3, zVariable);
+        _vectorFieldInfo.getValue(v1, settings.xVariable);
+        _vectorFieldInfo.getValue(v2, settings.yVariable);
+        _vectorFieldInfo.getValue(v3, settings.zVariable);
+    }
+    settings.lorentzForce = !threeVariables;
+    settings.stepSize = _stepSize;
+    return true;
+}
 
-        KameleonWrapper kw(fileName);
-        return kw.getClassifiedFieldLines(xVariable, yVariable, zVariable, _seedPoints, _stepSize);
+void RenderableFieldlines::traceFieldlines(TraceSettings settings) {
+    // Only one set of lines is ever traced at a time; a job that is still running for
+    // outdated settings or seed points stops at the next seed point
+    _tracingToken.cancel();
+    _tracingToken = JobManager::CancellationToken();
+
+    // Reopening the model is the most expensive part, so it only happens if the file
+    // changes. The model is opened lazily by the first job that needs it
+    if (!_kameleonModel || _kameleonModel->filename != settings.filename) {
+        _kameleonModel = std::make_shared<KameleonModel>();
+        _kameleonModel->filename = settings.filename;
     }
-    
-    if (lorentzForce) {
-        KameleonWrapper kw(fileName);
-        return kw.getLorentzTrajectories(_seedPoints, _fieldlineColor, _stepSize);
+
+    TraceResult result;
+    result.identifier = settings.identifier();
+    result.seedPoints = _seedPoints;
+
+    // Lines that were traced with the same settings before are reused; only new seed
+    // points are traced
+    bool cacheIsValid = (result.identifier == _cacheIdentifier);
+    std::set<glm::vec3, SeedPointLess> tracedSeedPoints;
+    for (const glm::vec3& seedPoint : _seedPoints) {
+        bool isCached = cacheIsValid && (_lineCache.find(seedPoint) != _lineCache.end());
+        if (!isCached && tracedSeedPoints.insert(seedPoint).second)
+            result.tracedSeedPoints.push_back(seedPoint);
     }
-    
-    ghoul_assert(false, "Should not reach this");
-    return {};
+
+    if (result.tracedSeedPoints.empty()) {
+        applyFieldlines(std::move(result));
+        return;
+    }
+
+    LDEBUG("Tracing " << result.tracedSeedPoints.size() << " of " <<
+        _seedPoints.size() << " fieldlines");
+
+    std::shared_ptr<KameleonModel> model = _kameleonModel;
+    JobManager::CancellationToken token = _tracingToken;
+    OsEng.jobManager().enqueueWithContinuation(
+        [model, settings, result, token]() mutable {
+            std::lock_guard<std::mutex> lock(model->mutex);
+            if (!model->wrapper) {
+                model->wrapper = std::make_unique<KameleonWrapper>();
+                model->isOpen = model->wrapper->open(model->filename);
+            }
+            if (!model->isOpen) {
+                // Allow the next regeneration to try again
+                model->wrapper = nullptr;
+                return result;
+            }
+
+            result.tracedLines.reserve(result.tracedSeedPoints.size());
+            for (const glm::vec3& seedPoint : result.tracedSeedPoints) {
+                if (token.isCancelled())
+                    break;
+
+                if (settings.lorentzForce) {
+                    result.tracedLines.push_back(
+                        model->wrapper->getLorentzTrajectory(seedPoint, settings.stepSize)
+                    );
+                }
+                else {
+                    result.tracedLines.push_back(model->wrapper->getClassifiedFieldLine(
+                        settings.xVariable,
+                        settings.yVariable,
+                        settings.zVariable,
+                        seedPoint,
+                        settings.stepSize
+                    ));
+                }
+            }
+            return result;
+        },
+        [this](TraceResult result) { applyFieldlines(std::move(result)); },
+        JobManager::Priority::Normal,
+        _tracingToken
+    );
+}
+
+void RenderableFieldlines::applyFieldlines(TraceResult result) {
+    if (result.tracedLines.size() != result.tracedSeedPoints.size()) {
+        LERROR("Could not open file '" << _kameleonModel->filename << "'");
+        return;
+    }
+
+    if (result.identifier != _cacheIdentifier) {
+        // Neither the cached nor the uploaded lines are valid for the new settings
+        _cacheIdentifier = result.identifier;
+        _lineCache.clear();
+        _uploadedLines.clear();
+        _bufferSize = 0;
+    }
+
+    for (size_t i = 0; i < result.tracedSeedPoints.size(); ++i)
+        _lineCache[result.tracedSeedPoints[i]] = std::move(result.tracedLines[i]);
+
+    uploadFieldlines(result.seedPoints);
+
+    if (_lineCache.size() > result.seedPoints.size() + MaxUnusedCachedLines) {
+        std::set<glm::vec3, SeedPointLess> used(
+            result.seedPoints.begin(),
+            result.seedPoints.end()
+        );
+        for (auto it = _lineCache.begin(); it != _lineCache.end();) {
+            if (used.find(it->first) == used.end()) {
+                _uploadedLines.erase(it->first);
+                it = _lineCache.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
+void RenderableFieldlines::uploadFieldlines(const std::vector<glm::vec3>& seedPoints) {
+    typedef std::map<glm::vec3, Line, SeedPointLess>::const_iterator CacheIterator;
+    std::vector<CacheIterator> lines;
+    lines.reserve(seedPoints.size());
+    for (const glm::vec3& seedPoint : seedPoints) {
+        CacheIterator it = _lineCache.find(seedPoint);
+        if (it != _lineCache.end() && !it->second.empty())
+            lines.push_back(it);
+    }
+
+    _lineStart.clear();
+    _lineCount.clear();
+
+    // Lines that are already in the buffer keep their range, new lines are appended
+    // behind all previously uploaded lines
+    std::vector<LinePoint> appendedData;
+    GLsizei end = _bufferSize;
+    GLsizei nUsed = 0;
+    for (CacheIterator line : lines) {
+        auto uploaded = _uploadedLines.find(line->first);
+        if (uploaded == _uploadedLines.end()) {
+            GLsizei count = static_cast<GLsizei>(line->second.size());
+            BufferRange range = { end, count };
+            uploaded = _uploadedLines.emplace(line->first, range).first;
+            appendedData.insert(
+                appendedData.end(),
+                line->second.begin(),
+                line->second.end()
+            );
+            end += count;
+        }
+        _lineStart.push_back(uploaded->second.start);
+        _lineCount.push_back(uploaded->second.count);
+        nUsed += uploaded->second.count;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
+
+    bool exceedsCapacity = end > _bufferCapacity;
+    bool isFragmented = (end - nUsed) > nUsed;
+    if (exceedsCapacity || isFragmented) {
+        // Compact the buffer so that it only contains the lines that are drawn and leave
+        // some room for lines that are added later
+        _uploadedLines.clear();
+        _lineStart.clear();
+        _lineCount.clear();
+
+        std::vector<LinePoint> vertexData;
+        vertexData.reserve(nUsed);
+        for (CacheIterator line : lines) {
+            BufferRange range = {
+                static_cast<GLint>(vertexData.size()),
+                static_cast<GLsizei>(line->second.size())
+            };
+            auto uploaded = _uploadedLines.emplace(line->first, range);
+            if (uploaded.second) {
+                vertexData.insert(
+                    vertexData.end(),
+                    line->second.begin(),
+                    line->second.end()
+                );
+            }
+            _lineStart.push_back(uploaded.first->second.start);
+            _lineCount.push_back(uploaded.first->second.count);
+        }
+
+        _bufferSize = static_cast<GLsizei>(vertexData.size());
+        _bufferCapacity = _bufferSize + _bufferSize / 2;
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            _bufferCapacity * sizeof(LinePoint),
+            nullptr,
+            GL_DYNAMIC_DRAW
+        );
+        if (!vertexData.empty()) {
+            glBufferSubData(
+                GL_ARRAY_BUFFER,
+                0,
+                vertexData.size() * sizeof(LinePoint),
+                vertexData.data()
+            );
+        }
+        LDEBUG("Uploaded " << vertexData.size() << " vertices");
+    }
+    else if (!appendedData.empty()) {
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            _bufferSize * sizeof(LinePoint),
+            appendedData.size() * sizeof(LinePoint),
+            appendedData.data()
+        );
+        _bufferSize = end;
+        LDEBUG("Uploaded " << appendedData.size() << " additional vertices");
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 } // namespace openspace
@@ -31,10 +31,15 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalarproperty.h>
 #include <openspace/properties/vectorproperty.h>
+#include <openspace/util/jobmanager.h>
 
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/opengl/ghoul_gl.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 namespace ghoul {
 namespace opengl {
     class ProgramObject;
@@ -43,6 +48,7 @@ namespace opengl {
 
 namespace openspace {
     struct LinePoint;
+    class KameleonWrapper;
 
 class RenderableFieldlines : public Renderable {
 public:
@@ -59,15 +65,60 @@ public:
 private:
     typedef std::vector<LinePoint> Line;
 
+    /// Orders seed points lexicographically so that they can be used as cache keys
+    struct SeedPointLess {
+        bool operator()(const glm::vec3& lhs, const glm::vec3& rhs) const;
+    };
+
+    /**
+     * A Kameleon model that stays open across regenerations. It is shared with the
+     * tracing jobs, and as the interpolator is not thread-safe, all access goes through
+     * the mutex.
+     */
+    struct KameleonModel {
+        std::mutex mutex;
+        std::string filename;
+        std::unique_ptr<KameleonWrapper> wrapper;
+        bool isOpen = false;
+    };
+
+    /// Everything the lines depend on apart from the seed points
+    struct TraceSettings {
+        std::string filename;
+        std::string xVariable;
+        std::string yVariable;
+        std::string zVariable;
+        bool lorentzForce;
+        float stepSize;
+
+        /// Returns a key that changes whenever previously traced lines become invalid
+        std::string identifier() const;
+    };
+
+    /// The lines traced by a single job for the seed points that were not cached
+    struct TraceResult {
+        std::string identifier;
+        std::vector<glm::vec3> seedPoints;
+        std::vector<glm::vec3> tracedSeedPoints;
+        std::vector<Line> tracedLines;
+    };
+
+    /// The location of one line in the vertex buffer
+    struct BufferRange {
+        GLint start;
+        GLsizei count;
+    };
+
     void initializeDefaultPropertyValues();
-    //std::vector<std::vector<LinePoint> > getFieldlinesData(std::string filename, ghoul::Dictionary hintsDictionary);
-    std::vector<Line> getFieldlinesData();
     void loadSeedPoints();
     void loadSeedPointsFromFile();
     void loadSeedPointsFromTable();
 
-    std::vector<Line> generateFieldlines();
-    std::vector<Line> generateFieldlinesVolumeKameleon();
+    void generateFieldlines();
+    bool traceSettingsVolumeKameleon(TraceSettings& settings);
+    void traceFieldlines(TraceSettings settings);
+    void applyFieldlines(TraceResult result);
+    void uploadFieldlines(const std::vector<glm::vec3>& seedPoints);
 
     properties::FloatProperty _stepSize;
     properties::BoolProperty _classification;
@@ -86,8 +137,20 @@ private:
 
     std::vector<glm::vec3> _seedPoints;
 
+    std::shared_ptr<KameleonModel> _kameleonModel;
+    JobManager::CancellationToken _tracingToken;
+
+    // Traced lines for the settings named by _cacheIdentifier, keyed by seed point
+    std::string _cacheIdentifier;
+    std::map<glm::vec3, Line, SeedPointLess> _lineCache;
+
     GLuint _fieldlineVAO;
     GLuint _vertexPositionBuffer;
+    // The number of LinePoints the buffer can hold and the number that are in use,
+    // including the ones belonging to lines that are no longer drawn
+    GLsizei _bufferCapacity;
+    GLsizei _bufferSize;
+    std::map<glm::vec3, BufferRange, SeedPointLess> _uploadedLines;
 
     std::vector<GLint> _lineStart;
     std::vector<GLsizei> _lineCount;
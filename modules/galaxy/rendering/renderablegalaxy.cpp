@@ -38,6 +38,7 @@
 
 #include <modules/volume/rawvolumereader.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 
@@ -49,6 +50,48 @@ namespace {
     const std::string GlslBoundsVsPath = "${MODULES}/toyvolume/shaders/boundsVs.glsl";
     const std::string GlslBoundsFsPath = "${MODULES}/toyvolume/shaders/boundsFs.glsl";
     const std::string _loggerCat       = "Renderable Galaxy";
+
+    struct Points {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> colors;
+    };
+
+    // Executed on a worker thread
+    Points readPoints(const std::string& filename) {
+        Points points;
+        std::ifstream pointFile(filename, std::ios::in | std::ios::binary);
+        if (!pointFile.good()) {
+            LERROR("Could not open points file '" << filename << "'");
+            return points;
+        }
+
+        int64_t nPoints;
+        pointFile.seekg(0, std::ios::beg); // read heder.
+        pointFile.read(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
+
+        size_t nFloats = static_cast<size_t>(nPoints) * 7;
+
+        std::vector<float> pointData(nFloats);
+        pointFile.seekg(sizeof(int64_t), std::ios::beg); // read past heder.
+        pointFile.read(reinterpret_cast<char*>(pointData.data()), nFloats * sizeof(float));
+        pointFile.close();
+
+        points.positions.reserve(static_cast<size_t>(nPoints));
+        points.colors.reserve(static_cast<size_t>(nPoints));
+        for (size_t i = 0; i < static_cast<size_t>(nPoints); ++i) {
+            float x = pointData[i * 7 + 0];
+            float y = pointData[i * 7 + 1];
+            float z = pointData[i * 7 + 2];
+            float r = pointData[i * 7 + 3];
+            float g = pointData[i * 7 + 4];
+            float b = pointData[i * 7 + 5];
+            //float a = pointData[i * 7 + 6];  alpha is not used.
+
+            points.positions.push_back(glm::vec3(x, y, z));
+            points.colors.push_back(glm::vec3(r, g, b));
+        }
+        return points;
+    }
 }
 
 namespace openspace {
@@ -59,7 +102,8 @@ namespace openspace {
     , _pointStepSize("pointStepSize", "Point Step Size", 0.01, 0.01, 0.1)
     , _translation("translation", "Translation", glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0), glm::vec3(10.0))
     , _rotation("rotation", "Euler rotation", glm::vec3(0.0, 0.0, 0.0), glm::vec3(0), glm::vec3(6.28))
-    , _enabledPointsRatio("nEnabledPointsRatio", "Enabled points", 0.2, 0, 1) {
+    , _enabledPointsRatio("nEnabledPointsRatio", "Enabled points", 0.2, 0, 1)
+    , _nPoints(0) {
 
     float stepSize;
     glm::vec3 scaling, translation, rotation;
@@ -119,15 +163,25 @@ namespace openspace {
 
 }
     
-RenderableGalaxy::~RenderableGalaxy() {}
+RenderableGalaxy::~RenderableGalaxy() {
+    _loadingToken.cancel();
+}
 
 bool RenderableGalaxy::initialize() {
     // Aspect is currently hardcoded to cubic voxels.
     _aspect = static_cast<glm::vec3>(_volumeDimensions);
     _aspect = _aspect / std::max(std::max(_aspect.x, _aspect.y), _aspect.z);
 
+    // The volume is mapped rather than read, so that only the pages the texture upload
+    // touches are loaded and no intermediate copy of the full volume is allocated
     RawVolumeReader<glm::tvec4<GLfloat>> reader(_volumeFilename, _volumeDimensions);
-    _volume = reader.read();
+    try {
+        _volume = reader.map();
+    }
+    catch (const MemoryMappedFile::MemoryMappedFileError& e) {
+        LERRORC(e.component, e.message);
+        return false;
+    }
     
     _texture = std::make_unique<ghoul::opengl::Texture>(
         _volumeDimensions,
@@ -163,64 +217,11 @@ bool RenderableGalaxy::initialize() {
     addProperty(_rotation);
     addProperty(_enabledPointsRatio);
     
-    // initialize points.
-    std::ifstream pointFile(_pointsFilename, std::ios::in | std::ios::binary);
-
-    std::vector<glm::vec3> pointPositions;
-    std::vector<glm::vec3> pointColors;
-
-    int64_t nPoints;
-    pointFile.seekg(0, std::ios::beg); // read heder.
-    pointFile.read(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
-
-    _nPoints = static_cast<size_t>(nPoints);
-
-    size_t nFloats = _nPoints * 7;
-
-    float* pointData = new float[nFloats];
-    pointFile.seekg(sizeof(int64_t), std::ios::beg); // read past heder.
-    pointFile.read(reinterpret_cast<char*>(pointData), nFloats * sizeof(float));
-    pointFile.close();
-
-    float maxdist = 0;
-    
-
-    float x, y, z, r, g, b, a;
-    for (size_t i = 0; i < _nPoints; ++i) {
-        float x = pointData[i * 7 + 0];
-        float y = pointData[i * 7 + 1];
-        float z = pointData[i * 7 + 2];
-        float r = pointData[i * 7 + 3];
-        float g = pointData[i * 7 + 4];
-        float b = pointData[i * 7 + 5];
-        maxdist = std::max(maxdist, glm::length(glm::vec3(x, y, z)));
-        //float a = pointData[i * 7 + 6];  alpha is not used.
-                               
-        pointPositions.push_back(glm::vec3(x, y, z));
-        pointColors.push_back(glm::vec3(r, g, b));        
-    }
-
-    std::cout << maxdist << std::endl;
-
-    delete[] pointData;
-
     glGenVertexArrays(1, &_pointsVao);
     glGenBuffers(1, &_positionVbo);
     glGenBuffers(1, &_colorVbo);
 
     glBindVertexArray(_pointsVao);
-    glBindBuffer(GL_ARRAY_BUFFER, _positionVbo);
-    glBufferData(GL_ARRAY_BUFFER,
-        pointPositions.size()*sizeof(glm::vec3),
-        pointPositions.data(),
-        GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _colorVbo);
-    glBufferData(GL_ARRAY_BUFFER,
-        pointColors.size()*sizeof(glm::vec3),
-        pointColors.data(),
-        GL_STATIC_DRAW);
-
 
     RenderEngine& renderEngine = OsEng.renderEngine();
     _pointsProgram = renderEngine.buildRenderProgram("Galaxy points",
@@ -245,10 +246,39 @@ bool RenderableGalaxy::initialize() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
+    // The points are read in the background and uploaded once they are available; until
+    // then, _nPoints is 0 and only the volume is rendered
+    std::string pointsFilename = _pointsFilename;
+    OsEng.jobManager().enqueueWithContinuation(
+        [pointsFilename]() { return readPoints(pointsFilename); },
+        [this](Points points) {
+            glBindBuffer(GL_ARRAY_BUFFER, _positionVbo);
+            glBufferData(GL_ARRAY_BUFFER,
+                points.positions.size()*sizeof(glm::vec3),
+                points.positions.data(),
+                GL_STATIC_DRAW);
+
+            glBindBuffer(GL_ARRAY_BUFFER, _colorVbo);
+            glBufferData(GL_ARRAY_BUFFER,
+                points.colors.size()*sizeof(glm::vec3),
+                points.colors.data(),
+                GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            _nPoints = points.positions.size();
+        },
+        JobManager::Priority::Normal,
+        _loadingToken
+    );
+
     return true;
 }
     
 bool RenderableGalaxy::deinitialize() {
+    _loadingToken.cancel();
+    _loadingToken = JobManager::CancellationToken();
+    _nPoints = 0;
+
     if (_raycaster) {
         OsEng.renderEngine().raycasterManager().detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
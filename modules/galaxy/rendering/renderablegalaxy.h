@@ -28,8 +28,9 @@
 #include <openspace/properties/vectorproperty.h>
 #include <openspace/util/boxgeometry.h>
 #include <openspace/rendering/renderable.h>
+#include <openspace/util/jobmanager.h>
 #include <modules/galaxy/rendering/galaxyraycaster.h>
-#include <modules/volume/rawvolume.h>
+#include <modules/volume/mappedrawvolume.h>
 
 namespace openspace {
 
@@ -63,7 +64,7 @@ private:
     std::string _pointsFilename;
 
     std::unique_ptr<GalaxyRaycaster> _raycaster;
-    std::unique_ptr<RawVolume<glm::tvec4<GLfloat>>> _volume;
+    std::unique_ptr<MappedRawVolume<glm::tvec4<GLfloat>>> _volume;
     std::unique_ptr<ghoul::opengl::Texture> _texture;
     glm::mat4 _pointTransform;
     glm::vec3 _aspect;
@@ -74,6 +75,7 @@ private:
     GLuint _pointsVao;
     GLuint _positionVbo;
     GLuint _colorVbo;
+    JobManager::CancellationToken _loadingToken;
 };
 }
 
@@ -29,6 +29,7 @@
 
 #include <modules/globebrowsing/chunk/chunk.h>
 #include <modules/globebrowsing/chunk/chunkedlodglobe.h>
+#include <modules/globebrowsing/chunk/chunklevelscheduler.h>
 #include <modules/globebrowsing/tile/layeredtextures.h>
 #include <modules/globebrowsing/tile/tileioresult.h>
 
@@ -70,29 +71,29 @@ namespace openspace {
     void Chunk::setIndex(const ChunkIndex& index) {
         _index = index;
         _surfacePatch = GeodeticPatch(index);
+        _levelEvaluation = LevelEvaluation();
     }
 
     void Chunk::setOwner(ChunkedLodGlobe* newOwner) {
         _owner = newOwner;
     }
 
-    Chunk::Status Chunk::update(const RenderData& data) {
-        auto savedCamera = _owner->getSavedCamera();
-        const Camera& camRef = savedCamera != nullptr ? *savedCamera : data.camera;
-        RenderData myRenderData = { camRef, data.position, data.doPerformanceMeasurement };
-
-
+    Chunk::Status Chunk::update(const RenderData& data, ChunkLevelScheduler& scheduler) {
         _isVisible = true;
-        if (_owner->testIfCullable(*this, myRenderData)) {
+        if (scheduler.isCullable(*this)) {
             _isVisible = false;
             return Status::WANT_MERGE;
         }
 
-        int desiredLevel = _owner->getDesiredLevel(*this, myRenderData);
+        return scheduler.status(*this, data);
+    }
+
+    const Chunk::LevelEvaluation& Chunk::levelEvaluation() const {
+        return _levelEvaluation;
+    }
 
-        if (desiredLevel < _index.level) return Status::WANT_MERGE;
-        else if (_index.level < desiredLevel) return Status::WANT_SPLIT;
-        else return Status::DO_NOTHING;
+    Chunk::LevelEvaluation& Chunk::levelEvaluation() {
+        return _levelEvaluation;
     }
 
     Chunk::BoundingHeights Chunk::getBoundingHeights() const {
@@ -105,10 +106,6 @@ namespace openspace {
         // One must also handle how to sample pick one out of multiplte heightmaps
         auto tileProviderManager = owner()->getTileProviderManager();
         
-        
-        auto heightMapProviders = tileProviderManager->getTileProviderGroup(LayeredTextures::HeightMaps).getActiveTileProviders();
-       
-        
         size_t HEIGHT_CHANNEL = 0;
         const TileProviderGroup& heightmaps = tileProviderManager->getTileProviderGroup(LayeredTextures::HeightMaps);
         std::vector<TileAndTransform> tiles = TileSelector::getTilesSortedByHighestResolution(heightmaps, _index);
@@ -147,64 +144,18 @@ namespace openspace {
         return boundingHeights;
     }
 
-    std::vector<glm::dvec4> Chunk::getBoundingPolyhedronCorners() const {
-        const Ellipsoid& ellipsoid = owner()->ellipsoid();
-        const GeodeticPatch& patch = surfacePatch();
+    std::array<glm::dvec4, 8> Chunk::getBoundingPolyhedronCorners() const {
+        return getBounds().corners;
+    }
 
+    ChunkBounds Chunk::getBounds() const {
         BoundingHeights boundingHeight = getBoundingHeights();
-
-        // assume worst case
-        double patchCenterRadius = ellipsoid.maximumRadius();
-
-        double maxCenterRadius = patchCenterRadius + boundingHeight.max;
-        Geodetic2 halfSize = patch.halfSize();
-
-        // As the patch is curved, the maximum height offsets at the corners must be long 
-        // enough to cover large enough to cover a boundingHeight.max at the center of the 
-        // patch.
-        // Approximating scaleToCoverCenter by assuming the latitude and longitude angles
-        // of "halfSize" are equal to the angles they create from the center of the
-        // globe to the patch corners. This is true for the longitude direction when
-        // the ellipsoid can be approximated as a sphere and for the latitude for patches
-        // close to the equator. Close to the pole this will lead to a bigger than needed
-        // value for scaleToCoverCenter. However, this is a simple calculation and a good
-        // Approximation.
-        double y1 = tan(halfSize.lat);
-        double y2 = tan(halfSize.lon);
-        double scaleToCoverCenter = sqrt(1 + pow(y1, 2) + pow(y2, 2));
-        
-        double maxCornerHeight = maxCenterRadius * scaleToCoverCenter - patchCenterRadius;
-
-        bool chunkIsNorthOfEquator = patch.isNorthern();
-
-        // The minimum height offset, however, we can simply 
-        double minCornerHeight = boundingHeight.min;
-        std::vector<glm::dvec4> corners(8);
-        
-        Scalar latCloseToEquator = patch.edgeLatitudeNearestEquator();
-        Geodetic3 p1Geodetic = { { latCloseToEquator, patch.minLon() }, maxCornerHeight };
-        Geodetic3 p2Geodetic = { { latCloseToEquator, patch.maxLon() }, maxCornerHeight };
-        
-        glm::vec3 p1 = ellipsoid.cartesianPosition(p1Geodetic);
-        glm::vec3 p2 = ellipsoid.cartesianPosition(p2Geodetic);
-        glm::vec3 p = 0.5f * (p1 + p2);
-        Geodetic2 pGeodetic = ellipsoid.cartesianToGeodetic2(p);
-        Scalar latDiff = latCloseToEquator - pGeodetic.lat;
-
-        for (size_t i = 0; i < 8; i++) {
-            Quad q = (Quad)(i % 4);
-            double cornerHeight = i < 4 ? minCornerHeight : maxCornerHeight;
-            Geodetic3 cornerGeodetic = { patch.getCorner(q), cornerHeight };
-            
-            bool cornerIsNorthern = !((i / 2) % 2);
-            bool cornerCloseToEquator = chunkIsNorthOfEquator ^ cornerIsNorthern;
-            if (cornerCloseToEquator) {
-                cornerGeodetic.geodetic2.lat += latDiff;
-            }
-
-            corners[i] = dvec4(ellipsoid.cartesianPosition(cornerGeodetic), 1);
-        }
-        return corners;
+        return ChunkBounds(
+            surfacePatch(),
+            owner()->ellipsoid(),
+            boundingHeight.min,
+            boundingHeight.max
+        );
     }
 
 
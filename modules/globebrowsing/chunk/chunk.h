@@ -26,6 +26,7 @@
 #define __CHUNK_H__
 
 #include <glm/glm.hpp>
+#include <array>
 #include <vector>
 #include <memory>
 #include <ostream>
@@ -42,6 +43,7 @@
 namespace openspace {
 
     class ChunkedLodGlobe;
+    class ChunkLevelScheduler;
 
     class Chunk {
     public:
@@ -58,19 +60,41 @@ namespace openspace {
             WANT_MERGE,
             WANT_SPLIT,
         };
+
+        /// The desired level of a previous frame that can be reused in later frames
+        struct LevelEvaluation {
+            /// The continuous desired level, see ChunkLevelEvaluator
+            double level = 0.0;
+            /// The camera position in the model space of the globe
+            glm::dvec3 cameraPosition;
+            /// The distance between the camera and the closest point of the chunk
+            double distance = 0.0;
+            /// The frame of the ChunkLevelScheduler in which the level was computed
+            int frame = 0;
+            /// Identifies the settings of the ChunkLevelScheduler that were used
+            int generation = -1;
+        };
         
         Chunk(ChunkedLodGlobe* owner, const ChunkIndex& chunkIndex, bool initVisible = true);
 
-        /// Updates chunk internally and returns a desired level
-        Status update(const RenderData& data);
+        /**
+         * Updates the visibility of the chunk and returns whether it wants to change its
+         * level, as decided by the \p scheduler.
+         */
+        Status update(const RenderData& data, ChunkLevelScheduler& scheduler);
+
+        std::array<glm::dvec4, 8> getBoundingPolyhedronCorners() const;
 
-        std::vector<glm::dvec4> getBoundingPolyhedronCorners() const;
+        /// Returns the bounds used for culling, which queries the bounding heights once
+        ChunkBounds getBounds() const;
 
         const GeodeticPatch& surfacePatch() const;
         ChunkedLodGlobe* const owner() const;
         const ChunkIndex index() const;
         bool isVisible() const;
         BoundingHeights getBoundingHeights() const;
+        const LevelEvaluation& levelEvaluation() const;
+        LevelEvaluation& levelEvaluation();
 
         void setIndex(const ChunkIndex& index);
         void setOwner(ChunkedLodGlobe* newOwner);
@@ -82,6 +106,7 @@ namespace openspace {
         ChunkIndex _index;
         bool _isVisible;
         GeodeticPatch _surfacePatch;
+        LevelEvaluation _levelEvaluation;
 
     };
 
@@ -27,12 +27,15 @@
 #include <modules/globebrowsing/meshes/skirtedgrid.h>
 #include <modules/globebrowsing/chunk/culling.h>
 #include <modules/globebrowsing/chunk/chunklevelevaluator.h>
+#include <modules/globebrowsing/tile/tileselector.h>
 
 #include <modules/debugging/rendering/debugrenderer.h>
 
 
 // open space includes
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/windowwrapper.h>
+#include <openspace/interaction/sessionrecording.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/scene/scenegraphnode.h>
@@ -70,6 +73,8 @@ namespace openspace {
         , maxSplitDepth(22)
         , _savedCamera(nullptr)
         , _tileProviderManager(tileProviderManager)
+        , _previousLodScaleFactor(0.f)
+        , _previousLevelByProjArea(true)
         , stats(StatsCollector(absPath("test_stats"), 1, StatsCollector::Enabled::No))
     {
 
@@ -88,6 +93,19 @@ namespace openspace {
         _chunkEvaluatorByProjectedArea = std::make_unique<EvaluateChunkLevelByProjectedArea>();
         _chunkEvaluatorByDistance = std::make_unique<EvaluateChunkLevelByDistance>();
 
+        _levelScheduler = std::make_unique<ChunkLevelScheduler>(
+            [this](const Chunk& chunk) {
+                return testIfCullable(chunk);
+            },
+            [this](const Chunk& chunk, const RenderData& data) {
+                return getDesiredLevelExact(chunk, data);
+            },
+            [this](const Chunk& chunk, const RenderData& data) {
+                return getMaxLevel(chunk, data);
+            },
+            minSplitDepth
+        );
+
         _renderer = std::make_unique<ChunkRenderer>(geometry, tileProviderManager);
 
     }
@@ -113,11 +131,21 @@ namespace openspace {
         return _tileProviderManager;
     }
 
-    bool ChunkedLodGlobe::testIfCullable(const Chunk& chunk, const RenderData& renderData) const {
-        if (debugOptions.doHorizonCulling && _chunkCullers[0]->isCullable(chunk, renderData)) {
+    bool ChunkedLodGlobe::testIfCullable(const Chunk& chunk) const {
+        if (!debugOptions.doHorizonCulling && !debugOptions.doFrustumCulling) {
+            return false;
+        }
+
+        // Computed once as the bounding heights require a lookup of the height tiles
+        ChunkBounds bounds = chunk.getBounds();
+        if (debugOptions.doHorizonCulling &&
+            _chunkCullers[0]->isCullable(bounds, _cullingContext))
+        {
             return true;
         }
-        if (debugOptions.doFrustumCulling && _chunkCullers[1]->isCullable(chunk, renderData)) {
+        if (debugOptions.doFrustumCulling &&
+            _chunkCullers[1]->isCullable(bounds, _cullingContext))
+        {
             return true;
         }
         return false;
@@ -133,23 +161,35 @@ namespace openspace {
         return p.lon < COVERAGE.center().lon ? _leftRoot->find(p) : _rightRoot->find(p);
     }
 
-    int ChunkedLodGlobe::getDesiredLevel(const Chunk& chunk, const RenderData& renderData) const {
-        int desiredLevel = 0;
+    double ChunkedLodGlobe::getDesiredLevelExact(const Chunk& chunk,
+                                                 const RenderData& renderData) const
+    {
         if (debugOptions.levelByProjAreaElseDistance) {
-            desiredLevel = _chunkEvaluatorByProjectedArea->getDesiredLevel(chunk, renderData);
+            return _chunkEvaluatorByProjectedArea->getDesiredLevelExact(
+                chunk,
+                renderData
+            );
         }
         else {
-            desiredLevel = _chunkEvaluatorByDistance->getDesiredLevel(chunk, renderData);
+            return _chunkEvaluatorByDistance->getDesiredLevelExact(chunk, renderData);
         }
+    }
 
-
-        int desiredLevelByAvailableData = _chunkEvaluatorByAvailableTiles->getDesiredLevel(chunk, renderData);
+    int ChunkedLodGlobe::getMaxLevel(const Chunk& chunk,
+                                     const RenderData& renderData) const
+    {
+        int maxLevel = maxSplitDepth;
+        int desiredLevelByAvailableData =
+            _chunkEvaluatorByAvailableTiles->getDesiredLevel(chunk, renderData);
         if (desiredLevelByAvailableData != ChunkLevelEvaluator::UNKNOWN_DESIRED_LEVEL) {
-            desiredLevel = min(desiredLevel, desiredLevelByAvailableData);
+            maxLevel = min(maxLevel, desiredLevelByAvailableData);
         }
 
-        desiredLevel = glm::clamp(desiredLevel, minSplitDepth, maxSplitDepth);
-        return desiredLevel;
+        return glm::clamp(maxLevel, minSplitDepth, maxSplitDepth);
+    }
+
+    ChunkLevelScheduler& ChunkedLodGlobe::levelScheduler() {
+        return *_levelScheduler;
     }
     
     void ChunkedLodGlobe::render(const RenderData& data){
@@ -164,14 +204,82 @@ namespace openspace {
 
         minDistToCamera = INFINITY;
 
-        _leftRoot->updateChunkTree(data);
-        _rightRoot->updateChunkTree(data);
+        // The culling and the level selection are reported as a stage of the frame
+        // while a recorded session is played back
+        {
+            interaction::SessionRecording::StageTimer cullingTimer(
+                OsEng.sessionRecording(),
+                "Culling"
+            );
+
+            // The chunks are culled against the saved camera, if there is one
+            const Camera::Snapshot& cullingCamera =
+                _savedCamera != nullptr ? *_savedCamera : data.camera;
+            _cullingContext.update(
+                cullingCamera.combinedViewProjectionMatrix(),
+                cullingCamera.positionVec3(),
+                _modelTransform,
+                _inverseModelTransform,
+                _ellipsoid
+            );
+
+            // The levels that were computed with other settings cannot be reused
+            if (lodScaleFactor != _previousLodScaleFactor ||
+                debugOptions.levelByProjAreaElseDistance != _previousLevelByProjArea)
+            {
+                _levelScheduler->invalidateLevels();
+                _previousLodScaleFactor = lodScaleFactor;
+                _previousLevelByProjArea = debugOptions.levelByProjAreaElseDistance;
+            }
+
+            // The levels are also evaluated for the saved camera, if there is one
+            RenderData levelData = {
+                cullingCamera, data.position, data.doPerformanceMeasurement
+            };
+            _levelScheduler->beginFrame(_cullingContext.cameraPosition, _ellipsoid);
+            _leftRoot->updateChunkTree(levelData, *_levelScheduler);
+            _rightRoot->updateChunkTree(levelData, *_levelScheduler);
+            _levelScheduler->endFrame();
+        }
+
+        const ChunkLevelScheduler::Statistics& levelStats = _levelScheduler->statistics();
+        stats.i["splits"] = levelStats.nSplits;
+        stats.i["merges"] = levelStats.nMerges;
+        stats.i["deferred splits"] = levelStats.nDeferredSplits;
+        stats.i["deferred merges"] = levelStats.nDeferredMerges;
+        stats.i["reused levels"] = levelStats.nReusedEvaluations;
+
+        // Without an OpenGL context nothing is drawn, but the tiles of the visible leaves
+        // are requested as the renderer would do it. The tile I/O, and thereby the
+        // levels that the available tile data allow, advance just as with a window
+        if (OsEng.windowWrapper().isHeadless()) {
+            std::function<void(const ChunkNode&)> requestJob =
+                [this](const ChunkNode& chunkNode)
+            {
+                const Chunk& chunk = chunkNode.getChunk();
+                if (!chunkNode.isLeaf() || !chunk.isVisible()) {
+                    return;
+                }
+                for (size_t i = 0; i < LayeredTextures::NUM_TEXTURE_CATEGORIES; i++) {
+                    const TileProviderGroup& group =
+                        _tileProviderManager->getTileProviderGroup(i);
+                    for (TileProvider* provider : group.getActiveTileProviders()) {
+                        TileSelector::getHighestResolutionTile(provider, chunk.index());
+                    }
+                }
+            };
+            _leftRoot->reverseBreadthFirst(requestJob);
+            _rightRoot->reverseBreadthFirst(requestJob);
+            return;
+        }
 
         // Calculate the MVP matrix
         dmat4 viewTransform = dmat4(data.camera.combinedViewMatrix());
         dmat4 vp = dmat4(data.camera.projectionMatrix()) * viewTransform;
         dmat4 mvp = vp * _modelTransform;
 
+        _renderer->updatePreprocessingData(*this);
+
         // Render function
         std::function<void(const ChunkNode&)> renderJob = [this, &data, &mvp](const ChunkNode& chunkNode) {
             stats.i["chunks"]++;
@@ -207,7 +315,8 @@ namespace openspace {
 
     void ChunkedLodGlobe::debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp) const {
         if (debugOptions.showChunkBounds || debugOptions.showChunkAABB) {
-            const std::vector<glm::dvec4> modelSpaceCorners = chunk.getBoundingPolyhedronCorners();
+            const std::array<glm::dvec4, 8> modelSpaceCorners =
+                chunk.getBoundingPolyhedronCorners();
             std::vector<glm::vec4> clippingSpaceCorners(8);
             AABB3 screenSpaceBounds;
             for (size_t i = 0; i < 8; i++) {
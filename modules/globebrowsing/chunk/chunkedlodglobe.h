@@ -41,6 +41,7 @@
 
 #include <modules/globebrowsing/chunk/chunknode.h>
 #include <modules/globebrowsing/chunk/chunkrenderer.h>
+#include <modules/globebrowsing/chunk/chunklevelscheduler.h>
 
 #include <modules/globebrowsing/tile/tileprovider/tileprovider.h>
 #include <modules/globebrowsing/other/statscollector.h>
@@ -76,8 +77,16 @@ namespace openspace {
         const ChunkNode& findChunkNode(const Geodetic2 location) const;
         ChunkNode& findChunkNode(const Geodetic2 location);
 
-        bool testIfCullable(const Chunk& chunk, const RenderData& renderData) const;
-        int getDesiredLevel(const Chunk& chunk, const RenderData& renderData) const;
+        /// Tests the chunk against the culling context of the current frame
+        bool testIfCullable(const Chunk& chunk) const;
+        /// Returns the continuous desired level of the chunk by the selected evaluator
+        double getDesiredLevelExact(const Chunk& chunk,
+            const RenderData& renderData) const;
+        /// Returns the highest level the chunk may have with the available tile data
+        int getMaxLevel(const Chunk& chunk, const RenderData& renderData) const;
+
+        /// The scheduler that limits how the chunk tree changes between frames
+        ChunkLevelScheduler& levelScheduler();
 
         double minDistToCamera;
 
@@ -92,8 +101,8 @@ namespace openspace {
         std::shared_ptr<TileProviderManager> getTileProviderManager() const;
 
 
-        const std::shared_ptr<const Camera> getSavedCamera() const { return _savedCamera; }
-        void setSaveCamera(std::shared_ptr<Camera> c) { 
+        const std::shared_ptr<const Camera::Snapshot> getSavedCamera() const { return _savedCamera; }
+        void setSaveCamera(std::shared_ptr<Camera::Snapshot> c) { 
             _savedCamera = c; 
         }
 
@@ -135,16 +144,24 @@ namespace openspace {
         static const ChunkIndex RIGHT_HEMISPHERE_INDEX;
 
         std::vector<std::unique_ptr<ChunkCuller>> _chunkCullers;
+        // Updated at the beginning of every frame, before the chunk tree is updated
+        CullingContext _cullingContext;
 
         std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByAvailableTiles;
         std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByProjectedArea;
         std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByDistance;
 
+        std::unique_ptr<ChunkLevelScheduler> _levelScheduler;
+        // The inputs of the desired levels in the previous frame, which invalidate the
+        // levels that the scheduler reuses when they change
+        float _previousLodScaleFactor;
+        bool _previousLevelByProjArea;
+
         const Ellipsoid& _ellipsoid;
         glm::dmat4 _modelTransform;
         glm::dmat4 _inverseModelTransform;
 
-        std::shared_ptr<Camera> _savedCamera;
+        std::shared_ptr<Camera::Snapshot> _savedCamera;
         
         std::shared_ptr<TileProviderManager> _tileProviderManager;
     };
@@ -41,8 +41,19 @@ namespace {
 
 namespace openspace {
 
+    double ChunkLevelEvaluator::getDesiredLevelExact(const Chunk& chunk,
+                                                     const RenderData& data) const
+    {
+        return getDesiredLevel(chunk, data) + 0.5;
+    }
     
     int EvaluateChunkLevelByDistance::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
+        return static_cast<int>(floor(getDesiredLevelExact(chunk, data)));
+    }
+
+    double EvaluateChunkLevelByDistance::getDesiredLevelExact(
+        const Chunk& chunk, const RenderData& data) const
+    {
         // Calculations are done in the reference frame of the globe. Hence, the camera
         // position needs to be transformed with the inverse model matrix
         glm::dmat4 inverseModelTransform = chunk.owner()->inverseModelTransform();
@@ -66,11 +77,17 @@ namespace openspace {
 
         Scalar scaleFactor = globe->lodScaleFactor * ellipsoid.minimumRadius();
         Scalar projectedScaleFactor = scaleFactor / distance;
-        int desiredLevel = ceil(log2(projectedScaleFactor));
-        return desiredLevel;
+        // The integer part is ceil(log2(projectedScaleFactor))
+        return log2(projectedScaleFactor) + 1.0;
     }
 
     int EvaluateChunkLevelByProjectedArea::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
+        return static_cast<int>(floor(getDesiredLevelExact(chunk, data)));
+    }
+
+    double EvaluateChunkLevelByProjectedArea::getDesiredLevelExact(
+        const Chunk& chunk, const RenderData& data) const
+    {
         // Calculations are done in the reference frame of the globe. Hence, the camera
         // position needs to be transformed with the inverse model matrix
         glm::dmat4 inverseModelTransform = chunk.owner()->inverseModelTransform();
@@ -157,17 +174,17 @@ namespace openspace {
         double projectedChunkAreaApprox = 8 * areaABC;
 
         double scaledArea = globe->lodScaleFactor * projectedChunkAreaApprox;
-        return chunk.index().level + round(scaledArea - 1);
+        // The integer part is chunk.index().level + round(scaledArea - 1)
+        return chunk.index().level + scaledArea - 0.5;
     }
 
     int EvaluateChunkLevelByAvailableTileData::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
         auto tileProvidermanager = chunk.owner()->getTileProviderManager();
-        auto heightMapProviders = tileProvidermanager->getTileProviderGroup(LayeredTextures::HeightMaps).getActiveTileProviders();
         int currLevel = chunk.index().level;
 
         for (size_t i = 0; i < LayeredTextures::NUM_TEXTURE_CATEGORIES; i++) {
-            auto tileProviderGroup = tileProvidermanager->getTileProviderGroup(i);
-            for (auto tileProvider : tileProviderGroup.getActiveTileProviders()) {
+            const TileProviderGroup& tileProviderGroup = tileProvidermanager->getTileProviderGroup(i);
+            for (TileProvider* tileProvider : tileProviderGroup.getActiveTileProviders()) {
                 Tile::Status tileStatus = tileProvider->getTileStatus(chunk.index());
 
                 if (tileStatus == Tile::Status::OK) {
@@ -38,6 +38,16 @@ namespace openspace {
     class ChunkLevelEvaluator {
     public:
         virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const = 0;
+
+        /**
+         * Returns the desired level as a continuous value, whose integer part is the
+         * level returned by getDesiredLevel. The fractional part tells how close the
+         * chunk is to the next level, which is used for hysteresis. The default
+         * implementation returns the middle of the desired level.
+         */
+        virtual double getDesiredLevelExact(const Chunk& chunk,
+            const RenderData& data) const;
+
         static const int UNKNOWN_DESIRED_LEVEL = -1;
     };
 
@@ -46,11 +56,15 @@ namespace openspace {
     class EvaluateChunkLevelByDistance : public ChunkLevelEvaluator {
     public:
         virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const;
+        virtual double getDesiredLevelExact(const Chunk& chunk,
+            const RenderData& data) const;
     };
 
     class EvaluateChunkLevelByProjectedArea : public ChunkLevelEvaluator {
     public:
         virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const;
+        virtual double getDesiredLevelExact(const Chunk& chunk,
+            const RenderData& data) const;
     };
 
     class EvaluateChunkLevelByAvailableTileData : public ChunkLevelEvaluator {
@@ -0,0 +1,204 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/chunk/chunklevelscheduler.h>
+
+#include <modules/globebrowsing/chunk/chunknode.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+    const std::string _loggerCat = "ChunkLevelScheduler";
+}
+
+namespace openspace {
+
+    ChunkLevelScheduler::ChunkLevelScheduler(CullingFunction isCullable,
+                                             LevelFunction desiredLevel,
+                                             MaxLevelFunction maxLevel, int minLevel)
+        : _isCullable(std::move(isCullable))
+        , _desiredLevel(std::move(desiredLevel))
+        , _maxLevel(std::move(maxLevel))
+        , _minLevel(minLevel)
+        , _cameraPosition(0.0)
+        , _ellipsoid(nullptr)
+        , _generation(0)
+        , _frame(0)
+    {
+        ghoul_assert(_isCullable, "Culling function must not be empty");
+        ghoul_assert(_desiredLevel, "Level function must not be empty");
+        ghoul_assert(_maxLevel, "Max level function must not be empty");
+    }
+
+    void ChunkLevelScheduler::beginFrame(const Vec3& cameraPosition,
+                                         const Ellipsoid& ellipsoid)
+    {
+        _cameraPosition = cameraPosition;
+        _cameraGeodetic = ellipsoid.cartesianToGeodetic2(cameraPosition);
+        _ellipsoid = &ellipsoid;
+        ++_frame;
+
+        _splitRequests.clear();
+        _mergeRequests.clear();
+        _statistics = Statistics();
+    }
+
+    void ChunkLevelScheduler::endFrame() {
+        _statistics.nSplits = execute(
+            _splitRequests,
+            settings.maxSplitsPerFrame,
+            [](ChunkNode& node) { node.split(); }
+        );
+        _statistics.nDeferredSplits =
+            static_cast<int>(_splitRequests.size()) - _statistics.nSplits;
+
+        _statistics.nMerges = execute(
+            _mergeRequests,
+            settings.maxMergesPerFrame,
+            [](ChunkNode& node) { node.merge(); }
+        );
+        _statistics.nDeferredMerges =
+            static_cast<int>(_mergeRequests.size()) - _statistics.nMerges;
+
+        // The requests point to nodes that might have been merged away
+        _splitRequests.clear();
+        _mergeRequests.clear();
+    }
+
+    void ChunkLevelScheduler::invalidateLevels() {
+        ++_generation;
+    }
+
+    bool ChunkLevelScheduler::isCullable(const Chunk& chunk) const {
+        return _isCullable(chunk);
+    }
+
+    Chunk::Status ChunkLevelScheduler::status(Chunk& chunk, const RenderData& data) {
+        const int level = chunk.index().level;
+        const int maxLevel = std::max(_maxLevel(chunk, data), _minLevel);
+        const double desiredLevel = this->desiredLevel(chunk, data);
+
+        if (level < _minLevel) {
+            return Chunk::Status::WANT_SPLIT;
+        }
+        if (level > maxLevel) {
+            return Chunk::Status::WANT_MERGE;
+        }
+        if (level < maxLevel && desiredLevel >= level + 1 + settings.hysteresis) {
+            return Chunk::Status::WANT_SPLIT;
+        }
+        if (level > _minLevel && desiredLevel < level - settings.hysteresis) {
+            return Chunk::Status::WANT_MERGE;
+        }
+        return Chunk::Status::DO_NOTHING;
+    }
+
+    void ChunkLevelScheduler::requestSplit(ChunkNode& node) {
+        ghoul_assert(node.isLeaf(), "Only leaves can be split");
+
+        // The further the desired level is above the next level, the larger the error
+        const Chunk& chunk = node.getChunk();
+        double priority = chunk.index().level < _minLevel ?
+            std::numeric_limits<double>::max() :
+            chunk.levelEvaluation().level - (chunk.index().level + 1);
+        _splitRequests.push_back({ &node, priority });
+    }
+
+    void ChunkLevelScheduler::requestMerge(ChunkNode& node) {
+        ghoul_assert(!node.isLeaf(), "Only nodes with children can be merged");
+
+        // Merging loses the detail of the most detailed visible child. Children that are
+        // culled do not contribute to the error
+        double priority = std::numeric_limits<double>::max();
+        bool hasVisibleChild = false;
+        for (int i = 0; i < 4; ++i) {
+            const Chunk& child = node.getChild(static_cast<Quad>(i)).getChunk();
+            if (child.isVisible()) {
+                hasVisibleChild = true;
+                priority = std::min(
+                    priority,
+                    child.index().level - child.levelEvaluation().level
+                );
+            }
+        }
+        priority = hasVisibleChild ? std::max(priority, 0.0) : 0.0;
+        _mergeRequests.push_back({ &node, priority });
+    }
+
+    const ChunkLevelScheduler::Statistics& ChunkLevelScheduler::statistics() const {
+        return _statistics;
+    }
+
+    double ChunkLevelScheduler::desiredLevel(Chunk& chunk, const RenderData& data) {
+        ghoul_assert(_ellipsoid, "beginFrame must be called before status");
+
+        Chunk::LevelEvaluation& evaluation = chunk.levelEvaluation();
+        if (evaluation.generation == _generation &&
+            _frame - evaluation.frame <= settings.maxReuseFrames)
+        {
+            const double movement =
+                glm::length(_cameraPosition - evaluation.cameraPosition);
+            if (movement <= settings.reuseTolerance * evaluation.distance) {
+                ++_statistics.nReusedEvaluations;
+                return evaluation.level;
+            }
+        }
+
+        const Geodetic2 closestPoint = chunk.surfacePatch().closestPoint(_cameraGeodetic);
+        evaluation.level = _desiredLevel(chunk, data);
+        evaluation.cameraPosition = _cameraPosition;
+        evaluation.distance = glm::length(
+            _ellipsoid->cartesianSurfacePosition(closestPoint) - _cameraPosition
+        );
+        evaluation.frame = _frame;
+        evaluation.generation = _generation;
+        ++_statistics.nEvaluations;
+        return evaluation.level;
+    }
+
+    int ChunkLevelScheduler::execute(std::vector<Request>& requests, int budget,
+                                     const std::function<void(ChunkNode&)>& operation)
+    {
+        int nExecuted = static_cast<int>(requests.size());
+        if (budget >= 0 && budget < nExecuted) {
+            // Stable, so that requests with the same priority are executed in the order
+            // in which the tree was traversed
+            std::stable_sort(
+                requests.begin(),
+                requests.end(),
+                [](const Request& a, const Request& b) { return a.priority > b.priority; }
+            );
+            nExecuted = budget;
+        }
+
+        for (int i = 0; i < nExecuted; ++i) {
+            operation(*requests[i].node);
+        }
+        return nExecuted;
+    }
+
+} // namespace openspace
@@ -0,0 +1,156 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __CHUNK_LEVEL_SCHEDULER_H__
+#define __CHUNK_LEVEL_SCHEDULER_H__
+
+#include <modules/globebrowsing/chunk/chunk.h>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
+
+#include <functional>
+#include <vector>
+
+namespace openspace {
+
+    class ChunkNode;
+
+    /**
+     * Decides which chunks are split and merged in a frame. A chunk wants to split when
+     * its continuous desired level exceeds the next level by the hysteresis and wants to
+     * merge when the desired level falls below its own level by the hysteresis, so that
+     * small camera movements around a threshold do not make chunks split and merge back
+     * and forth. The splits and merges that the ChunkNode%s request are not executed
+     * right away but collected until #endFrame, which executes the ones with the largest
+     * screen space error first and defers the rest to later frames once the budget of
+     * the frame is used up. The desired level of a chunk is reused from an earlier frame
+     * as long as the camera has moved less than a fraction of its distance to the chunk.
+     */
+    class ChunkLevelScheduler {
+    public:
+        /// Returns whether the chunk is culled in the current frame
+        using CullingFunction = std::function<bool(const Chunk&)>;
+        /// Returns the continuous desired level of the chunk
+        using LevelFunction = std::function<double(const Chunk&, const RenderData&)>;
+        /// Returns the highest level that the chunk may have in the current frame
+        using MaxLevelFunction = std::function<int(const Chunk&, const RenderData&)>;
+
+        struct Settings {
+            /// How far, in levels, the desired level has to pass a threshold
+            double hysteresis = 0.2;
+            /// The maximum number of splits per frame; negative for no limit
+            int maxSplitsPerFrame = 64;
+            /// The maximum number of merges per frame; negative for no limit
+            int maxMergesPerFrame = 256;
+            /// The camera movement relative to the distance to a chunk below which the
+            /// desired level of the chunk is reused
+            double reuseTolerance = 0.002;
+            /// The number of frames after which a desired level is computed again, so
+            /// that changes of the bounding heights are picked up
+            int maxReuseFrames = 30;
+        };
+
+        struct Statistics {
+            int nSplits = 0;
+            int nMerges = 0;
+            /// Requested splits that were deferred to later frames by the budget
+            int nDeferredSplits = 0;
+            /// Requested merges that were deferred to later frames by the budget
+            int nDeferredMerges = 0;
+            /// The number of chunks whose desired level was computed
+            int nEvaluations = 0;
+            /// The number of chunks whose desired level was reused
+            int nReusedEvaluations = 0;
+        };
+
+        /**
+         * Creates a scheduler that asks the functions for the state of the chunks.
+         * \param minLevel The lowest level of chunks that are not culled
+         */
+        ChunkLevelScheduler(CullingFunction isCullable, LevelFunction desiredLevel,
+            MaxLevelFunction maxLevel, int minLevel);
+
+        /**
+         * Starts a new frame, which resets the statistics.
+         * \param cameraPosition The camera position in the model space of the globe
+         * \param ellipsoid The ellipsoid of the globe
+         */
+        void beginFrame(const Vec3& cameraPosition, const Ellipsoid& ellipsoid);
+
+        /// Executes the requested splits and merges within the budget of the frame
+        void endFrame();
+
+        /// Discards the desired levels of all chunks, for example when the way in which
+        /// they are computed has changed
+        void invalidateLevels();
+
+        bool isCullable(const Chunk& chunk) const;
+
+        /// Returns whether a chunk that is not culled wants to change its level
+        Chunk::Status status(Chunk& chunk, const RenderData& data);
+
+        /// Requests a split of the leaf \p node, whose chunk wants to split
+        void requestSplit(ChunkNode& node);
+
+        /// Requests a merge of the children of \p node, which all want to merge
+        void requestMerge(ChunkNode& node);
+
+        /// Returns the statistics of the most recent frame
+        const Statistics& statistics() const;
+
+        Settings settings;
+
+    private:
+        struct Request {
+            ChunkNode* node;
+            double priority;
+        };
+
+        /// Returns the desired level, which is computed again if it cannot be reused
+        double desiredLevel(Chunk& chunk, const RenderData& data);
+
+        /// Executes at most \p budget of the \p requests, with the highest priority first
+        static int execute(std::vector<Request>& requests, int budget,
+            const std::function<void(ChunkNode&)>& operation);
+
+        CullingFunction _isCullable;
+        LevelFunction _desiredLevel;
+        MaxLevelFunction _maxLevel;
+        int _minLevel;
+
+        Vec3 _cameraPosition;
+        Geodetic2 _cameraGeodetic;
+        const Ellipsoid* _ellipsoid;
+
+        // Increased by invalidateLevels
+        int _generation;
+        int _frame;
+
+        std::vector<Request> _splitRequests;
+        std::vector<Request> _mergeRequests;
+        Statistics _statistics;
+    };
+
+} // namespace openspace
+
+#endif // __CHUNK_LEVEL_SCHEDULER_H__
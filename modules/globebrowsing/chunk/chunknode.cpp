@@ -31,6 +31,7 @@
 
 #include <modules/globebrowsing/chunk/chunknode.h>
 #include <modules/globebrowsing/chunk/chunkedlodglobe.h>
+#include <modules/globebrowsing/chunk/chunklevelscheduler.h>
 #include <modules/globebrowsing/chunk/culling.h>
 
 
@@ -67,30 +68,31 @@ bool ChunkNode::isLeaf() const {
 
 
 // Returns true or false wether this node can be merge or not
-bool ChunkNode::updateChunkTree(const RenderData& data) {
+bool ChunkNode::updateChunkTree(const RenderData& data, ChunkLevelScheduler& scheduler) {
     //Geodetic2 center = _chunk.surfacePatch.center();
     //LDEBUG("x: " << patch.x << " y: " << patch.y << " level: " << patch.level << "  lat: " << center.lat << " lon: " << center.lon);
 
     if (isLeaf()) {
-        Chunk::Status status = _chunk.update(data);
+        Chunk::Status status = _chunk.update(data, scheduler);
         if (status == Chunk::Status::WANT_SPLIT) {
-            split();
+            scheduler.requestSplit(*this);
         }
         return status == Chunk::Status::WANT_MERGE;
     }
     else {
         char requestedMergeMask = 0;
         for (int i = 0; i < 4; ++i) {
-            if (_children[i]->updateChunkTree(data)) {
+            if (_children[i]->updateChunkTree(data, scheduler)) {
                 requestedMergeMask |= (1 << i);
             }
         }
 
         bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        bool thisChunkWantsSplit = _chunk.update(data) == Chunk::Status::WANT_SPLIT;
+        bool thisChunkWantsSplit =
+            _chunk.update(data, scheduler) == Chunk::Status::WANT_SPLIT;
 
         if (allChildrenWantsMerge && !thisChunkWantsSplit) {
-            merge();
+            scheduler.requestMerge(*this);
         }
 
         return false;
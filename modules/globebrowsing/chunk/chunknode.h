@@ -44,6 +44,7 @@
 // forward declaration
 namespace openspace {
     class ChunkedLodGlobe;
+    class ChunkLevelScheduler;
 }
 
 
@@ -74,7 +75,12 @@ public:
 
     const Chunk& getChunk() const;
 
-    bool updateChunkTree(const RenderData& data);
+    /**
+     * Updates the chunks of the tree and requests the splits and merges that they want
+     * from the \p scheduler, which executes them at the end of the frame.
+     * \return true if this node is a leaf whose chunk wants to merge
+     */
+    bool updateChunkTree(const RenderData& data, ChunkLevelScheduler& scheduler);
 
     static int chunkNodeCount;
 
@@ -62,20 +62,32 @@ namespace openspace {
         std::shared_ptr<TileProviderManager> tileProviderManager)
         : _tileProviderManager(tileProviderManager)
         , _grid(grid)
+        , _hasPrecompiledShaderPrograms(false)
     {
+        std::vector<std::pair<std::string, std::string>> constantDefinitions = {
+            { "defaultHeight", std::to_string(Chunk::DEFAULT_HEIGHT) }
+        };
+
         _globalRenderingShaderProvider = std::make_shared<LayeredTextureShaderProvider>(
                 "GlobalChunkedLodPatch",
                 "${MODULE_GLOBEBROWSING}/shaders/globalchunkedlodpatch_vs.glsl",
-                "${MODULE_GLOBEBROWSING}/shaders/globalchunkedlodpatch_fs.glsl");
+                "${MODULE_GLOBEBROWSING}/shaders/globalchunkedlodpatch_fs.glsl",
+                constantDefinitions);
 
         _localRenderingShaderProvider = std::make_shared<LayeredTextureShaderProvider>(
                 "LocalChunkedLodPatch",
                 "${MODULE_GLOBEBROWSING}/shaders/localchunkedlodpatch_vs.glsl",
-                "${MODULE_GLOBEBROWSING}/shaders/localchunkedlodpatch_fs.glsl");
+                "${MODULE_GLOBEBROWSING}/shaders/localchunkedlodpatch_fs.glsl",
+                constantDefinitions);
 
         _globalProgramUniformHandler = std::make_shared<LayeredTextureShaderUniformIdHandler>();
         _localProgramUniformHandler = std::make_shared<LayeredTextureShaderUniformIdHandler>();
 
+        // The groups keep their lists of active tile providers up to date, so the lists
+        // only have to be looked up once
+        for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
+            _tileProviders[category] = &_tileProviderManager->getTileProviderGroup(category).getActiveTileProviders();
+        }
     }
 
     void ChunkRenderer::renderChunk(const Chunk& chunk, const RenderData& data) {
@@ -91,6 +103,39 @@ namespace openspace {
         // unued atm. Could be used for caching or precalculating
     }
 
+    void ChunkRenderer::updatePreprocessingData(const ChunkedLodGlobe& globe) {
+        using Flag = LayeredTexturePreprocessingData::Flag;
+
+        for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
+            LayeredTextureInfo& layeredTextureInfo = _preprocessingData.layeredTextureInfo[category];
+            layeredTextureInfo.lastLayerIdx = _tileProviders[category]->size() - 1;
+            layeredTextureInfo.layerBlendingEnabled = _tileProviderManager->getTileProviderGroup(category).levelBlendingEnabled;
+        }
+
+        _preprocessingData.setFlag(Flag::UseAtmosphere, globe.atmosphereEnabled);
+        _preprocessingData.setFlag(Flag::ShowChunkEdges, globe.debugOptions.showChunkEdges);
+        _preprocessingData.setFlag(
+            Flag::ShowHeightResolution,
+            globe.debugOptions.showHeightResolution);
+        _preprocessingData.setFlag(
+            Flag::ShowHeightIntensities,
+            globe.debugOptions.showHeightIntensities);
+
+        if (!_hasPrecompiledShaderPrograms) {
+            // Compile the variants for the initial layers and for each of the toggles
+            // flipped in the background, so that toggling them later does not stall
+            std::vector<LayeredTexturePreprocessingData> variants = { _preprocessingData };
+            for (int i = 0; i < LayeredTexturePreprocessingData::NUM_FLAGS; i++) {
+                LayeredTexturePreprocessingData variant = _preprocessingData;
+                variant.setFlag(Flag(i), !_preprocessingData.flag(Flag(i)));
+                variants.push_back(variant);
+            }
+            _globalRenderingShaderProvider->precompileShaderPrograms(variants);
+            _localRenderingShaderProvider->precompileShaderPrograms(variants);
+            _hasPrecompiledShaderPrograms = true;
+        }
+    }
+
 
     void ChunkRenderer::setDepthTransformUniforms(
         std::shared_ptr<LayeredTextureShaderUniformIdHandler> uniformIdHandler,
@@ -162,53 +207,13 @@ namespace openspace {
     {
         const ChunkIndex& chunkIndex = chunk.index();
 
-        std::array<std::vector<std::shared_ptr<TileProvider> >,
-            LayeredTextures::NUM_TEXTURE_CATEGORIES> tileProviders;
-        LayeredTexturePreprocessingData layeredTexturePreprocessingData;
-
-        for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
-            tileProviders[category] = _tileProviderManager->getTileProviderGroup(category).getActiveTileProviders();
-
-            LayeredTextureInfo layeredTextureInfo;
-            layeredTextureInfo.lastLayerIdx = tileProviders[category].size() - 1;
-            layeredTextureInfo.layerBlendingEnabled = _tileProviderManager->getTileProviderGroup(category).levelBlendingEnabled;
-
-            layeredTexturePreprocessingData.layeredTextureInfo[category] = layeredTextureInfo;
-        }
-
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
-            std::pair<std::string, std::string>(
-                "useAtmosphere",
-                std::to_string(chunk.owner()->atmosphereEnabled)));
-
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
-            std::pair<std::string, std::string>(
-                "showChunkEdges",
-                std::to_string(chunk.owner()->debugOptions.showChunkEdges)));
-
-
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
-            std::pair<std::string, std::string>(
-                "showHeightResolution",
-                std::to_string(chunk.owner()->debugOptions.showHeightResolution)));
-
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
-            std::pair<std::string, std::string>(
-                "showHeightIntensities",
-                std::to_string(chunk.owner()->debugOptions.showHeightIntensities)));
-
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
-            std::pair<std::string, std::string>(
-                "defaultHeight",
-                std::to_string(Chunk::DEFAULT_HEIGHT)));
-        
-
-
+        // The tile providers and the preprocessing data are the same for all chunks and
+        // have been collected in updatePreprocessingData for this frame
+        const auto& tileProviders = _tileProviders;
 
         // Now the shader program can be accessed
         ProgramObject* programObject =
-            layeredTextureShaderProvider->getUpdatedShaderProgram(
-                layeredTexturePreprocessingData);
+            layeredTextureShaderProvider->getUpdatedShaderProgram(_preprocessingData);
 
         programUniformHandler->updateIdsIfNecessary(layeredTextureShaderProvider);
 
@@ -223,15 +228,14 @@ namespace openspace {
         };
         std::array<std::vector<BlendTexUnits>, LayeredTextures::NUM_TEXTURE_CATEGORIES> texUnits;
         for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
-            texUnits[category].resize(tileProviders[category].size());
+            texUnits[category].resize(tileProviders[category]->size());
         }
 
         // Go through all the categories
         for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
             // Go through all the providers in this category
             int i = 0;
-            for (auto it = tileProviders[category].begin(); it != tileProviders[category].end(); it++) {
-                auto tileProvider = it->get();
+            for (TileProvider* tileProvider : *tileProviders[category]) {
 
                 // Get the texture that should be used for rendering
                 TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(tileProvider, chunkIndex);
@@ -250,7 +254,7 @@ namespace openspace {
                     tileAndTransform);
 
                 // If blending is enabled, two more textures are needed
-                if (layeredTexturePreprocessingData.layeredTextureInfo[category].layerBlendingEnabled) {
+                if (_preprocessingData.layeredTextureInfo[category].layerBlendingEnabled) {
                     TileAndTransform tileAndTransformParent1 = TileSelector::getHighestResolutionTile(tileProvider, chunkIndex, 1);
                     if (tileAndTransformParent1.tile.status == Tile::Status::Unavailable) {
                         tileAndTransformParent1 = tileAndTransform;
@@ -291,10 +295,7 @@ namespace openspace {
 
         // Go through all the height maps and set depth tranforms
         int i = 0;
-        auto it = tileProviders[LayeredTextures::HeightMaps].begin();
-        auto end = tileProviders[LayeredTextures::HeightMaps].end();
-        for (; it != end; it++) {
-            auto tileProvider = *it;
+        for (TileProvider* tileProvider : *tileProviders[LayeredTextures::HeightMaps]) {
 
             TileDepthTransform depthTransform = tileProvider->depthTransform();
             setDepthTransformUniforms(
@@ -333,7 +334,7 @@ namespace openspace {
         
         for (int i = 0; i < LayeredTextures::NUM_TEXTURE_CATEGORIES; ++i) {
             LayeredTextures::TextureCategory category = (LayeredTextures::TextureCategory)i;
-            if(_tileProviderManager->getTileProviderGroup(i).levelBlendingEnabled && _tileProviderManager->getTileProviderGroup(category).getActiveTileProviders().size() > 0){
+            if(_tileProviderManager->getTileProviderGroup(i).levelBlendingEnabled && !_tileProviders[category]->empty()){
                 performAnyBlending = true; 
                 break;
             }
@@ -365,10 +366,8 @@ namespace openspace {
         programObject->setUniform("lonLatScalingFactor", vec2(patchSize.toLonLatVec2()));
         programObject->setUniform("radiiSquared", vec3(ellipsoid.radiiSquared()));
 
-        if (_tileProviderManager->getTileProviderGroup(
-                LayeredTextures::NightTextures).getActiveTileProviders().size() > 0 ||
-            _tileProviderManager->getTileProviderGroup(
-                LayeredTextures::WaterMasks).getActiveTileProviders().size() > 0) {
+        if (!_tileProviders[LayeredTextures::NightTextures]->empty() ||
+            !_tileProviders[LayeredTextures::WaterMasks]->empty()) {
             glm::vec3 directionToSunWorldSpace =
                 glm::normalize(-data.modelTransform.translation);
             glm::vec3 directionToSunCameraSpace =
@@ -410,7 +409,7 @@ namespace openspace {
         bool performAnyBlending = false;
         for (int i = 0; i < LayeredTextures::NUM_TEXTURE_CATEGORIES; ++i) {
             LayeredTextures::TextureCategory category = (LayeredTextures::TextureCategory)i;
-            if (_tileProviderManager->getTileProviderGroup(i).levelBlendingEnabled && _tileProviderManager->getTileProviderGroup(category).getActiveTileProviders().size() > 0) {
+            if (_tileProviderManager->getTileProviderGroup(i).levelBlendingEnabled && !_tileProviders[category]->empty()) {
                 performAnyBlending = true;
                 break;
             }
@@ -427,11 +426,18 @@ namespace openspace {
         dmat4 modelViewTransform = viewTransform * modelTransform;
 
         std::vector<std::string> cornerNames = { "p01", "p11", "p00", "p10" };
+        Scalar lat[4], lon[4];
+        for (int i = 0; i < 4; ++i) {
+            Geodetic2 corner = chunk.surfacePatch().getCorner((Quad)i);
+            lat[i] = corner.lat;
+            lon[i] = corner.lon;
+        }
+        Scalar x[4], y[4], z[4];
+        ellipsoid.cartesianSurfacePosition(4, lat, lon, x, y, z);
+
         std::vector<Vec3> cornersCameraSpace(4);
         for (int i = 0; i < 4; ++i) {
-            Quad q = (Quad)i;
-            Geodetic2 corner = chunk.surfacePatch().getCorner(q);
-            Vec3 cornerModelSpace = ellipsoid.cartesianSurfacePosition(corner);
+            Vec3 cornerModelSpace(x[i], y[i], z[i]);
             Vec3 cornerCameraSpace = Vec3(dmat4(modelViewTransform) * glm::dvec4(cornerModelSpace, 1));
             cornersCameraSpace[i] = cornerCameraSpace;
             programObject->setUniform(cornerNames[i], vec3(cornerCameraSpace));
@@ -444,10 +450,8 @@ namespace openspace {
         programObject->setUniform("patchNormalCameraSpace", patchNormalCameraSpace);
         programObject->setUniform("projectionTransform", data.camera.projectionMatrix());
 
-        if (_tileProviderManager->getTileProviderGroup(
-                LayeredTextures::NightTextures).getActiveTileProviders().size() > 0 ||
-            _tileProviderManager->getTileProviderGroup(
-                LayeredTextures::WaterMasks).getActiveTileProviders().size() > 0) {
+        if (!_tileProviders[LayeredTextures::NightTextures]->empty() ||
+            !_tileProviders[LayeredTextures::WaterMasks]->empty()) {
             glm::vec3 directionToSunWorldSpace =
                 glm::normalize(-data.modelTransform.translation);
             glm::vec3 directionToSunCameraSpace =
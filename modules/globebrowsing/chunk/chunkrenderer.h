@@ -51,6 +51,8 @@ namespace opengl {
 }
 
 namespace openspace {
+
+    class ChunkedLodGlobe;
     
     class ChunkRenderer {
     public:
@@ -60,6 +62,13 @@ namespace openspace {
         void renderChunk(const Chunk& chunk, const RenderData& data);
         void update();
 
+        /**
+        * Collects the active tile providers and the shader preprocessing data that are
+        * shared by all chunks of the <code>globe</code>. Has to be called once per frame
+        * before the chunks are rendered.
+        */
+        void updatePreprocessingData(const ChunkedLodGlobe& globe);
+
     private:
 
         void renderChunkGlobally(const Chunk& chunk, const RenderData& data);
@@ -98,6 +107,12 @@ namespace openspace {
         std::shared_ptr<LayeredTextureShaderUniformIdHandler> _globalProgramUniformHandler;
         std::shared_ptr<LayeredTextureShaderUniformIdHandler> _localProgramUniformHandler;
 
+        // The active tile providers of each category, owned by the TileProviderManager
+        std::array<const std::vector<TileProvider*>*,
+            LayeredTextures::NUM_TEXTURE_CATEGORIES> _tileProviders;
+        LayeredTexturePreprocessingData _preprocessingData;
+        bool _hasPrecompiledShaderPrograms;
+
     };
 
 }  // namespace openspace
@@ -37,12 +37,112 @@
 
 #include <modules/debugging/rendering/debugrenderer.h>
 
+#include <algorithm>
+
 namespace {
     const std::string _loggerCat = "FrustrumCuller";
+
+    // The horizon culler processes the chunks in blocks of this size, which lets the
+    // surface positions of the closest points be computed by a single batched call
+    const size_t HorizonBlockSize = 64;
 }
 
 namespace openspace {
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    //                            CULLING CONTEXT                                       //
+    //////////////////////////////////////////////////////////////////////////////////////
+    CullingContext::CullingContext()
+        : ellipsoid(nullptr)
+        , modelViewProjectionTransform(1.0)
+        , cameraPosition(0.0)
+        , minimumGlobeRadius(0.0)
+        , distanceToHorizon(0.0)
+    {}
+
+    void CullingContext::update(const glm::dmat4& viewProjectionTransform,
+        const Vec3& cameraWorldPosition, const glm::dmat4& modelTransform,
+        const glm::dmat4& inverseModelTransform, const Ellipsoid& globeEllipsoid)
+    {
+        ellipsoid = &globeEllipsoid;
+        modelViewProjectionTransform = viewProjectionTransform * modelTransform;
+
+        // Calculations are done in the reference frame of the globe. Hence, the camera
+        // position needs to be transformed with the inverse model matrix
+        cameraPosition =
+            glm::dvec3(inverseModelTransform * glm::dvec4(cameraWorldPosition, 1));
+        cameraGeodetic = globeEllipsoid.cartesianToGeodetic2(cameraPosition);
+
+        minimumGlobeRadius = globeEllipsoid.minimumRadius();
+        // The globe is at the origin of its model space
+        distanceToHorizon =
+            sqrt(pow(length(cameraPosition), 2) - pow(minimumGlobeRadius, 2));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //                            CHUNK BOUNDS                                          //
+    //////////////////////////////////////////////////////////////////////////////////////
+    ChunkBounds::ChunkBounds(const GeodeticPatch& patch, const Ellipsoid& ellipsoid,
+        float minHeight, float maxHeight)
+        : patch(patch)
+        , maxHeight(maxHeight)
+    {
+        // assume worst case
+        double patchCenterRadius = ellipsoid.maximumRadius();
+
+        double maxCenterRadius = patchCenterRadius + maxHeight;
+        Geodetic2 halfSize = patch.halfSize();
+
+        // As the patch is curved, the maximum height offsets at the corners must be long 
+        // enough to cover large enough to cover a boundingHeight.max at the center of the 
+        // patch.
+        // Approximating scaleToCoverCenter by assuming the latitude and longitude angles
+        // of "halfSize" are equal to the angles they create from the center of the
+        // globe to the patch corners. This is true for the longitude direction when
+        // the ellipsoid can be approximated as a sphere and for the latitude for patches
+        // close to the equator. Close to the pole this will lead to a bigger than needed
+        // value for scaleToCoverCenter. However, this is a simple calculation and a good
+        // Approximation.
+        double y1 = tan(halfSize.lat);
+        double y2 = tan(halfSize.lon);
+        double scaleToCoverCenter = sqrt(1 + pow(y1, 2) + pow(y2, 2));
+        
+        double maxCornerHeight = maxCenterRadius * scaleToCoverCenter - patchCenterRadius;
+
+        bool chunkIsNorthOfEquator = patch.isNorthern();
+
+        // The minimum height offset, however, we can simply 
+        double minCornerHeight = minHeight;
+        
+        Scalar latCloseToEquator = patch.edgeLatitudeNearestEquator();
+        Geodetic3 p1Geodetic = { { latCloseToEquator, patch.minLon() }, maxCornerHeight };
+        Geodetic3 p2Geodetic = { { latCloseToEquator, patch.maxLon() }, maxCornerHeight };
+        
+        glm::vec3 p1 = ellipsoid.cartesianPosition(p1Geodetic);
+        glm::vec3 p2 = ellipsoid.cartesianPosition(p2Geodetic);
+        glm::vec3 p = 0.5f * (p1 + p2);
+        Geodetic2 pGeodetic = ellipsoid.cartesianToGeodetic2(p);
+        Scalar latDiff = latCloseToEquator - pGeodetic.lat;
+
+        Scalar lat[8], lon[8], height[8];
+        for (size_t i = 0; i < 8; i++) {
+            Quad q = (Quad)(i % 4);
+            Geodetic2 corner = patch.getCorner(q);
+            
+            bool cornerIsNorthern = !((i / 2) % 2);
+            bool cornerCloseToEquator = chunkIsNorthOfEquator ^ cornerIsNorthern;
+            lat[i] = cornerCloseToEquator ? corner.lat + latDiff : corner.lat;
+            lon[i] = corner.lon;
+            height[i] = i < 4 ? minCornerHeight : maxCornerHeight;
+        }
+
+        Scalar x[8], y[8], z[8];
+        ellipsoid.cartesianPosition(8, lat, lon, height, x, y, z);
+        for (size_t i = 0; i < 8; i++) {
+            corners[i] = dvec4(x[i], y[i], z[i], 1);
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////
     //                            FRUSTUM CULLER                                            //
     //////////////////////////////////////////////////////////////////////////////////////
@@ -55,28 +155,32 @@ namespace openspace {
 
     }
 
-    bool FrustumCuller::isCullable(const Chunk& chunk, const RenderData& data) {
-        // Calculate the MVP matrix
-        dmat4 modelTransform = chunk.owner()->modelTransform();
-        dmat4 viewTransform = dmat4(data.camera.combinedViewMatrix());
-        dmat4 modelViewProjectionTransform = dmat4(data.camera.projectionMatrix())
-            * viewTransform * modelTransform;
-
-        const std::vector<glm::dvec4>& corners = chunk.getBoundingPolyhedronCorners();
-        
+    bool FrustumCuller::isCullable(const ChunkBounds& bounds,
+                                   const CullingContext& context) const
+    {
+        const dmat4& modelViewProjectionTransform = context.modelViewProjectionTransform;
 
         // Create a bounding box that fits the patch corners
-        AABB3 bounds; // in screen space
-        std::vector<vec4> clippingSpaceCorners(8);
+        AABB3 screenSpaceBounds;
         for (size_t i = 0; i < 8; i++) {
-            dvec4 cornerClippingSpace = modelViewProjectionTransform * corners[i];
-            clippingSpaceCorners[i] = cornerClippingSpace;
-
-            dvec3 cornerScreenSpace = (1.0f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace;
-            bounds.expand(cornerScreenSpace);
+            dvec4 cornerClippingSpace = modelViewProjectionTransform * bounds.corners[i];
+            dvec3 cornerScreenSpace =
+                (1.0f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace;
+            screenSpaceBounds.expand(cornerScreenSpace);
         }
         
-        return !_viewFrustum.intersects(bounds);
+        return !_viewFrustum.intersects(screenSpaceBounds);
+    }
+
+    void FrustumCuller::cull(const std::vector<ChunkBounds>& bounds,
+        const CullingContext& context, std::vector<bool>& cullable) const
+    {
+        ghoul_assert(bounds.size() == cullable.size(), "Sizes must match");
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            if (!cullable[i]) {
+                cullable[i] = FrustumCuller::isCullable(bounds[i], context);
+            }
+        }
     }
 
 
@@ -91,31 +195,39 @@ namespace openspace {
 
     }
 
-    bool HorizonCuller::isCullable(const Chunk& chunk, const RenderData& data) {
-        //return !isVisible(data, chunk.surfacePatch(), chunk.owner()->ellipsoid(), chunk.owner()->chunkHeight);
-        
-        // Calculations are done in the reference frame of the globe. Hence, the camera
-        // position needs to be transformed with the inverse model matrix
-        glm::dmat4 inverseModelTransform = chunk.owner()->inverseModelTransform();
-
-        const Ellipsoid& ellipsoid = chunk.owner()->ellipsoid();
-        const GeodeticPatch& patch = chunk.surfacePatch();
-        float maxHeight = chunk.getBoundingHeights().max;
-        Vec3 globePosition = glm::dvec3(0,0,0); // In model space it is 0
-        Scalar minimumGlobeRadius = ellipsoid.minimumRadius();
-
-        Vec3 cameraPosition = 
-            glm::dvec3(inverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1));
-
-        Vec3 globeToCamera = cameraPosition;
+    bool HorizonCuller::isCullable(const ChunkBounds& bounds,
+                                   const CullingContext& context) const
+    {
+        Geodetic2 closestPatchPoint = bounds.patch.closestPoint(context.cameraGeodetic);
+        Vec3 objectPosition =
+            context.ellipsoid->cartesianSurfacePosition(closestPatchPoint);
+        return isBehindHorizon(objectPosition, bounds.maxHeight, context);
+    }
 
-        Geodetic2 cameraPositionOnGlobe =
-            ellipsoid.cartesianToGeodetic2(globeToCamera);
-        Geodetic2 closestPatchPoint = patch.closestPoint(cameraPositionOnGlobe);
-        const Vec3& objectPosition = ellipsoid.cartesianSurfacePosition(closestPatchPoint);
+    void HorizonCuller::cull(const std::vector<ChunkBounds>& bounds,
+        const CullingContext& context, std::vector<bool>& cullable) const
+    {
+        ghoul_assert(bounds.size() == cullable.size(), "Sizes must match");
+        Scalar lat[HorizonBlockSize], lon[HorizonBlockSize];
+        Scalar x[HorizonBlockSize], y[HorizonBlockSize], z[HorizonBlockSize];
+        for (size_t begin = 0; begin < bounds.size(); begin += HorizonBlockSize) {
+            const size_t size = std::min(HorizonBlockSize, bounds.size() - begin);
+            for (size_t i = 0; i < size; ++i) {
+                Geodetic2 closestPatchPoint =
+                    bounds[begin + i].patch.closestPoint(context.cameraGeodetic);
+                lat[i] = closestPatchPoint.lat;
+                lon[i] = closestPatchPoint.lon;
+            }
+            context.ellipsoid->cartesianSurfacePosition(size, lat, lon, x, y, z);
 
-        return isCullable(cameraPosition, globePosition, objectPosition,
-            maxHeight, minimumGlobeRadius);
+            for (size_t i = 0; i < size; ++i) {
+                if (!cullable[begin + i]) {
+                    cullable[begin + i] = isBehindHorizon(
+                        Vec3(x[i], y[i], z[i]), bounds[begin + i].maxHeight, context
+                    );
+                }
+            }
+        }
     }
 
     bool HorizonCuller::isCullable(
@@ -123,7 +235,7 @@ namespace openspace {
         const Vec3& globePosition,
         const Vec3& objectPosition,
         Scalar objectBoundingSphereRadius,
-        Scalar minimumGlobeRadius)
+        Scalar minimumGlobeRadius) const
     {
         Scalar distanceToHorizon =
             sqrt(pow(length(cameraPosition - globePosition), 2) - pow(minimumGlobeRadius, 2));
@@ -138,4 +250,21 @@ namespace openspace {
         return distanceToObjectSquared > minimumAllowedDistanceToObjectSquared;
     }
 
+    bool HorizonCuller::isBehindHorizon(const Vec3& objectPosition,
+        Scalar objectBoundingSphereRadius, const CullingContext& context) const
+    {
+        // Same as the test above with the globe at the origin and the distance to the
+        // horizon taken from the context
+        Scalar minimumAllowedDistanceToObjectFromHorizon = sqrt(
+            pow(length(objectPosition), 2) -
+            pow(context.minimumGlobeRadius - objectBoundingSphereRadius, 2));
+        // Minimum allowed for the object to be occluded
+        Scalar minimumAllowedDistanceToObjectSquared =
+            pow(context.distanceToHorizon + minimumAllowedDistanceToObjectFromHorizon, 2)
+            + pow(objectBoundingSphereRadius, 2);
+        Scalar distanceToObjectSquared =
+            pow(length(objectPosition - context.cameraPosition), 2);
+        return distanceToObjectSquared > minimumAllowedDistanceToObjectSquared;
+    }
+
 }  // namespace openspace
@@ -25,7 +25,9 @@
 #ifndef __CULLING_H__
 #define __CULLING_H__
 
+#include <array>
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 
 // open space includes
@@ -45,10 +47,68 @@ namespace openspace {
     class Chunk;
 
 
+    /**
+     * The values of the culling tests that only depend on the camera and the globe. They
+     * are computed once per frame by #update instead of once for every chunk.
+     */
+    struct CullingContext {
+        CullingContext();
+
+        /**
+         * Recomputes the context for a camera and a globe.
+         * \param viewProjectionTransform the combined view projection matrix of the
+         * camera
+         * \param cameraPosition the position of the camera in world space
+         * \param modelTransform the transform from the model space of the globe to world
+         * space
+         * \param inverseModelTransform the inverse of \p modelTransform
+         * \param ellipsoid the ellipsoid of the globe, which has to outlive the context
+         */
+        void update(const glm::dmat4& viewProjectionTransform,
+            const Vec3& cameraPosition, const glm::dmat4& modelTransform,
+            const glm::dmat4& inverseModelTransform, const Ellipsoid& ellipsoid);
+
+        const Ellipsoid* ellipsoid;
+        glm::dmat4 modelViewProjectionTransform;
+        /// The camera position in the model space of the globe
+        Vec3 cameraPosition;
+        Geodetic2 cameraGeodetic;
+        Scalar minimumGlobeRadius;
+        Scalar distanceToHorizon;
+    };
+
+
+    /**
+     * The bounding volume of a chunk that the culling tests work on. It is computed once
+     * per chunk and shared by all cullers.
+     */
+    struct ChunkBounds {
+        ChunkBounds(const GeodeticPatch& patch, const Ellipsoid& ellipsoid,
+            float minHeight, float maxHeight);
+
+        GeodeticPatch patch;
+        float maxHeight;
+        /// The corners of the bounding polyhedron in model space
+        std::array<glm::dvec4, 8> corners;
+    };
+
+
     class ChunkCuller {
     public:
         virtual void update() { }
-        virtual bool isCullable(const Chunk& chunk, const RenderData& renderData) = 0;
+
+        virtual bool isCullable(const ChunkBounds& bounds,
+            const CullingContext& context) const = 0;
+
+        /**
+         * Tests all chunks in \p bounds at once, for example a whole level of the chunk
+         * tree. The entries in \p cullable of chunks that can be culled are set to
+         * <code>true</code>. Other entries are left unchanged, which means that several
+         * cullers can be applied to the same list and that culled chunks are not tested
+         * again.
+         */
+        virtual void cull(const std::vector<ChunkBounds>& bounds,
+            const CullingContext& context, std::vector<bool>& cullable) const = 0;
     };
 
 
@@ -58,7 +118,11 @@ namespace openspace {
         FrustumCuller(const AABB3 viewFrustum);
         ~FrustumCuller();
 
-        virtual bool isCullable(const Chunk& chunk, const RenderData& renderData);
+        bool isCullable(const ChunkBounds& bounds,
+            const CullingContext& context) const override;
+
+        void cull(const std::vector<ChunkBounds>& bounds, const CullingContext& context,
+            std::vector<bool>& cullable) const override;
 
     private:
         const AABB3 _viewFrustum;
@@ -77,12 +141,20 @@ namespace openspace {
         HorizonCuller();
         ~HorizonCuller();
 
-        virtual bool isCullable(const Chunk& chunk, const RenderData& renderData);
+        bool isCullable(const ChunkBounds& bounds,
+            const CullingContext& context) const override;
+
+        void cull(const std::vector<ChunkBounds>& bounds, const CullingContext& context,
+            std::vector<bool>& cullable) const override;
 
         bool isCullable(const Vec3& cameraPosition, const Vec3& globePosition,
             const Vec3& objectPosition, Scalar objectBoundingSphereRadius,
-            Scalar minimumGlobeRadius);
+            Scalar minimumGlobeRadius) const;
 
+    private:
+        /// The horizon test for an object whose closest point to the camera is known
+        bool isBehindHorizon(const Vec3& objectPosition,
+            Scalar objectBoundingSphereRadius, const CullingContext& context) const;
     };
 
 
@@ -27,9 +27,115 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <algorithm>
+#include <limits>
 
 namespace {
     const std::string _loggerCat = "Ellipsoid";
+
+    // Number of points whose intermediate results are kept on the stack at a time
+    const size_t BlockSize = 64;
+    // Every pass runs a fixed number of iterations for all points of a block, which is
+    // enough for planetary ellipsoids to converge in a single pass
+    const int ProjectionIterationsPerPass = 3;
+    const int ProjectionMaxIterations = 30;
+    const Scalar ProjectionEpsilon = 1e-10;
+
+    // The polynomial approximations below are taken from the Cephes math library. They
+    // are written without branches so that they can be inlined into vectorized loops
+
+    // Computes the sine and cosine of x with an error of a few ulp for |x| < 1e8
+    inline void polynomialSinCos(Scalar x, Scalar& sine, Scalar& cosine) {
+        Scalar absX = std::abs(x);
+        // Octant of absX, rounded up to an even number so that z is in [-pi/4, pi/4]
+        int octant = static_cast<int>(absX * 1.27323954473516268615);
+        octant += octant & 1;
+        Scalar y = static_cast<Scalar>(octant);
+        // Extended precision modular arithmetic, z = absX - y * pi/4
+        Scalar z = ((absX - y * 7.85398125648498535156e-1) -
+            y * 3.77489470793079817668e-8) - y * 2.69515142907905952645e-15;
+        Scalar zz = z * z;
+
+        Scalar s = 1.58962301576546568060e-10;
+        s = s * zz - 2.50507477628578072866e-8;
+        s = s * zz + 2.75573136213857245213e-6;
+        s = s * zz - 1.98412698295895385996e-4;
+        s = s * zz + 8.33333333332211858878e-3;
+        s = s * zz - 1.66666666666666307295e-1;
+        s = z + z * zz * s;
+
+        Scalar c = -1.13585365213876817300e-11;
+        c = c * zz + 2.08757008419747316778e-9;
+        c = c * zz - 2.75573141792967388112e-7;
+        c = c * zz + 2.48015872888517045348e-5;
+        c = c * zz - 1.38888888888730564116e-3;
+        c = c * zz + 4.16666666666665929218e-2;
+        c = 1.0 - 0.5 * zz + zz * zz * c;
+
+        octant &= 7;
+        bool swap = (octant == 2) || (octant == 6);
+        bool negateSine = (octant >= 4) != (x < 0.0);
+        bool negateCosine = (octant == 2) || (octant == 4);
+        sine = swap ? c : s;
+        sine = negateSine ? -sine : sine;
+        cosine = swap ? s : c;
+        cosine = negateCosine ? -cosine : cosine;
+    }
+
+    // Computes the position on the surface of an ellipsoid with the squared radii
+    // radiiSquared and its geodetic surface normal
+    inline void surfacePosition(const Vec3& radiiSquared, Scalar lat, Scalar lon,
+        Scalar& x, Scalar& y, Scalar& z, Scalar& nx, Scalar& ny, Scalar& nz)
+    {
+        Scalar sinLat, cosLat, sinLon, cosLon;
+        polynomialSinCos(lat, sinLat, cosLat);
+        polynomialSinCos(lon, sinLon, cosLon);
+        nx = cosLat * cosLon;
+        ny = cosLat * sinLon;
+        nz = sinLat;
+
+        Scalar kx = radiiSquared.x * nx;
+        Scalar ky = radiiSquared.y * ny;
+        Scalar kz = radiiSquared.z * nz;
+        Scalar oneOverGamma = 1.0 / sqrt(kx * nx + ky * ny + kz * nz);
+        x = kx * oneOverGamma;
+        y = ky * oneOverGamma;
+        z = kz * oneOverGamma;
+    }
+
+    // Computes atan2(y, x) with an error of a few ulp
+    inline Scalar polynomialAtan2(Scalar y, Scalar x) {
+        Scalar absY = std::abs(y);
+        Scalar absX = std::abs(x);
+        // Reduce the argument to t = tan(a) in [0, 1] ...
+        bool swap = absY > absX;
+        Scalar numerator = swap ? absX : absY;
+        Scalar denominator = swap ? absY : absX;
+        // The divisions are unconditional as divisions in branches prevent vectorization
+        const Scalar tiny = std::numeric_limits<Scalar>::min();
+        Scalar t = numerator / (denominator > tiny ? denominator : tiny);
+        // ... and further to [-0.2, 0.66] using atan(t) = pi/4 + atan((t-1) / (t+1))
+        bool reduce = t > 0.66;
+        Scalar reduced = (t - 1.0) / (t + 1.0);
+        Scalar r = reduce ? reduced : t;
+        Scalar rr = r * r;
+
+        Scalar p = -8.750608600031904122785e-1;
+        p = p * rr - 1.615753718733365076637e1;
+        p = p * rr - 7.500855792314704667340e1;
+        p = p * rr - 1.228866684490136173410e2;
+        p = p * rr - 6.485021904942025371773e1;
+        Scalar q = rr + 2.485846490142306297962e1;
+        q = q * rr + 1.650270098316988542046e2;
+        q = q * rr + 4.328810604912902668951e2;
+        q = q * rr + 4.853903996359136964868e2;
+        q = q * rr + 1.945506571482613964425e2;
+        Scalar a = r + r * rr * p / q;
+
+        a = reduce ? a + (M_PI_4 + 3.061616997868382943065e-17) : a;
+        a = swap ? M_PI_2 - a : a;
+        a = x < 0.0 ? M_PI - a : a;
+        return y < 0.0 ? -a : a;
+    }
 }
 
 namespace openspace {
@@ -75,30 +181,9 @@ namespace openspace {
     }
 
     Vec3 Ellipsoid::geodeticSurfaceProjection(const Vec3& p) const {
-        Scalar beta = 1.0 / sqrt(dot(p * p, _cached._oneOverRadiiSquared));
-        Scalar n = glm::length(beta * p * _cached._oneOverRadiiSquared);
-        Scalar alpha = (1.0 - beta) * (glm::length(p) / n);
-        
-        Vec3 p2 = p * p;
-        Vec3 d, d2, d3;
-
-        Scalar s = 0.0;
-        Scalar dSdA = 1.0;
-
-        Scalar epsilon = 1e-10;
-        do {
-            alpha -= (s / dSdA);
-
-            d = Vec3(1.0) + alpha * _cached._oneOverRadiiSquared;
-            d2 = d * d;
-            d3 = d * d2;
-            
-            s = glm::dot(p2 / (_cached._radiiSquared * d2), Vec3(1.0)) - 1.0;
-
-            dSdA = -2.0 * glm::dot(p2 / (_cached._radiiToTheFourth * d3), Vec3(1.0));
-        }
-        while (abs(s) > epsilon);
-        return p / d;
+        Vec3 result;
+        geodeticSurfaceProjection(1, &p.x, &p.y, &p.z, &result.x, &result.y, &result.z);
+        return result;
     }
 
     Vec3 Ellipsoid::geodeticSurfaceNormalForGeocentricallyProjectedPoint(const Vec3& p) const {
@@ -107,12 +192,11 @@ namespace openspace {
     }
 
     Vec3 Ellipsoid::geodeticSurfaceNormal(Geodetic2 geodetic2) const {
-        Scalar cosLat = glm::cos(geodetic2.lat);
-        //geodetic2.lon = geodetic2.lon > M_PI ? geodetic2.lon - M_PI * 2 : geodetic2.lon;
-        return Vec3(
-            cosLat * cos(geodetic2.lon),
-            cosLat * sin(geodetic2.lon), 
-            sin(geodetic2.lat));
+        Vec3 result;
+        geodeticSurfaceNormal(
+            1, &geodetic2.lat, &geodetic2.lon, &result.x, &result.y, &result.z
+        );
+        return result;
     }
 
     const Vec3& Ellipsoid::radii() const {
@@ -167,25 +251,166 @@ namespace openspace {
 
     Geodetic2 Ellipsoid::cartesianToGeodetic2(const Vec3& p) const
     {
-        Vec3 normal = geodeticSurfaceNormalForGeocentricallyProjectedPoint(p);
-        return Geodetic2(
-            asin(normal.z / length(normal)),    // Latitude
-            atan2(normal.y, normal.x));            // Longitude
+        Geodetic2 result;
+        cartesianToGeodetic2(1, &p.x, &p.y, &p.z, &result.lat, &result.lon);
+        return result;
     }
 
     Vec3 Ellipsoid::cartesianSurfacePosition(const Geodetic2& geodetic2) const
     {
-        // Position on surface : height = 0
-        return cartesianPosition(Geodetic3({ geodetic2, 0 }));
+        Vec3 result;
+        cartesianPosition(
+            1, &geodetic2.lat, &geodetic2.lon, nullptr, &result.x, &result.y, &result.z
+        );
+        return result;
     }
 
     Vec3 Ellipsoid::cartesianPosition(const Geodetic3& geodetic3) const
     {
-        Vec3 normal = geodeticSurfaceNormal(geodetic3.geodetic2);
-        Vec3 k = _cached._radiiSquared * normal;
-        Scalar gamma = sqrt(dot(k, normal));
-        Vec3 rSurface = k / gamma;
-        return rSurface + geodetic3.height * normal;
+        const Geodetic2& geodetic2 = geodetic3.geodetic2;
+        Vec3 result;
+        cartesianPosition(1, &geodetic2.lat, &geodetic2.lon, &geodetic3.height,
+            &result.x, &result.y, &result.z);
+        return result;
+    }
+
+    void Ellipsoid::geodeticSurfaceProjection(size_t n, const Scalar* x, const Scalar* y,
+        const Scalar* z, Scalar* resultX, Scalar* resultY, Scalar* resultZ) const
+    {
+        const Vec3& oneOverRadiiSquared = _cached._oneOverRadiiSquared;
+        const Scalar ox = oneOverRadiiSquared.x;
+        const Scalar oy = oneOverRadiiSquared.y;
+        const Scalar oz = oneOverRadiiSquared.z;
+
+        Scalar alpha[BlockSize];
+        for (size_t begin = 0; begin < n; begin += BlockSize) {
+            const size_t size = std::min(BlockSize, n - begin);
+            const Scalar* px = x + begin;
+            const Scalar* py = y + begin;
+            const Scalar* pz = z + begin;
+
+            // Initial guess from the geocentric projection
+            for (size_t i = 0; i < size; ++i) {
+                Scalar x2 = px[i] * px[i];
+                Scalar y2 = py[i] * py[i];
+                Scalar z2 = pz[i] * pz[i];
+                Scalar beta = 1.0 / sqrt(x2 * ox + y2 * oy + z2 * oz);
+                Scalar nx = beta * px[i] * ox;
+                Scalar ny = beta * py[i] * oy;
+                Scalar nz = beta * pz[i] * oz;
+                Scalar length = sqrt(nx * nx + ny * ny + nz * nz);
+                alpha[i] = (1.0 - beta) * (sqrt(x2 + y2 + z2) / length);
+            }
+
+            // Newton-Raphson iterations on alpha, the scaling along the normal. Only the
+            // block as a whole decides whether another pass is needed
+            // The count is a Scalar as a reduction that mixes types is not vectorized
+            Scalar nUnconverged = 0.0;
+            int iteration = 0;
+            do {
+                for (int k = 0; k < ProjectionIterationsPerPass; ++k) {
+                    nUnconverged = 0.0;
+                    for (size_t i = 0; i < size; ++i) {
+                        Scalar dx = 1.0 + alpha[i] * ox;
+                        Scalar dy = 1.0 + alpha[i] * oy;
+                        Scalar dz = 1.0 + alpha[i] * oz;
+                        Scalar tx = px[i] * px[i] * ox / (dx * dx);
+                        Scalar ty = py[i] * py[i] * oy / (dy * dy);
+                        Scalar tz = pz[i] * pz[i] * oz / (dz * dz);
+                        Scalar s = tx + ty + tz - 1.0;
+                        Scalar dSdA = -2.0 * (tx * ox / dx + ty * oy / dy + tz * oz / dz);
+                        alpha[i] -= s / dSdA;
+                        nUnconverged += std::abs(s) > ProjectionEpsilon ? 1.0 : 0.0;
+                    }
+                }
+                iteration += ProjectionIterationsPerPass;
+            } while (nUnconverged > 0.0 && iteration < ProjectionMaxIterations);
+
+            // One loop per component keeps the number of aliasing checks low enough for
+            // the loops to be vectorized
+            for (size_t i = 0; i < size; ++i) {
+                resultX[begin + i] = px[i] / (1.0 + alpha[i] * ox);
+            }
+            for (size_t i = 0; i < size; ++i) {
+                resultY[begin + i] = py[i] / (1.0 + alpha[i] * oy);
+            }
+            for (size_t i = 0; i < size; ++i) {
+                resultZ[begin + i] = pz[i] / (1.0 + alpha[i] * oz);
+            }
+        }
+    }
+
+    void Ellipsoid::geodeticSurfaceNormal(size_t n, const Scalar* lat, const Scalar* lon,
+        Scalar* resultX, Scalar* resultY, Scalar* resultZ) const
+    {
+        for (size_t i = 0; i < n; ++i) {
+            Scalar sinLat, cosLat, sinLon, cosLon;
+            polynomialSinCos(lat[i], sinLat, cosLat);
+            polynomialSinCos(lon[i], sinLon, cosLon);
+            resultX[i] = cosLat * cosLon;
+            resultY[i] = cosLat * sinLon;
+            resultZ[i] = sinLat;
+        }
+    }
+
+    void Ellipsoid::cartesianToGeodetic2(size_t n, const Scalar* x, const Scalar* y,
+        const Scalar* z, Scalar* resultLat, Scalar* resultLon) const
+    {
+        const Vec3& oneOverRadiiSquared = _cached._oneOverRadiiSquared;
+        for (size_t i = 0; i < n; ++i) {
+            // The geodetic surface normal of the geocentrically projected point does not
+            // need to be normalized as only its direction is used
+            Scalar nx = x[i] * oneOverRadiiSquared.x;
+            Scalar ny = y[i] * oneOverRadiiSquared.y;
+            Scalar nz = z[i] * oneOverRadiiSquared.z;
+            resultLat[i] = polynomialAtan2(nz, sqrt(nx * nx + ny * ny));
+            resultLon[i] = polynomialAtan2(ny, nx);
+        }
+    }
+
+    void Ellipsoid::cartesianSurfacePosition(size_t n, const Scalar* lat,
+        const Scalar* lon, Scalar* resultX, Scalar* resultY, Scalar* resultZ) const
+    {
+        cartesianPosition(n, lat, lon, nullptr, resultX, resultY, resultZ);
+    }
+
+    void Ellipsoid::cartesianPosition(size_t n, const Scalar* lat, const Scalar* lon,
+        const Scalar* height, Scalar* resultX, Scalar* resultY, Scalar* resultZ) const
+    {
+        // A copy, as the results could alias the cache as far as the compiler knows
+        const Vec3 radiiSquared = _cached._radiiSquared;
+        if (!height) {
+            for (size_t i = 0; i < n; ++i) {
+                Scalar x, y, z, nx, ny, nz;
+                surfacePosition(radiiSquared, lat[i], lon[i], x, y, z, nx, ny, nz);
+                resultX[i] = x;
+                resultY[i] = y;
+                resultZ[i] = z;
+            }
+            return;
+        }
+
+        // The normals are kept in blocks and the heights are added in a second loop, as
+        // a single loop reading the height would need too many aliasing checks
+        Scalar normalX[BlockSize];
+        Scalar normalY[BlockSize];
+        Scalar normalZ[BlockSize];
+        for (size_t begin = 0; begin < n; begin += BlockSize) {
+            const size_t size = std::min(BlockSize, n - begin);
+            for (size_t i = 0; i < size; ++i) {
+                Scalar x, y, z;
+                surfacePosition(radiiSquared, lat[begin + i], lon[begin + i], x, y, z,
+                    normalX[i], normalY[i], normalZ[i]);
+                resultX[begin + i] = x;
+                resultY[begin + i] = y;
+                resultZ[begin + i] = z;
+            }
+            for (size_t i = 0; i < size; ++i) {
+                resultX[begin + i] += height[begin + i] * normalX[i];
+                resultY[begin + i] += height[begin + i] * normalY[i];
+                resultZ[begin + i] += height[begin + i] * normalZ[i];
+            }
+        }
     }
 
 } // namespace openspace
@@ -93,6 +93,33 @@ public:
     Vec3 cartesianSurfacePosition(const Geodetic2& geodetic2) const;
     Vec3 cartesianPosition(const Geodetic3& geodetic3) const;
 
+    /**
+    Batched versions of the conversions above. The points are passed as structure of
+    arrays, where each of the input and output arrays holds \p n values. The loops are
+    free of branches and library calls so that the compiler can vectorize them; the
+    trigonometric functions are replaced by polynomial approximations with an error of
+    a few ulp for the angles used in geodetic coordinates. The single point functions
+    above are implemented in terms of these.
+    */
+    void geodeticSurfaceProjection(size_t n, const Scalar* x, const Scalar* y,
+        const Scalar* z, Scalar* resultX, Scalar* resultY, Scalar* resultZ) const;
+
+    void geodeticSurfaceNormal(size_t n, const Scalar* lat, const Scalar* lon,
+        Scalar* resultX, Scalar* resultY, Scalar* resultZ) const;
+
+    void cartesianToGeodetic2(size_t n, const Scalar* x, const Scalar* y,
+        const Scalar* z, Scalar* resultLat, Scalar* resultLon) const;
+
+    void cartesianSurfacePosition(size_t n, const Scalar* lat, const Scalar* lon,
+        Scalar* resultX, Scalar* resultY, Scalar* resultZ) const;
+
+    /**
+    \param height may be <code>nullptr</code>, in which case the positions are placed on
+    the surface
+    */
+    void cartesianPosition(size_t n, const Scalar* lat, const Scalar* lon,
+        const Scalar* height, Scalar* resultX, Scalar* resultY, Scalar* resultZ) const;
+
 private:
     struct EllipsoidCache {
         Vec3 _radiiSquared;
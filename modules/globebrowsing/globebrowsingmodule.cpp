@@ -38,6 +38,7 @@
 #include <modules/globebrowsing/tile/tileprovider/singleimageprovider.h>
 #include <modules/globebrowsing/tile/tileprovider/temporaltileprovider.h>
 #include <modules/globebrowsing/tile/tileprovider/texttileprovider.h>
+#include <modules/globebrowsing/tile/tiledataset.h>
 
 
 namespace openspace {
@@ -46,6 +47,12 @@ namespace openspace {
     : OpenSpaceModule("GlobeBrowsing")
 {}
 
+void GlobeBrowsingModule::internalPrepare() {
+    // Registering the GDAL drivers is only done once, but it is the most expensive part
+    // of opening the first dataset, so we do it while other modules are initialized
+    TileDataset::gdalEnsureInitialized();
+}
+
 void GlobeBrowsingModule::internalInitialize() {
 
     auto fRenderable = FactoryManager::ref().factory<Renderable>();
@@ -34,6 +34,7 @@ public:
     GlobeBrowsingModule();
     
 protected:
+    void internalPrepare() override;
     void internalInitialize() override;
 };
 
@@ -24,7 +24,6 @@
 
 #include <modules/globebrowsing/globes/renderableglobe.h>
 
-#include <ghoul/misc/threadpool.h>
 #include <modules/globebrowsing/tile/tileselector.h>
 
 #include <modules/globebrowsing/chunk/chunkedlodglobe.h>
@@ -32,6 +31,7 @@
 
 // open space includes
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/interaction/sessionrecording.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/scene/scenegraphnode.h>
@@ -69,6 +69,10 @@ namespace openspace {
         , lodScaleFactor(properties::FloatProperty("lodScaleFactor", "lodScaleFactor", 10.0f, 1.0f, 50.0f))
         , debugSelection(ReferencedBoolSelection("Debug", "Debug"))
         , atmosphereEnabled(properties::BoolProperty("Atmosphere", "Atmosphere", false))
+        , _lodHysteresis(properties::FloatProperty("lodHysteresis", "lodHysteresis", 0.2f, 0.0f, 1.0f))
+        , _maxSplitsPerFrame(properties::IntProperty("maxSplitsPerFrame", "maxSplitsPerFrame (-1: no limit)", 64, -1, 4096))
+        , _maxMergesPerFrame(properties::IntProperty("maxMergesPerFrame", "maxMergesPerFrame (-1: no limit)", 256, -1, 4096))
+        , _lodReuseTolerance(properties::FloatProperty("lodReuseTolerance", "lodReuseTolerance", 0.002f, 0.0f, 0.1f))
     {
         setName("RenderableGlobe");
         
@@ -126,15 +130,10 @@ namespace openspace {
             LayeredTextures::TextureCategory category = (LayeredTextures::TextureCategory) i;
             std::string categoryName = LayeredTextures::TEXTURE_CATEGORY_NAMES[i];
             auto selection = std::make_unique<ReferencedBoolSelection>(categoryName, categoryName);
-            
-            auto& categoryProviders = _tileProviderManager->getTileProviderGroup(category);
-            for (auto& provider : categoryProviders.tileProviders) {
-                selection->addOption(provider.name, &provider.isActive);
-            }
-            selection->addOption(" - Blend tile levels - ", &_tileProviderManager->getTileProviderGroup(i).levelBlendingEnabled);
-
             addProperty(selection.get());
             _categorySelections.push_back(std::move(selection));
+            _categoryLayerSetVersions.push_back(0);
+            addCategoryOptions(category);
         }
 
         addProperty(atmosphereEnabled);
@@ -142,6 +141,10 @@ namespace openspace {
         addProperty(_resetTileProviders);
         addProperty(lodScaleFactor);
         addProperty(_cameraMinHeight);
+        addProperty(_lodHysteresis);
+        addProperty(_maxSplitsPerFrame);
+        addProperty(_maxMergesPerFrame);
+        addProperty(_lodReuseTolerance);
     }
 
     RenderableGlobe::~RenderableGlobe() {
@@ -165,6 +168,10 @@ namespace openspace {
         return _distanceSwitch.isReady();
     }
 
+    bool RenderableGlobe::isHeadlessCapable() const {
+        return true;
+    }
+
     void RenderableGlobe::render(const RenderData& data) {
         if (_toggleEnabledEveryFrame.value()) {
             _isEnabled.setValue(!_isEnabled.value());
@@ -175,7 +182,7 @@ namespace openspace {
 
                 if (_chunkedLodGlobe->getSavedCamera() == nullptr) { // save camera
                     LDEBUG("Saving snapshot of camera!");
-                    _chunkedLodGlobe->setSaveCamera(std::make_shared<Camera>(data.camera));
+                    _chunkedLodGlobe->setSaveCamera(std::make_shared<Camera::Snapshot>(data.camera));
                 }
                 else { // throw camera
                     LDEBUG("Throwing away saved camera!");
@@ -193,14 +200,49 @@ namespace openspace {
         _chunkedLodGlobe->lodScaleFactor = lodScaleFactor.value();
         _chunkedLodGlobe->atmosphereEnabled = atmosphereEnabled.value();
 
+        ChunkLevelScheduler::Settings& lodSettings =
+            _chunkedLodGlobe->levelScheduler().settings;
+        lodSettings.hysteresis = _lodHysteresis.value();
+        lodSettings.maxSplitsPerFrame = _maxSplitsPerFrame.value();
+        lodSettings.maxMergesPerFrame = _maxMergesPerFrame.value();
+        lodSettings.reuseTolerance = _lodReuseTolerance.value();
+
         if (_resetTileProviders) {
             _tileProviderManager->reset();
             _resetTileProviders = false;
         }
-        _tileProviderManager->update();
+
+        // Layers that were added, removed or reordered at runtime invalidate the
+        // references of the category's selection
+        for (size_t i = 0; i < _categorySelections.size(); i++) {
+            const TileProviderGroup& group = _tileProviderManager->getTileProviderGroup(i);
+            if (group.layerSetVersion() != _categoryLayerSetVersions[i]) {
+                _categorySelections[i]->clearOptions();
+                addCategoryOptions(i);
+                _categorySelections[i]->readReferences();
+            }
+        }
+
+        {
+            interaction::SessionRecording::StageTimer timer(
+                OsEng.sessionRecording(),
+                "TileIO"
+            );
+            _tileProviderManager->update();
+        }
         _chunkedLodGlobe->update(data);
     }
 
+    void RenderableGlobe::addCategoryOptions(size_t category) {
+        ReferencedBoolSelection& selection = *_categorySelections[category];
+        TileProviderGroup& group = _tileProviderManager->getTileProviderGroup(category);
+        for (NamedTileProvider& provider : group.tileProviders) {
+            selection.addOption(provider.name, &provider.isActive);
+        }
+        selection.addOption(" - Blend tile levels - ", &group.levelBlendingEnabled);
+        _categoryLayerSetVersions[category] = group.layerSetVersion();
+    }
+
     glm::dvec3 RenderableGlobe::projectOnEllipsoid(glm::dvec3 position) {
         return _ellipsoid.geodeticSurfaceProjection(position);
     }
@@ -214,7 +256,7 @@ namespace openspace {
         const auto& heightMapProviders = _tileProviderManager->getTileProviderGroup(LayeredTextures::HeightMaps).getActiveTileProviders();
         if (heightMapProviders.size() == 0)
             return 0;
-        const auto& tileProvider = heightMapProviders[0];
+        TileProvider* tileProvider = heightMapProviders[0];
 
         // Get the uv coordinates to sample from
         Geodetic2 geodeticPosition = _ellipsoid.cartesianToGeodetic2(position);
@@ -227,11 +269,12 @@ namespace openspace {
         glm::vec2 patchUV = glm::vec2(geoDiffPoint.lon / geoDiffPatch.lon, geoDiffPoint.lat / geoDiffPatch.lat);
 
         // Transform the uv coordinates to the current tile texture
-        TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(tileProvider.get(), chunkIdx);
+        TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(tileProvider, chunkIdx);
         const auto& tile = tileAndTransform.tile;
         const auto& uvTransform = tileAndTransform.uvTransform;
         const auto& depthTransform = tileProvider->depthTransform();
-        if (tile.status != Tile::Status::OK) {
+        if (tile.status != Tile::Status::OK || !tile.texture) {
+            // Headless tiles are OK but carry no texture to sample from
             return 0;
         }
         glm::vec2 transformedUv = uvTransform.uvOffset + uvTransform.uvScale * patchUV;
@@ -30,6 +30,7 @@
 // open space includes
 #include <openspace/rendering/renderable.h>
 
+#include <openspace/properties/scalarproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/selectionproperty.h>
@@ -41,7 +42,6 @@
 #include <modules/globebrowsing/geometry/ellipsoid.h>
 
 
-#include <ghoul/misc/threadpool.h>
 #include <modules/globebrowsing/other/distanceswitch.h>
 
 #include <unordered_map>
@@ -69,16 +69,7 @@ struct ReferencedBoolSelection : public properties::SelectionProperty {
     }
 
     void initialize() {
-        // Set values in GUI to the current values of the references
-        int nOptions = options().size();
-        std::vector<int> selected;
-        for (int i = 0; i < nOptions; ++i) {
-            if (*_referenceMap[i]) {
-                selected.push_back(i);
-            }
-        }
-        setValue(selected);
-
+        readReferences();
 
         onChange([this]() {
             int nOptions = this->options().size();
@@ -93,6 +84,24 @@ struct ReferencedBoolSelection : public properties::SelectionProperty {
         });
     }
 
+    // Set values in GUI to the current values of the references
+    void readReferences() {
+        int nOptions = options().size();
+        std::vector<int> selected;
+        for (int i = 0; i < nOptions; ++i) {
+            if (*_referenceMap[i]) {
+                selected.push_back(i);
+            }
+        }
+        setValue(selected);
+    }
+
+    // Removes all options, which is necessary before the references are invalidated
+    void clearOptions() {
+        _referenceMap.clear();
+        removeOptions();
+    }
+
     std::unordered_map<int, bool* const> _referenceMap;
 };
 
@@ -108,6 +117,7 @@ public:
     bool initialize() override;
     bool deinitialize() override;
     bool isReady() const override;
+    bool isHeadlessCapable() const override;
 
     void render(const RenderData& data) override;
     void update(const UpdateData& data) override;
@@ -130,8 +140,15 @@ public:
     properties::BoolProperty _resetTileProviders;
     
 private:
+    // Adds an option for each tile provider in the category and remembers the version
+    // of the layer set that the options reference
+    void addCategoryOptions(size_t category);
+
     double _interactionDepthBelowEllipsoid;
 
+    // The layer set version of each category when its selection was populated
+    std::vector<unsigned int> _categoryLayerSetVersions;
+
     std::string _frame;
     double _time;
 
@@ -143,6 +160,12 @@ private:
     DistanceSwitch _distanceSwitch;
 
     properties::FloatProperty _cameraMinHeight;
+
+    // Settings of the ChunkLevelScheduler of the chunked lod globe
+    properties::FloatProperty _lodHysteresis;
+    properties::IntProperty _maxSplitsPerFrame;
+    properties::IntProperty _maxMergesPerFrame;
+    properties::FloatProperty _lodReuseTolerance;
 };
 
 }  // namespace openspace
@@ -44,9 +44,13 @@ TriangleSoup::TriangleSoup(std::vector<unsigned int> elements,
 }
 
 TriangleSoup::~TriangleSoup() {
-    glDeleteBuffers(1, &_vertexBufferID);
-    glDeleteBuffers(1, &_elementBufferID);
-    glDeleteVertexArrays(1, &_vaoID);
+    // The GPU objects are only created on the first draw, which never happens headless
+    if (_vertexBufferID != 0)
+        glDeleteBuffers(1, &_vertexBufferID);
+    if (_elementBufferID != 0)
+        glDeleteBuffers(1, &_elementBufferID);
+    if (_vaoID != 0)
+        glDeleteVertexArrays(1, &_vaoID);
 }
 
 void TriangleSoup::setVertexPositions(std::vector<glm::vec4> positions) {
@@ -27,13 +27,12 @@
 
 #include <glm/glm.hpp>
 #include <memory>
-#include <ostream>
-#include <thread>
+#include <mutex>
 #include <queue>
 
 #include <modules/globebrowsing/other/concurrentqueue.h>
-#include <modules/globebrowsing/other/threadpool.h>
-//#include <ghoul/misc/threadpool.h>
+
+#include <openspace/util/jobmanager.h>
 
 #include <ghoul/misc/assert.h>
 
@@ -60,56 +59,102 @@ namespace openspace {
 
     /* 
      * Templated Concurrent Job Manager
-     * This class is used execute specific jobs on one (1) parallell thread
+     * This class is used execute specific jobs on the shared JobManager. The jobs of one
+     * ConcurrentJobManager are executed one after the other, never in parallel, as the
+     * data sources used by the jobs (e.g. GDAL datasets) are not thread safe
      */
     template<typename P>
     class ConcurrentJobManager{
     public:
-        ConcurrentJobManager(std::shared_ptr<ThreadPool> pool) : threadPool(pool)
+        ConcurrentJobManager(JobManager& jobManager,
+            JobManager::Priority priority = JobManager::Priority::Normal)
+            : _jobManager(jobManager)
+            , _priority(priority)
+            , _state(std::make_shared<State>())
         {
 
         }
 
         ~ConcurrentJobManager() {
-
+            // Jobs that are still queued in the JobManager are discarded; a job that is
+            // currently executing only touches the shared state
+            _token.cancel();
         }
 
 
         void enqueueJob(std::shared_ptr<Job<P>> job) {
-            //threadPool->queue([this, job]() {
-            //    job->execute();
-            //    _finishedJobs.push(job);
-            //});
-            threadPool->enqueue([this, job]() {
-                job->execute();
-                _finishedJobs.push(job);
-            });
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            _state->pendingJobs.push(job);
+            if (!_state->isRunning) {
+                _state->isRunning = true;
+                scheduleNext(_jobManager, _state, _priority, _token);
+            }
         }
 
         void clearEnqueuedJobs() {
-            //threadPool->clearRemainingTasks();
-            threadPool->clearTasks();
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            _state->pendingJobs = std::queue<std::shared_ptr<Job<P>>>();
         }
 
         std::shared_ptr<Job<P>> popFinishedJob() {
-            ghoul_assert(_finishedJobs.size() > 0, "There is no finished job to pop!");
-            return _finishedJobs.pop();
+            ghoul_assert(_state->finishedJobs.size() > 0, "There is no finished job to pop!");
+            return _state->finishedJobs.pop();
         }
 
         size_t numFinishedJobs() const{
-            return _finishedJobs.size();
+            return _state->finishedJobs.size();
         }
 
         void reset() {
-            //threadPool->clearRemainingTasks();
-            threadPool->clearTasks();
+            clearEnqueuedJobs();
         }
 
     
     private:
+        // The state is shared with the jobs that are enqueued in the JobManager, so
+        // that it outlives the ConcurrentJobManager if it is destroyed while one of its
+        // jobs is executing
+        struct State {
+            std::mutex mutex;
+            std::queue<std::shared_ptr<Job<P>>> pendingJobs;
+            bool isRunning = false;
+            ConcurrentQueue<std::shared_ptr<Job<P>>> finishedJobs;
+        };
+
+        // Enqueues a task that executes the oldest pending job and then schedules the
+        // next one, so that at most one job per ConcurrentJobManager is in flight
+        static void scheduleNext(JobManager& jobManager, std::shared_ptr<State> state,
+            JobManager::Priority priority, JobManager::CancellationToken token)
+        {
+            jobManager.enqueue([&jobManager, state, priority, token]() {
+                std::shared_ptr<Job<P>> job;
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (state->pendingJobs.empty()) {
+                        state->isRunning = false;
+                        return;
+                    }
+                    job = state->pendingJobs.front();
+                    state->pendingJobs.pop();
+                }
+
+                job->execute();
+                state->finishedJobs.push(job);
+
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->pendingJobs.empty()) {
+                    state->isRunning = false;
+                }
+                else {
+                    scheduleNext(jobManager, state, priority, token);
+                }
+            }, priority, token);
+        }
 
-        ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
-        std::shared_ptr<ThreadPool> threadPool;
+        JobManager& _jobManager;
+        JobManager::Priority _priority;
+        std::shared_ptr<State> _state;
+        JobManager::CancellationToken _token;
     };
 
 
@@ -117,9 +117,11 @@ namespace openspace {
 
     AsyncTileDataProvider::AsyncTileDataProvider(
         std::shared_ptr<TileDataset> tileDataset,
-        std::shared_ptr<ThreadPool> pool)
+        JobManager& jobManager)
         : _tileDataset(tileDataset)
-        , _concurrentJobManager(pool)
+        // Tile reads are what the user is waiting for, so they are prioritized over
+        // other background work
+        , _concurrentJobManager(jobManager, JobManager::Priority::High)
     {
 
     }
@@ -163,8 +165,6 @@ namespace openspace {
 
     void AsyncTileDataProvider::reset() {
         //_futureTileIOResults.clear();
-        //_threadPool->stop(ghoul::ThreadPool::RunRemainingTasks::No);
-        //_threadPool->start();
         _enqueuedTileRequests.clear();
         _concurrentJobManager.reset();
         while (_concurrentJobManager.numFinishedJobs() > 0) {
@@ -174,7 +174,6 @@ namespace openspace {
     }
 
     void AsyncTileDataProvider::clearRequestQueue() {
-        //_threadPool->clearRemainingTasks();
         //_futureTileIOResults.clear();
         _concurrentJobManager.clearEnqueuedJobs();
         _enqueuedTileRequests.clear();
@@ -33,8 +33,6 @@
 #include <modules/globebrowsing/geometry/geodetic2.h>
 
 #include <modules/globebrowsing/other/concurrentjobmanager.h>
-#include <modules/globebrowsing/other/threadpool.h>
-//#include <ghoul/misc/threadpool.h>
 
 #include <modules/globebrowsing/tile/tiledataset.h>
 
@@ -119,7 +117,7 @@ namespace openspace {
     public:
 
         AsyncTileDataProvider(std::shared_ptr<TileDataset> textureDataProvider, 
-            std::shared_ptr<ThreadPool> pool);
+            JobManager& jobManager);
 
         ~AsyncTileDataProvider();
 
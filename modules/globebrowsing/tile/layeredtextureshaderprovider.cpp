@@ -33,10 +33,25 @@
 
 namespace {
     const std::string _loggerCat = "LayeredTextureShaderProvider";
+
+    // Number of bits used per texture category in the preprocessing key: the number of
+    // active layers followed by the blending bit
+    const int BitsPerLayerCount = 4;
+    const int BitsPerCategory = BitsPerLayerCount + 1;
+    const int FlagsOffset = 32;
 }
 
 namespace openspace {
 
+    static_assert(
+        LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY < (1 << BitsPerLayerCount),
+        "The number of layers per category does not fit in the preprocessing key"
+    );
+    static_assert(
+        LayeredTextures::NUM_TEXTURE_CATEGORIES * BitsPerCategory <= FlagsOffset,
+        "The texture categories do not fit in the preprocessing key"
+    );
+
     const std::string LayeredTextureInfo::glslKeyPrefixes[NUM_SETTINGS_PER_CATEGORY] =
     {
         "lastLayerIndex",
@@ -51,34 +66,65 @@ namespace openspace {
             layerBlendingEnabled == other.layerBlendingEnabled;
     }
 
-    bool LayeredTexturePreprocessingData::operator==(
-        const LayeredTexturePreprocessingData& other) const
+    const std::string LayeredTexturePreprocessingData::FLAG_NAMES[NUM_FLAGS] =
     {
-        
-        if (layeredTextureInfo.size() != other.layeredTextureInfo.size() ||
-            keyValuePairs.size() != other.keyValuePairs.size()) {
-            return false;
+        "useAtmosphere",
+        "showChunkEdges",
+        "showHeightResolution",
+        "showHeightIntensities",
+    };
+
+    LayeredTexturePreprocessingData::LayeredTexturePreprocessingData()
+        : flags(0)
+    {
+        for (LayeredTextureInfo& info : layeredTextureInfo) {
+            info.lastLayerIdx = -1;
+            info.layerBlendingEnabled = false;
         }
-        else
-        {
-            bool equal = true;
-            for (size_t i = 0; i < layeredTextureInfo.size(); i++) {
-                equal = equal && (layeredTextureInfo[i] == other.layeredTextureInfo[i]);
-            }
-            for (size_t i = 0; i < keyValuePairs.size(); i++) {
-                equal = equal && (keyValuePairs[i] == other.keyValuePairs[i]);
-            }
-            return equal;
+    }
+
+    void LayeredTexturePreprocessingData::setFlag(Flag flag, bool value) {
+        if (value) {
+            flags |= (1u << flag);
+        }
+        else {
+            flags &= ~(1u << flag);
+        }
+    }
+
+    bool LayeredTexturePreprocessingData::flag(Flag flag) const {
+        return (flags & (1u << flag)) != 0;
+    }
+
+    LayeredTexturePreprocessingData::Key LayeredTexturePreprocessingData::key() const {
+        Key key = 0;
+        for (size_t i = 0; i < layeredTextureInfo.size(); i++) {
+            const LayeredTextureInfo& info = layeredTextureInfo[i];
+            Key category = static_cast<Key>(info.lastLayerIdx + 1) |
+                (static_cast<Key>(info.layerBlendingEnabled) << BitsPerLayerCount);
+            key |= category << (i * BitsPerCategory);
         }
+        key |= static_cast<Key>(flags) << FlagsOffset;
+        return key;
+    }
+
+    bool LayeredTexturePreprocessingData::operator==(
+        const LayeredTexturePreprocessingData& other) const
+    {
+        return key() == other.key();
     }
 
     LayeredTextureShaderProvider::LayeredTextureShaderProvider(
         const std::string& shaderName,
         const std::string& vsPath,
-        const std::string& fsPath)
-        : _shaderName(shaderName)
+        const std::string& fsPath,
+        std::vector<std::pair<std::string, std::string>> constantDefinitions)
+        : _currentVariant(nullptr)
+        , _currentKey(0)
+        , _shaderName(shaderName)
         , _vsPath(vsPath)
         , _fsPath(fsPath)
+        , _constantDefinitions(std::move(constantDefinitions))
         , _updatedOnLastCall(false)
     {
     
@@ -86,34 +132,57 @@ namespace openspace {
     
     LayeredTextureShaderProvider::~LayeredTextureShaderProvider()
     {
-        if (_programObject) {
-            RenderEngine& renderEngine = OsEng.renderEngine();
-            renderEngine.removeRenderProgram(_programObject);
-            _programObject = nullptr;
+        _precompilationToken.cancel();
+
+        RenderEngine& renderEngine = OsEng.renderEngine();
+        for (auto& variant : _shaderVariants) {
+            renderEngine.removeRenderProgram(variant.second->programObject);
         }
+        _shaderVariants.clear();
     }
 
     ProgramObject* LayeredTextureShaderProvider::getUpdatedShaderProgram(
-        LayeredTexturePreprocessingData preprocessingData)
+        const LayeredTexturePreprocessingData& preprocessingData)
+    {
+        const LayeredTexturePreprocessingData::Key key = preprocessingData.key();
+        if (_currentVariant && key == _currentKey) {
+            _updatedOnLastCall = false;
+            return _currentVariant->programObject.get();
+        }
+
+        auto it = _shaderVariants.find(key);
+        _currentVariant = (it != _shaderVariants.end()) ?
+            it->second.get() :
+            compileShaderVariant(preprocessingData);
+        _currentKey = key;
+        _updatedOnLastCall = true;
+        return _currentVariant->programObject.get();
+    }
+
+    void LayeredTextureShaderProvider::precompileShaderPrograms(
+        const std::vector<LayeredTexturePreprocessingData>& preprocessingData)
     {
-        _updatedOnLastCall = false;
-        if (!(preprocessingData == _preprocessingData) || _programObject == nullptr) {
-            recompileShaderProgram(preprocessingData);
-            _updatedOnLastCall = true;
+        for (const LayeredTexturePreprocessingData& data : preprocessingData) {
+            OsEng.jobManager().enqueueOnMainThread(
+                [this, data]() {
+                    if (_shaderVariants.find(data.key()) == _shaderVariants.end()) {
+                        compileShaderVariant(data);
+                    }
+                },
+                _precompilationToken
+            );
         }
-        return _programObject.get();
     }
 
-    void LayeredTextureShaderProvider::recompileShaderProgram(
-        LayeredTexturePreprocessingData preprocessingData)
+    LayeredTextureShaderProvider::ShaderVariant*
+        LayeredTextureShaderProvider::compileShaderVariant(
+            const LayeredTexturePreprocessingData& preprocessingData)
     {
-        _preprocessingData = preprocessingData;
         ghoul::Dictionary shaderDictionary;
-        
 
         // Different texture types can be height maps or color texture for example.
         // These are used differently within the shaders.
-        auto textureTypes = _preprocessingData.layeredTextureInfo;
+        const auto& textureTypes = preprocessingData.layeredTextureInfo;
         for (size_t i = 0; i < textureTypes.size(); i++) {
             // lastLayerIndex must be at least 0 for the shader to compile,
             // the layer type is inactivated by setting use to false
@@ -135,29 +204,47 @@ namespace openspace {
         }
 
         // Other settings such as "useAtmosphere"
-        auto keyValuePairs = _preprocessingData.keyValuePairs;
-        for (size_t i = 0; i < keyValuePairs.size(); i++) {
-            shaderDictionary.setValue(keyValuePairs[i].first, keyValuePairs[i].second);
+        for (int i = 0; i < LayeredTexturePreprocessingData::NUM_FLAGS; i++) {
+            using Flag = LayeredTexturePreprocessingData::Flag;
+            shaderDictionary.setValue(
+                LayeredTexturePreprocessingData::FLAG_NAMES[i],
+                std::to_string(preprocessingData.flag(Flag(i))));
+        }
+        for (const auto& definition : _constantDefinitions) {
+            shaderDictionary.setValue(definition.first, definition.second);
         }
 
-        // Remove old program
-        OsEng.renderEngine().removeRenderProgram(_programObject);
-
-        _programObject = OsEng.renderEngine().buildRenderProgram(
+        auto variant = std::make_unique<ShaderVariant>();
+        variant->programObject = OsEng.renderEngine().buildRenderProgram(
             _shaderName,
             _vsPath,
             _fsPath,
             shaderDictionary);
 
-        ghoul_assert(_programObject != nullptr, "Failed to initialize programObject!");
+        ghoul_assert(variant->programObject != nullptr, "Failed to initialize programObject!");
         using IgnoreError = ProgramObject::IgnoreError;
-        _programObject->setIgnoreSubroutineUniformLocationError(IgnoreError::Yes);
+        variant->programObject->setIgnoreSubroutineUniformLocationError(IgnoreError::Yes);
+
+        LayeredTextureShaderUniformIdHandler::queryIds(
+            *variant->programObject,
+            variant->uniformIds);
+
+        LDEBUG("Compiled variant " << _shaderVariants.size() + 1 << " of '" <<
+            _shaderName << "'");
+
+        ShaderVariant* result = variant.get();
+        _shaderVariants[preprocessingData.key()] = std::move(variant);
+        return result;
     }
 
     bool LayeredTextureShaderProvider::updatedOnLastCall() {
         return _updatedOnLastCall;
     }
 
+    size_t LayeredTextureShaderProvider::numCompiledVariants() const {
+        return _shaderVariants.size();
+    }
+
 
     const std::string LayeredTextureShaderUniformIdHandler::glslTileDataNames[
         NUM_TILE_DATA_VARIABLES] =
@@ -178,6 +265,8 @@ namespace openspace {
     };
 
     LayeredTextureShaderUniformIdHandler::LayeredTextureShaderUniformIdHandler()
+        : _tileUniformIds(nullptr)
+        , _programObject(nullptr)
     {
 
     }
@@ -190,35 +279,36 @@ namespace openspace {
     void LayeredTextureShaderUniformIdHandler::updateIdsIfNecessary(
         LayeredTextureShaderProvider* shaderProvider)
     {
-        if (shaderProvider->updatedOnLastCall())
+        // The IDs were queried when the variant was compiled
+        _tileUniformIds = &shaderProvider->_currentVariant->uniformIds;
+        _programObject = shaderProvider->_currentVariant->programObject.get();
+    }
+
+    void LayeredTextureShaderUniformIdHandler::queryIds(ProgramObject& programObject,
+        UniformIds& ids)
+    {
+        // Ignore errors since this loops through even uniforms that does not exist.
+        programObject.setIgnoreUniformLocationError(ProgramObject::IgnoreError::Yes);
+        for (size_t i = 0; i < LayeredTextures::NUM_TEXTURE_CATEGORIES; i++)
         {
-            _shaderProvider = shaderProvider;
-            // Ignore errors since this loops through even uniforms that does not exist.
-            _shaderProvider->_programObject->setIgnoreUniformLocationError(
-                ProgramObject::IgnoreError::Yes);
-            for (size_t i = 0; i < LayeredTextures::NUM_TEXTURE_CATEGORIES; i++)
+            for (size_t j = 0; j < NUM_BLEND_TEXTURES; j++)
             {
-                for (size_t j = 0; j < NUM_BLEND_TEXTURES; j++)
+                for (size_t k = 0; k < LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY;
+                    k++)
                 {
-                    for (size_t k = 0; k < LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY;
-                        k++)
+                    for (size_t l = 0; l < NUM_TILE_DATA_VARIABLES; l++)
                     {
-                        for (size_t l = 0; l < NUM_TILE_DATA_VARIABLES; l++)
-                        {
-                            _tileUniformIds[i][j][k][l] =
-                                _shaderProvider->_programObject->uniformLocation(
-                                    LayeredTextures::TEXTURE_CATEGORY_NAMES[i] +
-                                    blendLayerSuffixes[j] +
-                                    "[" + std::to_string(k) + "]." +
-                                    glslTileDataNames[l]);
-                        }
+                        ids[i][j][k][l] = programObject.uniformLocation(
+                            LayeredTextures::TEXTURE_CATEGORY_NAMES[i] +
+                            blendLayerSuffixes[j] +
+                            "[" + std::to_string(k) + "]." +
+                            glslTileDataNames[l]);
                     }
                 }
             }
-            // Reset ignore errors
-            _shaderProvider->_programObject->setIgnoreUniformLocationError(
-                ProgramObject::IgnoreError::No);
         }
+        // Reset ignore errors
+        programObject.setIgnoreUniformLocationError(ProgramObject::IgnoreError::No);
     }
 
     GLint LayeredTextureShaderUniformIdHandler::getId(
@@ -227,13 +317,13 @@ namespace openspace {
         size_t layerIndex,
         GlslTileDataId tileDataId)
     {
-        return _tileUniformIds[category][blendLayer][layerIndex][tileDataId];
+        return (*_tileUniformIds)[category][blendLayer][layerIndex][tileDataId];
     }
 
     
     ProgramObject& LayeredTextureShaderUniformIdHandler::programObject()
     {
-        return *_shaderProvider->_programObject;
+        return *_programObject;
     }
     
 }  // namespace openspace
@@ -27,11 +27,15 @@
 
 #include <modules/globebrowsing/tile/layeredtextures.h>
 
+#include <openspace/util/jobmanager.h>
+
 #include "ghoul/opengl/programobject.h"
 
 #include <vector>
 #include <array>
 #include <string>
+#include <unordered_map>
+#include <cstdint>
 
 //////////////////////////////////////////////////////////////////////////////////////////
 //                              LAYERED TEXTURE SHADER PROVIDER                         //
@@ -40,7 +44,7 @@
 namespace openspace {
     using namespace ghoul::opengl;
 
-    class LayeredTextureShaderUniformIdHandler;
+    class LayeredTextureShaderProvider;
 
     /**
     * Settings per texture category that contains shader preprocessing information.
@@ -66,59 +70,47 @@ namespace openspace {
     * Data needed for shader preprocessing before compiling a layered texture shader
     * program.
     *
-    * If a <code>LayeredTexturePreprocessingData</code> is compared with another it can
-    * be determined wheter or not a <code>LayeredTextureShaderProvider</code> needs to
-    * recompile its shader program. For each <code>TextureCategory</code> there is
-    * information about how many layers it has and whether or not to blend the texture
-    * levels.
+    * For each <code>TextureCategory</code> there is information about how many layers
+    * it has and whether or not to blend the texture levels. In addition, there is a set
+    * of boolean flags that are passed to the shaders. All of this information is encoded
+    * in a compact <code>Key</code> that identifies the shader variant that is needed to
+    * render with these settings.
     */
     struct LayeredTexturePreprocessingData
     {
-        std::array<LayeredTextureInfo, LayeredTextures::NUM_TEXTURE_CATEGORIES>
-            layeredTextureInfo;
-        std::vector<std::pair<std::string, std::string> > keyValuePairs;
-        bool operator==(const LayeredTexturePreprocessingData& other) const;
-    };
+        using Key = uint64_t;
 
-    /**
-    * This class has ownership of an updated shader program for rendering tiles.
-    */
-    class LayeredTextureShaderProvider
-    {
-    public:
-        LayeredTextureShaderProvider(
-            const std::string& shaderName,
-            const std::string& vsPath,
-            const std::string& fsPath);
-        ~LayeredTextureShaderProvider();
+        enum Flag {
+            UseAtmosphere = 0,
+            ShowChunkEdges,
+            ShowHeightResolution,
+            ShowHeightIntensities,
+            NUM_FLAGS
+        };
+        static const std::string FLAG_NAMES[NUM_FLAGS];
 
-        /**
-        * Returns a pointer to a <code>ProgramObject</code> for rendering tiles.
-        * \param <code>preprocessingData</code> determines wherer or not the shader
-        * program needs to be re-compiled. If <code>preprocessingData</code> is different
-        * from the last time this function was called the shader program will be
-        * recompiled before returned.
-        */
-        ProgramObject* getUpdatedShaderProgram(
-            LayeredTexturePreprocessingData preprocessingData);
+        LayeredTexturePreprocessingData();
 
-        bool updatedOnLastCall();
-    private:
-        friend class LayeredTextureShaderUniformIdHandler;
-        void recompileShaderProgram(LayeredTexturePreprocessingData preprocessingData);
+        void setFlag(Flag flag, bool value);
+        bool flag(Flag flag) const;
 
-        std::unique_ptr<ProgramObject> _programObject;
-        LayeredTexturePreprocessingData _preprocessingData;
+        /**
+        * Returns the compact encoding of this preprocessing data. Two preprocessing data
+        * objects result in the same shader program if and only if their keys are equal.
+        */
+        Key key() const;
 
-        const std::string _shaderName;
-        const std::string _vsPath;
-        const std::string _fsPath;
+        bool operator==(const LayeredTexturePreprocessingData& other) const;
 
-        bool _updatedOnLastCall;
+        std::array<LayeredTextureInfo, LayeredTextures::NUM_TEXTURE_CATEGORIES>
+            layeredTextureInfo;
+        uint32_t flags;
     };
 
     /**
     * This class caches OpenGL uniform IDs for <code>LayeredTextureShaderProvider</code>s.
+    * The IDs are queried once when a shader variant is compiled and are stored alongside
+    * the variant, so switching between variants does not require any queries.
     */
     class LayeredTextureShaderUniformIdHandler
     {
@@ -167,10 +159,25 @@ namespace openspace {
             Parent2,
         };
 
+        using UniformIds = std::array<
+            std::array<
+            std::array<
+            std::array<
+            GLint,
+            NUM_TILE_DATA_VARIABLES>,
+            LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY>,
+            NUM_BLEND_TEXTURES>,
+            LayeredTextures::NUM_TEXTURE_CATEGORIES>;
+
         LayeredTextureShaderUniformIdHandler();
         ~LayeredTextureShaderUniformIdHandler();
         void updateIdsIfNecessary(LayeredTextureShaderProvider* shaderProvider);
 
+        /**
+        * Queries all uniform IDs from the \p programObject.
+        */
+        static void queryIds(ProgramObject& programObject, UniformIds& ids);
+
         /**
         * \param <code>category</code> can be one of the categories specified in
         * <code>LayeredTextures::TextureCategory</code>.
@@ -197,19 +204,82 @@ namespace openspace {
         static const std::string glslTileDataNames[NUM_TILE_DATA_VARIABLES];
         static const std::string blendLayerSuffixes[NUM_BLEND_TEXTURES];
 
-        std::array<
-            std::array<
-            std::array<
-            std::array<
-            GLint,
-            NUM_TILE_DATA_VARIABLES>,
-            LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY>,
-            NUM_BLEND_TEXTURES>,
-            LayeredTextures::NUM_TEXTURE_CATEGORIES>
-            _tileUniformIds;
+        const UniformIds* _tileUniformIds;
+        ProgramObject* _programObject;
+    };
+
+    /**
+    * This class has ownership of the shader programs for rendering tiles. A separate
+    * program variant is compiled for each distinct
+    * <code>LayeredTexturePreprocessingData</code> that is requested, and all variants are
+    * kept, so that switching back to a previously used variant does not recompile.
+    */
+    class LayeredTextureShaderProvider
+    {
+    public:
+        /**
+        * \param <code>constantDefinitions</code> are passed to the shader preprocessor
+        * for every variant.
+        */
+        LayeredTextureShaderProvider(
+            const std::string& shaderName,
+            const std::string& vsPath,
+            const std::string& fsPath,
+            std::vector<std::pair<std::string, std::string>> constantDefinitions = {});
+        ~LayeredTextureShaderProvider();
 
-        LayeredTextureShaderProvider* _shaderProvider;
+        /**
+        * Returns a pointer to a <code>ProgramObject</code> for rendering tiles.
+        * \param <code>preprocessingData</code> determines which shader variant is used.
+        * If no variant has been compiled for <code>preprocessingData</code> yet, it is
+        * compiled before it is returned.
+        */
+        ProgramObject* getUpdatedShaderProgram(
+            const LayeredTexturePreprocessingData& preprocessingData);
+
+        /**
+        * Compiles the variants for each of the <code>preprocessingData</code> in the
+        * background, before they are requested. As programs can only be compiled on
+        * the rendering thread, one variant is compiled per main thread job; variants
+        * that are requested before they were compiled are compiled immediately.
+        */
+        void precompileShaderPrograms(
+            const std::vector<LayeredTexturePreprocessingData>& preprocessingData);
+
+        /**
+        * Returns <code>true</code> if the last call to
+        * <code>getUpdatedShaderProgram</code> returned a different variant than the
+        * call before it.
+        */
+        bool updatedOnLastCall();
+
+        /// Returns the number of variants that have been compiled
+        size_t numCompiledVariants() const;
+
+    private:
+        friend class LayeredTextureShaderUniformIdHandler;
+
+        struct ShaderVariant {
+            std::unique_ptr<ProgramObject> programObject;
+            LayeredTextureShaderUniformIdHandler::UniformIds uniformIds;
+        };
+
+        ShaderVariant* compileShaderVariant(
+            const LayeredTexturePreprocessingData& preprocessingData);
+
+        std::unordered_map<LayeredTexturePreprocessingData::Key,
+            std::unique_ptr<ShaderVariant>> _shaderVariants;
+        ShaderVariant* _currentVariant;
+        LayeredTexturePreprocessingData::Key _currentKey;
+
+        const std::string _shaderName;
+        const std::string _vsPath;
+        const std::string _fsPath;
+        const std::vector<std::pair<std::string, std::string>> _constantDefinitions;
+
+        bool _updatedOnLastCall;
+        JobManager::CancellationToken _precompilationToken;
     };
 }  // namespace openspace
 
-#endif  // __LAYERED_TEXTURE_SHADER_PROVIDER__
\ No newline at end of file
+#endif  // __LAYERED_TEXTURE_SHADER_PROVIDER__
@@ -69,7 +69,8 @@ namespace openspace {
 
             /**
             * The Texture is uploaded to the GPU and good for usage.
-            * texture is defined. preprocessData may be defined.
+            * texture is defined, except when running headless where nothing is
+            * uploaded. preprocessData may be defined.
             */
             OK 
         } status;
@@ -122,7 +122,7 @@ namespace openspace {
 
     const PixelRegion TileDataset::padding = PixelRegion(tilePixelStartOffset, tilePixelSizeDifference);
     
-    bool TileDataset::GdalHasBeenInitialized = false;
+    std::once_flag TileDataset::GdalInitializedFlag;
 
 
 
@@ -167,11 +167,10 @@ namespace openspace {
     }
 
     void TileDataset::gdalEnsureInitialized() {
-        if (!GdalHasBeenInitialized) {
+        std::call_once(GdalInitializedFlag, []() {
             GDALAllRegister();
             CPLSetConfigOption("GDAL_DATA", absPath("${MODULE_GLOBEBROWSING}/gdal_data").c_str());
-            GdalHasBeenInitialized = true;
-        }
+        });
     }
 
     GDALDataset* TileDataset::gdalDataset(const std::string& gdalDatasetDesc) {
@@ -30,11 +30,11 @@
 #include <queue>
 #include <iostream>
 #include <unordered_map>
+#include <mutex>
 
 
 #include <ghoul/filesystem/file.h>
 #include <ghoul/opengl/texture.h>
-#include <ghoul/misc/threadpool.h>
 
 #include <modules/globebrowsing/tile/tiledatatype.h>
 #include <modules/globebrowsing/tile/pixelregion.h>
@@ -113,6 +113,12 @@ namespace openspace {
         const TileDataLayout& getDataLayout();
         void reset();
 
+        /**
+        * Registers all GDAL drivers and sets the GDAL data path. This is done only once,
+        * no matter how often or from how many threads this function is called.
+        */
+        static void gdalEnsureInitialized();
+
 
         const static glm::ivec2 tilePixelStartOffset;
         const static glm::ivec2 tilePixelSizeDifference;
@@ -135,7 +141,6 @@ namespace openspace {
         //                            GDAL helper methods                               //
         //////////////////////////////////////////////////////////////////////////////////
 
-        void gdalEnsureInitialized();
         GDALDataset* gdalDataset(const std::string& gdalDatasetDesc);
         bool gdalHasOverviews() const;
         int gdalOverview(const PixelRange& baseRegionSize) const;
@@ -185,7 +190,7 @@ namespace openspace {
         TileDepthTransform _depthTransform;
         TileDataLayout _dataLayout;
 
-        static bool GdalHasBeenInitialized;
+        static std::once_flag GdalInitializedFlag;
         bool hasBeenInitialized;
     };
 
@@ -31,6 +31,7 @@
 #include <ghoul/logging/logmanager.h>
 
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/windowwrapper.h>
 
 namespace {
     const std::string _loggerCat = "CachingTileProvider";
@@ -46,6 +47,7 @@ namespace openspace {
 
     CachingTileProvider::CachingTileProvider(const ghoul::Dictionary& dictionary) 
     : _framesSinceLastRequestFlush(0)
+    , _defaultTile(Tile::TileUnavailable)
     {
         std::string name = "Name unspecified";
         dictionary.getValue("Name", name);
@@ -86,13 +88,11 @@ namespace openspace {
         // Initialize instance variables
         auto tileDataset = std::make_shared<TileDataset>(filePath, config);
 
-        // only one thread per provider supported atm
-        // (GDAL does not handle multiple threads for a single dataset very well
-        // currently)
-        auto threadPool = std::make_shared<ThreadPool>(1);
-
+        // The tiles are read by the engine's shared job system, but never more than one
+        // at a time per provider (GDAL does not handle multiple threads for a single
+        // dataset very well currently)
         _asyncTextureDataProvider = std::make_shared<AsyncTileDataProvider>(
-            tileDataset, threadPool);
+            tileDataset, OsEng.jobManager());
         _tileCache = std::make_shared<TileCache>(cacheSize);
         _framesUntilRequestFlush = framesUntilRequestFlush;
     }
@@ -105,6 +105,7 @@ namespace openspace {
         , _tileCache(tileCache)
         , _framesUntilRequestFlush(framesUntilFlushRequestQueue)
         , _framesSinceLastRequestFlush(0)
+        , _defaultTile(Tile::TileUnavailable)
     {
         
     }
@@ -150,7 +151,7 @@ namespace openspace {
     }
 
     Tile CachingTileProvider::getDefaultTile() {
-        if (_defaultTile.texture == nullptr) {
+        if (_defaultTile.status != Tile::Status::OK) {
             _defaultTile = createTile(_asyncTextureDataProvider->getTextureDataProvider()->defaultTileData());
         }
         return _defaultTile;
@@ -194,7 +195,14 @@ namespace openspace {
             return{ nullptr, nullptr, Tile::Status::IOError };
         }
 
-        ChunkHashKey key = tileIOResult->chunkIndex.hashKey();
+        if (OsEng.windowWrapper().isHeadless()) {
+            // Without an OpenGL context there is nothing to upload to, but the tile is
+            // still reported as OK so that the chunk tree can refine past it
+            delete[] tileIOResult->imageData;
+            tileIOResult->imageData = nullptr;
+            return{ nullptr, tileIOResult->preprocessData, Tile::Status::OK };
+        }
+
         TileDataLayout dataLayout =
             _asyncTextureDataProvider->getTextureDataProvider()->getDataLayout();
         
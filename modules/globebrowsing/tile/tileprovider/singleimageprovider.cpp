@@ -31,6 +31,7 @@
 #include <ghoul/logging/logmanager.h>
 
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/rendering/texturecache.h>
 
 namespace {
     const std::string _loggerCat = "SingleImageProvider";
@@ -46,13 +47,27 @@ namespace openspace {
             throw std::runtime_error("Must define key '" + KeyFilePath + "'");
         }
 
-        reset();
+        initialize();
     }
 
     SingleImageProvider::SingleImageProvider(const std::string& imagePath)
         : _imagePath(imagePath)
     {
-        reset();
+        initialize();
+    }
+
+    SingleImageProvider::~SingleImageProvider() {
+        OsEng.textureCache().release(_source);
+    }
+
+    void SingleImageProvider::initialize() {
+        _source = absPath(_imagePath);
+        _tile = Tile();
+        _tile.status = Tile::Status::Unavailable;
+        _tile.preprocessData = nullptr;
+
+        // The image is decoded in the background and shared with other users of it
+        OsEng.textureCache().acquire(_source);
     }
 
     Tile SingleImageProvider::getTile(const ChunkIndex& chunkIndex) {
@@ -75,17 +90,15 @@ namespace openspace {
     }
 
     void SingleImageProvider::update() {
-        // nothing to be done
+        std::shared_ptr<Texture> texture = OsEng.textureCache().texture(_source);
+        if (texture && texture != _tile.texture) {
+            _tile.texture = texture;
+            _tile.status = Tile::Status::OK;
+        }
     }
 
     void SingleImageProvider::reset() {
-        _tile = Tile();
-        _tile.texture = std::shared_ptr<Texture>(ghoul::io::TextureReader::ref().loadTexture(_imagePath).release());
-        _tile.status = _tile.texture != nullptr ? Tile::Status::OK : Tile::Status::IOError;
-        _tile.preprocessData = nullptr;
-
-        _tile.texture->uploadTexture();
-        _tile.texture->setFilter(ghoul::opengl::Texture::FilterMode::Linear);
+        OsEng.textureCache().refresh(_source);
     }
 
     int SingleImageProvider::maxLevel() {
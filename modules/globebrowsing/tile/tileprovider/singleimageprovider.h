@@ -50,7 +50,7 @@ namespace openspace {
         
         SingleImageProvider(const ghoul::Dictionary& dictionary);
         SingleImageProvider(const std::string& imagePath);
-        virtual ~SingleImageProvider() { }
+        virtual ~SingleImageProvider();
 
         virtual Tile getTile(const ChunkIndex& chunkIndex);
         virtual Tile getDefaultTile();
@@ -60,8 +60,12 @@ namespace openspace {
         virtual void reset();
         virtual int maxLevel();
     private:
+        void initialize();
+
         Tile _tile;
         std::string _imagePath;
+        // The key of the image in the TextureCache
+        std::string _source;
     };
 
 }  // namespace openspace
@@ -33,6 +33,7 @@
 #include <ghoul/font/fontmanager.h>
 
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/windowwrapper.h>
 
 #include <sstream>
 
@@ -50,22 +51,23 @@ namespace openspace {
         : _tileCache(500)
         , _textureSize(textureSize)
         , _fontSize(fontSize)
+        , _fbo(0)
     {
-
-        _font = OsEng.fontManager().font("Mono", _fontSize);
-        
-        _fontRenderer = std::unique_ptr<FontRenderer>(FontRenderer::createDefault());
-        _fontRenderer->setFramebufferSize(textureSize);
-
-
-        glGenFramebuffers(1, &_fbo);
+        // The font, font renderer and FBO need an OpenGL context and are created on
+        // first use in createChunkIndexTile
     }
 
     TextTileProvider::~TextTileProvider() {
-        glDeleteFramebuffers(1, &_fbo);
+        if (_fbo != 0) {
+            glDeleteFramebuffers(1, &_fbo);
+        }
     }
 
     Tile TextTileProvider::getTile(const ChunkIndex& chunkIndex) {
+        if (OsEng.windowWrapper().isHeadless()) {
+            return Tile::TileUnavailable;
+        }
+
         ChunkHashKey key = chunkIndex.hashKey();
         
         if (!_tileCache.exist(key)) {
@@ -81,6 +83,9 @@ namespace openspace {
 
 
     Tile::Status TextTileProvider::getTileStatus(const ChunkIndex& index) {
+        if (OsEng.windowWrapper().isHeadless()) {
+            return Tile::Status::Unavailable;
+        }
         return Tile::Status::OK;
     }
 
@@ -99,7 +104,20 @@ namespace openspace {
         _tileCache.clear();
     }
 
+    void TextTileProvider::initializeFontRendering() {
+        _font = OsEng.fontManager().font("Mono", _fontSize);
+
+        _fontRenderer = std::unique_ptr<FontRenderer>(FontRenderer::createDefault());
+        _fontRenderer->setFramebufferSize(_textureSize);
+
+        glGenFramebuffers(1, &_fbo);
+    }
+
     Tile TextTileProvider::createChunkIndexTile(const ChunkIndex& chunkIndex) {
+        if (_fbo == 0) {
+            initializeFontRendering();
+        }
+
         Tile tile = backgroundTile(chunkIndex);
 
         // Keep track of defaultFBO and viewport to be able to reset state when done
@@ -179,8 +197,6 @@ namespace openspace {
 
     SizeReferenceTileProvider::SizeReferenceTileProvider(const ghoul::Dictionary& dictionary) {
         _fontSize = 50;
-        ghoul::fontrendering::FontManager& fm = OsEng.fontManager();
-        _font = fm.font("Mono", _fontSize);
 
         glm::dvec3 radii(1,1,1);
         if (!dictionary.getValue(KeyRadii, radii)) {
@@ -191,14 +207,9 @@ namespace openspace {
         _backgroundTile.status = Tile::Status::Unavailable;
         std::string backgroundImagePath;
         if (dictionary.getValue(KeyBackgroundImagePath, backgroundImagePath)) {
-            using namespace ghoul::io;
-            std::string imgAbsPath = absPath(backgroundImagePath);
-            _backgroundTile.texture = TextureReader::ref().loadTexture(imgAbsPath);
-            _backgroundTile.texture->uploadTexture();
-            _backgroundTile.texture->setFilter(ghoul::opengl::Texture::FilterMode::Linear);
-            _backgroundTile.status = Tile::Status::OK;
+            // Loaded together with the other OpenGL resources in backgroundTile
+            _backgroundImagePath = absPath(backgroundImagePath);
         }
-
     }
 
     void SizeReferenceTileProvider::renderText(const FontRenderer& fontRenderer, const ChunkIndex& chunkIndex) const {
@@ -250,6 +261,17 @@ namespace openspace {
     }
 
     Tile SizeReferenceTileProvider::backgroundTile(const ChunkIndex& chunkIndex) const {
+        if (!_backgroundImagePath.empty()) {
+            using namespace ghoul::io;
+            using FilterMode = ghoul::opengl::Texture::FilterMode;
+            _backgroundTile.texture =
+                TextureReader::ref().loadTexture(_backgroundImagePath);
+            _backgroundTile.texture->uploadTexture();
+            _backgroundTile.texture->setFilter(FilterMode::Linear);
+            _backgroundTile.status = Tile::Status::OK;
+            _backgroundImagePath.clear();
+        }
+
         if (_backgroundTile.status == Tile::Status::OK) {
             Tile tile;
             auto t = _backgroundTile.texture;
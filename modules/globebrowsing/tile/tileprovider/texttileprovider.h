@@ -106,6 +106,7 @@ namespace openspace {
         size_t _fontSize;
 
     private:
+        void initializeFontRendering();
         Tile createChunkIndexTile(const ChunkIndex& chunkIndex);
         std::unique_ptr<ghoul::fontrendering::FontRenderer> _fontRenderer;
 
@@ -141,7 +142,8 @@ namespace openspace {
         int roundedLongitudalLength(const ChunkIndex& chunkIndex) const;
 
         Ellipsoid _ellipsoid;
-        Tile _backgroundTile;
+        mutable Tile _backgroundTile;
+        mutable std::string _backgroundImagePath;
     };
 
 }  // namespace openspace
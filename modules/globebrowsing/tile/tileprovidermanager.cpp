@@ -30,6 +30,8 @@
 
 #include "cpl_minixml.h"
 
+#include <algorithm>
+
 
 namespace {
     const std::string _loggerCat = "TileProviderManager";
@@ -43,23 +45,130 @@ namespace openspace {
     //                            Tile Provider Group                                   //
     //////////////////////////////////////////////////////////////////////////////////////
 
+    TileProviderGroup::TileProviderGroup()
+        : levelBlendingEnabled(true)
+        , _layerSetVersion(0)
+    {}
+
     void TileProviderGroup::update() {
-        for (auto tileProviderWithName : tileProviders) {
-            if (tileProviderWithName.isActive) {
-                tileProviderWithName.tileProvider->update();
-            }
+        updateActiveTileProviders();
+        for (TileProvider* tileProvider : _activeTileProviders) {
+            tileProvider->update();
+        }
+    }
+
+    const std::vector<TileProvider*>& TileProviderGroup::getActiveTileProviders() const {
+        return _activeTileProviders;
+    }
+
+    bool TileProviderGroup::addTileProvider(NamedTileProvider provider) {
+        if (provider.isActive &&
+            numActiveTileProviders() >= LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY)
+        {
+            LERROR("Could not add tile provider '" << provider.name << "': At most " <<
+                LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY <<
+                " tile providers per category can be active");
+            return false;
+        }
+
+        tileProviders.push_back(std::move(provider));
+        ++_layerSetVersion;
+        updateActiveTileProviders(true);
+        return true;
+    }
+
+    bool TileProviderGroup::removeTileProvider(const std::string& name) {
+        auto it = std::find_if(
+            tileProviders.begin(),
+            tileProviders.end(),
+            [&name](const NamedTileProvider& p) { return p.name == name; }
+        );
+        if (it == tileProviders.end()) {
+            return false;
+        }
+
+        tileProviders.erase(it);
+        ++_layerSetVersion;
+        updateActiveTileProviders(true);
+        return true;
+    }
+
+    bool TileProviderGroup::moveTileProvider(const std::string& name, size_t index) {
+        auto it = std::find_if(
+            tileProviders.begin(),
+            tileProviders.end(),
+            [&name](const NamedTileProvider& p) { return p.name == name; }
+        );
+        if (it == tileProviders.end()) {
+            return false;
+        }
+
+        auto destination = tileProviders.begin() +
+            std::min(index, tileProviders.size() - 1);
+        if (destination < it) {
+            std::rotate(destination, it, it + 1);
+        }
+        else {
+            std::rotate(it, it + 1, destination + 1);
         }
+        ++_layerSetVersion;
+        updateActiveTileProviders(true);
+        return true;
     }
 
+    unsigned int TileProviderGroup::layerSetVersion() const {
+        return _layerSetVersion;
+    }
 
-    const std::vector<std::shared_ptr<TileProvider>> TileProviderGroup::getActiveTileProviders() const {
-        std::vector<std::shared_ptr<TileProvider>> activeTileProviders;
-        for (auto tileProviderWithName : tileProviders) {
-            if (tileProviderWithName.isActive) {
-                activeTileProviders.push_back(tileProviderWithName.tileProvider);
+    void TileProviderGroup::updateActiveTileProviders(bool force) {
+        if (!force) {
+            // Only scanning the flags, the list is only rebuilt if one has changed
+            bool hasChanged = _activeStates.size() != tileProviders.size();
+            for (size_t i = 0; !hasChanged && i < tileProviders.size(); ++i) {
+                hasChanged = _activeStates[i] != tileProviders[i].isActive;
+            }
+            if (!hasChanged) {
+                return;
             }
         }
-        return activeTileProviders;
+
+        // The shaders have a fixed number of texture slots per category, so the providers
+        // that were enabled last are disabled again, starting with the last one
+        size_t nActive = numActiveTileProviders();
+        const size_t MaxActive = LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY;
+        for (int pass = 0; pass < 2 && nActive > MaxActive; ++pass) {
+            for (size_t i = tileProviders.size(); i > 0 && nActive > MaxActive; --i) {
+                NamedTileProvider& p = tileProviders[i - 1];
+                bool wasActive = i - 1 < _activeStates.size() && _activeStates[i - 1];
+                // The first pass only disables the providers that were enabled since
+                // the last update, the second pass any remaining ones
+                if (p.isActive && (pass == 1 || !wasActive)) {
+                    LWARNING("Disabling tile provider '" << p.name << "': At most " <<
+                        MaxActive << " tile providers per category can be active");
+                    p.isActive = false;
+                    --nActive;
+                    // Makes the user interface read the changed flag back
+                    ++_layerSetVersion;
+                }
+            }
+        }
+
+        _activeTileProviders.clear();
+        _activeStates.resize(tileProviders.size());
+        for (size_t i = 0; i < tileProviders.size(); ++i) {
+            _activeStates[i] = tileProviders[i].isActive;
+            if (tileProviders[i].isActive) {
+                _activeTileProviders.push_back(tileProviders[i].tileProvider.get());
+            }
+        }
+    }
+
+    size_t TileProviderGroup::numActiveTileProviders() const {
+        return static_cast<size_t>(std::count_if(
+            tileProviders.begin(),
+            tileProviders.end(),
+            [](const NamedTileProvider& p) { return p.isActive; }
+        ));
     }
 
     //////////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +220,7 @@ namespace openspace {
 
             // init level blending to be true
             _layerCategories[i].levelBlendingEnabled = true;
+            _layerCategories[i].updateActiveTileProviders(true);
         }
     }
 
@@ -166,14 +276,14 @@ namespace openspace {
     }
 
     void TileProviderManager::update() {
-        for (auto tileProviderGroup : _layerCategories) {
+        for (TileProviderGroup& tileProviderGroup : _layerCategories) {
             tileProviderGroup.update();
         }
     }
 
     void TileProviderManager::reset(bool includingInactive) {
-        for (auto layerCategory : _layerCategories) {
-            for (auto tileProviderWithName : layerCategory.tileProviders) {
+        for (TileProviderGroup& layerCategory : _layerCategories) {
+            for (const NamedTileProvider& tileProviderWithName : layerCategory.tileProviders) {
                 if (tileProviderWithName.isActive) {
                     tileProviderWithName.tileProvider->reset();
                 }
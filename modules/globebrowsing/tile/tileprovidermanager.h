@@ -48,14 +48,70 @@ namespace openspace {
 
 
     struct TileProviderGroup {
-
+        TileProviderGroup();
+
+        /**
+         * Updates all active tile providers and rebuilds the list of active tile
+         * providers if a provider has been enabled or disabled since the last update.
+         * Providers are toggled by writing to <code>isActive</code> directly, which is
+         * why this is checked once per update instead of on every access. If more than
+         * <code>LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY</code> providers are
+         * active, the most recently enabled ones are disabled again.
+         */
         void update();
-        const std::vector<std::shared_ptr<TileProvider>> getActiveTileProviders() const;
 
+        /**
+         * Returns the active tile providers in the order of #tileProviders. The list is
+         * cached and does not own the providers; it is valid until the next call to
+         * #update or a change of the layer set.
+         */
+        const std::vector<TileProvider*>& getActiveTileProviders() const;
+
+        /**
+         * Appends the \p provider to #tileProviders, after which it can be moved with
+         * #moveTileProvider. An active \p provider is rejected if the group already has
+         * <code>LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY</code> active providers.
+         * \return <code>true</code> if the tile provider was added
+         */
+        bool addTileProvider(NamedTileProvider provider);
+
+        /**
+         * Removes the tile provider with the name \p name.
+         * \return <code>true</code> if a tile provider was removed
+         */
+        bool removeTileProvider(const std::string& name);
+
+        /**
+         * Moves the tile provider with the name \p name to \p index, which is clamped
+         * to the last position.
+         * \return <code>true</code> if the tile provider was found
+         */
+        bool moveTileProvider(const std::string& name, size_t index);
+
+        /**
+         * Returns a number that changes every time the layer set is changed through
+         * #addTileProvider, #removeTileProvider or #moveTileProvider, which invalidates
+         * references to the elements of #tileProviders, and every time #update had to
+         * disable providers that exceeded the maximum number of active providers.
+         */
+        unsigned int layerSetVersion() const;
 
         std::vector<NamedTileProvider> tileProviders;
         bool levelBlendingEnabled;
 
+    private:
+        /// Rebuilds _activeTileProviders if the isActive flags have changed
+        void updateActiveTileProviders(bool force = false);
+
+        /// Returns the number of providers in #tileProviders that are active
+        size_t numActiveTileProviders() const;
+
+        std::vector<TileProvider*> _activeTileProviders;
+        // The isActive flags of tileProviders when _activeTileProviders was built
+        std::vector<bool> _activeStates;
+        unsigned int _layerSetVersion;
+
+        friend class TileProviderManager;
     };
 
 
@@ -79,9 +79,9 @@ namespace openspace {
         mostHighResolution.tile = Tile::TileUnavailable;
         mostHighResolution.uvTransform.uvScale.x = 0;
 
-        auto activeProviders = tileProviderGroup.getActiveTileProviders();
+        const auto& activeProviders = tileProviderGroup.getActiveTileProviders();
         for (size_t i = 0; i < activeProviders.size(); i++) {
-            TileAndTransform tileAndTransform = getHighestResolutionTile(activeProviders[i].get(), chunkIndex);
+            TileAndTransform tileAndTransform = getHighestResolutionTile(activeProviders[i], chunkIndex);
             bool tileIsOk = tileAndTransform.tile.status == Tile::Status::OK;
             bool tileHasPreprocessData = tileAndTransform.tile.preprocessData != nullptr;
             bool tileIsHigherResolution = tileAndTransform.uvTransform.uvScale.x > mostHighResolution.uvTransform.uvScale.x;
@@ -99,10 +99,11 @@ namespace openspace {
     }
 
     std::vector<TileAndTransform> TileSelector::getTilesSortedByHighestResolution(const TileProviderGroup& tileProviderGroup, const ChunkIndex& chunkIndex) {
-        auto activeProviders = tileProviderGroup.getActiveTileProviders();
+        const auto& activeProviders = tileProviderGroup.getActiveTileProviders();
         std::vector<TileAndTransform> tiles;
-        for (auto provider : activeProviders){
-            tiles.push_back(getHighestResolutionTile(provider.get(), chunkIndex));
+        tiles.reserve(activeProviders.size());
+        for (TileProvider* provider : activeProviders){
+            tiles.push_back(getHighestResolutionTile(provider, chunkIndex));
         }
 
 
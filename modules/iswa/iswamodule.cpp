@@ -42,6 +42,11 @@ namespace openspace {
         : OpenSpaceModule("ISWA")
     {}
 
+    std::vector<std::string> IswaModule::requiredModules() const {
+        // The ScreenSpaceRenderable factory is created by the Base module
+        return { "Base" };
+    }
+
     void IswaModule::internalInitialize(){
         auto fRenderable = FactoryManager::ref().factory<Renderable>();
         ghoul_assert(fRenderable, "No renderable factory existed");
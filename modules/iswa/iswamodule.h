@@ -33,6 +33,8 @@ class IswaModule : public OpenSpaceModule {
 public:
     IswaModule();
 
+    std::vector<std::string> requiredModules() const override;
+
 protected:
     void internalInitialize() override;
 };
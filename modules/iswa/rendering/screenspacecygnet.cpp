@@ -76,14 +76,19 @@ void ScreenSpaceCygnet::update(){
                         (_realTime.count()-_lastUpdateRealTime.count()) > _minRealTimeUpdateInterval);
 
     if((Time::ref().timeJumped() || timeToUpdate )){
-        _url = IswaManager::ref().iswaUrl(_cygnetId);
-        updateTexture();
+        std::string url = IswaManager::ref().iswaUrl(_cygnetId);
+        if (url == _url) {
+            // Only replaces the image if the server reports that it has changed
+            refreshTexture();
+        }
+        else {
+            _url = url;
+            updateTexture();
+        }
         _lastUpdateRealTime = _realTime;
         _lastUpdateOpenSpaceTime = _openSpaceTime;
     }
 
-    if(_futureImage.valid() && DownloadManager::futureReady(_futureImage)) {
-        loadTexture();
-    }
+    ScreenSpaceImage::update();
 }
 }
\ No newline at end of file
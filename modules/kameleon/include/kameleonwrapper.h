@@ -111,6 +111,18 @@ public:
         const std::vector<glm::vec3>& seedPoints, 
         float stepSize);
 
+    /**
+     * Traces and classifies the single fieldline through \p seedPoint, the same way
+     * #getClassifiedFieldLines does for each of its seed points.
+     * \pre The model must have been opened successfully
+     */
+    std::vector<LinePoint> getClassifiedFieldLine(
+        const std::string& xVar,
+        const std::string& yVar,
+        const std::string& zVar,
+        const glm::vec3& seedPoint,
+        float stepSize);
+
     Fieldlines getFieldLines(
         const std::string& xVar,
         const std::string& yVar, 
@@ -124,6 +136,14 @@ public:
         const glm::vec4& color, 
         float stepsize);
 
+    /**
+     * Traces the single Lorentz force trajectory through \p seedPoint, the same way
+     * #getLorentzTrajectories does for each of its seed points.
+     */
+    std::vector<LinePoint> getLorentzTrajectory(
+        const glm::vec3& seedPoint,
+        float stepsize);
+
     glm::vec3 getModelBarycenterOffset();
     glm::vec4 getModelBarycenterOffsetScaled();
     glm::vec3 getModelScale();
@@ -565,29 +565,13 @@ KameleonWrapper::Fieldlines KameleonWrapper::getClassifiedFieldLines(
     assert(_model && _interpolator);
     LINFO("Creating " << seedPoints.size() << " fieldlines from variables " << xVar << " " << yVar << " " << zVar);
 
-    std::vector<glm::vec3> fLine, bLine;
     std::vector<std::vector<LinePoint> > fieldLines;
-    glm::vec4 color;
-    FieldlineEnd forwardEnd, backEnd;
 
     if (_type == Model::BATSRUS) {
         for (glm::vec3 seedPoint : seedPoints) {
-            fLine = traceCartesianFieldline(xVar, yVar, zVar, seedPoint, stepSize, TraceDirection::FORWARD, forwardEnd);
-            bLine = traceCartesianFieldline(xVar, yVar, zVar, seedPoint, stepSize, TraceDirection::BACK, backEnd);
-
-            bLine.erase(bLine.begin());
-            bLine.insert(bLine.begin(), fLine.rbegin(), fLine.rend());
-
-            // classify
-            color = classifyFieldline(forwardEnd, backEnd);
-
-            // write colors and convert positions to meter
-            std::vector<LinePoint> line;
-            for (glm::vec3 position : bLine) {
-                line.push_back(LinePoint(RE_TO_METER*position, color));
-            }
-
-            fieldLines.push_back(line);
+            fieldLines.push_back(
+                getClassifiedFieldLine(xVar, yVar, zVar, seedPoint, stepSize)
+            );
         }
     } else {
         LERROR("Fieldlines are only supported for BATSRUS model");
@@ -596,6 +580,36 @@ KameleonWrapper::Fieldlines KameleonWrapper::getClassifiedFieldLines(
     return fieldLines;
 }
 
+std::vector<LinePoint> KameleonWrapper::getClassifiedFieldLine(
+    const std::string& xVar,
+    const std::string& yVar,
+    const std::string& zVar,
+    const glm::vec3& seedPoint,
+    float stepSize)
+{
+    assert(_model && _interpolator);
+    if (_type != Model::BATSRUS)
+        return {};
+
+    FieldlineEnd forwardEnd, backEnd;
+    std::vector<glm::vec3> fLine = traceCartesianFieldline(xVar, yVar, zVar, seedPoint, stepSize, TraceDirection::FORWARD, forwardEnd);
+    std::vector<glm::vec3> bLine = traceCartesianFieldline(xVar, yVar, zVar, seedPoint, stepSize, TraceDirection::BACK, backEnd);
+
+    bLine.erase(bLine.begin());
+    bLine.insert(bLine.begin(), fLine.rbegin(), fLine.rend());
+
+    // classify
+    glm::vec4 color = classifyFieldline(forwardEnd, backEnd);
+
+    // write colors and convert positions to meter
+    std::vector<LinePoint> line;
+    line.reserve(bLine.size());
+    for (glm::vec3 position : bLine) {
+        line.push_back(LinePoint(RE_TO_METER*position, color));
+    }
+    return line;
+}
+
 KameleonWrapper::Fieldlines KameleonWrapper::getFieldLines(
     const std::string& xVar, 
     const std::string& yVar,
@@ -642,30 +656,36 @@ KameleonWrapper::Fieldlines KameleonWrapper::getLorentzTrajectories(
     LINFO("Creating " << seedPoints.size() << " Lorentz force trajectories");
 
     Fieldlines trajectories;
-    std::vector<glm::vec3> plusTraj, minusTraj;
-
     for (auto seedPoint : seedPoints) {
-        plusTraj = traceLorentzTrajectory(seedPoint, stepsize, 1.0);
-        minusTraj = traceLorentzTrajectory(seedPoint, stepsize, -1.0);
-
-        //minusTraj.erase(minusTraj.begin());
-        size_t plusNum = plusTraj.size();
-        minusTraj.insert(minusTraj.begin(), plusTraj.rbegin(), plusTraj.rend());
-
-        // write colors and convert positions to meter
-        std::vector<LinePoint> trajectory;
-        for (glm::vec3 position : minusTraj) {            
-            if (trajectory.size() < plusNum) // set positive trajectory to pink
-                trajectory.push_back(LinePoint(RE_TO_METER*position, glm::vec4(1, 0, 1, 1)));
-            else // set negative trajectory to cyan
-                trajectory.push_back(LinePoint(RE_TO_METER*position, glm::vec4(0, 1, 1, 1)));
-        }
-        trajectories.push_back(trajectory);
+        trajectories.push_back(getLorentzTrajectory(seedPoint, stepsize));
     }
 
     return trajectories;
 }
 
+std::vector<LinePoint> KameleonWrapper::getLorentzTrajectory(
+    const glm::vec3& seedPoint,
+    float stepsize)
+{
+    std::vector<glm::vec3> plusTraj = traceLorentzTrajectory(seedPoint, stepsize, 1.0);
+    std::vector<glm::vec3> minusTraj = traceLorentzTrajectory(seedPoint, stepsize, -1.0);
+
+    //minusTraj.erase(minusTraj.begin());
+    size_t plusNum = plusTraj.size();
+    minusTraj.insert(minusTraj.begin(), plusTraj.rbegin(), plusTraj.rend());
+
+    // write colors and convert positions to meter
+    std::vector<LinePoint> trajectory;
+    trajectory.reserve(minusTraj.size());
+    for (glm::vec3 position : minusTraj) {            
+        if (trajectory.size() < plusNum) // set positive trajectory to pink
+            trajectory.push_back(LinePoint(RE_TO_METER*position, glm::vec4(1, 0, 1, 1)));
+        else // set negative trajectory to cyan
+            trajectory.push_back(LinePoint(RE_TO_METER*position, glm::vec4(0, 1, 1, 1)));
+    }
+    return trajectory;
+}
+
 glm::vec3 KameleonWrapper::getModelBarycenterOffset() {
     // ENLIL is centered, no need for offset
     if (_type == Model::ENLIL)
@@ -33,11 +33,117 @@
 
 // std
 #include <algorithm>
+#include <atomic>
 #include <math.h>
-#include <queue>
+#include <thread>
 
 namespace {
     const std::string _loggerCat = "TSP";
+
+    // Number of bricks that are fetched from the file with one sequential read
+    const unsigned int BricksPerChunk = 64;
+
+    // Reads bricks from the data region of a TSP file. Every worker thread owns its own
+    // reader so that the file position is never shared between threads
+    class BrickReader {
+    public:
+        BrickReader(const std::string& filename, unsigned int numBrickVals)
+            : _file(filename, std::ios::in | std::ios::binary)
+            , _numBrickVals(numBrickVals)
+        {}
+
+        bool isOpen() const {
+            return _file.is_open();
+        }
+
+        // Reads nBricks consecutive bricks, starting at firstBrick, into the buffer
+        bool read(unsigned int firstBrick, unsigned int nBricks, std::vector<float>& buffer) {
+            const size_t nValues = static_cast<size_t>(nBricks) * _numBrickVals;
+            if (buffer.size() < nValues) {
+                buffer.resize(nValues);
+            }
+            const long long offset = openspace::TSP::dataPosition() +
+                static_cast<long long>(firstBrick) * _numBrickVals * sizeof(float);
+            _file.seekg(offset);
+            _file.read(reinterpret_cast<char*>(buffer.data()), nValues * sizeof(float));
+            return _file.good();
+        }
+
+    private:
+        std::ifstream _file;
+        unsigned int _numBrickVals;
+    };
+
+    // Distributes the indices [0, n) in blocks of grainSize over all hardware threads.
+    // The function is called as f(reader, buffer, begin, end) and has to return false
+    // if the processing failed, in which case the remaining work is abandoned
+    template <typename Func>
+    bool processBricksInParallel(const std::string& filename, unsigned int numBrickVals,
+                                 unsigned int n, unsigned int grainSize, Func f)
+    {
+        std::atomic<unsigned int> next(0);
+        std::atomic<bool> success(true);
+
+        auto worker = [&]() {
+            BrickReader reader(filename, numBrickVals);
+            if (!reader.isOpen()) {
+                success = false;
+                return;
+            }
+            std::vector<float> buffer;
+            while (success) {
+                const unsigned int begin = next.fetch_add(grainSize);
+                if (begin >= n) {
+                    return;
+                }
+                const unsigned int end = std::min(begin + grainSize, n);
+                if (!f(reader, buffer, begin, end)) {
+                    success = false;
+                }
+            }
+        };
+
+        const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < nThreads; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        return success;
+    }
+
+    // The kernels below keep the order of the floating point additions of the original
+    // implementation so that the cached error values stay bit-identical
+
+    float brickAverage(const float* values, unsigned int n) {
+        double average = 0.0;
+        for (unsigned int i = 0; i < n; ++i) {
+            average += values[i];
+        }
+        return static_cast<float>(average / static_cast<double>(n));
+    }
+
+    float accumulateSquaredDeviation(const float* values, size_t n, float mean, float sum)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            const float d = values[i] - mean;
+            sum += d * d;
+        }
+        return sum;
+    }
+
+    // Adds the squared deviation per voxel; independent across i and thus vectorizable
+    void accumulateVoxelDeviations(const float* samples, const float* means, float* sums,
+                                   unsigned int n)
+    {
+        for (unsigned int i = 0; i < n; ++i) {
+            const float d = samples[i] - means[i];
+            sums[i] += d * d;
+        }
+    }
 }
 
 namespace openspace {
@@ -282,123 +388,91 @@ GLuint TSP::ssbo() const {
 }
 
 bool TSP::calculateSpatialError() {
-    unsigned int numBrickVals = paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
+    const unsigned int numBrickVals = paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
 
     if (!_file.is_open())
         return false;
 
-    std::vector<float> buffer(numBrickVals);
     std::vector<float> averages(numTotalNodes_);
     std::vector<float> stdDevs(numTotalNodes_);
 
-    // First pass: Calculate average color for each brick
+    // First pass: Calculate average color for each brick, streaming the whole data
+    // region in large sequential chunks
     LDEBUG("Calculating spatial error, first pass");
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        // Offset in file
-        std::streampos offset = dataPosition() + static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(reinterpret_cast<char*>(&buffer[0]),
-            static_cast<size_t>(numBrickVals)*sizeof(float));
+    bool success = processBricksInParallel(_filename, numBrickVals, numTotalNodes_,
+        BricksPerChunk,
+        [&](BrickReader& reader, std::vector<float>& buffer,
+            unsigned int begin, unsigned int end)
+        {
+            if (!reader.read(begin, end - begin, buffer))
+                return false;
 
-        double average = 0.0;
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
-            average += *it;
+            for (unsigned int brick = begin; brick < end; ++brick) {
+                const float* values = buffer.data() +
+                    static_cast<size_t>(brick - begin) * numBrickVals;
+                averages[brick] = brickAverage(values, numBrickVals);
+            }
+            return true;
         }
-
-        averages[brick] = average / static_cast<double>(numBrickVals);
+    );
+    if (!success) {
+        LERROR("Could not read bricks from " << _filename);
+        return false;
     }
 
-    // Spatial SNR stats
-    float minError = 1e20f;
-    float maxError = 0.f;
-    std::vector<float> medianArray(numTotalNodes_);
-
     // Second pass: For each brick, compare the covered leaf voxels with
-    // the brick average
+    // the brick average. The covered leaves are contiguous in the file
     LDEBUG("Calculating spatial error, second pass");
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        // Fetch mean intensity 
-        float brickAvg = averages[brick];
-
-        // Sum  for std dev computation
-        float stdDev = 0.f;
-
-        // Get a list of leaf bricks that the current brick covers
-        std::list<unsigned int> coveredLeafBricks =
-            CoveredLeafBricks(brick);
-
-        // If the brick is already a leaf, assign a negative error.
-        // Ad hoc "hack" to distinguish leafs from other nodes that happens
-        // to get a zero error due to rounding errors or other reasons.
-        if (coveredLeafBricks.size() == 1) {
-            stdDev = -0.1f;
-        }
-        else {
-
-            // Calculate "standard deviation" corresponding to leaves
-            for (auto lb = coveredLeafBricks.begin();
-                lb != coveredLeafBricks.end(); ++lb) {
-
-                // Read brick
-                std::streampos offset = dataPosition() + static_cast<long long>((*lb)*numBrickVals*sizeof(float));
-                _file.seekg(offset);
-
-                _file.read(reinterpret_cast<char*>(&buffer[0]),
-                    static_cast<size_t>(numBrickVals)*sizeof(float));
-
-                // Add to sum
-                for (auto v = buffer.begin(); v != buffer.end(); ++v) {
-                    stdDev += pow(*v - brickAvg, 2.f);
+    success = processBricksInParallel(_filename, numBrickVals, numTotalNodes_, 1,
+        [&](BrickReader& reader, std::vector<float>& buffer,
+            unsigned int begin, unsigned int end)
+        {
+            for (unsigned int brick = begin; brick < end; ++brick) {
+                const BrickRange leaves = coveredLeafBricks(brick);
+
+                // If the brick is already a leaf, assign a negative error.
+                // Ad hoc "hack" to distinguish leafs from other nodes that happens
+                // to get a zero error due to rounding errors or other reasons.
+                if (leaves.count == 1) {
+                    stdDevs[brick] = -0.1f;
+                    continue;
                 }
 
+                const float brickAvg = averages[brick];
+                float stdDev = 0.f;
+                for (unsigned int i = 0; i < leaves.count; i += BricksPerChunk) {
+                    const unsigned int n = std::min(BricksPerChunk, leaves.count - i);
+                    if (!reader.read(leaves.first + i, n, buffer))
+                        return false;
+
+                    stdDev = accumulateSquaredDeviation(
+                        buffer.data(),
+                        static_cast<size_t>(n) * numBrickVals,
+                        brickAvg,
+                        stdDev
+                    );
+                }
 
+                stdDev /= static_cast<float>(
+                    static_cast<size_t>(leaves.count) * numBrickVals
+                );
+                stdDevs[brick] = sqrt(stdDev);
             }
-
-            // Finish calculation
-            if (sizeof(float) != sizeof(int)) {
-                LERROR("Float and int sizes don't match, can't reintepret");
-                return false;
-            }
-
-            stdDev /= static_cast<float>(coveredLeafBricks.size()*numBrickVals);
-            stdDev = sqrt(stdDev);
-
-        } // if not leaf
-
-        if (stdDev < minError) {
-            minError = stdDev;
-        }
-        else if (stdDev > maxError) {
-            maxError = stdDev;
+            return true;
         }
-
-        stdDevs[brick] = stdDev;
-        medianArray[brick] = stdDev;
-
+    );
+    if (!success) {
+        LERROR("Could not read bricks from " << _filename);
+        return false;
     }
 
-    std::sort(medianArray.begin(), medianArray.end());
-    //float medError = medianArray[medianArray.size()/2];
-
-    /*
-    LDEBUG("\nMin spatial std dev: " << minError);
-    LDEBUG("Max spatial std dev: " << maxError);
-    LDEBUG("Median spatial std dev: " << medError);
-    LDEBUG("");
-    */
-
     // "Normalize" errors
     float minNorm = 1e20f;
     float maxNorm = 0.f;
     for (unsigned int i = 0; i<numTotalNodes_; ++i) {
-        //float normalized = (stdDevs[i]-minError)/(maxError-minError);
         if (stdDevs[i] > 0.f) {
             stdDevs[i] = pow(stdDevs[i], 0.5f);
         }
-        //data_[i*NUM_DATA + SPATIAL_ERR] = *reinterpret_cast<int*>(&stdDevs[i]);
         data_[i*NUM_DATA + SPATIAL_ERR] = glm::floatBitsToInt(stdDevs[i]);
         if (stdDevs[i] < minNorm) {
             minNorm = stdDevs[i];
@@ -408,7 +482,7 @@ bool TSP::calculateSpatialError() {
         }
     }
 
-    std::sort(stdDevs.begin(), stdDevs.end());
+    std::nth_element(stdDevs.begin(), stdDevs.begin() + stdDevs.size() / 2, stdDevs.end());
     float medNorm = stdDevs[stdDevs.size() / 2];
 
     minSpatialError_ = minNorm;
@@ -429,92 +503,71 @@ bool TSP::calculateTemporalError() {
 
     LDEBUG("Calculating temporal error");
 
-    // Statistics
-    //float minErr = 1e20f;
-    //float maxErr = 0.f;
-    std::vector<float> meanArray(numTotalNodes_);
+    const unsigned int numBrickVals = paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
 
     // Save errors
     std::vector<float> errors(numTotalNodes_);
 
     // Calculate temporal error for one brick at a time
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        unsigned int numBrickVals =
-            paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
-
-        // Save the individual voxel's average over timesteps. Because the
-        // BSTs are built by averaging leaf nodes, we only need to sample
-        // the brick at the correct coordinate.
-        std::vector<float> voxelAverages(numBrickVals);
-        std::vector<float> voxelStdDevs(numBrickVals);
-
-        // Read the whole brick to fill the averages
-        std::streampos offset = dataPosition() + static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(reinterpret_cast<char*>(&voxelAverages[0]),
-            static_cast<size_t>(numBrickVals)*sizeof(float));
-
-        // Build a list of the BST leaf bricks (within the same octree level) that
-        // this brick covers
-        std::list<unsigned int> coveredBricks = CoveredBSTLeafBricks(brick);
-
-        // If the brick is at the lowest BST level, automatically set the error 
-        // to -0.1 (enables using -1 as a marker for "no error accepted");
-        // Somewhat ad hoc to get around the fact that the error could be
-        // 0.0 higher up in the tree
-        if (coveredBricks.size() == 1) {
-            errors[brick] = -0.1f;
-        } else {
-            // Calculate standard deviation per voxel, average over brick
-            float avgStdDev = 0.f;
-            for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
-
-                float stdDev = 0.f;
-                for (auto leaf = coveredBricks.begin();
-                    leaf != coveredBricks.end(); ++leaf) {
-
-                    // Sample the leaves at the corresponding voxel position
-
-                    std::streampos offset = dataPosition() + static_cast<long long>((*leaf*numBrickVals + voxel)*sizeof(float));
-                    _file.seekg(offset);
-
-                    float sample;
-                    _file.read(reinterpret_cast<char*>(&sample), sizeof(float));
-
-                    stdDev += pow(sample - voxelAverages[voxel], 2.f);
+    bool success = processBricksInParallel(_filename, numBrickVals, numTotalNodes_, 1,
+        [&](BrickReader& reader, std::vector<float>& buffer,
+            unsigned int begin, unsigned int end)
+        {
+            // Save the individual voxel's average over timesteps. Because the
+            // BSTs are built by averaging leaf nodes, we only need to sample
+            // the brick at the correct coordinate.
+            std::vector<float> voxelAverages(numBrickVals);
+            std::vector<float> voxelSums(numBrickVals);
+
+            for (unsigned int brick = begin; brick < end; ++brick) {
+                // The BST leaf bricks (within the same octree level) that this
+                // brick covers
+                const BrickRange leaves = coveredBSTLeafBricks(brick);
+
+                // If the brick is at the lowest BST level, automatically set the error
+                // to -0.1 (enables using -1 as a marker for "no error accepted");
+                // Somewhat ad hoc to get around the fact that the error could be
+                // 0.0 higher up in the tree
+                if (leaves.count == 1) {
+                    errors[brick] = -0.1f;
+                    continue;
                 }
-                stdDev /= static_cast<float>(coveredBricks.size());
-                stdDev = sqrt(stdDev);
-
-                avgStdDev += stdDev;
-            } // for voxel
-
-            avgStdDev /= static_cast<float>(numBrickVals);
-            meanArray[brick] = avgStdDev;
-            errors[brick] = avgStdDev;
 
-        }
+                // Read the whole brick to fill the averages
+                if (!reader.read(brick, 1, voxelAverages))
+                    return false;
+
+                // Sample the leaves at the corresponding voxel positions, one whole
+                // leaf brick at a time
+                std::fill(voxelSums.begin(), voxelSums.end(), 0.f);
+                for (unsigned int i = 0; i < leaves.count; ++i) {
+                    if (!reader.read(leaves.first + i * leaves.stride, 1, buffer))
+                        return false;
+
+                    accumulateVoxelDeviations(
+                        buffer.data(),
+                        voxelAverages.data(),
+                        voxelSums.data(),
+                        numBrickVals
+                    );
+                }
 
-        /*
-        if (avgStdDev < minErr) {
-        minErr = avgStdDev;
-        } else if (avgStdDev > maxErr) {
-        maxErr = avgStdDev;
+                // Calculate standard deviation per voxel, average over brick
+                float avgStdDev = 0.f;
+                for (unsigned int voxel = 0; voxel < numBrickVals; ++voxel) {
+                    float stdDev = voxelSums[voxel] / static_cast<float>(leaves.count);
+                    avgStdDev += sqrt(stdDev);
+                }
+                avgStdDev /= static_cast<float>(numBrickVals);
+                errors[brick] = avgStdDev;
+            }
+            return true;
         }
-        */
-
-    } // for all bricks
-
-    std::sort(meanArray.begin(), meanArray.end());
-    //float medErr = meanArray[meanArray.size()/2];
-
-    /*
-    LDEBUG("\nMin temporal error: " << minErr);
-    LDEBUG("Max temporal error: " << maxErr);
-    LDEBUG("Median temporal error: " << medErr);
-    */
+    );
+    if (!success) {
+        LERROR("Could not read bricks from " << _filename);
+        return false;
+    }
 
     // Adjust errors using user-provided exponents
     float minNorm = 1e20f;
@@ -523,7 +576,6 @@ bool TSP::calculateTemporalError() {
         if (errors[i] > 0.f) {
             errors[i] = pow(errors[i], 0.25f);
         }
-        //data_[i*NUM_DATA + TEMPORAL_ERR] = *reinterpret_cast<int*>(&errors[i]);
         data_[i*NUM_DATA + TEMPORAL_ERR] = glm::floatBitsToInt(errors[i]);
         if (errors[i] < minNorm) {
             minNorm = errors[i];
@@ -533,7 +585,7 @@ bool TSP::calculateTemporalError() {
         }
     }
 
-    std::sort(errors.begin(), errors.end());
+    std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
     float medNorm = errors[errors.size() / 2];
 
     minTemporalError_ = minNorm;
@@ -674,82 +726,61 @@ bool TSP::isOctreeLeaf(unsigned int _brickIndex) {
 }
 
 
-std::list<unsigned int> TSP::CoveredLeafBricks(unsigned int _brickIndex) {
-    std::list<unsigned int> out;
-
-    // Find what octree skeleton node the index belongs to
-    unsigned int OTNode = _brickIndex % numOTNodes_;
-
-    // Find what BST node the index corresponds to using int division
-    unsigned int BSTNode = _brickIndex / numOTNodes_;
-    // Calculate BST offset (to translate to root octree)
-    unsigned int BSTOffset = BSTNode * numOTNodes_;
-
-    // Traverse root octree structure to leaves
-    // When visiting the leaves, translate back to correct BST level and save
-    std::queue<unsigned int> queue;
-    queue.push(OTNode);
-    do {
-
-        // Get front of queue and pop it
-        unsigned int toVisit = queue.front();
-        queue.pop();
-
-        // See if the node has children
-        int child = data_[toVisit*NUM_DATA + CHILD_INDEX];
-        if (child == -1) {
-            // Translate back and save
-            out.push_back(toVisit + BSTOffset);
-        }
-        else {
-            // Queue the eight children
-            for (int i = 0; i<8; ++i) {
-                queue.push(child + i);
-            }
-        }
-
-    } while (!queue.empty());
-
-    return out;
+unsigned int TSP::octreeDepth(unsigned int otNode) {
+    unsigned int depth = 0;
+    unsigned int levelSize = 1;
+    unsigned int nextLevelStart = 1;
+    while (otNode >= nextLevelStart) {
+        levelSize *= 8;
+        nextLevelStart += levelSize;
+        ++depth;
+    }
+    return depth;
 }
 
-std::list<unsigned int> TSP::CoveredBSTLeafBricks(unsigned int _brickIndex) {
-    std::list<unsigned int> out;
-
-    // Traverse the BST children until we are at root
-    std::queue<unsigned int> queue;
-    queue.push(_brickIndex);
-    do {
-
-        unsigned int toVisit = queue.front();
-        queue.pop();
-
-        bool BSTRoot = toVisit < numOTNodes_;
-        if (BSTRoot) {
-            if (numBSTLevels_ == 1) {
-                out.push_back(toVisit);
-            }
-            else {
-                queue.push(toVisit + numOTNodes_);
-                queue.push(toVisit + numOTNodes_ * 2);
-            }
-        }
-        else {
-            int child = data_[toVisit*NUM_DATA + CHILD_INDEX];
-            if (child == -1) {
-                // Save leaf brick to list
-                out.push_back(toVisit);
-            }
-            else {
-                // Queue children
-                queue.push(child);
-                queue.push(child + numOTNodes_);
-            }
-        }
-
-    } while (!queue.empty());
-
-    return out;
+unsigned int TSP::bstDepth(unsigned int bstNode) {
+    unsigned int depth = 0;
+    while (bstNode >= (2u << depth) - 1) {
+        ++depth;
+    }
+    return depth;
+}
+
+TSP::BrickRange TSP::coveredLeafBricks(unsigned int brickIndex) const {
+    // Find what octree skeleton node the index belongs to and the offset of its BST
+    // node, which is kept for the leaves
+    const unsigned int otNode = brickIndex % numOTNodes_;
+    const unsigned int bstOffset = brickIndex - otNode;
+
+    // The octree is stored level by level, so the leaves below a node form a
+    // contiguous range in the last level
+    const unsigned int depth = octreeDepth(otNode);
+    const unsigned int leafDepth = numOTLevels_ - 1;
+    const unsigned int firstInLevel = ((1u << (3 * depth)) - 1) / 7;
+    const unsigned int firstLeaf = ((1u << (3 * leafDepth)) - 1) / 7;
+    const unsigned int nLeaves = 1u << (3 * (leafDepth - depth));
+
+    return {
+        bstOffset + firstLeaf + (otNode - firstInLevel) * nLeaves,
+        nLeaves,
+        1
+    };
+}
+
+TSP::BrickRange TSP::coveredBSTLeafBricks(unsigned int brickIndex) const {
+    const unsigned int bstNode = brickIndex / numOTNodes_;
+    const unsigned int otNode = brickIndex % numOTNodes_;
+
+    // The BST is stored as an implicit binary heap, so the leaves below a node are
+    // consecutive BST nodes, each of them one full octree (numOTNodes_ bricks) apart
+    const unsigned int depth = bstDepth(bstNode);
+    const unsigned int leafDepth = numBSTLevels_ - 1;
+    const unsigned int firstInLevel = (1u << depth) - 1;
+    const unsigned int firstLeaf = (1u << leafDepth) - 1;
+    const unsigned int nLeaves = 1u << (leafDepth - depth);
+
+    const unsigned int firstLeafNode = firstLeaf + (bstNode - firstInLevel) * nLeaves;
+    return { firstLeafNode * numOTNodes_ + otNode, nLeaves, numOTNodes_ };
 }
 
 }
@@ -28,7 +28,6 @@
 // std includes
 #include <string>
 #include <vector>
-#include <list>
 #include <iostream>
 #include <fstream>
 
@@ -101,17 +100,28 @@ public:
     bool isOctreeLeaf(unsigned int _brickIndex);
 
 private:
-    // Returns a list of the octree leaf nodes that a given input 
-    // brick covers. If the input is already a leaf, the list will
-    // only contain that one index.
-    std::list<unsigned int> CoveredLeafBricks(unsigned int _brickIndex);
+    // A set of bricks that are laid out in the file with a constant distance between
+    // them, expressed in number of bricks
+    struct BrickRange {
+        unsigned int first;
+        unsigned int count;
+        unsigned int stride;
+    };
+
+    // Returns the range of octree leaf nodes that a given input brick covers. If the
+    // input is already a leaf, the range will only contain that one index. The leaves
+    // are contiguous in the file, so the stride is always 1
+    BrickRange coveredLeafBricks(unsigned int brickIndex) const;
+
+    // Returns the range of BST leaf nodes that a given input brick covers (at the same
+    // spatial subdivision level). The leaves are numOTNodes_ bricks apart in the file
+    BrickRange coveredBSTLeafBricks(unsigned int brickIndex) const;
 
-    // Returns a list of the BST leaf nodes that a given input brick
-    // covers (at the same spatial subdivision level).
-    std::list<unsigned int> CoveredBSTLeafBricks(unsigned int _brickIndex);
+    // Returns the depth of an octree node (the root being at depth 0)
+    static unsigned int octreeDepth(unsigned int otNode);
 
-    // Return a list of eight children brick incices given a brick index
-    std::list<unsigned int> ChildBricks(unsigned int _brickIndex);
+    // Returns the depth of a BST node (the root being at depth 0)
+    static unsigned int bstDepth(unsigned int bstNode);
 
     std::string _filename;
     std::ifstream _file;
@@ -48,9 +48,12 @@ NewHorizonsModule::NewHorizonsModule()
     : OpenSpaceModule("NewHorizons")
 {}
 
-void NewHorizonsModule::internalInitialize() {
+void NewHorizonsModule::internalPrepare() {
+    // The ImageSequencer is only used by this module's renderables
     ImageSequencer::initialize();
+}
 
+void NewHorizonsModule::internalInitialize() {
     FactoryManager::ref().addFactory(
         std::make_unique<ghoul::TemplateFactory<Decoder>>(),
         "Decoder"
@@ -34,6 +34,7 @@ public:
     NewHorizonsModule();
     
 protected:
+    void internalPrepare() override;
     void internalInitialize() override;
 };
 
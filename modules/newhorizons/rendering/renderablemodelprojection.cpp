@@ -114,6 +114,8 @@ bool RenderableModelProjection::isReady() const {
     ready &= (_programObject != nullptr);
     ready &= (_baseTexture != nullptr);
     ready &= (_projectionComponent.isReady());
+    // Projecting onto the placeholder would write into the wrong parts of the texture
+    ready &= (_geometry && _geometry->isLoaded());
     return ready;
 }
 
@@ -141,9 +143,8 @@ bool RenderableModelProjection::initialize() {
     completeSuccess &= loadTextures();
     completeSuccess &= _projectionComponent.initialize();
 
-    auto bs = getBoundingSphere();
+    // The geometry keeps the bounding sphere that was set in the constructor
     completeSuccess &= _geometry->initialize(this);
-    setBoundingSphere(bs); // ignore bounding sphere set by geometry.
 
     completeSuccess &= !_source.empty();
     completeSuccess &= !_destination.empty();
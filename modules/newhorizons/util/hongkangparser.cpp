@@ -116,6 +116,34 @@ bool HongKangParser::create() {
                << "please check modfile");
     }
 
+    // Everything besides the playbook itself that changes the decoded sequence
+    std::string information = _fileName + '|' + _spacecraft + '|' + _defaultCaptureImage;
+    for (const auto& p : _fileTranslation) {
+        InstrumentDecoder* decoder = static_cast<InstrumentDecoder*>(p.second.get());
+        information += p.first + '=' + decoder->getStopCommand() + ';';
+    }
+    information += describeTranslation(_fileTranslation);
+    for (const std::string& target : _potentialTargets) {
+        information += target + ',';
+    }
+    std::string cacheFile = cacheFilename(PlaybookIdentifierName + "_" + _name, information);
+
+    if (loadCache(cacheFile, { _fileName })) {
+        LINFO("Loaded decoded playbook '" << _fileName << "' from cache");
+    }
+    else {
+        bool success = parsePlaybook();
+        if (!success) {
+            return false;
+        }
+        saveCache(cacheFile, { _fileName });
+    }
+
+    sendPlaybookInformation(PlaybookIdentifierName);
+    return true;
+}
+
+bool HongKangParser::parsePlaybook() {
     if (size_t position = _fileName.find_last_of(".") + 1){
         if (position != std::string::npos){
             std::string extension = ghoul::filesystem::File(_fileName).fileExtension();
@@ -255,9 +283,6 @@ bool HongKangParser::create() {
             }
         }
     }
-
-
-    sendPlaybookInformation(PlaybookIdentifierName);
     return true;
 }
 
@@ -48,6 +48,8 @@ public:
     void findPlaybookSpecifiedTarget(std::string line, std::string& target);
 
 private:
+    bool parsePlaybook();
+
     double getMetFromET(double et);
     double getETfromMet(std::string timestr);
     double getETfromMet(double met);
@@ -34,6 +34,7 @@
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iterator>
 #include <iomanip>
@@ -136,6 +137,46 @@ std::string LabelParser::encode(std::string line) {
 }
 
 bool LabelParser::create() {
+    using RawPath = ghoul::filesystem::Directory::RawPath;
+    ghoul::filesystem::Directory sequenceDir(_fileName, RawPath::Yes);
+    if (!FileSys.directoryExists(sequenceDir)) {
+        LERROR("Could not load Label Directory '" << sequenceDir.path() << "'");
+        return false;
+    }
+    using Recursive = ghoul::filesystem::Directory::Recursive;
+    using Sort = ghoul::filesystem::Directory::Sort;
+    std::vector<std::string> sequencePaths = sequenceDir.read(Recursive::Yes, Sort::No);
+
+    // Besides the labels, the images next to them determine the decoded sequence, so
+    // every file in the directory is part of the cache key
+    std::vector<std::string> inputFiles = sequencePaths;
+    std::sort(inputFiles.begin(), inputFiles.end());
+
+    std::string information = _fileName + '|' + describeTranslation(_fileTranslation);
+    for (const std::string& spec : _specsOfInterest) {
+        information += spec + ',';
+    }
+    for (const std::string& ext : ghoul::io::TextureReader::ref().supportedExtensions()) {
+        information += ext + ',';
+    }
+    std::string cacheFile = cacheFilename(PlaybookIdentifierName + "_" + _name, information);
+
+    if (loadCache(cacheFile, inputFiles)) {
+        LINFO("Loaded decoded labels in '" << _fileName << "' from cache");
+    }
+    else {
+        bool success = parseLabels(sequencePaths);
+        if (!success) {
+            return false;
+        }
+        saveCache(cacheFile, inputFiles);
+    }
+
+    sendPlaybookInformation(PlaybookIdentifierName);
+    return true;
+}
+
+bool LabelParser::parseLabels(const std::vector<std::string>& sequencePaths) {
     auto imageComparer = [](const Image &a, const Image &b)->bool{
         return a.timeRange.start < b.timeRange.start;
     };
@@ -146,15 +187,6 @@ bool LabelParser::create() {
     std::string previousTarget;
     std::string lblName = "";
 
-    using RawPath = ghoul::filesystem::Directory::RawPath;
-    ghoul::filesystem::Directory sequenceDir(_fileName, RawPath::Yes);
-    if (!FileSys.directoryExists(sequenceDir)) {
-        LERROR("Could not load Label Directory '" << sequenceDir.path() << "'");
-        return false;
-    }
-    using Recursive = ghoul::filesystem::Directory::Recursive;
-    using Sort = ghoul::filesystem::Directory::Sort;
-    std::vector<std::string> sequencePaths = sequenceDir.read(Recursive::Yes, Sort::No);
     for (auto path : sequencePaths){
         if (size_t position = path.find_last_of(".") + 1){
             if (position != std::string::npos){
@@ -311,7 +343,6 @@ bool LabelParser::create() {
     //        myfile << std::endl;
     //    }
     }
-    sendPlaybookInformation(PlaybookIdentifierName);
     return true;
 }
 
@@ -46,6 +46,8 @@ public:
     //std::map<std::string, Decoder*> getTranslation() { return _fileTranslation; };
 
 private:
+    bool parseLabels(const std::vector<std::string>& sequencePaths);
+
     void createImage(Image& image,
                         double startTime,
                         double stopTime,
@@ -25,16 +25,136 @@
 #include <modules/newhorizons/util/sequenceparser.h>
 
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/util/memorymappedfile.h>
 #include <openspace/util/spicemanager.h>
 #include <modules/newhorizons/util/decoder.h>
 
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
 namespace {
     const std::string _loggerCat = "SequenceParser";
     const std::string keyTranslation = "DataInputTranslation";
 
     const std::string PlaybookIdentifierName = "Playbook";
+
+    // "SEQC" in little endian, followed by the version of the cache layout
+    const uint32_t CacheMagic = 0x43514553;
+    const uint32_t CurrentCacheVersion = 1;
+
+    struct FileStamp {
+        std::string path;
+        uint64_t size = 0;
+        int64_t modificationTime = 0;
+    };
+
+    FileStamp stampFile(const std::string& path) {
+        FileStamp stamp;
+        stamp.path = path;
+#ifdef WIN32
+        struct _stat64 s;
+        if (_stat64(path.c_str(), &s) == 0) {
+#else
+        struct stat s;
+        if (stat(path.c_str(), &s) == 0) {
+#endif
+            stamp.size = static_cast<uint64_t>(s.st_size);
+            stamp.modificationTime = static_cast<int64_t>(s.st_mtime);
+        }
+        return stamp;
+    }
+
+    class CacheWriter {
+    public:
+        template <typename T>
+        void write(T value) {
+            const char* p = reinterpret_cast<const char*>(&value);
+            _buffer.insert(_buffer.end(), p, p + sizeof(T));
+        }
+
+        void write(const std::string& value) {
+            write(static_cast<uint32_t>(value.size()));
+            _buffer.insert(_buffer.end(), value.begin(), value.end());
+        }
+
+        const std::vector<char>& buffer() const {
+            return _buffer;
+        }
+
+    private:
+        std::vector<char> _buffer;
+    };
+
+    // Reads values from a block of memory; reading past the end yields default values
+    // and marks the reader as bad instead of touching memory outside the block
+    class CacheReader {
+    public:
+        CacheReader(const char* data, size_t size)
+            : _current(data)
+            , _end(data + size)
+        {}
+
+        template <typename T>
+        T read() {
+            T value = T();
+            if (hasBytes(sizeof(T))) {
+                std::memcpy(&value, _current, sizeof(T));
+                _current += sizeof(T);
+            }
+            return value;
+        }
+
+        std::string readString() {
+            uint32_t length = read<uint32_t>();
+            if (!hasBytes(length)) {
+                return "";
+            }
+            std::string value(_current, length);
+            _current += length;
+            return value;
+        }
+
+        // Returns a number of elements that is guaranteed to fit into the remaining bytes
+        // if each element occupies at least minimumSize bytes
+        uint32_t readCount(size_t minimumSize) {
+            uint32_t count = read<uint32_t>();
+            if (count > static_cast<size_t>(_end - _current) / minimumSize) {
+                _isGood = false;
+                return 0;
+            }
+            return count;
+        }
+
+        bool isGood() const {
+            return _isGood;
+        }
+
+        bool isAtEnd() const {
+            return _current == _end;
+        }
+
+    private:
+        bool hasBytes(size_t n) {
+            if (!_isGood || static_cast<size_t>(_end - _current) < n) {
+                _isGood = false;
+                return false;
+            }
+            return true;
+        }
+
+        const char* _current;
+        const char* _end;
+        bool _isGood = true;
+    };
 }
 
 namespace openspace {
@@ -56,6 +176,225 @@ std::map<std::string, std::unique_ptr<Decoder>>& SequenceParser::getTranslation(
     return _fileTranslation;
 }
 
+bool SequenceParser::isLoadedFromCache() const {
+    return _isLoadedFromCache;
+}
+
+void SequenceParser::setCacheDirectory(std::string directory) {
+    _cacheDirectory = std::move(directory);
+}
+
+std::string SequenceParser::cacheFilename(const std::string& baseName,
+                                          const std::string& information) const
+{
+    if (!_cacheDirectory.empty()) {
+        // The file name is built from the same parts as by the cache manager
+        return FileSys.pathByAppendingComponent(
+            _cacheDirectory,
+            baseName + "_" + std::to_string(std::hash<std::string>()(information))
+        );
+    }
+    return FileSys.cacheManager()->cachedFilename(
+        baseName,
+        information,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+}
+
+std::string SequenceParser::describeTranslation(
+                          const std::map<std::string, std::unique_ptr<Decoder>>& translation)
+{
+    std::string result;
+    for (const auto& p : translation) {
+        result += p.first + '=' + p.second->getDecoderType() + ':';
+        for (const std::string& t : p.second->getTranslation()) {
+            result += t + ',';
+        }
+        result += ';';
+    }
+    return result;
+}
+
+bool SequenceParser::loadCache(const std::string& cacheFile,
+                               const std::vector<std::string>& inputFiles)
+{
+    _isLoadedFromCache = false;
+    if (!FileSys.fileExists(cacheFile)) {
+        return false;
+    }
+
+    std::unique_ptr<MemoryMappedFile> file;
+    try {
+        file = std::make_unique<MemoryMappedFile>(cacheFile);
+    }
+    catch (const MemoryMappedFile::MemoryMappedFileError& e) {
+        LWARNING("Could not map sequence cache '" << cacheFile << "': " << e.message);
+        return false;
+    }
+    CacheReader reader(file->data(), file->size());
+
+    if (reader.read<uint32_t>() != CacheMagic ||
+        reader.read<uint32_t>() != CurrentCacheVersion)
+    {
+        LDEBUG("Sequence cache '" << cacheFile << "' has an outdated format");
+        return false;
+    }
+
+    uint32_t nInputFiles = reader.readCount(sizeof(uint32_t));
+    if (nInputFiles != inputFiles.size()) {
+        LDEBUG("Sequence cache '" << cacheFile << "' was created from different files");
+        return false;
+    }
+    for (const std::string& path : inputFiles) {
+        FileStamp stamp = stampFile(path);
+        bool isSame = (reader.readString() == stamp.path);
+        isSame &= (reader.read<uint64_t>() == stamp.size);
+        isSame &= (reader.read<int64_t>() == stamp.modificationTime);
+        if (!isSame) {
+            LDEBUG("Sequence cache '" << cacheFile << "' is stale; '" << path <<
+                "' has changed");
+            return false;
+        }
+    }
+
+    std::map<std::string, ImageSubset> subsetMap;
+    uint32_t nSubsets = reader.readCount(sizeof(uint32_t));
+    for (uint32_t i = 0; i < nSubsets; ++i) {
+        std::string name = reader.readString();
+        ImageSubset& subset = subsetMap[name];
+        subset._range.start = reader.read<double>();
+        subset._range.end = reader.read<double>();
+
+        uint32_t nImages = reader.readCount(2 * sizeof(double));
+        subset._subset.resize(nImages);
+        for (Image& image : subset._subset) {
+            image.timeRange.start = reader.read<double>();
+            image.timeRange.end = reader.read<double>();
+            image.path = reader.readString();
+            uint32_t nInstruments = reader.readCount(sizeof(uint32_t));
+            image.activeInstruments.resize(nInstruments);
+            for (std::string& instrument : image.activeInstruments) {
+                instrument = reader.readString();
+            }
+            image.target = reader.readString();
+            image.isPlaceholder = (reader.read<uint8_t>() != 0);
+            image.projected = (reader.read<uint8_t>() != 0);
+        }
+    }
+
+    std::vector<std::pair<std::string, TimeRange>> instrumentTimes;
+    uint32_t nInstrumentTimes = reader.readCount(sizeof(uint32_t) + 2 * sizeof(double));
+    instrumentTimes.resize(nInstrumentTimes);
+    for (std::pair<std::string, TimeRange>& p : instrumentTimes) {
+        p.first = reader.readString();
+        p.second.start = reader.read<double>();
+        p.second.end = reader.read<double>();
+    }
+
+    std::vector<std::pair<double, std::string>> targetTimes;
+    uint32_t nTargetTimes = reader.readCount(sizeof(double) + sizeof(uint32_t));
+    targetTimes.resize(nTargetTimes);
+    for (std::pair<double, std::string>& p : targetTimes) {
+        p.first = reader.read<double>();
+        p.second = reader.readString();
+    }
+
+    std::vector<double> captureProgression;
+    uint32_t nCaptures = reader.readCount(sizeof(double));
+    captureProgression.resize(nCaptures);
+    for (double& d : captureProgression) {
+        d = reader.read<double>();
+    }
+
+    if (!reader.isGood() || !reader.isAtEnd()) {
+        LWARNING("Sequence cache '" << cacheFile << "' is corrupt");
+        return false;
+    }
+
+    _subsetMap = std::move(subsetMap);
+    _instrumentTimes = std::move(instrumentTimes);
+    _targetTimes = std::move(targetTimes);
+    _captureProgression = std::move(captureProgression);
+    _isLoadedFromCache = true;
+    return true;
+}
+
+void SequenceParser::saveCache(const std::string& cacheFile,
+                               const std::vector<std::string>& inputFiles) const
+{
+    CacheWriter writer;
+    writer.write(CacheMagic);
+    writer.write(CurrentCacheVersion);
+
+    writer.write(static_cast<uint32_t>(inputFiles.size()));
+    for (const std::string& path : inputFiles) {
+        FileStamp stamp = stampFile(path);
+        writer.write(stamp.path);
+        writer.write(stamp.size);
+        writer.write(stamp.modificationTime);
+    }
+
+    writer.write(static_cast<uint32_t>(_subsetMap.size()));
+    for (const std::pair<const std::string, ImageSubset>& p : _subsetMap) {
+        writer.write(p.first);
+        writer.write(p.second._range.start);
+        writer.write(p.second._range.end);
+
+        writer.write(static_cast<uint32_t>(p.second._subset.size()));
+        for (const Image& image : p.second._subset) {
+            writer.write(image.timeRange.start);
+            writer.write(image.timeRange.end);
+            writer.write(image.path);
+            writer.write(static_cast<uint32_t>(image.activeInstruments.size()));
+            for (const std::string& instrument : image.activeInstruments) {
+                writer.write(instrument);
+            }
+            writer.write(image.target);
+            writer.write(static_cast<uint8_t>(image.isPlaceholder));
+            writer.write(static_cast<uint8_t>(image.projected));
+        }
+    }
+
+    writer.write(static_cast<uint32_t>(_instrumentTimes.size()));
+    for (const std::pair<std::string, TimeRange>& p : _instrumentTimes) {
+        writer.write(p.first);
+        writer.write(p.second.start);
+        writer.write(p.second.end);
+    }
+
+    writer.write(static_cast<uint32_t>(_targetTimes.size()));
+    for (const std::pair<double, std::string>& p : _targetTimes) {
+        writer.write(p.first);
+        writer.write(p.second);
+    }
+
+    writer.write(static_cast<uint32_t>(_captureProgression.size()));
+    for (double d : _captureProgression) {
+        writer.write(d);
+    }
+
+    // Write into a temporary file first so that a crash can never leave a truncated
+    // cache file behind that would be mapped the next time
+    std::string temporaryFile = cacheFile + ".tmp";
+    {
+        std::ofstream file(temporaryFile, std::ofstream::binary);
+        if (!file.good()) {
+            LWARNING("Could not create sequence cache '" << cacheFile << "'");
+            return;
+        }
+        file.write(writer.buffer().data(), writer.buffer().size());
+        if (!file.good()) {
+            LWARNING("Could not write sequence cache '" << cacheFile << "'");
+            return;
+        }
+    }
+    std::remove(cacheFile.c_str());
+    if (std::rename(temporaryFile.c_str(), cacheFile.c_str()) != 0) {
+        LWARNING("Could not move sequence cache into place at '" << cacheFile << "'");
+        std::remove(temporaryFile.c_str());
+    }
+}
+
 template <typename T>
 void writeToBuffer(std::vector<char>& buffer, size_t& currentWriteLocation, T value) {
     if ((currentWriteLocation + sizeof(T)) > buffer.size())
@@ -60,9 +60,50 @@ public:
     std::map<std::string, std::unique_ptr<Decoder>>& getTranslation();
     virtual std::vector<double> getCaptureProgression() final;
 
+    /// Returns whether the last call to create was satisfied from the binary cache
+    bool isLoadedFromCache() const;
+
+    /**
+     * Stores the binary cache in the \p directory instead of the persistent cache of the
+     * file system's cache manager. An empty \p directory restores the default.
+     */
+    void setCacheDirectory(std::string directory);
+
 protected:
     void sendPlaybookInformation(const std::string& name);
 
+    /**
+     * Returns the path of the binary cache file for a sequence. The \p information has
+     * to contain everything besides the input files that influences the decoded result,
+     * such as the location of the input and the translation table.
+     */
+    std::string cacheFilename(const std::string& baseName,
+        const std::string& information) const;
+
+    /**
+     * Restores the decoded sequence (subset map, instrument times, target times, and
+     * capture progression) from the binary \p cacheFile. The cache is only used if it
+     * was written by the current cache version for exactly the \p inputFiles and none
+     * of them has changed its size or modification time since.
+     * \param cacheFile The path to the cache file
+     * \param inputFiles The files the sequence would otherwise be parsed from
+     * \return <code>true</code> if the cache was valid and has been loaded,
+     * <code>false</code> if the sequence has to be parsed from the input files
+     */
+    bool loadCache(const std::string& cacheFile,
+        const std::vector<std::string>& inputFiles);
+
+    /**
+     * Writes the decoded sequence into the binary \p cacheFile together with the sizes
+     * and modification times of the \p inputFiles it was parsed from.
+     */
+    void saveCache(const std::string& cacheFile,
+        const std::vector<std::string>& inputFiles) const;
+
+    /// Returns a textual description of the decoders in \p translation
+    static std::string describeTranslation(
+        const std::map<std::string, std::unique_ptr<Decoder>>& translation);
+
     std::map<std::string, ImageSubset> _subsetMap;
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
     std::vector<std::pair<double, std::string>> _targetTimes;
@@ -71,6 +112,9 @@ protected:
     std::map<std::string, std::unique_ptr<Decoder>> _fileTranslation;
 
     NetworkEngine::MessageIdentifier _messageIdentifier;
+
+    bool _isLoadedFromCache = false;
+    std::string _cacheDirectory;
 };
 
 } // namespace openspace
@@ -27,17 +27,26 @@
 
 #include <modules/onscreengui/include/guicomponent.h>
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace ghoul {
     class SharedMemory;
 }
 
 namespace openspace {
+
+namespace performance {
+    struct PerformanceLayout;
+}
+
 namespace gui {
 
 class GuiPerformanceComponent : public GuiComponent {
 public:
+    ~GuiPerformanceComponent();
+
     void render() override;
 
 protected:
@@ -46,6 +55,16 @@ protected:
     
     bool _sceneGraphIsEnabled = false;
     bool _functionsIsEnabled = false;
+    bool _frameTimeIsEnabled = false;
+
+    /// If this is <code>true</code>, the values in _frozenLayout are shown instead
+    bool _isFrozen = false;
+    std::unique_ptr<performance::PerformanceLayout> _frozenLayout;
+
+    /// The scene graph entries in sorted order as of frame _sortedFrame
+    std::vector<size_t> _sortedIndices;
+    uint32_t _sortedFrame = 0;
+    int _sortedSelection = -1;
 };
 
 } // namespace gui
@@ -26,7 +26,9 @@
 #define __GUIPROPERTYCOMPONENT_H__
 
 #include <modules/onscreengui/include/guicomponent.h>
+#include <modules/onscreengui/include/propertytree.h>
 
+#include <array>
 #include <functional>
 #include <string>
 #include <vector>
@@ -53,11 +55,27 @@ public:
     void render();
 
 protected:
-    void renderPropertyOwner(properties::PropertyOwner* owner);
-    void renderProperty(properties::Property* prop, properties::PropertyOwner* owner);
+    /**
+     * Renders the nodes in the range [begin, end) of the _tree. Top-level owners are
+     * shown as collapsing headers instead of tree nodes.
+     */
+    void renderNodes(int begin, int end, bool isTopLevel = false);
+
+    /// Renders a run of consecutive Property nodes, skipping the ones that are clipped
+    int renderProperties(int begin, int end);
+
+    void renderProperty(const PropertyTree::Node& node);
 
     std::string _name;
     SourceFunction _function;
+
+    PropertyTree _tree;
+    /// The height each Property row had when it was last rendered, indexed by node
+    std::vector<float> _rowHeights;
+
+    std::array<char, 256> _filterBuffer;
+    /// Set when the filter has changed so that all matching nodes are opened once
+    bool _isFilterChanged = false;
 };
 
 } // namespace gui
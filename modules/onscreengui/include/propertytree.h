@@ -0,0 +1,149 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __PROPERTYTREE_H__
+#define __PROPERTYTREE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+namespace properties {
+    class Property;
+    class PropertyOwner;
+}
+
+namespace gui {
+
+/**
+ * A flattened model of the Property hierarchy below a list of PropertyOwners, as it is
+ * shown by the GuiPropertyComponent. The PropertyOwners, groups, and Propertys are stored
+ * in depth-first order, so that the subtree of each node is the contiguous range of nodes
+ * following it and a collapsed subtree can be skipped without visiting it. The model is
+ * only rebuilt if the list of PropertyOwners changes or if any PropertyOwner has been
+ * structurally modified (see properties::PropertyOwner::structureVersion). A text filter
+ * can be applied that marks every node that, or whose subtree, matches the filter.
+ * This class does not depend on a GUI and can be used without a window.
+ */
+class PropertyTree {
+public:
+    /// The types of Property for which the GUI has a renderer
+    enum class PropertyType : uint8_t {
+        Bool = 0,
+        Int,
+        IVec2,
+        IVec3,
+        IVec4,
+        Float,
+        Vec2,
+        Vec3,
+        Vec4,
+        String,
+        Option,
+        Trigger,
+        Selection,
+        Unsupported
+    };
+
+    struct Node {
+        enum class Type : uint8_t {
+            Owner = 0,
+            Group,
+            Property
+        };
+
+        Type type;
+        /// Owners that are the only sub-owner of their parent are shown without a tree node
+        bool isInlined;
+        /// The type of the Property; only valid for Property nodes
+        PropertyType propertyType;
+        /// The index one past the last node in the subtree of this node
+        int end;
+        /// The PropertyOwner itself, or the PropertyOwner of the group or Property
+        properties::PropertyOwner* owner;
+        /// The Property of Property nodes, <code>nullptr</code> otherwise
+        properties::Property* property;
+        /// The name of the PropertyOwner, the group identifier, or the Property's GUI name
+        std::string name;
+    };
+
+    /**
+     * Returns the PropertyType for the <code>className</code> of a Property.
+     * \param className The class name as it is returned by properties::Property::className
+     * \return The PropertyType or PropertyType::Unsupported if the GUI cannot show it
+     */
+    static PropertyType propertyType(const std::string& className);
+
+    /**
+     * Rebuilds the model if \p owners is different from the list of the last call or if
+     * the structure of any PropertyOwner has changed since then. PropertyOwners without
+     * any Propertys in their subtree are not part of the model.
+     * \param owners The top-level PropertyOwners
+     * \return <code>true</code> if the model has been rebuilt, <code>false</code> if the
+     * cached model is still valid
+     */
+    bool update(const std::vector<properties::PropertyOwner*>& owners);
+
+    /**
+     * Sets the text that is searched for in the names of the PropertyOwners and groups
+     * and in the GUI names and fully qualified identifiers of the Propertys. The search
+     * is case-insensitive. If a PropertyOwner or group matches, its whole subtree is
+     * included. An empty filter includes all nodes.
+     * \param filter The text to search for
+     */
+    void setFilter(std::string filter);
+
+    /// Returns the current filter in lower case
+    const std::string& filter() const;
+
+    /// Returns all nodes in depth-first order
+    const std::vector<Node>& nodes() const;
+
+    /// Returns whether the node at \p index or any node in its subtree matches the filter
+    bool isIncluded(int index) const;
+
+    /// Returns the number of Property nodes that are included by the current filter
+    int nIncludedProperties() const;
+
+private:
+    void addOwner(properties::PropertyOwner* owner, bool isInlined);
+    void addNode(Node node, const std::string& searchText);
+    bool applyFilter(int begin, int end, bool isAncestorIncluded);
+
+    std::vector<properties::PropertyOwner*> _owners;
+    uint64_t _structureVersion = 0;
+    bool _isBuilt = false;
+
+    std::vector<Node> _nodes;
+    /// The lower case text that the filter is matched against, one for each node
+    std::vector<std::string> _searchTexts;
+    std::vector<bool> _isIncluded;
+    std::string _filter;
+};
+
+} // namespace gui
+} // namespace openspace
+
+#endif // __PROPERTYTREE_H__
@@ -29,17 +29,25 @@
 #include <openspace/performance/performancemanager.h>
 #include <openspace/rendering/renderengine.h>
 
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/sharedmemory.h>
 
 #include <imgui.h>
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <array>
+#include <fstream>
 #include <numeric>
 
 namespace {
     const std::string _loggerCat = "GuiPerformanceComponent";
 
+    const std::string CsvFile = "${BASE_PATH}/PerformanceMeasurements.csv";
+
+    const int NumberHistogramBins = 32;
+
     enum class Sorting {
         NoSorting = -1,
         UpdateEphemeris = 0,
@@ -47,32 +55,145 @@ namespace {
         Render = 2,
         Total = 3
     };
+
+    using openspace::performance::PerformanceLayout;
+
+    // Plots the window of the series in the order in which the values were added. All
+    // statistics are precomputed by the producer, so this is constant time except for
+    // the plotting itself
+    void plotSeries(const std::string& name, const PerformanceLayout::Series& series) {
+        const int n = series.nValues();
+        if (n < 2) {
+            // ImGui needs at least two values to plot a line
+            ImGui::Text("%s: No measurements", name.c_str());
+            return;
+        }
+
+        std::string label = fmt::format(
+            "{}\nAverage: {:.2f}us\nP95/P99: {:.2f}us/{:.2f}us",
+            name,
+            series.average(),
+            series.percentile(95.f),
+            series.percentile(99.f)
+        );
+        std::string overlay = fmt::format("{:.2f}us", series.latest());
+
+        ImGui::PlotLines(
+            label.c_str(),
+            series.values,
+            n,
+            // Once the window is full, the oldest value is located at the head of the
+            // ring buffer, before that the values start at 0 and head == n
+            series.head % n,
+            overlay.c_str(),
+            series.minimum(),
+            series.maximum(),
+            ImVec2(0, 40)
+        );
+    }
+
+    float sortingKey(const PerformanceLayout::SceneGraphPerformanceLayout& entry,
+                     Sorting sorting)
+    {
+        switch (sorting) {
+            case Sorting::UpdateEphemeris:
+                return entry.updateEphemeris.average();
+            case Sorting::UpdateRender:
+                return entry.updateRenderable.average();
+            case Sorting::Render:
+                return entry.renderTime.average();
+            case Sorting::Total:
+                return entry.updateEphemeris.average() +
+                    entry.updateRenderable.average() + entry.renderTime.average();
+            default:
+                return 0.f;
+        }
+    }
 }
 
 namespace openspace {
 namespace gui {
 
+// The destructor has to be defined here as PerformanceLayout is incomplete in the header
+GuiPerformanceComponent::~GuiPerformanceComponent() {}
+
 void GuiPerformanceComponent::render() {
     using ghoul::SharedMemory;
     using namespace performance;
 
     ImGui::Begin("Performance", &_isEnabled);
     if (OsEng.renderEngine().doesPerformanceMeasurements()) {
-        PerformanceLayout* layout = OsEng.renderEngine().performanceManager()->performanceData();
+        PerformanceLayout* liveLayout =
+            OsEng.renderEngine().performanceManager()->performanceData();
 
         ImGui::Checkbox("SceneGraph", &_sceneGraphIsEnabled);
         ImGui::Checkbox("Functions", &_functionsIsEnabled);
+        ImGui::Checkbox("Frame time", &_frameTimeIsEnabled);
         
         ImGui::Spacing();
         
         if (ImGui::Button("Reset measurements")) {
             OsEng.renderEngine().performanceManager()->resetPerformanceMeasurements();
         }
+
+        // Freezing keeps a copy of the layout at that point in time so that the values
+        // can be inspected without them moving underneath the cursor
+        if (ImGui::Checkbox("Freeze", &_isFrozen) && _isFrozen) {
+            if (!_frozenLayout) {
+                _frozenLayout = std::make_unique<PerformanceLayout>();
+            }
+            *_frozenLayout = *liveLayout;
+        }
+        const PerformanceLayout* layout = _isFrozen ? _frozenLayout.get() : liveLayout;
+
+        if (ImGui::Button("Save window to CSV")) {
+            std::string file = absPath(CsvFile);
+            std::ofstream stream(file);
+            if (stream.good()) {
+                layout->writeCsv(stream);
+                LINFO("Saved performance measurements to '" << file << "'");
+            }
+            else {
+                LERROR("Could not open file '" << file << "' for writing");
+            }
+        }
+
+        if (_frameTimeIsEnabled) {
+            ImGui::Begin("Frame time", &_frameTimeIsEnabled);
+
+            const PerformanceLayout::Series& frameTime = layout->frameTime;
+            plotSeries("Frame time", frameTime);
+
+            ImGui::Text(
+                "Min: %.2fus  Max: %.2fus",
+                frameTime.minimum(),
+                frameTime.maximum()
+            );
+
+            std::array<float, NumberHistogramBins> bins;
+            frameTime.histogram(bins.data(), NumberHistogramBins);
+            ImGui::PlotHistogram(
+                fmt::format(
+                    "Histogram\n{:.2f}us - {:.2f}us",
+                    frameTime.minimum(),
+                    frameTime.maximum()
+                ).c_str(),
+                bins.data(),
+                NumberHistogramBins,
+                0,
+                nullptr,
+                0.f,
+                static_cast<float>(std::max(frameTime.nValues(), 1)),
+                ImVec2(0, 80)
+            );
+
+            ImGui::End();
+        }
         
         if (_sceneGraphIsEnabled) {
             ImGui::Begin("SceneGraph", &_sceneGraphIsEnabled);
         
-            // The indices correspond to the index into the average array further below
+            // The indices correspond to the Sorting enum
             ImGui::Text("Sorting");
             ImGui::RadioButton(
                 "No Sorting",
@@ -100,186 +221,50 @@ void GuiPerformanceComponent::render() {
                 static_cast<int>(Sorting::Total)
             );
 
-            // Later, we will sort this indices list instead of the real values for
-            // performance reasons
-            std::vector<size_t> indices(layout->nScaleGraphEntries);
-            std::iota(indices.begin(), indices.end(), 0);
-
-            // Ordering:
-            // updateEphemeris
-            // UpdateRender
-            // RenderTime
-            std::vector<std::array<float, 3>> averages(
-                layout->nScaleGraphEntries,
-                { 0.f, 0.f, 0.f }
-            );
-            
-            std::vector<std::array<std::pair<float, float>, 3>> minMax(
-                layout->nScaleGraphEntries
-            );
-            
-            for (int i = 0; i < layout->nScaleGraphEntries; ++i) {
-                const PerformanceLayout::SceneGraphPerformanceLayout& entry =
-                    layout->sceneGraphEntries[i];
-
-                int nValues[3] = { 0, 0, 0 };
-                
-                // Compute the averages and count the number of values so we don't divide
-                // by 0 later
-                for (int j = 0; j < PerformanceLayout::NumberValues; ++j) {
-                    averages[i][0] += entry.updateEphemeris[j];
-                    if (entry.updateEphemeris[j] != 0.f)
-                        ++(nValues[0]);
-                    averages[i][1] += entry.updateRenderable[j];
-                    if (entry.updateRenderable[j] != 0.f)
-                        ++(nValues[1]);
-                    averages[i][2] += entry.renderTime[j];
-                    if (entry.renderTime[j] != 0.f)
-                        ++(nValues[2]);
-                }
-
-                if (nValues[0] != 0)
-                    averages[i][0] /= static_cast<float>(nValues[0]);
-                if (nValues[1] != 0)
-                    averages[i][1] /= static_cast<float>(nValues[1]);
-                if (nValues[2] != 0)
-                    averages[i][2] /= static_cast<float>(nValues[2]);
-                
-                // Get the minimum/maximum values for each of the components so that we
-                // can scale the plot by these numbers
-                auto minmaxEphemeris = std::minmax_element(
-                    std::begin(entry.updateEphemeris),
-                    std::end(entry.updateEphemeris)
-                );
-                minMax[i][0] = std::make_pair(
-                    *(minmaxEphemeris.first),
-                    *(minmaxEphemeris.second)
-                );
-                
-                auto minmaxUpdateRenderable = std::minmax_element(
-                    std::begin(entry.updateRenderable),
-                    std::end(entry.updateRenderable)
-                );
-                minMax[i][1] = std::make_pair(
-                    *(minmaxUpdateRenderable.first),
-                    *(minmaxUpdateRenderable.second)
-                );
-
-                auto minmaxRendering = std::minmax_element(
-                    std::begin(entry.renderTime),
-                    std::end(entry.renderTime)
-                );
-                minMax[i][2] = std::make_pair(
-                    *(minmaxRendering.first),
-                    *(minmaxRendering.second)
-                );
-                
-
-            }
-            
-            // If we don't want to sort, we will leave the indices list alone, thus
-            // leaving them in the regular ordering
-            Sorting selection = Sorting(_sortingSelection);
-            if (selection != Sorting::NoSorting) {
-                std::function<bool(size_t, size_t)> sortFunc;
-
-                if (selection == Sorting::Total) {
-                    // If we do want to sort totally, we need to sum all the averages and
-                    // use that as the criterion
-                    sortFunc = [&averages](size_t a, size_t b) {
-                        float sumA = std::accumulate(
-                            std::begin(averages[a]),
-                            std::end(averages[a]),
-                            0.f
-                        );
-
-                        float sumB = std::accumulate(
-                            std::begin(averages[b]),
-                            std::end(averages[b]),
-                            0.f
-                        );
-
-                        return sumA > sumB;
-                    };
-                }
-                else {
-                    // otherwise we use the sorting index
-                    int sel = _sortingSelection;
-                    sortFunc = [sel, &averages](size_t a, size_t b) {
-                        return averages[a][sel] > averages[b][sel];
-                    };
+            // We sort an indices list instead of the real values and only redo this if
+            // new values have been stored or the sorting criterion changed
+            const size_t nEntries = static_cast<size_t>(layout->nScaleGraphEntries);
+            const bool needsSorting = _sortedIndices.size() != nEntries ||
+                _sortedFrame != layout->nFrames ||
+                _sortedSelection != _sortingSelection;
+
+            if (needsSorting) {
+                _sortedIndices.resize(nEntries);
+                std::iota(_sortedIndices.begin(), _sortedIndices.end(), 0);
+
+                // If we don't want to sort, we will leave the indices list alone, thus
+                // leaving them in the regular ordering
+                Sorting selection = Sorting(_sortingSelection);
+                if (selection != Sorting::NoSorting) {
+                    std::vector<float> keys(nEntries);
+                    for (size_t i = 0; i < nEntries; ++i) {
+                        keys[i] = sortingKey(layout->sceneGraphEntries[i], selection);
+                    }
+
+                    std::sort(
+                        _sortedIndices.begin(),
+                        _sortedIndices.end(),
+                        [&keys](size_t a, size_t b) { return keys[a] > keys[b]; }
+                    );
                 }
 
-                std::sort(
-                    indices.begin(),
-                    indices.end(),
-                    sortFunc
-                );
+                _sortedFrame = layout->nFrames;
+                _sortedSelection = _sortingSelection;
             }
 
-            for (int i = 0; i < layout->nScaleGraphEntries; ++i) {
+            for (size_t i : _sortedIndices) {
                 // We are using the indices list as an additional level of indirection
                 // into the respective values so that the list will be sorted by whatever
                 // criterion we selected previously
-
                 const PerformanceLayout::SceneGraphPerformanceLayout& entry =
-                    layout->sceneGraphEntries[indices[i]];
+                    layout->sceneGraphEntries[i];
 
                 if (ImGui::CollapsingHeader(entry.name)) {
-
-                    std::string updateEphemerisTime = std::to_string(
-                        entry.updateEphemeris[PerformanceLayout::NumberValues - 1]
-                    ) + "us";
-
-                    ImGui::PlotLines(
-                        fmt::format(
-                            "UpdateEphemeris\nAverage: {}us",
-                            averages[indices[i]][0]
-                        ).c_str(),
-                        &entry.updateEphemeris[0],
-                        PerformanceLayout::NumberValues,
-                        0,
-                        updateEphemerisTime.c_str(),
-                        minMax[indices[i]][0].first,
-                        minMax[indices[i]][0].second,
-                        ImVec2(0, 40)
-                    );
-
-                    std::string updateRenderableTime = std::to_string(
-                        entry.updateRenderable[PerformanceLayout::NumberValues - 1]
-                    ) + "us";
-
-                    ImGui::PlotLines(
-                        fmt::format(
-                            "UpdateRender\nAverage: {}us",
-                            averages[indices[i]][1]
-                        ).c_str(),
-                        &entry.updateRenderable[0],
-                        PerformanceLayout::NumberValues,
-                        0,
-                        updateRenderableTime.c_str(),
-                        minMax[indices[i]][1].first,
-                        minMax[indices[i]][1].second,
-                        ImVec2(0, 40)
-                    );
-
-                    std::string renderTime = std::to_string(
-                        entry.renderTime[PerformanceLayout::NumberValues - 1]
-                    ) + "us";
-
-                    ImGui::PlotLines(
-                        fmt::format(
-                            "RenderTime\nAverage: {}us",
-                            averages[indices[i]][2]
-                        ).c_str(),
-                        &entry.renderTime[0],
-                        PerformanceLayout::NumberValues,
-                        0,
-                        renderTime.c_str(),
-                        minMax[indices[i]][2].first,
-                        minMax[indices[i]][2].second,
-                        ImVec2(0, 40)
-                    );
+                    ImGui::PushID(entry.name);
+                    plotSeries("UpdateEphemeris", entry.updateEphemeris);
+                    plotSeries("UpdateRender", entry.updateRenderable);
+                    plotSeries("RenderTime", entry.renderTime);
+                    ImGui::PopID();
                 }
             }
             ImGui::End();
@@ -287,42 +272,11 @@ void GuiPerformanceComponent::render() {
         
         if (_functionsIsEnabled) {
             ImGui::Begin("Functions", &_functionsIsEnabled);
-            using namespace performance;
             
             for (int i = 0; i < layout->nFunctionEntries; ++i) {
                 const PerformanceLayout::FunctionPerformanceLayout& entry =
                     layout->functionEntries[i];
-                
-                float avg = 0.f;
-                int count = 0;
-                for (int j = 0; j < PerformanceLayout::NumberValues; ++j) {
-                    avg += layout->functionEntries[i].time[j];
-                    if (layout->functionEntries[i].time[j] != 0.f)
-                        ++count;
-                }
-                avg /= count;
-                
-                auto minmax = std::minmax_element(
-                    std::begin(layout->functionEntries[i].time),
-                    std::end(layout->functionEntries[i].time)
-                );
-                
-                const PerformanceLayout::FunctionPerformanceLayout& f =
-                    layout->functionEntries[i];
-                
-                std::string renderTime = std::to_string(
-                    entry.time[PerformanceLayout::NumberValues - 1]
-                ) + "us";
-                ImGui::PlotLines(
-                    fmt::format("{}\nAverage: {}us", entry.name, avg).c_str(),
-                    &entry.time[0],
-                    PerformanceLayout::NumberValues,
-                    0,
-                    renderTime.c_str(),
-                    *(minmax.first),
-                    *(minmax.second),
-                    ImVec2(0, 40)
-                );
+                plotSeries(entry.name, entry.time);
             }
             ImGui::End();
         }
@@ -30,6 +30,8 @@
 
 #include "imgui.h"
 
+#include <algorithm>
+
 namespace {
     const std::string _loggerCat = "GuiPropertyComponent";
     const ImVec2 size = ImVec2(350, 500);
@@ -40,60 +42,109 @@ namespace gui {
 
 GuiPropertyComponent::GuiPropertyComponent(std::string name) 
     : _name(std::move(name))
-{}
+{
+    _filterBuffer.fill('\0');
+}
 
 void GuiPropertyComponent::setSource(SourceFunction function) {
     _function = std::move(function);
 }
 
-void GuiPropertyComponent::renderPropertyOwner(properties::PropertyOwner* owner) {
-    ImGui::PushID(owner->name().c_str());
-    const auto& subOwners = owner->propertySubOwners();
-    for (properties::PropertyOwner* subOwner : subOwners) {
-        if (subOwners.size() == 1) {
-            renderPropertyOwner(subOwner);
-        }
-        else {
-            if (ImGui::TreeNode(subOwner->name().c_str())) {
-                renderPropertyOwner(subOwner);
-                ImGui::TreePop();
-            }
+void GuiPropertyComponent::renderNodes(int begin, int end, bool isTopLevel) {
+    const std::vector<PropertyTree::Node>& nodes = _tree.nodes();
+
+    int i = begin;
+    while (i < end) {
+        const PropertyTree::Node& node = nodes[i];
+        if (!_tree.isIncluded(i)) {
+            i = node.end;
+            continue;
         }
-    }
 
-    ImGui::Spacing();
+        // Open every node that leads to a match once when the filter changes
+        bool hasTreeNode = (node.type == PropertyTree::Node::Type::Group) ||
+            (node.type == PropertyTree::Node::Type::Owner && !node.isInlined);
+        if (hasTreeNode && _isFilterChanged && !_tree.filter().empty()) {
+            ImGui::SetNextTreeNodeOpened(true, ImGuiSetCond_Always);
+        }
 
-    using Properties = std::vector<properties::Property*>;
-    std::map<std::string, Properties> propertiesByGroup;
-    Properties remainingProperies;
+        switch (node.type) {
+            case PropertyTree::Node::Type::Owner: {
+                bool isOpen = true;
+                if (isTopLevel) {
+                    // Create a header in case we have multiple owners
+                    isOpen = ImGui::CollapsingHeader(node.name.c_str());
+                }
+                else if (!node.isInlined) {
+                    isOpen = ImGui::TreeNode(node.name.c_str());
+                }
 
-    for (properties::Property* p : owner->properties()) {
-        std::string group = p->groupIdentifier();
-        if (group.empty()) {
-            remainingProperies.push_back(p);
-        }
-        else {
-            propertiesByGroup[group].push_back(p);
+                if (isOpen) {
+                    ImGui::PushID(node.name.c_str());
+                    renderNodes(i + 1, node.end);
+                    ImGui::Spacing();
+                    ImGui::PopID();
+                    if (!isTopLevel && !node.isInlined) {
+                        ImGui::TreePop();
+                    }
+                }
+                i = node.end;
+                break;
+            }
+            case PropertyTree::Node::Type::Group:
+                if (ImGui::TreeNode(node.name.c_str())) {
+                    renderProperties(i + 1, node.end);
+                    ImGui::TreePop();
+                }
+                i = node.end;
+                break;
+            case PropertyTree::Node::Type::Property:
+                i = renderProperties(i, end);
+                break;
         }
     }
+}
 
-    for (const std::pair<std::string, Properties>& p : propertiesByGroup) {
-        if (ImGui::TreeNode(p.first.c_str())) {
-            for (properties::Property* prop : p.second) {
-                renderProperty(prop, owner);
-            }
-            ImGui::TreePop();
+int GuiPropertyComponent::renderProperties(int begin, int end) {
+    const std::vector<PropertyTree::Node>& nodes = _tree.nodes();
+    const float itemSpacing = ImGui::GetStyle().ItemSpacing.y;
+
+    // Rows that are outside of the visible region are not rendered; instead, the
+    // height they had when they were last visible is skipped in a single invisible item
+    float skippedHeight = 0.f;
+    auto flushSkipped = [&skippedHeight, itemSpacing](int index) {
+        if (skippedHeight > 0.f) {
+            ImGui::PushID(index);
+            ImGui::InvisibleButton(
+                "##clipped",
+                ImVec2(1.f, std::max(skippedHeight - itemSpacing, 1.f))
+            );
+            ImGui::PopID();
+            skippedHeight = 0.f;
         }
-    }
+    };
 
-    ImGui::Spacing();
+    int i = begin;
+    for (; i < end && nodes[i].type == PropertyTree::Node::Type::Property; ++i) {
+        const PropertyTree::Node& node = nodes[i];
+        if (!_tree.isIncluded(i) || !node.property->isVisible()) {
+            continue;
+        }
 
-    for (properties::Property* prop : remainingProperies) {
-        if (prop->isVisible()) {
-            renderProperty(prop, owner);
+        float& height = _rowHeights[i];
+        ImVec2 rowSize(1.f, height > 0.f ? height : ImGui::GetTextLineHeightWithSpacing());
+        if (height > 0.f && ImGui::IsRectClipped(rowSize)) {
+            skippedHeight += height;
+            continue;
         }
+
+        flushSkipped(i);
+        float before = ImGui::GetCursorPosY();
+        renderProperty(node);
+        height = ImGui::GetCursorPosY() - before;
     }
-    ImGui::PopID();
+    flushSkipped(i);
+    return i;
 }
 
 void GuiPropertyComponent::render() {
@@ -102,55 +153,58 @@ void GuiPropertyComponent::render() {
     ImGui::Spacing();
 
     if (_function) {
-        const std::vector<properties::PropertyOwner*>& owners = _function();
+        if (_tree.update(_function())) {
+            _rowHeights.assign(_tree.nodes().size(), 0.f);
+        }
 
-        for (properties::PropertyOwner* pOwner : owners) {
-            if (pOwner->propertiesRecursive().empty())
-                continue;
+        std::string previousFilter = _tree.filter();
+        ImGui::InputText("Filter", _filterBuffer.data(), _filterBuffer.size());
+        _tree.setFilter(_filterBuffer.data());
+        _isFilterChanged = (_tree.filter() != previousFilter);
+        ImGui::Spacing();
 
-            auto header = [&]() -> bool {
-                if (owners.size() > 1) {
-                    // Create a header in case we have multiple owners
-                    return ImGui::CollapsingHeader(pOwner->name().c_str());
-                }
-                else {
-                    // Otherwise, do nothing
-                    ImGui::Text(pOwner->name().c_str());
-                    ImGui::Spacing();
-                    return true;
-                }
-            };
+        const std::vector<PropertyTree::Node>& nodes = _tree.nodes();
+        int nTopLevel = 0;
+        for (int i = 0; i < static_cast<int>(nodes.size()); i = nodes[i].end) {
+            ++nTopLevel;
+        }
 
-            if (header()) {
-                renderPropertyOwner(pOwner);
-            }
+        if (nTopLevel == 1) {
+            ImGui::Text(nodes[0].name.c_str());
+            ImGui::Spacing();
+            ImGui::PushID(nodes[0].name.c_str());
+            renderNodes(1, nodes[0].end);
+            ImGui::PopID();
+        }
+        else {
+            renderNodes(0, static_cast<int>(nodes.size()), true);
         }
     }
 
     ImGui::End();
 }
 
-void GuiPropertyComponent::renderProperty(properties::Property* prop, properties::PropertyOwner* owner)     {
-    using Func = std::function<void(properties::Property*, const std::string&)>;
-    static std::map<std::string, Func> FunctionMapping = {
-        { "BoolProperty", &renderBoolProperty },
-        { "IntProperty", &renderIntProperty },
-        { "IVec2Property", &renderIVec2Property },
-        { "IVec3Property", &renderIVec3Property },
-        { "IVec4Property", &renderIVec4Property },
-        { "FloatProperty", &renderFloatProperty },
-        { "Vec2Property", &renderVec2Property },
-        { "Vec3Property", &renderVec3Property },
-        { "Vec4Property", &renderVec4Property },
-        { "StringProperty", &renderStringProperty },
-        { "OptionProperty", &renderOptionProperty },
-        { "TriggerProperty", &renderTriggerProperty },
-        { "SelectionProperty", &renderSelectionProperty }
+void GuiPropertyComponent::renderProperty(const PropertyTree::Node& node) {
+    using Func = void(*)(properties::Property*, const std::string&);
+    // Indexed by PropertyTree::PropertyType
+    static const std::array<Func, 13> Renderers = {
+        &renderBoolProperty,
+        &renderIntProperty,
+        &renderIVec2Property,
+        &renderIVec3Property,
+        &renderIVec4Property,
+        &renderFloatProperty,
+        &renderVec2Property,
+        &renderVec3Property,
+        &renderVec4Property,
+        &renderStringProperty,
+        &renderOptionProperty,
+        &renderTriggerProperty,
+        &renderSelectionProperty
     };
 
-    auto it = FunctionMapping.find(prop->className());
-    if (it != FunctionMapping.end()) {
-        it->second(prop, owner->name());
+    if (node.propertyType != PropertyTree::PropertyType::Unsupported) {
+        Renderers[static_cast<int>(node.propertyType)](node.property, node.owner->name());
     }
 }
 
@@ -0,0 +1,214 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <modules/onscreengui/include/propertytree.h>
+
+#include <openspace/properties/propertyowner.h>
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <unordered_map>
+
+namespace {
+    std::string toLower(std::string s) {
+        std::transform(
+            s.begin(),
+            s.end(),
+            s.begin(),
+            [](char c) { return static_cast<char>(std::tolower(c)); }
+        );
+        return s;
+    }
+}
+
+namespace openspace {
+namespace gui {
+
+PropertyTree::PropertyType PropertyTree::propertyType(const std::string& className) {
+    static const std::unordered_map<std::string, PropertyType> Types = {
+        { "BoolProperty", PropertyType::Bool },
+        { "IntProperty", PropertyType::Int },
+        { "IVec2Property", PropertyType::IVec2 },
+        { "IVec3Property", PropertyType::IVec3 },
+        { "IVec4Property", PropertyType::IVec4 },
+        { "FloatProperty", PropertyType::Float },
+        { "Vec2Property", PropertyType::Vec2 },
+        { "Vec3Property", PropertyType::Vec3 },
+        { "Vec4Property", PropertyType::Vec4 },
+        { "StringProperty", PropertyType::String },
+        { "OptionProperty", PropertyType::Option },
+        { "TriggerProperty", PropertyType::Trigger },
+        { "SelectionProperty", PropertyType::Selection }
+    };
+
+    auto it = Types.find(className);
+    if (it != Types.end()) {
+        return it->second;
+    }
+    else {
+        return PropertyType::Unsupported;
+    }
+}
+
+bool PropertyTree::update(const std::vector<properties::PropertyOwner*>& owners) {
+    uint64_t version = properties::PropertyOwner::structureVersion();
+    if (_isBuilt && version == _structureVersion && owners == _owners) {
+        return false;
+    }
+
+    _owners = owners;
+    _structureVersion = version;
+    _nodes.clear();
+    _searchTexts.clear();
+
+    for (properties::PropertyOwner* owner : owners) {
+        if (owner->propertiesRecursive().empty()) {
+            continue;
+        }
+        addOwner(owner, false);
+    }
+
+    _isIncluded.assign(_nodes.size(), true);
+    applyFilter(0, static_cast<int>(_nodes.size()), false);
+    _isBuilt = true;
+    return true;
+}
+
+void PropertyTree::addOwner(properties::PropertyOwner* owner, bool isInlined) {
+    int index = static_cast<int>(_nodes.size());
+    addNode(
+        { Node::Type::Owner, isInlined, PropertyType::Unsupported, 0, owner, nullptr,
+          owner->name() },
+        owner->name()
+    );
+
+    const std::vector<properties::PropertyOwner*>& subOwners = owner->propertySubOwners();
+    for (properties::PropertyOwner* subOwner : subOwners) {
+        addOwner(subOwner, subOwners.size() == 1);
+    }
+
+    using Properties = std::vector<properties::Property*>;
+    std::map<std::string, Properties> propertiesByGroup;
+    Properties remainingProperties;
+    for (properties::Property* p : owner->properties()) {
+        std::string group = p->groupIdentifier();
+        if (group.empty()) {
+            remainingProperties.push_back(p);
+        }
+        else {
+            propertiesByGroup[group].push_back(p);
+        }
+    }
+
+    auto addProperty = [this, owner](properties::Property* p) {
+        std::string guiName = p->guiName();
+        addNode(
+            { Node::Type::Property, false, propertyType(p->className()), 0, owner, p,
+              guiName },
+            guiName + ' ' + p->fullyQualifiedIdentifier()
+        );
+    };
+
+    for (const std::pair<std::string, Properties>& p : propertiesByGroup) {
+        int groupIndex = static_cast<int>(_nodes.size());
+        addNode(
+            { Node::Type::Group, false, PropertyType::Unsupported, 0, owner, nullptr,
+              p.first },
+            p.first
+        );
+        for (properties::Property* prop : p.second) {
+            addProperty(prop);
+        }
+        _nodes[groupIndex].end = static_cast<int>(_nodes.size());
+    }
+
+    for (properties::Property* prop : remainingProperties) {
+        addProperty(prop);
+    }
+
+    _nodes[index].end = static_cast<int>(_nodes.size());
+}
+
+void PropertyTree::addNode(Node node, const std::string& searchText) {
+    node.end = static_cast<int>(_nodes.size()) + 1;
+    _nodes.push_back(std::move(node));
+    _searchTexts.push_back(toLower(searchText));
+}
+
+void PropertyTree::setFilter(std::string filter) {
+    filter = toLower(std::move(filter));
+    if (filter == _filter) {
+        return;
+    }
+    _filter = std::move(filter);
+    applyFilter(0, static_cast<int>(_nodes.size()), false);
+}
+
+bool PropertyTree::applyFilter(int begin, int end, bool isAncestorIncluded) {
+    bool isAnyIncluded = false;
+    int i = begin;
+    while (i < end) {
+        const Node& node = _nodes[i];
+        bool isMatching = isAncestorIncluded || _filter.empty() ||
+            _searchTexts[i].find(_filter) != std::string::npos;
+
+        bool isIncluded = isMatching;
+        if (node.end > i + 1) {
+            // Descendants have to be visited even if this node matches, as they inherit
+            // the match
+            bool isChildIncluded = applyFilter(i + 1, node.end, isMatching);
+            isIncluded |= isChildIncluded;
+        }
+
+        _isIncluded[i] = isIncluded;
+        isAnyIncluded |= isIncluded;
+        i = node.end;
+    }
+    return isAnyIncluded;
+}
+
+const std::string& PropertyTree::filter() const {
+    return _filter;
+}
+
+const std::vector<PropertyTree::Node>& PropertyTree::nodes() const {
+    return _nodes;
+}
+
+bool PropertyTree::isIncluded(int index) const {
+    return _isIncluded[index];
+}
+
+int PropertyTree::nIncludedProperties() const {
+    int result = 0;
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        if (_nodes[i].type == Node::Type::Property && _isIncluded[i]) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+} // namespace gui
+} // namespace openspace
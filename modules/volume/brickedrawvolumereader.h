@@ -0,0 +1,78 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __BRICKEDRAWVOLUMEREADER_H__
+#define __BRICKEDRAWVOLUMEREADER_H__
+
+#include <modules/volume/brickedvolumelayout.h>
+#include <modules/volume/rawvolume.h>
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <memory>
+#include <string>
+
+namespace openspace {
+
+/**
+ * Reads volumes that were written by RawVolumeWriter::writeBricked. The file is mapped
+ * into memory, so reading a sub-region or a downsampled level only touches the bricks
+ * that are needed for it.
+ */
+template <typename Voxel>
+class BrickedRawVolumeReader {
+public:
+    typedef Voxel VoxelType;
+
+    /**
+     * \throw MemoryMappedFile::MemoryMappedFileError If the file could not be mapped or
+     * is not a bricked volume with the VoxelType of this reader
+     */
+    BrickedRawVolumeReader(const std::string& path);
+
+    int nLevels() const;
+    glm::ivec3 dimensions(int level = 0) const;
+    const BrickedVolumeLayout& layout() const;
+
+    VoxelType get(const glm::ivec3& coordinates, int level = 0) const;
+
+    /// Reads a full level of detail
+    std::unique_ptr<RawVolume<VoxelType>> read(int level = 0) const;
+
+    /// Reads the voxels in [min, max) of the specified level of detail
+    std::unique_ptr<RawVolume<VoxelType>> readRegion(const glm::ivec3& min,
+        const glm::ivec3& max, int level = 0) const;
+
+private:
+    static BrickedVolumeLayout::Header readHeader(const MemoryMappedFile& file);
+
+    MemoryMappedFile _file;
+    BrickedVolumeLayout _layout;
+};
+
+} // namespace openspace
+
+#include "brickedrawvolumereader.inl"
+
+#endif // __BRICKEDRAWVOLUMEREADER_H__
@@ -0,0 +1,177 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+
+#include <cstring>
+
+namespace openspace {
+
+template <typename VoxelType>
+BrickedRawVolumeReader<VoxelType>::BrickedRawVolumeReader(const std::string& path)
+    : _file(path)
+    , _layout(readHeader(_file))
+{
+    if (_file.size() < _layout.fileSize()) {
+        throw MemoryMappedFile::MemoryMappedFileError(
+            "Bricked volume '" + path + "' is truncated"
+        );
+    }
+}
+
+template <typename VoxelType>
+BrickedVolumeLayout::Header BrickedRawVolumeReader<VoxelType>::readHeader(
+                                                            const MemoryMappedFile& file)
+{
+    BrickedVolumeLayout::Header header;
+    if (file.size() < sizeof(header)) {
+        throw MemoryMappedFile::MemoryMappedFileError(
+            "File '" + file.filename() + "' is too small to be a bricked volume"
+        );
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != BrickedVolumeLayout::Magic) {
+        throw MemoryMappedFile::MemoryMappedFileError(
+            "File '" + file.filename() + "' is not a bricked volume"
+        );
+    }
+    if (header.version != BrickedVolumeLayout::CurrentVersion) {
+        throw MemoryMappedFile::MemoryMappedFileError(
+            "Bricked volume '" + file.filename() + "' has unsupported version " +
+            std::to_string(header.version)
+        );
+    }
+    if (header.voxelSize != sizeof(VoxelType)) {
+        throw MemoryMappedFile::MemoryMappedFileError(
+            "Voxel size of bricked volume '" + file.filename() + "' does not match"
+        );
+    }
+    return header;
+}
+
+template <typename VoxelType>
+int BrickedRawVolumeReader<VoxelType>::nLevels() const {
+    return _layout.nLevels();
+}
+
+template <typename VoxelType>
+glm::ivec3 BrickedRawVolumeReader<VoxelType>::dimensions(int level) const {
+    return _layout.dimensions(level);
+}
+
+template <typename VoxelType>
+const BrickedVolumeLayout& BrickedRawVolumeReader<VoxelType>::layout() const {
+    return _layout;
+}
+
+template <typename VoxelType>
+VoxelType BrickedRawVolumeReader<VoxelType>::get(const glm::ivec3& coordinates,
+                                                 int level) const
+{
+    ghoul_assert(level >= 0 && level < nLevels(), "Level out of range");
+    const int brickSize = _layout.brickSize();
+    const glm::ivec3 brick = coordinates / brickSize;
+    const glm::ivec3 inBrick = coordinates - brick * brickSize;
+
+    const size_t voxel = (static_cast<size_t>(inBrick.z) * brickSize + inBrick.y) *
+        brickSize + inBrick.x;
+
+    VoxelType value;
+    std::memcpy(
+        &value,
+        _file.data() + _layout.brickOffset(level, brick) + voxel * sizeof(VoxelType),
+        sizeof(VoxelType)
+    );
+    return value;
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>> BrickedRawVolumeReader<VoxelType>::read(
+                                                                      int level) const
+{
+    return readRegion(glm::ivec3(0), dimensions(level), level);
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>> BrickedRawVolumeReader<VoxelType>::readRegion(
+                                                                const glm::ivec3& min,
+                                                                const glm::ivec3& max,
+                                                                int level) const
+{
+    ghoul_assert(level >= 0 && level < nLevels(), "Level out of range");
+    ghoul_assert(
+        glm::all(glm::lessThanEqual(glm::ivec3(0), min)) &&
+        glm::all(glm::lessThanEqual(min, max)) &&
+        glm::all(glm::lessThanEqual(max, dimensions(level))),
+        "Region must be inside the volume"
+    );
+
+    const glm::ivec3 regionSize = max - min;
+    std::unique_ptr<RawVolume<VoxelType>> volume =
+        std::make_unique<RawVolume<VoxelType>>(regionSize);
+    if (glm::any(glm::equal(regionSize, glm::ivec3(0)))) {
+        return volume;
+    }
+
+    const int brickSize = _layout.brickSize();
+    const glm::ivec3 firstBrick = min / brickSize;
+    const glm::ivec3 lastBrick = (max - glm::ivec3(1)) / brickSize;
+
+    VoxelType* target = volume->data();
+
+    // Copy each brick's overlap with the region one row at a time
+    for (int bz = firstBrick.z; bz <= lastBrick.z; ++bz) {
+        for (int by = firstBrick.y; by <= lastBrick.y; ++by) {
+            for (int bx = firstBrick.x; bx <= lastBrick.x; ++bx) {
+                const glm::ivec3 brick(bx, by, bz);
+                const glm::ivec3 brickMin = brick * brickSize;
+                const glm::ivec3 from = glm::max(min, brickMin);
+                const glm::ivec3 to = glm::min(max, brickMin + glm::ivec3(brickSize));
+                const size_t rowLength = static_cast<size_t>(to.x - from.x);
+
+                const char* brickData = _file.data() + _layout.brickOffset(level, brick);
+                for (int z = from.z; z < to.z; ++z) {
+                    for (int y = from.y; y < to.y; ++y) {
+                        const size_t source = (static_cast<size_t>(z - brickMin.z) *
+                            brickSize + (y - brickMin.y)) * brickSize +
+                            (from.x - brickMin.x);
+                        const size_t destination = (static_cast<size_t>(z - min.z) *
+                            regionSize.y + (y - min.y)) * regionSize.x +
+                            (from.x - min.x);
+
+                        std::memcpy(
+                            target + destination,
+                            brickData + source * sizeof(VoxelType),
+                            rowLength * sizeof(VoxelType)
+                        );
+                    }
+                }
+            }
+        }
+    }
+    return volume;
+}
+
+} // namespace openspace
@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/brickedvolumelayout.h>
+
+#include <modules/volume/volumeutils.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace openspace {
+
+BrickedVolumeLayout::BrickedVolumeLayout(const glm::ivec3& dimensions, int brickSize,
+                                         size_t voxelSize)
+    : _dimensions(dimensions)
+    , _brickSize(brickSize)
+    , _voxelSize(voxelSize)
+{
+    ghoul_assert(brickSize > 0, "Brick size must be positive");
+    computeLayout();
+}
+
+BrickedVolumeLayout::BrickedVolumeLayout(const Header& header)
+    : _dimensions(header.dimensions[0], header.dimensions[1], header.dimensions[2])
+    , _brickSize(header.brickSize)
+    , _voxelSize(header.voxelSize)
+{
+    ghoul_assert(_brickSize > 0, "Brick size must be positive");
+    computeLayout();
+}
+
+void BrickedVolumeLayout::computeLayout() {
+    size_t offset = sizeof(Header);
+    glm::ivec3 dims = _dimensions;
+    while (true) {
+        Level level;
+        level.dimensions = dims;
+        level.nBricks = (dims + glm::ivec3(_brickSize - 1)) / _brickSize;
+        level.offset = offset;
+
+        // Sort the bricks by their Morton code to get the file order
+        const size_t nBricks = static_cast<size_t>(level.nBricks.x) *
+            level.nBricks.y * level.nBricks.z;
+        std::vector<uint32_t> order(nBricks);
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<uint64_t> codes(nBricks);
+        for (size_t i = 0; i < nBricks; ++i) {
+            codes[i] = volumeutils::mortonEncode(glm::uvec3(
+                i % level.nBricks.x,
+                (i / level.nBricks.x) % level.nBricks.y,
+                i / level.nBricks.x / level.nBricks.y
+            ));
+        }
+        std::sort(order.begin(), order.end(), [&codes](uint32_t a, uint32_t b) {
+            return codes[a] < codes[b];
+        });
+        level.slots.resize(nBricks);
+        for (size_t slot = 0; slot < nBricks; ++slot) {
+            level.slots[order[slot]] = static_cast<uint32_t>(slot);
+        }
+
+        offset += nBricks * bytesPerBrick();
+        _levels.push_back(std::move(level));
+
+        if (nBricks == 1) {
+            break;
+        }
+        dims = glm::max((dims + glm::ivec3(1)) / 2, glm::ivec3(1));
+    }
+}
+
+BrickedVolumeLayout::Header BrickedVolumeLayout::header() const {
+    Header h;
+    h.magic = Magic;
+    h.version = CurrentVersion;
+    h.voxelSize = static_cast<uint32_t>(_voxelSize);
+    h.brickSize = static_cast<uint32_t>(_brickSize);
+    h.dimensions[0] = _dimensions.x;
+    h.dimensions[1] = _dimensions.y;
+    h.dimensions[2] = _dimensions.z;
+    h.nLevels = static_cast<uint32_t>(_levels.size());
+    return h;
+}
+
+int BrickedVolumeLayout::nLevels() const {
+    return static_cast<int>(_levels.size());
+}
+
+int BrickedVolumeLayout::brickSize() const {
+    return _brickSize;
+}
+
+size_t BrickedVolumeLayout::voxelsPerBrick() const {
+    return static_cast<size_t>(_brickSize) * _brickSize * _brickSize;
+}
+
+size_t BrickedVolumeLayout::bytesPerBrick() const {
+    return voxelsPerBrick() * _voxelSize;
+}
+
+glm::ivec3 BrickedVolumeLayout::dimensions(int level) const {
+    return _levels[level].dimensions;
+}
+
+glm::ivec3 BrickedVolumeLayout::nBricks(int level) const {
+    return _levels[level].nBricks;
+}
+
+size_t BrickedVolumeLayout::brickOffset(int level, const glm::ivec3& brick) const {
+    const Level& l = _levels[level];
+    const size_t index = (static_cast<size_t>(brick.z) * l.nBricks.y + brick.y) *
+        l.nBricks.x + brick.x;
+    return l.offset + l.slots[index] * bytesPerBrick();
+}
+
+std::vector<glm::ivec3> BrickedVolumeLayout::bricksInFileOrder(int level) const {
+    const Level& l = _levels[level];
+    std::vector<glm::ivec3> bricks(l.slots.size());
+    for (size_t i = 0; i < l.slots.size(); ++i) {
+        bricks[l.slots[i]] = glm::ivec3(
+            i % l.nBricks.x,
+            (i / l.nBricks.x) % l.nBricks.y,
+            i / l.nBricks.x / l.nBricks.y
+        );
+    }
+    return bricks;
+}
+
+size_t BrickedVolumeLayout::fileSize() const {
+    const Level& last = _levels.back();
+    return last.offset + last.slots.size() * bytesPerBrick();
+}
+
+} // namespace openspace
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __BRICKEDVOLUMELAYOUT_H__
+#define __BRICKEDVOLUMELAYOUT_H__
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Describes the on-disk layout of a bricked raw volume. The file starts with a Header,
+ * followed by one section per level of detail. Level 0 is the full resolution volume,
+ * every following level halves the resolution until the level fits into a single
+ * brick. Each level is split into cubic bricks of brickSize^3 voxels that are stored in
+ * Morton (Z-order) of their brick coordinates; the voxels inside a brick are stored
+ * x-major like a linear raw volume. Bricks on the upper borders are padded to the full
+ * brick size, so that every brick has the same size on disk.
+ */
+class BrickedVolumeLayout {
+public:
+    static const uint32_t Magic = 0x4B435242; // "BRCK"
+    static const uint32_t CurrentVersion = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t voxelSize;
+        uint32_t brickSize;
+        int32_t dimensions[3];
+        uint32_t nLevels;
+    };
+
+    BrickedVolumeLayout(const glm::ivec3& dimensions, int brickSize, size_t voxelSize);
+    explicit BrickedVolumeLayout(const Header& header);
+
+    Header header() const;
+
+    int nLevels() const;
+    int brickSize() const;
+    size_t voxelsPerBrick() const;
+    size_t bytesPerBrick() const;
+
+    glm::ivec3 dimensions(int level) const;
+    glm::ivec3 nBricks(int level) const;
+
+    /// Returns the byte offset in the file of the brick at the brick coordinates
+    size_t brickOffset(int level, const glm::ivec3& brick) const;
+
+    /// Returns the brick coordinates of all bricks in the level in file order
+    std::vector<glm::ivec3> bricksInFileOrder(int level) const;
+
+    /// Returns the total size of the file in bytes
+    size_t fileSize() const;
+
+private:
+    void computeLayout();
+
+    glm::ivec3 _dimensions;
+    int _brickSize;
+    size_t _voxelSize;
+
+    struct Level {
+        glm::ivec3 dimensions;
+        glm::ivec3 nBricks;
+        size_t offset;
+        // Position in file order of each brick, indexed by linear brick index
+        std::vector<uint32_t> slots;
+    };
+    std::vector<Level> _levels;
+};
+
+} // namespace openspace
+
+#endif // __BRICKEDVOLUMELAYOUT_H__
@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MAPPEDRAWVOLUME_H__
+#define __MAPPEDRAWVOLUME_H__
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+
+namespace openspace {
+
+/**
+ * A view of a linear raw volume file that is mapped into memory instead of being read.
+ * Only the parts of the file that are accessed are loaded from disk. The voxels can be
+ * modified through data(), but the changes are never written back to the file.
+ */
+template <typename Voxel>
+class MappedRawVolume {
+public:
+    typedef Voxel VoxelType;
+    MappedRawVolume(const std::string& path, const glm::ivec3& dimensions);
+    glm::ivec3 dimensions() const;
+    VoxelType get(const glm::ivec3& coordinates) const;
+    VoxelType get(size_t index) const;
+    VoxelType* data();
+    const VoxelType* data() const;
+private:
+    size_t coordsToIndex(const glm::ivec3& cartesian) const;
+    glm::ivec3 _dimensions;
+    MemoryMappedFile _file;
+};
+
+} // namespace openspace
+
+#include "mappedrawvolume.inl"
+
+#endif // __MAPPEDRAWVOLUME_H__
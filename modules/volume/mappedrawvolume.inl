@@ -0,0 +1,83 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/volumeutils.h>
+
+#include <ghoul/misc/assert.h>
+
+namespace openspace {
+
+template <typename VoxelType>
+MappedRawVolume<VoxelType>::MappedRawVolume(const std::string& path,
+                                            const glm::ivec3& dimensions)
+    : _dimensions(dimensions)
+    , _file(path, MemoryMappedFile::Access::CopyOnWrite)
+{
+    const size_t length = static_cast<size_t>(dimensions.x) *
+        static_cast<size_t>(dimensions.y) *
+        static_cast<size_t>(dimensions.z) *
+        sizeof(VoxelType);
+
+    if (_file.size() < length) {
+        throw MemoryMappedFile::MemoryMappedFileError(
+            "File '" + path + "' is smaller than the volume dimensions require"
+        );
+    }
+}
+
+template <typename VoxelType>
+glm::ivec3 MappedRawVolume<VoxelType>::dimensions() const {
+    return _dimensions;
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(const glm::ivec3& coordinates) const {
+    return get(coordsToIndex(coordinates));
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(size_t index) const {
+    ghoul_assert(
+        (index + 1) * sizeof(VoxelType) <= _file.size(),
+        "Index must be inside the volume"
+    );
+    return data()[index];
+}
+
+template <typename VoxelType>
+VoxelType* MappedRawVolume<VoxelType>::data() {
+    return reinterpret_cast<VoxelType*>(_file.data());
+}
+
+template <typename VoxelType>
+const VoxelType* MappedRawVolume<VoxelType>::data() const {
+    return reinterpret_cast<const VoxelType*>(_file.data());
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::coordsToIndex(const glm::ivec3& cartesian) const {
+    return volumeutils::coordsToIndex(cartesian, dimensions());
+}
+
+} // namespace openspace
@@ -40,6 +40,7 @@ public:
     void set(size_t index, const VoxelType& value);
     void forEachVoxel(const std::function<void(const glm::ivec3&, const VoxelType&)>& fn);
     VoxelType* data();
+    const VoxelType* data() const;
 private:
     size_t coordsToIndex(const glm::ivec3& cartesian) const;
     glm::ivec3 indexToCoords(size_t linear) const;
@@ -48,7 +48,7 @@ void RawVolume<VoxelType>::setDimensions(const glm::ivec3& dimensions) {
 
 template <typename VoxelType>
 VoxelType RawVolume<VoxelType>::get(const glm::ivec3& coordinates) const {
-    return get(coordsToIndex(coordinates, dimensions()));
+    return get(coordsToIndex(coordinates));
 }
 
 template <typename VoxelType>
@@ -58,7 +58,7 @@ VoxelType RawVolume<VoxelType>::get(size_t index) const {
 
 template <typename VoxelType>
 void RawVolume<VoxelType>::set(const glm::ivec3& coordinates, const VoxelType& value) {
-    return set(coordsToIndex(coordinates, dimensions()), value);
+    return set(coordsToIndex(coordinates), value);
 }
 
 template <typename VoxelType>
@@ -96,5 +96,10 @@ template <typename VoxelType>
 VoxelType* RawVolume<VoxelType>::data() {
     return _data.data();
 }
+
+template <typename VoxelType>
+const VoxelType* RawVolume<VoxelType>::data() const {
+    return _data.data();
+}
     
 }
@@ -26,7 +26,9 @@
 #define __RAWVOLUMEREADER_H__
 
 #include <functional>
+#include <memory>
 #include <modules/volume/rawvolume.h>
+#include <modules/volume/mappedrawvolume.h>
 
 namespace openspace {
 
@@ -39,14 +41,18 @@ public:
     std::string path() const;
     void setPath(const std::string& path);
     void setDimensions(const glm::ivec3& dimensions);
-    //VoxelType get(const glm::ivec3& coordinates) const; // TODO: Implement this
-    //VoxelType get(const size_t index) const; // TODO: Implement this
+    // Random access into the file; the file is mapped into memory on first access
+    VoxelType get(const glm::ivec3& coordinates) const;
+    VoxelType get(const size_t index) const;
     std::unique_ptr<RawVolume<VoxelType>> read();
+    // Returns a view of the file that is mapped into memory instead of being read
+    std::unique_ptr<MappedRawVolume<VoxelType>> map() const;
 private:
     size_t coordsToIndex(const glm::ivec3& cartesian) const;
     glm::ivec3 indexToCoords(size_t linear) const;
     glm::ivec3 _dimensions;
     std::string _path;
+    mutable std::unique_ptr<MappedRawVolume<VoxelType>> _mappedVolume;
 };
 
 }
@@ -16,6 +16,7 @@ glm::ivec3 RawVolumeReader<VoxelType>::dimensions() const {
 template <typename VoxelType>
 void RawVolumeReader<VoxelType>::setDimensions(const glm::ivec3& dimensions) {
     _dimensions = dimensions;
+    _mappedVolume = nullptr;
 }
 
 template <typename VoxelType>
@@ -26,21 +27,26 @@ std::string RawVolumeReader<VoxelType>::path() const {
 template <typename VoxelType>
 void RawVolumeReader<VoxelType>::setPath(const std::string& path) {
     _path = path;
+    _mappedVolume = nullptr;
 }
 
-
-/*
-TODO: Implement these methods for random access in raw volume file
 template <typename VoxelType>
 VoxelType RawVolumeReader<VoxelType>::get(const glm::ivec3& coordinates) const {
-    return get(coordsToIndex(coordinates, dimensions()));
+    return get(coordsToIndex(coordinates));
 }
 
 template <typename VoxelType>
 VoxelType RawVolumeReader<VoxelType>::get(size_t index) const {
-    // TODO: read from specific position.
-    return VoxelType();
-}*/
+    if (!_mappedVolume) {
+        _mappedVolume = map();
+    }
+    return _mappedVolume->get(index);
+}
+
+template <typename VoxelType>
+std::unique_ptr<MappedRawVolume<VoxelType>> RawVolumeReader<VoxelType>::map() const {
+    return std::make_unique<MappedRawVolume<VoxelType>>(_path, dimensions());
+}
 
 template <typename VoxelType>
 size_t RawVolumeReader<VoxelType>::coordsToIndex(const glm::ivec3& cartesian) const {
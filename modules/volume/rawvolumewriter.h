@@ -18,6 +18,13 @@ public:
                const std::function<void(float t)>& onProgress = [](float t) {});
     void write(const RawVolume<VoxelType>& volume);
 
+    /**
+     * Writes the volume in the bricked layout described by BrickedVolumeLayout, including
+     * all downsampled levels of detail. The result can be read with
+     * BrickedRawVolumeReader.
+     */
+    void writeBricked(const RawVolume<VoxelType>& volume, int brickSize = 32);
+
     size_t coordsToIndex(const glm::ivec3& coords) const;
     glm::ivec3 indexToCoords(size_t linear) const;
 private:
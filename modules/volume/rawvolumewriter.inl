@@ -1,4 +1,5 @@
 #include <fstream>
+#include <modules/volume/brickedvolumelayout.h>
 #include <modules/volume/volumeutils.h>
 
 namespace openspace {
@@ -63,9 +64,9 @@ void RawVolumeWriter<VoxelType>::write(const std::function<VoxelType(const glm::
 template <typename VoxelType>    
 void RawVolumeWriter<VoxelType>::write(const RawVolume<VoxelType>& volume) {
     glm::ivec3 dims = dimensions();
-    ghoul_assert(dims == volume.dims(), "Dimensions of input and output volume must agree");
+    ghoul_assert(dims == volume.dimensions(), "Dimensions of input and output volume must agree");
 
-    const char* buffer = reinterpret_cast<char*>(volume.data());
+    const char* buffer = reinterpret_cast<const char*>(volume.data());
     size_t length = static_cast<size_t>(dims.x) *
         static_cast<size_t>(dims.y) *
         static_cast<size_t>(dims.z) *
@@ -76,5 +77,84 @@ void RawVolumeWriter<VoxelType>::write(const RawVolume<VoxelType>& volume) {
     file.close();
 }
 
-    
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::writeBricked(const RawVolume<VoxelType>& volume,
+                                              int brickSize)
+{
+    glm::ivec3 dims = dimensions();
+    ghoul_assert(dims == volume.dimensions(), "Dimensions of input and output volume must agree");
+
+    BrickedVolumeLayout layout(dims, brickSize, sizeof(VoxelType));
+
+    std::ofstream file(_path, std::ios::binary);
+    BrickedVolumeLayout::Header header = layout.header();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<VoxelType> brick(layout.voxelsPerBrick());
+
+    // Each level is created by averaging 2x2x2 voxels of the previous level
+    std::unique_ptr<RawVolume<VoxelType>> downsampled;
+    const RawVolume<VoxelType>* current = &volume;
+    for (int level = 0; level < layout.nLevels(); ++level) {
+        const glm::ivec3 levelDims = layout.dimensions(level);
+        if (level > 0) {
+            const glm::ivec3 previousDims = current->dimensions();
+            auto next = std::make_unique<RawVolume<VoxelType>>(levelDims);
+            for (int z = 0; z < levelDims.z; ++z) {
+                for (int y = 0; y < levelDims.y; ++y) {
+                    for (int x = 0; x < levelDims.x; ++x) {
+                        const glm::ivec3 from = glm::ivec3(x, y, z) * 2;
+                        const glm::ivec3 to = glm::min(from + glm::ivec3(2), previousDims);
+                        // Accumulated in double so that integer voxels do not overflow
+                        double sum = 0.0;
+                        int n = 0;
+                        for (int k = from.z; k < to.z; ++k) {
+                            for (int j = from.y; j < to.y; ++j) {
+                                for (int i = from.x; i < to.x; ++i) {
+                                    sum += current->get(glm::ivec3(i, j, k));
+                                    ++n;
+                                }
+                            }
+                        }
+                        next->set(
+                            glm::ivec3(x, y, z),
+                            static_cast<VoxelType>(sum / static_cast<double>(n))
+                        );
+                    }
+                }
+            }
+            downsampled = std::move(next);
+            current = downsampled.get();
+        }
+
+        for (const glm::ivec3& b : layout.bricksInFileOrder(level)) {
+            const glm::ivec3 brickMin = b * brickSize;
+            const glm::ivec3 brickMax = glm::min(brickMin + glm::ivec3(brickSize), levelDims);
+
+            // Voxels outside of the volume are left as zero padding
+            std::fill(brick.begin(), brick.end(), VoxelType(0));
+            for (int z = brickMin.z; z < brickMax.z; ++z) {
+                for (int y = brickMin.y; y < brickMax.y; ++y) {
+                    const size_t source = volumeutils::coordsToIndex(
+                        glm::ivec3(brickMin.x, y, z),
+                        levelDims
+                    );
+                    const size_t destination = (static_cast<size_t>(z - brickMin.z) *
+                        brickSize + (y - brickMin.y)) * brickSize;
+                    std::copy(
+                        current->data() + source,
+                        current->data() + source + (brickMax.x - brickMin.x),
+                        brick.begin() + destination
+                    );
+                }
+            }
+            file.write(
+                reinterpret_cast<const char*>(brick.data()),
+                brick.size() * sizeof(VoxelType)
+            );
+        }
+    }
+    file.close();
+}
+
 }
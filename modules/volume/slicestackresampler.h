@@ -0,0 +1,86 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __SLICESTACKRESAMPLER_H__
+#define __SLICESTACKRESAMPLER_H__
+
+#include <modules/volume/rawvolume.h>
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace openspace {
+
+/**
+ * Resamples a stack of 2D slices into a linear raw volume file of a different
+ * resolution, using the same filtering as VolumeSampler. The output is produced in
+ * z-slabs (one output slice each) that are sampled in parallel. The input slices are
+ * loaded ahead of the workers on a separate thread and only the slices inside the
+ * filter footprint of the slabs that are in flight are kept in memory. Finished slabs
+ * are written to the output file in order.
+ */
+template <typename Voxel>
+class SliceStackResampler {
+public:
+    typedef Voxel VoxelType;
+
+    /**
+     * Loads the slice with the given index as a volume with a depth of 1. The loader is
+     * only ever called from a single thread, in increasing slice order.
+     */
+    using SliceLoader =
+        std::function<std::unique_ptr<RawVolume<VoxelType>>(size_t sliceIndex)>;
+
+    struct Statistics {
+        double seconds;
+        size_t nVoxelsWritten;
+        size_t nSlicesLoaded;
+        int nThreads;
+    };
+
+    SliceStackResampler(SliceLoader loader, const glm::ivec2& sliceDimensions,
+        size_t nSlices, const glm::ivec3& outDimensions);
+
+    /**
+     * Resamples the slice stack into the file at outFilename.
+     * \param nThreads The number of sampling threads; 0 uses all hardware threads
+     * \param onProgress Called with the fraction of the output that has been written
+     */
+    Statistics resample(const std::string& outFilename, int nThreads = 0,
+        const std::function<void(float)>& onProgress = [](float) {});
+
+private:
+    SliceLoader _loader;
+    glm::ivec3 _inDimensions;
+    glm::ivec3 _outDimensions;
+};
+
+} // namespace openspace
+
+#include "slicestackresampler.inl"
+
+#endif // __SLICESTACKRESAMPLER_H__
@@ -0,0 +1,268 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014 - 2016                                                             *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/volumesampler.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+namespace slicestackresampler_internal {
+
+// A volume made up of the slices in [first, first + slices.size()) of a larger stack.
+// It satisfies the interface that VolumeSampler requires, so that the sampling code is
+// inlined instead of going through a std::function per voxel
+template <typename Voxel>
+class SliceWindow {
+public:
+    typedef Voxel VoxelType;
+
+    SliceWindow(const glm::ivec3& dimensions, int first,
+                std::vector<std::shared_ptr<const RawVolume<VoxelType>>> slices)
+        : _dimensions(dimensions)
+        , _first(first)
+        , _slices(std::move(slices))
+    {}
+
+    glm::ivec3 dimensions() const {
+        return _dimensions;
+    }
+
+    VoxelType get(const glm::ivec3& coordinates) const {
+        return _slices[coordinates.z - _first]->get(
+            glm::ivec3(coordinates.x, coordinates.y, 0)
+        );
+    }
+
+private:
+    glm::ivec3 _dimensions;
+    int _first;
+    std::vector<std::shared_ptr<const RawVolume<VoxelType>>> _slices;
+};
+
+} // namespace slicestackresampler_internal
+
+template <typename VoxelType>
+SliceStackResampler<VoxelType>::SliceStackResampler(SliceLoader loader,
+                                                    const glm::ivec2& sliceDimensions,
+                                                    size_t nSlices,
+                                                    const glm::ivec3& outDimensions)
+    : _loader(std::move(loader))
+    , _inDimensions(sliceDimensions.x, sliceDimensions.y, static_cast<int>(nSlices))
+    , _outDimensions(outDimensions)
+{}
+
+template <typename VoxelType>
+typename SliceStackResampler<VoxelType>::Statistics
+SliceStackResampler<VoxelType>::resample(const std::string& outFilename, int nThreads,
+                                         const std::function<void(float)>& onProgress)
+{
+    using Window = slicestackresampler_internal::SliceWindow<VoxelType>;
+    using Slice = std::shared_ptr<const RawVolume<VoxelType>>;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (nThreads <= 0) {
+        nThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    const glm::vec3 resolutionRatio =
+        static_cast<glm::vec3>(_inDimensions) / static_cast<glm::vec3>(_outDimensions);
+
+    // Only used to query the filter size; the window it refers to is never sampled
+    const Window emptyWindow(_inDimensions, 0, {});
+    const glm::ivec3 filterSize =
+        VolumeSampler<Window>(emptyWindow, resolutionRatio).filterSize();
+
+    // The range of input slices that the sampler reads for an output slice
+    auto footprint = [&](int z) {
+        const float inZ = ((static_cast<float>(z) + 0.5f) * resolutionRatio.z) - 0.5f;
+        const int minZ = static_cast<int>(std::floor(inZ)) - filterSize.z / 2;
+        return std::make_pair(
+            glm::clamp(minZ, 0, _inDimensions.z - 1),
+            glm::clamp(minZ + filterSize.z, 0, _inDimensions.z - 1)
+        );
+    };
+
+    // The prefetcher may run ahead as far as all slabs in flight could need
+    const int capacity = filterSize.z + 2 +
+        (nThreads + 1) * (static_cast<int>(std::ceil(resolutionRatio.z)) + 1);
+
+    std::mutex sliceMutex;
+    std::condition_variable sliceLoaded;
+    std::condition_variable sliceEvicted;
+    std::map<int, Slice> slices;
+    int nextSliceToLoad = 0;
+    int evictBelow = 0;
+    bool aborted = false;
+
+    std::vector<bool> slabDone(_outDimensions.z, false);
+    int lowestUnfinishedSlab = 0;
+
+    std::thread prefetcher([&]() {
+        for (int i = 0; i < _inDimensions.z; ++i) {
+            {
+                std::unique_lock<std::mutex> lock(sliceMutex);
+                sliceEvicted.wait(lock, [&]() {
+                    return aborted || i - evictBelow < capacity;
+                });
+                if (aborted) {
+                    return;
+                }
+            }
+
+            Slice slice = _loader(i);
+
+            std::lock_guard<std::mutex> lock(sliceMutex);
+            if (!slice) {
+                aborted = true;
+                sliceLoaded.notify_all();
+                return;
+            }
+            ghoul_assert(
+                slice->dimensions() == glm::ivec3(_inDimensions.x, _inDimensions.y, 1),
+                "Slice dimensions do not agree."
+            );
+            slices[i] = std::move(slice);
+            nextSliceToLoad = i + 1;
+            sliceLoaded.notify_all();
+        }
+    });
+
+    // Finished slabs are kept until all slabs before them have been written
+    std::ofstream file(outFilename, std::ios::binary);
+    std::mutex writeMutex;
+    std::map<int, std::vector<VoxelType>> finishedSlabs;
+    int nextSlabToWrite = 0;
+
+    const size_t slabSize = static_cast<size_t>(_outDimensions.x) * _outDimensions.y;
+    std::atomic<int> nextSlab(0);
+
+    auto worker = [&]() {
+        while (true) {
+            const int z = nextSlab++;
+            if (z >= _outDimensions.z) {
+                return;
+            }
+
+            const std::pair<int, int> range = footprint(z);
+            std::vector<Slice> windowSlices;
+            {
+                std::unique_lock<std::mutex> lock(sliceMutex);
+                sliceLoaded.wait(lock, [&]() {
+                    return aborted || nextSliceToLoad > range.second;
+                });
+                if (aborted) {
+                    return;
+                }
+                for (int i = range.first; i <= range.second; ++i) {
+                    windowSlices.push_back(slices[i]);
+                }
+            }
+
+            const Window window(_inDimensions, range.first, std::move(windowSlices));
+            const VolumeSampler<Window> sampler(window, resolutionRatio);
+
+            std::vector<VoxelType> slab(slabSize);
+            size_t i = 0;
+            for (int y = 0; y < _outDimensions.y; ++y) {
+                for (int x = 0; x < _outDimensions.x; ++x, ++i) {
+                    const glm::vec3 inCoord =
+                        ((glm::vec3(glm::ivec3(x, y, z)) + glm::vec3(0.5)) *
+                            resolutionRatio) - glm::vec3(0.5);
+                    slab[i] = sampler.sample(inCoord);
+                }
+            }
+
+            {
+                // Release the slices that no unfinished slab needs anymore
+                std::lock_guard<std::mutex> lock(sliceMutex);
+                slabDone[z] = true;
+                while (lowestUnfinishedSlab < _outDimensions.z &&
+                       slabDone[lowestUnfinishedSlab])
+                {
+                    ++lowestUnfinishedSlab;
+                }
+                const int needed = lowestUnfinishedSlab < _outDimensions.z ?
+                    footprint(lowestUnfinishedSlab).first :
+                    _inDimensions.z;
+                slices.erase(slices.begin(), slices.lower_bound(needed));
+                evictBelow = std::max(evictBelow, needed);
+                sliceEvicted.notify_all();
+            }
+
+            std::lock_guard<std::mutex> lock(writeMutex);
+            finishedSlabs[z] = std::move(slab);
+            while (!finishedSlabs.empty() &&
+                   finishedSlabs.begin()->first == nextSlabToWrite)
+            {
+                const std::vector<VoxelType>& data = finishedSlabs.begin()->second;
+                file.write(
+                    reinterpret_cast<const char*>(data.data()),
+                    data.size() * sizeof(VoxelType)
+                );
+                finishedSlabs.erase(finishedSlabs.begin());
+                ++nextSlabToWrite;
+                onProgress(static_cast<float>(nextSlabToWrite) / _outDimensions.z);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < nThreads; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(sliceMutex);
+        aborted = true;
+        sliceEvicted.notify_all();
+    }
+    prefetcher.join();
+    file.close();
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    Statistics stats;
+    stats.seconds = std::chrono::duration<double>(end - start).count();
+    stats.nVoxelsWritten = static_cast<size_t>(nextSlabToWrite) * slabSize;
+    stats.nSlicesLoaded = static_cast<size_t>(nextSliceToLoad);
+    stats.nThreads = nThreads;
+    return stats;
+}
+
+} // namespace openspace
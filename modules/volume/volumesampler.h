@@ -8,6 +8,8 @@ class VolumeSampler {
 public:
     VolumeSampler(const VolumeType& volume, const glm::vec3& filterSize);
     typename VolumeType::VoxelType sample(const glm::vec3& position) const;
+    // The number of voxels along each axis that a sample is filtered over
+    glm::ivec3 filterSize() const;
 private:
     glm::ivec3 _filterSize;
     const VolumeType* _volume;
@@ -54,4 +54,9 @@ typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(const glm::vec3
     return value;
 }
 
+template <typename VolumeType>
+glm::ivec3 VolumeSampler<VolumeType>::filterSize() const {
+    return _filterSize;
+}
+
 }
@@ -27,5 +27,23 @@ glm::vec3 indexToCoords(size_t index, const glm::ivec3& dims) {
     return glm::ivec3(x, y, z);
 }
     
+namespace {
+// Inserts two zero bits between each of the lowest 21 bits of v
+uint64_t spreadBits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+} // namespace
+
+uint64_t mortonEncode(const glm::uvec3& coords) {
+    return spreadBits(coords.x) | (spreadBits(coords.y) << 1) |
+           (spreadBits(coords.z) << 2);
+}
+
 }
 }
@@ -27,12 +27,20 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
 namespace openspace {
 namespace volumeutils {
 
 size_t coordsToIndex(const glm::vec3& coords, const glm::ivec3& dimensions);
 glm::vec3 indexToCoords(size_t index, const glm::ivec3& dimensions);
 
+/**
+ * Interleaves the bits of the three coordinates (x in the least significant bit) into a
+ * Z-order (Morton) code. Each coordinate may use at most 21 bits.
+ */
+uint64_t mortonEncode(const glm::uvec3& coords);
+
 }
 }
 
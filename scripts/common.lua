@@ -86,9 +86,12 @@ helper.scheduledScript.reversible.setEnabled = function(time, renderable, enable
     return 
     {
         Time = time,
-        ReversibleLuaScript = {
-            Forward = helper.renderable.setEnabled(renderable, enabled),
-            Backward = helper.renderable.setEnabled(renderable, not enabled)
+        State = {
+            {
+                Property = renderable .. ".renderable.enabled",
+                Forward = enabled,
+                Backward = not enabled
+            }
         }
     }
 end
@@ -97,9 +100,11 @@ helper.scheduledScript.setEnabled = function(time, renderable, enabled)
     return 
     {
         Time = time,
-        ReversibleLuaScript = {
-            Forward = helper.renderable.setEnabled(renderable, enabled),
-            Backward = ""
+        State = {
+            {
+                Property = renderable .. ".renderable.enabled",
+                Forward = enabled
+            }
         }
     }
 end
\ No newline at end of file
@@ -45,10 +45,11 @@ float acc = 0;
 #include <#{raycaster.raycastPath}>
 #endfor
 
-#for index in 1..#{resolveData.nRaycasters}
-uniform bool insideRaycaster#{index};
-uniform vec3 cameraPosInRaycaster#{index}
-#endfor
+// One entry per raycaster slot. xyz: the camera position in the raycaster's local
+// coordinates, w: 1.0 if the camera is inside the raycaster, 0.0 otherwise
+layout (std140) uniform RaycasterUniforms {
+    vec4 cameraPosInRaycaster[N_RAYCASTERS];
+};
 
 
 #endif
@@ -141,10 +142,10 @@ void retrieveRaycasterData(uint nFrags) {
     int j = #{i} - 1;
     entryDepths[j] = -1;
     raycasterData[j].scale = -1;    
-    bool inside = insideRaycaster#{i};
+    bool inside = cameraPosInRaycaster[j].w > 0.5;
     if (inside) {
         entryDepths[j] = 0;
-        raycasterData[j].position = cameraPosInRaycaster#{i};
+        raycasterData[j].position = cameraPosInRaycaster[j].xyz;
         raycasterData[j].previousJitterDistance = 0;
     }
     }
@@ -254,7 +255,7 @@ bool initRaycasterMask(inout uint raycasterMask) {
 #for i in 1..#{resolveData.nRaycasters}
     {
     int j = #{i} - 1;
-    if (insideRaycaster#{i} && raycasterData[j].scale > 0) {
+    if (cameraPosInRaycaster[j].w > 0.5 && raycasterData[j].scale > 0) {
         raycasterMask |= (1 << j);
         insideAnyRaycaster = true;
     }
@@ -25,6 +25,7 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 
+#include <algorithm>
 #include <set>
 
 namespace {
@@ -55,6 +56,20 @@ namespace {
         }
     };
 
+    using openspace::documentation::TestResult;
+
+    std::string qualifiedKey(const std::string& location, const std::string& key) {
+        return location.empty() ? key : location + "." + key;
+    }
+
+    // Returns the keys of the table at the location, which is the dictionary itself if
+    // the location is empty
+    std::vector<std::string> tableKeys(const ghoul::Dictionary& dictionary,
+                                       const std::string& location)
+    {
+        return location.empty() ? dictionary.keys() : dictionary.keys(location);
+    }
+
 } // namespace
 
 // Unfortunately, the standard library does not contain a no-op for the to_string method
@@ -126,101 +141,122 @@ Documentation::Documentation(DocumentationEntries entries, Exhaustive exh)
     : Documentation("", "", entries, exh)
 {}
 
-TestResult testSpecification(const Documentation& d, const ghoul::Dictionary& dict) {
-    TestResult result;
-    result.success = true;
+namespace {
 
-    auto applyVerifier = [dict, &result](Verifier& verifier, const std::string& key) {
+void testTable(const Documentation& d, const ghoul::Dictionary& dict,
+               const std::string& location, TestResult& result)
+{
+    auto applyVerifier = [&dict, &result](Verifier& verifier, const std::string& key) {
         TestResult res = verifier(dict, key);
         if (!res.success) {
             result.success = false;
             result.offenses.insert(
                 result.offenses.end(),
-                res.offenses.begin(),
-                res.offenses.end()
+                std::make_move_iterator(res.offenses.begin()),
+                std::make_move_iterator(res.offenses.end())
             );
         }
         result.warnings.insert(
             result.warnings.end(),
-            res.warnings.begin(),
-            res.warnings.end()
+            std::make_move_iterator(res.warnings.begin()),
+            std::make_move_iterator(res.warnings.end())
         );
     };
 
+    // The keys are only requested if they are needed, which is the case for wildcards
+    // and exhaustive Documentations
+    std::vector<std::string> keys;
+    bool hasKeys = false;
+    auto allKeys = [&]() -> const std::vector<std::string>& {
+        if (!hasKeys) {
+            keys = tableKeys(dict, location);
+            hasKeys = true;
+        }
+        return keys;
+    };
+
+    bool hasWildcard = false;
     for (const auto& p : d.entries) {
         if (p.key == DocumentationEntry::Wildcard) {
-            for (const std::string& key : dict.keys()) {
-                applyVerifier(*(p.verifier), key);
+            hasWildcard = true;
+            for (const std::string& key : allKeys()) {
+                applyVerifier(*(p.verifier), qualifiedKey(location, key));
             }
         }
         else {
-            if (p.optional && !dict.hasKey(p.key)) {
+            std::string key = qualifiedKey(location, p.key);
+            if (p.optional && !dict.hasKey(key)) {
                 // If the key is optional and it doesn't exist, we don't need to check it
                 // if the key exists, it has to be correct, however
                 continue;
             }
-            applyVerifier(*(p.verifier), p.key);
+            applyVerifier(*(p.verifier), key);
         }
     }
 
-    if (d.exhaustive) {
-        // If the documentation is exhaustive, we have to check if there are extra values
-        // in the table that are not covered by the Documentation
-
-        for (const std::string& key : dict.keys()) {
-            auto it = std::find_if(
-                d.entries.begin(),
-                d.entries.end(),
-                [&key](const DocumentationEntry& entry) {
-                    if (entry.key == DocumentationEntry::Wildcard) {
-                        return true;
-                    }
-                    else {
-                        return entry.key == key;
-                    }
-                }
+    // If the documentation is exhaustive, we have to check if there are extra values
+    // in the table that are not covered by the Documentation. A wildcard covers all keys
+    if (d.exhaustive && !hasWildcard) {
+        std::vector<std::string> documentedKeys;
+        documentedKeys.reserve(d.entries.size());
+        for (const DocumentationEntry& entry : d.entries) {
+            documentedKeys.push_back(entry.key);
+        }
+        std::sort(documentedKeys.begin(), documentedKeys.end());
+
+        for (const std::string& key : allKeys()) {
+            bool isDocumented = std::binary_search(
+                documentedKeys.begin(),
+                documentedKeys.end(),
+                key
             );
 
-            if (it == d.entries.end()) {
+            if (!isDocumented) {
                 result.success = false;
                 result.offenses.push_back(
-                    { key, TestResult::Offense::Reason::ExtraKey }
+                    { qualifiedKey(location, key), TestResult::Offense::Reason::ExtraKey }
                 );
             }
         }
     }
+}
 
-    // Remove duplicate offenders that might occur if multiple rules apply to a single
-    // key and more than one of these rules are broken
-    std::set<TestResult::Offense, OffenseCompare> uniqueOffenders(
-        result.offenses.begin(), result.offenses.end()
-    );
-    result.offenses = std::vector<TestResult::Offense>(
-        uniqueOffenders.begin(), uniqueOffenders.end()
-    );
-    // Remove duplicate warnings. This should normally not happen, but we want to be sure
-    std::set<TestResult::Warning, WarningCompare> uniqueWarnings(
-        result.warnings.begin(), result.warnings.end()
-    );
-    result.warnings = std::vector<TestResult::Warning>(
-        uniqueWarnings.begin(), uniqueWarnings.end()
-    );
-
-    std::sort(
-        result.offenses.begin(),
-        result.offenses.end(),
-        [](const TestResult::Offense& lhs, const TestResult::Offense& rhs) {
-            return OffenseCompare()(lhs, rhs);
-        }
-    );
-    std::sort(
-        result.warnings.begin(),
-        result.warnings.end(),
-        [](const TestResult::Warning& lhs, const TestResult::Warning& rhs) {
-            return WarningCompare()(lhs, rhs);
-        }
-    );
+} // namespace
+
+void testSpecification(const Documentation& d, const ghoul::Dictionary& dict,
+                       const std::string& location, TestResult& result)
+{
+    testTable(d, dict, location, result);
+
+    if (result.offenses.size() > 1) {
+        // Remove duplicate offenders that might occur if multiple rules apply to a
+        // single key and more than one of these rules are broken. The set also sorts
+        // the offenses
+        std::set<TestResult::Offense, OffenseCompare> uniqueOffenders(
+            std::make_move_iterator(result.offenses.begin()),
+            std::make_move_iterator(result.offenses.end())
+        );
+        result.offenses = std::vector<TestResult::Offense>(
+            uniqueOffenders.begin(), uniqueOffenders.end()
+        );
+    }
+    if (result.warnings.size() > 1) {
+        // Remove duplicate warnings. This should normally not happen, but we want to be
+        // sure
+        std::set<TestResult::Warning, WarningCompare> uniqueWarnings(
+            std::make_move_iterator(result.warnings.begin()),
+            std::make_move_iterator(result.warnings.end())
+        );
+        result.warnings = std::vector<TestResult::Warning>(
+            uniqueWarnings.begin(), uniqueWarnings.end()
+        );
+    }
+}
 
+TestResult testSpecification(const Documentation& d, const ghoul::Dictionary& dict) {
+    TestResult result;
+    result.success = true;
+    testSpecification(d, dict, "", result);
     return result;
 }
 
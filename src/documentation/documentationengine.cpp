@@ -140,14 +140,9 @@ std::string generateHtmlDocumentation(const Documentation& d) {
         // We have to check ReferencingVerifier first as a ReferencingVerifier is also a
         // TableVerifier
         if (rv) {
-            std::vector<Documentation> documentations = DocEng.documentations();
-            auto it = std::find_if(
-                documentations.begin(),
-                documentations.end(),
-                [rv](const Documentation& doc) { return doc.id == rv->identifier; }
-            );
-
-            if (it == documentations.end()) {
+            const Documentation* doc = DocEng.documentation(rv->identifier);
+
+            if (!doc) {
                 html << "\t\t<td>"
                      << "<font color=\"red\">"
                      << "Could not find identifier: " << rv->identifier
@@ -157,7 +152,7 @@ std::string generateHtmlDocumentation(const Documentation& d) {
             else {
                 html << "\t\t<td>"
                      << "\t\t\tReferencing: "
-                     << "<a href=\"#" << rv->identifier << "\">" << it->name << "</a>"
+                     << "<a href=\"#" << rv->identifier << "\">" << doc->name << "</a>"
                      << "\t\t</td>";
             }
         }
@@ -267,16 +262,11 @@ void DocumentationEngine::addDocumentation(Documentation doc) {
         _documentations.push_back(std::move(doc));
     }
     else {
-        auto it = std::find_if(
-            _documentations.begin(),
-            _documentations.end(),
-            [doc](const Documentation& d) { return doc.id == d.id; }
-        );
-
-        if (it != _documentations.end()) {
+        if (_documentationIndices.find(doc.id) != _documentationIndices.end()) {
             throw DuplicateDocumentationException(std::move(doc));
         }
         else {
+            _documentationIndices[doc.id] = _documentations.size();
             _documentations.push_back(std::move(doc));
         }
     }
@@ -286,5 +276,15 @@ std::vector<Documentation> DocumentationEngine::documentations() const {
     return _documentations;
 }
 
+const Documentation* DocumentationEngine::documentation(const std::string& id) const {
+    auto it = _documentationIndices.find(id);
+    if (it == _documentationIndices.end()) {
+        return nullptr;
+    }
+    else {
+        return &_documentations[it->second];
+    }
+}
+
 } // namespace documentation
 } // namespace openspace
@@ -158,19 +158,10 @@ TableVerifier::TableVerifier(std::vector<DocumentationEntry> d, Exhaustive exhau
 TestResult TableVerifier::operator()(const ghoul::Dictionary& dict,
                                      const std::string& key) const {
     if (dict.hasKeyAndValue<Type>(key)) {
-        ghoul::Dictionary d = dict.value<ghoul::Dictionary>(key);
-        TestResult res = testSpecification({ "", documentations, exhaustive }, d);
-
-        // Add the 'key' as a prefix to make the new offender a fully qualified identifer
-        for (TestResult::Offense& s : res.offenses) {
-            s.offender = key + "." + s.offender;
-        }
-
-        // Add the 'key' as a prefix to make the new warning a fully qualified identifer
-        for (TestResult::Warning& w : res.warnings) {
-            w.offender = key + "." + w.offender;
-        }
-
+        // The nested table is tested in place, so that it does not have to be copied and
+        // all offenders and warnings already have fully qualified identifiers
+        TestResult res = { true, {} };
+        testSpecification({ "", documentations, exhaustive }, dict, key, res);
         return res;
     }
     else {
@@ -197,39 +188,23 @@ ReferencingVerifier::ReferencingVerifier(std::string id)
 TestResult ReferencingVerifier::operator()(const ghoul::Dictionary& dictionary,
                                            const std::string& key) const
 {
-    TestResult res = TableVerifier::operator()(dictionary, key);
-    if (res.success) {
-        std::vector<Documentation> documentations = DocEng.documentations();
-
-        auto it = std::find_if(
-            documentations.begin(),
-            documentations.end(),
-            [this](const Documentation& doc) { return doc.id == identifier; }
-        );
-
-        if (it == documentations.end()) {
-            return { false, { { key, TestResult::Offense::Reason::UnknownIdentifier } } };
+    if (!dictionary.hasKeyAndValue<Type>(key)) {
+        if (dictionary.hasKey(key)) {
+            return { false, { { key, TestResult::Offense::Reason::WrongType } } };
         }
         else {
-            ghoul::Dictionary d = dictionary.value<ghoul::Dictionary>(key);
-            TestResult res = testSpecification(*it, d);
-
-            // Add the 'key' as a prefix to make the offender a fully qualified identifer
-            for (TestResult::Offense& s : res.offenses) {
-                s.offender = key + "." + s.offender;
-            }
-
-            // Add the 'key' as a prefix to make the warning a fully qualified identifer
-            for (TestResult::Warning& w : res.warnings) {
-                w.offender = key + "." + w.offender;
-            }
-
-            return res;
+            return { false, { { key, TestResult::Offense::Reason::MissingKey } } };
         }
     }
-    else {
-        return res;
+
+    const Documentation* doc = DocEng.documentation(identifier);
+    if (!doc) {
+        return { false, { { key, TestResult::Offense::Reason::UnknownIdentifier } } };
     }
+
+    TestResult res = { true, {} };
+    testSpecification(*doc, dictionary, key, res);
+    return res;
 }
 
 std::string ReferencingVerifier::documentation() const {
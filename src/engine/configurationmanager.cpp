@@ -55,6 +55,7 @@ const string ConfigurationManager::KeyPropertyDocumentation = "PropertyDocumenta
 const string ConfigurationManager::KeyKeyboardShortcuts = "KeyboardShortcuts";
 const string ConfigurationManager::KeyDocumentation = "Documentation";
 const string ConfigurationManager::KeyFactoryDocumentation = "FactoryDocumentation";
+const string ConfigurationManager::KeyStartupTimeline = "StartupTimeline";
 const string ConfigurationManager::KeyConfigScene = "Scene";
 
 const string ConfigurationManager::KeyLogging = "Logging";
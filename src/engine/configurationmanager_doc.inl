@@ -286,6 +286,15 @@ Documentation ConfigurationManager::Documentation() {
             "shows the different types of objects that can be created in the current "
             "application configuration."
         },
+        {
+            ConfigurationManager::KeyStartupTimeline,
+            new StringVerifier,
+            "The JSON file to which the durations of the individual startup phases are "
+            "written after the first frame has been rendered. Any previous file in this "
+            "location will be silently overwritten. If this value is not specified, the "
+            "file 'StartupTimeline.json' in the base directory is used.",
+            Optional::Yes
+        },
         {
             ConfigurationManager::KeyShutdownCountdown,
             new DoubleGreaterEqualVerifier(0.0),
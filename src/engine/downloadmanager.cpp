@@ -32,7 +32,11 @@
 #include <chrono>
 #include <fstream>
 #include <thread>
+#include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <mutex>
+#include <sstream>
 
 #ifdef OPENSPACE_CURL_ENABLED
 #include <curl/curl.h>
@@ -81,6 +85,41 @@ namespace {
         return realsize;
     }
 
+    // Stores the validators of the response, so that later requests can be conditional
+    size_t headerCallback(char* data, size_t size, size_t nItems, void* userp) {
+        size_t length = size * nItems;
+        openspace::DownloadManager::MemoryFile* file =
+            static_cast<openspace::DownloadManager::MemoryFile*>(userp);
+
+        std::string line(data, length);
+        if (line.compare(0, 5, "HTTP/") == 0) {
+            // A new response begins, for example after a redirect
+            file->etag.clear();
+            file->lastModified.clear();
+            return length;
+        }
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            return length;
+        }
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        size_t begin = line.find_first_not_of(" \t", colon + 1);
+        size_t end = line.find_last_not_of(" \t\r\n");
+        std::string value = (begin == std::string::npos || end < begin) ?
+            "" :
+            line.substr(begin, end - begin + 1);
+
+        if (name == "etag") {
+            file->etag = value;
+        }
+        else if (name == "last-modified") {
+            file->lastModified = value;
+        }
+        return length;
+    }
+
     int xferinfo(void* p, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
                  curl_off_t ulnow)
     {
@@ -224,54 +263,98 @@ std::future<DownloadManager::MemoryFile> DownloadManager::fetchFile(
     LDEBUG("Start downloading file: '" << url << "' into memory");
     
     auto downloadFunction = [url, successCallback, errorCallback]() {
-        DownloadManager::MemoryFile file;
-        file.buffer = (char*)malloc(1);
-        file.size = 0;
-        file.corrupted = false;
-
-        CURL* curl = curl_easy_init();
-        if (curl) {
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&file);
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeMemoryCallback);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
-            // Will fail when response status is 400 or above
-            curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
-            
-            CURLcode res = curl_easy_perform(curl);
-            if(res == CURLE_OK){
-                // ask for the content-type
-                char *ct;
-                res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct);
-                if(res == CURLE_OK){
-                    std::string extension = std::string(ct);
-                    std::stringstream ss(extension);
-                    getline(ss, extension ,'/');
-                    getline(ss, extension);
-                    file.format = extension;
-                } else{
-                    LWARNING("Could not get File extension from file downloaded from: " + url);
-                }
-                successCallback(file);
-                curl_easy_cleanup(curl);
-                return std::move(file);
-            } else {
-                std::string err = curl_easy_strerror(res);
-                errorCallback(err);
-                curl_easy_cleanup(curl);
-                // Throw an error and use try-catch around call to future.get()
-                //throw std::runtime_error( err );
-
-                // or set a boolean variable in MemoryFile to determine if it is valid/corrupted or not.
-                // Return MemoryFile even if it is not valid, and check if it is after future.get() call.
-                file.corrupted = true;
-                return std::move(file);
-            }
+        MemoryFile file = fetchFileBlocking(url);
+        // Use a try-catch around the call to future.get() or check whether the returned
+        // MemoryFile is corrupted
+        if (file.corrupted) {
+            if (errorCallback)
+                errorCallback(file.errorMessage);
         }
+        else if (successCallback) {
+            successCallback(file);
+        }
+        return file;
     };
 
-    return std::move( std::async(std::launch::async, downloadFunction) );
+    return std::async(std::launch::async, downloadFunction);
+}
+
+DownloadManager::MemoryFile DownloadManager::fetchFileBlocking(const std::string& url,
+    const std::string& etag, const std::string& lastModified)
+{
+    // curl_easy_init would initialize curl implicitly, but that is not thread-safe
+    static std::once_flag curlInitialized;
+    std::call_once(curlInitialized, []() { curl_global_init(CURL_GLOBAL_ALL); });
+
+    MemoryFile file;
+    file.buffer = (char*)malloc(1);
+    file.size = 0;
+    file.corrupted = false;
+    file.isModified = true;
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        file.corrupted = true;
+        file.errorMessage = "Could not initialize curl";
+        return file;
+    }
+
+    curl_slist* headers = nullptr;
+    if (!etag.empty())
+        headers = curl_slist_append(headers, ("If-None-Match: " + etag).c_str());
+    if (!lastModified.empty()) {
+        headers = curl_slist_append(
+            headers,
+            ("If-Modified-Since: " + lastModified).c_str()
+        );
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&file);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeMemoryCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void *)&file);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+    // Will fail when response status is 400 or above
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+
+    CURLcode res = curl_easy_perform(curl);
+    if (res == CURLE_OK) {
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        if (status == 304) {
+            file.isModified = false;
+            // The server does not have to repeat the validators in the response
+            if (file.etag.empty())
+                file.etag = etag;
+            if (file.lastModified.empty())
+                file.lastModified = lastModified;
+        }
+
+        // ask for the content-type
+        char* ct = nullptr;
+        res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct);
+        if (res == CURLE_OK && ct) {
+            std::string extension = std::string(ct);
+            std::stringstream ss(extension);
+            getline(ss, extension ,'/');
+            getline(ss, extension);
+            file.format = extension;
+        }
+        else if (file.isModified) {
+            LWARNING("Could not get File extension from file downloaded from: " + url);
+        }
+    }
+    else {
+        file.corrupted = true;
+        file.errorMessage = curl_easy_strerror(res);
+    }
+
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+    return file;
 }
 
 std::vector<std::shared_ptr<DownloadManager::FileFuture>> DownloadManager::downloadRequestFiles(
@@ -24,31 +24,47 @@
 
 #include <openspace/engine/moduleengine.h>
 
+#include <openspace/engine/startuptimeline.h>
 #include <openspace/moduleregistration.h>
+#include <openspace/util/jobmanager.h>
 #include <openspace/util/openspacemodule.h>
 
 #include <ghoul/logging/logmanager.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <set>
 
 #include "moduleengine_lua.inl"
 
 namespace {
     const std::string _loggerCat = "ModuleEngine";
+
+    const std::string PreparationCategory = "Module Preparation";
+    const std::string InitializationCategory = "Module Initialization";
 }
 
 namespace openspace {
 
-void ModuleEngine::initialize() {
-    for (OpenSpaceModule* m : AllModules())
-        registerModule(std::unique_ptr<OpenSpaceModule>(m));
+void ModuleEngine::initialize(JobManager& jobManager, StartupTimeline* timeline) {
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    for (OpenSpaceModule* m : AllModules()) {
+        modules.push_back(std::unique_ptr<OpenSpaceModule>(m));
+    }
+    registerModules(std::move(modules), jobManager, timeline);
 }
 
 void ModuleEngine::deinitialize() {
     LDEBUG("Deinitializing modules");
-    for (auto& m : _modules) {
-        LDEBUG("Deinitialieing module '" << m->name() << "'");
-        m->deinitialize();
+    // Modules are deinitialized in reverse order so that no module is deinitialized
+    // before the modules that depend on it
+    for (auto it = _modules.rbegin(); it != _modules.rend(); ++it) {
+        LDEBUG("Deinitialieing module '" << (*it)->name() << "'");
+        (*it)->deinitialize();
     }
     _modules.clear();
     LDEBUG("Finished destroying modules");
@@ -57,24 +73,220 @@ void ModuleEngine::deinitialize() {
 void ModuleEngine::registerModule(std::unique_ptr<OpenSpaceModule> module) {
     ghoul_assert(module, "Module must not be nullptr");
     
-    auto it = std::find_if(
-        _modules.begin(),
-        _modules.end(),
-        [&module](std::unique_ptr<OpenSpaceModule>& rhs) {
-            return rhs->name() == module->name();
-        }
-    );
-    if (it != _modules.end()) {
+    if (isRegistered(module->name())) {
         throw ghoul::RuntimeError(
             "Module name '" + module->name() + "' was registered before", "ModuleEngine"
         );
     }
+    for (const std::string& required : module->requiredModules()) {
+        if (!isRegistered(required)) {
+            throw ghoul::RuntimeError(
+                "Module '" + module->name() + "' requires module '" + required +
+                "', which was not registered",
+                "ModuleEngine"
+            );
+        }
+    }
     
     LDEBUG("Registering module '" << module->name() << "'");
+    module->registerPathToken();
+    module->prepare();
     module->initialize();
     _modules.push_back(std::move(module));
 }
 
+void ModuleEngine::registerModules(std::vector<std::unique_ptr<OpenSpaceModule>> modules,
+                                   JobManager& jobManager, StartupTimeline* timeline)
+{
+    const size_t nModules = modules.size();
+
+    // Resolve the names and check for duplicates
+    std::map<std::string, size_t> indices;
+    for (size_t i = 0; i < nModules; ++i) {
+        ghoul_assert(modules[i], "Module must not be nullptr");
+        const std::string& name = modules[i]->name();
+        bool inserted = indices.emplace(name, i).second;
+        if (!inserted || isRegistered(name)) {
+            throw ghoul::RuntimeError(
+                "Module name '" + name + "' was registered before", "ModuleEngine"
+            );
+        }
+    }
+
+    // Build the dependency graph. Required modules that were registered previously are
+    // already initialized and thus do not need to be waited for
+    std::vector<int> nMissing(nModules, 0);
+    std::vector<std::vector<size_t>> dependents(nModules);
+    for (size_t i = 0; i < nModules; ++i) {
+        for (const std::string& required : modules[i]->requiredModules()) {
+            auto it = indices.find(required);
+            if (it != indices.end()) {
+                ++nMissing[i];
+                dependents[it->second].push_back(i);
+            }
+            else if (!isRegistered(required)) {
+                throw ghoul::RuntimeError(
+                    "Module '" + modules[i]->name() + "' requires module '" + required +
+                    "', which was not registered",
+                    "ModuleEngine"
+                );
+            }
+        }
+    }
+
+    // Determine the order in which the modules are initialized before any work is
+    // started. Of all modules whose requirements are initialized, the one that was passed
+    // first comes next, so the order does not depend on how long the preparations take
+    std::vector<size_t> order;
+    {
+        std::vector<int> nRemaining = nMissing;
+        std::set<size_t> ready;
+        for (size_t i = 0; i < nModules; ++i) {
+            if (nRemaining[i] == 0) {
+                ready.insert(i);
+            }
+        }
+        while (!ready.empty()) {
+            size_t i = *ready.begin();
+            ready.erase(ready.begin());
+            order.push_back(i);
+            for (size_t d : dependents[i]) {
+                if (--nRemaining[d] == 0) {
+                    ready.insert(d);
+                }
+            }
+        }
+        if (order.size() < nModules) {
+            std::string names;
+            for (size_t i = 0; i < nModules; ++i) {
+                if (nRemaining[i] > 0) {
+                    names += (names.empty() ? "" : ", ") + modules[i]->name();
+                }
+            }
+            throw ghoul::RuntimeError(
+                "Cyclic dependency between modules: " + names, "ModuleEngine"
+            );
+        }
+    }
+
+    // Path tokens are registered on the main thread before the preparation starts, so
+    // that the FileSystem is not modified while the modules are being prepared
+    for (const std::unique_ptr<OpenSpaceModule>& m : modules) {
+        LDEBUG("Registering module '" << m->name() << "'");
+        m->registerPathToken();
+    }
+
+    struct Prepared {
+        size_t index;
+        std::exception_ptr error;
+    };
+
+    std::mutex mutex;
+    std::condition_variable preparedCondition;
+    std::deque<Prepared> prepared;
+
+    auto startPreparation = [&](size_t i) {
+        OpenSpaceModule* module = modules[i].get();
+        jobManager.enqueue(
+            [&mutex, &preparedCondition, &prepared, module, i, timeline]() {
+                std::exception_ptr error;
+                try {
+                    StartupTimeline::ScopedPhase phase(
+                        timeline,
+                        module->name(),
+                        PreparationCategory
+                    );
+                    module->prepare();
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+
+                // The notification has to happen while the lock is held as the waiting
+                // thread might otherwise return and destroy the condition variable
+                std::lock_guard<std::mutex> lock(mutex);
+                prepared.push_back({ i, error });
+                preparedCondition.notify_one();
+            },
+            JobManager::Priority::High
+        );
+    };
+
+    size_t nStarted = 0;
+    for (size_t i = 0; i < nModules; ++i) {
+        if (nMissing[i] == 0) {
+            startPreparation(i);
+            ++nStarted;
+        }
+    }
+
+    // Every started preparation has to be waited for, even after an error occurred, as
+    // the jobs refer to the modules and the local state of this function. The modules
+    // are initialized strictly in the determined order; a module whose preparation
+    // finished early waits until all modules before it are initialized. The module next
+    // in line is always being prepared, as its requirements come before it in the order
+    std::exception_ptr error;
+    std::vector<bool> isPrepared(nModules, false);
+    size_t next = 0;
+    for (size_t nFinished = 0; nFinished < nStarted; ++nFinished) {
+        Prepared p;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            preparedCondition.wait(lock, [&prepared]() { return !prepared.empty(); });
+            p = prepared.front();
+            prepared.pop_front();
+        }
+
+        if (error) {
+            continue;
+        }
+        if (p.error) {
+            error = p.error;
+            continue;
+        }
+        isPrepared[p.index] = true;
+
+        while (next < nModules && isPrepared[order[next]]) {
+            const size_t i = order[next];
+            std::unique_ptr<OpenSpaceModule>& module = modules[i];
+            try {
+                StartupTimeline::ScopedPhase phase(
+                    timeline,
+                    module->name(),
+                    InitializationCategory
+                );
+                LDEBUG("Initializing module '" << module->name() << "'");
+                module->initialize();
+            }
+            catch (...) {
+                error = std::current_exception();
+                break;
+            }
+
+            for (size_t d : dependents[i]) {
+                if (--nMissing[d] == 0) {
+                    startPreparation(d);
+                    ++nStarted;
+                }
+            }
+            _modules.push_back(std::move(module));
+            ++next;
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool ModuleEngine::isRegistered(const std::string& name) const {
+    return std::any_of(
+        _modules.begin(),
+        _modules.end(),
+        [&name](const std::unique_ptr<OpenSpaceModule>& m) { return m->name() == name; }
+    );
+}
+
 std::vector<OpenSpaceModule*> ModuleEngine::modules() const {
     std::vector<OpenSpaceModule*> result;
     for (auto& m : _modules)
@@ -33,21 +33,26 @@
 #include <openspace/engine/logfactory.h>
 #include <openspace/engine/moduleengine.h>
 #include <openspace/engine/settingsengine.h>
+#include <openspace/engine/startuptimeline.h>
 #include <openspace/engine/syncengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
 #include <openspace/interaction/interactionhandler.h>
 #include <openspace/interaction/keyboardcontroller.h>
 #include <openspace/interaction/luaconsole.h>
 #include <openspace/interaction/mousecontroller.h>
+#include <openspace/interaction/sessionrecording.h>
 #include <openspace/network/networkengine.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/texturecache.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
 #include <openspace/scene/ephemeris.h>
 #include <openspace/scene/scene.h>
+#include <openspace/util/camera.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/jobmanager.h>
 #include <openspace/util/time.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/syncbuffer.h>
@@ -69,6 +74,7 @@
 #include <ghoul/systemcapabilities/systemcapabilities>
 
 #include <fstream>
+#include <future>
 #include <queue>
 
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
@@ -99,6 +105,7 @@ namespace {
     const std::string _loggerCat = "OpenSpaceEngine";
     const std::string _sgctDefaultConfigFile = "${SGCT}/single.xml";
     const std::string _defaultCacheLocation = "${BASE_PATH}/cache";
+    const std::string _defaultStartupTimelineFile = "${BASE_PATH}/StartupTimeline.json";
     
     const std::string _sgctConfigArgumentCommand = "-config";
     
@@ -107,12 +114,22 @@ namespace {
 
     const int CacheVersion = 1;
     const int DownloadVersion = 1;
+
+    // The time per frame that is spent on finishing background jobs on the main thread
+    const std::chrono::microseconds MainThreadJobBudget(4000);
+    // The time per frame that is spent on uploading decoded images to the GPU
+    const std::chrono::microseconds TextureUploadBudget(2000);
+
+    // The category of the startup phases that are recorded by the OpenSpaceEngine
+    const std::string StartupCategory = "Engine";
     
     struct {
         std::string configurationName;
         std::string sgctConfigurationName;
         std::string sceneName;
         std::string cacheFolder;
+        std::string playbackFile;
+        std::string timingsFile;
     } commandlineArgumentPlaceholders;
 }
 
@@ -128,6 +145,7 @@ OpenSpaceEngine::OpenSpaceEngine(std::string programName,
                                  std::unique_ptr<WindowWrapper> windowWrapper)
     : _configurationManager(new ConfigurationManager)
     , _interactionHandler(new interaction::InteractionHandler)
+    , _sessionRecording(new interaction::SessionRecording)
     , _renderEngine(new RenderEngine)
     , _scriptEngine(new scripting::ScriptEngine)
     , _scriptScheduler(new scripting::ScriptScheduler)
@@ -140,17 +158,21 @@ OpenSpaceEngine::OpenSpaceEngine(std::string programName,
     , _moduleEngine(new ModuleEngine)
     , _settingsEngine(new SettingsEngine)
     , _downloadManager(nullptr)
+    , _jobManager(new JobManager)
+    , _textureCache(new TextureCache(*_jobManager))
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
     , _gui(new gui::GUI)
 #endif
     , _parallelConnection(new network::ParallelConnection)
     , _windowWrapper(std::move(windowWrapper))
+    , _startupTimeline(std::make_unique<StartupTimeline>())
     , _globalPropertyNamespace(new properties::PropertyOwner)
     , _isMaster(false)
     , _runTime(0.0)
     , _isInShutdownMode(false)
     , _shutdownCountdown(0.f)
     , _shutdownWait(0.f)
+    , _terminateAfterPlayback(false)
     , _isFirstRenderingFirstFrame(true)
 {
     _interactionHandler->setPropertyOwner(_globalPropertyNamespace.get());
@@ -176,10 +198,17 @@ OpenSpaceEngine::~OpenSpaceEngine() {
     LINFO("_windowWrapper->isUsingSwapGroups(): " << _windowWrapper->isUsingSwapGroups());
     LINFO("_windowWrapper->isSwapGroupMaster(): " << _windowWrapper->isSwapGroupMaster());
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
-    _gui->deinitializeGL();
+    if (!_windowWrapper->isHeadless()) {
+        _gui->deinitializeGL();
+    }
 #endif
     _renderEngine->deinitialize();
 
+    // The textures have to be released while the OpenGL context still exists
+    _textureCache = nullptr;
+    // Jobs might still refer to resources owned by other components
+    _jobManager = nullptr;
+
     _globalPropertyNamespace = nullptr;
     _windowWrapper = nullptr;
     _parallelConnection = nullptr;
@@ -275,6 +304,11 @@ bool OpenSpaceEngine::create(int argc, char** argv,
     // Loading configuration from disk
     LDEBUG("Loading configuration from disk");
     try {
+        StartupTimeline::ScopedPhase phase(
+            _engine->_startupTimeline.get(),
+            "Configuration",
+            StartupCategory
+        );
         _engine->configurationManager().loadFromFile(configurationFilePath);
     }
     catch (const ghoul::RuntimeError& e) {
@@ -310,14 +344,31 @@ bool OpenSpaceEngine::create(int argc, char** argv,
     }
 
     // Register modules
-    _engine->_moduleEngine->initialize();
-
-    documentation::registerCoreClasses(DocEng);
-    // After registering the modules, the documentations for the available classes
-    // can be added as well
-    for (OpenSpaceModule* m : _engine->_moduleEngine->modules()) {
-        for (auto&& doc : m->documentations()) {
-            DocEng.addDocumentation(doc);
+    {
+        StartupTimeline::ScopedPhase phase(
+            _engine->_startupTimeline.get(),
+            "Modules",
+            StartupCategory
+        );
+        _engine->_moduleEngine->initialize(
+            *_engine->_jobManager,
+            _engine->_startupTimeline.get()
+        );
+    }
+
+    {
+        StartupTimeline::ScopedPhase phase(
+            _engine->_startupTimeline.get(),
+            "Documentation Registration",
+            StartupCategory
+        );
+        documentation::registerCoreClasses(DocEng);
+        // After registering the modules, the documentations for the available classes
+        // can be added as well
+        for (OpenSpaceModule* m : _engine->_moduleEngine->modules()) {
+            for (auto&& doc : m->documentations()) {
+                DocEng.addDocumentation(doc);
+            }
         }
     }
 
@@ -372,13 +423,25 @@ bool OpenSpaceEngine::initialize() {
     // graphics card
     clearAllWindows();
 
+    // The initialization is split into consecutive phases that are recorded in the
+    // startup timeline whenever one of them is finished
+    StartupTimeline::Clock::time_point phaseStart = StartupTimeline::Clock::now();
+    auto finishPhase = [this, &phaseStart](std::string name) {
+        StartupTimeline::Clock::time_point now = StartupTimeline::Clock::now();
+        _startupTimeline->addPhase(std::move(name), StartupCategory, phaseStart, now);
+        phaseStart = now;
+    };
+
     // Detect and log OpenCL and OpenGL versions and available devices
     SysCap.addComponent(
         std::make_unique<ghoul::systemcapabilities::GeneralCapabilitiesComponent>()
     );
-    SysCap.addComponent(
-        std::make_unique<ghoul::systemcapabilities::OpenGLCapabilitiesComponent>()
-    );
+    // Without an OpenGL context, there are no OpenGL capabilities to detect
+    if (!_windowWrapper->isHeadless()) {
+        SysCap.addComponent(
+            std::make_unique<ghoul::systemcapabilities::OpenGLCapabilitiesComponent>()
+        );
+    }
     SysCap.detectCapabilities();
 
     using Verbosity = ghoul::systemcapabilities::SystemCapabilitiesComponent::Verbosity;
@@ -398,6 +461,7 @@ bool OpenSpaceEngine::initialize() {
             verbosity = verbosityMap[v];
     }
     SysCap.logCapabilities(verbosity);
+    finishPhase("System Capabilities");
     
     std::string requestURL = "";
     bool success = configurationManager().getValue(ConfigurationManager::KeyDownloadRequestURL, requestURL);
@@ -413,6 +477,7 @@ bool OpenSpaceEngine::initialize() {
     _scriptEngine->addLibrary(Scene::luaLibrary());
     _scriptEngine->addLibrary(Time::luaLibrary());
     _scriptEngine->addLibrary(interaction::InteractionHandler::luaLibrary());
+    _scriptEngine->addLibrary(interaction::SessionRecording::luaLibrary());
     _scriptEngine->addLibrary(LuaConsole::luaLibrary());
     _scriptEngine->addLibrary(gui::GUI::luaLibrary());
     _scriptEngine->addLibrary(network::ParallelConnection::luaLibrary());
@@ -426,6 +491,25 @@ bool OpenSpaceEngine::initialize() {
 
     // TODO: Maybe move all scenegraph and renderengine stuff to initializeGL
     scriptEngine().initialize();
+    finishPhase("Lua Libraries");
+
+    // The documentation files are written on worker threads while the initialization
+    // continues. They only read the registered Lua libraries, documentations, and
+    // factories, which do not change until the RenderEngine is initialized
+    std::vector<std::future<void>> documentationWriters;
+    auto writeDocumentation = [this, &documentationWriters](std::string name,
+                                                            std::function<void()> write)
+    {
+        StartupTimeline* timeline = _startupTimeline.get();
+        auto task = std::make_shared<std::packaged_task<void()>>(
+            [timeline, name, write]() {
+                StartupTimeline::ScopedPhase phase(timeline, name, "Documentation");
+                write();
+            }
+        );
+        documentationWriters.push_back(task->get_future());
+        _jobManager->enqueue([task]() { (*task)(); });
+    };
 
     // If a LuaDocumentationFile was specified, generate it now
     const std::string LuaDocumentationType =
@@ -442,7 +526,15 @@ bool OpenSpaceEngine::initialize() {
         configurationManager().getValue(LuaDocumentationFile, luaDocumentationFile);
 
         luaDocumentationFile = absPath(luaDocumentationFile);
-        _scriptEngine->writeDocumentation(luaDocumentationFile, luaDocumentationType);
+        writeDocumentation(
+            "Lua Documentation",
+            [this, luaDocumentationFile, luaDocumentationType]() {
+                _scriptEngine->writeDocumentation(
+                    luaDocumentationFile,
+                    luaDocumentationType
+                );
+            }
+        );
     }
 
     // If a general documentation was specified, generate it now
@@ -459,7 +551,12 @@ bool OpenSpaceEngine::initialize() {
         std::string documentationFile;
         configurationManager().getValue(DocumentationFile, documentationFile);
         documentationFile = absPath(documentationFile);
-        DocEng.writeDocumentation(documentationFile, documentationType);
+        writeDocumentation(
+            "Documentation",
+            [documentationFile, documentationType]() {
+                DocEng.writeDocumentation(documentationFile, documentationType);
+            }
+        );
     }
 
     const std::string FactoryDocumentationType =
@@ -473,7 +570,11 @@ bool OpenSpaceEngine::initialize() {
         std::string type = configurationManager().value<std::string>(FactoryDocumentationType);
         std::string file = configurationManager().value<std::string>(FactoryDocumentationFile);
 
-        FactoryManager::ref().writeDocumentation(absPath(file), type);
+        file = absPath(file);
+        writeDocumentation(
+            "Factory Documentation",
+            [file, type]() { FactoryManager::ref().writeDocumentation(file, type); }
+        );
     }
 
     bool disableMasterRendering = false;
@@ -493,9 +594,13 @@ bool OpenSpaceEngine::initialize() {
     // Initialize the SettingsEngine
     _settingsEngine->initialize();
     _settingsEngine->setModules(_moduleEngine->modules());
+    finishPhase("Settings");
 
-    // Load a light and a monospaced font
-    loadFonts();
+    // Load a light and a monospaced font; the font renderer requires OpenGL
+    if (!_windowWrapper->isHeadless()) {
+        loadFonts();
+    }
+    finishPhase("Fonts");
 
     // Initialize the Scene
     Scene* sceneGraph = new Scene;
@@ -504,12 +609,21 @@ bool OpenSpaceEngine::initialize() {
     std::string scenePath = "";
     configurationManager().getValue(ConfigurationManager::KeyConfigScene, scenePath);
     sceneGraph->scheduleLoadSceneFile(scenePath);
+    finishPhase("Scene");
+
+    // The RenderEngine initialization registers additional Lua libraries, so the
+    // documentation has to be finished before. Errors are rethrown by the futures
+    for (std::future<void>& writer : documentationWriters) {
+        writer.get();
+    }
+    finishPhase("Waiting for Documentation");
 
     // Initialize the RenderEngine
     _renderEngine->setSceneGraph(sceneGraph);
     _renderEngine->initialize();
     _renderEngine->setGlobalBlackOutFactor(0.0);
     _renderEngine->startFading(1, 3.0);
+    finishPhase("RenderEngine");
 
 
     //_interactionHandler->setKeyboardController(new interaction::KeyboardControllerFixed);
@@ -517,6 +631,7 @@ bool OpenSpaceEngine::initialize() {
 
     // Run start up scripts
     runPreInitializationScripts(scenePath);
+    finishPhase("Pre-Initialization Scripts");
 
 
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
@@ -573,6 +688,7 @@ bool OpenSpaceEngine::initialize() {
     _syncEngine->addSyncables(Time::ref().getSyncables());
     _syncEngine->addSyncables(_renderEngine->getSyncables());
     _syncEngine->addSyncable(_scriptEngine.get());
+    finishPhase("GUI");
 
     LINFO("Finished initializing");
     return true;
@@ -612,6 +728,20 @@ void OpenSpaceEngine::gatherCommandlineArguments() {
         "path to a cache file, overriding the value set in the OpenSpace configuration "
         "file"
     ));
+
+    commandlineArgumentPlaceholders.playbackFile = "";
+    _commandlineParser->addCommand(std::make_unique<SingleCommand<std::string>>(
+        &commandlineArgumentPlaceholders.playbackFile, "-playback", "", "Provides the "
+        "path to a recorded session that is played back after the first frame. The "
+        "application is closed when the playback has finished"
+    ));
+
+    commandlineArgumentPlaceholders.timingsFile = "";
+    _commandlineParser->addCommand(std::make_unique<SingleCommand<std::string>>(
+        &commandlineArgumentPlaceholders.timingsFile, "-timings", "", "Provides the "
+        "path to a CSV file that receives the per-frame timings of the session that is "
+        "played back with -playback"
+    ));
 }
 
 void OpenSpaceEngine::runScripts(const ghoul::Dictionary& scripts) {
@@ -796,6 +926,17 @@ void OpenSpaceEngine::configureLogging() {
 }
 
 bool OpenSpaceEngine::initializeGL() {
+    StartupTimeline::ScopedPhase phase(
+        _startupTimeline.get(),
+        "OpenGL Initialization",
+        StartupCategory
+    );
+
+    if (_windowWrapper->isHeadless()) {
+        LINFO("Skipping OpenGL initialization for the headless window");
+        return true;
+    }
+
     LINFO("Initializing Rendering Engine");
     bool success = _renderEngine->initializeGL();
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
@@ -836,27 +977,79 @@ void OpenSpaceEngine::preSynchronization() {
 
     if (_isFirstRenderingFirstFrame) {
         _windowWrapper->setSynchronization(false);
+        _firstFrameStart = StartupTimeline::Clock::now();
     }
     
+    // While a session is played back, each recorded frame drives exactly one rendered
+    // frame. The recorded scripts are queued before the presync so that they are
+    // selected for execution in the same frame in which they were recorded
+    const interaction::SessionRecording::Frame* playbackFrame = nullptr;
+    if (_isMaster && _sessionRecording->isPlayingBack()) {
+        playbackFrame = &_sessionRecording->beginPlaybackFrame();
+        for (const std::string& script : playbackFrame->scripts) {
+            _scriptEngine->queueScript(script);
+        }
+    }
+
     _syncEngine->presync(_isMaster);
     if (_isMaster) {
         double dt = _windowWrapper->averageDeltaTime();
 
-        Time::ref().advanceTime(dt);
+        if (playbackFrame) {
+            Time::ref().setDeltaTime(playbackFrame->simulationDeltaTime);
+            Time::ref().setTime(
+                playbackFrame->simulationTime,
+                _sessionRecording->playbackFrameIndex() == 0
+            );
+        }
+        else {
+            Time::ref().advanceTime(dt);
+        }
 
         auto scheduledScripts = _scriptScheduler->progressTo(Time::ref().j2000Seconds());
         while(scheduledScripts.size()){
             auto scheduledScript = scheduledScripts.front();
-            LINFO(scheduledScript);
-            _scriptEngine->queueScript(scheduledScript);
+            // The scheduled scripts are part of the recorded scripts during playback
+            if (!playbackFrame) {
+                LINFO(scheduledScript);
+                _scriptEngine->queueScript(scheduledScript);
+            }
             scheduledScripts.pop();
         }
+        _scriptScheduler->applyStateChanges();
 
-        _interactionHandler->updateInputStates(dt);
+        if (!playbackFrame) {
+            _interactionHandler->updateInputStates(dt);
+        }
         
-        _renderEngine->updateSceneGraph();
-        _interactionHandler->updateCamera();
-        _renderEngine->camera()->invalidateCache();
+        {
+            interaction::SessionRecording::StageTimer timer(*_sessionRecording, "Update");
+            _renderEngine->updateSceneGraph();
+        }
+
+        Camera* camera = _renderEngine->camera();
+        if (playbackFrame) {
+            camera->setPositionVec3(playbackFrame->cameraPosition);
+            camera->setRotation(playbackFrame->cameraRotation);
+        }
+        else {
+            _interactionHandler->updateCamera();
+        }
+        camera->invalidateCache();
+
+        if (_sessionRecording->isRecording()) {
+            interaction::SessionRecording::Frame frame;
+            frame.simulationTime = Time::ref().j2000Seconds();
+            frame.simulationDeltaTime = Time::ref().deltaTime();
+            frame.frameTime = dt;
+            frame.cameraPosition = camera->positionVec3();
+            frame.cameraRotation = camera->rotationQuaternion();
+            const std::string& script = _scriptEngine->currentSyncedScript();
+            if (!script.empty()) {
+                frame.scripts.push_back(script);
+            }
+            _sessionRecording->recordFrame(frame);
+        }
 
         _parallelConnection->preSynchronization();
 
@@ -866,6 +1059,14 @@ void OpenSpaceEngine::preSynchronization() {
 void OpenSpaceEngine::postSynchronizationPreDraw() {
     _syncEngine->postsync(_isMaster);
 
+    // Finish the background jobs that have to run on the main thread, for example to
+    // upload their results to the GPU, before anything uses them for rendering
+    _jobManager->drainMainThreadQueue(MainThreadJobBudget);
+    // Without an OpenGL context, the decoded images stay pending in the texture cache
+    if (!_windowWrapper->isHeadless()) {
+        _textureCache->update(TextureUploadBudget);
+    }
+
     if (_isInShutdownMode) {
         if (_shutdownCountdown <= 0.f) {
             _windowWrapper->terminate();
@@ -879,6 +1080,11 @@ void OpenSpaceEngine::postSynchronizationPreDraw() {
     _renderEngine->updateShaderPrograms();
     
     if (!_isMaster) {
+        // The scheduled scripts are synced by the master, but the state they establish
+        // is derived from the synced time on every node
+        _scriptScheduler->progressTo(Time::ref().j2000Seconds());
+        _scriptScheduler->applyStateChanges();
+
         _renderEngine->updateSceneGraph();
         _renderEngine->camera()->invalidateCache();
     }   
@@ -890,7 +1096,9 @@ void OpenSpaceEngine::postSynchronizationPreDraw() {
 
 
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
-    if (_isMaster && _gui->isEnabled() && _windowWrapper->isRegularRendering()) {
+    if (_isMaster && _gui->isEnabled() && _windowWrapper->isRegularRendering() &&
+        !_windowWrapper->isHeadless())
+    {
         glm::vec2 mousePosition = _windowWrapper->mousePosition();
         glm::ivec2 drawBufferResolution = _windowWrapper->currentDrawBufferResolution();
         glm::ivec2 windowSize = _windowWrapper->currentWindowSize();
@@ -932,14 +1140,17 @@ void OpenSpaceEngine::postSynchronizationPreDraw() {
 }
 
 void OpenSpaceEngine::render(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix) {
+    interaction::SessionRecording::StageTimer timer(*_sessionRecording, "Render");
     _renderEngine->render(projectionMatrix, viewMatrix);
 }
 
 void OpenSpaceEngine::postDraw() {
     _renderEngine->postDraw();
 
+    // The screen log, the console, and the GUI are drawn with OpenGL
+    const bool isHeadless = _windowWrapper->isHeadless();
     bool showGui = _windowWrapper->hasGuiWindow() ? _windowWrapper->isGuiWindow() : true;
-    if (showGui) {
+    if (showGui && !isHeadless) {
         _renderEngine->renderScreenLog();
         if (_console->isVisible())
             _console->render();
@@ -949,15 +1160,63 @@ void OpenSpaceEngine::postDraw() {
 #endif
     }
 
-    if (_isInShutdownMode) {
+    if (_isInShutdownMode && !isHeadless) {
         _renderEngine->renderShutdownInformation(_shutdownCountdown, _shutdownWait);
     }
 
     if (_isFirstRenderingFirstFrame) {
         _windowWrapper->setSynchronization(true);
         _isFirstRenderingFirstFrame = false;
+
+        // The first frame includes the loading of the scene, which concludes the startup
+        _startupTimeline->addPhase(
+            "First Frame",
+            StartupCategory,
+            _firstFrameStart,
+            StartupTimeline::Clock::now()
+        );
+        std::string timelineFile = _defaultStartupTimelineFile;
+        configurationManager().getValue(
+            ConfigurationManager::KeyStartupTimeline,
+            timelineFile
+        );
+        try {
+            _startupTimeline->writeJson(absPath(timelineFile));
+            LINFO(
+                "Startup took " << _startupTimeline->elapsed().count() / 1000 << " ms"
+            );
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+        _startupTimeline = nullptr;
+
+        // The playback starts after the first frame so that the loading of the scene
+        // does not distort the timings of the first recorded frame
+        if (_isMaster && !commandlineArgumentPlaceholders.playbackFile.empty()) {
+            std::string timingsFile = commandlineArgumentPlaceholders.timingsFile;
+            if (!timingsFile.empty()) {
+                timingsFile = absPath(timingsFile);
+            }
+            try {
+                _sessionRecording->startPlayback(
+                    absPath(commandlineArgumentPlaceholders.playbackFile),
+                    timingsFile
+                );
+                _terminateAfterPlayback = true;
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+                _windowWrapper->terminate();
+            }
+        }
     }
 
+    _sessionRecording->endPlaybackFrame();
+    if (_terminateAfterPlayback && !_sessionRecording->isPlayingBack()) {
+        _terminateAfterPlayback = false;
+        _windowWrapper->terminate();
+    }
 }
 
 void OpenSpaceEngine::keyboardCallback(Key key, KeyModifier mod, KeyAction action) {
@@ -1114,6 +1373,11 @@ interaction::InteractionHandler& OpenSpaceEngine::interactionHandler() {
     return *_interactionHandler;
 }
 
+interaction::SessionRecording& OpenSpaceEngine::sessionRecording() {
+    ghoul_assert(_sessionRecording, "SessionRecording must not be nullptr");
+    return *_sessionRecording;
+}
+
 RenderEngine& OpenSpaceEngine::renderEngine() {
     ghoul_assert(_renderEngine, "RenderEngine must not be nullptr");
     return *_renderEngine;
@@ -1169,5 +1433,15 @@ DownloadManager& OpenSpaceEngine::downloadManager() {
     return *_downloadManager;
 }
 
+JobManager& OpenSpaceEngine::jobManager() {
+    ghoul_assert(_jobManager, "Job Manager must not be nullptr");
+    return *_jobManager;
+}
+
+TextureCache& OpenSpaceEngine::textureCache() {
+    ghoul_assert(_textureCache, "Texture Cache must not be nullptr");
+    return *_textureCache;
+}
+
 
 }  // namespace openspace
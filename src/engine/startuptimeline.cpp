@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/engine/startuptimeline.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+    std::string escapedJson(const std::string& text) {
+        std::string result;
+        result.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                default:
+                    result += c;
+            }
+        }
+        return result;
+    }
+} // namespace
+
+namespace openspace {
+
+StartupTimeline::ScopedPhase::ScopedPhase(StartupTimeline* timeline, std::string name,
+                                          std::string category)
+    : _timeline(timeline)
+    , _name(std::move(name))
+    , _category(std::move(category))
+    , _begin(Clock::now())
+{}
+
+StartupTimeline::ScopedPhase::~ScopedPhase() {
+    if (_timeline) {
+        _timeline->addPhase(
+            std::move(_name),
+            std::move(_category),
+            _begin,
+            Clock::now()
+        );
+    }
+}
+
+StartupTimeline::StartupTimeline()
+    : _origin(Clock::now())
+    , _mainThread(std::this_thread::get_id())
+{}
+
+void StartupTimeline::addPhase(std::string name, std::string category,
+                               Clock::time_point begin, Clock::time_point end)
+{
+    ghoul_assert(begin <= end, "Begin must not be later than end");
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    Entry entry = {
+        std::move(name),
+        std::move(category),
+        std::this_thread::get_id() == _mainThread,
+        duration_cast<microseconds>(begin - _origin),
+        duration_cast<microseconds>(end - begin)
+    };
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.push_back(std::move(entry));
+}
+
+std::vector<StartupTimeline::Entry> StartupTimeline::entries() const {
+    std::vector<Entry> result;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        result = _entries;
+    }
+    std::stable_sort(
+        result.begin(),
+        result.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.start < rhs.start; }
+    );
+    return result;
+}
+
+std::chrono::microseconds StartupTimeline::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _origin);
+}
+
+void StartupTimeline::writeJson(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            "Could not open file '" + filename + "' for writing",
+            "StartupTimeline"
+        );
+    }
+
+    std::vector<Entry> es = entries();
+
+    file << "{\n";
+    file << "  \"total\": " << elapsed().count() << ",\n";
+    file << "  \"phases\": [";
+    for (size_t i = 0; i < es.size(); ++i) {
+        const Entry& e = es[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    { "
+             << "\"name\": \"" << escapedJson(e.name) << "\", "
+             << "\"category\": \"" << escapedJson(e.category) << "\", "
+             << "\"thread\": \"" << (e.isMainThread ? "main" : "worker") << "\", "
+             << "\"start\": " << e.start.count() << ", "
+             << "\"duration\": " << e.duration.count()
+             << " }";
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+}
+
+} // namespace openspace
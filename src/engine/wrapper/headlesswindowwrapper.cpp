@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/engine/wrapper/headlesswindowwrapper.h>
+
+#include <openspace/engine/openspaceengine.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#undef near
+#undef far
+
+namespace {
+    // The vertical field of view of the virtual framebuffer in radians (60 degrees)
+    const float FieldOfView = 1.0471976f;
+}
+
+namespace openspace {
+
+HeadlessWindowWrapper::HeadlessWindowWrapper(glm::ivec2 resolution, double deltaTime)
+    : _resolution(resolution)
+    , _deltaTime(deltaTime)
+    , _nearClippingPlane(0.1f)
+    , _farClippingPlane(100.f)
+    , _frameNumber(0)
+    , _isTerminated(false)
+{
+    ghoul_assert(deltaTime > 0.0, "Delta time must be positive");
+}
+
+int HeadlessWindowWrapper::run(int nFrames, FrameCallback beforeFrame) {
+    ghoul_assert(nFrames >= 0, "Number of frames must not be negative");
+
+    const glm::mat4 viewMatrix = glm::mat4(1.f);
+    int nRunFrames = 0;
+    while (!_isTerminated && (nFrames == 0 || nRunFrames < nFrames)) {
+        if (beforeFrame) {
+            beforeFrame(_frameNumber);
+            if (_isTerminated) {
+                break;
+            }
+        }
+
+        // This is the only node of the cluster, so the synchronized state is encoded as
+        // on every master, but it is never decoded
+        OsEng.setRunTime(_frameNumber * _deltaTime);
+        OsEng.preSynchronization();
+        OsEng.encode();
+        OsEng.postSynchronizationPreDraw();
+        OsEng.render(projectionMatrix(), viewMatrix);
+        OsEng.postDraw();
+
+        ++_frameNumber;
+        ++nRunFrames;
+    }
+    return nRunFrames;
+}
+
+int HeadlessWindowWrapper::frameNumber() const {
+    return _frameNumber;
+}
+
+bool HeadlessWindowWrapper::isTerminated() const {
+    return _isTerminated;
+}
+
+void HeadlessWindowWrapper::terminate() {
+    _isTerminated = true;
+}
+
+double HeadlessWindowWrapper::averageDeltaTime() const {
+    return _deltaTime;
+}
+
+double HeadlessWindowWrapper::deltaTime() const {
+    return _deltaTime;
+}
+
+glm::ivec2 HeadlessWindowWrapper::currentWindowSize() const {
+    return _resolution;
+}
+
+bool HeadlessWindowWrapper::isHeadless() const {
+    return true;
+}
+
+glm::mat4 HeadlessWindowWrapper::viewProjectionMatrix() const {
+    return projectionMatrix();
+}
+
+void HeadlessWindowWrapper::setNearFarClippingPlane(float near, float far) {
+    _nearClippingPlane = near;
+    _farClippingPlane = far;
+}
+
+glm::mat4 HeadlessWindowWrapper::projectionMatrix() const {
+    return glm::perspective(
+        FieldOfView,
+        static_cast<float>(_resolution.x) / static_cast<float>(_resolution.y),
+        _nearClippingPlane,
+        _farClippingPlane
+    );
+}
+
+} // namespace openspace
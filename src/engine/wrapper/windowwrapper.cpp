@@ -133,6 +133,10 @@ bool WindowWrapper::isUsingSwapGroups() const {
     return false;
 }
 
+bool WindowWrapper::isHeadless() const {
+    return false;
+}
+
 
 glm::mat4 WindowWrapper::viewProjectionMatrix() const {
     return glm::mat4(1.f);
@@ -26,6 +26,9 @@
 
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/query/query.h>
 
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
@@ -36,6 +39,7 @@
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <iterator>
@@ -46,6 +50,26 @@ namespace {
     const std::string historyFile = "ConsoleHistory";
 
     const int NoAutoComplete = -1;
+    const int NoMatch = -1;
+
+    // Returns the position of the quotation mark that opens a string which is not closed
+    // before the end of the script, or std::string::npos if all strings are closed
+    size_t unterminatedStringStart(const std::string& script) {
+        size_t start = std::string::npos;
+        for (size_t i = 0; i < script.size(); ++i) {
+            const char c = script[i];
+            if (start == std::string::npos) {
+                if (c == '"' || c == '\'')
+                    start = i;
+            }
+            else if (c == '\\')
+                // Skip the escaped character
+                ++i;
+            else if (c == script[start])
+                start = std::string::npos;
+        }
+        return start;
+    }
 }
 
 #include "luaconsole_lua.inl"
@@ -57,6 +81,9 @@ LuaConsole::LuaConsole()
     , _activeCommand(0)
     , _filename("")
     , _autoCompleteInfo({NoAutoComplete, false, ""})
+    , _propertyIndexVersion(0)
+    , _hasPropertyIndex(false)
+    , _historySearch({false, "", NoMatch})
     , _isVisible(false)
 {
 //    _commands.push_back("");
@@ -109,6 +136,15 @@ void LuaConsole::keyboardCallback(Key key, KeyModifier modifier, KeyAction actio
         const bool modifierControl = (modifier == KeyModifier::Control);
         const bool modifierShift = (modifier == KeyModifier::Shift);
 
+        if (_historySearch.isActive && historySearchKeyboardCallback(key, modifier))
+            return;
+
+        // Start the reverse incremental search through the history
+        if (modifierControl && (key == Key::R)) {
+            _historySearch = { true, "", NoMatch };
+            return;
+        }
+
         // Paste from clipboard
         if (modifierControl && (key == Key::V))
             addToCommand(ghoul::clipboardText());
@@ -187,91 +223,42 @@ void LuaConsole::keyboardCallback(Key key, KeyModifier modifier, KeyAction actio
         }
 
         if (key == Key::Tab) {
-            // We get a list of all the available commands and initially find the first
-            // command that starts with how much we typed sofar. We store the index so
-            // that in subsequent "tab" presses, we will discard previous commands. This
-            // implements the 'hop-over' behavior. As soon as another key is pressed,
-            // everything is set back to normal
+            // We look up all the available completions of the command that start with
+            // how much we typed sofar in a prefix index. We store the index of the
+            // completion so that in subsequent "tab" presses, we will discard previous
+            // completions. This implements the 'hop-over' behavior. As soon as another
+            // key is pressed, everything is set back to normal
 
             // If the shift key is pressed, we decrement the current index so that we will
             // find the value before the one that was previously found
             if (_autoCompleteInfo.lastIndex != NoAutoComplete && modifierShift)
                 _autoCompleteInfo.lastIndex -= 2;
-            std::vector<std::string> allCommands = OsEng.scriptEngine().allLuaFunctions();
-            std::sort(allCommands.begin(), allCommands.end());
 
-            std::string currentCommand = _commands.at(_activeCommand);
-            
             // Check if it is the first time the tab has been pressed. If so, we need to
             // store the already entered command so that we can later start the search
-            // from there. We will overwrite the 'currentCommand' thus making the storage
+            // from there. We will overwrite the current command thus making the storage
             // necessary
             if (!_autoCompleteInfo.hasInitialValue) {
-                _autoCompleteInfo.initialValue = currentCommand;
+                _autoCompleteInfo.initialValue = _commands.at(_activeCommand);
                 _autoCompleteInfo.hasInitialValue = true;
             }
 
-            for (int i = 0; i < static_cast<int>(allCommands.size()); ++i) {
-                const std::string& command = allCommands[i];
-
-                // Check if the command has enough length (we don't want crashes here)
-                // Then check if the iterator-command's start is equal to what we want
-                // then check if we need to skip the first found values as the user has
-                // pressed TAB repeatedly
-                size_t fullLength = _autoCompleteInfo.initialValue.length();
-                bool correctLength = command.length() >= fullLength;
-
-                std::string commandLowerCase;
-                std::transform(
-                    command.begin(), command.end(),
-                    std::back_inserter(commandLowerCase),
-                    ::tolower
+            // Inside of a string we complete property URIs, as they are passed to the
+            // property functions as strings, and Lua functions everywhere else
+            size_t stringStart = unterminatedStringStart(_autoCompleteInfo.initialValue);
+            if (stringStart == std::string::npos) {
+                autoComplete(
+                    OsEng.scriptEngine().luaFunctionIndex(),
+                    0,
+                    CompletionType::LuaFunction
                 );
-                
-                std::string initialValueLowerCase;
-                std::transform(
-                    _autoCompleteInfo.initialValue.begin(),
-                    _autoCompleteInfo.initialValue.end(),
-                    std::back_inserter(initialValueLowerCase),
-                    ::tolower
+            }
+            else {
+                autoComplete(
+                    propertyIndex(),
+                    stringStart + 1,
+                    CompletionType::PropertyUri
                 );
-    
-                bool correctCommand =
-                    commandLowerCase.substr(0, fullLength) == initialValueLowerCase;
-                
-                if (correctLength && correctCommand && (i > _autoCompleteInfo.lastIndex)){
-                    // We found our index, so store it
-                    _autoCompleteInfo.lastIndex = i;
-
-                    // We only want to auto-complete until the next separator "."
-                    size_t pos = command.find('.', fullLength);
-                    if (pos == std::string::npos) {
-                        // If we don't find a separator, we autocomplete until the end
-                        // Set the found command as active command
-                        _commands.at(_activeCommand) = command + "();";
-                        // Set the cursor position to be between the brackets
-                        _inputPosition = _commands.at(_activeCommand).size() - 2;
-                    }
-                    else {
-                        // If we find a separator, we autocomplete until and including the
-                        // separator unless the autocompletion would be the same that we
-                        // already have (the case if there are multiple commands in the
-                        // same group
-                        std::string subCommand = command.substr(0, pos + 1);
-                        if (subCommand == _commands.at(_activeCommand))
-                            continue;
-                        else {
-                            _commands.at(_activeCommand) = command.substr(0, pos + 1);
-                            _inputPosition = _commands.at(_activeCommand).length();
-                            // We only want to remove the autocomplete info if we just
-                            // entered the 'default' openspace namespace
-                            if (command.substr(0, pos + 1) == "openspace.")
-                                _autoCompleteInfo = { NoAutoComplete, false, "" };
-                        }
-                    }
-
-                    break;
-                }
             }
         }
         else {
@@ -291,11 +278,27 @@ void LuaConsole::charCallback(unsigned int codepoint, KeyModifier modifier) {
     const bool modifierControl = (modifier == KeyModifier::Control);
 
     const int codepoint_C = 99;
+    const int codepoint_R = 114;
     const int codepoint_V = 118;
-    if (modifierControl && (codepoint == codepoint_C || codepoint == codepoint_V)) {
+    const bool isShortcut =
+        (codepoint == codepoint_C) ||
+        (codepoint == codepoint_R) ||
+        (codepoint == codepoint_V);
+    if (modifierControl && isShortcut) {
         return;
     }
 #endif
+    if (_historySearch.isActive) {
+        // Extending the query can only narrow the search, so the current match is the
+        // newest candidate
+        _historySearch.query += UnicodeToUTF8(codepoint);
+        if (_historySearch.match == NoMatch)
+            updateHistorySearch(static_cast<int>(_commandsHistory.size()) - 1);
+        else
+            updateHistorySearch(_historySearch.match);
+        return;
+    }
+
     addToCommand(UnicodeToUTF8(codepoint));
 
 }
@@ -315,6 +318,25 @@ void LuaConsole::render() {
 
     using ghoul::fontrendering::RenderFont;
 
+    if (_historySearch.isActive) {
+        const bool failed = !_historySearch.query.empty() &&
+                            (_historySearch.match == NoMatch);
+        std::string match = (_historySearch.match == NoMatch) ?
+            "" :
+            _commandsHistory[_historySearch.match];
+
+        RenderFont(
+            *font,
+            glm::vec2(15.f, startY),
+            white,
+            "%s`%s': %s",
+            failed ? "(failed reverse-i-search)" : "(reverse-i-search)",
+            _historySearch.query.c_str(),
+            match.c_str()
+        );
+        return;
+    }
+
     RenderFont(*font, glm::vec2(15.f, startY), red, "$");
     RenderFont(*font, glm::vec2(15.f + font_size, startY), white, "%s", _commands.at(_activeCommand).c_str());
     
@@ -350,6 +372,147 @@ Key LuaConsole::commandInputButton() {
     return Key::GraveAccent;
 }
 
+void LuaConsole::autoComplete(const PrefixIndex& index, size_t tokenStart,
+                              CompletionType type)
+{
+    const std::string& initialValue = _autoCompleteInfo.initialValue;
+    const std::string head = initialValue.substr(0, tokenStart);
+    const std::string token = initialValue.substr(tokenStart);
+
+    // All entries that start with the token are stored consecutively in the index, so
+    // we only have to check if we need to skip the first found values as the user has
+    // pressed TAB repeatedly
+    PrefixIndex::Range range = index.matches(token);
+    int first = std::max(static_cast<int>(range.first), _autoCompleteInfo.lastIndex + 1);
+    for (int i = first; i < static_cast<int>(range.second); ++i) {
+        const std::string& entry = index[i];
+
+        // We found our index, so store it
+        _autoCompleteInfo.lastIndex = i;
+
+        // We only want to auto-complete until the next separator "."
+        size_t pos = entry.find('.', token.length());
+        if (pos == std::string::npos) {
+            // If we don't find a separator, we autocomplete until the end
+            if (type == CompletionType::LuaFunction) {
+                // Set the cursor position to be between the brackets
+                _commands.at(_activeCommand) = head + entry + "();";
+                _inputPosition = _commands.at(_activeCommand).size() - 2;
+            }
+            else {
+                // Close the string with the quotation mark that opened it
+                const char quotationMark = initialValue[tokenStart - 1];
+                _commands.at(_activeCommand) = head + entry + quotationMark;
+                _inputPosition = _commands.at(_activeCommand).size();
+            }
+        }
+        else {
+            // If we find a separator, we autocomplete until and including the separator
+            // unless the autocompletion would be the same that we already have (the case
+            // if there are multiple entries in the same group
+            std::string completion = head + entry.substr(0, pos + 1);
+            if (completion == _commands.at(_activeCommand))
+                continue;
+
+            _commands.at(_activeCommand) = completion;
+            _inputPosition = completion.length();
+            // We only want to remove the autocomplete info if we just entered the
+            // 'default' openspace namespace
+            if (type == CompletionType::LuaFunction && completion == "openspace.")
+                _autoCompleteInfo = { NoAutoComplete, false, "" };
+        }
+        return;
+    }
+}
+
+const PrefixIndex& LuaConsole::propertyIndex() {
+    const uint64_t version = properties::PropertyOwner::structureVersion();
+    if (!_hasPropertyIndex || (version != _propertyIndexVersion)) {
+        std::vector<properties::Property*> properties = allProperties();
+
+        std::vector<std::string> uris;
+        uris.reserve(properties.size());
+        for (properties::Property* p : properties)
+            uris.push_back(p->fullyQualifiedIdentifier());
+
+        _propertyIndex.set(std::move(uris));
+        _propertyIndexVersion = version;
+        _hasPropertyIndex = true;
+    }
+    return _propertyIndex;
+}
+
+bool LuaConsole::historySearchKeyboardCallback(Key key, KeyModifier modifier) {
+    const bool modifierControl = (modifier == KeyModifier::Control);
+
+    // Look for the next older match
+    if (modifierControl && (key == Key::R)) {
+        // If there is no older match, the current one is kept
+        const int match = _historySearch.match;
+        if (match != NoMatch) {
+            updateHistorySearch(match - 1);
+            if (_historySearch.match == NoMatch)
+                _historySearch.match = match;
+        }
+        return true;
+    }
+
+    if (key == Key::BackSpace) {
+        if (!_historySearch.query.empty()) {
+            _historySearch.query.pop_back();
+            updateHistorySearch(static_cast<int>(_commandsHistory.size()) - 1);
+        }
+        return true;
+    }
+
+    // Cancel the search and leave the command untouched
+    if (key == Key::Escape || (modifierControl && (key == Key::G))) {
+        _historySearch = { false, "", NoMatch };
+        return true;
+    }
+
+    // Enter, Tab and the navigation keys accept the match into the current command.
+    // Enter only accepts it, so that it can be edited before it is executed, the other
+    // keys are then handled as usual
+    const bool isAcceptingKey =
+        key == Key::Enter || key == Key::KeypadEnter || key == Key::Tab ||
+        key == Key::Left || key == Key::Right || key == Key::Up || key == Key::Down ||
+        key == Key::Home || key == Key::End;
+    if (isAcceptingKey) {
+        if (_historySearch.match != NoMatch) {
+            _commands.at(_activeCommand) = _commandsHistory[_historySearch.match];
+            _inputPosition = _commands.at(_activeCommand).length();
+        }
+        _historySearch = { false, "", NoMatch };
+        return key == Key::Enter || key == Key::KeypadEnter;
+    }
+
+    // All other keys, including the modifiers and the printable keys whose characters
+    // extend the query in charCallback, keep the search going
+    return true;
+}
+
+const std::string& LuaConsole::historySearchQuery() const {
+    return _historySearch.query;
+}
+
+void LuaConsole::updateHistorySearch(int start) {
+    // An empty query does not match anything, as every entry would match
+    _historySearch.match = NoMatch;
+    if (_historySearch.query.empty())
+        return;
+
+    for (int i = std::min(start, static_cast<int>(_commandsHistory.size()) - 1);
+         i >= 0;
+         --i)
+    {
+        if (_commandsHistory[i].find(_historySearch.query) != std::string::npos) {
+            _historySearch.match = i;
+            return;
+        }
+    }
+}
+
 void LuaConsole::addToCommand(std::string c) {
     size_t length = c.length();
     _commands.at(_activeCommand).insert(_inputPosition, c);
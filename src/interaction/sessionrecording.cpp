@@ -0,0 +1,464 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/sessionrecording.h>
+
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/scripting/lualibrary.h>
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+
+namespace {
+    const std::string _loggerCat = "SessionRecording";
+
+    // "OSSR" in little endian, followed by the version of the session layout
+    const uint32_t SessionMagic = 0x5253534F;
+    const uint32_t CurrentSessionVersion = 1;
+
+    // Scripts calling into this library are not recorded, as they would start or stop a
+    // recording or playback while the session is played back
+    const std::string LibraryPrefix = "openspace.sessionRecording.";
+
+    template <typename T>
+    void write(std::vector<char>& buffer, T value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+    void write(std::vector<char>& buffer, const std::string& value) {
+        write(buffer, static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    // Reads values from a block of memory; reading past the end yields default values
+    // and marks the reader as bad instead of touching memory outside the block
+    class SessionReader {
+    public:
+        SessionReader(const char* data, size_t size)
+            : _current(data)
+            , _end(data + size)
+        {}
+
+        template <typename T>
+        T read() {
+            T value = T();
+            if (hasBytes(sizeof(T))) {
+                std::memcpy(&value, _current, sizeof(T));
+                _current += sizeof(T);
+            }
+            return value;
+        }
+
+        std::string readString() {
+            uint32_t length = read<uint32_t>();
+            if (!hasBytes(length)) {
+                return "";
+            }
+            std::string value(_current, length);
+            _current += length;
+            return value;
+        }
+
+        bool isGood() const {
+            return _isGood;
+        }
+
+        bool isAtEnd() const {
+            return _current == _end;
+        }
+
+    private:
+        bool hasBytes(size_t size) {
+            if (!_isGood || static_cast<size_t>(_end - _current) < size) {
+                _isGood = false;
+                return false;
+            }
+            return true;
+        }
+
+        const char* _current;
+        const char* _end;
+        bool _isGood = true;
+    };
+
+    double toMilliseconds(std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+} // namespace
+
+#include "sessionrecording_lua.inl"
+
+namespace openspace {
+namespace interaction {
+
+SessionRecording::SessionRecordingError::SessionRecordingError(std::string msg)
+    : ghoul::RuntimeError(std::move(msg), "SessionRecording")
+{}
+
+SessionRecording::StageTimer::StageTimer(SessionRecording& recording, const char* stage)
+    : _recording(recording.isPlayingBack() ? &recording : nullptr)
+    , _stage(stage)
+{
+    if (_recording) {
+        _begin = Clock::now();
+    }
+}
+
+SessionRecording::StageTimer::~StageTimer() {
+    if (_recording) {
+        _recording->addStageTime(_stage, Clock::now() - _begin);
+    }
+}
+
+SessionRecording::SessionRecording()
+    : _state(State::Idle)
+    , _currentFrame(0)
+    , _isInFrame(false)
+{}
+
+SessionRecording::~SessionRecording() {
+    stopRecording();
+    stopPlayback();
+}
+
+SessionRecording::State SessionRecording::state() const {
+    return _state;
+}
+
+bool SessionRecording::isRecording() const {
+    return _state == State::Recording;
+}
+
+bool SessionRecording::isPlayingBack() const {
+    return _state == State::Playback;
+}
+
+void SessionRecording::startRecording(const std::string& filename) {
+    ghoul_assert(_state == State::Idle, "SessionRecording must be idle");
+
+    _recordingFile.open(filename, std::ofstream::binary | std::ofstream::trunc);
+    if (!_recordingFile.good()) {
+        _recordingFile = std::ofstream();
+        throw SessionRecordingError("Could not create session file '" + filename + "'");
+    }
+
+    _frameBuffer.clear();
+    write(_frameBuffer, SessionMagic);
+    write(_frameBuffer, CurrentSessionVersion);
+    _recordingFile.write(_frameBuffer.data(), _frameBuffer.size());
+
+    _state = State::Recording;
+    LINFO("Started recording session into '" << filename << "'");
+}
+
+void SessionRecording::recordFrame(const Frame& frame) {
+    ghoul_assert(_state == State::Recording, "SessionRecording must be recording");
+
+    std::vector<const std::string*> scripts;
+    for (const std::string& script : frame.scripts) {
+        if (script.compare(0, LibraryPrefix.size(), LibraryPrefix) != 0) {
+            scripts.push_back(&script);
+        }
+    }
+
+    // The frame is assembled first so that it is written with a single call, which
+    // makes a partially written frame at the end of the file less likely
+    _frameBuffer.clear();
+    write(_frameBuffer, frame.simulationTime);
+    write(_frameBuffer, frame.simulationDeltaTime);
+    write(_frameBuffer, frame.frameTime);
+    write(_frameBuffer, frame.cameraPosition.x);
+    write(_frameBuffer, frame.cameraPosition.y);
+    write(_frameBuffer, frame.cameraPosition.z);
+    write(_frameBuffer, frame.cameraRotation.x);
+    write(_frameBuffer, frame.cameraRotation.y);
+    write(_frameBuffer, frame.cameraRotation.z);
+    write(_frameBuffer, frame.cameraRotation.w);
+    write(_frameBuffer, static_cast<uint32_t>(scripts.size()));
+    for (const std::string* script : scripts) {
+        write(_frameBuffer, *script);
+    }
+    _recordingFile.write(_frameBuffer.data(), _frameBuffer.size());
+
+    if (!_recordingFile.good()) {
+        LERROR("Could not write to the session file; stopping the recording");
+        stopRecording();
+    }
+}
+
+void SessionRecording::stopRecording() {
+    if (_state != State::Recording) {
+        return;
+    }
+    _recordingFile.close();
+    _recordingFile = std::ofstream();
+    _frameBuffer = std::vector<char>();
+    _state = State::Idle;
+    LINFO("Stopped recording session");
+}
+
+void SessionRecording::startPlayback(const std::string& filename,
+                                     std::string timingsFile)
+{
+    ghoul_assert(_state == State::Idle, "SessionRecording must be idle");
+
+    std::vector<Frame> frames = loadSession(filename);
+    if (frames.empty()) {
+        throw SessionRecordingError("Session file '" + filename + "' contains no frames");
+    }
+
+    _frames = std::move(frames);
+    _currentFrame = 0;
+    _isInFrame = false;
+    _timingsFile = std::move(timingsFile);
+    _stages.clear();
+    _timings.clear();
+    _timings.reserve(_frames.size());
+
+    _state = State::Playback;
+    LINFO(
+        "Started playback of session '" << filename << "' with " << _frames.size() <<
+        " frames"
+    );
+}
+
+const SessionRecording::Frame& SessionRecording::beginPlaybackFrame() {
+    ghoul_assert(_state == State::Playback, "SessionRecording must be playing back");
+    ghoul_assert(!_isInFrame, "The previous playback frame must have been ended");
+    ghoul_assert(_currentFrame < _frames.size(), "Frame index out of range");
+
+    _isInFrame = true;
+    _frameBegin = Clock::now();
+    _timings.push_back({
+        _frames[_currentFrame].simulationTime,
+        std::chrono::nanoseconds(0),
+        std::vector<std::chrono::nanoseconds>(_stages.size())
+    });
+    return _frames[_currentFrame];
+}
+
+size_t SessionRecording::playbackFrameIndex() const {
+    return _currentFrame;
+}
+
+void SessionRecording::endPlaybackFrame() {
+    if (!_isInFrame) {
+        return;
+    }
+    _timings.back().total = Clock::now() - _frameBegin;
+    _isInFrame = false;
+
+    ++_currentFrame;
+    if (_currentFrame == _frames.size()) {
+        stopPlayback();
+    }
+}
+
+void SessionRecording::stopPlayback() {
+    if (_state != State::Playback) {
+        return;
+    }
+
+    // A frame that was started but not finished has no meaningful total time
+    if (_isInFrame) {
+        _timings.pop_back();
+        _isInFrame = false;
+    }
+
+    if (!_timingsFile.empty()) {
+        try {
+            writeTimings();
+        }
+        catch (const SessionRecordingError& e) {
+            LERRORC(e.component, e.message);
+        }
+    }
+    LINFO("Stopped playback after " << _timings.size() << " frames");
+
+    _state = State::Idle;
+    _frames = std::vector<Frame>();
+    _timings = std::vector<FrameTiming>();
+    _stages.clear();
+    _timingsFile.clear();
+    _currentFrame = 0;
+}
+
+void SessionRecording::addStageTime(const std::string& stage,
+                                    std::chrono::nanoseconds duration)
+{
+    if (!_isInFrame) {
+        return;
+    }
+
+    auto it = std::find(_stages.begin(), _stages.end(), stage);
+    size_t index = std::distance(_stages.begin(), it);
+    if (it == _stages.end()) {
+        _stages.push_back(stage);
+    }
+
+    std::vector<std::chrono::nanoseconds>& stages = _timings.back().stages;
+    if (stages.size() <= index) {
+        stages.resize(index + 1, std::chrono::nanoseconds(0));
+    }
+    stages[index] += duration;
+}
+
+void SessionRecording::writeTimings() const {
+    std::ofstream file(_timingsFile);
+    if (!file.good()) {
+        throw SessionRecordingError(
+            "Could not create timings file '" + _timingsFile + "'"
+        );
+    }
+
+    file << "Frame,SimulationTime,Total";
+    for (const std::string& stage : _stages) {
+        file << ',' << stage;
+    }
+    file << '\n';
+
+    // Times are written in milliseconds; stages that did not run in a frame, or were
+    // first reported after it, are written as 0
+    for (size_t i = 0; i < _timings.size(); ++i) {
+        const FrameTiming& timing = _timings[i];
+        file << i << ',' << std::setprecision(17) << timing.simulationTime << ','
+             << std::setprecision(6) << toMilliseconds(timing.total);
+        for (size_t j = 0; j < _stages.size(); ++j) {
+            std::chrono::nanoseconds duration =
+                j < timing.stages.size() ? timing.stages[j] : std::chrono::nanoseconds(0);
+            file << ',' << toMilliseconds(duration);
+        }
+        file << '\n';
+    }
+
+    if (!file.good()) {
+        throw SessionRecordingError(
+            "Could not write timings file '" + _timingsFile + "'"
+        );
+    }
+}
+
+std::vector<SessionRecording::Frame> SessionRecording::loadSession(
+                                                              const std::string& filename)
+{
+    std::unique_ptr<MemoryMappedFile> file;
+    try {
+        file = std::make_unique<MemoryMappedFile>(filename);
+    }
+    catch (const MemoryMappedFile::MemoryMappedFileError& e) {
+        throw SessionRecordingError(
+            "Could not open session file '" + filename + "': " + e.message
+        );
+    }
+    const MemoryMappedFile& mappedFile = *file;
+    SessionReader reader(mappedFile.data(), mappedFile.size());
+
+    if (reader.read<uint32_t>() != SessionMagic) {
+        throw SessionRecordingError("File '" + filename + "' is not a session file");
+    }
+    uint32_t version = reader.read<uint32_t>();
+    if (version != CurrentSessionVersion) {
+        throw SessionRecordingError(
+            "Session file '" + filename + "' has unsupported version " +
+            std::to_string(version)
+        );
+    }
+
+    std::vector<Frame> frames;
+    while (reader.isGood() && !reader.isAtEnd()) {
+        Frame frame;
+        frame.simulationTime = reader.read<double>();
+        frame.simulationDeltaTime = reader.read<double>();
+        frame.frameTime = reader.read<double>();
+        frame.cameraPosition.x = reader.read<double>();
+        frame.cameraPosition.y = reader.read<double>();
+        frame.cameraPosition.z = reader.read<double>();
+        frame.cameraRotation.x = reader.read<double>();
+        frame.cameraRotation.y = reader.read<double>();
+        frame.cameraRotation.z = reader.read<double>();
+        frame.cameraRotation.w = reader.read<double>();
+        uint32_t nScripts = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < nScripts && reader.isGood(); ++i) {
+            frame.scripts.push_back(reader.readString());
+        }
+
+        if (reader.isGood()) {
+            frames.push_back(std::move(frame));
+        }
+    }
+
+    if (!reader.isGood()) {
+        LWARNING(
+            "Session file '" << filename << "' ends with an incomplete frame, which "
+            "is ignored"
+        );
+    }
+    return frames;
+}
+
+scripting::LuaLibrary SessionRecording::luaLibrary() {
+    return {
+        "sessionRecording",
+        {
+            {
+                "startRecording",
+                &luascriptfunctions::startRecording,
+                "string",
+                "Starts recording the camera, the simulation time, and the executed "
+                "scripts of every frame into the provided session file"
+            },
+            {
+                "stopRecording",
+                &luascriptfunctions::stopRecording,
+                "",
+                "Stops the current session recording"
+            },
+            {
+                "startPlayback",
+                &luascriptfunctions::startPlayback,
+                "string [, string]",
+                "Plays back the provided session file, one recorded frame per rendered "
+                "frame. If a second file is provided, the timings of each frame are "
+                "written to it as CSV when the playback ends"
+            },
+            {
+                "stopPlayback",
+                &luascriptfunctions::stopPlayback,
+                "",
+                "Stops the current playback and writes the frame timings"
+            }
+        }
+    };
+}
+
+} // namespace interaction
+} // namespace openspace
@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+namespace openspace {
+
+namespace luascriptfunctions {
+
+/**
+ * \ingroup LuaScripts
+ * startRecording(string):
+ * Starts recording a session into the provided file
+ */
+int startRecording(lua_State* L) {
+    int nArguments = lua_gettop(L);
+    if (nArguments != 1)
+        return luaL_error(L, "Expected %i arguments, got %i", 1, nArguments);
+
+    std::string filename = luaL_checkstring(L, -1);
+    interaction::SessionRecording& recording = OsEng.sessionRecording();
+    if (recording.state() != interaction::SessionRecording::State::Idle)
+        return luaL_error(L, "A session is already being recorded or played back");
+
+    try {
+        recording.startRecording(absPath(filename));
+    }
+    catch (const interaction::SessionRecording::SessionRecordingError& e) {
+        return luaL_error(L, "%s", e.message.c_str());
+    }
+    return 0;
+}
+
+/**
+ * \ingroup LuaScripts
+ * stopRecording():
+ * Stops the current session recording
+ */
+int stopRecording(lua_State* L) {
+    int nArguments = lua_gettop(L);
+    if (nArguments != 0)
+        return luaL_error(L, "Expected %i arguments, got %i", 0, nArguments);
+
+    OsEng.sessionRecording().stopRecording();
+    return 0;
+}
+
+/**
+ * \ingroup LuaScripts
+ * startPlayback(string [, string]):
+ * Plays back the provided session file and optionally writes the frame timings to the
+ * second file
+ */
+int startPlayback(lua_State* L) {
+    int nArguments = lua_gettop(L);
+    if (nArguments != 1 && nArguments != 2)
+        return luaL_error(L, "Expected %i or %i arguments, got %i", 1, 2, nArguments);
+
+    std::string filename = luaL_checkstring(L, 1);
+    std::string timingsFile;
+    if (nArguments == 2)
+        timingsFile = absPath(luaL_checkstring(L, 2));
+
+    interaction::SessionRecording& recording = OsEng.sessionRecording();
+    if (recording.state() != interaction::SessionRecording::State::Idle)
+        return luaL_error(L, "A session is already being recorded or played back");
+
+    try {
+        recording.startPlayback(absPath(filename), timingsFile);
+    }
+    catch (const interaction::SessionRecording::SessionRecordingError& e) {
+        return luaL_error(L, "%s", e.message.c_str());
+    }
+    return 0;
+}
+
+/**
+ * \ingroup LuaScripts
+ * stopPlayback():
+ * Stops the current playback
+ */
+int stopPlayback(lua_State* L) {
+    int nArguments = lua_gettop(L);
+    if (nArguments != 0)
+        return luaL_error(L, "Expected %i arguments, got %i", 0, nArguments);
+
+    OsEng.sessionRecording().stopPlayback();
+    return 0;
+}
+
+} // namespace luascriptfunctions
+
+} // namespace openspace
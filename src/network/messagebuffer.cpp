@@ -0,0 +1,153 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/messagebuffer.h>
+
+#include <openspace/openspace.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace openspace {
+namespace network {
+
+MessageWriter::MessageWriter(std::vector<char>& buffer)
+    : _buffer(buffer)
+{}
+
+void MessageWriter::encode(const std::string& value) {
+    const uint16_t length = static_cast<uint16_t>(std::min<size_t>(
+        value.size(),
+        std::numeric_limits<uint16_t>::max()
+    ));
+    encode(length);
+    encode(value.data(), length);
+}
+
+void MessageWriter::encode(const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const size_t offset = _buffer.size();
+    _buffer.resize(offset + size);
+    std::memcpy(_buffer.data() + offset, data, size);
+}
+
+MessageReader::MessageReader(const char* data, size_t size)
+    : _data(data)
+    , _size(size)
+    , _offset(0)
+    , _good(true)
+{}
+
+MessageReader::MessageReader(const std::vector<char>& buffer)
+    : MessageReader(buffer.data(), buffer.size())
+{}
+
+bool MessageReader::decode(std::string& value) {
+    uint16_t length = 0;
+    if (!decode(length) || remaining() < length) {
+        _good = false;
+        return false;
+    }
+    value.assign(_data + _offset, length);
+    _offset += length;
+    return true;
+}
+
+bool MessageReader::decode(char* data, size_t size) {
+    if (!_good || remaining() < size) {
+        _good = false;
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+    std::memcpy(data, _data + _offset, size);
+    _offset += size;
+    return true;
+}
+
+size_t MessageReader::remaining() const {
+    return _size - _offset;
+}
+
+bool MessageReader::good() const {
+    return _good;
+}
+
+void writeMessageHeader(std::vector<char>& buffer, uint32_t messageType) {
+    buffer.reserve(buffer.size() + MessageHeaderSize);
+
+    MessageWriter writer(buffer);
+    writer.encode('O');
+    writer.encode('S');
+    writer.encode(static_cast<uint8_t>(OPENSPACE_VERSION_MAJOR));
+    writer.encode(static_cast<uint8_t>(OPENSPACE_VERSION_MINOR));
+    writer.encode(messageType);
+}
+
+bool readMessageHeader(const char* header, uint32_t& messageType) {
+    const bool isCompatible =
+        header[0] == 'O' &&
+        header[1] == 'S' &&
+        static_cast<uint8_t>(header[2]) == OPENSPACE_VERSION_MAJOR &&
+        static_cast<uint8_t>(header[3]) == OPENSPACE_VERSION_MINOR;
+
+    if (!isCompatible) {
+        return false;
+    }
+    std::memcpy(&messageType, header + 4, sizeof(uint32_t));
+    return true;
+}
+
+size_t beginDataMessage(std::vector<char>& buffer, uint16_t dataType) {
+    writeMessageHeader(buffer, MessageTypes::Data);
+
+    MessageWriter writer(buffer);
+    writer.encode(dataType);
+    const size_t lengthOffset = buffer.size();
+    writer.encode(uint16_t(0));
+    return lengthOffset;
+}
+
+bool finishDataMessage(std::vector<char>& buffer, size_t lengthOffset) {
+    ghoul_assert(
+        lengthOffset + sizeof(uint16_t) <= buffer.size(),
+        "Length offset must lie within the buffer"
+    );
+
+    const size_t length = buffer.size() - lengthOffset - sizeof(uint16_t);
+    if (length > std::numeric_limits<uint16_t>::max()) {
+        return false;
+    }
+    const uint16_t messageLength = static_cast<uint16_t>(length);
+    std::memcpy(buffer.data() + lengthOffset, &messageLength, sizeof(uint16_t));
+    return true;
+}
+
+} // namespace network
+} // namespace openspace
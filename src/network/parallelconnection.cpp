@@ -22,49 +22,178 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#ifdef WIN32
-#ifndef _ERRNO
-#define _ERRNO WSAGetLastError()
-#endif
-#else //Use BSD sockets
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <netinet/tcp.h>
-#include <arpa/inet.h>
-#include <netdb.h>
-#include <errno.h>
-#ifndef SOCKET_ERROR
-#define SOCKET_ERROR (-1)
-#endif
-
-#ifndef INVALID_SOCKET
-#define INVALID_SOCKET (_SOCKET)(~0)
-#endif
-
-#ifndef NO_ERROR
-#define NO_ERROR 0L
-#endif
-
-#ifndef _ERRNO
-#define _ERRNO errno
-#endif
-#endif
-
 //openspace includes
 #include <openspace/network/parallelconnection.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/interaction/interactionhandler.h>
+#include <openspace/properties/property.h>
 #include <openspace/util/time.h>
 #include <openspace/openspace.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 //lua functions
 #include "parallelconnection_lua.inl"
 
 namespace {
     const std::string _loggerCat = "ParallelConnection";
+
+    // Coalescing keys of the queued messages. Consecutive keyframes replace each other
+    // and property values are coalesced per property, using PropertyValueKey + their id
+    const uint32_t PositionKeyframeKey = 1;
+    const uint32_t TimeKeyframeKey = 2;
+    const uint32_t PropertyValueKey = 16;
+
+    using openspace::network::datamessagestructures::PropertyValue;
+
+    template <typename T>
+    bool encodeValue(const openspace::properties::Property& property,
+                     PropertyValue::Type type, PropertyValue& result)
+    {
+        if (property.type() != typeid(T)) {
+            return false;
+        }
+        const T value = ghoul::any_cast<T>(property.get());
+        result._type = type;
+        result._value.resize(sizeof(T));
+        std::memcpy(result._value.data(), &value, sizeof(T));
+        return true;
+    }
+
+    // Encodes the value of the property if it has one of the types that are sent in
+    // binary form
+    bool encodeBinaryValue(const openspace::properties::Property& property,
+                           PropertyValue& result)
+    {
+        using Type = PropertyValue::Type;
+
+        if (property.type() == typeid(std::string)) {
+            const std::string value = ghoul::any_cast<std::string>(property.get());
+            result._type = Type::String;
+            result._value.assign(value.begin(), value.end());
+            return true;
+        }
+
+        return
+            encodeValue<bool>(property, Type::Bool, result) ||
+            encodeValue<int>(property, Type::Int, result) ||
+            encodeValue<float>(property, Type::Float, result) ||
+            encodeValue<double>(property, Type::Double, result) ||
+            encodeValue<glm::vec2>(property, Type::Vec2, result) ||
+            encodeValue<glm::vec3>(property, Type::Vec3, result) ||
+            encodeValue<glm::vec4>(property, Type::Vec4, result) ||
+            encodeValue<glm::dvec2>(property, Type::DVec2, result) ||
+            encodeValue<glm::dvec3>(property, Type::DVec3, result) ||
+            encodeValue<glm::dvec4>(property, Type::DVec4, result) ||
+            encodeValue<glm::ivec2>(property, Type::IVec2, result) ||
+            encodeValue<glm::ivec3>(property, Type::IVec3, result) ||
+            encodeValue<glm::ivec4>(property, Type::IVec4, result);
+    }
+
+    // Writes the number with as many digits as are needed to read back the same value
+    template <typename T>
+    void writeNumber(std::ostringstream& stream, T value) {
+        stream << std::setprecision(std::numeric_limits<T>::max_digits10) << value;
+    }
+
+    template <typename T>
+    bool luaNumber(const PropertyValue& value, std::string& result) {
+        if (value._value.size() != sizeof(T)) {
+            return false;
+        }
+        T v;
+        std::memcpy(&v, value._value.data(), sizeof(T));
+        std::ostringstream stream;
+        writeNumber(stream, v);
+        result = stream.str();
+        return true;
+    }
+
+    // Vectors are passed to the properties as Lua tables of their components
+    template <typename T>
+    bool luaVector(const PropertyValue& value, std::string& result) {
+        if (value._value.size() != sizeof(T)) {
+            return false;
+        }
+        T v;
+        std::memcpy(&v, value._value.data(), sizeof(T));
+        std::ostringstream stream;
+        stream << '{';
+        for (glm::length_t i = 0; i < v.length(); ++i) {
+            if (i > 0) {
+                stream << ',';
+            }
+            writeNumber(stream, v[i]);
+        }
+        stream << '}';
+        result = stream.str();
+        return true;
+    }
+
+    std::string luaString(const std::vector<char>& value) {
+        std::string result = "\"";
+        for (char c : value) {
+            switch (c) {
+                case '"':
+                case '\\':
+                    result += '\\';
+                    result += c;
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\r':
+                    result += "\\r";
+                    break;
+                case '\0':
+                    result += "\\0";
+                    break;
+                default:
+                    result += c;
+            }
+        }
+        return result + '"';
+    }
+
+    // Converts the received value into the Lua value that the property accepts, returns
+    // false if the value is malformed
+    bool luaValue(const PropertyValue& value, std::string& result) {
+        using Type = PropertyValue::Type;
+
+        switch (value._type) {
+            case Type::Bool:
+                if (value._value.size() != sizeof(bool)) {
+                    return false;
+                }
+                result = value._value[0] ? "true" : "false";
+                return true;
+            case Type::Int:       return luaNumber<int>(value, result);
+            case Type::Float:     return luaNumber<float>(value, result);
+            case Type::Double:    return luaNumber<double>(value, result);
+            case Type::Vec2:      return luaVector<glm::vec2>(value, result);
+            case Type::Vec3:      return luaVector<glm::vec3>(value, result);
+            case Type::Vec4:      return luaVector<glm::vec4>(value, result);
+            case Type::DVec2:     return luaVector<glm::dvec2>(value, result);
+            case Type::DVec3:     return luaVector<glm::dvec3>(value, result);
+            case Type::DVec4:     return luaVector<glm::dvec4>(value, result);
+            case Type::IVec2:     return luaVector<glm::ivec2>(value, result);
+            case Type::IVec3:     return luaVector<glm::ivec3>(value, result);
+            case Type::IVec4:     return luaVector<glm::ivec4>(value, result);
+            case Type::String:
+                result = luaString(value._value);
+                return true;
+            case Type::LuaString:
+                result.assign(value._value.begin(), value._value.end());
+                return true;
+            default:
+                return false;
+        }
+    }
 }
 
 namespace openspace {
@@ -134,38 +263,13 @@ void ParallelConnection::signalDisconnect(){
     _disconnectCondition.notify_all();
 }
         
-void ParallelConnection::closeSocket(){
-            
-    /*
-        Windows shutdown options
-        * SD_RECIEVE
-        * SD_SEND
-        * SD_BOTH
-             
-        Linux & Mac shutdown options
-        * SHUT_RD (Disables further receive operations)
-        * SHUT_WR (Disables further send operations)
-        * SHUT_RDWR (Disables further send and receive operations)
-        */
-            
-#ifdef WIN32
-    shutdown(_clientSocket, SD_BOTH);
-    closesocket(_clientSocket);
-#else
-    shutdown(_clientSocket, SHUT_RDWR);
-    close(_clientSocket);
-#endif
-            
-    _clientSocket = INVALID_SOCKET;
-}
-        
 void ParallelConnection::disconnect(){
     //we're disconnecting
             
     if (_clientSocket != INVALID_SOCKET){
                 
         //must be run before trying to join communication threads, else the threads are stuck trying to receive data
-        closeSocket();
+        closeSocket(_clientSocket);
                 
         //tell connection thread to stop trying to connect
         _tryConnect.store(false);
@@ -176,8 +280,14 @@ void ParallelConnection::disconnect(){
         //tell broadcast thread to stop broadcasting (we're no longer host)
         _isHost.store(false);
                 
-        //signal send thread to stop waiting and finish current run
-        _sendCondition.notify_all();
+        //discard unsent messages and wake the send thread so that it can finish
+        _sendQueue.close();
+
+        //wake the broadcast thread instead of waiting for its next keyframe
+        {
+            std::lock_guard<std::mutex> lock(_broadcastMutex);
+        }
+        _broadcastCondition.notify_all();
                 
         //join connection thread and delete it
         if(_connectionThread != nullptr){
@@ -219,7 +329,7 @@ void ParallelConnection::clientConnect(){
         return;
     }
             
-    if (!initNetworkAPI()){
+    if (!initializeSocketApi()){
         LERROR("Failed to initialize network API for Parallel Connection");
         return;
     }
@@ -318,6 +428,9 @@ void ParallelConnection::establishConnection(addrinfo *info){
                     
             //we're connected
             _isConnected.store(true);
+
+            //accept messages for the send thread
+            _sendQueue.open();
                     
             //start sending messages
             _sendThread = new (std::nothrow) std::thread(&ParallelConnection::sendFunc, this);
@@ -354,27 +467,20 @@ void ParallelConnection::establishConnection(addrinfo *info){
 }
 
 void ParallelConnection::sendAuthentication(){
-    //length of this nodes name
-    uint16_t namelen = static_cast<uint16_t>(_name.length());
-            
-    //total size of the buffer, header + size of passcodde + namelength + size of namelength
-    int size = headerSize() + sizeof(uint32_t) + sizeof(namelen) + static_cast<int>(namelen);
-
-    //create and reserve buffer
+    //create and reserve buffer for header, passcode, name length, and name
     std::vector<char> buffer;
-    buffer.reserve(size);
+    buffer.reserve(MessageHeaderSize + sizeof(uint32_t) + sizeof(uint16_t) + _name.size());
 
     //write header to buffer
-    writeHeader(buffer, MessageTypes::Authentication);
+    writeMessageHeader(buffer, MessageTypes::Authentication);
 
-    //write passcode to buffer
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_passCode), reinterpret_cast<char*>(&_passCode) + sizeof(uint32_t));
+    MessageWriter writer(buffer);
 
-    //write the length of the nodes name to buffer
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&namelen), reinterpret_cast<char*>(&namelen) + sizeof(uint16_t));
+    //write passcode to buffer
+    writer.encode(_passCode);
 
-    //write this nodes name to buffer
-    buffer.insert(buffer.end(), _name.begin(), _name.end());
+    //write the length of the nodes name followed by the name to buffer
+    writer.encode(_name);
             
     //send buffer
     queueMessage(buffer);
@@ -408,64 +514,38 @@ void ParallelConnection::delegateDecoding(uint32_t type){
 
 void ParallelConnection::initializationMessageReceived(){
             
-    int result;
-            
     uint32_t id, datasize;
     uint16_t numscripts;
-            
-    std::vector<char> buffer;
-    buffer.resize(sizeof(id));
 
-    //read id
-    result = receiveData(_clientSocket, buffer, sizeof(id), 0);
-    if (result < 0){
-        //error
+    //read id and length of the scripts
+    char sizes[sizeof(id) + sizeof(datasize)];
+    if (receiveAll(_clientSocket, sizes, sizeof(sizes)) <= 0){
+        LERROR("Failed to read initialization message.");
+        return;
     }
-    id = *(reinterpret_cast<uint32_t*>(buffer.data()));
+    MessageReader sizeReader(sizes, sizeof(sizes));
+    sizeReader.decode(id);
+    sizeReader.decode(datasize);
 
-    //read datalength
-    result = receiveData(_clientSocket, buffer, sizeof(datasize), 0);
-    if (result < 0){
-        //error
+    //read number of scripts and all scripts
+    std::vector<char> buffer(sizeof(numscripts) + datasize);
+    if (receiveAll(_clientSocket, buffer.data(), buffer.size()) <= 0){
+        LERROR("Failed to read scripts of initialization message.");
+        return;
     }
-    datasize = *(reinterpret_cast<uint32_t*>(buffer.data()));
-            
-    buffer.clear();
-    buffer.resize(sizeof(uint16_t));
-    //read number of scripts
-    result = receiveData(_clientSocket, buffer, sizeof(numscripts), 0);
-    if(result < 0){
-        //error
-    }        
-    numscripts = *(reinterpret_cast<uint16_t*>(buffer.data()));
-            
-    //length of current script
-    uint16_t scriptlen;
-            
-    buffer.clear();
-    buffer.resize(sizeof(scriptlen));
+
+    MessageReader reader(buffer);
+    reader.decode(numscripts);
             
     //holder for current script
     std::string script;
             
     for(int n = 0; n < numscripts; ++n){
-        //read length of script
-        result = receiveData(_clientSocket, buffer, sizeof(numscripts), 0);
-        if(result < 0){
-            //error
+        //read length of script and script
+        if (!reader.decode(script)){
+            LERROR("Initialization message contains a truncated script.");
+            break;
         }
-        scriptlen = *(reinterpret_cast<uint16_t*>(buffer.data()));
-                
-        //resize buffer
-        buffer.clear();
-        buffer.resize(scriptlen);
-                
-        //read script
-        result = receiveData(_clientSocket, buffer, scriptlen, 0);
-
-        //assign current script
-        script.clear();
-        script.assign(buffer.begin(), buffer.end());
                 
         //queue received script
         OsEng.scriptEngine().queueScript(script);
@@ -473,7 +553,7 @@ void ParallelConnection::initializationMessageReceived(){
             
     //we've gone through all scripts, initialization is done
     buffer.clear();
-    writeHeader(buffer, MessageTypes::InitializationCompleted);
+    writeMessageHeader(buffer, MessageTypes::InitializationCompleted);
             
     //let the server know
     queueMessage(buffer);
@@ -484,46 +564,26 @@ void ParallelConnection::initializationMessageReceived(){
 }
 
 void ParallelConnection::dataMessageReceived(){
-    int result;
     uint16_t msglen;
     uint16_t type;
 
-    //create a buffer to hold the size of streamdata message
-    std::vector<char> buffer;
-    buffer.resize(sizeof(type));
-            
-    //read type of data message
-    result = receiveData(_clientSocket, buffer, sizeof(type), 0);
-
-    if (result <= 0){
-        //error
-        LERROR("Failed to read type of data message received.");
-        return;
-    }
-            
-    //the type of data message received
-    type =(*(reinterpret_cast<uint16_t*>(buffer.data())));
-            
-    //read size of streamdata message
-    result = receiveData(_clientSocket, buffer, sizeof(msglen), 0);
-            
-    if (result <= 0){
+    //read type and size of the data message
+    char dataHeader[DataMessageHeaderSize];
+    if (receiveAll(_clientSocket, dataHeader, DataMessageHeaderSize) <= 0){
         //error
-        LERROR("Failed to read size of data message received.");
+        LERROR("Failed to read type and size of data message received.");
         return;
     }
-            
-    //the size in bytes of the streamdata message
-    msglen = (*(reinterpret_cast<uint16_t*>(buffer.data())));
+    MessageReader headerReader(dataHeader, DataMessageHeaderSize);
+    headerReader.decode(type);
+    headerReader.decode(msglen);
 
-    //resize the buffer to be able to read the streamdata
-    buffer.clear();
+    //resize the buffer to be able to read the data, it keeps its capacity between messages
+    std::vector<char>& buffer = _receiveBuffer;
     buffer.resize(msglen);
 
     //read the data into buffer
-    result = receiveData(_clientSocket, buffer, msglen, 0);
-            
-    if (result <= 0){
+    if (msglen > 0 && receiveAll(_clientSocket, buffer.data(), msglen) <= 0){
         //error
         LERROR("Failed to read data message.");
         return;
@@ -535,7 +595,10 @@ void ParallelConnection::dataMessageReceived(){
             //position data message
             //create and read a position keyframe from the data buffer
             network::datamessagestructures::PositionKeyframe kf;
-            kf.deserialize(buffer);
+            if (!kf.deserialize(buffer)){
+                LERROR("Received a truncated position keyframe.");
+                break;
+            }
                     
             //add the keyframe to the interaction handler
             OsEng.interactionHandler().addKeyframe(kf);
@@ -545,7 +608,10 @@ void ParallelConnection::dataMessageReceived(){
             //time data message
             //create and read a time keyframe from the data buffer
             network::datamessagestructures::TimeKeyframe tf;
-            tf.deserialize(buffer);
+            if (!tf.deserialize(buffer)){
+                LERROR("Received a truncated time keyframe.");
+                break;
+            }
                     
             //lock mutex and assign latest time keyframe parameters
             _timeKeyframeMutex.lock();
@@ -582,12 +648,29 @@ void ParallelConnection::dataMessageReceived(){
             //script data message
             //create and read a script message from data buffer
             network::datamessagestructures::ScriptMessage sm;
-            sm.deserialize(buffer);
+            if (!sm.deserialize(buffer)){
+                LERROR("Received a truncated script message.");
+                break;
+            }
                     
             //Que script to be executed by script engine
             OsEng.scriptEngine().queueScript(sm._script);
             break;
         }
+        case network::datamessagestructures::PropertyIdentifierData:{
+            //the host has bound a property to an id that its values refer to
+            network::datamessagestructures::PropertyIdentifier pi;
+            if (!pi.deserialize(buffer)){
+                LERROR("Received a truncated property identifier.");
+                break;
+            }
+            _propertyUris[pi._id] = pi._uri;
+            break;
+        }
+        case network::datamessagestructures::PropertyValueData:{
+            propertyValueReceived(buffer);
+            break;
+        }
         default:{
             LERROR("Unidentified data message with identifier " << type << " received in parallel connection.");
             break;
@@ -595,63 +678,101 @@ void ParallelConnection::dataMessageReceived(){
     }
 }
 
-void ParallelConnection::queueMessage(std::vector<char> message){
-    {
-        std::unique_lock<std::mutex> unqlock(_sendBufferMutex);
-        _sendBuffer.push_back(message);
-        _sendCondition.notify_all();
+void ParallelConnection::propertyValueReceived(const std::vector<char>& buffer){
+    network::datamessagestructures::PropertyValue value;
+    if (!value.deserialize(buffer)){
+        LERROR("Received a truncated or unknown property value.");
+        return;
+    }
+
+    auto it = _propertyUris.find(value._id);
+    if (it == _propertyUris.end()){
+        //the value was sent before we requested initialization and is part of that state
+        LDEBUG("Ignoring value of unknown property id " << value._id);
+        return;
+    }
+
+    //queued like all other received scripts, so that the value reaches every node of a
+    //cluster and is applied in the order in which it was received
+    std::string script = scriptFromPropertyValue(it->second, value);
+    if (script.empty()){
+        LERROR("Received a malformed value for property '" << it->second << "'");
+        return;
+    }
+    OsEng.scriptEngine().queueScript(script);
+}
+
+void ParallelConnection::queueMessage(const std::vector<char>& message,
+                                      uint32_t coalescingKey)
+{
+    _sendQueue.push(message, coalescingKey);
+}
+
+template <typename T>
+void ParallelConnection::queueDataMessage(datamessagestructures::type type, const T& data,
+                                          uint32_t coalescingKey)
+{
+    std::vector<char> buffer;
+
+    //header, type, and size of message followed by the actual message
+    size_t lengthOffset = beginDataMessage(buffer, static_cast<uint16_t>(type));
+    data.serialize(buffer);
+    if (!finishDataMessage(buffer, lengthOffset)){
+        LERROR("Data message of type " << type << " is too large to be sent.");
+        return;
     }
+
+    queueMessage(buffer, coalescingKey);
 }
         
 void ParallelConnection::sendFunc(){
-    int result;
-    //while we're connected
-    while(_isConnected.load()){
-        {
-            //wait for signal then lock mutex and send first queued message
-            std::unique_lock<std::mutex> unqlock(_sendBufferMutex);
-            _sendCondition.wait_for(unqlock, std::chrono::milliseconds(500));
-                    
-            if(!_sendBuffer.empty()){
-                while(!_sendBuffer.empty()){
-                    result = send(_clientSocket, _sendBuffer.front().data(), _sendBuffer.front().size(), 0);
-                    _sendBuffer.erase(_sendBuffer.begin());
-                            
-                    //make sure everything went well
-                    if (result == SOCKET_ERROR){
-                        //failed to send message
-                        LERROR("Failed to send message.\nError: " << _ERRNO << " detected in connection, disconnecting.");
-                                
-                        //signal that a disconnect should be performed
-                        signalDisconnect();
-                    }
-                }
-            }
+    //reused for all messages, pop swaps its allocation with the queue's
+    std::vector<char> message;
+
+    //wait for messages until the queue is closed when we disconnect. Messages are
+    //sent without holding the queue's lock, so new messages can be queued meanwhile
+    while(_sendQueue.pop(message)){
+        int result = sendAll(_clientSocket, message.data(), message.size());
+
+        //make sure everything went well
+        if (result == SOCKET_ERROR){
+            //failed to send message
+            LERROR("Failed to send message.\nError: " << _ERRNO << " detected in connection, disconnecting.");
+
+            //signal that a disconnect should be performed
+            signalDisconnect();
+            break;
         }
-                
     }
 }
         
 void ParallelConnection::hostInfoMessageReceived(){
-    //create buffer
-    std::vector<char> hostflag;
-    //resize to hold a flag saying if we're host or not
-    hostflag.resize(1);
+    //flag saying if we're host or not
+    char hostflag = 0;
             
     //read data into buffer
-    int result = receiveData(_clientSocket, hostflag, 1, 0);
+    int result = receiveAll(_clientSocket, &hostflag, 1);
 
     //enough data was read
     if (result > 0){
                 
         //we've been assigned as host
-        if (hostflag.at(0) == 1){
+        if (hostflag == 1){
                     
             //we're already host, do nothing (dummy check)
             if (_isHost.load()){
                 return;
             }
             else{
+                //clients only know the property ids of the previous host
+                {
+                    std::lock_guard<std::mutex> lock(_propertyIdMutex);
+                    std::fill(
+                        _isPropertyIdAnnounced.begin(),
+                        _isPropertyIdAnnounced.end(),
+                        false
+                    );
+                }
                         
                 //we're the host
                 _isHost.store(true);
@@ -667,6 +788,10 @@ void ParallelConnection::hostInfoMessageReceived(){
 
                 //stop broadcast loop
                 _isHost.store(false);
+                {
+                    std::lock_guard<std::mutex> lock(_broadcastMutex);
+                }
+                _broadcastCondition.notify_all();
                         
                 //and delete broadcasting thread
                 if (_broadcastThread != nullptr){
@@ -681,14 +806,15 @@ void ParallelConnection::hostInfoMessageReceived(){
                     
             //clear buffered any keyframes
             OsEng.interactionHandler().clearKeyframes();
+
+            //property ids are assigned by the host, which might have changed
+            _propertyUris.clear();
                     
             //request init package from the host
-            int size = headerSize();
             std::vector<char> buffer;
-            buffer.reserve(size);
                     
             //write header
-            writeHeader(buffer, MessageTypes::InitializationRequest);
+            writeMessageHeader(buffer, MessageTypes::InitializationRequest);
 
             //send message
             queueMessage(buffer);
@@ -702,69 +828,60 @@ void ParallelConnection::hostInfoMessageReceived(){
 
 void ParallelConnection::initializationRequestMessageReceived(){
             
-    //get current state as scripts
-    std::vector<std::string> scripts;
-    std::map<std::string, std::string>::iterator state_it;
-    {
-        //mutex protect
-        std::lock_guard<std::mutex> lock(_currentStateMutex);
-                
-        for(state_it = _currentState.begin();
-            state_it != _currentState.end();
-            ++state_it){
-            scripts.push_back(scriptFromPropertyAndValue(state_it->first, state_it->second));
-        }
-    }
-            
     //get requester ID
-    std::vector<char> buffer;
-    buffer.resize(sizeof(uint32_t));
-    receiveData(_clientSocket, buffer, sizeof(uint32_t), 0);
-    uint32_t requesterID = *reinterpret_cast<uint32_t*>(buffer.data());
-            
+    uint32_t requesterID;
+    char id[sizeof(requesterID)];
+    if (receiveAll(_clientSocket, id, sizeof(id)) <= 0){
+        LERROR("Failed to read initialization request.");
+        return;
+    }
+    std::memcpy(&requesterID, id, sizeof(requesterID));
+
+    //no property values can be queued until the state is queued. Values that were
+    //queued before are part of the state, values queued after bind their ids again
+    std::lock_guard<std::mutex> propertyIdLock(_propertyIdMutex);
+    std::fill(_isPropertyIdAnnounced.begin(), _isPropertyIdAnnounced.end(), false);
+
     //total number of scripts sent
     uint16_t numscripts = 0;
             
-    //temporary buffers
+    //serialize and encode current state as scripts into scriptbuffer
     std::vector<char> scriptbuffer;
-    std::vector<char> tmpbuffer;
-            
-    //serialize and encode all scripts into scriptbuffer
-    std::vector<std::string>::iterator script_it;
     network::datamessagestructures::ScriptMessage sm;
-    for(script_it = scripts.begin();
-        script_it != scripts.end();
-        ++script_it){
-        sm._script = *script_it;
-        sm._scriptlen = script_it->length();
-
-        //serialize current script
-        tmpbuffer.clear();
-        sm.serialize(tmpbuffer);
-                
-        //and insert into full buffer
-        scriptbuffer.insert(scriptbuffer.end(), tmpbuffer.begin(), tmpbuffer.end());
-                
-        //increment number of scripts
-        numscripts++;
+    {
+        //mutex protect
+        std::lock_guard<std::mutex> lock(_currentStateMutex);
+
+        for (const auto& state : _currentState){
+            sm._script = scriptFromPropertyAndValue(state.first, state.second);
+            sm.serialize(scriptbuffer);
+
+            //increment number of scripts
+            numscripts++;
+        }
     }
             
+    std::vector<char> buffer;
+    buffer.reserve(
+        MessageHeaderSize + 2 * sizeof(uint32_t) + sizeof(uint16_t) + scriptbuffer.size()
+    );
+
     //write header
-    buffer.clear();
-    writeHeader(buffer, MessageTypes::Initialization);
+    writeMessageHeader(buffer, MessageTypes::Initialization);
+
+    MessageWriter writer(buffer);
             
     //write client ID to receive init message
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&requesterID), reinterpret_cast<char*>(&requesterID) + sizeof(uint32_t));
+    writer.encode(requesterID);
             
     //write total size of data chunk
-    uint32_t totlen = static_cast<uint32_t>(scriptbuffer.size());
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&totlen), reinterpret_cast<char*>(&totlen) + sizeof(uint32_t));
+    writer.encode(static_cast<uint32_t>(scriptbuffer.size()));
             
     //write number of scripts
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&numscripts), reinterpret_cast<char*>(&numscripts) + sizeof(uint16_t));
+    writer.encode(numscripts);
             
     //write all scripts
-    buffer.insert(buffer.end(), scriptbuffer.begin(), scriptbuffer.end());
+    writer.encode(scriptbuffer.data(), scriptbuffer.size());
             
     //queue message
     queueMessage(buffer);
@@ -772,36 +889,27 @@ void ParallelConnection::initializationRequestMessageReceived(){
 
 void ParallelConnection::listenCommunication(){
             
-    //create basic buffer for receiving first part of messages
-    std::vector<char> buffer;
-    //size of the header
-    buffer.resize(headerSize());
+    //basic buffer for receiving first part of messages
+    char header[MessageHeaderSize];
             
     int result;
             
     //while we're still connected
     while (_isConnected.load()){
         //receive the first parts of a message
-        result = receiveData(_clientSocket, buffer, headerSize(), 0);
+        result = receiveAll(_clientSocket, header, MessageHeaderSize);
 
         //if enough data was received
         if (result > 0){
+            uint32_t type;
                 
-            //make sure that header matches this version of OpenSpace
-            if (buffer[0] == 'O' &&                     //Open
-                buffer[1] == 'S' &&                     //Space
-                buffer[2] == OPENSPACE_VERSION_MAJOR && // major version
-                buffer[3] == OPENSPACE_VERSION_MINOR    // minor version
-                )
-            {
-                //parse type
-                uint32_t type = (*(reinterpret_cast<uint32_t*>(&buffer[4])));
-
+            //make sure that header matches this version of OpenSpace and parse type
+            if (readMessageHeader(header, type)){
                 //and delegate decoding depending on type
                 delegateDecoding(type);
             }
             else{
-                LERROR("Error: Client OpenSpace version " << OPENSPACE_VERSION_MAJOR << ", " << OPENSPACE_VERSION_MINOR << " does not match server version " << buffer[2] <<", " << buffer[3] << std::endl << "Message not decoded.");
+                LERROR("Error: Client OpenSpace version " << OPENSPACE_VERSION_MAJOR << ", " << OPENSPACE_VERSION_MINOR << " does not match server version " << static_cast<int>(header[2]) <<", " << static_cast<int>(header[3]) << std::endl << "Message not decoded.");
             }
         }
         else{
@@ -820,26 +928,6 @@ void ParallelConnection::listenCommunication(){
     }
 
 }
-
-int ParallelConnection::receiveData(_SOCKET & socket, std::vector<char> &buffer, int length, int flags){
-    int result = 0;
-    int received = 0;
-    while (result < length){
-        received = recv(socket, buffer.data() + result, length - result, flags);
-
-        if (received > 0){
-            result += received;
-            received = 0;
-        }
-        else{
-            //error receiving
-            result = received;
-            break;
-        }
-    }
-
-    return result;
-}
         
 void ParallelConnection::setPort(const std::string  &port){
     _port = port;
@@ -859,15 +947,15 @@ bool ParallelConnection::isHost(){
         
 void ParallelConnection::requestHostship(const std::string &password){
     std::vector<char> buffer;
-    buffer.reserve(headerSize());
+    buffer.reserve(MessageHeaderSize + sizeof(uint32_t));
           
     uint32_t passcode = hash(password);
             
     //write header
-    writeHeader(buffer, MessageTypes::HostshipRequest);
+    writeMessageHeader(buffer, MessageTypes::HostshipRequest);
             
     //write passcode
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&passcode), reinterpret_cast<char*>(&passcode) + sizeof(uint32_t));
+    MessageWriter(buffer).encode(passcode);
             
     //send message
     queueMessage(buffer);
@@ -877,34 +965,8 @@ void ParallelConnection::setPassword(const std::string& pwd){
     _passCode = hash(pwd);
 }
 
-bool ParallelConnection::initNetworkAPI(){
-    #if defined(__WIN32__)
-        WSADATA wsaData;
-        WORD version;
-        int error;
-
-        version = MAKEWORD(2, 2);
-
-        error = WSAStartup(version, &wsaData);
-
-        if (error != 0 ||
-            LOBYTE(wsaData.wVersion) != 2 ||
-            HIBYTE(wsaData.wVersion) != 2)
-        {
-            /* incorrect WinSock version */
-            LERROR("Failed to init winsock API.");
-            //WSACleanup();
-            return false;
-        }
-    #else
-                //No init needed on unix
-    #endif
-
-    return true;
-}
-
 void ParallelConnection::preSynchronization(){
-            
+
     //if we're the host
     if(_isHost){
         //get current time parameters and create a keyframe
@@ -914,34 +976,12 @@ void ParallelConnection::preSynchronization(){
         tf._requiresTimeJump = Time::ref().timeJumped();
         tf._time = Time::ref().j2000Seconds();
                 
-        //create a buffer and serialize message
-        std::vector<char> tbuffer;
-        tf.serialize(tbuffer);
-                
-        //get the size of the keyframebuffer
-        uint16_t msglen = static_cast<uint16_t>(tbuffer.size());
-                
-        //the type of data message
-        uint16_t type = static_cast<uint16_t>(network::datamessagestructures::TimeData);
-                
-        //create the full buffer
-        std::vector<char> buffer;
-        buffer.reserve(headerSize() + sizeof(type) + sizeof(msglen) + msglen);
-                
-        //write header
-        writeHeader(buffer, MessageTypes::Data);
-                
-        //type of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&type), reinterpret_cast<char*>(&type) + sizeof(type));
-                
-        //size of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&msglen), reinterpret_cast<char*>(&msglen) + sizeof(msglen));
-                
-        //actual message
-        buffer.insert(buffer.end(), tbuffer.begin(), tbuffer.end());
-                
-        //send message
-        queueMessage(buffer);
+        //send message, replacing an unsent keyframe unless this one requires a jump
+        queueDataMessage(
+            network::datamessagestructures::TimeData,
+            tf,
+            tf._requiresTimeJump ? SendQueue::NoCoalescing : TimeKeyframeKey
+        );
     }
     else{
         //if we're not the host and we have a valid keyframe (one that hasnt been used before)
@@ -969,59 +1009,78 @@ void ParallelConnection::preSynchronization(){
     }
 }
         
-void ParallelConnection::scriptMessage(const std::string propIdentifier, const std::string propValue){
+void ParallelConnection::propertyMessage(const properties::Property& property){
+
+    const std::string uri = property.fullyQualifiedIdentifier();
+    std::string value;
+    property.getStringValue(value);
             
-    //save script as current state
+    //save value as current state
     {
         //mutex protect
         std::lock_guard<std::mutex> lock(_currentStateMutex);
-        _currentState[propIdentifier] = propValue;
+        _currentState[uri] = value;
     }
             
-    //if we're connected and we're the host, also send the script
-    if(_isConnected.load() && _isHost.load()){
-        //construct script
-        std::string script = scriptFromPropertyAndValue(propIdentifier, propValue);
-                
-        //create a script message
-        network::datamessagestructures::ScriptMessage sm;
-        sm._script = script;
-        sm._scriptlen = static_cast<uint16_t>(script.length());
-                
-        //create a buffer for the script
-        std::vector<char> sbuffer;
-                
-        //fill the script buffer
-        sm.serialize(sbuffer);
-                
-        //get the size of the keyframebuffer
-        uint16_t msglen = static_cast<uint16_t>(sbuffer.size());
-                
-        //the type of message
-        uint16_t type = static_cast<uint16_t>(network::datamessagestructures::ScriptData);
-                
-        //create the full buffer
-        std::vector<char> buffer;
-        buffer.reserve(headerSize() + sizeof(type) + sizeof(msglen) + msglen);
-                
-        //write header
-        writeHeader(buffer, MessageTypes::Data);
-                
-        //type of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&type), reinterpret_cast<char*>(&type) + sizeof(type));
-                
-        //size of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&msglen), reinterpret_cast<char*>(&msglen) + sizeof(msglen));
-                
-        //actual message
-        buffer.insert(buffer.end(), sbuffer.begin(), sbuffer.end());
-                
-        //send message
-        queueMessage(buffer);
+    //if we're connected and we're the host, also send the value
+    if(!_isConnected.load() || !_isHost.load()){
+        return;
     }
 
+    network::datamessagestructures::PropertyValue pv;
+    encodePropertyValue(property, pv);
+
+    std::lock_guard<std::mutex> lock(_propertyIdMutex);
+
+    //intern the uri
+    auto it = _propertyIds.find(uri);
+    if (it == _propertyIds.end()){
+        const uint32_t id = static_cast<uint32_t>(_propertyIds.size());
+        it = _propertyIds.emplace(uri, id).first;
+        _isPropertyIdAnnounced.push_back(false);
+    }
+    pv._id = it->second;
+
+    //bind the id to the uri before the first value that uses it
+    if (!_isPropertyIdAnnounced[pv._id]){
+        network::datamessagestructures::PropertyIdentifier pi;
+        pi._id = pv._id;
+        pi._uri = uri;
+        queueDataMessage(network::datamessagestructures::PropertyIdentifierData, pi);
+        _isPropertyIdAnnounced[pv._id] = true;
+    }
+
+    //an unsent value of the same property is replaced
+    queueDataMessage(
+        network::datamessagestructures::PropertyValueData,
+        pv,
+        PropertyValueKey + pv._id
+    );
 }
         
+void ParallelConnection::encodePropertyValue(const properties::Property& property,
+                                             datamessagestructures::PropertyValue& value)
+{
+    if (!encodeBinaryValue(property, value)){
+        //fall back to the value that would have been used in a script
+        std::string stringValue;
+        property.getStringValue(stringValue);
+        value._type = datamessagestructures::PropertyValue::Type::LuaString;
+        value._value.assign(stringValue.begin(), stringValue.end());
+    }
+}
+
+std::string ParallelConnection::scriptFromPropertyValue(const std::string& uri,
+                                     const datamessagestructures::PropertyValue& value)
+{
+    std::string v;
+    if (!luaValue(value, v)){
+        return "";
+    }
+    //the uri is exact, so the property does not have to be searched for wildcards
+    return "openspace.setPropertyValueSingle(\"" + uri + "\"," + v + ");";
+}
+
 std::string ParallelConnection::scriptFromPropertyAndValue(const std::string property, const std::string value){
     //consruct script
     std::string script = "openspace.setPropertyValue(\"" + property + "\"," + value + ");";
@@ -1041,64 +1100,22 @@ void ParallelConnection::broadcast(){
         //timestamp as current runtime of OpenSpace instance
         kf._timeStamp = OsEng.runTime();
                 
-        //create a buffer for the keyframe
-        std::vector<char> kfBuffer;
-                
-        //fill the keyframe buffer
-        kf.serialize(kfBuffer);
-                
-        //get the size of the keyframebuffer
-        uint16_t msglen = static_cast<uint16_t>(kfBuffer.size());
-                
-        //the type of message
-        uint16_t type = static_cast<uint16_t>(network::datamessagestructures::PositionData);
-                
-        //create the full buffer
-        std::vector<char> buffer;
-        buffer.reserve(headerSize() + sizeof(type) + sizeof(msglen) + msglen);
-                
-        //write header
-        writeHeader(buffer, MessageTypes::Data);
-                
-        //type of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&type), reinterpret_cast<char*>(&type) + sizeof(type));
-
-        //size of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&msglen), reinterpret_cast<char*>(&msglen) + sizeof(msglen));
-
-        //actual message
-        buffer.insert(buffer.end(), kfBuffer.begin(), kfBuffer.end());
-
-        //send message
-        queueMessage(buffer);
+        //send message, replacing the previous keyframe if it has not been sent yet
+        queueDataMessage(
+            network::datamessagestructures::PositionData,
+            kf,
+            PositionKeyframeKey
+        );
 
-        //100 ms sleep - send keyframes 10 times per second
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        //send keyframes 10 times per second, but wake up as soon as we have to stop
+        std::unique_lock<std::mutex> lock(_broadcastMutex);
+        _broadcastCondition.wait_for(
+            lock,
+            std::chrono::milliseconds(100),
+            [this]() { return !_isConnected.load() || !_isHost.load(); }
+        );
     }
 }
-        
-void ParallelConnection::writeHeader(std::vector<char> &buffer, uint32_t messageType){
-    //make sure the buffer is large enough to hold at least the header
-    if(buffer.size() < headerSize()){
-        buffer.reserve(headerSize());
-    }
-            
-    //get the current running version of openspace
-    uint8_t versionMajor = static_cast<uint8_t>(OPENSPACE_VERSION_MAJOR);
-    uint8_t versionMinor = static_cast<uint8_t>(OPENSPACE_VERSION_MINOR);
-            
-    //insert header into buffer
-    buffer.insert(buffer.end(), 'O');
-    buffer.insert(buffer.end(), 'S');
-    buffer.insert(buffer.end(), versionMajor);
-    buffer.insert(buffer.end(), versionMinor);
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&messageType), reinterpret_cast<char*>(&messageType) + sizeof(messageType));
-}
-        
-int ParallelConnection::headerSize(){
-    //minor and major version (as uint8_t -> 1 byte) + two bytes for the chars 'O' and 'S' + 4 bytes for type of message
-    return 2 * sizeof(uint8_t) + 2 + sizeof(uint32_t);
-}
 
 scripting::LuaLibrary ParallelConnection::luaLibrary() {
     return {
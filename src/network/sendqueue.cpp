@@ -22,102 +22,90 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#include <memory>
-#include <ostream>
-#include <thread>
-#include <queue>
-
-#include <modules/globebrowsing/other/concurrentqueue.h>
-#include <modules/globebrowsing/other/threadpool.h>
+#include <openspace/network/sendqueue.h>
 
 #include <ghoul/misc/assert.h>
-#include <iostream>
-
-
 
 namespace openspace {
-
-    Worker::Worker(ThreadPool& pool)
-        : pool(pool)
+namespace network {
+
+SendQueue::SendQueue(size_t capacity)
+    : _slots(capacity)
+    , _head(0)
+    , _size(0)
+    , _isOpen(false)
+{
+    ghoul_assert(capacity > 0, "Capacity must be bigger than 0");
+}
+
+void SendQueue::open() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isOpen = true;
+}
+
+void SendQueue::close() {
     {
-
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isOpen = false;
+        _head = 0;
+        _size = 0;
     }
+    _condition.notify_all();
+}
 
-    void Worker::operator()() {
-        std::function<void()> task;
-        while (true) {
-
-            // acquire lock
-            {
-                std::unique_lock<std::mutex> lock(pool.queue_mutex);
-
-                // look for a work item
-                while (!pool.stop && pool.tasks.empty()) {
-                    // if there are none wait for notification
-                    pool.condition.wait(lock);
-                }
-
-                if (pool.stop) { // exit if the pool is stopped
-                    return;
-                }
-
-                // get the task from the queue
-                task = pool.tasks.front();
-                pool.tasks.pop_front();
-
-            }// release lock
-
-            // execute the task
-            task();
-        }
-
-        
-    }
-
-
-
-
-
-    ThreadPool::ThreadPool(size_t numThreads)
-        : stop(false)
+bool SendQueue::push(const std::vector<char>& message, uint32_t coalescingKey) {
     {
-        for (size_t i = 0; i < numThreads; ++i) {
-            workers.push_back(std::thread(Worker(*this)));
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isOpen) {
+            return false;
         }
-    }
 
-    // the destructor joins all threads
-    ThreadPool::~ThreadPool() {
-        // stop all threads
-        stop = true;
-        condition.notify_all();
+        if (coalescingKey != NoCoalescing && _size > 0) {
+            Slot& newest = _slots[(_head + _size - 1) % _slots.size()];
+            if (newest.coalescingKey == coalescingKey) {
+                newest.message.assign(message.begin(), message.end());
+                return true;
+            }
+        }
 
-        // join them
-        for (size_t i = 0; i < workers.size(); ++i) {
-            workers[i].join();
+        if (_size == _slots.size()) {
+            grow();
         }
+        Slot& slot = _slots[(_head + _size) % _slots.size()];
+        slot.message.assign(message.begin(), message.end());
+        slot.coalescingKey = coalescingKey;
+        ++_size;
     }
-    
-
-    // add new work item to the pool
-    void ThreadPool::enqueue(std::function<void()> f) {
-        { // acquire lock
-            std::unique_lock<std::mutex> lock(queue_mutex);
-
-            // add the task
-            tasks.push_back(f);
-        } // release lock
-
-          // wake up one thread
-        condition.notify_one();
+    _condition.notify_one();
+    return true;
+}
+
+bool SendQueue::pop(std::vector<char>& message) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return !_isOpen || _size > 0; });
+    if (!_isOpen) {
+        return false;
     }
 
-    void ThreadPool::clearTasks() {
-        { // acquire lock
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            tasks.clear();
-        } // release lock
+    _slots[_head].message.swap(message);
+    _head = (_head + 1) % _slots.size();
+    --_size;
+    return true;
+}
+
+size_t SendQueue::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+void SendQueue::grow() {
+    std::vector<Slot> slots(_slots.size() * 2);
+    for (size_t i = 0; i < _size; ++i) {
+        slots[i] = std::move(_slots[(_head + i) % _slots.size()]);
     }
+    _slots = std::move(slots);
+    _head = 0;
+}
 
-
-} // namespace openspace
\ No newline at end of file
+} // namespace network
+} // namespace openspace
@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/socket.h>
+
+#include <ghoul/logging/logmanager.h>
+
+namespace {
+    const std::string _loggerCat = "Socket";
+}
+
+namespace openspace {
+namespace network {
+
+bool initializeSocketApi() {
+#if defined(__WIN32__)
+    WSADATA wsaData;
+    WORD version = MAKEWORD(2, 2);
+    int error = WSAStartup(version, &wsaData);
+
+    if (error != 0 || LOBYTE(wsaData.wVersion) != 2 || HIBYTE(wsaData.wVersion) != 2) {
+        // incorrect WinSock version
+        LERROR("Failed to init winsock API.");
+        return false;
+    }
+#endif
+    return true;
+}
+
+int sendAll(_SOCKET socket, const char* data, size_t length) {
+    size_t sent = 0;
+    while (sent < length) {
+        const int remaining = static_cast<int>(length - sent);
+        int result = send(socket, data + sent, remaining, 0);
+        if (result == SOCKET_ERROR) {
+            return SOCKET_ERROR;
+        }
+        sent += result;
+    }
+    return static_cast<int>(sent);
+}
+
+int receiveAll(_SOCKET socket, char* data, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+        const int remaining = static_cast<int>(length - received);
+        int result = recv(socket, data + received, remaining, 0);
+        if (result <= 0) {
+            // The connection was closed or the receive failed
+            return result;
+        }
+        received += result;
+    }
+    return static_cast<int>(received);
+}
+
+void closeSocket(_SOCKET& socket) {
+    /*
+        Windows shutdown options
+        * SD_RECIEVE
+        * SD_SEND
+        * SD_BOTH
+
+        Linux & Mac shutdown options
+        * SHUT_RD (Disables further receive operations)
+        * SHUT_WR (Disables further send operations)
+        * SHUT_RDWR (Disables further send and receive operations)
+    */
+#ifdef WIN32
+    shutdown(socket, SD_BOTH);
+    closesocket(socket);
+#else
+    shutdown(socket, SHUT_RDWR);
+    close(socket);
+#endif
+    socket = INVALID_SOCKET;
+}
+
+} // namespace network
+} // namespace openspace
@@ -24,7 +24,26 @@
 
 #include <openspace/performance/performancelayout.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+    // Writes the name as a quoted CSV cell, doubling all embedded quotes
+    void writeCsvName(std::ostream& stream, const std::string& name) {
+        stream << '"';
+        for (char c : name) {
+            if (c == '"') {
+                stream << '"';
+            }
+            stream << c;
+        }
+        stream << '"';
+    }
+}
 
 namespace openspace {
 namespace performance {
@@ -32,6 +51,7 @@ namespace performance {
 PerformanceLayout::PerformanceLayout()
     : nScaleGraphEntries(0)
     , nFunctionEntries(0)
+    , nFrames(0)
 {
     std::memset(
         sceneGraphEntries,
@@ -44,6 +64,121 @@ PerformanceLayout::PerformanceLayout()
         0,
         MaxValues * sizeof(FunctionPerformanceLayout)
     );
+
+    std::memset(&frameTime, 0, sizeof(Series));
+}
+
+void PerformanceLayout::Series::addValue(float value) {
+    if (count == NumberValues) {
+        // The window is full, so the value at the head is the oldest one and has to be
+        // removed from the sorted values before it is overwritten
+        const float evicted = values[head];
+        float* it = std::lower_bound(sortedValues, sortedValues + count, evicted);
+        std::move(it + 1, sortedValues + count, it);
+        --count;
+        sum -= evicted;
+    }
+
+    values[head] = value;
+    head = (head + 1) % NumberValues;
+
+    float* it = std::upper_bound(sortedValues, sortedValues + count, value);
+    std::move_backward(it, sortedValues + count, sortedValues + count + 1);
+    *it = value;
+    ++count;
+
+    if (head == 0) {
+        // Every time the ring buffer wraps around we recompute the sum so that the
+        // rounding errors of the incremental updates cannot accumulate
+        sum = std::accumulate(values, values + count, 0.0);
+    }
+    else {
+        sum += value;
+    }
+}
+
+int PerformanceLayout::Series::nValues() const {
+    return count;
+}
+
+float PerformanceLayout::Series::latest() const {
+    return count > 0 ? value(0) : 0.f;
+}
+
+float PerformanceLayout::Series::minimum() const {
+    return count > 0 ? sortedValues[0] : 0.f;
+}
+
+float PerformanceLayout::Series::maximum() const {
+    return count > 0 ? sortedValues[count - 1] : 0.f;
+}
+
+float PerformanceLayout::Series::average() const {
+    return count > 0 ? static_cast<float>(sum / count) : 0.f;
+}
+
+float PerformanceLayout::Series::percentile(float p) const {
+    if (count == 0) {
+        return 0.f;
+    }
+    const int rank = static_cast<int>(std::ceil(p / 100.f * count));
+    return sortedValues[std::min(std::max(rank, 1), static_cast<int>(count)) - 1];
+}
+
+float PerformanceLayout::Series::value(int age) const {
+    return values[(head - 1 - age + NumberValues) % NumberValues];
+}
+
+void PerformanceLayout::Series::histogram(float* bins, int nBins) const {
+    std::fill(bins, bins + nBins, 0.f);
+    if (count == 0 || nBins == 0) {
+        return;
+    }
+
+    const float min = minimum();
+    const float range = maximum() - min;
+    if (range <= 0.f) {
+        bins[0] = static_cast<float>(count);
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const int bin = static_cast<int>((sortedValues[i] - min) / range * nBins);
+        bins[std::min(bin, nBins - 1)] += 1.f;
+    }
+}
+
+void PerformanceLayout::writeCsv(std::ostream& stream) const {
+    std::vector<std::pair<std::string, const Series*>> columns;
+    columns.emplace_back("Frame time", &frameTime);
+    for (int i = 0; i < nScaleGraphEntries; ++i) {
+        const SceneGraphPerformanceLayout& e = sceneGraphEntries[i];
+        const std::string name = e.name;
+        columns.emplace_back(name + " (UpdateEphemeris)", &e.updateEphemeris);
+        columns.emplace_back(name + " (UpdateRender)", &e.updateRenderable);
+        columns.emplace_back(name + " (RenderTime)", &e.renderTime);
+    }
+    for (int i = 0; i < nFunctionEntries; ++i) {
+        columns.emplace_back(functionEntries[i].name, &functionEntries[i].time);
+    }
+
+    int nRows = 0;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        writeCsvName(stream, columns[i].first);
+        stream << (i == columns.size() - 1 ? '\n' : ',');
+        nRows = std::max(nRows, columns[i].second->nValues());
+    }
+
+    for (int row = 0; row < nRows; ++row) {
+        const int age = nRows - 1 - row;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            const Series& series = *(columns[i].second);
+            if (age < series.nValues()) {
+                stream << series.value(age);
+            }
+            stream << (i == columns.size() - 1 ? '\n' : ',');
+        }
+    }
 }
 
 } // namespace performance
@@ -203,6 +203,37 @@ PerformanceLayout* PerformanceManager::performanceData() {
 void PerformanceManager::storeIndividualPerformanceMeasurement
                                          (std::string identifier, long long microseconds)
 {
+    storeFunctionValue(identifier, static_cast<float>(microseconds));
+}
+
+void PerformanceManager::storeJobManagerStatistics(
+                                                  const JobManager::Statistics& statistics)
+{
+    // The job statistics are stored alongside the function measurements, so that they
+    // are plotted per frame in the same way
+    storeFunctionValue(
+        "JobManager: Queued jobs",
+        static_cast<float>(statistics.nQueuedJobs)
+    );
+    storeFunctionValue(
+        "JobManager: Queued continuations",
+        static_cast<float>(statistics.nQueuedContinuations)
+    );
+    storeFunctionValue(
+        "JobManager: Worker utilization (%)",
+        static_cast<float>(statistics.utilization * 100.0)
+    );
+}
+
+void PerformanceManager::storeFrameTime(double seconds) {
+    PerformanceLayout* layout = performanceData();
+    _performanceMemory->acquireLock();
+    layout->frameTime.addValue(static_cast<float>(seconds * 1000000.0));
+    ++(layout->nFrames);
+    _performanceMemory->releaseLock();
+}
+
+void PerformanceManager::storeFunctionValue(const std::string& identifier, float value) {
     PerformanceLayout* layout = performanceData();
     _performanceMemory->acquireLock();
 
@@ -212,23 +243,17 @@ void PerformanceManager::storeIndividualPerformanceMeasurement
         p = &(layout->functionEntries[layout->nFunctionEntries]);
         individualPerformanceLocations[identifier] = layout->nFunctionEntries;
         ++(layout->nFunctionEntries);
+#ifdef _MSC_VER
+        strcpy_s(p->name, identifier.length() + 1, identifier.c_str());
+#else
+        strcpy(p->name, identifier.c_str());
+#endif
     }
     else {
         p = &(layout->functionEntries[it->second]);
     }
-#ifdef _MSC_VER
-    strcpy_s(p->name, identifier.length() + 1, identifier.c_str());
-#else
-    strcpy(p->name, identifier.c_str());
-#endif
     
-    std::rotate(
-        std::begin(p->time),
-        std::next(std::begin(p->time)),
-        std::end(p->time)
-    );
-    p->time[PerformanceLayout::NumberValues - 1] =
-        static_cast<float>(microseconds);
+    p->time.addValue(value);
 
     _performanceMemory->releaseLock();
 }
@@ -245,37 +270,23 @@ void PerformanceManager::storeScenePerformanceMeasurements(
     layout->nScaleGraphEntries = nNodes;
     for (int i = 0; i < nNodes; ++i) {
         SceneGraphNode* node = sceneNodes[i];
+        PerformanceLayout::SceneGraphPerformanceLayout& entry = layout->sceneGraphEntries[i];
 
-        memset(layout->sceneGraphEntries[i].name, 0, PerformanceLayout::LengthName);
+        if (node->name() != entry.name) {
+            // The scene graph has changed, so the values stored in this slot belong to a
+            // different node and are discarded
+            memset(&entry, 0, sizeof(PerformanceLayout::SceneGraphPerformanceLayout));
 #ifdef _MSC_VER
-        strcpy_s(layout->sceneGraphEntries[i].name, node->name().length() + 1, node->name().c_str());
+            strcpy_s(entry.name, node->name().length() + 1, node->name().c_str());
 #else
-        strcpy(layout->sceneGraphEntries[i].name, node->name().c_str());
+            strcpy(entry.name, node->name().c_str());
 #endif
+        }
         
         SceneGraphNode::PerformanceRecord r = node->performanceRecord();
-        PerformanceLayout::SceneGraphPerformanceLayout& entry = layout->sceneGraphEntries[i];
-
-        std::rotate(
-            std::begin(entry.renderTime),
-            std::next(std::begin(entry.renderTime)),
-            std::end(entry.renderTime)
-        );
-        entry.renderTime[PerformanceLayout::NumberValues - 1] = r.renderTime / 1000.f;
-        
-        std::rotate(
-            std::begin(entry.updateEphemeris),
-            std::next(std::begin(entry.updateEphemeris)),
-            std::end(entry.updateEphemeris)
-        );
-        entry.updateEphemeris[PerformanceLayout::NumberValues - 1] = r.updateTimeEphemeris / 1000.f;
-        
-        std::rotate(
-            std::begin(entry.updateRenderable),
-            std::next(std::begin(entry.updateRenderable)),
-            std::end(entry.updateRenderable)
-        );
-        entry.updateRenderable[PerformanceLayout::NumberValues - 1] = r.updateTimeRenderable / 1000.f;
+        entry.renderTime.addValue(r.renderTime / 1000.f);
+        entry.updateEphemeris.addValue(r.updateTimeEphemeris / 1000.f);
+        entry.updateRenderable.addValue(r.updateTimeRenderable / 1000.f);
     }
     _performanceMemory->releaseLock();
 }
@@ -32,6 +32,8 @@
 namespace openspace {
 namespace properties {
 
+std::atomic<uint64_t> PropertyOwner::_structureVersion(0);
+
 namespace {
 const std::string _loggerCat = "PropertyOwner";
 
@@ -55,6 +57,7 @@ PropertyOwner::PropertyOwner()
 PropertyOwner::~PropertyOwner() {
     _properties.clear();
     _subOwners.clear();
+    ++_structureVersion;
 }
 
 std::vector<Property*> PropertyOwner::properties() const {
@@ -186,6 +189,7 @@ void PropertyOwner::addProperty(Property* prop)
             // now have found the correct position to add it in
             _properties.insert(it, prop);
             prop->setPropertyOwner(this);
+            ++_structureVersion;
         }
     }
 }
@@ -228,6 +232,7 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
             // Otherwise we have found the correct position to add it in
             _subOwners.insert(it, owner);
             owner->setPropertyOwner(this);
+            ++_structureVersion;
         }
     }
     
@@ -251,6 +256,7 @@ void PropertyOwner::removeProperty(Property* prop) {
     if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
         (*it)->setPropertyOwner(nullptr);
         _properties.erase(it);
+        ++_structureVersion;
     } else
         LERROR("Property with identifier '" << prop->identifier()
                                             << "' not found for removal.");
@@ -273,6 +279,7 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
     // If we found the propertyowner, we can delete it
     if (it != _subOwners.end() && (*it)->name() == owner->name()) {
         _subOwners.erase(it);
+        ++_structureVersion;
     } else
         LERROR("PropertyOwner with name '" << owner->name()
                << "' not found for removal.");
@@ -284,6 +291,11 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner&
 
 void PropertyOwner::setName(std::string name) {
     _name = std::move(name);
+    ++_structureVersion;
+}
+
+uint64_t PropertyOwner::structureVersion() {
+    return _structureVersion;
 }
 
 const std::string& PropertyOwner::name() const {
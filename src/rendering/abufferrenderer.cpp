@@ -43,8 +43,10 @@
 
 
 
-#include <string>
+#include <algorithm>
+#include <array>
 #include <iterator>
+#include <string>
 
 namespace {
     const std::string _loggerCat = "ABufferRenderer";
@@ -52,8 +54,20 @@ namespace {
     const std::string RenderFragmentShaderPath = "${SHADERS}/abuffer/renderabuffer.frag";
     const std::string PostRenderFragmentShaderPath = "${SHADERS}/abuffer/postrenderabuffer.frag";
     const int MaxRaycasters = 32;
+    const int RaycasterSlotsPerType = 4;
+    const std::string RaycasterUniformsBlock = "RaycasterUniforms";
+    const GLuint RaycasterUniformsBinding = 0;
     const int MaxLayers = 32;
     const int MaxAverageLayers = 8;
+
+    // The sampler types that can be declared by raycasters
+    const std::vector<GLenum> SamplerTypes = {
+        GL_SAMPLER_1D, GL_SAMPLER_2D, GL_SAMPLER_3D, GL_SAMPLER_CUBE,
+        GL_SAMPLER_1D_ARRAY, GL_SAMPLER_2D_ARRAY, GL_SAMPLER_2D_MULTISAMPLE,
+        GL_SAMPLER_BUFFER, GL_INT_SAMPLER_1D, GL_INT_SAMPLER_2D, GL_INT_SAMPLER_3D,
+        GL_INT_SAMPLER_BUFFER, GL_UNSIGNED_INT_SAMPLER_1D, GL_UNSIGNED_INT_SAMPLER_2D,
+        GL_UNSIGNED_INT_SAMPLER_3D, GL_UNSIGNED_INT_SAMPLER_BUFFER
+    };
 }
 
 namespace openspace {
@@ -67,7 +81,9 @@ ABufferRenderer::ABufferRenderer()
         , _dirtyRaycastData(true)
         , _dirtyRendererData(true)
         , _dirtyResolveDictionary(true)
-        , _resolveProgram(nullptr) { }
+        , _resolveProgram(nullptr)
+        , _raycasterRegistry(MaxRaycasters, RaycasterSlotsPerType)
+        , _raycasterUniformBuffer(0) { }
 
 ABufferRenderer::~ABufferRenderer() {}
 
@@ -108,6 +124,8 @@ void ABufferRenderer::initialize() {
     glGenTextures(1, &_mainDepthTexture);
     glGenFramebuffers(1, &_mainFramebuffer);
 
+    glGenBuffers(1, &_raycasterUniformBuffer);
+
     GLint defaultFbo;
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
 
@@ -139,6 +157,7 @@ void ABufferRenderer::initialize() {
             "${SHADERS}/abuffer/resolveabuffer.vert",
             "${SHADERS}/abuffer/resolveabuffer.frag",
             dict);
+        updateResolveUniformLocations();
     } catch (ghoul::RuntimeError e) {
         LERROR(e.message);
     }
@@ -154,6 +173,7 @@ void ABufferRenderer::deinitialize() {
     glDeleteTextures(1, &_anchorPointerTexture);
     glDeleteBuffers(1, &_anchorPointerTextureInitializer);
     glDeleteBuffers(1, &_atomicCounterBuffer);
+    glDeleteBuffers(1, &_raycasterUniformBuffer);
 
     glDeleteBuffers(1, &_vertexPositionBuffer);
     glDeleteVertexArrays(1, &_screenQuad);
@@ -206,6 +226,7 @@ void ABufferRenderer::update() {
     if (_resolveProgram->isDirty()) {
         try {
             _resolveProgram->rebuildFromFile();
+            updateResolveUniformLocations();
         } catch (ghoul::RuntimeError& error) {
             LERROR(error.message);
         }
@@ -266,7 +287,9 @@ void ABufferRenderer::render(float blackoutFactor, bool doPerformanceMeasurement
         static_cast<int>(Renderable::RenderBin::Transparent) |
         static_cast<int>(Renderable::RenderBin::Overlay);
 
-    RenderData data{ *_camera, psc(), doPerformanceMeasurements, renderBinMask };
+    // All renderables see the same camera state for the whole frame
+    Camera::SnapshotReference camera = _camera->snapshot();
+    RenderData data{ *camera, psc(), doPerformanceMeasurements, renderBinMask };
     RendererTasks tasks;
     _scene->render(data, tasks);
 
@@ -280,7 +303,9 @@ void ABufferRenderer::render(float blackoutFactor, bool doPerformanceMeasurement
     // Step 2: Perform raycasting tasks requested by the scene
     for (const RaycasterTask& raycasterTask : tasks.raycasterTasks) {
         VolumeRaycaster* raycaster = raycasterTask.raycaster;
-        ghoul::opengl::ProgramObject* program = _boundsPrograms[raycaster].get();
+        auto it = _boundsPrograms.find(raycaster);
+        ghoul::opengl::ProgramObject* program =
+            it != _boundsPrograms.end() ? it->second.get() : nullptr;
         if (program) {
             program->activate();
             program->setUniform("_exit_", false);
@@ -311,7 +336,7 @@ void ABufferRenderer::render(float blackoutFactor, bool doPerformanceMeasurement
     t = glm::clamp(t, 0.0f, 1.0f);
     gamma = 1.0 * (1 - t) + 2.2 * t;
 
-    _resolveProgram->setUniform("gamma", gamma);
+    _resolveProgram->setUniform(_resolveUniforms.gamma, gamma);
 
     // END TEMPORARY GAMMA CORRECTION.
 
@@ -330,29 +355,56 @@ void ABufferRenderer::render(float blackoutFactor, bool doPerformanceMeasurement
 
 
 void ABufferRenderer::preRaycast(ghoul::opengl::ProgramObject& program) {
-
-    program.setUniform("mainColorTexture", _mainColorTextureUnit->unitNumber());
-    program.setUniform("mainDepthTexture", _mainDepthTextureUnit->unitNumber());
-    
-    for (const auto& raycastData : _raycastData) {
+    program.setUniform(
+        _resolveUniforms.mainColorTexture,
+        _mainColorTextureUnit->unitNumber()
+    );
+    program.setUniform(
+        _resolveUniforms.mainDepthTexture,
+        _mainDepthTextureUnit->unitNumber()
+    );
+
+    // The camera position in each raycaster's local coordinates is stored in the xyz
+    // components of its slot in the uniform block, the w component is 1 if the camera is
+    // inside the raycaster's volume. Unused slots are left as zero
+    std::fill(_raycasterUniformData.begin(), _raycasterUniformData.end(), glm::vec4(0.f));
+    for (const auto& raycastData : _raycasterRegistry.raycastData()) {
         raycastData.first->preRaycast(raycastData.second, program);
 
         glm::vec3 localCameraPosition;
-        bool cameraIsInside = raycastData.first->cameraIsInside(*_renderData, localCameraPosition);
-        int uniformIndex = raycastData.second.id + 1; // uniforms are indexed from 1 (not from 0)
-        program.setUniform("insideRaycaster" + std::to_string(uniformIndex), cameraIsInside);
-        if (cameraIsInside) {
-            program.setUniform("cameraPosInRaycaster" + std::to_string(uniformIndex), localCameraPosition);
-        }
+        bool cameraIsInside = raycastData.first->cameraIsInside(
+            *_renderData,
+            localCameraPosition
+        );
+        _raycasterUniformData[raycastData.second.id] = glm::vec4(
+            localCameraPosition,
+            cameraIsInside ? 1.f : 0.f
+        );
+    }
+
+    if (!_raycasterUniformData.empty()) {
+        glBindBuffer(GL_UNIFORM_BUFFER, _raycasterUniformBuffer);
+        glBufferData(
+            GL_UNIFORM_BUFFER,
+            _raycasterUniformData.size() * sizeof(glm::vec4),
+            _raycasterUniformData.data(),
+            GL_STREAM_DRAW
+        );
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(
+            GL_UNIFORM_BUFFER,
+            RaycasterUniformsBinding,
+            _raycasterUniformBuffer
+        );
     }
 
     // 3b: Set "global" uniforms, and start the resolve pass.
-    program.setUniform("blackoutFactor", _blackoutFactor);
-    program.setUniform("nAaSamples", _nAaSamples);
+    program.setUniform(_resolveUniforms.blackoutFactor, _blackoutFactor);
+    program.setUniform(_resolveUniforms.nAaSamples, _nAaSamples);
 }
 
 void ABufferRenderer::postRaycast(ghoul::opengl::ProgramObject& program) {
-    for (const auto& raycastData : _raycastData) {
+    for (const auto& raycastData : _raycasterRegistry.raycastData()) {
         raycastData.first->postRaycast(raycastData.second, program);
     }
 }
@@ -451,87 +503,89 @@ void ABufferRenderer::updateResolution() {
 
 
 void ABufferRenderer::updateResolveDictionary() {
-    ghoul::Dictionary dict;
+    ghoul::Dictionary dict = _raycasterRegistry.resolveDictionary();
+    dict.setValue("storeSorted", true);
 
-    ghoul::Dictionary raycastersDict;
+    _resolveDictionary = dict;
+    _raycasterUniformData.resize(_raycasterRegistry.nReservedSlots());
 
-    for (const auto &raycastPair : _raycastData) {
-        ghoul::Dictionary innerDict;
-        int id = raycastPair.second.id;
-        std::string namespaceName = raycastPair.second.namespaceName;
-        std::string raycastPath = raycastPair.first->getRaycastPath();
+    OsEng.renderEngine().setResolveData(dict);
 
-        innerDict.setValue("id", id);
-        innerDict.setValue("namespace", namespaceName);
-        innerDict.setValue("bitmask", 1 << id);
-        innerDict.setValue("raycastPath", raycastPath);
+    _dirtyResolveDictionary = false;
+}
 
-        raycastersDict.setValue(std::to_string(id), innerDict);
+void ABufferRenderer::updateResolveUniformLocations() {
+    if (!_resolveProgram) {
+        return;
     }
 
-    dict.setValue("raycasters", raycastersDict);
-
-    ghoul::Dictionary helperPathsDict;
-    for (int i = 0; i < _helperPaths.size(); i++) {
-        helperPathsDict.setValue(std::to_string(i), _helperPaths[i]);
+    ghoul::opengl::ProgramObject& program = *_resolveProgram;
+    _resolveUniforms.mainColorTexture = program.uniformLocation("mainColorTexture");
+    _resolveUniforms.mainDepthTexture = program.uniformLocation("mainDepthTexture");
+    _resolveUniforms.blackoutFactor = program.uniformLocation("blackoutFactor");
+    _resolveUniforms.nAaSamples = program.uniformLocation("nAaSamples");
+    _resolveUniforms.gamma = program.uniformLocation("gamma");
+
+    // The uniform block only exists if there is at least one raycaster slot
+    GLuint blockIndex = glGetUniformBlockIndex(
+        GLuint(program),
+        RaycasterUniformsBlock.c_str()
+    );
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(GLuint(program), blockIndex, RaycasterUniformsBinding);
     }
 
-    dict.setValue("helperPaths", helperPathsDict);
-    dict.setValue("raycastingEnabled", _raycastData.size() > 0);
-    dict.setValue("storeSorted", true);
-    dict.setValue("nRaycasters", static_cast<unsigned long long>(_raycastData.size()));
-
-    _resolveDictionary = dict;
-
-    OsEng.renderEngine().setResolveData(dict);
-
-    _dirtyResolveDictionary = false;
+    // Reserved slots that are not occupied by a raycaster never get their samplers set,
+    // which would leave samplers of different types referring to texture unit 0. Point
+    // each sampler type to a separate unit at the end of the range instead; samplers
+    // that are in use are overwritten every frame
+    GLint nTextureUnits = 0;
+    glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &nTextureUnits);
+    GLint nUniforms = 0;
+    glGetProgramiv(GLuint(program), GL_ACTIVE_UNIFORMS, &nUniforms);
+    for (GLint i = 0; i < nUniforms; ++i) {
+        std::array<GLchar, 256> name;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(
+            GLuint(program),
+            i,
+            static_cast<GLsizei>(name.size()),
+            nullptr,
+            &size,
+            &type,
+            name.data()
+        );
+        auto it = std::find(SamplerTypes.begin(), SamplerTypes.end(), type);
+        if (it != SamplerTypes.end()) {
+            GLint unit = nTextureUnits - 1 -
+                static_cast<GLint>(std::distance(SamplerTypes.begin(), it));
+            glProgramUniform1i(
+                GLuint(program),
+                glGetUniformLocation(GLuint(program), name.data()),
+                unit
+            );
+        }
+    }
 }
 
 void ABufferRenderer::updateRaycastData() {
     PerfMeasure("ABufferRenderer::updateRaycastData");
 
-    _raycastData.clear();
-    _boundsPrograms.clear();
-    _helperPaths.clear();
+    const std::vector<VolumeRaycaster*>& raycasters =
+        OsEng.renderEngine().raycasterManager().raycasters();
 
-    const std::vector<VolumeRaycaster*>& raycasters = OsEng.renderEngine().raycasterManager().raycasters();
+    // Raycasters keep their slot while they are attached, so only the bounds programs of
+    // the raycasters that changed have to be touched
+    RaycasterRegistry::Changes changes = _raycasterRegistry.update(raycasters);
 
-    std::map<std::string, int> namespaceIndices;
-    int nextId = 0; // raycaster ids are positive integers starting at 0. (for raycasters, fragment type is id+1)
-    int nextNamespaceIndex = 0;
-
-    for (auto &raycaster : raycasters) {
-        if (nextId > MaxRaycasters) {
-            int nIgnored = MaxRaycasters - raycasters.size();
-            LWARNING("ABufferRenderer does not support more than 32 raycasters. Ignoring " << nIgnored << " raycasters");
-            break;
-        }
+    for (VolumeRaycaster* raycaster : changes.removed) {
+        _boundsPrograms.erase(raycaster);
+    }
 
-        RaycastData data;
-        data.id = nextId++;
-
-        std::string helperPath = raycaster->getHelperPath();
-        // Each new helper path generates a new namespace,
-        // to avoid glsl name collisions between raycaster implementaitons.
-        // Assign a new namespace or find an already created index.
-
-        if (helperPath == "") {
-            data.namespaceName = "NAMESPACE_" + std::to_string(nextNamespaceIndex++);
-        } else {
-            auto iter = namespaceIndices.find(helperPath);
-            if (iter == namespaceIndices.end()) {
-                int namespaceIndex = nextNamespaceIndex++;
-                data.namespaceName = std::to_string(namespaceIndex);
-                namespaceIndices[helperPath] = namespaceIndex;
-                _helperPaths.push_back(helperPath);
-            }
-            else {
-                data.namespaceName = "NAMESPACE_" + std::to_string(iter->second);
-            }
-        }
+    for (VolumeRaycaster* raycaster : changes.added) {
+        const RaycastData& data = *_raycasterRegistry.raycastData(raycaster);
 
-        _raycastData[raycaster] = data;
         std::string vsPath = raycaster->getBoundsVsPath();
         std::string fsPath = raycaster->getBoundsFsPath();
         ghoul::Dictionary dict;
@@ -544,7 +598,12 @@ void ABufferRenderer::updateRaycastData() {
         dict.setValue("fragmentPath", fsPath);
         dict.setValue("fragmentType", data.id + 1);
         try {
-            _boundsPrograms[raycaster] = ghoul::opengl::ProgramObject::Build("Volume " + std::to_string(data.id) + " bounds", vsPath, BoundsFragmentShaderPath, dict);
+            _boundsPrograms[raycaster] = ghoul::opengl::ProgramObject::Build(
+                "Volume " + std::to_string(data.id) + " bounds",
+                vsPath,
+                BoundsFragmentShaderPath,
+                dict
+            );
         }
         catch (ghoul::RuntimeError& error) {
             LERROR(error.message);
@@ -552,8 +611,10 @@ void ABufferRenderer::updateRaycastData() {
     }
 
     _dirtyRaycastData = false;
-    _dirtyResolveDictionary = true;
-
+    // The resolve program only has to be rebuilt if the reserved slots changed
+    if (changes.reservationsChanged) {
+        _dirtyResolveDictionary = true;
+    }
 }
 
 
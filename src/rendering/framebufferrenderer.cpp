@@ -48,6 +48,7 @@ namespace {
     const std::string RaycastFragmentShaderPath = "${SHADERS}/framebuffer/raycastframebuffer.frag";
     const std::string RenderFragmentShaderPath = "${SHADERS}/framebuffer/renderframebuffer.frag";
     const std::string PostRenderFragmentShaderPath = "${SHADERS}/framebuffer/postrenderframebuffer.frag";
+    const int MaxRaycasters = 32;
 }
 
 namespace openspace {
@@ -55,7 +56,8 @@ namespace openspace {
 FramebufferRenderer::FramebufferRenderer()
     : _camera(nullptr)
     , _scene(nullptr)
-    , _resolution(glm::vec2(0)) {
+    , _resolution(glm::vec2(0))
+    , _raycasterRegistry(MaxRaycasters, 1) {
 }
 
 FramebufferRenderer::~FramebufferRenderer() {}
@@ -120,6 +122,7 @@ void FramebufferRenderer::initialize() {
         _resolveProgram = ghoul::opengl::ProgramObject::Build("Framebuffer Resolve",
             "${SHADERS}/framebuffer/resolveframebuffer.vert",
             "${SHADERS}/framebuffer/resolveframebuffer.frag");
+        updateResolveUniformLocations();
     } catch (ghoul::RuntimeError e) {
         LERROR(e.message);
     }
@@ -168,6 +171,7 @@ void FramebufferRenderer::update() {
     if (_resolveProgram->isDirty()) {
         try {
             _resolveProgram->rebuildFromFile();
+            updateResolveUniformLocations();
         } catch (ghoul::RuntimeError& error) {
             LERROR(error.message);
         }
@@ -187,6 +191,7 @@ void FramebufferRenderer::update() {
         if (program.second->isDirty()) {
             try {
                 program.second->rebuildFromFile();
+                updateRaycastUniformLocations(*program.second);
             } catch (ghoul::RuntimeError e) {
                 LERROR(e.message);
             }
@@ -197,6 +202,7 @@ void FramebufferRenderer::update() {
         if (program.second->isDirty()) {
             try {
                 program.second->rebuildFromFile();
+                updateRaycastUniformLocations(*program.second);
             }
             catch (ghoul::RuntimeError e) {
                 LERROR(e.message);
@@ -265,17 +271,29 @@ void FramebufferRenderer::updateResolution() {
 void FramebufferRenderer::updateRaycastData() {
     PerfMeasure("FramebufferRenderer::updateRaycastData");
 
-    _raycastData.clear();
-    _exitPrograms.clear();
-    _raycastPrograms.clear();
-    _insideRaycastPrograms.clear();
+    const std::vector<VolumeRaycaster*>& raycasters =
+        OsEng.renderEngine().raycasterManager().raycasters();
 
-    const std::vector<VolumeRaycaster*>& raycasters = OsEng.renderEngine().raycasterManager().raycasters();
-    int nextId = 0;
-    for (auto &raycaster : raycasters) {
-        RaycastData data;
-        data.id = nextId++;
-        data.namespaceName = "HELPER";
+    // Raycasters keep their id while they are attached, so only the programs of the
+    // raycasters that changed have to be touched
+    RaycasterRegistry::Changes changes = _raycasterRegistry.update(raycasters);
+
+    for (VolumeRaycaster* raycaster : changes.removed) {
+        auto raycastIt = _raycastPrograms.find(raycaster);
+        if (raycastIt != _raycastPrograms.end()) {
+            _raycastUniforms.erase(raycastIt->second.get());
+            _raycastPrograms.erase(raycastIt);
+        }
+        auto insideIt = _insideRaycastPrograms.find(raycaster);
+        if (insideIt != _insideRaycastPrograms.end()) {
+            _raycastUniforms.erase(insideIt->second.get());
+            _insideRaycastPrograms.erase(insideIt);
+        }
+        _exitPrograms.erase(raycaster);
+    }
+
+    for (VolumeRaycaster* raycaster : changes.added) {
+        const RaycastData& data = *_raycasterRegistry.raycastData(raycaster);
 
         std::string vsPath = raycaster->getBoundsVsPath();
         std::string fsPath = raycaster->getBoundsFsPath();
@@ -292,8 +310,6 @@ void FramebufferRenderer::updateRaycastData() {
         dict.setValue("helperPaths", helpersDict);
         dict.setValue("raycastPath", raycaster->getRaycastPath());
 
-        _raycastData[raycaster] = data;
-
         try {
             _exitPrograms[raycaster] = ghoul::opengl::ProgramObject::Build("Volume " + std::to_string(data.id) + " exit", vsPath, ExitFragmentShaderPath, dict);
         }
@@ -302,6 +318,7 @@ void FramebufferRenderer::updateRaycastData() {
         }
         try {
             _raycastPrograms[raycaster] = ghoul::opengl::ProgramObject::Build("Volume " + std::to_string(data.id) + " raycast", vsPath, RaycastFragmentShaderPath, dict);
+            updateRaycastUniformLocations(*_raycastPrograms[raycaster]);
         } catch (ghoul::RuntimeError e) {
             LERROR(e.message);
         }
@@ -310,6 +327,7 @@ void FramebufferRenderer::updateRaycastData() {
                 "Volume " + std::to_string(data.id) + " inside raycast",
                 "${SHADERS}/framebuffer/resolveframebuffer.vert",
                 RaycastFragmentShaderPath, dict);
+            updateRaycastUniformLocations(*_insideRaycastPrograms[raycaster]);
         }
         catch (ghoul::RuntimeError e) {
             LERROR(e.message);
@@ -318,6 +336,26 @@ void FramebufferRenderer::updateRaycastData() {
     _dirtyRaycastData = false;
 }
 
+void FramebufferRenderer::updateRaycastUniformLocations(
+                                                   ghoul::opengl::ProgramObject& program)
+{
+    RaycastUniforms& uniforms = _raycastUniforms[&program];
+    uniforms.insideRaycaster = program.uniformLocation("insideRaycaster");
+    uniforms.cameraPosInRaycaster = program.uniformLocation("cameraPosInRaycaster");
+    uniforms.exitColorTexture = program.uniformLocation("exitColorTexture");
+    uniforms.exitDepthTexture = program.uniformLocation("exitDepthTexture");
+    uniforms.mainDepthTexture = program.uniformLocation("mainDepthTexture");
+    uniforms.nAaSamples = program.uniformLocation("nAaSamples");
+}
+
+void FramebufferRenderer::updateResolveUniformLocations() {
+    _resolveUniforms.mainColorTexture = _resolveProgram->uniformLocation(
+        "mainColorTexture"
+    );
+    _resolveUniforms.blackoutFactor = _resolveProgram->uniformLocation("blackoutFactor");
+    _resolveUniforms.nAaSamples = _resolveProgram->uniformLocation("nAaSamples");
+}
+
 void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasurements) {
     PerfMeasure("FramebufferRenderer::render");
     
@@ -330,7 +368,9 @@ void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasure
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    RenderData data = { *_camera, psc(), doPerformanceMeasurements, 0 };
+    // All renderables see the same camera state for the whole frame
+    Camera::SnapshotReference camera = _camera->snapshot();
+    RenderData data = { *camera, psc(), doPerformanceMeasurements, 0 };
     RendererTasks tasks;
 
     // Capture standard fbo
@@ -351,6 +391,11 @@ void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasure
 
     for (const RaycasterTask& raycasterTask : tasks.raycasterTasks) {
         VolumeRaycaster* raycaster = raycasterTask.raycaster;
+        const RaycastData* raycastData = _raycasterRegistry.raycastData(raycaster);
+        if (!raycastData) {
+            LWARNING("Raycaster is not attached when trying to perform raycaster task");
+            continue;
+        }
 
         glBindFramebuffer(GL_FRAMEBUFFER, _exitFramebuffer);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -364,9 +409,6 @@ void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasure
 
         glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
 
-        
-        ghoul::opengl::ProgramObject* insideRaycastProgram = _raycastPrograms[raycaster].get();
-
         glm::vec3 cameraPosition;
         bool cameraIsInside = raycaster->cameraIsInside(raycasterTask.renderData, cameraPosition);
         ghoul::opengl::ProgramObject* raycastProgram = nullptr;
@@ -378,29 +420,39 @@ void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasure
         }
         
         if (raycastProgram) {
+            const RaycastUniforms& uniforms = _raycastUniforms[raycastProgram];
             raycastProgram->activate();
 
-            raycastProgram->setUniform("insideRaycaster", cameraIsInside);
-            raycastProgram->setUniform("cameraPosInRaycaster", cameraPosition);
+            raycastProgram->setUniform(uniforms.insideRaycaster, cameraIsInside);
+            raycastProgram->setUniform(uniforms.cameraPosInRaycaster, cameraPosition);
 
-            raycaster->preRaycast(_raycastData[raycaster], *raycastProgram);
+            raycaster->preRaycast(*raycastData, *raycastProgram);
 
             ghoul::opengl::TextureUnit exitColorTextureUnit;
             exitColorTextureUnit.activate();
             glBindTexture(GL_TEXTURE_2D, _exitColorTexture);
-            raycastProgram->setUniform("exitColorTexture", exitColorTextureUnit);
+            raycastProgram->setUniform(
+                uniforms.exitColorTexture,
+                exitColorTextureUnit.unitNumber()
+            );
 
             ghoul::opengl::TextureUnit exitDepthTextureUnit;
             exitDepthTextureUnit.activate();
             glBindTexture(GL_TEXTURE_2D, _exitDepthTexture);
-            raycastProgram->setUniform("exitDepthTexture", exitDepthTextureUnit);
+            raycastProgram->setUniform(
+                uniforms.exitDepthTexture,
+                exitDepthTextureUnit.unitNumber()
+            );
 
             ghoul::opengl::TextureUnit mainDepthTextureUnit;
             mainDepthTextureUnit.activate();
             glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainDepthTexture);
-            raycastProgram->setUniform("mainDepthTexture", mainDepthTextureUnit);
+            raycastProgram->setUniform(
+                uniforms.mainDepthTexture,
+                mainDepthTextureUnit.unitNumber()
+            );
 
-            raycastProgram->setUniform("nAaSamples", _nAaSamples);
+            raycastProgram->setUniform(uniforms.nAaSamples, _nAaSamples);
 
 
             glDisable(GL_DEPTH_TEST);
@@ -417,7 +469,7 @@ void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasure
 
 
 
-            raycaster->postRaycast(_raycastData[raycaster], *raycastProgram);
+            raycaster->postRaycast(*raycastData, *raycastProgram);
             raycastProgram->deactivate();
         } else {
             LWARNING("Raycaster is not attached when trying to perform raycaster task");
@@ -431,9 +483,12 @@ void FramebufferRenderer::render(float blackoutFactor, bool doPerformanceMeasure
     mainColorTextureUnit.activate();
     glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainColorTexture);
 
-    _resolveProgram->setUniform("mainColorTexture", mainColorTextureUnit);
-    _resolveProgram->setUniform("blackoutFactor", blackoutFactor);
-    _resolveProgram->setUniform("nAaSamples", _nAaSamples);
+    _resolveProgram->setUniform(
+        _resolveUniforms.mainColorTexture,
+        mainColorTextureUnit.unitNumber()
+    );
+    _resolveProgram->setUniform(_resolveUniforms.blackoutFactor, blackoutFactor);
+    _resolveProgram->setUniform(_resolveUniforms.nAaSamples, _nAaSamples);
     glBindVertexArray(_screenQuad);
     glDrawArrays(GL_TRIANGLES, 0, 6);
     glBindVertexArray(0);
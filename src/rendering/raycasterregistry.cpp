@@ -0,0 +1,261 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/raycasterregistry.h>
+
+#include <openspace/rendering/volumeraycaster.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <set>
+
+namespace {
+    const std::string _loggerCat = "RaycasterRegistry";
+}
+
+namespace openspace {
+
+RaycasterRegistry::RaycasterRegistry(int nSlots, int nSlotsPerType)
+    : _nSlotsPerType(nSlotsPerType)
+    , _slotTypes(nSlots, -1)
+    , _slotRaycasters(nSlots, nullptr)
+    , _nextTypeIndex(0)
+    , _nextNamespaceIndex(0)
+{
+    ghoul_assert(nSlots > 0, "nSlots must be positive");
+    ghoul_assert(nSlotsPerType > 0, "nSlotsPerType must be positive");
+}
+
+RaycasterRegistry::Changes RaycasterRegistry::update(
+                                          const std::vector<VolumeRaycaster*>& raycasters)
+{
+    Changes changes;
+
+    // Free the slots of all raycasters that are no longer attached
+    std::set<VolumeRaycaster*> attached(raycasters.begin(), raycasters.end());
+    for (auto it = _raycastData.begin(); it != _raycastData.end(); ) {
+        if (attached.find(it->first) == attached.end()) {
+            const int slot = it->second.id;
+            _slotRaycasters[slot] = nullptr;
+            --(_types[_slotTypes[slot]].nRaycasters);
+            changes.removed.push_back(it->first);
+            it = _raycastData.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    // Collect the new raycasters and their types before the reservations of unused types
+    // are released, so that a type whose raycasters are replaced by new raycasters of the
+    // same type in a single update keeps its reservation
+    std::vector<VolumeRaycaster*> newRaycasters;
+    std::set<std::pair<std::string, std::string>> newTypes;
+    std::set<VolumeRaycaster*> seen;
+    for (VolumeRaycaster* raycaster : raycasters) {
+        if (_raycastData.find(raycaster) == _raycastData.end() &&
+            seen.insert(raycaster).second)
+        {
+            newRaycasters.push_back(raycaster);
+            newTypes.emplace(raycaster->getRaycastPath(), raycaster->getHelperPath());
+        }
+    }
+
+    for (auto it = _types.begin(); it != _types.end(); ) {
+        const Type& type = it->second;
+        const bool isUsed = type.nRaycasters > 0 ||
+            newTypes.find({ type.raycastPath, type.helperPath }) != newTypes.end();
+
+        if (!isUsed) {
+            for (int slot : type.slots) {
+                _slotTypes[slot] = -1;
+            }
+            changes.reservationsChanged = true;
+            it = _types.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (VolumeRaycaster* raycaster : newRaycasters) {
+        const std::string raycastPath = raycaster->getRaycastPath();
+        const std::string helperPath = raycaster->getHelperPath();
+
+        auto typeIt = std::find_if(
+            _types.begin(),
+            _types.end(),
+            [&](const std::pair<const int, Type>& t) {
+                return t.second.raycastPath == raycastPath &&
+                       t.second.helperPath == helperPath;
+            }
+        );
+
+        if (typeIt == _types.end()) {
+            Type type;
+            type.raycastPath = raycastPath;
+            type.helperPath = helperPath;
+            type.nRaycasters = 0;
+
+            // Each helper file generates its own namespace to avoid glsl name collisions
+            // between raycaster implementations. Raycasters without a helper file get a
+            // namespace of their own
+            if (helperPath.empty()) {
+                type.namespaceName = "NAMESPACE_" + std::to_string(_nextNamespaceIndex++);
+            }
+            else {
+                auto it = _helperNamespaces.find(helperPath);
+                if (it == _helperNamespaces.end()) {
+                    it = _helperNamespaces.emplace(
+                        helperPath,
+                        "NAMESPACE_" + std::to_string(_nextNamespaceIndex++)
+                    ).first;
+                }
+                type.namespaceName = it->second;
+            }
+
+            typeIt = _types.emplace(_nextTypeIndex++, std::move(type)).first;
+        }
+
+        Type& type = typeIt->second;
+        auto slotIt = std::find_if(
+            type.slots.begin(),
+            type.slots.end(),
+            [this](int slot) { return _slotRaycasters[slot] == nullptr; }
+        );
+
+        int slot = -1;
+        if (slotIt != type.slots.end()) {
+            slot = *slotIt;
+        }
+        else {
+            slot = reserveSlots(typeIt->first, type);
+            if (slot != -1) {
+                changes.reservationsChanged = true;
+            }
+        }
+
+        if (slot == -1) {
+            LWARNING(
+                "No more than " << _slotTypes.size() << " raycasters are supported. "
+                "Ignoring raycaster '" << raycastPath << "'"
+            );
+            if (type.slots.empty()) {
+                _types.erase(typeIt);
+            }
+            continue;
+        }
+
+        _slotRaycasters[slot] = raycaster;
+        ++(type.nRaycasters);
+        _raycastData[raycaster] = { slot, type.namespaceName };
+        changes.added.push_back(raycaster);
+    }
+
+    return changes;
+}
+
+int RaycasterRegistry::reserveSlots(int typeIndex, Type& type) {
+    // Grow the reservation geometrically so that types with many raycasters do not cause
+    // a rebuild for every few raycasters that are attached
+    const size_t nRequested = std::max(
+        static_cast<size_t>(_nSlotsPerType),
+        type.slots.size()
+    );
+
+    int first = -1;
+    size_t nReserved = 0;
+    for (size_t i = 0; i < _slotTypes.size() && nReserved < nRequested; ++i) {
+        if (_slotTypes[i] == -1) {
+            _slotTypes[i] = typeIndex;
+            type.slots.push_back(static_cast<int>(i));
+            if (first == -1) {
+                first = static_cast<int>(i);
+            }
+            ++nReserved;
+        }
+    }
+    std::sort(type.slots.begin(), type.slots.end());
+    return first;
+}
+
+const RaycastData* RaycasterRegistry::raycastData(VolumeRaycaster* raycaster) const {
+    auto it = _raycastData.find(raycaster);
+    return it != _raycastData.end() ? &(it->second) : nullptr;
+}
+
+const std::map<VolumeRaycaster*, RaycastData>& RaycasterRegistry::raycastData() const {
+    return _raycastData;
+}
+
+int RaycasterRegistry::nReservedSlots() const {
+    for (int i = static_cast<int>(_slotTypes.size()) - 1; i >= 0; --i) {
+        if (_slotTypes[i] != -1) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+ghoul::Dictionary RaycasterRegistry::resolveDictionary() const {
+    const int nSlots = nReservedSlots();
+    ghoul_assert(nSlots <= 32, "The bitmask cannot represent more than 32 slots");
+
+    ghoul::Dictionary raycastersDict;
+    for (int slot = 0; slot < nSlots; ++slot) {
+        if (_slotTypes[slot] == -1) {
+            continue;
+        }
+        const Type& type = _types.at(_slotTypes[slot]);
+
+        ghoul::Dictionary innerDict;
+        innerDict.setValue("id", slot);
+        innerDict.setValue("namespace", type.namespaceName);
+        innerDict.setValue("bitmask", 1 << slot);
+        innerDict.setValue("raycastPath", type.raycastPath);
+
+        raycastersDict.setValue(std::to_string(slot), innerDict);
+    }
+
+    // Each helper file is only included once, regardless of the number of types using it
+    ghoul::Dictionary helperPathsDict;
+    std::set<std::string> helperPaths;
+    for (const std::pair<const int, Type>& t : _types) {
+        const std::string& path = t.second.helperPath;
+        if (!path.empty() && helperPaths.insert(path).second) {
+            helperPathsDict.setValue(std::to_string(helperPaths.size() - 1), path);
+        }
+    }
+
+    ghoul::Dictionary dict;
+    dict.setValue("raycasters", raycastersDict);
+    dict.setValue("helperPaths", helperPathsDict);
+    dict.setValue("raycastingEnabled", nSlots > 0);
+    dict.setValue("nRaycasters", static_cast<unsigned long long>(nSlots));
+    return dict;
+}
+
+} // namespace openspace
@@ -138,7 +138,7 @@ void Renderable::postRender(const RenderData& data) {}
 
 void Renderable::setPscUniforms(
     ghoul::opengl::ProgramObject& program, 
-    const Camera& camera,
+    const Camera::Snapshot& camera,
     const PowerScaledCoordinate& position) 
 {
     program.setUniform("campos", camera.position().vec4());
@@ -185,6 +185,10 @@ bool Renderable::isEnabled() const {
     return _enabled;
 }
 
+bool Renderable::isHeadlessCapable() const {
+    return false;
+}
+
 void Renderable::onEnabledChange(std::function<void(bool)> callback) {
     _enabled.onChange([=] () {
             callback(isEnabled());
@@ -33,6 +33,7 @@
 #include <openspace/rendering/abufferrenderer.h>
 #include <openspace/rendering/framebufferrenderer.h>
 #include <openspace/rendering/raycastermanager.h>
+#include <openspace/rendering/renderable.h>
 
 #include <modules/base/rendering/screenspaceimage.h>
 #include <modules/base/rendering/screenspaceframebuffer.h>
@@ -190,7 +191,7 @@ bool RenderEngine::initialize() {
 
     if (OsEng.configurationManager().hasKeyAndValue<std::string>(KeyRenderingMethod)) {
         renderingMethod = OsEng.configurationManager().value<std::string>(KeyRenderingMethod);
-    } else {
+    } else if (!OsEng.windowWrapper().isHeadless()) {
         using Version = ghoul::systemcapabilities::OpenGLCapabilitiesComponent::Version;
 
         // The default rendering method has a requirement of OpenGL 4.3, so if we are
@@ -204,8 +205,15 @@ bool RenderEngine::initialize() {
     _raycasterManager = new RaycasterManager();
     _nAaSamples = OsEng.windowWrapper().currentNumberOfAaSamples();
 
-    LINFO("Seting renderer from string: " << renderingMethod);
-    setRendererFromString(renderingMethod);
+    // The renderers consist of framebuffers and shaders, so there is no renderer if there
+    // is no OpenGL context
+    if (OsEng.windowWrapper().isHeadless()) {
+        LINFO("Running without a renderer for the headless window");
+    }
+    else {
+        LINFO("Seting renderer from string: " << renderingMethod);
+        setRendererFromString(renderingMethod);
+    }
 
     // init camera and set temporary position and scaling
     _mainCamera = new Camera();
@@ -342,6 +350,8 @@ bool RenderEngine::initializeGL() {
 }
 
 void RenderEngine::updateSceneGraph() {
+    // The frame transforms are shared between all nodes that are updated in this frame
+    SpiceManager::ref().clearTransformCache();
     _sceneGraph->update({
         glm::dvec3(0),
         glm::dmat3(1),
@@ -375,6 +385,10 @@ void RenderEngine::updateShaderPrograms() {
 }
 
 void RenderEngine::updateRenderer() {
+    if (!_renderer) {
+        return;
+    }
+
     bool windowResized = OsEng.windowWrapper().windowHasResized();
 
     if (windowResized) {
@@ -420,6 +434,30 @@ void RenderEngine::updateFade() {
 void RenderEngine::render(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix){
     _mainCamera->sgctInternal.setViewMatrix(viewMatrix);
     _mainCamera->sgctInternal.setProjectionMatrix(projectionMatrix);
+    _mainCamera->publishSnapshot();
+
+    // Without an OpenGL context there is no renderer, but the scene is still traversed
+    // in the renderers' order, so that the headless Renderables can do their camera
+    // dependent work, such as selecting levels of detail. The raycaster tasks are not
+    // executed, as only Renderables that use OpenGL would create them. The performance
+    // measurement is disabled, as it synchronizes with the GPU
+    if (OsEng.windowWrapper().isHeadless()) {
+        if (_sceneGraph) {
+            Camera::SnapshotReference camera = _mainCamera->snapshot();
+            RenderData data = { *camera, psc(), false, 0 };
+            RendererTasks tasks;
+            for (Renderable::RenderBin bin : { Renderable::RenderBin::Background,
+                                               Renderable::RenderBin::Opaque,
+                                               Renderable::RenderBin::Transparent,
+                                               Renderable::RenderBin::Overlay })
+            {
+                data.renderBinMask = static_cast<int>(bin);
+                _sceneGraph->render(data, tasks);
+            }
+        }
+        _frameNumber++;
+        return;
+    }
 
     if (!(OsEng.isMaster() && _disableMasterRendering) && !OsEng.windowWrapper().isGuiWindow()) {
         _renderer->render(_globalBlackOutFactor, _performanceManager != nullptr);
@@ -485,6 +523,8 @@ void RenderEngine::postDraw() {
 
     if (_performanceManager) {
         _performanceManager->storeScenePerformanceMeasurements(scene()->allSceneGraphNodes());
+        _performanceManager->storeJobManagerStatistics(OsEng.jobManager().statistics());
+        _performanceManager->storeFrameTime(OsEng.windowWrapper().deltaTime());
     }
 }
 
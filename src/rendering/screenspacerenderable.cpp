@@ -327,7 +327,7 @@ void ScreenSpaceRenderable::draw(glm::mat4 modelTransform) {
     _shader->setUniform("ModelTransform", modelTransform);
     _shader->setUniform(
         "ViewProjectionMatrix",
-        OsEng.renderEngine().camera()->viewProjectionMatrix()
+        OsEng.renderEngine().camera()->snapshot()->viewProjectionMatrix()
     );
     
     ghoul::opengl::TextureUnit unit;
@@ -0,0 +1,356 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/texturecache.h>
+
+#include <openspace/engine/downloadmanager.h>
+
+#include <ghoul/io/texture/texturereader.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef GHOUL_USE_FREEIMAGE
+#include <FreeImage.h>
+#endif // GHOUL_USE_FREEIMAGE
+
+namespace {
+    const std::string _loggerCat = "TextureCache";
+
+    bool isUrl(const std::string& source) {
+        return source.compare(0, 7, "http://") == 0 ||
+            source.compare(0, 8, "https://") == 0;
+    }
+
+    std::string fileExtension(const std::string& path) {
+        size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos) {
+            return "";
+        }
+        std::string extension = path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension;
+    }
+
+#ifdef GHOUL_USE_FREEIMAGE
+    std::unique_ptr<openspace::TextureCache::Image> decodeFreeImage(const char* data,
+        size_t size, const std::string&)
+    {
+        FIMEMORY* memory = FreeImage_OpenMemory(
+            reinterpret_cast<BYTE*>(const_cast<char*>(data)),
+            static_cast<DWORD>(size)
+        );
+        FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(memory, 0);
+        FIBITMAP* bitmap = nullptr;
+        if (format != FIF_UNKNOWN && FreeImage_FIFSupportsReading(format)) {
+            bitmap = FreeImage_LoadFromMemory(format, memory, 0);
+        }
+        FreeImage_CloseMemory(memory);
+        if (!bitmap) {
+            return nullptr;
+        }
+
+        FIBITMAP* converted = FreeImage_ConvertTo32Bits(bitmap);
+        FreeImage_Unload(bitmap);
+        if (!converted) {
+            return nullptr;
+        }
+
+        const unsigned int width = FreeImage_GetWidth(converted);
+        const unsigned int height = FreeImage_GetHeight(converted);
+        const size_t rowSize = 4 * static_cast<size_t>(width);
+
+        auto image = std::make_unique<openspace::TextureCache::Image>();
+        image->data.reset(new char[rowSize * height]);
+        // The scanlines might be padded, so they are copied one at a time
+        for (unsigned int y = 0; y < height; ++y) {
+            std::memcpy(
+                image->data.get() + y * rowSize,
+                FreeImage_GetScanLine(converted, y),
+                rowSize
+            );
+        }
+        FreeImage_Unload(converted);
+
+        image->dimensions = glm::uvec3(width, height, 1);
+        image->format = ghoul::opengl::Texture::Format::BGRA;
+        image->internalFormat = GL_RGBA;
+        image->dataType = GL_UNSIGNED_BYTE;
+        return image;
+    }
+#endif // GHOUL_USE_FREEIMAGE
+}
+
+namespace openspace {
+
+TextureCache::Decoder TextureCache::defaultDecoder() {
+#ifdef GHOUL_USE_FREEIMAGE
+    return decodeFreeImage;
+#else
+    return Decoder();
+#endif // GHOUL_USE_FREEIMAGE
+}
+
+TextureCache::TextureCache(JobManager& jobManager, Decoder decoder)
+    : _jobManager(jobManager)
+    , _decoder(std::move(decoder))
+    , _statistics({ 0, 0, 0, 0 })
+{}
+
+TextureCache::~TextureCache() {
+    for (std::pair<const std::string, Entry>& entry : _entries) {
+        entry.second.token.cancel();
+    }
+}
+
+void TextureCache::acquire(const std::string& source) {
+    ghoul_assert(!source.empty(), "Source must not be empty");
+
+    Entry& entry = _entries[source];
+    ++entry.nReferences;
+    if (entry.nReferences == 1) {
+        load(source, entry);
+    }
+}
+
+void TextureCache::release(const std::string& source) {
+    auto it = _entries.find(source);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    --(it->second.nReferences);
+    if (it->second.nReferences == 0) {
+        it->second.token.cancel();
+        _entries.erase(it);
+    }
+}
+
+void TextureCache::refresh(const std::string& source) {
+    auto it = _entries.find(source);
+    ghoul_assert(it != _entries.end(), "Source must have been acquired");
+
+    if (!it->second.isLoading) {
+        load(source, it->second);
+    }
+}
+
+std::shared_ptr<ghoul::opengl::Texture> TextureCache::texture(
+                                                          const std::string& source) const
+{
+    auto it = _entries.find(source);
+    return it != _entries.end() ? it->second.texture : nullptr;
+}
+
+const TextureCache::Image* TextureCache::image(const std::string& source) const {
+    auto it = _entries.find(source);
+    return it != _entries.end() ? it->second.image.get() : nullptr;
+}
+
+int TextureCache::version(const std::string& source) const {
+    auto it = _entries.find(source);
+    return it != _entries.end() ? it->second.version : 0;
+}
+
+TextureCache::Statistics TextureCache::statistics() const {
+    return _statistics;
+}
+
+void TextureCache::load(const std::string& source, Entry& entry) {
+    entry.isLoading = true;
+    const int loadId = ++entry.loadId;
+
+    // The job only works on copies, as the entry might be gone when it is executed
+    const std::string etag = entry.etag;
+    const std::string lastModified = entry.lastModified;
+    const Decoder decoder = _decoder;
+
+    auto job = [source, etag, lastModified, decoder]() {
+        LoadResult result;
+
+        auto decode = [&result, &decoder](const char* data, size_t size) {
+            if (decoder) {
+                result.image = decoder(data, size, result.format);
+                if (!result.image) {
+                    result.errorMessage = "Could not decode image";
+                    return;
+                }
+            }
+            else {
+                result.encoded.assign(data, data + size);
+            }
+            result.isValid = true;
+        };
+
+        if (isUrl(source)) {
+            DownloadManager::MemoryFile file = DownloadManager::fetchFileBlocking(
+                source,
+                etag,
+                lastModified
+            );
+            result.format = file.format;
+            result.etag = file.etag;
+            result.lastModified = file.lastModified;
+            result.isModified = file.isModified;
+            if (file.corrupted) {
+                result.errorMessage = file.errorMessage;
+            }
+            else if (!file.isModified) {
+                result.isValid = true;
+            }
+            else {
+                decode(file.buffer, file.size);
+            }
+            free(file.buffer);
+        }
+        else {
+            std::ifstream file(source, std::ifstream::binary);
+            if (!file.good()) {
+                result.errorMessage = "Could not open file";
+                return result;
+            }
+            std::vector<char> contents(
+                (std::istreambuf_iterator<char>(file)),
+                std::istreambuf_iterator<char>()
+            );
+            result.format = fileExtension(source);
+            decode(contents.data(), contents.size());
+        }
+        return result;
+    };
+
+    _jobManager.enqueueWithContinuation(
+        job,
+        [this, source, loadId](LoadResult result) {
+            finishLoad(source, loadId, std::move(result));
+        },
+        JobManager::Priority::Normal,
+        entry.token
+    );
+}
+
+void TextureCache::finishLoad(const std::string& source, int loadId, LoadResult result)
+{
+    auto it = _entries.find(source);
+    if (it == _entries.end() || it->second.loadId != loadId) {
+        // The source was released or loaded again in the meantime
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.isLoading = false;
+    ++_statistics.nLoads;
+
+    if (!result.isValid) {
+        LERROR("Could not load image '" << source << "': " << result.errorMessage);
+        return;
+    }
+
+    entry.etag = std::move(result.etag);
+    entry.lastModified = std::move(result.lastModified);
+    if (!result.isModified) {
+        ++_statistics.nUnchanged;
+        return;
+    }
+
+    if (result.image) {
+        ++_statistics.nDecodes;
+    }
+    entry.image = std::move(result.image);
+    entry.encoded = std::move(result.encoded);
+    entry.format = std::move(result.format);
+    ++entry.version;
+
+    if (!entry.hasPendingUpload) {
+        entry.hasPendingUpload = true;
+        _pendingUploads.push_back(source);
+    }
+}
+
+int TextureCache::update(std::chrono::microseconds budget) {
+    using namespace std::chrono;
+    using ghoul::opengl::Texture;
+
+    const steady_clock::time_point start = steady_clock::now();
+    int nUploads = 0;
+    while (!_pendingUploads.empty()) {
+        const std::string source = std::move(_pendingUploads.front());
+        _pendingUploads.pop_front();
+
+        auto it = _entries.find(source);
+        if (it == _entries.end() || !it->second.hasPendingUpload) {
+            continue;
+        }
+        Entry& entry = it->second;
+        entry.hasPendingUpload = false;
+
+        std::unique_ptr<Texture> texture;
+        if (entry.image) {
+            // The texture takes ownership of the pixel data
+            texture = std::make_unique<Texture>(
+                entry.image->data.release(),
+                entry.image->dimensions,
+                entry.image->format,
+                entry.image->internalFormat,
+                entry.image->dataType,
+                Texture::FilterMode::Linear,
+                Texture::WrappingMode::ClampToEdge
+            );
+            entry.image = nullptr;
+        }
+        else {
+            texture = ghoul::io::TextureReader::ref().loadTexture(
+                reinterpret_cast<void*>(entry.encoded.data()),
+                entry.encoded.size(),
+                entry.format
+            );
+            entry.encoded = std::vector<char>();
+            ++_statistics.nDecodes;
+        }
+
+        if (texture) {
+            texture->uploadTexture();
+            texture->setFilter(Texture::FilterMode::Linear);
+            entry.texture = std::move(texture);
+            ++_statistics.nUploads;
+            ++nUploads;
+        }
+        else {
+            LERROR("Could not create texture for image '" << source << "'");
+        }
+
+        if (steady_clock::now() - start >= budget) {
+            break;
+        }
+    }
+    return nUploads;
+}
+
+} // namespace openspace
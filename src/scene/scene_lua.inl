@@ -50,12 +50,7 @@ void applyRegularExpression(lua_State* L, std::regex regex, std::vector<properti
             else {
                 prop->setLuaValue(L);
                 //ensure properties are synced over parallel connection
-                std::string value;
-                prop->getStringValue(value);
-                OsEng.parallelConnection().scriptMessage(
-                    prop->fullyQualifiedIdentifier(),
-                    value
-                );
+                OsEng.parallelConnection().propertyMessage(*prop);
             }
 
         }
@@ -99,9 +94,7 @@ int property_setValueSingle(lua_State* L) {
     else {
         prop->setLuaValue(L);
         //ensure properties are synced over parallel connection
-        std::string value;
-        prop->getStringValue(value);
-        OsEng.parallelConnection().scriptMessage(prop->fullyQualifiedIdentifier(), value);
+        OsEng.parallelConnection().propertyMessage(*prop);
     }
 
     return 0;
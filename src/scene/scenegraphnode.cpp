@@ -44,6 +44,7 @@
 #include <modules/base/scale/staticscale.h>
 
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/windowwrapper.h>
 #include <openspace/util/factorymanager.h>
 
 #include <cctype>
@@ -99,8 +100,20 @@ SceneGraphNode* SceneGraphNode::createFromDictionary(const ghoul::Dictionary& di
             delete result;
             return nullptr;
         }
-        result->addPropertySubOwner(result->_renderable);
-        LDEBUG("Successfully created renderable for '" << result->name() << "'");
+
+        // Without an OpenGL context, the node only keeps its renderable if it can be
+        // used without one; otherwise the scene consists of the node's transformations
+        if (OsEng.windowWrapper().isHeadless() &&
+            !result->_renderable->isHeadlessCapable())
+        {
+            LDEBUG("Skipping renderable of '" << name << "' for the headless window");
+            delete result->_renderable;
+            result->_renderable = nullptr;
+        }
+        else {
+            result->addPropertySubOwner(result->_renderable);
+            LDEBUG("Successfully created renderable for '" << result->name() << "'");
+        }
     }
 
     if (dictionary.hasKey(keyTransformTranslation)) {
@@ -83,6 +83,8 @@ void ScriptEngine::initializeLuaState(lua_State* state) {
 }
 
 void ScriptEngine::addLibrary(LuaLibrary library) {
+    _luaFunctionIndexIsDirty = true;
+
     auto sortFunc = [](const LuaLibrary::Function& lhs, const LuaLibrary::Function& rhs)
     {
         return lhs.name < rhs.name;
@@ -487,6 +489,14 @@ std::vector<std::string> ScriptEngine::allLuaFunctions() const {
     return result;
 }
 
+const PrefixIndex& ScriptEngine::luaFunctionIndex() const {
+    if (_luaFunctionIndexIsDirty) {
+        _luaFunctionIndex.set(allLuaFunctions());
+        _luaFunctionIndexIsDirty = false;
+    }
+    return _luaFunctionIndex;
+}
+
 void ScriptEngine::writeDocumentation(const std::string& filename, const std::string& type) const {
     auto concatenate = [](std::string library, std::string function) {
         std::string total = "openspace.";
@@ -766,6 +776,10 @@ void ScriptEngine::postsync(bool isMaster) {
     }
 }
 
+const std::string& ScriptEngine::currentSyncedScript() const {
+    return _currentSyncedScript;
+}
+
 void ScriptEngine::queueScript(const std::string &script){
     if (script.empty())
         return;
@@ -26,11 +26,15 @@
 
 #include <openspace/engine/openspaceengine.h>
 
+#include <openspace/properties/property.h>
+#include <openspace/query/query.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/spicemanager.h> // parse time
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/filesystem/filesystem>
+#include <ghoul/lua/lua_helper.h>
 
+#include <algorithm>
 
 namespace openspace {
 namespace scripting {
@@ -41,6 +45,86 @@ namespace {
     const std::string KEY_TIME = "Time";
     const std::string KEY_FORWARD_SCRIPT = "ReversibleLuaScript.Forward";
     const std::string KEY_BACKWARD_SCRIPT = "ReversibleLuaScript.Backward";
+
+    const std::string KEY_STATE = "State";
+    const std::string KEY_STATE_PROPERTY = "Property";
+    const std::string KEY_STATE_FORWARD = "Forward";
+    const std::string KEY_STATE_BACKWARD = "Backward";
+
+    // Converts the value stored at key in dict into value and returns whether the value
+    // was of a supported type
+    bool readPropertyValue(const ghoul::Dictionary& dict, const std::string& key,
+                           PropertyValue& value)
+    {
+        if (dict.hasValue<bool>(key)) {
+            value.type = PropertyValue::Type::Boolean;
+            value.boolean = dict.value<bool>(key);
+            return true;
+        }
+        if (dict.hasValue<double>(key)) {
+            value.type = PropertyValue::Type::Number;
+            value.number = dict.value<double>(key);
+            return true;
+        }
+        if (dict.hasValue<std::string>(key)) {
+            value.type = PropertyValue::Type::String;
+            value.string = dict.value<std::string>(key);
+            return true;
+        }
+        if (dict.hasValue<ghoul::Dictionary>(key)) {
+            const ghoul::Dictionary& components = dict.value<ghoul::Dictionary>(key);
+            value.type = PropertyValue::Type::Vector;
+            value.vector.clear();
+            for (size_t i = 1; i <= components.size(); ++i) {
+                double component;
+                if (!components.getValue(std::to_string(i), component)) {
+                    return false;
+                }
+                value.vector.push_back(component);
+            }
+            return true;
+        }
+        return false;
+    }
+}
+
+
+void PropertyValue::push(lua_State* L) const {
+    switch (type) {
+        case Type::Boolean:
+            lua_pushboolean(L, boolean);
+            break;
+        case Type::Number:
+            lua_pushnumber(L, number);
+            break;
+        case Type::String:
+            lua_pushstring(L, string.c_str());
+            break;
+        case Type::Vector:
+            lua_newtable(L);
+            for (size_t i = 0; i < vector.size(); ++i) {
+                lua_pushnumber(L, vector[i]);
+                lua_rawseti(L, -2, static_cast<int>(i + 1));
+            }
+            break;
+    }
+}
+
+bool PropertyValue::operator==(const PropertyValue& other) const {
+    if (type != other.type) {
+        return false;
+    }
+    switch (type) {
+        case Type::Boolean:
+            return boolean == other.boolean;
+        case Type::Number:
+            return number == other.number;
+        case Type::String:
+            return string == other.string;
+        case Type::Vector:
+            return vector == other.vector;
+    }
+    return false;
 }
 
 
@@ -50,7 +134,51 @@ ScheduledScript::ScheduledScript(const ghoul::Dictionary& dict)
     std::string timeStr;
     if (dict.getValue(KEY_TIME, timeStr)) {
         time = SpiceManager::ref().ephemerisTimeFromDate(timeStr);
+    }
+    else if (!dict.getValue(KEY_TIME, time)) {
+        LERROR("Unable to read " << KEY_TIME);
+        return;
+    }
+
+    if (dict.hasValue<ghoul::Dictionary>(KEY_STATE)) {
+        const ghoul::Dictionary& state = dict.value<ghoul::Dictionary>(KEY_STATE);
+        for (size_t i = 1; i <= state.size(); ++i) {
+            ghoul::Dictionary entry;
+            std::string uri;
+            if (!state.getValue(std::to_string(i), entry) ||
+                !entry.getValue(KEY_STATE_PROPERTY, uri))
+            {
+                LERROR("Unable to read " << KEY_STATE_PROPERTY << " of " <<
+                       KEY_STATE << " entry " << i);
+                continue;
+            }
+
+            PropertyValue value;
+            if (entry.hasKey(KEY_STATE_FORWARD)) {
+                if (readPropertyValue(entry, KEY_STATE_FORWARD, value)) {
+                    forwardState[uri] = value;
+                }
+                else {
+                    LERROR("Unsupported " << KEY_STATE_FORWARD << " value for '" <<
+                           uri << "'");
+                }
+            }
+            if (entry.hasKey(KEY_STATE_BACKWARD)) {
+                if (readPropertyValue(entry, KEY_STATE_BACKWARD, value)) {
+                    backwardState[uri] = value;
+                }
+                else {
+                    LERROR("Unsupported " << KEY_STATE_BACKWARD << " value for '" <<
+                           uri << "'");
+                }
+            }
+        }
 
+        // The scripts are optional if the state is declared
+        dict.getValue(KEY_FORWARD_SCRIPT, script.forwardScript);
+        dict.getValue(KEY_BACKWARD_SCRIPT, script.backwardScript);
+    }
+    else {
         if (!dict.getValue(KEY_FORWARD_SCRIPT, script.forwardScript)) {
             LERROR("Unable to read " << KEY_FORWARD_SCRIPT);
         }
@@ -58,9 +186,6 @@ ScheduledScript::ScheduledScript(const ghoul::Dictionary& dict)
             LERROR("Unable to read " << KEY_BACKWARD_SCRIPT);
         }
     }
-    else {
-        LERROR("Unable to read " << KEY_TIME);
-    }
 }
 
 bool ScheduledScript::CompareByTime(const ScheduledScript& s1, const ScheduledScript& s2){
@@ -69,6 +194,12 @@ bool ScheduledScript::CompareByTime(const ScheduledScript& s1, const ScheduledSc
 
 
 
+ScriptScheduler::~ScriptScheduler() {
+    if (_state) {
+        ghoul::lua::destroyLuaState(_state);
+    }
+}
+
 void ScriptScheduler::loadScripts(const std::string& filepath, lua_State* L) {
     ghoul::Dictionary timedScriptsDict;
     try {
@@ -82,6 +213,7 @@ void ScriptScheduler::loadScripts(const std::string& filepath, lua_State* L) {
 }
 
 void ScriptScheduler::loadScripts(const ghoul::Dictionary& dict) {
+    _scheduledScripts.reserve(_scheduledScripts.size() + dict.size());
     for (size_t i = 0; i < dict.size(); ++i) {
         std::string id = std::to_string(i + 1);
         const ghoul::Dictionary& timedScriptDict = dict.value<ghoul::Dictionary>(id);
@@ -90,11 +222,58 @@ void ScriptScheduler::loadScripts(const ghoul::Dictionary& dict) {
 
     // Sort scripts by time
     std::stable_sort(_scheduledScripts.begin(), _scheduledScripts.end(), &ScheduledScript::CompareByTime);
+    buildIndices();
 
     // Ensure _currentIndex and _currentTime is accurate after new scripts was added
     double lastTime = _currentTime;
     rewind();
     progressTo(lastTime);
+    _stateChanges.clear();
+}
+
+void ScriptScheduler::buildIndices() {
+    _forwardScriptIndices.clear();
+    _backwardScriptIndices.clear();
+    _propertyTimelines.clear();
+    _timelineIndices.clear();
+
+    auto timeline = [this](const std::string& uri) -> PropertyTimeline& {
+        auto it = _timelineIndices.find(uri);
+        if (it == _timelineIndices.end()) {
+            it = _timelineIndices.emplace(uri, _propertyTimelines.size()).first;
+            _propertyTimelines.push_back({ uri, {}, {}, {}, {}, {} });
+        }
+        return _propertyTimelines[it->second];
+    };
+
+    // As the scripts are iterated in order, all index lists end up sorted
+    for (size_t i = 0; i < _scheduledScripts.size(); ++i) {
+        const ScheduledScript& s = _scheduledScripts[i];
+        if (!s.script.forwardScript.empty()) {
+            _forwardScriptIndices.push_back(i);
+        }
+        if (!s.script.backwardScript.empty()) {
+            _backwardScriptIndices.push_back(i);
+        }
+
+        for (const auto& p : s.forwardState) {
+            PropertyTimeline& t = timeline(p.first);
+            t.scripts.push_back(i);
+            t.forwardScripts.push_back(i);
+            t.forwardValues.push_back(p.second);
+        }
+        for (const auto& p : s.backwardState) {
+            PropertyTimeline& t = timeline(p.first);
+            if (t.scripts.empty() || t.scripts.back() != i) {
+                t.scripts.push_back(i);
+            }
+            t.backwardScripts.push_back(i);
+            t.backwardValues.push_back(p.second);
+        }
+    }
+
+    _resolvedGeneration.assign(_propertyTimelines.size(), 0);
+    _generation = 0;
 }
 
 void ScriptScheduler::rewind() {
@@ -106,31 +285,151 @@ void ScriptScheduler::rewind() {
 void ScriptScheduler::clearSchedule() {
     rewind();
     _scheduledScripts.clear();
+    _forwardScriptIndices.clear();
+    _backwardScriptIndices.clear();
+    _propertyTimelines.clear();
+    _timelineIndices.clear();
+    _resolvedGeneration.clear();
+    _stateChanges.clear();
 }
 
 std::queue<std::string> ScriptScheduler::progressTo(double newTime) {
     std::queue<std::string> triggeredScripts;
-    if (newTime > _currentTime) {
-        while(_currentIndex < _scheduledScripts.size() && _scheduledScripts[_currentIndex].time <= newTime){
-            triggeredScripts.push(_scheduledScripts[_currentIndex].script.forwardScript);
-            _currentIndex++;
+    _stateChanges.clear();
+
+    // The number of scripts that have a time earlier than or equal to newTime
+    size_t newIndex = std::distance(
+        _scheduledScripts.begin(),
+        std::upper_bound(
+            _scheduledScripts.begin(),
+            _scheduledScripts.end(),
+            newTime,
+            [](double time, const ScheduledScript& s) { return time < s.time; }
+        )
+    );
+
+    if (newIndex > _currentIndex) {
+        auto it = std::lower_bound(
+            _forwardScriptIndices.begin(),
+            _forwardScriptIndices.end(),
+            _currentIndex
+        );
+        for (; it != _forwardScriptIndices.end() && *it < newIndex; ++it) {
+            triggeredScripts.push(_scheduledScripts[*it].script.forwardScript);
         }
     }
     else {
-        while (0 < _currentIndex && _scheduledScripts[_currentIndex - 1].time > newTime) {
-            triggeredScripts.push(_scheduledScripts[_currentIndex - 1].script.backwardScript);
-            _currentIndex--;
+        auto it = std::lower_bound(
+            _backwardScriptIndices.begin(),
+            _backwardScriptIndices.end(),
+            _currentIndex
+        );
+        for (; it != _backwardScriptIndices.begin() && *(it - 1) >= newIndex; --it) {
+            triggeredScripts.push(_scheduledScripts[*(it - 1)].script.backwardScript);
         }
     }
 
+    if (newIndex != _currentIndex && !_propertyTimelines.empty()) {
+        const size_t begin = std::min(_currentIndex, newIndex);
+        const size_t end = std::max(_currentIndex, newIndex);
+
+        if (end - begin < _propertyTimelines.size()) {
+            // Few scripts were passed, so we only resolve the properties they touch
+            ++_generation;
+            for (size_t i = begin; i < end; ++i) {
+                const ScheduledScript& s = _scheduledScripts[i];
+                for (const auto* state : { &s.forwardState, &s.backwardState }) {
+                    for (const auto& p : *state) {
+                        size_t t = _timelineIndices.at(p.first);
+                        if (_resolvedGeneration[t] != _generation) {
+                            _resolvedGeneration[t] = _generation;
+                            resolveState(_propertyTimelines[t], newIndex);
+                        }
+                    }
+                }
+            }
+        }
+        else {
+            // A jump across many scripts; every property that has a script in the
+            // passed range is resolved, which is found by a binary search each
+            for (const PropertyTimeline& t : _propertyTimelines) {
+                auto it = std::lower_bound(t.scripts.begin(), t.scripts.end(), begin);
+                if (it != t.scripts.end() && *it < end) {
+                    resolveState(t, newIndex);
+                }
+            }
+        }
+    }
+
+    _currentIndex = newIndex;
     _currentTime = newTime;
     return triggeredScripts;
 }
 
+void ScriptScheduler::resolveState(const PropertyTimeline& timeline, size_t index) {
+    // The last script before index that establishes a forward value wins
+    auto forward = std::lower_bound(
+        timeline.forwardScripts.begin(),
+        timeline.forwardScripts.end(),
+        index
+    );
+    if (forward != timeline.forwardScripts.begin()) {
+        size_t i = std::distance(timeline.forwardScripts.begin(), forward) - 1;
+        _stateChanges.push_back({ timeline.uri, timeline.forwardValues[i] });
+        return;
+    }
+
+    // Otherwise, the property is in the state before the first script after index
+    auto backward = std::lower_bound(
+        timeline.backwardScripts.begin(),
+        timeline.backwardScripts.end(),
+        index
+    );
+    if (backward != timeline.backwardScripts.end()) {
+        size_t i = std::distance(timeline.backwardScripts.begin(), backward);
+        _stateChanges.push_back({ timeline.uri, timeline.backwardValues[i] });
+    }
+}
+
 std::queue<std::string> ScriptScheduler::progressTo(const std::string& timeStr) {
     return std::move(progressTo(SpiceManager::ref().ephemerisTimeFromDate(timeStr)));
 }
 
+const std::vector<PropertyState>& ScriptScheduler::stateChanges() const {
+    return _stateChanges;
+}
+
+void ScriptScheduler::applyStateChanges() {
+    using ghoul::lua::luaTypeToString;
+
+    if (_stateChanges.empty()) {
+        return;
+    }
+    if (!_state) {
+        _state = ghoul::lua::createNewLuaState();
+    }
+
+    for (const PropertyState& s : _stateChanges) {
+        properties::Property* prop = property(s.uri);
+        if (!prop) {
+            LERROR("Property with URI '" << s.uri << "' was not found");
+            continue;
+        }
+
+        s.value.push(_state);
+        const int type = lua_type(_state, -1);
+        if (type != prop->typeLua()) {
+            LERROR("Property '" << s.uri << "' does not accept input of type '" <<
+                   luaTypeToString(type) << "'. Requested type: '" <<
+                   luaTypeToString(prop->typeLua()) << "'");
+        }
+        else {
+            prop->setLuaValue(_state);
+        }
+        lua_settop(_state, 0);
+    }
+}
+
 double ScriptScheduler::currentTime() const { 
     return _currentTime; 
 };
@@ -158,6 +457,7 @@ namespace luascriptfunctions {
         }
         
         OsEng.scriptScheduler().loadScripts(missionFileName, L);
+        return 0;
     }
 
     int clear(lua_State* L) {
@@ -167,6 +467,7 @@ namespace luascriptfunctions {
             return luaL_error(L, "Expected %i arguments, got %i", 0, nArguments);
 
         OsEng.scriptScheduler().clearSchedule();
+        return 0;
     }
 } // namespace luascriptfunction
 
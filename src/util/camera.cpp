@@ -33,6 +33,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
+#include <thread>
+
 namespace openspace {
 
     //////////////////////////////////////////////////////////////////////////////////////
@@ -49,12 +51,19 @@ namespace openspace {
     Camera::Camera()
         : _maxFov(0.f)
         , _focusPosition()
+        , _currentSnapshot(0)
+        , _snapshotVersion(0)
     {
 
         _scaling = glm::vec2(1.f, 0.f);
         _position = Vec3(1.0, 1.0, 1.0);
         Vec3 eulerAngles(1.0, 1.0, 1.0);
         _rotation = Quat(eulerAngles);
+
+        for (std::atomic<int>& n : _nSnapshotReaders) {
+            n = 0;
+        }
+        publishSnapshot();
     }
 
     Camera::Camera(const Camera& o)
@@ -66,25 +75,29 @@ namespace openspace {
         , _rotation(o._rotation)
         , _scaling(o._scaling)
         , _maxFov(o._maxFov)
-    { }
+        , _currentSnapshot(0)
+        , _snapshotVersion(0)
+    {
+        for (std::atomic<int>& n : _nSnapshotReaders) {
+            n = 0;
+        }
+        publishSnapshot();
+    }
 
     Camera::~Camera() { }
 
     // Mutators
     void Camera::setPositionVec3(Vec3 pos) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _position = pos;
       
         _cachedCombinedViewMatrix.isDirty = true;
     }
 
     void Camera::setFocusPositionVec3(Vec3 pos) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _focusPosition = pos;
     }
 
     void Camera::setRotation(Quat rotation) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _rotation = rotation;
         _cachedViewDirection.isDirty = true;
         _cachedLookupVector.isDirty = true;
@@ -93,19 +106,16 @@ namespace openspace {
     }
 
     void Camera::setScaling(glm::vec2 scaling) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _scaling = std::move(scaling);
     }
 
     void Camera::setMaxFov(float fov) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _maxFov = fov;
         _cachedSinMaxFov.isDirty = true;
     }
 
     // Relative mutators
     void Camera::rotate(Quat rotation) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _rotation = rotation * (glm::dquat)_rotation;
       
         _cachedViewDirection.isDirty = true;
@@ -191,6 +201,82 @@ namespace openspace {
         return _cachedCombinedViewMatrix.datum;
     }
 
+    void Camera::publishSnapshot() {
+        // Find a slot that no reader can access. The current slot is never written, so
+        // a reader that has just registered for the current slot stays valid
+        int current = _currentSnapshot.load();
+        int slot = current;
+        while (slot == current) {
+            for (int i = 0; i < NumberOfSnapshots; ++i) {
+                if (i != current && _nSnapshotReaders[i].load() == 0) {
+                    slot = i;
+                    break;
+                }
+            }
+            if (slot == current) {
+                // All other snapshots are still referenced by slow readers
+                std::this_thread::yield();
+            }
+        }
+
+        Snapshot& s = _snapshots[slot];
+        s._position = _position;
+        s._focusPosition = _focusPosition;
+        s._rotation = _rotation;
+        s._scaling = _scaling;
+        s._maxFov = _maxFov;
+        s._sinMaxFov = sin(_maxFov);
+        s._viewDirection = glm::normalize(s._rotation * _VIEW_DIRECTION_CAMERA_SPACE);
+        s._lookUpVector = glm::normalize(s._rotation * _LOOKUP_VECTOR_CAMERA_SPACE);
+        s._viewRotationMatrix = glm::mat4_cast(glm::inverse(s._rotation));
+
+        s._viewMatrix = sgctInternal._viewMatrix;
+        s._projectionMatrix = sgctInternal._projectionMatrix;
+        s._viewProjectionMatrix = s._projectionMatrix * s._viewMatrix;
+
+        s._combinedViewMatrix = Mat4(s._viewMatrix) * s._viewRotationMatrix *
+            glm::inverse(glm::translate(Mat4(1.0), s._position));
+        s._combinedViewProjectionMatrix =
+            Mat4(s._projectionMatrix) * s._combinedViewMatrix;
+
+        // Extract the planes from the rows of the view projection matrix; a point p is
+        // inside of a plane if dot(plane.xyz, p) + plane.w >= 0
+        const Mat4& m = s._combinedViewProjectionMatrix;
+        glm::dvec4 rowX(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::dvec4 rowY(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::dvec4 rowZ(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::dvec4 rowW(m[0][3], m[1][3], m[2][3], m[3][3]);
+        s._frustumPlanes[Snapshot::Left] = rowW + rowX;
+        s._frustumPlanes[Snapshot::Right] = rowW - rowX;
+        s._frustumPlanes[Snapshot::Bottom] = rowW + rowY;
+        s._frustumPlanes[Snapshot::Top] = rowW - rowY;
+        s._frustumPlanes[Snapshot::Near] = rowW + rowZ;
+        s._frustumPlanes[Snapshot::Far] = rowW - rowZ;
+        for (glm::dvec4& plane : s._frustumPlanes) {
+            double length = glm::length(glm::dvec3(plane));
+            if (length > 0.0) {
+                plane /= length;
+            }
+        }
+
+        s._version = ++_snapshotVersion;
+
+        _currentSnapshot.store(slot);
+    }
+
+    Camera::SnapshotReference Camera::snapshot() const {
+        while (true) {
+            int slot = _currentSnapshot.load();
+            ++_nSnapshotReaders[slot];
+            // If the slot is still the current one after registering, the writer has
+            // not picked it and will not pick it while we are registered
+            if (_currentSnapshot.load() == slot) {
+                return SnapshotReference(&_snapshots[slot], &_nSnapshotReaders[slot]);
+            }
+            --_nSnapshotReaders[slot];
+        }
+    }
+
     void Camera::invalidateCache() {
         _cachedViewDirection.isDirty = true;
         _cachedLookupVector.isDirty = true;
@@ -215,6 +301,140 @@ namespace openspace {
         setRotation(q);
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    //                                   SNAPSHOT                                        //
+    //////////////////////////////////////////////////////////////////////////////////////
+    Camera::Snapshot::Snapshot()
+        : _position(0.0)
+        , _focusPosition(0.0)
+        , _viewDirection(_VIEW_DIRECTION_CAMERA_SPACE)
+        , _lookUpVector(_LOOKUP_VECTOR_CAMERA_SPACE)
+        , _rotation()
+        , _scaling(1.f, 0.f)
+        , _maxFov(0.f)
+        , _sinMaxFov(0.f)
+        , _viewRotationMatrix(1.0)
+        , _combinedViewMatrix(1.0)
+        , _combinedViewProjectionMatrix(1.0)
+        , _viewMatrix(1.f)
+        , _projectionMatrix(1.f)
+        , _viewProjectionMatrix(1.f)
+        , _frustumPlanes()
+        , _version(0)
+    {}
+
+    const Camera::Vec3& Camera::Snapshot::positionVec3() const {
+        return _position;
+    }
+
+    const Camera::Vec3& Camera::Snapshot::unsynchedPositionVec3() const {
+        return _position;
+    }
+
+    const Camera::Vec3& Camera::Snapshot::focusPositionVec3() const {
+        return _focusPosition;
+    }
+
+    const Camera::Vec3& Camera::Snapshot::viewDirectionWorldSpace() const {
+        return _viewDirection;
+    }
+
+    const Camera::Vec3& Camera::Snapshot::lookUpVectorCameraSpace() const {
+        return _LOOKUP_VECTOR_CAMERA_SPACE;
+    }
+
+    const Camera::Vec3& Camera::Snapshot::lookUpVectorWorldSpace() const {
+        return _lookUpVector;
+    }
+
+    const glm::vec2& Camera::Snapshot::scaling() const {
+        return _scaling;
+    }
+
+    const Camera::Mat4& Camera::Snapshot::viewRotationMatrix() const {
+        return _viewRotationMatrix;
+    }
+
+    const Camera::Quat& Camera::Snapshot::rotationQuaternion() const {
+        return _rotation;
+    }
+
+    float Camera::Snapshot::maxFov() const {
+        return _maxFov;
+    }
+
+    float Camera::Snapshot::sinMaxFov() const {
+        return _sinMaxFov;
+    }
+
+    const Camera::Mat4& Camera::Snapshot::combinedViewMatrix() const {
+        return _combinedViewMatrix;
+    }
+
+    const glm::mat4& Camera::Snapshot::viewMatrix() const {
+        return _viewMatrix;
+    }
+
+    const glm::mat4& Camera::Snapshot::projectionMatrix() const {
+        return _projectionMatrix;
+    }
+
+    const glm::mat4& Camera::Snapshot::viewProjectionMatrix() const {
+        return _viewProjectionMatrix;
+    }
+
+    const Camera::Mat4& Camera::Snapshot::combinedViewProjectionMatrix() const {
+        return _combinedViewProjectionMatrix;
+    }
+
+    const std::array<glm::dvec4, 6>& Camera::Snapshot::frustumPlanes() const {
+        return _frustumPlanes;
+    }
+
+    uint64_t Camera::Snapshot::version() const {
+        return _version;
+    }
+
+    psc Camera::Snapshot::position() const {
+        return psc(_position);
+    }
+
+    psc Camera::Snapshot::unsynchedPosition() const {
+        return psc(_position);
+    }
+
+    psc Camera::Snapshot::focusPosition() const {
+        return psc(_focusPosition);
+    }
+
+    Camera::SnapshotReference::SnapshotReference(const Snapshot* snapshot,
+                                                 std::atomic<int>* nReaders)
+        : _snapshot(snapshot)
+        , _nReaders(nReaders)
+    {}
+
+    Camera::SnapshotReference::SnapshotReference(SnapshotReference&& other)
+        : _snapshot(other._snapshot)
+        , _nReaders(other._nReaders)
+    {
+        other._snapshot = nullptr;
+        other._nReaders = nullptr;
+    }
+
+    Camera::SnapshotReference::~SnapshotReference() {
+        if (_nReaders) {
+            --(*_nReaders);
+        }
+    }
+
+    const Camera::Snapshot& Camera::SnapshotReference::operator*() const {
+        return *_snapshot;
+    }
+
+    const Camera::Snapshot* Camera::SnapshotReference::operator->() const {
+        return _snapshot;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////
     //                                    SGCT INTERNAL                                    //
     //////////////////////////////////////////////////////////////////////////////////////
@@ -224,15 +444,11 @@ namespace openspace {
     { }
 
     void Camera::SgctInternal::setViewMatrix(glm::mat4 viewMatrix) {
-        std::lock_guard<std::mutex> _lock(_mutex);
-
         _viewMatrix = std::move(viewMatrix);
         _cachedViewProjectionMatrix.isDirty = true;
     }
 
     void Camera::SgctInternal::setProjectionMatrix(glm::mat4 projectionMatrix) {
-        std::lock_guard<std::mutex> _lock(_mutex);
-
         _projectionMatrix = std::move(projectionMatrix);
         _cachedViewProjectionMatrix.isDirty = true;
     }
@@ -247,7 +463,6 @@ namespace openspace {
 
     const glm::mat4& Camera::SgctInternal::viewProjectionMatrix() const {
         if (_cachedViewProjectionMatrix.isDirty) {
-            std::lock_guard<std::mutex> _lock(_mutex);
             _cachedViewProjectionMatrix.datum = _projectionMatrix * _viewMatrix;
             _cachedViewProjectionMatrix.isDirty = false;
         }
@@ -256,12 +471,10 @@ namespace openspace {
 
     // Deprecated
     void Camera::setPosition(psc pos) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _position = pos.dvec3();
     }
 
     void Camera::setFocusPosition(psc pos) {
-        std::lock_guard<std::mutex> _lock(_mutex);
         _focusPosition = pos.dvec3();
     }
 
@@ -0,0 +1,254 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/jobmanager.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+namespace {
+    // The manager and worker index of the current thread, if it is a worker thread.
+    // Jobs that are enqueued from within a job are placed in the worker's own queue
+    thread_local openspace::JobManager* CurrentManager = nullptr;
+    thread_local int CurrentWorker = -1;
+}
+
+namespace openspace {
+
+JobManager::CancellationToken::CancellationToken()
+    : _isCancelled(std::make_shared<std::atomic_bool>(false))
+{}
+
+void JobManager::CancellationToken::cancel() {
+    *_isCancelled = true;
+}
+
+bool JobManager::CancellationToken::isCancelled() const {
+    return *_isCancelled;
+}
+
+JobManager::JobManager(int nWorkers)
+    : _shouldStop(false)
+    , _nextQueue(0)
+    , _nQueuedTasks(0)
+    , _nUnfinishedTasks(0)
+    , _nFinishedTasks(0)
+    , _nCancelledTasks(0)
+    , _busyNanoseconds(0)
+    , _lastStatisticsTime(std::chrono::steady_clock::now())
+{
+    if (nWorkers <= 0) {
+        nWorkers = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+    }
+
+    for (int i = 0; i < nWorkers; ++i) {
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < nWorkers; ++i) {
+        _workers.emplace_back([this, i]() { work(i); });
+    }
+}
+
+JobManager::~JobManager() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _shouldStop = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void JobManager::enqueue(std::function<void()> job, Priority priority,
+                         CancellationToken token)
+{
+    ghoul_assert(job, "Job must not be empty");
+
+    int queueIndex;
+    if (CurrentManager == this) {
+        queueIndex = CurrentWorker;
+    }
+    else {
+        queueIndex = static_cast<int>(_nextQueue++ % _queues.size());
+    }
+
+    // The counters are increased before the task becomes visible, so that they can never
+    // be decremented below zero by a worker that picks the task up immediately
+    ++_nUnfinishedTasks;
+    ++_nQueuedTasks;
+    {
+        WorkerQueue& queue = *_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks[static_cast<int>(priority)].push_back(
+            { std::move(job), std::move(token) }
+        );
+    }
+
+    {
+        // Taking the lock prevents the notification from getting lost between a
+        // worker's check for work and it going to sleep
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _workAvailable.notify_one();
+}
+
+void JobManager::enqueueOnMainThread(std::function<void()> f, CancellationToken token) {
+    ghoul_assert(f, "Function must not be empty");
+
+    std::lock_guard<std::mutex> lock(_mainThreadMutex);
+    _mainThreadTasks.push_back({ std::move(f), std::move(token) });
+}
+
+int JobManager::drainMainThreadQueue(std::chrono::microseconds budget) {
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    // The maximum budget would overflow when converted to the clock's resolution
+    const bool hasBudget = budget != microseconds::max();
+
+    int nExecuted = 0;
+    while (true) {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(_mainThreadMutex);
+            if (_mainThreadTasks.empty()) {
+                break;
+            }
+            task = std::move(_mainThreadTasks.front());
+            _mainThreadTasks.pop_front();
+        }
+
+        if (!task.token.isCancelled()) {
+            task.function();
+            ++nExecuted;
+        }
+
+        if (hasBudget && nExecuted > 0 && steady_clock::now() - start >= budget) {
+            break;
+        }
+    }
+    return nExecuted;
+}
+
+void JobManager::waitForIdle() {
+    ghoul_assert(CurrentManager != this, "Must not be called from a worker thread");
+
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _allTasksFinished.wait(lock, [this]() { return _nUnfinishedTasks == 0; });
+}
+
+int JobManager::nWorkers() const {
+    return static_cast<int>(_workers.size());
+}
+
+JobManager::Statistics JobManager::statistics() {
+    using namespace std::chrono;
+    const steady_clock::time_point now = steady_clock::now();
+    const double elapsed = static_cast<double>(
+        duration_cast<nanoseconds>(now - _lastStatisticsTime).count()
+    );
+    _lastStatisticsTime = now;
+    const uint64_t busy = _busyNanoseconds.exchange(0);
+
+    Statistics stats;
+    stats.nWorkers = nWorkers();
+    stats.nQueuedJobs = static_cast<size_t>(std::max<int64_t>(_nQueuedTasks, 0));
+    {
+        std::lock_guard<std::mutex> lock(_mainThreadMutex);
+        stats.nQueuedContinuations = _mainThreadTasks.size();
+    }
+    stats.nFinishedJobs = _nFinishedTasks;
+    stats.nCancelledJobs = _nCancelledTasks;
+    stats.utilization = elapsed > 0.0 ?
+        std::min(static_cast<double>(busy) / (elapsed * stats.nWorkers), 1.0) :
+        0.0;
+    return stats;
+}
+
+void JobManager::work(int workerIndex) {
+    CurrentManager = this;
+    CurrentWorker = workerIndex;
+
+    while (true) {
+        Task task;
+        if (popTask(workerIndex, task)) {
+            --_nQueuedTasks;
+
+            if (task.token.isCancelled()) {
+                ++_nCancelledTasks;
+            }
+            else {
+                using namespace std::chrono;
+                const steady_clock::time_point start = steady_clock::now();
+                task.function();
+                _busyNanoseconds += duration_cast<nanoseconds>(
+                    steady_clock::now() - start
+                ).count();
+                ++_nFinishedTasks;
+            }
+            // Release the captured state before the task is reported as finished
+            task = Task();
+            finishTask();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _workAvailable.wait(lock, [this]() {
+            return _shouldStop || _nQueuedTasks > 0;
+        });
+        if (_shouldStop) {
+            return;
+        }
+    }
+}
+
+bool JobManager::popTask(int workerIndex, Task& task) {
+    const int nQueues = static_cast<int>(_queues.size());
+
+    // Within a priority, the worker's own queue is checked first before stealing from
+    // the other workers' queues. Jobs are always taken in the order they were enqueued
+    for (int p = NumberPriorities - 1; p >= 0; --p) {
+        for (int i = 0; i < nQueues; ++i) {
+            WorkerQueue& queue = *_queues[(workerIndex + i) % nQueues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks[p].empty()) {
+                task = std::move(queue.tasks[p].front());
+                queue.tasks[p].pop_front();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void JobManager::finishTask() {
+    if (--_nUnfinishedTasks == 0) {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _allTasksFinished.notify_all();
+    }
+}
+
+} // namespace openspace
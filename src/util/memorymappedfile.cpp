@@ -0,0 +1,201 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace openspace {
+
+MemoryMappedFile::MemoryMappedFileError::MemoryMappedFileError(std::string msg)
+    : ghoul::RuntimeError(std::move(msg), "MemoryMappedFile")
+{}
+
+MemoryMappedFile::MemoryMappedFile(std::string filename, Access access)
+    : _filename(std::move(filename))
+    , _access(access)
+    , _size(0)
+    , _data(nullptr)
+#ifdef WIN32
+    , _fileHandle(INVALID_HANDLE_VALUE)
+    , _mappingHandle(nullptr)
+#else
+    , _fileDescriptor(-1)
+#endif
+{
+#ifdef WIN32
+    _fileHandle = CreateFileA(
+        _filename.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        throw MemoryMappedFileError("Could not open file '" + _filename + "'");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(_fileHandle, &size)) {
+        CloseHandle(_fileHandle);
+        throw MemoryMappedFileError("Could not get size of file '" + _filename + "'");
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) {
+        // Empty files cannot be mapped, but are valid nevertheless
+        return;
+    }
+
+    _mappingHandle = CreateFileMappingA(
+        _fileHandle,
+        nullptr,
+        access == Access::ReadOnly ? PAGE_READONLY : PAGE_WRITECOPY,
+        0,
+        0,
+        nullptr
+    );
+    if (!_mappingHandle) {
+        CloseHandle(_fileHandle);
+        throw MemoryMappedFileError("Could not map file '" + _filename + "'");
+    }
+
+    _data = reinterpret_cast<char*>(MapViewOfFile(
+        _mappingHandle,
+        access == Access::ReadOnly ? FILE_MAP_READ : FILE_MAP_COPY,
+        0,
+        0,
+        0
+    ));
+    if (!_data) {
+        CloseHandle(_mappingHandle);
+        CloseHandle(_fileHandle);
+        throw MemoryMappedFileError("Could not map view of file '" + _filename + "'");
+    }
+#else
+    _fileDescriptor = open(_filename.c_str(), O_RDONLY);
+    if (_fileDescriptor == -1) {
+        throw MemoryMappedFileError("Could not open file '" + _filename + "'");
+    }
+
+    struct stat fileStat;
+    if (fstat(_fileDescriptor, &fileStat) == -1) {
+        close(_fileDescriptor);
+        throw MemoryMappedFileError("Could not get size of file '" + _filename + "'");
+    }
+    _size = static_cast<size_t>(fileStat.st_size);
+    if (_size == 0) {
+        // Empty files cannot be mapped, but are valid nevertheless
+        return;
+    }
+
+    void* data = mmap(
+        nullptr,
+        _size,
+        access == Access::ReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE),
+        MAP_PRIVATE,
+        _fileDescriptor,
+        0
+    );
+    if (data == MAP_FAILED) {
+        close(_fileDescriptor);
+        throw MemoryMappedFileError("Could not map file '" + _filename + "'");
+    }
+    _data = reinterpret_cast<char*>(data);
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(_fileHandle);
+    }
+#else
+    if (_data) {
+        munmap(_data, _size);
+    }
+    if (_fileDescriptor != -1) {
+        close(_fileDescriptor);
+    }
+#endif
+}
+
+const std::string& MemoryMappedFile::filename() const {
+    return _filename;
+}
+
+size_t MemoryMappedFile::size() const {
+    return _size;
+}
+
+const char* MemoryMappedFile::data() const {
+    return _data;
+}
+
+char* MemoryMappedFile::data() {
+    ghoul_assert(
+        _access == Access::CopyOnWrite,
+        "Writable access requires a copy-on-write mapping"
+    );
+    return _data;
+}
+
+void MemoryMappedFile::prefetch(size_t offset, size_t length) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    length = std::min(length, _size - offset);
+
+#ifdef WIN32
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = _data + offset;
+    range.NumberOfBytes = length;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise requires a page-aligned start address
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t alignedOffset = offset - (offset % pageSize);
+    madvise(_data + alignedOffset, length + (offset - alignedOffset), MADV_WILLNEED);
+#endif
+}
+
+} // namespace openspace
@@ -42,7 +42,7 @@ OpenSpaceModule::OpenSpaceModule(std::string name) {
     setName(name);
 }
 
-void OpenSpaceModule::initialize() {
+void OpenSpaceModule::registerPathToken() {
     std::string upperName = name();
     std::transform(upperName.begin(), upperName.end(), upperName.begin(), toupper);
     
@@ -55,7 +55,13 @@ void OpenSpaceModule::initialize() {
     std::string path = modulePath();
     LDEBUG("Registering module path: " << moduleToken << ": " << path);
     FileSys.registerPathToken(moduleToken, path);
-    
+}
+
+void OpenSpaceModule::prepare() {
+    internalPrepare();
+}
+
+void OpenSpaceModule::initialize() {
     internalInitialize();
 }
 
@@ -67,6 +73,10 @@ std::vector<Documentation> OpenSpaceModule::documentations() const {
     return {};
 }
 
+std::vector<std::string> OpenSpaceModule::requiredModules() const {
+    return {};
+}
+
 std::string OpenSpaceModule::modulePath() const {
     std::string moduleName = name();
     std::transform(moduleName.begin(), moduleName.end(), moduleName.begin(), tolower);
@@ -83,6 +93,7 @@ std::string OpenSpaceModule::modulePath() const {
     );
 }
 
+void OpenSpaceModule::internalPrepare() {}
 void OpenSpaceModule::internalInitialize() {}
 void OpenSpaceModule::internalDeinitialize() {}
 
@@ -0,0 +1,117 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <openspace/util/prefixindex.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <numeric>
+
+namespace {
+    std::string toLower(const std::string& s) {
+        std::string result(s.size(), '\0');
+        std::transform(
+            s.begin(),
+            s.end(),
+            result.begin(),
+            [](unsigned char c) { return static_cast<char>(::tolower(c)); }
+        );
+        return result;
+    }
+} // namespace
+
+namespace openspace {
+
+PrefixIndex::PrefixIndex(std::vector<std::string> entries) {
+    set(std::move(entries));
+}
+
+void PrefixIndex::set(std::vector<std::string> entries) {
+    std::vector<std::string> keys;
+    keys.reserve(entries.size());
+    std::transform(entries.begin(), entries.end(), std::back_inserter(keys), toLower);
+
+    // Sort a permutation so that the entries and keys can be moved into place together.
+    // Entries that only differ in case are ordered by their original spelling
+    std::vector<size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(
+        order.begin(),
+        order.end(),
+        [&](size_t lhs, size_t rhs) {
+            if (keys[lhs] != keys[rhs])
+                return keys[lhs] < keys[rhs];
+            return entries[lhs] < entries[rhs];
+        }
+    );
+
+    _entries.clear();
+    _keys.clear();
+    _entries.reserve(entries.size());
+    _keys.reserve(entries.size());
+    for (size_t i : order) {
+        if (!_entries.empty() && _entries.back() == entries[i])
+            continue;
+        _entries.push_back(std::move(entries[i]));
+        _keys.push_back(std::move(keys[i]));
+    }
+}
+
+PrefixIndex::Range PrefixIndex::matches(const std::string& prefix) const {
+    std::string key = toLower(prefix);
+
+    auto begin = std::lower_bound(_keys.begin(), _keys.end(), key);
+    // All keys that start with the prefix are sorted before the first key that is
+    // larger than the prefix in its first prefix.size() characters
+    auto end = std::upper_bound(
+        begin,
+        _keys.end(),
+        key,
+        [](const std::string& k, const std::string& entry) {
+            return entry.compare(0, k.size(), k) > 0;
+        }
+    );
+
+    return {
+        static_cast<size_t>(begin - _keys.begin()),
+        static_cast<size_t>(end - _keys.begin())
+    };
+}
+
+const std::string& PrefixIndex::operator[](size_t index) const {
+    ghoul_assert(index < _entries.size(), "Index out of range");
+    return _entries[index];
+}
+
+size_t PrefixIndex::size() const {
+    return _entries.size();
+}
+
+bool PrefixIndex::empty() const {
+    return _entries.empty();
+}
+
+} // namespace openspace
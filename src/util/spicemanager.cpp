@@ -232,6 +232,9 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(string filePath) {
     else if (fileExtension == "bsp" || fileExtension == "BSP")
         findSpkCoverage(path); // binary spk kernel
 
+    // A new kernel might change the orientation of already cached frames
+    clearTransformCache();
+
     KernelHandle kernelId = ++_lastAssignedKernel;
     ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
     _loadedKernels.push_back({std::move(path), kernelId, 1});
@@ -252,6 +255,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             LINFO(format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
             _loadedKernels.erase(it);
+            clearTransformCache();
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -280,6 +284,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
             LINFO(format("Unloading SPICE kernel '{}'", path));
             unload_c(path.c_str());
             _loadedKernels.erase(it);
+            clearTransformCache();
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -699,6 +704,11 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& fromFrame,
 {
     ghoul_assert(!fromFrame.empty(), "fromFrame must not be empty");
     ghoul_assert(!toFrame.empty(), "toFrame must not be empty");
+
+    auto it = _transformCache.find(std::tie(fromFrame, toFrame, ephemerisTime));
+    if (it != _transformCache.end()) {
+        return it->second;
+    }
     
     glm::dmat3 result;
     pxform_c(
@@ -714,7 +724,20 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& fromFrame,
     if (!success)
         result = getEstimatedTransformMatrix(fromFrame, toFrame, ephemerisTime);
 
-    return glm::transpose(result);
+    result = glm::transpose(result);
+    _transformCache.emplace(
+        TransformCacheKey(fromFrame, toFrame, ephemerisTime),
+        result
+    );
+    return result;
+}
+
+void SpiceManager::clearTransformCache() {
+    _transformCache.clear();
+}
+
+size_t SpiceManager::numberOfCachedTransforms() const {
+    return _transformCache.size();
 }
 
 glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& fromFrame,
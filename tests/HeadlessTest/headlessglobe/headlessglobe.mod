@@ -0,0 +1,34 @@
+return {
+    {
+        Name = "HeadlessGlobe",
+        Parent = "Root",
+        Renderable = {
+            Type = "RenderableGlobe",
+            Frame = "GALACTIC",
+            Radii = { 1000000.0, 1000000.0, 1000000.0 },
+            CameraMinHeight = 100,
+            InteractionDepthBelowEllipsoid = 0,
+            SegmentsPerPatch = 8,
+            TextureInitData = {
+                ColorTextureMinimumSize = 16,
+                OverlayMinimumSize = 16,
+                HeightMapMinimumSize = 16,
+            },
+            Textures = {
+                ColorTextures = {
+                    -- A global dataset without any sources, which GDAL reads as zeros
+                    {
+                        Name = "Blank",
+                        FilePath = "blank.vrt",
+                        Enabled = true,
+                    },
+                },
+                GrayScaleOverlays = { },
+                NightTextures = { },
+                WaterMasks = { },
+                Overlays = { },
+                HeightMaps = { },
+            },
+        },
+    },
+}
@@ -35,11 +35,19 @@
 #include <test_spicemanager.inl>
 #include <test_scenegraphloader.inl>
 
+#ifdef OPENSPACE_MODULE_BASE_ENABLED
+#include <test_spicerotation.inl>
+#include <test_modelcache.inl>
+#endif
+
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
 //#include <test_chunknode.inl>
 #include <test_lrucache.inl>
 #include <test_aabb.inl>
+#include <test_ellipsoid.inl>
 #include <test_convexhull.inl>
+#include <test_culling.inl>
+#include <test_chunklevelscheduler.inl>
 
 #include <test_angle.inl>
 //#include <test_latlonpatch.inl>
@@ -48,10 +56,22 @@
 
 #include <test_concurrentqueue.inl>
 #include <test_concurrentjobmanager.inl>
+#include <test_tileprovidermanager.inl>
 #endif
 
 #include <test_luaconversions.inl>
 #include <test_powerscalecoordinates.inl>
+#include <test_jobmanager.inl>
+#include <test_texturecache.inl>
+#include <test_sessionrecording.inl>
+#include <test_scriptscheduler.inl>
+#include <test_camera.inl>
+#include <test_performancelayout.inl>
+#include <test_raycasterregistry.inl>
+#include <test_prefixindex.inl>
+#include <test_luaconsole.inl>
+#include <test_moduleengine.inl>
+#include <test_parallelconnection.inl>
 
 #ifdef OPENSPACE_MODULE_ISWA_ENABLED
 #include <test_screenspaceimage.inl>
@@ -60,8 +80,29 @@
 
 #include <test_documentation.inl>
 
+#ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
+#include <test_propertytree.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_NEWHORIZONS_ENABLED
+#include <test_sequenceparsercache.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_MULTIRESVOLUME_ENABLED
+#include <test_tsp.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_VOLUME_ENABLED
+#include <test_rawvolume.inl>
+#include <test_slicestackresampler.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+#include <test_headless.inl>
+#endif
+
 #include <openspace/engine/openspaceengine.h>
-#include <openspace/engine/wrapper/windowwrapper.h>
+#include <openspace/engine/wrapper/headlesswindowwrapper.h>
 #include <openspace/engine/configurationmanager.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/time.h>
@@ -80,7 +121,12 @@ namespace {
 
 int main(int argc, char** argv) {
     std::vector<std::string> args;
-    openspace::OpenSpaceEngine::create(argc, argv, std::make_unique<openspace::WindowWrapper>(), args);
+    // There is no OpenGL context in the tests, which the headless window tells the engine
+    openspace::OpenSpaceEngine::create(
+        argc, argv,
+        std::make_unique<openspace::HeadlessWindowWrapper>(),
+        args
+    );
 
     testing::InitGoogleTest(&argc, argv);
 
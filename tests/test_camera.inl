@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include "gtest/gtest.h"
+
+#include <openspace/util/camera.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class CameraTest : public testing::Test {};
+
+namespace {
+    // Puts the camera in a state in which every component is derived from i, so that
+    // a snapshot mixing two states can be detected
+    void setCameraState(openspace::Camera& camera, int i) {
+        double d = static_cast<double>(i);
+        camera.setPositionVec3(glm::dvec3(d, d, d));
+        camera.setRotation(glm::angleAxis(d * 1e-3, glm::dvec3(0.0, 1.0, 0.0)));
+        camera.setScaling(glm::vec2(static_cast<float>(i), 0.f));
+        camera.sgctInternal.setViewMatrix(
+            glm::translate(glm::mat4(1.f), glm::vec3(static_cast<float>(i)))
+        );
+        camera.sgctInternal.setProjectionMatrix(
+            glm::perspective(1.f, 1.f + static_cast<float>(i) * 1e-4f, 0.1f, 100.f)
+        );
+    }
+}
+
+TEST_F(CameraTest, SnapshotReflectsPublishedState) {
+    openspace::Camera camera;
+    setCameraState(camera, 42);
+
+    uint64_t versionBefore = camera.snapshot()->version();
+    EXPECT_NE(42.0, camera.snapshot()->positionVec3().x);
+
+    camera.publishSnapshot();
+    openspace::Camera::SnapshotReference snapshot = camera.snapshot();
+    EXPECT_EQ(versionBefore + 1, snapshot->version());
+    EXPECT_EQ(glm::dvec3(42.0), snapshot->positionVec3());
+    EXPECT_EQ(camera.rotationQuaternion(), snapshot->rotationQuaternion());
+    EXPECT_EQ(camera.sgctInternal.viewMatrix(), snapshot->viewMatrix());
+    EXPECT_EQ(camera.sgctInternal.projectionMatrix(), snapshot->projectionMatrix());
+
+    // Modifying the camera does not change a published snapshot
+    setCameraState(camera, 43);
+    EXPECT_EQ(glm::dvec3(42.0), snapshot->positionVec3());
+}
+
+TEST_F(CameraTest, SnapshotFrustumPlanes) {
+    openspace::Camera camera;
+    camera.setPositionVec3(glm::dvec3(0.0));
+    camera.setRotation(glm::dquat(1.0, 0.0, 0.0, 0.0));
+    camera.sgctInternal.setViewMatrix(glm::mat4(1.f));
+    camera.sgctInternal.setProjectionMatrix(
+        glm::perspective(glm::radians(90.f), 1.f, 1.f, 100.f)
+    );
+    camera.publishSnapshot();
+
+    openspace::Camera::SnapshotReference snapshot = camera.snapshot();
+    auto isInside = [&snapshot](const glm::dvec3& p) {
+        for (const glm::dvec4& plane : snapshot->frustumPlanes()) {
+            if (glm::dot(glm::dvec3(plane), p) + plane.w < 0.0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // The camera looks down the negative z axis
+    EXPECT_TRUE(isInside(glm::dvec3(0.0, 0.0, -10.0)));
+    EXPECT_TRUE(isInside(glm::dvec3(5.0, -5.0, -10.0)));
+    EXPECT_FALSE(isInside(glm::dvec3(0.0, 0.0, 10.0)));
+    EXPECT_FALSE(isInside(glm::dvec3(0.0, 0.0, -0.5)));
+    EXPECT_FALSE(isInside(glm::dvec3(0.0, 0.0, -200.0)));
+    EXPECT_FALSE(isInside(glm::dvec3(20.0, 0.0, -10.0)));
+    EXPECT_FALSE(isInside(glm::dvec3(0.0, -20.0, -10.0)));
+}
+
+TEST_F(CameraTest, ConcurrentSnapshotsAreConsistent) {
+    const int nStates = 20000;
+    const int nReaders = 4;
+
+    openspace::Camera camera;
+    setCameraState(camera, 0);
+    camera.publishSnapshot();
+
+    std::atomic<bool> isDone(false);
+    std::atomic<int> nInconsistencies(0);
+    std::atomic<int64_t> nReads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < nReaders; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t lastVersion = 0;
+            while (!isDone) {
+                openspace::Camera::SnapshotReference s = camera.snapshot();
+
+                double i = s->positionVec3().x;
+                glm::dquat rotation = glm::angleAxis(i * 1e-3, glm::dvec3(0.0, 1.0, 0.0));
+                bool isConsistent =
+                    s->positionVec3().y == i &&
+                    s->positionVec3().z == i &&
+                    s->rotationQuaternion() == rotation &&
+                    s->scaling().x == static_cast<float>(i) &&
+                    s->viewMatrix()[3][0] == static_cast<float>(i) &&
+                    s->combinedViewMatrix() ==
+                        glm::dmat4(s->viewMatrix()) * s->viewRotationMatrix() *
+                        glm::inverse(glm::translate(glm::dmat4(1.0), s->positionVec3())) &&
+                    s->combinedViewProjectionMatrix() ==
+                        glm::dmat4(s->projectionMatrix()) * s->combinedViewMatrix() &&
+                    s->version() >= lastVersion;
+
+                if (!isConsistent) {
+                    ++nInconsistencies;
+                }
+                lastVersion = s->version();
+                ++nReads;
+            }
+        });
+    }
+
+    for (int i = 1; i <= nStates; ++i) {
+        setCameraState(camera, i);
+        camera.publishSnapshot();
+    }
+    isDone = true;
+
+    for (std::thread& t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(0, nInconsistencies);
+    EXPECT_LT(0, nReads);
+    EXPECT_EQ(glm::dvec3(static_cast<double>(nStates)), camera.snapshot()->positionVec3());
+}
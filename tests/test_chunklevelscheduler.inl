@@ -0,0 +1,309 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/chunk/chunklevelscheduler.h>
+#include <modules/globebrowsing/chunk/chunknode.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class ChunkLevelSchedulerTest : public testing::Test {
+protected:
+    // The two hemispheres of a globe without height data, whose desired levels are
+    // computed like EvaluateChunkLevelByDistance does it
+    class Globe {
+    public:
+        Globe(const openspace::Ellipsoid& ellipsoid,
+              const openspace::ChunkLevelScheduler::Settings& settings)
+            : _ellipsoid(ellipsoid)
+            , _left(openspace::Chunk(nullptr, openspace::ChunkIndex(0, 0, 1)))
+            , _right(openspace::Chunk(nullptr, openspace::ChunkIndex(1, 0, 1)))
+            , _data({ _camera, openspace::psc(), false })
+            , _scheduler(
+                [](const openspace::Chunk&) { return false; },
+                [this](const openspace::Chunk& chunk, const openspace::RenderData&) {
+                    return desiredLevel(chunk);
+                },
+                [](const openspace::Chunk&, const openspace::RenderData&) {
+                    return MaxLevel;
+                },
+                MinLevel
+            )
+        {
+            _scheduler.settings = settings;
+        }
+
+        // Updates the chunk tree for one frame
+        const openspace::ChunkLevelScheduler::Statistics& update(const Vec3& camera) {
+            _cameraPosition = camera;
+            _scheduler.beginFrame(camera, _ellipsoid);
+            _left.updateChunkTree(_data, _scheduler);
+            _right.updateChunkTree(_data, _scheduler);
+            _scheduler.endFrame();
+            return _scheduler.statistics();
+        }
+
+        int nNodes() const {
+            int n = 0;
+            auto count = [&n](const openspace::ChunkNode&) { ++n; };
+            _left.depthFirst(count);
+            _right.depthFirst(count);
+            return n;
+        }
+
+        // Returns the level of the leaf that covers the location
+        int levelAt(const openspace::Geodetic2& location) const {
+            const openspace::ChunkNode& root = location.lon < 0.0 ? _left : _right;
+            return root.find(location).getChunk().index().level;
+        }
+
+        // Returns the leaves and by how many levels their desired level exceeds the next
+        // level for the camera of the previous frame
+        std::vector<std::pair<openspace::ChunkIndex, double>> leafErrors() const {
+            std::vector<std::pair<openspace::ChunkIndex, double>> leaves;
+            auto collect = [this, &leaves](const openspace::ChunkNode& node) {
+                if (node.isLeaf()) {
+                    const openspace::Chunk& chunk = node.getChunk();
+                    double error = desiredLevel(chunk) - (chunk.index().level + 1);
+                    leaves.emplace_back(chunk.index(), error);
+                }
+            };
+            _left.depthFirst(collect);
+            _right.depthFirst(collect);
+            return leaves;
+        }
+
+        openspace::ChunkLevelScheduler& scheduler() { return _scheduler; }
+
+    private:
+        double desiredLevel(const openspace::Chunk& chunk) const {
+            openspace::Geodetic2 closestPoint = chunk.surfacePatch().closestPoint(
+                _ellipsoid.cartesianToGeodetic2(_cameraPosition)
+            );
+            double distance = glm::length(
+                _ellipsoid.cartesianSurfacePosition(closestPoint) - _cameraPosition
+            );
+            double scaleFactor = LodScaleFactor * _ellipsoid.minimumRadius();
+            return std::log2(scaleFactor / distance) + 1.0;
+        }
+
+        const openspace::Ellipsoid& _ellipsoid;
+        openspace::ChunkNode _left;
+        openspace::ChunkNode _right;
+        const openspace::Camera::Snapshot _camera;
+        openspace::RenderData _data;
+        Vec3 _cameraPosition;
+        openspace::ChunkLevelScheduler _scheduler;
+    };
+
+    // A settings object without hysteresis, budget, and reuse, which behaves like the
+    // chunk tree did before the scheduler existed
+    static openspace::ChunkLevelScheduler::Settings immediateSettings() {
+        openspace::ChunkLevelScheduler::Settings settings;
+        settings.hysteresis = 0.0;
+        settings.maxSplitsPerFrame = -1;
+        settings.maxMergesPerFrame = -1;
+        settings.reuseTolerance = 0.0;
+        return settings;
+    }
+
+    // The camera position above the target at the altitude
+    Vec3 cameraPosition(double altitude, double lateralOffset = 0.0) const {
+        openspace::Geodetic2 location(target.lat, target.lon + lateralOffset);
+        return earth.cartesianPosition({ location, altitude });
+    }
+
+    // The camera descends from orbit to the surface in the first frames and then hovers
+    // with a small deterministic jitter in altitude and position
+    Vec3 cameraPath(int frame) const {
+        if (frame < ApproachFrames) {
+            double t = static_cast<double>(frame) / (ApproachFrames - 1);
+            double ratio = HoverAltitude / OrbitAltitude;
+            return cameraPosition(OrbitAltitude * std::pow(ratio, t));
+        }
+        double jitter = std::sin(frame * 1.7) + 0.5 * std::sin(frame * 0.31);
+        return cameraPosition(HoverAltitude * (1.0 + 0.03 * jitter), 1e-4 * jitter);
+    }
+
+    static const int MinLevel = 2;
+    static const int MaxLevel = 22;
+    static const int ApproachFrames = 200;
+    static const int HoverFrames = 300;
+    static constexpr double LodScaleFactor = 10.0;
+    static constexpr double OrbitAltitude = 3.6e7;
+    static constexpr double HoverAltitude = 2e4;
+
+    const openspace::Ellipsoid earth = openspace::Ellipsoid(6378137.0, 6378137.0,
+        6356752.314245);
+    const openspace::Geodetic2 target = openspace::Geodetic2(0.5, 0.3);
+};
+
+TEST_F(ChunkLevelSchedulerTest, CameraPathConverges) {
+    openspace::ChunkLevelScheduler::Settings settings;
+    Globe globe(earth, settings);
+
+    std::vector<int> nNodes;
+    int nChangesWhileHovering = 0;
+    for (int frame = 0; frame < ApproachFrames + HoverFrames; ++frame) {
+        const openspace::ChunkLevelScheduler::Statistics& stats =
+            globe.update(cameraPath(frame));
+        ASSERT_LE(stats.nSplits, settings.maxSplitsPerFrame);
+        ASSERT_LE(stats.nMerges, settings.maxMergesPerFrame);
+        nNodes.push_back(globe.nNodes());
+
+        // Every split or merge changes the number of nodes
+        if (frame >= ApproachFrames + HoverFrames / 2) {
+            nChangesWhileHovering += stats.nSplits + stats.nMerges;
+        }
+    }
+
+    EXPECT_EQ(0, nChangesWhileHovering);
+    EXPECT_EQ(nNodes[ApproachFrames + HoverFrames / 2], nNodes.back());
+    const double scaleFactor = LodScaleFactor * earth.minimumRadius();
+    const double level = std::log2(scaleFactor / HoverAltitude) + 1.0;
+    EXPECT_NEAR(std::floor(level), globe.levelAt(target), 1.0);
+}
+
+TEST_F(ChunkLevelSchedulerTest, HysteresisBoundsOscillation) {
+    Globe immediate(earth, immediateSettings());
+    Globe scheduled(earth, openspace::ChunkLevelScheduler::Settings());
+
+    int nImmediateChanges = 0;
+    int nScheduledChanges = 0;
+    int minNodes = std::numeric_limits<int>::max();
+    int maxNodes = 0;
+    for (int frame = 0; frame < ApproachFrames + HoverFrames; ++frame) {
+        const openspace::ChunkLevelScheduler::Statistics& i =
+            immediate.update(cameraPath(frame));
+        const openspace::ChunkLevelScheduler::Statistics& s =
+            scheduled.update(cameraPath(frame));
+
+        // Give both trees some time to settle after the approach
+        if (frame >= ApproachFrames + 50) {
+            nImmediateChanges += i.nSplits + i.nMerges;
+            nScheduledChanges += s.nSplits + s.nMerges;
+            minNodes = std::min(minNodes, scheduled.nNodes());
+            maxNodes = std::max(maxNodes, scheduled.nNodes());
+        }
+    }
+
+    // The jitter makes chunks without hysteresis split and merge back and forth
+    EXPECT_GT(nImmediateChanges, 0);
+    EXPECT_EQ(0, nScheduledChanges);
+    EXPECT_EQ(minNodes, maxNodes);
+}
+
+TEST_F(ChunkLevelSchedulerTest, BudgetDefersSplitsByPriority) {
+    openspace::ChunkLevelScheduler::Settings settings = immediateSettings();
+    Globe unlimited(earth, settings);
+    settings.maxSplitsPerFrame = 8;
+    Globe budgeted(earth, settings);
+
+    // Start in orbit and jump to the surface
+    const Vec3 orbit = cameraPosition(OrbitAltitude);
+    for (int frame = 0; frame < 10; ++frame) {
+        unlimited.update(orbit);
+        budgeted.update(orbit);
+    }
+    ASSERT_EQ(unlimited.nNodes(), budgeted.nNodes());
+
+    const Vec3 surface = cameraPosition(HoverAltitude);
+    unlimited.update(surface);
+    budgeted.update(surface);
+
+    int nDeferredSplits = 0;
+    for (int frame = 1; frame < 200; ++frame) {
+        unlimited.update(surface);
+
+        std::vector<std::pair<openspace::ChunkIndex, double>> leaves =
+            budgeted.leafErrors();
+        int nNodesBefore = budgeted.nNodes();
+        const openspace::ChunkLevelScheduler::Statistics& stats =
+            budgeted.update(surface);
+        EXPECT_LE(stats.nSplits, settings.maxSplitsPerFrame);
+        EXPECT_EQ(4 * stats.nSplits, budgeted.nNodes() - nNodesBefore);
+        nDeferredSplits += stats.nDeferredSplits;
+
+        // No leaf that still wants to split has a larger error than the split ones
+        double minSplitError = std::numeric_limits<double>::max();
+        double maxDeferredError = 0.0;
+        for (const std::pair<openspace::ChunkIndex, double>& leaf : leaves) {
+            openspace::Geodetic2 center = openspace::GeodeticPatch(leaf.first).center();
+            if (budgeted.levelAt(center) > leaf.first.level) {
+                minSplitError = std::min(minSplitError, leaf.second);
+            }
+            else if (leaf.first.level < MaxLevel) {
+                maxDeferredError = std::max(maxDeferredError, leaf.second);
+            }
+        }
+        if (stats.nDeferredSplits > 0) {
+            EXPECT_GE(minSplitError, maxDeferredError);
+        }
+    }
+
+    EXPECT_GT(nDeferredSplits, 0);
+    EXPECT_EQ(0, budgeted.scheduler().statistics().nDeferredSplits);
+    EXPECT_EQ(unlimited.nNodes(), budgeted.nNodes());
+    EXPECT_EQ(unlimited.levelAt(target), budgeted.levelAt(target));
+}
+
+TEST_F(ChunkLevelSchedulerTest, ReusesLevels) {
+    openspace::ChunkLevelScheduler::Settings settings;
+    settings.maxReuseFrames = 10 * ApproachFrames;
+    Globe globe(earth, settings);
+
+    const Vec3 camera = cameraPosition(HoverAltitude);
+    for (int frame = 0; frame < ApproachFrames; ++frame) {
+        globe.update(camera);
+    }
+
+    // A camera that barely moves reuses the levels of the previous frames
+    openspace::ChunkLevelScheduler::Statistics stats = globe.update(camera);
+    EXPECT_EQ(0, stats.nEvaluations);
+    EXPECT_EQ(globe.nNodes(), stats.nReusedEvaluations);
+
+    stats = globe.update(camera + Vec3(0.001 * settings.reuseTolerance * HoverAltitude));
+    EXPECT_EQ(0, stats.nEvaluations);
+
+    // A camera that moves far enough evaluates the closest chunks again
+    stats = globe.update(camera + Vec3(2.0 * settings.reuseTolerance * HoverAltitude));
+    EXPECT_GT(stats.nEvaluations, 0);
+    EXPECT_GT(stats.nReusedEvaluations, 0);
+
+    // Invalidated levels are all evaluated again
+    globe.scheduler().invalidateLevels();
+    stats = globe.update(camera);
+    EXPECT_EQ(globe.nNodes(), stats.nEvaluations);
+    EXPECT_EQ(0, stats.nReusedEvaluations);
+
+    // As are levels that are older than the maximum number of frames
+    globe.scheduler().settings.maxReuseFrames = 0;
+    stats = globe.update(camera);
+    EXPECT_EQ(globe.nNodes(), stats.nEvaluations);
+}
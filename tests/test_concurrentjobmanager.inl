@@ -25,7 +25,7 @@
 #include "gtest/gtest.h"
 
 #include <modules/globebrowsing/other/concurrentjobmanager.h>
-#include <ghoul/misc/threadpool.h>
+#include <openspace/util/jobmanager.h>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -68,7 +68,7 @@ private:
 
 
 TEST_F(ConcurrentJobManagerTest, Basic) {
-    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(1);
+    JobManager pool(2);
     
     ConcurrentJobManager<int> jobManager(pool);
 
@@ -147,7 +147,7 @@ struct VerboseJob : public Job<VerboseProduct>{
 
 
 TEST_F(ConcurrentJobManagerTest, JobCreation) {
-    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(1);
+    JobManager pool(1);
 
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
 
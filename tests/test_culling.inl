@@ -0,0 +1,236 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/chunk/culling.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+class CullingTest : public testing::Test {
+protected:
+    struct CameraPose {
+        glm::dvec3 position;
+        glm::dvec3 target;
+    };
+
+    // The frustum test as it was done per chunk before the culling context existed
+    static bool referenceFrustumCullable(const openspace::ChunkBounds& bounds,
+        const glm::dmat4& viewProjection, const glm::dmat4& modelTransform)
+    {
+        const openspace::AABB3 viewFrustum(glm::vec3(-1, -1, 0), glm::vec3(1, 1, 1e35));
+        glm::dmat4 modelViewProjectionTransform = viewProjection * modelTransform;
+        const std::vector<glm::dvec4> corners(
+            bounds.corners.begin(), bounds.corners.end()
+        );
+
+        openspace::AABB3 screenSpaceBounds;
+        std::vector<glm::vec4> clippingSpaceCorners(8);
+        for (size_t i = 0; i < 8; i++) {
+            glm::dvec4 cornerClippingSpace = modelViewProjectionTransform * corners[i];
+            clippingSpaceCorners[i] = cornerClippingSpace;
+
+            glm::dvec3 cornerScreenSpace =
+                (1.0f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace;
+            screenSpaceBounds.expand(cornerScreenSpace);
+        }
+        return !viewFrustum.intersects(screenSpaceBounds);
+    }
+
+    // The horizon test as it was done per chunk before the culling context existed
+    static bool referenceHorizonCullable(const openspace::ChunkBounds& bounds,
+        const openspace::Ellipsoid& ellipsoid, const glm::dvec3& cameraWorldPosition,
+        const glm::dmat4& inverseModelTransform)
+    {
+        Vec3 cameraPosition =
+            glm::dvec3(inverseModelTransform * glm::dvec4(cameraWorldPosition, 1));
+        openspace::Geodetic2 cameraPositionOnGlobe =
+            ellipsoid.cartesianToGeodetic2(cameraPosition);
+        openspace::Geodetic2 closestPatchPoint =
+            bounds.patch.closestPoint(cameraPositionOnGlobe);
+        Vec3 objectPosition = ellipsoid.cartesianSurfacePosition(closestPatchPoint);
+
+        return openspace::HorizonCuller().isCullable(cameraPosition, Vec3(0.0),
+            objectPosition, bounds.maxHeight, ellipsoid.minimumRadius());
+    }
+
+    // All chunks of a chunk tree that is fully split down to maxLevel
+    static std::vector<openspace::ChunkBounds> createChunkTree(
+        const openspace::Ellipsoid& ellipsoid, int maxLevel)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> minHeight(-10000.f, 0.f);
+        std::uniform_real_distribution<float> maxHeight(0.f, 10000.f);
+
+        std::vector<openspace::ChunkBounds> chunks;
+        for (int level = 1; level <= maxLevel; ++level) {
+            for (int x = 0; x < (1 << level); ++x) {
+                for (int y = 0; y < (1 << (level - 1)); ++y) {
+                    openspace::GeodeticPatch patch(openspace::ChunkIndex(x, y, level));
+                    chunks.emplace_back(
+                        patch, ellipsoid, minHeight(generator), maxHeight(generator)
+                    );
+                }
+            }
+        }
+        return chunks;
+    }
+
+    const openspace::Ellipsoid earth = openspace::Ellipsoid(6378137.0, 6378137.0,
+        6356752.314245);
+    const glm::dvec3 globePosition = glm::dvec3(1.5e11, 0.0, 0.0);
+    const glm::dmat4 modelTransform = glm::translate(glm::dmat4(1.0), globePosition);
+    const glm::dmat4 inverseModelTransform =
+        glm::translate(glm::dmat4(1.0), -globePosition);
+    const glm::dmat4 projection =
+        glm::dmat4(glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 1e20f));
+
+    // Cameras in orbit, close to the surface, above a pole and facing away
+    const std::vector<CameraPose> poses = {
+        { globePosition + glm::dvec3(0.0, 3.6e7, 0.0), globePosition },
+        { globePosition + glm::dvec3(6.4e6, 1e3, 0.0),
+          globePosition + glm::dvec3(6.4e6, 1e5, 1e5) },
+        { globePosition + glm::dvec3(0.0, 1e3, 7e6), globePosition },
+        { globePosition + glm::dvec3(2e7, 0.0, 0.0),
+          globePosition + glm::dvec3(3e7, 0.0, 0.0) }
+    };
+};
+
+TEST_F(CullingTest, IdenticalToPerChunkTests) {
+    std::vector<openspace::ChunkBounds> chunks = createChunkTree(earth, 6);
+    openspace::FrustumCuller frustumCuller(
+        openspace::AABB3(glm::vec3(-1, -1, 0), glm::vec3(1, 1, 1e35))
+    );
+    openspace::HorizonCuller horizonCuller;
+
+    int nFrustumCulledTotal = 0;
+    int nHorizonCulledTotal = 0;
+    for (const CameraPose& pose : poses) {
+        glm::dmat4 view = glm::lookAt(pose.position, pose.target, glm::dvec3(0, 0, 1));
+        glm::dmat4 viewProjection = projection * view;
+        openspace::CullingContext context;
+        context.update(viewProjection, pose.position, modelTransform,
+            inverseModelTransform, earth);
+
+        int nFrustumCulled = 0;
+        int nHorizonCulled = 0;
+        for (const openspace::ChunkBounds& chunk : chunks) {
+            bool frustum =
+                referenceFrustumCullable(chunk, viewProjection, modelTransform);
+            EXPECT_EQ(frustum, frustumCuller.isCullable(chunk, context));
+            nFrustumCulled += frustum;
+
+            bool horizon = referenceHorizonCullable(chunk, earth, pose.position,
+                inverseModelTransform);
+            EXPECT_EQ(horizon, horizonCuller.isCullable(chunk, context));
+            nHorizonCulled += horizon;
+        }
+        // Make sure that the poses exercise both outcomes of the tests
+        EXPECT_LT(nHorizonCulled, static_cast<int>(chunks.size()));
+        nFrustumCulledTotal += nFrustumCulled;
+        nHorizonCulledTotal += nHorizonCulled;
+    }
+    EXPECT_GT(nFrustumCulledTotal, 0);
+    EXPECT_LT(nFrustumCulledTotal, static_cast<int>(chunks.size() * poses.size()));
+    EXPECT_GT(nHorizonCulledTotal, 0);
+}
+
+TEST_F(CullingTest, BatchedCulling) {
+    std::vector<openspace::ChunkBounds> chunks = createChunkTree(earth, 6);
+    openspace::FrustumCuller frustumCuller(
+        openspace::AABB3(glm::vec3(-1, -1, 0), glm::vec3(1, 1, 1e35))
+    );
+    openspace::HorizonCuller horizonCuller;
+
+    for (const CameraPose& pose : poses) {
+        glm::dmat4 view = glm::lookAt(pose.position, pose.target, glm::dvec3(0, 0, 1));
+        openspace::CullingContext context;
+        context.update(projection * view, pose.position, modelTransform,
+            inverseModelTransform, earth);
+
+        std::vector<bool> cullable(chunks.size(), false);
+        horizonCuller.cull(chunks, context, cullable);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            EXPECT_EQ(horizonCuller.isCullable(chunks[i], context), cullable[i]) << i;
+        }
+
+        frustumCuller.cull(chunks, context, cullable);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            bool expected = horizonCuller.isCullable(chunks[i], context) ||
+                frustumCuller.isCullable(chunks[i], context);
+            EXPECT_EQ(expected, cullable[i]) << i;
+        }
+    }
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(CullingTest, TimingTest) {
+    std::ofstream logFile("CullingTest.timing");
+    std::vector<openspace::ChunkBounds> chunks = createChunkTree(earth, 7);
+    openspace::FrustumCuller frustumCuller(
+        openspace::AABB3(glm::vec3(-1, -1, 0), glm::vec3(1, 1, 1e35))
+    );
+    openspace::HorizonCuller horizonCuller;
+    const CameraPose& pose = poses[1];
+    glm::dmat4 viewProjection =
+        projection * glm::lookAt(pose.position, pose.target, glm::dvec3(0, 0, 1));
+    int nCulled = 0;
+
+    START_TIMER_NO_RESET(perChunk, logFile, 10);
+    for (const openspace::ChunkBounds& chunk : chunks) {
+        nCulled += referenceHorizonCullable(chunk, earth, pose.position,
+            inverseModelTransform) ||
+            referenceFrustumCullable(chunk, viewProjection, modelTransform);
+    }
+    FINISH_TIMER(perChunk, logFile);
+
+    START_TIMER_NO_RESET(context, logFile, 10);
+    openspace::CullingContext context;
+    context.update(viewProjection, pose.position, modelTransform,
+        inverseModelTransform, earth);
+    for (const openspace::ChunkBounds& chunk : chunks) {
+        nCulled += horizonCuller.isCullable(chunk, context) ||
+            frustumCuller.isCullable(chunk, context);
+    }
+    FINISH_TIMER(context, logFile);
+
+    START_TIMER_NO_RESET(batched, logFile, 10);
+    openspace::CullingContext context;
+    context.update(viewProjection, pose.position, modelTransform,
+        inverseModelTransform, earth);
+    std::vector<bool> cullable(chunks.size(), false);
+    horizonCuller.cull(chunks, context, cullable);
+    frustumCuller.cull(chunks, context, cullable);
+    nCulled += static_cast<int>(std::count(cullable.begin(), cullable.end(), true));
+    FINISH_TIMER(batched, logFile);
+
+    EXPECT_GT(nCulled, 0);
+}
+
+#endif // GHL_TIMING_TESTS
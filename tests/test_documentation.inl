@@ -2545,3 +2545,104 @@ TEST_F(DocumentationTest, VerifierDocumentationPostConditions) {
     EXPECT_NE("", ReferencingVerifier("identifier"s).documentation());
 
 }
+
+TEST_F(DocumentationTest, ReferencingWildcard) {
+    using namespace openspace::documentation;
+
+    Documentation referenced {
+        "Wildcard Referenced Name",
+        "wildcard_referenced_id",
+        {
+            { "a", new IntVerifier },
+            { "b", new DoubleVerifier, "", Optional::Yes }
+        },
+        Exhaustive::Yes
+    };
+    DocEng.addDocumentation(referenced);
+
+    Documentation doc {{
+        {
+            DocumentationEntry::Wildcard,
+            new ReferencingVerifier("wildcard_referenced_id")
+        }
+    }};
+
+    // Identical tables have to be reported at their own locations
+    ghoul::Dictionary negative {
+        { "First", ghoul::Dictionary{ { "a", 1 }, { "b", true } } },
+        { "Second", ghoul::Dictionary{ { "a", 1 }, { "b", true } } },
+        { "Third", ghoul::Dictionary{ { "a", 1 }, { "b", 2.0 }, { "c", 3.0 } } },
+        { "Fourth", ghoul::Dictionary{ { "a", 1 } } }
+    };
+
+    TestResult negativeRes = testSpecification(doc, negative);
+    EXPECT_FALSE(negativeRes.success);
+    ASSERT_EQ(3, negativeRes.offenses.size());
+    EXPECT_EQ("First.b", negativeRes.offenses[0].offender);
+    EXPECT_EQ(TestResult::Offense::Reason::WrongType, negativeRes.offenses[0].reason);
+    EXPECT_EQ("Second.b", negativeRes.offenses[1].offender);
+    EXPECT_EQ(TestResult::Offense::Reason::WrongType, negativeRes.offenses[1].reason);
+    EXPECT_EQ("Third.c", negativeRes.offenses[2].offender);
+    EXPECT_EQ(TestResult::Offense::Reason::ExtraKey, negativeRes.offenses[2].reason);
+
+    ghoul::Dictionary positive {
+        { "First", ghoul::Dictionary{ { "a", 1 }, { "b", 2.0 } } },
+        { "Second", ghoul::Dictionary{ { "a", 1 } } }
+    };
+    TestResult positiveRes = testSpecification(doc, positive);
+    EXPECT_TRUE(positiveRes.success);
+    EXPECT_EQ(0, positiveRes.offenses.size());
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(DocumentationTest, TimingTest) {
+    using namespace openspace::documentation;
+
+    std::ofstream logFile("DocumentationTest.timing");
+
+    // 100 layers with 100 keys each, similar to a large globe configuration
+    const int nLayers = 100;
+    const int nValues = 99;
+
+    ghoul::Dictionary dictionary;
+    for (int i = 0; i < nLayers; ++i) {
+        ghoul::Dictionary l;
+        l.setValue("Name", "Layer" + std::to_string(i));
+        for (int j = 0; j < nValues; ++j) {
+            l.setValue("Value" + std::to_string(j), static_cast<double>(j));
+        }
+        dictionary.setValue("Layer" + std::to_string(i), l);
+    }
+
+    Documentation::DocumentationEntries layerEntries = {
+        { "Name", new StringVerifier },
+        { "Enabled", new BoolVerifier, "", Optional::Yes }
+    };
+    for (int j = 0; j < nValues; ++j) {
+        layerEntries.push_back({
+            "Value" + std::to_string(j),
+            new DoubleInRangeVerifier(0.0, 100.0)
+        });
+    }
+
+    DocEng.addDocumentation({ "Timing Layer", "timing_layer_id", layerEntries });
+    Documentation doc {{
+        { DocumentationEntry::Wildcard, new ReferencingVerifier("timing_layer_id") }
+    }};
+    Documentation anonymousDoc {{
+        { DocumentationEntry::Wildcard, new TableVerifier(layerEntries) }
+    }};
+
+    START_TIMER_NO_RESET(tableVerification, logFile, 25);
+    TestResult result = testSpecification(anonymousDoc, dictionary);
+    EXPECT_TRUE(result.success);
+    FINISH_TIMER(tableVerification, logFile);
+
+    START_TIMER_NO_RESET(referencingVerification, logFile, 25);
+    TestResult result = testSpecification(doc, dictionary);
+    EXPECT_TRUE(result.success);
+    FINISH_TIMER(referencingVerification, logFile);
+}
+
+#endif // GHL_TIMING_TESTS
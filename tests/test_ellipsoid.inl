@@ -24,22 +24,289 @@
 
 #include "gtest/gtest.h"
 
-#include <modules/globebrowsing/geodetics/ellipsoid.h>
-#include <thread>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
 
-#define _USE_MATH_DEFINES
-#include <math.h>
-#include <glm/glm.hpp>
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <vector>
 
-class EllipsoidTest : public testing::Test {};
+class EllipsoidTest : public testing::Test {
+protected:
+    // The scalar implementations that preceded the batched conversions, which the
+    // batched results are compared against
 
-using namespace openspace;
+    static Vec3 referenceSurfaceNormal(const openspace::Geodetic2& geodetic2) {
+        Scalar cosLat = cos(geodetic2.lat);
+        return Vec3(
+            cosLat * cos(geodetic2.lon),
+            cosLat * sin(geodetic2.lon),
+            sin(geodetic2.lat)
+        );
+    }
+
+    static Vec3 referencePosition(const openspace::Ellipsoid& ellipsoid,
+        const openspace::Geodetic2& geodetic2, Scalar height)
+    {
+        Vec3 normal = referenceSurfaceNormal(geodetic2);
+        Vec3 k = ellipsoid.radiiSquared() * normal;
+        Scalar gamma = sqrt(glm::dot(k, normal));
+        return k / gamma + height * normal;
+    }
+
+    static openspace::Geodetic2 referenceGeodetic2(const openspace::Ellipsoid& ellipsoid,
+        const Vec3& p)
+    {
+        Vec3 normal = glm::normalize(p * ellipsoid.oneOverRadiiSquared());
+        return openspace::Geodetic2(
+            asin(normal.z / glm::length(normal)),
+            atan2(normal.y, normal.x)
+        );
+    }
+
+    static Vec3 referenceProjection(const openspace::Ellipsoid& ellipsoid,
+        const Vec3& p)
+    {
+        const Vec3& oneOverRadiiSquared = ellipsoid.oneOverRadiiSquared();
+        Scalar beta = 1.0 / sqrt(glm::dot(p * p, oneOverRadiiSquared));
+        Scalar n = glm::length(beta * p * oneOverRadiiSquared);
+        Scalar alpha = (1.0 - beta) * (glm::length(p) / n);
+
+        Vec3 p2 = p * p;
+        Vec3 d, d2, d3;
+        Scalar s = 0.0;
+        Scalar dSdA = 1.0;
+        do {
+            alpha -= (s / dSdA);
+            d = Vec3(1.0) + alpha * oneOverRadiiSquared;
+            d2 = d * d;
+            d3 = d * d2;
+            s = glm::dot(p2 / (ellipsoid.radiiSquared() * d2), Vec3(1.0)) - 1.0;
+            dSdA = -2.0 * glm::dot(p2 / (ellipsoid.radiiToTheFourth() * d3), Vec3(1.0));
+        } while (std::abs(s) > 1e-10);
+        return p / d;
+    }
+
+    // The full latitude range and two turns of longitude, in steps of half a degree
+    static std::vector<openspace::Geodetic2> createGeodeticGrid() {
+        std::vector<openspace::Geodetic2> grid;
+        for (int lat = -180; lat <= 180; ++lat) {
+            for (int lon = -720; lon <= 720; ++lon) {
+                grid.emplace_back(lat * M_PI / 360.0, lon * M_PI / 360.0);
+            }
+        }
+        return grid;
+    }
+
+    // Points outside of the ellipsoid between 1 and 1000 radii from the center
+    static std::vector<Vec3> createPoints(const openspace::Ellipsoid& ellipsoid,
+        size_t n)
+    {
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<Scalar> direction(-1.0, 1.0);
+        std::uniform_real_distribution<Scalar> exponent(0.0, 3.0);
+        std::vector<Vec3> points;
+        while (points.size() < n) {
+            Vec3 p(direction(generator), direction(generator), direction(generator));
+            if (glm::length(p) > 0.0) {
+                Scalar distance = pow(10.0, exponent(generator)) *
+                    ellipsoid.maximumRadius();
+                points.push_back(glm::normalize(p) * distance);
+            }
+        }
+        return points;
+    }
+
+    struct Batch {
+        explicit Batch(size_t n) : x(n), y(n), z(n), lat(n), lon(n), height(n) {}
+
+        std::vector<Scalar> x, y, z;
+        std::vector<Scalar> lat, lon, height;
+    };
+
+    const openspace::Ellipsoid earth = openspace::Ellipsoid(6378137.0, 6378137.0,
+        6356752.314245);
+    const openspace::Ellipsoid mars = openspace::Ellipsoid(3396190.0, 3396190.0,
+        3376200.0);
+};
 
 TEST_F(EllipsoidTest, GeodeticSurfaceNormal) {
-	Ellipsoid ellipsoid(Vec3(1, 1, 1));
+    openspace::Ellipsoid ellipsoid(Vec3(1, 1, 1));
+
+    Vec3 geodeticNormal = ellipsoid.geodeticSurfaceNormal({ M_PI_2, 0.0 });
+    EXPECT_NEAR(0.0, glm::length(geodeticNormal - Vec3(0, 0, 1)), 1e-15);
+}
+
+TEST_F(EllipsoidTest, SurfaceNormal) {
+    std::vector<openspace::Geodetic2> grid = createGeodeticGrid();
+    Batch batch(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) {
+        batch.lat[i] = grid[i].lat;
+        batch.lon[i] = grid[i].lon;
+    }
+    earth.geodeticSurfaceNormal(grid.size(), batch.lat.data(), batch.lon.data(),
+        batch.x.data(), batch.y.data(), batch.z.data());
+
+    for (size_t i = 0; i < grid.size(); ++i) {
+        Vec3 reference = referenceSurfaceNormal(grid[i]);
+        EXPECT_NEAR(reference.x, batch.x[i], 1e-15) << grid[i].lat << ", " << grid[i].lon;
+        EXPECT_NEAR(reference.y, batch.y[i], 1e-15) << grid[i].lat << ", " << grid[i].lon;
+        EXPECT_NEAR(reference.z, batch.z[i], 1e-15) << grid[i].lat << ", " << grid[i].lon;
+    }
+}
+
+TEST_F(EllipsoidTest, CartesianPosition) {
+    std::vector<openspace::Geodetic2> grid = createGeodeticGrid();
+    Batch batch(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) {
+        batch.lat[i] = grid[i].lat;
+        batch.lon[i] = grid[i].lon;
+        batch.height[i] = (i % 7) * 1000.0 - 2000.0;
+    }
+
+    for (const openspace::Ellipsoid& ellipsoid : { earth, mars }) {
+        ellipsoid.cartesianPosition(grid.size(), batch.lat.data(), batch.lon.data(),
+            batch.height.data(), batch.x.data(), batch.y.data(), batch.z.data());
+
+        // Relative to the radius, the error of the trigonometric approximations
+        const Scalar tolerance = 1e-15 * ellipsoid.maximumRadius();
+        for (size_t i = 0; i < grid.size(); ++i) {
+            Vec3 reference = referencePosition(ellipsoid, grid[i], batch.height[i]);
+            EXPECT_NEAR(reference.x, batch.x[i], tolerance) << i;
+            EXPECT_NEAR(reference.y, batch.y[i], tolerance) << i;
+            EXPECT_NEAR(reference.z, batch.z[i], tolerance) << i;
+        }
+    }
+}
+
+TEST_F(EllipsoidTest, CartesianToGeodetic2) {
+    std::vector<openspace::Geodetic2> grid = createGeodeticGrid();
+    Batch batch(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) {
+        Vec3 p = referencePosition(earth, grid[i], 0.0);
+        batch.x[i] = p.x;
+        batch.y[i] = p.y;
+        batch.z[i] = p.z;
+    }
+    earth.cartesianToGeodetic2(grid.size(), batch.x.data(), batch.y.data(),
+        batch.z.data(), batch.lat.data(), batch.lon.data());
 
-	Vec3 geodeticNormal = ellipsoid.geodeticSurfaceNormal(Vec3(0, 0, 1));
-	Vec3 expectedNormal = Vec3(0, 0, 1);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        Vec3 p(batch.x[i], batch.y[i], batch.z[i]);
+        openspace::Geodetic2 reference = referenceGeodetic2(earth, p);
+        // The reference uses asin for the latitude, which loses precision at the poles
+        Scalar latTolerance = std::abs(grid[i].lat) > 1.5 ? 1e-7 : 1e-13;
+        EXPECT_NEAR(reference.lat, batch.lat[i], latTolerance) << i;
+        EXPECT_NEAR(reference.lon, batch.lon[i], 1e-14) << i;
 
-	ASSERT_EQ(geodeticNormal, expectedNormal);
+        // Points on the surface map back to their coordinates, up to the wrapping of
+        // the longitude; the longitude is undefined at the poles
+        EXPECT_NEAR(grid[i].lat, batch.lat[i], 1e-13) << i;
+        if (std::abs(grid[i].lat) < M_PI_2) {
+            Scalar lonDifference = remainder(grid[i].lon - batch.lon[i], 2.0 * M_PI);
+            EXPECT_NEAR(0.0, lonDifference, 1e-13) << i;
+        }
+    }
 }
+
+TEST_F(EllipsoidTest, GeodeticSurfaceProjection) {
+    const openspace::Ellipsoid oblate(1.0, 1.0, 0.5);
+    for (const openspace::Ellipsoid& ellipsoid : { earth, mars, oblate }) {
+        std::vector<Vec3> points = createPoints(ellipsoid, 1000);
+        Batch batch(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            batch.x[i] = points[i].x;
+            batch.y[i] = points[i].y;
+            batch.z[i] = points[i].z;
+        }
+        ellipsoid.geodeticSurfaceProjection(points.size(), batch.x.data(),
+            batch.y.data(), batch.z.data(), batch.x.data(), batch.y.data(),
+            batch.z.data());
+
+        const Scalar tolerance = 1e-9 * ellipsoid.maximumRadius();
+        for (size_t i = 0; i < points.size(); ++i) {
+            Vec3 reference = referenceProjection(ellipsoid, points[i]);
+            EXPECT_NEAR(reference.x, batch.x[i], tolerance) << i;
+            EXPECT_NEAR(reference.y, batch.y[i], tolerance) << i;
+            EXPECT_NEAR(reference.z, batch.z[i], tolerance) << i;
+        }
+    }
+}
+
+TEST_F(EllipsoidTest, ScalarWrappers) {
+    std::vector<Vec3> points = createPoints(earth, 100);
+    for (const Vec3& p : points) {
+        Vec3 projected = earth.geodeticSurfaceProjection(p);
+        openspace::Geodetic2 geodetic = earth.cartesianToGeodetic2(projected);
+        Vec3 position = earth.cartesianSurfacePosition(geodetic);
+        EXPECT_NEAR(0.0, glm::length(position - projected), 1e-6);
+
+        Vec3 elevated = earth.cartesianPosition({ geodetic, 1000.0 });
+        Vec3 normal = earth.geodeticSurfaceNormal(geodetic);
+        EXPECT_NEAR(0.0, glm::length(elevated - (position + 1000.0 * normal)), 1e-6);
+    }
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(EllipsoidTest, TimingTest) {
+    std::ofstream logFile("EllipsoidTest.timing");
+    std::vector<openspace::Geodetic2> grid = createGeodeticGrid();
+    std::vector<Vec3> positions(grid.size());
+    Batch batch(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) {
+        batch.lat[i] = grid[i].lat;
+        batch.lon[i] = grid[i].lon;
+    }
+    Scalar sum = 0.0;
+
+    START_TIMER_NO_RESET(scalarPosition, logFile, 10);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        positions[i] = referencePosition(earth, grid[i], 0.0);
+    }
+    sum += positions.back().x;
+    FINISH_TIMER(scalarPosition, logFile);
+
+    START_TIMER_NO_RESET(batchPosition, logFile, 10);
+    earth.cartesianSurfacePosition(grid.size(), batch.lat.data(), batch.lon.data(),
+        batch.x.data(), batch.y.data(), batch.z.data());
+    sum += batch.x.back();
+    FINISH_TIMER(batchPosition, logFile);
+
+    START_TIMER_NO_RESET(scalarGeodetic, logFile, 10);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        grid[i] = referenceGeodetic2(earth, positions[i]);
+    }
+    sum += grid.back().lat;
+    FINISH_TIMER(scalarGeodetic, logFile);
+
+    START_TIMER_NO_RESET(batchGeodetic, logFile, 10);
+    earth.cartesianToGeodetic2(grid.size(), batch.x.data(), batch.y.data(),
+        batch.z.data(), batch.lat.data(), batch.lon.data());
+    sum += batch.lat.back();
+    FINISH_TIMER(batchGeodetic, logFile);
+
+    std::vector<Vec3> points = createPoints(earth, grid.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        batch.x[i] = points[i].x;
+        batch.y[i] = points[i].y;
+        batch.z[i] = points[i].z;
+    }
+
+    START_TIMER_NO_RESET(scalarProjection, logFile, 10);
+    for (size_t i = 0; i < points.size(); ++i) {
+        positions[i] = referenceProjection(earth, points[i]);
+    }
+    sum += positions.back().x;
+    FINISH_TIMER(scalarProjection, logFile);
+
+    START_TIMER_NO_RESET(batchProjection, logFile, 10);
+    earth.geodeticSurfaceProjection(points.size(), batch.x.data(), batch.y.data(),
+        batch.z.data(), batch.lat.data(), batch.lon.data(), batch.height.data());
+    sum += batch.lat.back();
+    FINISH_TIMER(batchProjection, logFile);
+
+    EXPECT_NE(0.0, sum);
+}
+
+#endif // GHL_TIMING_TESTS
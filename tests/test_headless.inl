@@ -0,0 +1,132 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/chunk/chunkedlodglobe.h>
+#include <modules/globebrowsing/globes/renderableglobe.h>
+
+#include <openspace/engine/configurationmanager.h>
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/wrapper/headlesswindowwrapper.h>
+#include <openspace/query/query.h>
+#include <openspace/util/spicemanager.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+// The engine cannot be deinitialized after OsEng.initialize, so the tests that initialize
+// it run in a child process. Otherwise the scene, the job threads and the tile providers
+// would keep running after TearDown has deinitialized the SpiceManager
+class HeadlessTest : public testing::Test {
+protected:
+    void SetUp() override {
+        openspace::SpiceManager::initialize();
+        openspace::SpiceManager::ref().loadKernel(
+            "${TESTDIR}/SpiceTest/spicekernels/naif0008.tls"
+        );
+    }
+
+    void TearDown() override {
+        openspace::SpiceManager::deinitialize();
+    }
+
+    // Runs the \p test in the child process, which exits without destroying the engine
+    // and reports the failures of the test through its exit code
+    static void runAndExit(void (*test)()) {
+        test();
+        std::fflush(stdout);
+        std::fflush(stderr);
+        std::_Exit(testing::Test::HasFailure() ? 1 : 0);
+    }
+
+    static void globeChunkTreeAdvances();
+};
+
+// Runs frames of the fully initialized engine without an OpenGL context. The scene is
+// only loaded in the first Scene::update, and the tiles that allow the chunk tree to
+// be refined are read asynchronously, so the frames are run until the globe reaches the
+// expected level or the maximum number of frames is exceeded
+void HeadlessTest::globeChunkTreeAdvances() {
+    using namespace openspace;
+
+    const int MaxFrames = 1000;
+    // The dataset has no overviews, so its 1024 pixel wide raster provides tiles of the
+    // minimum size of 16 pixels up to level log2(1024 / 16) = 6. From 100 km above a
+    // globe with a radius of 1000 km, the distance evaluator with the default scale
+    // factor of 10 requests level floor(log2(10 * 1000 / 100)) = 6 below the camera.
+    // The expected level leaves a margin for the tiles that are still being read
+    const int ExpectedLevel = 4;
+    const Geodetic2 BelowCamera(0.0, 0.0);
+
+    HeadlessWindowWrapper* window =
+        dynamic_cast<HeadlessWindowWrapper*>(&OsEng.windowWrapper());
+    ASSERT_NE(nullptr, window) << "The tests have to be run with a headless window";
+
+    OsEng.configurationManager().setValue(
+        ConfigurationManager::KeyConfigScene,
+        absPath("${TESTDIR}/HeadlessTest/headless.scene")
+    );
+    OsEng.setMaster(true);
+    ASSERT_TRUE(OsEng.initialize());
+    ASSERT_TRUE(OsEng.initializeGL());
+
+    EXPECT_EQ(nullptr, sceneGraphNode("HeadlessGlobe"));
+    EXPECT_EQ(1, window->run(1));
+
+    // The node only exists if Scene::update has loaded the scene
+    SceneGraphNode* node = sceneGraphNode("HeadlessGlobe");
+    ASSERT_NE(nullptr, node);
+    RenderableGlobe* globe = dynamic_cast<RenderableGlobe*>(node->renderable());
+    ASSERT_NE(nullptr, globe) << "The globe was not added to the headless scene";
+    EXPECT_TRUE(globe->isReady());
+
+    // The camera of the headless window does not look at the globe
+    ChunkedLodGlobe& chunkedLodGlobe = *globe->chunkedLodGlobe();
+    chunkedLodGlobe.debugOptions.doFrustumCulling = false;
+    chunkedLodGlobe.debugOptions.doHorizonCulling = false;
+
+    const int initialLevel =
+        chunkedLodGlobe.findChunkNode(BelowCamera).getChunk().index().level;
+    int level = initialLevel;
+    for (int i = 0; i < MaxFrames && level < ExpectedLevel; ++i) {
+        window->run(1);
+        level = chunkedLodGlobe.findChunkNode(BelowCamera).getChunk().index().level;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    EXPECT_LT(initialLevel, level);
+    EXPECT_LE(ExpectedLevel, level);
+}
+
+TEST_F(HeadlessTest, GlobeChunkTreeAdvances) {
+    // The child process runs the whole test binary again up to this point instead of
+    // forking the process with its running engine threads
+    testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT(runAndExit(&globeChunkTreeAdvances), testing::ExitedWithCode(0), "");
+}
@@ -0,0 +1,208 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/jobmanager.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+class JobManagerTest : public testing::Test {};
+
+using namespace openspace;
+
+TEST_F(JobManagerTest, ExecutesAllJobs) {
+    JobManager jobManager(4);
+    ASSERT_EQ(4, jobManager.nWorkers());
+
+    std::atomic<int> sum(0);
+    for (int i = 1; i <= 1000; ++i) {
+        jobManager.enqueue([&sum, i]() { sum += i; });
+    }
+    jobManager.waitForIdle();
+
+    EXPECT_EQ(500500, sum);
+
+    JobManager::Statistics stats = jobManager.statistics();
+    EXPECT_EQ(0, stats.nQueuedJobs);
+    EXPECT_EQ(1000, stats.nFinishedJobs);
+    EXPECT_EQ(0, stats.nCancelledJobs);
+}
+
+TEST_F(JobManagerTest, Priorities) {
+    JobManager jobManager(1);
+
+    // Keep the only worker busy until all jobs are enqueued
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    jobManager.enqueue([released]() { released.wait(); });
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&mutex, &order](int value) {
+        return [&mutex, &order, value]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+        };
+    };
+
+    jobManager.enqueue(record(0), JobManager::Priority::Low);
+    jobManager.enqueue(record(1), JobManager::Priority::Normal);
+    jobManager.enqueue(record(2), JobManager::Priority::High);
+    jobManager.enqueue(record(3), JobManager::Priority::Normal);
+
+    release.set_value();
+    jobManager.waitForIdle();
+
+    std::vector<int> expected = { 2, 1, 3, 0 };
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(JobManagerTest, Cancellation) {
+    JobManager jobManager(1);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    jobManager.enqueue([released]() { released.wait(); });
+
+    JobManager::CancellationToken token;
+    std::atomic<int> nExecuted(0);
+    for (int i = 0; i < 10; ++i) {
+        jobManager.enqueue([&nExecuted]() { ++nExecuted; }, JobManager::Priority::Normal, token);
+    }
+    jobManager.enqueue([&nExecuted]() { ++nExecuted; });
+    token.cancel();
+
+    release.set_value();
+    jobManager.waitForIdle();
+
+    EXPECT_EQ(1, nExecuted);
+    JobManager::Statistics stats = jobManager.statistics();
+    EXPECT_EQ(10, stats.nCancelledJobs);
+    EXPECT_EQ(2, stats.nFinishedJobs);
+}
+
+TEST_F(JobManagerTest, ContinuationsRunOnMainThread) {
+    JobManager jobManager(2);
+    const std::thread::id mainThread = std::this_thread::get_id();
+
+    std::vector<int> results;
+    std::vector<std::thread::id> threads;
+    for (int i = 0; i < 8; ++i) {
+        jobManager.enqueueWithContinuation(
+            [i]() { return i * i; },
+            [&results, &threads](int value) {
+                results.push_back(value);
+                threads.push_back(std::this_thread::get_id());
+            }
+        );
+    }
+    jobManager.waitForIdle();
+
+    // Nothing is executed until the main thread drains the queue
+    EXPECT_TRUE(results.empty());
+    EXPECT_EQ(8, jobManager.statistics().nQueuedContinuations);
+
+    EXPECT_EQ(8, jobManager.drainMainThreadQueue());
+    ASSERT_EQ(8, results.size());
+    int sum = 0;
+    for (int i = 0; i < 8; ++i) {
+        sum += results[i];
+        EXPECT_EQ(mainThread, threads[i]);
+    }
+    EXPECT_EQ(140, sum);
+    EXPECT_EQ(0, jobManager.drainMainThreadQueue());
+}
+
+TEST_F(JobManagerTest, CancelledContinuationsAreDiscarded) {
+    JobManager jobManager(2);
+
+    JobManager::CancellationToken token;
+    bool continuationExecuted = false;
+    jobManager.enqueueWithContinuation(
+        []() { return 42; },
+        [&continuationExecuted](int) { continuationExecuted = true; },
+        JobManager::Priority::Normal,
+        token
+    );
+    jobManager.waitForIdle();
+    token.cancel();
+
+    EXPECT_EQ(0, jobManager.drainMainThreadQueue());
+    EXPECT_FALSE(continuationExecuted);
+}
+
+TEST_F(JobManagerTest, DrainBudget) {
+    JobManager jobManager(1);
+
+    int nExecuted = 0;
+    for (int i = 0; i < 3; ++i) {
+        jobManager.enqueueOnMainThread([&nExecuted]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            ++nExecuted;
+        });
+    }
+
+    // A budget that is immediately exceeded still executes one continuation per call
+    EXPECT_EQ(1, jobManager.drainMainThreadQueue(std::chrono::microseconds(1)));
+    EXPECT_EQ(1, nExecuted);
+    EXPECT_EQ(2, jobManager.drainMainThreadQueue());
+    EXPECT_EQ(3, nExecuted);
+}
+
+TEST_F(JobManagerTest, NestedJobsAreStolen) {
+    JobManager jobManager(4);
+
+    // A single job fans out into many jobs in its own worker's queue, which the other
+    // workers have to steal to participate
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> nExecuted(0);
+    jobManager.enqueue([&]() {
+        for (int i = 0; i < 400; ++i) {
+            jobManager.enqueue([&]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                ++nExecuted;
+            });
+        }
+    });
+    jobManager.waitForIdle();
+
+    EXPECT_EQ(400, nExecuted);
+    EXPECT_GT(threads.size(), 1);
+
+    JobManager::Statistics stats = jobManager.statistics();
+    EXPECT_GT(stats.utilization, 0.0);
+    EXPECT_LE(stats.utilization, 1.0);
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/interaction/luaconsole.h>
+
+#include <cctype>
+
+class LuaConsoleTest : public testing::Test {
+protected:
+    // Sends a key press followed by the character it produces, like the window does
+    void typeCharacter(char c) {
+        // The Key values of letters are their upper case ASCII codes
+        console.keyboardCallback(
+            openspace::Key(std::toupper(c)),
+            openspace::KeyModifier::NoModifier,
+            openspace::KeyAction::Press
+        );
+        console.charCallback(
+            static_cast<unsigned int>(c),
+            openspace::KeyModifier::NoModifier
+        );
+    }
+
+    void pressKey(openspace::Key key,
+                  openspace::KeyModifier modifier = openspace::KeyModifier::NoModifier)
+    {
+        console.keyboardCallback(key, modifier, openspace::KeyAction::Press);
+    }
+
+    openspace::LuaConsole console;
+};
+
+TEST_F(LuaConsoleTest, HistorySearchExtendsQuery) {
+    pressKey(openspace::Key::R, openspace::KeyModifier::Control);
+    typeCharacter('a');
+    typeCharacter('b');
+    EXPECT_EQ("ab", console.historySearchQuery());
+
+    // Modifier keys and repeated searches keep the query
+    pressKey(openspace::Key::LeftShift);
+    pressKey(openspace::Key::R, openspace::KeyModifier::Control);
+    EXPECT_EQ("ab", console.historySearchQuery());
+
+    pressKey(openspace::Key::BackSpace);
+    EXPECT_EQ("a", console.historySearchQuery());
+
+    pressKey(openspace::Key::Escape);
+    EXPECT_EQ("", console.historySearchQuery());
+}
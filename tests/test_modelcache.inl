@@ -0,0 +1,316 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/base/rendering/modelcache.h>
+#include <modules/base/rendering/wavefrontgeometry.h>
+
+#include <openspace/util/powerscaledcoordinate.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <tiny_obj_loader.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+class ModelCacheTest : public testing::Test {
+protected:
+    using ModelCache = openspace::modelgeometry::ModelCache;
+
+    ModelCacheTest()
+        : _objPath(absPath("${TEMPORARY}/modelcachetest.obj"))
+        , _cachePath(absPath("${TEMPORARY}/modelcachetest.cache"))
+    {}
+
+    ~ModelCacheTest() {
+        std::remove(_objPath.c_str());
+        std::remove(_cachePath.c_str());
+    }
+
+    // Writes a sphere with texture coordinates and normals as a Wavefront file
+    void writeSphere(int nLongitudes, int nLatitudes, double radius = 1.0) {
+        const double Pi = 3.14159265358979323846;
+        std::ofstream file(_objPath);
+        for (int lat = 0; lat <= nLatitudes; ++lat) {
+            for (int lon = 0; lon <= nLongitudes; ++lon) {
+                double u = static_cast<double>(lon) / nLongitudes;
+                double v = static_cast<double>(lat) / nLatitudes;
+                double theta = v * Pi;
+                double phi = u * 2.0 * Pi;
+                double x = std::sin(theta) * std::cos(phi);
+                double y = std::sin(theta) * std::sin(phi);
+                double z = std::cos(theta);
+                file << "v " << radius * x << ' ' << radius * y << ' ' <<
+                    radius * z << '\n';
+                file << "vt " << u << ' ' << v << '\n';
+                file << "vn " << x << ' ' << y << ' ' << z << '\n';
+            }
+        }
+        for (int lat = 0; lat < nLatitudes; ++lat) {
+            for (int lon = 0; lon < nLongitudes; ++lon) {
+                int a = lat * (nLongitudes + 1) + lon + 1;
+                int b = a + 1;
+                int c = a + nLongitudes + 1;
+                int d = c + 1;
+                file << "f " << a << '/' << a << '/' << a << ' ' << c << '/' << c <<
+                    '/' << c << ' ' << b << '/' << b << '/' << b << '\n';
+                file << "f " << b << '/' << b << '/' << b << ' ' << c << '/' << c <<
+                    '/' << c << ' ' << d << '/' << d << '/' << d << '\n';
+            }
+        }
+    }
+
+    std::vector<tinyobj::shape_t> loadShapes() {
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string err;
+        bool success = tinyobj::LoadObj(
+            shapes,
+            materials,
+            err,
+            _objPath.c_str(),
+            _objPath.c_str()
+        );
+        EXPECT_TRUE(success) << err;
+        EXPECT_EQ(1, shapes.size());
+        return shapes;
+    }
+
+    // Loads the Wavefront file in the same way as the model geometry does
+    ModelCache::Mesh loadMesh() {
+        ModelCache::Mesh mesh;
+        bool success = openspace::modelgeometry::WavefrontGeometry::loadModel(
+            _objPath,
+            mesh
+        );
+        EXPECT_TRUE(success);
+        return mesh;
+    }
+
+    // The rendered position of the power-scaled vertex location
+    static glm::dvec3 position(const ModelCache::Vertex& v) {
+        return openspace::PowerScaledCoordinate(
+            v.location[0], v.location[1], v.location[2], v.location[3]
+        ).dvec3();
+    }
+
+    // Compares the decoded vertices against the original tinyobj output
+    static void expectSameGeometry(const tinyobj::shape_t& shape,
+                                   const ModelCache::Mesh& decoded,
+                                   float texTolerance, float normalTolerance)
+    {
+        const tinyobj::mesh_t& m = shape.mesh;
+        ASSERT_EQ(m.positions.size() / 3, decoded.vertices.size());
+        for (size_t i = 0; i < decoded.vertices.size(); ++i) {
+            const ModelCache::Vertex& v = decoded.vertices[i];
+            glm::dvec3 p = position(v);
+            for (int c = 0; c < 3; ++c) {
+                EXPECT_NEAR(m.positions[3 * i + c], p[c], 1e-5);
+                EXPECT_NEAR(m.normals[3 * i + c], v.normal[c], normalTolerance);
+            }
+            for (int c = 0; c < 2; ++c) {
+                EXPECT_NEAR(m.texcoords[2 * i + c], v.tex[c], texTolerance);
+            }
+        }
+        ASSERT_EQ(m.indices.size(), decoded.indices.size());
+        for (size_t i = 0; i < decoded.indices.size(); ++i) {
+            EXPECT_EQ(static_cast<int>(m.indices[i]), decoded.indices[i]);
+        }
+    }
+
+    std::string _objPath;
+    std::string _cachePath;
+};
+
+TEST_F(ModelCacheTest, RoundTripMatchesObj) {
+    writeSphere(16, 8);
+    std::vector<tinyobj::shape_t> shapes = loadShapes();
+
+    std::unique_ptr<ModelCache> created = ModelCache::create(
+        loadMesh(),
+        ModelCache::VertexFormat::Full
+    );
+    ASSERT_NE(nullptr, created);
+    ASSERT_TRUE(created->save(_cachePath, _objPath));
+
+    std::unique_ptr<ModelCache> cache = ModelCache::open(_cachePath, _objPath);
+    ASSERT_NE(nullptr, cache);
+    EXPECT_EQ(ModelCache::VertexFormat::Full, cache->vertexFormat());
+    EXPECT_NEAR(1.f, cache->boundingRadius(), 1e-5f);
+
+    float radius = 0.f;
+    EXPECT_TRUE(ModelCache::readBoundingRadius(_cachePath, radius));
+    EXPECT_EQ(cache->boundingRadius(), radius);
+
+    expectSameGeometry(shapes[0], cache->decode(0), 0.f, 0.f);
+}
+
+TEST_F(ModelCacheTest, CompressedRoundTripMatchesObj) {
+    writeSphere(16, 8);
+    std::vector<tinyobj::shape_t> shapes = loadShapes();
+
+    std::unique_ptr<ModelCache> created = ModelCache::create(
+        loadMesh(),
+        ModelCache::VertexFormat::Compressed
+    );
+    ASSERT_NE(nullptr, created);
+    EXPECT_EQ(sizeof(ModelCache::CompressedVertex), created->vertexSize());
+    ASSERT_TRUE(created->save(_cachePath, _objPath));
+
+    std::unique_ptr<ModelCache> cache = ModelCache::open(_cachePath, _objPath);
+    ASSERT_NE(nullptr, cache);
+    EXPECT_EQ(ModelCache::VertexFormat::Compressed, cache->vertexFormat());
+
+    // Half floats have 11 significant bits, normalized shorts a step size of 1/32767
+    expectSameGeometry(shapes[0], cache->decode(0), 1e-3f, 1e-4f);
+}
+
+TEST_F(ModelCacheTest, GeneratesLevelsOfDetail) {
+    writeSphere(256, 128);
+    ModelCache::Mesh mesh = loadMesh();
+
+    std::unique_ptr<ModelCache> cache = ModelCache::create(
+        mesh,
+        ModelCache::VertexFormat::Full
+    );
+    ASSERT_NE(nullptr, cache);
+    EXPECT_TRUE(cache->hasGeneratedLods());
+
+    const std::vector<ModelCache::Lod>& lods = cache->lods();
+    ASSERT_GT(lods.size(), 2);
+    EXPECT_EQ(mesh.indices.size(), lods[0].nIndices);
+    for (size_t i = 1; i < lods.size(); ++i) {
+        EXPECT_LT(lods[i].nIndices, lods[i - 1].nIndices);
+        EXPECT_LT(lods[i].maxScreenSize, lods[i - 1].maxScreenSize);
+        EXPECT_EQ(0, lods[i].nIndices % 3);
+
+        // The simplified levels must still resemble a sphere
+        ModelCache::Mesh level = cache->decode(i);
+        for (const ModelCache::Vertex& v : level.vertices) {
+            EXPECT_NEAR(1.0, glm::length(position(v)), 1e-5);
+        }
+    }
+
+    // Larger screen sizes never select a coarser level
+    EXPECT_EQ(0, cache->selectLod(1.f));
+    EXPECT_EQ(lods.size() - 1, cache->selectLod(0.f));
+    size_t previous = lods.size() - 1;
+    for (float size = 0.f; size < 1.f; size += 0.001f) {
+        size_t lod = cache->selectLod(size);
+        EXPECT_LE(lod, previous);
+        previous = lod;
+    }
+
+    std::unique_ptr<ModelCache> single = ModelCache::create(
+        mesh,
+        ModelCache::VertexFormat::Full,
+        false
+    );
+    ASSERT_NE(nullptr, single);
+    EXPECT_FALSE(single->hasGeneratedLods());
+    EXPECT_EQ(1, single->lods().size());
+}
+
+TEST_F(ModelCacheTest, SimplifiesMixedPowerScaledExponents) {
+    // The loader stores coordinates of at least 9.5 with the exponent 2 and all others
+    // with the exponent 1, so this sphere mixes both within the same mesh
+    const double Radius = 10.0;
+    writeSphere(128, 64, Radius);
+    ModelCache::Mesh mesh = loadMesh();
+    bool hasMixedExponents = false;
+    for (const ModelCache::Vertex& v : mesh.vertices) {
+        hasMixedExponents |= (v.location[3] != mesh.vertices[0].location[3]);
+    }
+    ASSERT_TRUE(hasMixedExponents);
+
+    std::unique_ptr<ModelCache> cache = ModelCache::create(
+        mesh,
+        ModelCache::VertexFormat::Full
+    );
+    ASSERT_NE(nullptr, cache);
+    EXPECT_NEAR(Radius, cache->boundingRadius(), 1e-4);
+
+    const std::vector<ModelCache::Lod>& lods = cache->lods();
+    ASSERT_GT(lods.size(), 2);
+    // The diagonals of the original quads are the longest edges with a length of
+    // sqrt(2) * 2 * pi * Radius / 128
+    const double OriginalEdge = 0.7;
+    for (size_t i = 1; i < lods.size(); ++i) {
+        // Every simplified level was clustered on a grid with this spacing
+        const double cellSize = 2.0 * Radius / (lods[i].maxScreenSize / 0.002);
+        const double MaxEdge = 2.0 * std::sqrt(3.0) * cellSize + OriginalEdge;
+
+        ModelCache::Mesh level = cache->decode(i);
+        for (size_t j = 0; j < level.indices.size(); j += 3) {
+            for (int k = 0; k < 3; ++k) {
+                glm::dvec3 a = position(level.vertices[level.indices[j + k]]);
+                glm::dvec3 b = position(level.vertices[level.indices[j + (k + 1) % 3]]);
+                EXPECT_NEAR(Radius, glm::length(a), 1e-4);
+                EXPECT_LE(glm::distance(a, b), MaxEdge);
+            }
+        }
+    }
+}
+
+TEST_F(ModelCacheTest, RejectsInvalidCaches) {
+    writeSphere(16, 8);
+    std::unique_ptr<ModelCache> created = ModelCache::create(
+        loadMesh(),
+        ModelCache::VertexFormat::Full
+    );
+    ASSERT_NE(nullptr, created);
+
+    EXPECT_EQ(nullptr, ModelCache::open(_cachePath, _objPath));
+
+    // A different version
+    ASSERT_TRUE(created->save(_cachePath, _objPath));
+    {
+        std::fstream file(_cachePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(uint32_t));
+        uint32_t version = ModelCache::CurrentVersion + 1;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+    }
+    EXPECT_EQ(nullptr, ModelCache::open(_cachePath, _objPath));
+
+    // A truncated file
+    ASSERT_TRUE(created->save(_cachePath, _objPath));
+    {
+        std::ifstream in(_cachePath, std::ifstream::binary);
+        std::vector<char> content((std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(_cachePath, std::ofstream::binary);
+        out.write(content.data(), content.size() / 2);
+    }
+    EXPECT_EQ(nullptr, ModelCache::open(_cachePath, _objPath));
+
+    // A changed source file
+    ASSERT_TRUE(created->save(_cachePath, _objPath));
+    ASSERT_NE(nullptr, ModelCache::open(_cachePath, _objPath));
+    writeSphere(32, 16);
+    EXPECT_EQ(nullptr, ModelCache::open(_cachePath, _objPath));
+}
@@ -0,0 +1,369 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/engine/moduleengine.h>
+#include <openspace/engine/startuptimeline.h>
+#include <openspace/util/jobmanager.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class ModuleEngineTest : public testing::Test {
+protected:
+    struct Event {
+        std::string module;
+        bool isPreparation;
+        std::thread::id thread;
+    };
+
+    class EventLog {
+    public:
+        void add(std::string module, bool isPreparation) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _events.push_back(
+                { std::move(module), isPreparation, std::this_thread::get_id() }
+            );
+        }
+
+        std::vector<Event> events() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _events;
+        }
+
+        // Returns the position of the event or -1 if it did not happen
+        int index(const std::string& module, bool isPreparation) const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = std::find_if(
+                _events.begin(),
+                _events.end(),
+                [&](const Event& e) {
+                    return e.module == module && e.isPreparation == isPreparation;
+                }
+            );
+            return it == _events.end() ? -1 : static_cast<int>(it - _events.begin());
+        }
+
+    private:
+        mutable std::mutex _mutex;
+        std::vector<Event> _events;
+    };
+
+    class StubModule : public openspace::OpenSpaceModule {
+    public:
+        StubModule(std::string name, std::vector<std::string> required,
+                   EventLog& log, std::function<void()> onPrepare)
+            : openspace::OpenSpaceModule(std::move(name))
+            , _required(std::move(required))
+            , _log(log)
+            , _onPrepare(std::move(onPrepare))
+        {}
+
+        std::vector<std::string> requiredModules() const override {
+            return _required;
+        }
+
+    protected:
+        void internalPrepare() override {
+            if (_onPrepare) {
+                _onPrepare();
+            }
+            _log.add(name(), true);
+        }
+
+        void internalInitialize() override {
+            _log.add(name(), false);
+        }
+
+    private:
+        std::vector<std::string> _required;
+        EventLog& _log;
+        std::function<void()> _onPrepare;
+    };
+
+    ModuleEngineTest()
+        : _jobManager(2)
+        , _modulesPath(absPath("${MODULES}"))
+    {
+        // The stub modules need a directory to register their path tokens
+        FileSys.registerPathToken(
+            "${MODULES}",
+            absPath("${TEMPORARY}/moduleenginetest"),
+            ghoul::filesystem::FileSystem::Override::Yes
+        );
+    }
+
+    ~ModuleEngineTest() {
+        FileSys.registerPathToken(
+            "${MODULES}",
+            _modulesPath,
+            ghoul::filesystem::FileSystem::Override::Yes
+        );
+    }
+
+    std::unique_ptr<openspace::OpenSpaceModule> createModule(std::string name,
+        std::vector<std::string> required, std::function<void()> onPrepare = {})
+    {
+        std::string directory = name;
+        std::transform(directory.begin(), directory.end(), directory.begin(), tolower);
+        FileSys.createDirectory(
+            absPath("${MODULES}/" + directory),
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+
+        return std::make_unique<StubModule>(
+            std::move(name),
+            std::move(required),
+            _log,
+            std::move(onPrepare)
+        );
+    }
+
+    openspace::JobManager _jobManager;
+    EventLog _log;
+    std::string _modulesPath;
+};
+
+TEST_F(ModuleEngineTest, DependencyOrder) {
+    using namespace openspace;
+
+    // The modules are passed in the reverse order of their dependencies
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule("OrderD", { "OrderB", "OrderC" }));
+    modules.push_back(createModule("OrderC", { "OrderA" }));
+    modules.push_back(createModule("OrderB", { "OrderA" }));
+    modules.push_back(createModule("OrderA", {}));
+    modules.push_back(createModule("OrderE", {}));
+
+    ModuleEngine engine;
+    engine.registerModules(std::move(modules), _jobManager);
+
+    const std::vector<std::pair<std::string, std::string>> dependencies = {
+        { "OrderB", "OrderA" },
+        { "OrderC", "OrderA" },
+        { "OrderD", "OrderB" },
+        { "OrderD", "OrderC" }
+    };
+    for (const std::pair<std::string, std::string>& d : dependencies) {
+        // A module is only prepared after its requirement has been initialized
+        EXPECT_LT(_log.index(d.second, false), _log.index(d.first, true))
+            << d.first << " depends on " << d.second;
+    }
+
+    for (const std::string& name : { "OrderA", "OrderB", "OrderC", "OrderD", "OrderE" }) {
+        ASSERT_NE(-1, _log.index(name, true)) << name;
+        ASSERT_NE(-1, _log.index(name, false)) << name;
+        EXPECT_LT(_log.index(name, true), _log.index(name, false)) << name;
+    }
+
+    // All initializations happen on the calling thread
+    for (const Event& e : _log.events()) {
+        if (!e.isPreparation) {
+            EXPECT_EQ(std::this_thread::get_id(), e.thread) << e.module;
+        }
+    }
+
+    // The modules are returned in the order of their initialization
+    std::vector<std::string> names;
+    for (OpenSpaceModule* m : engine.modules()) {
+        names.push_back(m->name());
+    }
+    ASSERT_EQ(5, names.size());
+    // Of the modules whose requirements are initialized, the earliest passed one is
+    // initialized first
+    EXPECT_EQ(
+        std::vector<std::string>({ "OrderA", "OrderC", "OrderB", "OrderD", "OrderE" }),
+        names
+    );
+    auto position = [&names](const std::string& name) {
+        return std::find(names.begin(), names.end(), name) - names.begin();
+    };
+    for (const std::pair<std::string, std::string>& d : dependencies) {
+        EXPECT_LT(position(d.second), position(d.first));
+    }
+}
+
+TEST_F(ModuleEngineTest, ConcurrentPreparation) {
+    using namespace openspace;
+
+    // Each preparation waits until the other one has started as well, which is only
+    // possible if both are executed concurrently
+    std::atomic<int> nStarted(0);
+    std::atomic<int> nConcurrent(0);
+    auto prepare = [&nStarted, &nConcurrent]() {
+        ++nStarted;
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (nStarted < 2 && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::yield();
+        }
+        if (nStarted == 2) {
+            ++nConcurrent;
+        }
+    };
+
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule("ParallelA", {}, prepare));
+    modules.push_back(createModule("ParallelB", {}, prepare));
+
+    StartupTimeline timeline;
+    ModuleEngine engine;
+    engine.registerModules(std::move(modules), _jobManager, &timeline);
+
+    EXPECT_EQ(2, nConcurrent);
+
+    // Both modules have recorded their preparation and initialization
+    std::vector<StartupTimeline::Entry> entries = timeline.entries();
+    EXPECT_EQ(4, entries.size());
+    for (const StartupTimeline::Entry& e : entries) {
+        if (e.category == "Module Preparation") {
+            EXPECT_FALSE(e.isMainThread) << e.name;
+        }
+        else {
+            EXPECT_EQ("Module Initialization", e.category) << e.name;
+            EXPECT_TRUE(e.isMainThread) << e.name;
+        }
+    }
+}
+
+TEST_F(ModuleEngineTest, InitializationOrderIndependentOfPreparation) {
+    using namespace openspace;
+
+    // The preparation of the first module only finishes after the second module has
+    // been prepared, but the first module still has to be initialized first
+    std::atomic<bool> isSecondPrepared(false);
+    auto waitForSecond = [&isSecondPrepared]() {
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!isSecondPrepared && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::yield();
+        }
+    };
+
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule("SlowA", {}, waitForSecond));
+    modules.push_back(createModule(
+        "FastB",
+        {},
+        [&isSecondPrepared]() { isSecondPrepared = true; }
+    ));
+    modules.push_back(createModule("FastC", { "FastB" }));
+
+    ModuleEngine engine;
+    engine.registerModules(std::move(modules), _jobManager);
+
+    EXPECT_TRUE(isSecondPrepared);
+    EXPECT_LT(_log.index("FastB", true), _log.index("SlowA", true));
+    EXPECT_LT(_log.index("SlowA", false), _log.index("FastB", false));
+    EXPECT_LT(_log.index("FastB", false), _log.index("FastC", false));
+
+    std::vector<std::string> names;
+    for (OpenSpaceModule* m : engine.modules()) {
+        names.push_back(m->name());
+    }
+    EXPECT_EQ(std::vector<std::string>({ "SlowA", "FastB", "FastC" }), names);
+}
+
+TEST_F(ModuleEngineTest, PreviouslyRegisteredRequirement) {
+    using namespace openspace;
+
+    ModuleEngine engine;
+    engine.registerModule(createModule("EarlierA", {}));
+
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule("EarlierB", { "EarlierA" }));
+    engine.registerModules(std::move(modules), _jobManager);
+
+    EXPECT_EQ(2, engine.modules().size());
+    EXPECT_LT(_log.index("EarlierA", false), _log.index("EarlierB", true));
+}
+
+TEST_F(ModuleEngineTest, MissingRequirement) {
+    using namespace openspace;
+
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule("MissingA", { "MissingDoesNotExist" }));
+    modules.push_back(createModule("MissingB", {}));
+
+    ModuleEngine engine;
+    EXPECT_THROW(
+        engine.registerModules(std::move(modules), _jobManager),
+        ghoul::RuntimeError
+    );
+
+    // No module must have been touched
+    EXPECT_TRUE(_log.events().empty());
+    EXPECT_TRUE(engine.modules().empty());
+
+    EXPECT_THROW(
+        engine.registerModule(createModule("MissingC", { "MissingDoesNotExist" })),
+        ghoul::RuntimeError
+    );
+}
+
+TEST_F(ModuleEngineTest, CyclicRequirement) {
+    using namespace openspace;
+
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule("CycleA", { "CycleC" }));
+    modules.push_back(createModule("CycleB", { "CycleA" }));
+    modules.push_back(createModule("CycleC", { "CycleB" }));
+    modules.push_back(createModule("CycleD", {}));
+
+    ModuleEngine engine;
+    EXPECT_THROW(
+        engine.registerModules(std::move(modules), _jobManager),
+        ghoul::RuntimeError
+    );
+    EXPECT_TRUE(_log.events().empty());
+    EXPECT_TRUE(engine.modules().empty());
+}
+
+TEST_F(ModuleEngineTest, FailedPreparation) {
+    using namespace openspace;
+
+    std::vector<std::unique_ptr<OpenSpaceModule>> modules;
+    modules.push_back(createModule(
+        "FailingA",
+        {},
+        []() { throw ghoul::RuntimeError("Preparation failed", "FailingA"); }
+    ));
+    modules.push_back(createModule("FailingB", { "FailingA" }));
+
+    ModuleEngine engine;
+    EXPECT_THROW(
+        engine.registerModules(std::move(modules), _jobManager),
+        ghoul::RuntimeError
+    );
+
+    // A module that depends on a failed module is never prepared
+    EXPECT_EQ(-1, _log.index("FailingA", false));
+    EXPECT_EQ(-1, _log.index("FailingB", true));
+    EXPECT_TRUE(engine.modules().empty());
+}
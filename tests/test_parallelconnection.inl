@@ -0,0 +1,534 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/network/messagebuffer.h>
+#include <openspace/network/messagestructures.h>
+#include <openspace/network/parallelconnection.h>
+#include <openspace/network/sendqueue.h>
+#include <openspace/network/socket.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalarproperty.h>
+#include <openspace/properties/stringproperty.h>
+#include <openspace/properties/vectorproperty.h>
+#include <openspace/scene/scene.h>
+#include <openspace/scripting/scriptengine.h>
+#include <openspace/util/syncbuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ParallelConnectionTest : public testing::Test {
+protected:
+    // Properties of the types that are sent in binary form and of one type that is sent
+    // as a string
+    struct TestProperties : public openspace::properties::PropertyOwner {
+        TestProperties()
+            : boolValue("bool", "Bool")
+            , intValue("int", "Int")
+            , uintValue("uint", "UInt")
+            , floatValue("float", "Float")
+            , doubleValue("double", "Double")
+            , vec3Value("vec3", "Vec3")
+            , dvec3Value("dvec3", "DVec3")
+            , stringValue("string", "String")
+        {
+            setName("ParallelConnectionTest");
+            addProperty(boolValue);
+            addProperty(intValue);
+            addProperty(uintValue);
+            addProperty(floatValue);
+            addProperty(doubleValue);
+            addProperty(vec3Value);
+            addProperty(dvec3Value);
+            addProperty(stringValue);
+        }
+
+        openspace::properties::BoolProperty boolValue;
+        openspace::properties::IntProperty intValue;
+        openspace::properties::UIntProperty uintValue;
+        openspace::properties::FloatProperty floatValue;
+        openspace::properties::DoubleProperty doubleValue;
+        openspace::properties::Vec3Property vec3Value;
+        openspace::properties::DVec3Property dvec3Value;
+        openspace::properties::StringProperty stringValue;
+    };
+
+    // Makes the properties of the owner reachable through their URIs while it exists
+    struct RegisteredOwner {
+        RegisteredOwner(openspace::properties::PropertyOwner& owner) : _owner(owner) {
+            OsEng.globalPropertyOwner().addPropertySubOwner(_owner);
+        }
+        ~RegisteredOwner() {
+            OsEng.globalPropertyOwner().removePropertySubOwner(_owner);
+        }
+        openspace::properties::PropertyOwner& _owner;
+    };
+
+    // Creates two connected TCP sockets on the loopback interface
+    static void createLoopbackPair(_SOCKET& host, _SOCKET& client) {
+        ASSERT_TRUE(openspace::network::initializeSocketApi());
+
+        _SOCKET listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        ASSERT_NE(INVALID_SOCKET, listener);
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        ASSERT_NE(
+            SOCKET_ERROR,
+            bind(listener, reinterpret_cast<sockaddr*>(&address), length)
+        );
+        ASSERT_NE(SOCKET_ERROR, listen(listener, 1));
+        ASSERT_NE(
+            SOCKET_ERROR,
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length)
+        );
+
+        client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        ASSERT_NE(INVALID_SOCKET, client);
+        ASSERT_NE(
+            SOCKET_ERROR,
+            connect(client, reinterpret_cast<sockaddr*>(&address), length)
+        );
+        host = accept(listener, nullptr, nullptr);
+        ASSERT_NE(INVALID_SOCKET, host);
+
+        openspace::network::closeSocket(listener);
+    }
+
+    // Creates a data message of \p type containing \p data
+    template <typename T>
+    static std::vector<char> dataMessage(uint16_t type, const T& data) {
+        std::vector<char> buffer;
+        size_t lengthOffset = openspace::network::beginDataMessage(buffer, type);
+        data.serialize(buffer);
+        openspace::network::finishDataMessage(buffer, lengthOffset);
+        return buffer;
+    }
+
+    // Reads the data message that dataMessage has created from the \p buffer
+    static bool readDataMessage(const std::vector<char>& buffer, uint16_t& type,
+                                std::vector<char>& payload)
+    {
+        using namespace openspace::network;
+
+        uint32_t messageType;
+        if (buffer.size() < MessageHeaderSize ||
+            !readMessageHeader(buffer.data(), messageType) ||
+            messageType != MessageTypes::Data)
+        {
+            return false;
+        }
+
+        MessageReader reader(
+            buffer.data() + MessageHeaderSize,
+            buffer.size() - MessageHeaderSize
+        );
+        uint16_t length;
+        reader.decode(type);
+        reader.decode(length);
+        payload.resize(length);
+        reader.decode(payload.data(), length);
+        return reader.good() && reader.remaining() == 0;
+    }
+
+    // Receives the next data message from the \p socket, like the ParallelConnection
+    static bool receiveDataMessage(_SOCKET socket, uint16_t& type,
+                                   std::vector<char>& payload)
+    {
+        using namespace openspace::network;
+
+        std::vector<char> buffer(MessageHeaderSize + DataMessageHeaderSize);
+        if (receiveAll(socket, buffer.data(), buffer.size()) <= 0) {
+            return false;
+        }
+
+        uint16_t length;
+        std::memcpy(&length, buffer.data() + buffer.size() - sizeof(uint16_t), 2);
+        buffer.resize(buffer.size() + length);
+        if (length > 0 &&
+            receiveAll(socket, buffer.data() + buffer.size() - length, length) <= 0)
+        {
+            return false;
+        }
+        return readDataMessage(buffer, type, payload);
+    }
+};
+
+TEST_F(ParallelConnectionTest, DataMessageFraming) {
+    using namespace openspace::network;
+    using namespace openspace::network::datamessagestructures;
+
+    PositionKeyframe kf;
+    kf._position = openspace::psc(1.f, 2.f, 3.f, 4.f);
+    kf._viewRotationQuat = glm::quat(0.5f, 0.5f, 0.5f, 0.5f);
+    kf._timeStamp = 12.5;
+
+    std::vector<char> buffer = dataMessage(PositionData, kf);
+
+    // The layout is unchanged from the messages the parallel server already relays
+    const size_t payloadSize = sizeof(glm::vec4) + sizeof(glm::quat) + sizeof(double);
+    ASSERT_EQ(MessageHeaderSize + DataMessageHeaderSize + payloadSize, buffer.size());
+    EXPECT_EQ('O', buffer[0]);
+    EXPECT_EQ('S', buffer[1]);
+
+    uint16_t type;
+    std::vector<char> payload;
+    ASSERT_TRUE(readDataMessage(buffer, type, payload));
+    EXPECT_EQ(PositionData, type);
+    ASSERT_EQ(payloadSize, payload.size());
+
+    PositionKeyframe result;
+    ASSERT_TRUE(result.deserialize(payload));
+    EXPECT_EQ(kf._position.vec4(), result._position.vec4());
+    EXPECT_EQ(kf._viewRotationQuat, result._viewRotationQuat);
+    EXPECT_EQ(kf._timeStamp, result._timeStamp);
+}
+
+TEST_F(ParallelConnectionTest, TruncatedMessage) {
+    using namespace openspace::network::datamessagestructures;
+
+    TimeKeyframe tf;
+    tf._time = 1.0;
+    tf._dt = 2.0;
+    tf._paused = false;
+    tf._requiresTimeJump = true;
+
+    std::vector<char> buffer;
+    tf.serialize(buffer);
+    buffer.pop_back();
+
+    TimeKeyframe result;
+    EXPECT_FALSE(result.deserialize(buffer));
+
+    ScriptMessage sm;
+    sm._script = "openspace.setPropertyValue('a', 1);";
+    buffer.clear();
+    sm.serialize(buffer);
+    buffer.resize(buffer.size() - 5);
+
+    ScriptMessage smResult;
+    EXPECT_FALSE(smResult.deserialize(buffer));
+}
+
+TEST_F(ParallelConnectionTest, PropertyMessages) {
+    using namespace openspace::network::datamessagestructures;
+
+    PropertyIdentifier pi;
+    pi._id = 7;
+    pi._uri = "Earth.renderable.enabled";
+
+    std::vector<char> buffer;
+    pi.serialize(buffer);
+    PropertyIdentifier piResult;
+    ASSERT_TRUE(piResult.deserialize(buffer));
+    EXPECT_EQ(pi._id, piResult._id);
+    EXPECT_EQ(pi._uri, piResult._uri);
+
+    const glm::vec3 value(1.f, 2.f, 3.f);
+    PropertyValue pv;
+    pv._id = 7;
+    pv._type = PropertyValue::Type::Vec3;
+    pv._value.resize(sizeof(value));
+    std::memcpy(pv._value.data(), &value, sizeof(value));
+
+    buffer.clear();
+    pv.serialize(buffer);
+
+    // The id, the type, and the raw bytes of the value
+    EXPECT_EQ(sizeof(uint32_t) + sizeof(uint8_t) + sizeof(glm::vec3), buffer.size());
+
+    PropertyValue pvResult;
+    ASSERT_TRUE(pvResult.deserialize(buffer));
+    EXPECT_EQ(pv._id, pvResult._id);
+    EXPECT_EQ(pv._type, pvResult._type);
+    EXPECT_EQ(pv._value, pvResult._value);
+
+    // Types that are unknown to this version are rejected
+    buffer[sizeof(uint32_t)] = static_cast<char>(PropertyValue::Type::LuaString) + 1;
+    EXPECT_FALSE(pvResult.deserialize(buffer));
+}
+
+TEST_F(ParallelConnectionTest, SendQueueKeepsOrderWhileGrowing) {
+    openspace::network::SendQueue queue(4);
+    queue.open();
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue.push(std::vector<char>(i % 50 + 1, static_cast<char>(i))));
+    }
+    ASSERT_EQ(1000, queue.size());
+
+    std::vector<char> message;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue.pop(message));
+        ASSERT_EQ(i % 50 + 1, message.size());
+        EXPECT_EQ(static_cast<char>(i), message.front());
+    }
+    EXPECT_EQ(0, queue.size());
+}
+
+TEST_F(ParallelConnectionTest, SendQueueCoalescing) {
+    using openspace::network::SendQueue;
+
+    SendQueue queue;
+    queue.open();
+
+    // Consecutive messages with the same key replace each other
+    queue.push({ 1 }, 1);
+    queue.push({ 2 }, 1);
+    queue.push({ 3 }, 1);
+    EXPECT_EQ(1, queue.size());
+
+    // Messages with another key in between are kept
+    queue.push({ 4 }, 2);
+    queue.push({ 5 }, 1);
+    EXPECT_EQ(3, queue.size());
+
+    // Messages without a key are never coalesced
+    queue.push({ 6 });
+    queue.push({ 7 });
+    EXPECT_EQ(5, queue.size());
+
+    std::vector<char> message;
+    for (char expected : { 3, 4, 5, 6, 7 }) {
+        ASSERT_TRUE(queue.pop(message));
+        EXPECT_EQ(std::vector<char>{ expected }, message);
+    }
+
+    // A message that has been popped is not replaced
+    queue.push({ 8 }, 1);
+    ASSERT_TRUE(queue.pop(message));
+    queue.push({ 9 }, 1);
+    EXPECT_EQ(1, queue.size());
+}
+
+TEST_F(ParallelConnectionTest, SendQueueClose) {
+    openspace::network::SendQueue queue;
+
+    // A queue that has not been opened drops messages
+    EXPECT_FALSE(queue.push({ 1 }));
+    EXPECT_EQ(0, queue.size());
+
+    queue.open();
+    queue.push({ 1 });
+    std::vector<char> message;
+    ASSERT_TRUE(queue.pop(message));
+
+    // Closing the queue wakes the waiting sender
+    std::thread sender([&queue]() {
+        std::vector<char> m;
+        while (queue.pop(m)) {}
+    });
+    queue.push({ 2 });
+    queue.close();
+    sender.join();
+
+    EXPECT_EQ(0, queue.size());
+    EXPECT_FALSE(queue.push({ 3 }));
+}
+
+TEST_F(ParallelConnectionTest, Loopback) {
+    using namespace openspace::network;
+    using namespace openspace::network::datamessagestructures;
+    using openspace::scripting::ScriptEngine;
+
+    _SOCKET hostSocket = INVALID_SOCKET;
+    _SOCKET clientSocket = INVALID_SOCKET;
+    createLoopbackPair(hostSocket, clientSocket);
+    ASSERT_NE(INVALID_SOCKET, hostSocket);
+    ASSERT_NE(INVALID_SOCKET, clientSocket);
+
+    // The client's properties are found through the global property owner, like all
+    // properties that are set by the scripts of a parallel session
+    TestProperties hostProperties;
+    TestProperties clientProperties;
+    RegisteredOwner registered(clientProperties);
+    const std::string Prefix = clientProperties.name() + ".";
+
+    const int NumberOfKeyframes = 500;
+    const uint32_t KeyframeKey = 1;
+    const uint32_t ValueKey = 16;
+
+    // Host: the queue is drained by a send thread like in the ParallelConnection
+    SendQueue queue;
+    queue.open();
+    std::thread sender([&queue, hostSocket]() {
+        std::vector<char> message;
+        while (queue.pop(message)) {
+            if (sendAll(hostSocket, message.data(), message.size()) == SOCKET_ERROR) {
+                break;
+            }
+        }
+    });
+
+    // Cluster: the master selects the received scripts and synchronizes them to a slave
+    ScriptEngine master;
+    ScriptEngine slave;
+    for (ScriptEngine* engine : { &master, &slave }) {
+        engine->addLibrary(openspace::Scene::luaLibrary());
+        engine->initialize();
+    }
+
+    // Client: queues the received values and scripts on the master like the
+    // ParallelConnection does
+    std::vector<double> timeStamps;
+    std::map<uint32_t, std::string> uris;
+    int nScripts = 0;
+    bool isFinished = false;
+    std::thread receiver([&]() {
+        uint16_t type;
+        std::vector<char> payload;
+        while (receiveDataMessage(clientSocket, type, payload)) {
+            if (type == PositionData) {
+                PositionKeyframe kf;
+                ASSERT_TRUE(kf.deserialize(payload));
+                timeStamps.push_back(kf._timeStamp);
+            }
+            else if (type == PropertyIdentifierData) {
+                PropertyIdentifier pi;
+                ASSERT_TRUE(pi.deserialize(payload));
+                uris[pi._id] = pi._uri;
+            }
+            else if (type == PropertyValueData) {
+                PropertyValue pv;
+                ASSERT_TRUE(pv.deserialize(payload));
+                ASSERT_EQ(1, uris.count(pv._id));
+                std::string script =
+                    ParallelConnection::scriptFromPropertyValue(uris[pv._id], pv);
+                ASSERT_FALSE(script.empty());
+                master.queueScript(script);
+                ++nScripts;
+            }
+            else if (type == ScriptData) {
+                ScriptMessage sm;
+                ASSERT_TRUE(sm.deserialize(payload));
+                if (sm._script == "end") {
+                    isFinished = true;
+                    return;
+                }
+                master.queueScript(sm._script);
+                ++nScripts;
+            }
+        }
+    });
+
+    for (int i = 0; i < NumberOfKeyframes; ++i) {
+        PositionKeyframe kf;
+        kf._position = openspace::psc(float(i), 0.f, 0.f, 0.f);
+        kf._timeStamp = i;
+        queue.push(dataMessage(PositionData, kf), KeyframeKey);
+    }
+
+    hostProperties.boolValue = true;
+    hostProperties.intValue = -7;
+    hostProperties.uintValue = 42;
+    hostProperties.floatValue = 0.1f;
+    hostProperties.doubleValue = 1.0 / 3.0;
+    hostProperties.dvec3Value = glm::dvec3(1e-300, -2.5, 6.02214076e23);
+    hostProperties.stringValue = std::string("a \"quoted\"\\ line\nand another");
+
+    std::vector<openspace::properties::Property*> properties =
+        hostProperties.properties();
+    for (size_t id = 0; id < properties.size(); ++id) {
+        PropertyIdentifier pi;
+        pi._id = static_cast<uint32_t>(id);
+        pi._uri = Prefix + properties[id]->identifier();
+        queue.push(dataMessage(PropertyIdentifierData, pi));
+
+        PropertyValue pv;
+        ParallelConnection::encodePropertyValue(*properties[id], pv);
+        pv._id = pi._id;
+        queue.push(dataMessage(PropertyValueData, pv), ValueKey + pv._id);
+    }
+
+    // A script that is received between two values of a property is applied in between
+    ScriptMessage script;
+    script._script =
+        "openspace.setPropertyValueSingle(\"" + Prefix + "float\", 5);";
+    queue.push(dataMessage(ScriptData, script));
+
+    for (int i = 0; i < 100; ++i) {
+        hostProperties.vec3Value = glm::vec3(float(i), float(i + 1), float(i + 2));
+        PropertyValue pv;
+        ParallelConnection::encodePropertyValue(hostProperties.vec3Value, pv);
+        pv._id = static_cast<uint32_t>(std::distance(
+            properties.begin(),
+            std::find(properties.begin(), properties.end(), &hostProperties.vec3Value)
+        ));
+        queue.push(dataMessage(PropertyValueData, pv), ValueKey + pv._id);
+    }
+
+    ScriptMessage end;
+    end._script = "end";
+    queue.push(dataMessage(ScriptData, end));
+
+    receiver.join();
+    queue.close();
+    sender.join();
+    closeSocket(hostSocket);
+    closeSocket(clientSocket);
+
+    ASSERT_TRUE(isFinished);
+
+    // Keyframes may have been coalesced, but arrive in order and the newest one arrives
+    ASSERT_FALSE(timeStamps.empty());
+    EXPECT_LE(timeStamps.size(), NumberOfKeyframes);
+    EXPECT_TRUE(std::is_sorted(timeStamps.begin(), timeStamps.end()));
+    EXPECT_EQ(NumberOfKeyframes - 1, timeStamps.back());
+
+    // One script per frame is synchronized and only the slave runs it, so every value
+    // that has been applied has been received by the other nodes of the cluster
+    for (int i = 0; i < nScripts; ++i) {
+        openspace::SyncBuffer buffer(4096);
+        master.presync(true);
+        const std::string synced = master.currentSyncedScript();
+        ASSERT_FALSE(synced.empty());
+        master.encode(&buffer);
+        slave.decode(&buffer);
+        EXPECT_EQ(synced, slave.currentSyncedScript());
+        slave.postsync(false);
+    }
+
+    EXPECT_EQ(hostProperties.boolValue.value(), clientProperties.boolValue.value());
+    EXPECT_EQ(hostProperties.intValue.value(), clientProperties.intValue.value());
+    EXPECT_EQ(hostProperties.uintValue.value(), clientProperties.uintValue.value());
+    EXPECT_EQ(5.f, clientProperties.floatValue.value()) << "Scripts keep their order";
+    EXPECT_EQ(hostProperties.doubleValue.value(), clientProperties.doubleValue.value());
+    EXPECT_EQ(hostProperties.vec3Value.value(), clientProperties.vec3Value.value());
+    EXPECT_EQ(hostProperties.dvec3Value.value(), clientProperties.dvec3Value.value());
+    EXPECT_EQ(hostProperties.stringValue.value(), clientProperties.stringValue.value());
+
+    master.deinitialize();
+    slave.deinitialize();
+}
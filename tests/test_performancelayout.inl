@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/performance/performancelayout.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <vector>
+
+class PerformanceLayoutTest : public testing::Test {
+protected:
+    using Series = openspace::performance::PerformanceLayout::Series;
+
+    PerformanceLayoutTest()
+        : _layout(std::make_unique<openspace::performance::PerformanceLayout>())
+    {}
+
+    // The PerformanceLayout is too large to be put on the stack
+    std::unique_ptr<openspace::performance::PerformanceLayout> _layout;
+};
+
+TEST_F(PerformanceLayoutTest, EmptySeries) {
+    const Series& s = _layout->frameTime;
+    EXPECT_EQ(0, s.nValues());
+    EXPECT_EQ(0.f, s.latest());
+    EXPECT_EQ(0.f, s.minimum());
+    EXPECT_EQ(0.f, s.maximum());
+    EXPECT_EQ(0.f, s.average());
+    EXPECT_EQ(0.f, s.percentile(99.f));
+}
+
+TEST_F(PerformanceLayoutTest, PartialWindow) {
+    Series& s = _layout->frameTime;
+    for (int i = 1; i <= 100; ++i) {
+        s.addValue(static_cast<float>(101 - i));
+    }
+
+    EXPECT_EQ(100, s.nValues());
+    EXPECT_EQ(1.f, s.latest());
+    EXPECT_EQ(100.f, s.value(99));
+    EXPECT_EQ(1.f, s.minimum());
+    EXPECT_EQ(100.f, s.maximum());
+    EXPECT_FLOAT_EQ(50.5f, s.average());
+    EXPECT_EQ(50.f, s.percentile(50.f));
+    EXPECT_EQ(95.f, s.percentile(95.f));
+    EXPECT_EQ(99.f, s.percentile(99.f));
+    EXPECT_EQ(1.f, s.percentile(0.f));
+    EXPECT_EQ(100.f, s.percentile(100.f));
+}
+
+TEST_F(PerformanceLayoutTest, SlidingWindowMatchesRecomputation) {
+    using PerformanceLayout = openspace::performance::PerformanceLayout;
+    Series& s = _layout->frameTime;
+
+    std::mt19937 generator(1337);
+    std::lognormal_distribution<float> distribution(7.f, 0.5f);
+
+    std::vector<float> samples;
+    for (int i = 0; i < 10 * PerformanceLayout::NumberValues + 17; ++i) {
+        const float value = distribution(generator);
+        samples.push_back(value);
+        s.addValue(value);
+
+        const size_t n = std::min<size_t>(
+            samples.size(),
+            PerformanceLayout::NumberValues
+        );
+        std::vector<float> window(samples.end() - n, samples.end());
+        std::vector<float> sorted = window;
+        std::sort(sorted.begin(), sorted.end());
+        const double sum = std::accumulate(window.begin(), window.end(), 0.0);
+
+        ASSERT_EQ(static_cast<int>(n), s.nValues());
+        ASSERT_EQ(value, s.latest());
+        ASSERT_EQ(window.front(), s.value(static_cast<int>(n) - 1));
+        ASSERT_EQ(sorted.front(), s.minimum());
+        ASSERT_EQ(sorted.back(), s.maximum());
+        ASSERT_NEAR(sum / n, s.average(), 1e-2);
+
+        const size_t rank95 = static_cast<size_t>(std::ceil(0.95 * n));
+        const size_t rank99 = static_cast<size_t>(std::ceil(0.99 * n));
+        ASSERT_EQ(sorted[rank95 - 1], s.percentile(95.f));
+        ASSERT_EQ(sorted[rank99 - 1], s.percentile(99.f));
+    }
+}
+
+TEST_F(PerformanceLayoutTest, Histogram) {
+    Series& s = _layout->frameTime;
+    for (int i = 0; i < 40; ++i) {
+        s.addValue(static_cast<float>(i % 4));
+    }
+
+    std::array<float, 4> bins;
+    s.histogram(bins.data(), static_cast<int>(bins.size()));
+    EXPECT_EQ(10.f, bins[0]);
+    EXPECT_EQ(10.f, bins[1]);
+    EXPECT_EQ(10.f, bins[2]);
+    EXPECT_EQ(10.f, bins[3]);
+
+    // A constant series puts all values into the first bin
+    Series& constant = _layout->functionEntries[0].time;
+    constant.addValue(5.f);
+    constant.addValue(5.f);
+    constant.histogram(bins.data(), static_cast<int>(bins.size()));
+    EXPECT_EQ(2.f, bins[0]);
+    EXPECT_EQ(0.f, bins[3]);
+}
+
+TEST_F(PerformanceLayoutTest, WriteCsv) {
+    _layout->frameTime.addValue(1.f);
+    _layout->frameTime.addValue(2.f);
+    _layout->frameTime.addValue(3.f);
+
+    _layout->nFunctionEntries = 1;
+    std::strcpy(_layout->functionEntries[0].name, "Say \"cheese\"");
+    _layout->functionEntries[0].time.addValue(4.f);
+
+    std::stringstream stream;
+    _layout->writeCsv(stream);
+
+    EXPECT_EQ(
+        "\"Frame time\",\"Say \"\"cheese\"\"\"\n"
+        "1,\n"
+        "2,\n"
+        "3,4\n",
+        stream.str()
+    );
+}
@@ -0,0 +1,189 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include "gtest/gtest.h"
+
+#include <openspace/util/prefixindex.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    // Creates nLibraries * nFunctions names that look like the Lua functions of the
+    // ScriptEngine, e.g. "openspace.library12.Function345"
+    std::vector<std::string> createSymbols(int nLibraries, int nFunctions) {
+        std::vector<std::string> symbols;
+        for (int i = 0; i < nLibraries; ++i) {
+            for (int j = 0; j < nFunctions; ++j) {
+                symbols.push_back(
+                    "openspace.library" + std::to_string(i) +
+                    ".Function" + std::to_string(j)
+                );
+            }
+        }
+        return symbols;
+    }
+
+    // The linear search that the LuaConsole used before the PrefixIndex
+    std::vector<std::string> linearMatches(const std::vector<std::string>& symbols,
+                                           const std::string& prefix)
+    {
+        auto lower = [](std::string s) {
+            std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+            return s;
+        };
+
+        std::vector<std::string> result;
+        for (const std::string& s : symbols) {
+            if (lower(s.substr(0, prefix.size())) == lower(prefix))
+                result.push_back(s);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::string> indexMatches(const openspace::PrefixIndex& index,
+                                          const std::string& prefix)
+    {
+        openspace::PrefixIndex::Range range = index.matches(prefix);
+        std::vector<std::string> result;
+        for (size_t i = range.first; i < range.second; ++i)
+            result.push_back(index[i]);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+} // namespace
+
+class PrefixIndexTest : public testing::Test {};
+
+TEST_F(PrefixIndexTest, EmptyIndex) {
+    openspace::PrefixIndex index;
+    EXPECT_TRUE(index.empty());
+
+    openspace::PrefixIndex::Range range = index.matches("openspace.");
+    EXPECT_EQ(range.first, range.second);
+
+    range = index.matches("");
+    EXPECT_EQ(range.first, range.second);
+}
+
+TEST_F(PrefixIndexTest, CaseInsensitiveMatches) {
+    openspace::PrefixIndex index({
+        "openspace.setPropertyValue",
+        "openspace.setPropertyValueSingle",
+        "openspace.time.setTime",
+        "openspace.SetDeltaTime",
+        "openspace.printInfo"
+    });
+    ASSERT_EQ(5, index.size());
+
+    std::vector<std::string> expected = {
+        "openspace.SetDeltaTime",
+        "openspace.setPropertyValue",
+        "openspace.setPropertyValueSingle"
+    };
+    EXPECT_EQ(expected, indexMatches(index, "openspace.set"));
+    EXPECT_EQ(expected, indexMatches(index, "OPENSPACE.SET"));
+
+    EXPECT_EQ(
+        std::vector<std::string>{ "openspace.time.setTime" },
+        indexMatches(index, "openspace.time.")
+    );
+    EXPECT_TRUE(indexMatches(index, "openspace.x").empty());
+    EXPECT_TRUE(indexMatches(index, "openspace.printInfo2").empty());
+
+    // The empty prefix matches everything
+    openspace::PrefixIndex::Range range = index.matches("");
+    EXPECT_EQ(0, range.first);
+    EXPECT_EQ(index.size(), range.second);
+}
+
+TEST_F(PrefixIndexTest, MatchesAreSortedAndUnique) {
+    openspace::PrefixIndex index({ "b.c", "a.b", "A.a", "a.b", "a.B" });
+    ASSERT_EQ(4, index.size());
+    EXPECT_EQ("A.a", index[0]);
+    EXPECT_EQ("a.B", index[1]);
+    EXPECT_EQ("a.b", index[2]);
+    EXPECT_EQ("b.c", index[3]);
+
+    openspace::PrefixIndex::Range range = index.matches("a.b");
+    EXPECT_EQ(1, range.first);
+    EXPECT_EQ(3, range.second);
+
+    // Setting new entries replaces the old ones
+    index.set({ "c" });
+    ASSERT_EQ(1, index.size());
+    range = index.matches("a");
+    EXPECT_EQ(range.first, range.second);
+}
+
+TEST_F(PrefixIndexTest, TenThousandSymbols) {
+    std::vector<std::string> symbols = createSymbols(100, 100);
+    openspace::PrefixIndex index(symbols);
+    ASSERT_EQ(10000, index.size());
+
+    const std::vector<std::string> prefixes = {
+        "",
+        "o",
+        "openspace.",
+        "openspace.library1",
+        "openspace.LIBRARY42.",
+        "openspace.library99.function9",
+        "openspace.library5.Function55",
+        "openspace.library100",
+        "library"
+    };
+    for (const std::string& prefix : prefixes)
+        EXPECT_EQ(linearMatches(symbols, prefix), indexMatches(index, prefix)) << prefix;
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(PrefixIndexTest, TimingTest) {
+    std::ofstream logFile("PrefixIndexTest.timing");
+    std::vector<std::string> symbols = createSymbols(100, 100);
+
+    START_TIMER_NO_RESET(buildIndex, logFile, 25);
+    openspace::PrefixIndex index(symbols);
+    FINISH_TIMER(buildIndex, logFile);
+
+    openspace::PrefixIndex index(symbols);
+    size_t nMatches = 0;
+    START_TIMER_NO_RESET(indexLookup, logFile, 10000);
+    std::string prefix = "openspace.library" + std::to_string(indexLookupNum % 100);
+    openspace::PrefixIndex::Range range = index.matches(prefix);
+    nMatches += range.second - range.first;
+    FINISH_TIMER(indexLookup, logFile);
+
+    START_TIMER_NO_RESET(linearLookup, logFile, 100);
+    std::string prefix = "openspace.library" + std::to_string(linearLookupNum % 100);
+    nMatches += linearMatches(symbols, prefix).size();
+    FINISH_TIMER(linearLookup, logFile);
+
+    EXPECT_GT(nMatches, 0);
+}
+
+#endif // GHL_TIMING_TESTS
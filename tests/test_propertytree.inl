@@ -0,0 +1,226 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include "gtest/gtest.h"
+
+#include <modules/onscreengui/include/propertytree.h>
+
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalarproperty.h>
+#include <openspace/properties/stringproperty.h>
+
+#include <fstream>
+#include <memory>
+
+namespace {
+    using namespace openspace::properties;
+
+    // A PropertyOwner with grouped and ungrouped Propertys, similar to a globe layer
+    class TestLayer : public PropertyOwner {
+    public:
+        TestLayer(const std::string& name, int nPropertiesPerGroup) {
+            setName(name);
+            for (int i = 0; i < nPropertiesPerGroup; ++i) {
+                std::string n = std::to_string(i);
+                _floats.push_back(std::make_unique<FloatProperty>(
+                    "Gamma" + n, "Gamma " + n, 1.f, 0.f, 10.f
+                ));
+                _floats.back()->setGroupIdentifier("Color");
+                addProperty(_floats.back().get());
+
+                _bools.push_back(std::make_unique<BoolProperty>(
+                    "Flag" + n, "Flag " + n, false
+                ));
+                _bools.back()->setGroupIdentifier("Settings");
+                addProperty(_bools.back().get());
+            }
+            _enabled = std::make_unique<BoolProperty>("Enabled", "Enabled", true);
+            addProperty(_enabled.get());
+            _path = std::make_unique<StringProperty>("FilePath", "File Path", "");
+            addProperty(_path.get());
+        }
+
+    private:
+        std::vector<std::unique_ptr<FloatProperty>> _floats;
+        std::vector<std::unique_ptr<BoolProperty>> _bools;
+        std::unique_ptr<BoolProperty> _enabled;
+        std::unique_ptr<StringProperty> _path;
+    };
+}
+
+class PropertyTreeTest : public testing::Test {
+protected:
+    void createLayers(int nLayers, int nPropertiesPerGroup) {
+        _root.setName("Globe");
+        for (int i = 0; i < nLayers; ++i) {
+            _layers.push_back(std::make_unique<TestLayer>(
+                "Layer" + std::to_string(i),
+                nPropertiesPerGroup
+            ));
+            _root.addPropertySubOwner(_layers.back().get());
+        }
+    }
+
+    openspace::properties::PropertyOwner _root;
+    std::vector<std::unique_ptr<TestLayer>> _layers;
+};
+
+TEST_F(PropertyTreeTest, Structure) {
+    using Node = openspace::gui::PropertyTree::Node;
+    createLayers(3, 2);
+
+    openspace::gui::PropertyTree tree;
+    EXPECT_TRUE(tree.update({ &_root }));
+
+    // Root + 3 * (layer + 2 groups + 2 * 2 grouped properties + 2 ungrouped properties)
+    const std::vector<Node>& nodes = tree.nodes();
+    ASSERT_EQ(1 + 3 * (1 + 2 + 4 + 2), nodes.size());
+    EXPECT_EQ(Node::Type::Owner, nodes[0].type);
+    EXPECT_EQ(static_cast<int>(nodes.size()), nodes[0].end);
+
+    // The first layer follows the root; its groups are sorted by name
+    EXPECT_EQ("Layer0", nodes[1].name);
+    EXPECT_FALSE(nodes[1].isInlined);
+    EXPECT_EQ(10, nodes[1].end);
+    EXPECT_EQ(Node::Type::Group, nodes[2].type);
+    EXPECT_EQ("Color", nodes[2].name);
+    EXPECT_EQ(5, nodes[2].end);
+    EXPECT_EQ(Node::Type::Property, nodes[3].type);
+    EXPECT_EQ(openspace::gui::PropertyTree::PropertyType::Float, nodes[3].propertyType);
+    EXPECT_EQ(_layers[0].get(), nodes[3].owner);
+    EXPECT_EQ("Settings", nodes[5].name);
+    EXPECT_EQ(openspace::gui::PropertyTree::PropertyType::Bool, nodes[6].propertyType);
+    EXPECT_EQ(openspace::gui::PropertyTree::PropertyType::String, nodes[9].propertyType);
+    EXPECT_EQ("Layer1", nodes[10].name);
+
+    EXPECT_EQ(3 * 6, tree.nIncludedProperties());
+}
+
+TEST_F(PropertyTreeTest, RebuildOnlyOnStructuralChange) {
+    createLayers(2, 1);
+
+    openspace::gui::PropertyTree tree;
+    EXPECT_TRUE(tree.update({ &_root }));
+    EXPECT_FALSE(tree.update({ &_root }));
+    size_t nNodes = tree.nodes().size();
+
+    // Changing the value of a Property does not invalidate the tree
+    _root.property("Layer0.Enabled")->set(false);
+    EXPECT_FALSE(tree.update({ &_root }));
+
+    openspace::properties::FloatProperty extra("Extra", "Extra", 0.f, 0.f, 1.f);
+    _layers[1]->addProperty(extra);
+    EXPECT_TRUE(tree.update({ &_root }));
+    EXPECT_EQ(nNodes + 1, tree.nodes().size());
+    EXPECT_FALSE(tree.update({ &_root }));
+
+    _layers[1]->removeProperty(extra);
+    EXPECT_TRUE(tree.update({ &_root }));
+    EXPECT_EQ(nNodes, tree.nodes().size());
+
+    _root.removePropertySubOwner(_layers[1].get());
+    EXPECT_TRUE(tree.update({ &_root }));
+    EXPECT_GT(nNodes, tree.nodes().size());
+
+    // A different list of owners invalidates the tree as well
+    EXPECT_TRUE(tree.update({ _layers[0].get() }));
+    EXPECT_EQ(1 + 1 + 1 + 1 + 1 + 2, tree.nodes().size());
+}
+
+TEST_F(PropertyTreeTest, Filter) {
+    using Node = openspace::gui::PropertyTree::Node;
+    createLayers(12, 2);
+
+    openspace::gui::PropertyTree tree;
+    tree.update({ &_root });
+    const std::vector<Node>& nodes = tree.nodes();
+    const int nPropertiesPerLayer = 6;
+
+    // Owner names include their whole subtree: Layer1, Layer10, Layer11
+    tree.setFilter("LAYER1");
+    EXPECT_EQ(3 * nPropertiesPerLayer, tree.nIncludedProperties());
+    EXPECT_TRUE(tree.isIncluded(0));
+
+    // Property names only include the matching Propertys and their ancestors
+    tree.setFilter("file path");
+    EXPECT_EQ(12, tree.nIncludedProperties());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].type == Node::Type::Group) {
+            EXPECT_FALSE(tree.isIncluded(static_cast<int>(i)));
+        }
+        if (nodes[i].type == Node::Type::Owner) {
+            EXPECT_TRUE(tree.isIncluded(static_cast<int>(i)));
+        }
+    }
+
+    // Fully qualified identifiers are searched as well
+    tree.setFilter("Layer11.Gamma1");
+    EXPECT_EQ(1, tree.nIncludedProperties());
+
+    // Group names include all Propertys of the group
+    tree.setFilter("settings");
+    EXPECT_EQ(12 * 2, tree.nIncludedProperties());
+
+    tree.setFilter("does not exist");
+    EXPECT_EQ(0, tree.nIncludedProperties());
+    EXPECT_FALSE(tree.isIncluded(0));
+
+    // The filter survives a rebuild of the tree
+    openspace::properties::BoolProperty extra("DoesNotExist", "does not exist", false);
+    _layers[3]->addProperty(extra);
+    EXPECT_TRUE(tree.update({ &_root }));
+    EXPECT_EQ(1, tree.nIncludedProperties());
+    _layers[3]->removeProperty(extra);
+
+    tree.setFilter("");
+    EXPECT_EQ(12 * nPropertiesPerLayer, tree.nIncludedProperties());
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(PropertyTreeTest, TimingTest) {
+    std::ofstream logFile("PropertyTreeTest.timing");
+    createLayers(300, 10);
+
+    openspace::properties::BoolProperty extra("Extra", "Extra", false);
+    START_TIMER_NO_RESET(buildTree, logFile, 25);
+    // Force a rebuild by changing the structure
+    _layers[0]->addProperty(extra);
+    _layers[0]->removeProperty(extra);
+    openspace::gui::PropertyTree rebuiltTree;
+    rebuiltTree.update({ &_root });
+    FINISH_TIMER(buildTree, logFile);
+
+    openspace::gui::PropertyTree tree;
+    tree.update({ &_root });
+
+    START_TIMER_NO_RESET(cachedUpdate, logFile, 1000);
+    tree.update({ &_root });
+    FINISH_TIMER(cachedUpdate, logFile);
+
+    START_TIMER_NO_RESET(filterTree, logFile, 100);
+    tree.setFilter(filterTreeNum % 2 == 0 ? "gamma" : "layer29");
+    FINISH_TIMER(filterTree, logFile);
+}
+
+#endif // GHL_TIMING_TESTS
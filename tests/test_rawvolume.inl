@@ -0,0 +1,223 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/rawvolumereader.h>
+#include <modules/volume/rawvolumewriter.h>
+#include <modules/volume/brickedrawvolumereader.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+class RawVolumeTest : public testing::Test {
+protected:
+    RawVolumeTest()
+        : _linearPath(absPath("${TEMPORARY}/rawvolumetest_linear.rawvolume"))
+        , _brickedPath(absPath("${TEMPORARY}/rawvolumetest_bricked.rawvolume"))
+    {}
+
+    ~RawVolumeTest() {
+        std::remove(_linearPath.c_str());
+        std::remove(_brickedPath.c_str());
+    }
+
+    static float voxelValue(const glm::ivec3& c) {
+        return static_cast<float>(c.x + 1000 * c.y + 1000000 * c.z);
+    }
+
+    // Writes the same volume to the linear and the bricked path
+    std::unique_ptr<openspace::RawVolume<float>> writeVolumes(const glm::ivec3& dims,
+                                                              int brickSize)
+    {
+        auto volume = std::make_unique<openspace::RawVolume<float>>(dims);
+        for (int z = 0; z < dims.z; ++z) {
+            for (int y = 0; y < dims.y; ++y) {
+                for (int x = 0; x < dims.x; ++x) {
+                    volume->set(glm::ivec3(x, y, z), voxelValue(glm::ivec3(x, y, z)));
+                }
+            }
+        }
+
+        openspace::RawVolumeWriter<float> linearWriter(_linearPath);
+        linearWriter.setDimensions(dims);
+        linearWriter.write(*volume);
+
+        openspace::RawVolumeWriter<float> brickedWriter(_brickedPath);
+        brickedWriter.setDimensions(dims);
+        brickedWriter.writeBricked(*volume, brickSize);
+
+        return volume;
+    }
+
+    std::string _linearPath;
+    std::string _brickedPath;
+};
+
+TEST_F(RawVolumeTest, MappedRandomAccess) {
+    const glm::ivec3 dims(17, 9, 5);
+    writeVolumes(dims, 4);
+
+    openspace::RawVolumeReader<float> reader(_linearPath, dims);
+    EXPECT_EQ(voxelValue(glm::ivec3(0, 0, 0)), reader.get(glm::ivec3(0, 0, 0)));
+    EXPECT_EQ(voxelValue(glm::ivec3(16, 8, 4)), reader.get(glm::ivec3(16, 8, 4)));
+    EXPECT_EQ(voxelValue(glm::ivec3(3, 7, 2)), reader.get(glm::ivec3(3, 7, 2)));
+    EXPECT_EQ(voxelValue(glm::ivec3(1, 0, 0)), reader.get(1));
+
+    std::unique_ptr<openspace::RawVolume<float>> full = reader.read();
+    std::unique_ptr<openspace::MappedRawVolume<float>> mapped = reader.map();
+    ASSERT_EQ(full->dimensions(), mapped->dimensions());
+    for (size_t i = 0; i < static_cast<size_t>(dims.x * dims.y * dims.z); ++i) {
+        ASSERT_EQ(full->get(i), mapped->get(i)) << "Index " << i;
+    }
+}
+
+TEST_F(RawVolumeTest, BrickedLayout) {
+    // Dimensions that are not multiples of the brick size exercise the padding
+    const glm::ivec3 dims(17, 9, 5);
+    auto volume = writeVolumes(dims, 4);
+
+    openspace::BrickedRawVolumeReader<float> reader(_brickedPath);
+    ASSERT_EQ(dims, reader.dimensions(0));
+    // 17x9x5 -> 9x5x3 -> 5x3x2 -> 3x2x1, which fits in a single brick
+    ASSERT_EQ(4, reader.nLevels());
+    EXPECT_EQ(glm::ivec3(9, 5, 3), reader.dimensions(1));
+    EXPECT_EQ(glm::ivec3(3, 2, 1), reader.dimensions(3));
+
+    for (int z = 0; z < dims.z; ++z) {
+        for (int y = 0; y < dims.y; ++y) {
+            for (int x = 0; x < dims.x; ++x) {
+                const glm::ivec3 c(x, y, z);
+                ASSERT_EQ(voxelValue(c), reader.get(c));
+            }
+        }
+    }
+
+    // A region that straddles brick borders
+    const glm::ivec3 min(3, 2, 1);
+    const glm::ivec3 max(14, 9, 4);
+    std::unique_ptr<openspace::RawVolume<float>> region = reader.readRegion(min, max);
+    ASSERT_EQ(max - min, region->dimensions());
+    for (int z = min.z; z < max.z; ++z) {
+        for (int y = min.y; y < max.y; ++y) {
+            for (int x = min.x; x < max.x; ++x) {
+                const glm::ivec3 c(x, y, z);
+                ASSERT_EQ(voxelValue(c), region->get(c - min));
+            }
+        }
+    }
+
+    // The first downsampled voxel is the average of the first 2x2x2 voxels
+    float expected = 0.f;
+    for (int i = 0; i < 8; ++i) {
+        expected += voxelValue(glm::ivec3(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+    }
+    EXPECT_FLOAT_EQ(expected / 8.f, reader.get(glm::ivec3(0), 1));
+
+    std::unique_ptr<openspace::RawVolume<float>> level = reader.read(1);
+    EXPECT_EQ(reader.get(glm::ivec3(4, 2, 1), 1), level->get(glm::ivec3(4, 2, 1)));
+}
+
+TEST_F(RawVolumeTest, LinearAndBrickedAgree) {
+    const glm::ivec3 dims(48, 48, 48);
+    writeVolumes(dims, 16);
+
+    openspace::RawVolumeReader<float> linearReader(_linearPath, dims);
+    openspace::BrickedRawVolumeReader<float> brickedReader(_brickedPath);
+
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<int> coordinate(0, 47);
+    for (int i = 0; i < 10000; ++i) {
+        const glm::ivec3 c(coordinate(generator), coordinate(generator),
+            coordinate(generator));
+        ASSERT_EQ(linearReader.get(c), brickedReader.get(c)) << "Sample " << i;
+    }
+
+    std::unique_ptr<openspace::RawVolume<float>> linear = linearReader.read();
+    std::unique_ptr<openspace::RawVolume<float>> bricked = brickedReader.read();
+    EXPECT_EQ(linear->get(glm::ivec3(10, 40, 25)), bricked->get(glm::ivec3(10, 40, 25)));
+    EXPECT_EQ(glm::ivec3(12, 12, 12), brickedReader.read(2)->dimensions());
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(RawVolumeTest, TimingTest) {
+    std::ofstream logFile("RawVolumeTest.timing");
+    const glm::ivec3 dims(256, 256, 256);
+    writeVolumes(dims, 32);
+
+    openspace::RawVolumeReader<float> linearReader(_linearPath, dims);
+    openspace::BrickedRawVolumeReader<float> brickedReader(_brickedPath);
+
+    START_TIMER_NO_RESET(linearRead, logFile, 1);
+    linearReader.read();
+    FINISH_TIMER(linearRead, logFile);
+
+    START_TIMER_NO_RESET(brickedRead, logFile, 1);
+    brickedReader.read();
+    FINISH_TIMER(brickedRead, logFile);
+
+    // Random samples in a small neighborhood, like a raycaster would take
+    const int nSamples = 1000000;
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<int> center(16, 239);
+    std::uniform_int_distribution<int> offset(-16, 15);
+    std::vector<glm::ivec3> samples(nSamples);
+    glm::ivec3 c(center(generator), center(generator), center(generator));
+    for (int i = 0; i < nSamples; ++i) {
+        if (i % 1000 == 0) {
+            c = glm::ivec3(center(generator), center(generator), center(generator));
+        }
+        samples[i] = c +
+            glm::ivec3(offset(generator), offset(generator), offset(generator));
+    }
+
+    float linearSum = 0.f;
+    START_TIMER_NO_RESET(linearSamples, logFile, 1);
+    for (const glm::ivec3& s : samples) {
+        linearSum += linearReader.get(s);
+    }
+    FINISH_TIMER(linearSamples, logFile);
+
+    float brickedSum = 0.f;
+    START_TIMER_NO_RESET(brickedSamples, logFile, 1);
+    for (const glm::ivec3& s : samples) {
+        brickedSum += brickedReader.get(s);
+    }
+    FINISH_TIMER(brickedSamples, logFile);
+
+    // Downsampled level, which the linear layout has no equivalent for
+    START_TIMER_NO_RESET(brickedLevel2Read, logFile, 1);
+    brickedReader.read(2);
+    FINISH_TIMER(brickedLevel2Read, logFile);
+
+    EXPECT_EQ(linearSum, brickedSum);
+}
+
+#endif // GHL_TIMING_TESTS
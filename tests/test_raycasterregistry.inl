@@ -0,0 +1,255 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/rendering/raycasterregistry.h>
+#include <openspace/rendering/volumeraycaster.h>
+
+#include <ghoul/misc/dictionary.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    // A raycaster that only provides the paths that determine its type
+    class StubRaycaster : public openspace::VolumeRaycaster {
+    public:
+        StubRaycaster(std::string raycastPath, std::string helperPath = "")
+            : _raycastPath(std::move(raycastPath))
+            , _helperPath(std::move(helperPath))
+        {}
+
+        void renderEntryPoints(const openspace::RenderData&,
+                               ghoul::opengl::ProgramObject&) override {}
+        void renderExitPoints(const openspace::RenderData&,
+                              ghoul::opengl::ProgramObject&) override {}
+
+        std::string getBoundsVsPath() const override { return "bounds.vs"; }
+        std::string getBoundsFsPath() const override { return "bounds.fs"; }
+        std::string getRaycastPath() const override { return _raycastPath; }
+        std::string getHelperPath() const override { return _helperPath; }
+
+    private:
+        std::string _raycastPath;
+        std::string _helperPath;
+    };
+}
+
+class RaycasterRegistryTest : public testing::Test {
+protected:
+    openspace::VolumeRaycaster* create(std::string raycastPath,
+                                       std::string helperPath = "")
+    {
+        _raycasters.push_back(std::make_unique<StubRaycaster>(
+            std::move(raycastPath),
+            std::move(helperPath)
+        ));
+        return _raycasters.back().get();
+    }
+
+    std::vector<std::unique_ptr<openspace::VolumeRaycaster>> _raycasters;
+};
+
+using openspace::RaycasterRegistry;
+using openspace::VolumeRaycaster;
+
+TEST_F(RaycasterRegistryTest, StableSlots) {
+    RaycasterRegistry registry(32, 4);
+
+    VolumeRaycaster* a = create("toy.glsl");
+    VolumeRaycaster* b = create("toy.glsl");
+    VolumeRaycaster* c = create("toy.glsl");
+
+    RaycasterRegistry::Changes changes = registry.update({ a, b, c });
+    EXPECT_EQ(3, changes.added.size());
+    EXPECT_TRUE(changes.removed.empty());
+    EXPECT_TRUE(changes.reservationsChanged);
+    EXPECT_EQ(0, registry.raycastData(a)->id);
+    EXPECT_EQ(1, registry.raycastData(b)->id);
+    EXPECT_EQ(2, registry.raycastData(c)->id);
+    EXPECT_EQ(4, registry.nReservedSlots());
+
+    // Detaching a raycaster keeps the slots of the others
+    changes = registry.update({ a, c });
+    ASSERT_EQ(1, changes.removed.size());
+    EXPECT_EQ(b, changes.removed[0]);
+    EXPECT_TRUE(changes.added.empty());
+    EXPECT_FALSE(changes.reservationsChanged);
+    EXPECT_EQ(nullptr, registry.raycastData(b));
+    EXPECT_EQ(0, registry.raycastData(a)->id);
+    EXPECT_EQ(2, registry.raycastData(c)->id);
+
+    // A new raycaster of the same type reuses the free slot without a rebuild
+    VolumeRaycaster* d = create("toy.glsl");
+    changes = registry.update({ a, c, d });
+    ASSERT_EQ(1, changes.added.size());
+    EXPECT_EQ(d, changes.added[0]);
+    EXPECT_FALSE(changes.reservationsChanged);
+    EXPECT_EQ(1, registry.raycastData(d)->id);
+
+    // Updating with the same list does not change anything
+    changes = registry.update({ a, c, d });
+    EXPECT_TRUE(changes.added.empty());
+    EXPECT_TRUE(changes.removed.empty());
+    EXPECT_FALSE(changes.reservationsChanged);
+}
+
+TEST_F(RaycasterRegistryTest, ReservationGrowth) {
+    RaycasterRegistry registry(32, 4);
+
+    std::vector<VolumeRaycaster*> raycasters;
+    for (int i = 0; i < 4; ++i) {
+        raycasters.push_back(create("toy.glsl"));
+    }
+    EXPECT_TRUE(registry.update(raycasters).reservationsChanged);
+    EXPECT_EQ(4, registry.nReservedSlots());
+
+    // The fifth raycaster of a type exhausts the reservation, which doubles in size
+    raycasters.push_back(create("toy.glsl"));
+    RaycasterRegistry::Changes changes = registry.update(raycasters);
+    EXPECT_TRUE(changes.reservationsChanged);
+    EXPECT_EQ(4, registry.raycastData(raycasters[4])->id);
+    EXPECT_EQ(8, registry.nReservedSlots());
+
+    for (int i = 0; i < 3; ++i) {
+        raycasters.push_back(create("toy.glsl"));
+    }
+    EXPECT_FALSE(registry.update(raycasters).reservationsChanged);
+    EXPECT_EQ(8, registry.nReservedSlots());
+}
+
+TEST_F(RaycasterRegistryTest, Types) {
+    RaycasterRegistry registry(32, 2);
+
+    VolumeRaycaster* toy = create("toy.glsl");
+    VolumeRaycaster* galaxy = create("galaxy.glsl");
+    VolumeRaycaster* multires1 = create("multires.glsl", "helper.glsl");
+    VolumeRaycaster* multires2 = create("multiresother.glsl", "helper.glsl");
+
+    registry.update({ toy, galaxy, multires1, multires2 });
+    EXPECT_EQ(0, registry.raycastData(toy)->id);
+    EXPECT_EQ(2, registry.raycastData(galaxy)->id);
+    EXPECT_EQ(4, registry.raycastData(multires1)->id);
+    EXPECT_EQ(6, registry.raycastData(multires2)->id);
+    EXPECT_EQ(8, registry.nReservedSlots());
+
+    // Raycasters without helper get a namespace of their own, the others share the
+    // namespace of their helper file
+    const std::string toyNamespace = registry.raycastData(toy)->namespaceName;
+    const std::string galaxyNamespace = registry.raycastData(galaxy)->namespaceName;
+    EXPECT_NE(toyNamespace, galaxyNamespace);
+    EXPECT_EQ(
+        registry.raycastData(multires1)->namespaceName,
+        registry.raycastData(multires2)->namespaceName
+    );
+    EXPECT_NE(toyNamespace, registry.raycastData(multires1)->namespaceName);
+
+    // Removing the last raycaster of a type releases its reservation
+    RaycasterRegistry::Changes changes = registry.update({ toy, multires1, multires2 });
+    EXPECT_TRUE(changes.reservationsChanged);
+
+    // A new type reuses the lowest free slots
+    VolumeRaycaster* other = create("other.glsl");
+    registry.update({ toy, multires1, multires2, other });
+    EXPECT_EQ(2, registry.raycastData(other)->id);
+
+    // Replacing the last raycaster of a type by one of the same type in a single update
+    // keeps the reservation
+    VolumeRaycaster* toy2 = create("toy.glsl");
+    changes = registry.update({ toy2, multires1, multires2, other });
+    EXPECT_FALSE(changes.reservationsChanged);
+    EXPECT_EQ(0, registry.raycastData(toy2)->id);
+    EXPECT_EQ(toyNamespace, registry.raycastData(toy2)->namespaceName);
+
+    // Removing everything releases all slots
+    changes = registry.update({});
+    EXPECT_EQ(4, changes.removed.size());
+    EXPECT_TRUE(changes.reservationsChanged);
+    EXPECT_EQ(0, registry.nReservedSlots());
+    EXPECT_TRUE(registry.raycastData().empty());
+}
+
+TEST_F(RaycasterRegistryTest, ExhaustedSlots) {
+    RaycasterRegistry registry(4, 2);
+
+    std::vector<VolumeRaycaster*> raycasters = {
+        create("a.glsl"), create("b.glsl"), create("c.glsl")
+    };
+    RaycasterRegistry::Changes changes = registry.update(raycasters);
+    EXPECT_EQ(2, changes.added.size());
+    EXPECT_EQ(nullptr, registry.raycastData(raycasters[2]));
+
+    // The ignored raycaster gets a slot once another type is detached
+    changes = registry.update({ raycasters[1], raycasters[2] });
+    EXPECT_EQ(1, changes.removed.size());
+    ASSERT_EQ(1, changes.added.size());
+    EXPECT_EQ(raycasters[2], changes.added[0]);
+    EXPECT_EQ(0, registry.raycastData(raycasters[2])->id);
+}
+
+TEST_F(RaycasterRegistryTest, ResolveDictionary) {
+    RaycasterRegistry registry(32, 2);
+
+    ghoul::Dictionary empty = registry.resolveDictionary();
+    EXPECT_FALSE(empty.value<bool>("raycastingEnabled"));
+    EXPECT_EQ(0, empty.value<unsigned long long>("nRaycasters"));
+
+    VolumeRaycaster* toy = create("toy.glsl");
+    VolumeRaycaster* multires = create("multires.glsl", "helper.glsl");
+    VolumeRaycaster* multires2 = create("multiresother.glsl", "helper.glsl");
+    registry.update({ toy, multires, multires2 });
+
+    ghoul::Dictionary dict = registry.resolveDictionary();
+    EXPECT_TRUE(dict.value<bool>("raycastingEnabled"));
+    EXPECT_EQ(6, dict.value<unsigned long long>("nRaycasters"));
+
+    // All reserved slots are part of the dictionary, even the unoccupied ones, so that
+    // attaching another raycaster of the same type does not change it
+    ghoul::Dictionary raycasters = dict.value<ghoul::Dictionary>("raycasters");
+    EXPECT_EQ(6, raycasters.size());
+    EXPECT_EQ("toy.glsl", raycasters.value<std::string>("1.raycastPath"));
+    EXPECT_EQ(1, raycasters.value<int>("1.id"));
+    EXPECT_EQ(2, raycasters.value<int>("1.bitmask"));
+    EXPECT_EQ(8, raycasters.value<int>("3.bitmask"));
+    EXPECT_EQ("multires.glsl", raycasters.value<std::string>("3.raycastPath"));
+    EXPECT_EQ(
+        registry.raycastData(multires)->namespaceName,
+        raycasters.value<std::string>("3.namespace")
+    );
+
+    // The shared helper file is only included once
+    ghoul::Dictionary helperPaths = dict.value<ghoul::Dictionary>("helperPaths");
+    ASSERT_EQ(1, helperPaths.size());
+    EXPECT_EQ("helper.glsl", helperPaths.value<std::string>("0"));
+
+    VolumeRaycaster* toy2 = create("toy.glsl");
+    registry.update({ toy, multires, multires2, toy2 });
+    EXPECT_EQ(
+        dict.value<ghoul::Dictionary>("raycasters").keys(),
+        registry.resolveDictionary().value<ghoul::Dictionary>("raycasters").keys()
+    );
+}
@@ -0,0 +1,250 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/scripting/scriptscheduler.h>
+
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+namespace {
+    const int NProperties = 100;
+    const int NScripts = 50000;
+    const double TimeStep = 10.0;
+
+    std::string propertyUri(int p) {
+        return "Node" + std::to_string(p) + ".value";
+    }
+
+    // Script i sets the property i % NProperties to i at the time i * TimeStep, so
+    // going backward it restores the value of the previous script for this property
+    ghoul::Dictionary createSchedule() {
+        ghoul::Dictionary schedule;
+        for (int i = 0; i < NScripts; ++i) {
+            ghoul::Dictionary property;
+            property.setValue("Property", propertyUri(i % NProperties));
+            property.setValue("Forward", static_cast<double>(i));
+            property.setValue("Backward", static_cast<double>(i - NProperties));
+
+            ghoul::Dictionary state;
+            state.setValue("1", property);
+
+            ghoul::Dictionary script;
+            script.setValue("Time", i * TimeStep);
+            script.setValue("State", state);
+            schedule.setValue(std::to_string(i + 1), script);
+        }
+        return schedule;
+    }
+
+    // The value of property p that replaying all scripts up to time would result in
+    double expectedValue(int p, double time) {
+        int nPassed = 0;
+        if (time >= 0.0) {
+            nPassed = std::min(NScripts, static_cast<int>(time / TimeStep) + 1);
+        }
+        if (nPassed <= p) {
+            return static_cast<double>(p - NProperties);
+        }
+        return static_cast<double>(p + ((nPassed - 1 - p) / NProperties) * NProperties);
+    }
+
+    void applyChanges(const openspace::scripting::ScriptScheduler& scheduler,
+                      std::map<std::string, double>& values)
+    {
+        for (const openspace::scripting::PropertyState& s : scheduler.stateChanges()) {
+            ASSERT_EQ(openspace::scripting::PropertyValue::Type::Number, s.value.type);
+            values[s.uri] = s.value.number;
+        }
+    }
+} // namespace
+
+class ScriptSchedulerTest : public testing::Test {
+protected:
+    ScriptSchedulerTest() {
+        scheduler.loadScripts(createSchedule());
+        for (int p = 0; p < NProperties; ++p) {
+            values[propertyUri(p)] = expectedValue(p, -1.0);
+        }
+    }
+
+    void seek(double time) {
+        std::queue<std::string> scripts = scheduler.progressTo(time);
+        EXPECT_TRUE(scripts.empty());
+
+        std::set<std::string> uris;
+        for (const openspace::scripting::PropertyState& s : scheduler.stateChanges()) {
+            EXPECT_TRUE(uris.insert(s.uri).second) << "Duplicate change for " << s.uri;
+        }
+        applyChanges(scheduler, values);
+    }
+
+    void checkValues(double time) {
+        for (int p = 0; p < NProperties; ++p) {
+            ASSERT_EQ(expectedValue(p, time), values[propertyUri(p)]) <<
+                "Property " << p << " at time " << time;
+        }
+    }
+
+    openspace::scripting::ScriptScheduler scheduler;
+    std::map<std::string, double> values;
+};
+
+TEST_F(ScriptSchedulerTest, LoadsSortedSchedule) {
+    ASSERT_EQ(NScripts, scheduler.allScripts().size());
+    EXPECT_EQ(0.0, scheduler.allScripts().front().time);
+    EXPECT_EQ((NScripts - 1) * TimeStep, scheduler.allScripts().back().time);
+}
+
+TEST_F(ScriptSchedulerTest, SmallStepsMatchReplay) {
+    for (double time = -TimeStep; time < 3 * NProperties * TimeStep; time += 3.7) {
+        seek(time);
+        checkValues(time);
+    }
+    for (double time = 3 * NProperties * TimeStep; time > -TimeStep; time -= 5.3) {
+        seek(time);
+        checkValues(time);
+    }
+}
+
+TEST_F(ScriptSchedulerTest, JumpsMatchReplay) {
+    const double end = NScripts * TimeStep;
+
+    seek(end);
+    checkValues(end);
+    seek(-1.0);
+    checkValues(-1.0);
+
+    std::mt19937 generator(1337);
+    std::uniform_real_distribution<double> distribution(-TimeStep, end + TimeStep);
+    for (int i = 0; i < 1000; ++i) {
+        double time = distribution(generator);
+        seek(time);
+        checkValues(time);
+    }
+}
+
+TEST_F(ScriptSchedulerTest, JumpsOnlyResolveFinalState) {
+    const double end = NScripts * TimeStep;
+
+    scheduler.progressTo(end);
+    EXPECT_EQ(NProperties, scheduler.stateChanges().size());
+
+    scheduler.progressTo(end + 1.0);
+    EXPECT_TRUE(scheduler.stateChanges().empty());
+
+    // Passing a single script only touches its property
+    scheduler.progressTo((NScripts - 1) * TimeStep - 1.0);
+    ASSERT_EQ(1, scheduler.stateChanges().size());
+    EXPECT_EQ(propertyUri((NScripts - 1) % NProperties), scheduler.stateChanges()[0].uri);
+
+    // Jumping back to the start resolves every property once more
+    EXPECT_TRUE(scheduler.progressTo(-1.0).empty());
+    EXPECT_EQ(NProperties, scheduler.stateChanges().size());
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(ScriptSchedulerTest, TimingTest) {
+    std::ofstream logFile("ScriptSchedulerTest.timing");
+    const double end = NScripts * TimeStep;
+
+    // Replaying the history would run NScripts scripts for every jump
+    START_TIMER_NO_RESET(fullRangeJumps, logFile, 200);
+    scheduler.progressTo(fullRangeJumpsNum % 2 == 0 ? end : -1.0);
+    FINISH_TIMER(fullRangeJumps, logFile);
+}
+
+#endif // GHL_TIMING_TESTS
+
+TEST(ScriptSchedulerStateTest, ValueTypesAndScripts) {
+    using openspace::scripting::PropertyValue;
+
+    ghoul::Dictionary components;
+    components.setValue("1", 1.0);
+    components.setValue("2", 2.0);
+    components.setValue("3", 3.0);
+
+    ghoul::Dictionary enabled;
+    enabled.setValue("Property", std::string("Node.renderable.enabled"));
+    enabled.setValue("Forward", true);
+    ghoul::Dictionary name;
+    name.setValue("Property", std::string("Node.name"));
+    name.setValue("Forward", std::string("after"));
+    name.setValue("Backward", std::string("before"));
+    ghoul::Dictionary position;
+    position.setValue("Property", std::string("Node.position"));
+    position.setValue("Forward", components);
+
+    ghoul::Dictionary state;
+    state.setValue("1", enabled);
+    state.setValue("2", name);
+    state.setValue("3", position);
+
+    ghoul::Dictionary first;
+    first.setValue("Time", 10.0);
+    first.setValue("State", state);
+
+    ghoul::Dictionary script;
+    script.setValue("Forward", std::string("forward()"));
+    script.setValue("Backward", std::string("backward()"));
+    ghoul::Dictionary second;
+    second.setValue("Time", 20.0);
+    second.setValue("ReversibleLuaScript", script);
+
+    ghoul::Dictionary schedule;
+    schedule.setValue("1", second);
+    schedule.setValue("2", first);
+
+    openspace::scripting::ScriptScheduler scheduler;
+    scheduler.loadScripts(schedule);
+
+    std::queue<std::string> scripts = scheduler.progressTo(30.0);
+    ASSERT_EQ(1, scripts.size());
+    EXPECT_EQ("forward()", scripts.front());
+
+    std::map<std::string, PropertyValue> values;
+    for (const openspace::scripting::PropertyState& s : scheduler.stateChanges()) {
+        values[s.uri] = s.value;
+    }
+    ASSERT_EQ(3, values.size());
+    EXPECT_EQ(PropertyValue::Type::Boolean, values["Node.renderable.enabled"].type);
+    EXPECT_TRUE(values["Node.renderable.enabled"].boolean);
+    EXPECT_EQ(PropertyValue::Type::String, values["Node.name"].type);
+    EXPECT_EQ("after", values["Node.name"].string);
+    EXPECT_EQ(PropertyValue::Type::Vector, values["Node.position"].type);
+    EXPECT_EQ(std::vector<double>({ 1.0, 2.0, 3.0 }), values["Node.position"].vector);
+
+    // Only the name declares a value before the first script
+    scripts = scheduler.progressTo(0.0);
+    ASSERT_EQ(1, scripts.size());
+    EXPECT_EQ("backward()", scripts.front());
+    ASSERT_EQ(1, scheduler.stateChanges().size());
+    EXPECT_EQ("Node.name", scheduler.stateChanges()[0].uri);
+    EXPECT_EQ("before", scheduler.stateChanges()[0].value.string);
+}
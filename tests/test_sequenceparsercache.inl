@@ -0,0 +1,215 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include "gtest/gtest.h"
+
+#include <modules/newhorizons/util/hongkangparser.h>
+
+#include <openspace/util/spicemanager.h>
+
+#include <ghoul/filesystem/directory.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <cstdio>
+#include <fstream>
+
+class SequenceParserCacheTest : public testing::Test {
+protected:
+    SequenceParserCacheTest()
+        : _playbookPath(absPath("${TEMPORARY}/sequenceparsercachetest.txt"))
+        , _cacheDirectory(absPath("${TEMPORARY}/sequenceparsercachetest"))
+    {
+        // The parsers write their cache here instead of into the persistent cache, which
+        // is emptied first in case a previous run has been aborted
+        FileSys.createDirectory(
+            _cacheDirectory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+        removeCacheFiles();
+    }
+
+    ~SequenceParserCacheTest() {
+        std::remove(_playbookPath.c_str());
+        removeCacheFiles();
+        FileSys.deleteDirectory(_cacheDirectory);
+    }
+
+    void removeCacheFiles() {
+        ghoul::filesystem::Directory directory(_cacheDirectory);
+        for (const std::string& file : directory.readFiles()) {
+            std::remove(file.c_str());
+        }
+    }
+
+    void SetUp() override {
+        openspace::SpiceManager::initialize();
+        openspace::SpiceManager::ref().loadKernel(
+            "${TESTDIR}/SpiceTest/spicekernels/naif0008.tls"
+        );
+    }
+
+    void TearDown() override {
+        openspace::SpiceManager::deinitialize();
+    }
+
+    // The playbook columns that are read are the event name at the start of the line
+    // and the mission elapsed time in the nine characters starting at column 25
+    static std::string playbookLine(const std::string& event, int met,
+                                    const std::string& target)
+    {
+        std::string line = event;
+        line.resize(25, ' ');
+        return line + std::to_string(met) + "  " + target;
+    }
+
+    void writePlaybook(int nExtraImages) {
+        std::vector<std::string> lines = {
+            playbookLine("LORRI_IMAGE", 299180000, "PLUTO"),
+            playbookLine("LORRI_IMAGE", 299180010, "PLUTO"),
+            playbookLine("LORRI_IMAGE", 299180020, "CHARON"),
+            playbookLine("IDLE", 299180030, ""),
+            playbookLine("RALPH_SCAN", 299180100, "PLUTO"),
+            playbookLine("RALPH_ABORT", 299180160, ""),
+            playbookLine("LORRI_IMAGE", 299180200, "CHARON")
+        };
+        for (int i = 0; i < nExtraImages; ++i) {
+            lines.push_back(playbookLine("LORRI_IMAGE", 299180300 + 10 * i, "PLUTO"));
+        }
+        lines.push_back(playbookLine("IDLE", 299181000, ""));
+
+        // The parser requires the last line to not be terminated
+        std::ofstream file(_playbookPath, std::ofstream::binary);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            file << lines[i];
+            if (i != lines.size() - 1) {
+                file << '\n';
+            }
+        }
+    }
+
+    std::unique_ptr<openspace::HongKangParser> createParser() {
+        using ghoul::Dictionary;
+        Dictionary translation {
+            { "Instrument", Dictionary {
+                { "LORRI_IMAGE", Dictionary {
+                    { "DetectorType", std::string("Camera") },
+                    { "Spice", Dictionary { { "1", std::string("NH_LORRI") } } }
+                }},
+                { "RALPH_SCAN", Dictionary {
+                    { "DetectorType", std::string("Scanner") },
+                    { "StopCommand", std::string("RALPH_ABORT") },
+                    { "Spice", Dictionary {
+                        { "1", std::string("NH_RALPH_MVIC_PAN1") },
+                        { "2", std::string("NH_RALPH_MVIC_RED") }
+                    }}
+                }}
+            }}
+        };
+
+        auto parser = std::make_unique<openspace::HongKangParser>(
+            "SequenceParserCacheTest",
+            _playbookPath,
+            "NEW HORIZONS",
+            translation,
+            std::vector<std::string>{ "PLUTO", "CHARON" }
+        );
+        parser->setCacheDirectory(_cacheDirectory);
+        return parser;
+    }
+
+    static void expectEqual(openspace::SequenceParser& lhs,
+                            openspace::SequenceParser& rhs)
+    {
+        std::map<std::string, openspace::ImageSubset> lhsSubsets = lhs.getSubsetMap();
+        std::map<std::string, openspace::ImageSubset> rhsSubsets = rhs.getSubsetMap();
+        ASSERT_EQ(lhsSubsets.size(), rhsSubsets.size());
+        for (const auto& p : lhsSubsets) {
+            ASSERT_EQ(1, rhsSubsets.count(p.first)) << p.first;
+            const openspace::ImageSubset& l = p.second;
+            const openspace::ImageSubset& r = rhsSubsets[p.first];
+            EXPECT_EQ(l._range.start, r._range.start);
+            EXPECT_EQ(l._range.end, r._range.end);
+            ASSERT_EQ(l._subset.size(), r._subset.size());
+            for (size_t i = 0; i < l._subset.size(); ++i) {
+                EXPECT_EQ(l._subset[i].timeRange.start, r._subset[i].timeRange.start);
+                EXPECT_EQ(l._subset[i].timeRange.end, r._subset[i].timeRange.end);
+                EXPECT_EQ(l._subset[i].path, r._subset[i].path);
+                EXPECT_EQ(l._subset[i].activeInstruments, r._subset[i].activeInstruments);
+                EXPECT_EQ(l._subset[i].target, r._subset[i].target);
+                EXPECT_EQ(l._subset[i].isPlaceholder, r._subset[i].isPlaceholder);
+                EXPECT_EQ(l._subset[i].projected, r._subset[i].projected);
+            }
+        }
+
+        auto lhsInstruments = lhs.getInstrumentTimes();
+        auto rhsInstruments = rhs.getInstrumentTimes();
+        ASSERT_EQ(lhsInstruments.size(), rhsInstruments.size());
+        for (size_t i = 0; i < lhsInstruments.size(); ++i) {
+            EXPECT_EQ(lhsInstruments[i].first, rhsInstruments[i].first);
+            EXPECT_EQ(lhsInstruments[i].second.start, rhsInstruments[i].second.start);
+            EXPECT_EQ(lhsInstruments[i].second.end, rhsInstruments[i].second.end);
+        }
+
+        EXPECT_EQ(lhs.getTargetTimes(), rhs.getTargetTimes());
+        EXPECT_EQ(lhs.getCaptureProgression(), rhs.getCaptureProgression());
+    }
+
+    std::string _playbookPath;
+    std::string _cacheDirectory;
+};
+
+TEST_F(SequenceParserCacheTest, RoundTrip) {
+    writePlaybook(0);
+
+    std::unique_ptr<openspace::HongKangParser> parsed = createParser();
+    ASSERT_TRUE(parsed->create());
+    // 4 camera images and one scan
+    EXPECT_EQ(5, parsed->getCaptureProgression().size());
+    EXPECT_EQ(3, parsed->getInstrumentTimes().size());
+    EXPECT_EQ(2, parsed->getSubsetMap().size());
+
+    std::unique_ptr<openspace::HongKangParser> cached = createParser();
+    ASSERT_TRUE(cached->create());
+    EXPECT_TRUE(cached->isLoadedFromCache());
+
+    expectEqual(*parsed, *cached);
+}
+
+TEST_F(SequenceParserCacheTest, StalePlaybookIsParsed) {
+    writePlaybook(0);
+    std::unique_ptr<openspace::HongKangParser> original = createParser();
+    ASSERT_TRUE(original->create());
+
+    writePlaybook(3);
+    std::unique_ptr<openspace::HongKangParser> modified = createParser();
+    ASSERT_TRUE(modified->create());
+    EXPECT_FALSE(modified->isLoadedFromCache());
+    EXPECT_EQ(original->getCaptureProgression().size() + 3,
+        modified->getCaptureProgression().size());
+
+    std::unique_ptr<openspace::HongKangParser> cached = createParser();
+    ASSERT_TRUE(cached->create());
+    EXPECT_TRUE(cached->isLoadedFromCache());
+    expectEqual(*modified, *cached);
+}
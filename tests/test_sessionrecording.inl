@@ -0,0 +1,183 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/sessionrecording.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <cstdio>
+#include <fstream>
+
+class SessionRecordingTest : public testing::Test {
+protected:
+    using SessionRecording = openspace::interaction::SessionRecording;
+
+    SessionRecordingTest()
+        : _sessionPath(absPath("${TEMPORARY}/sessionrecordingtest.ossr"))
+        , _timingsPath(absPath("${TEMPORARY}/sessionrecordingtest.csv"))
+    {}
+
+    ~SessionRecordingTest() {
+        std::remove(_sessionPath.c_str());
+        std::remove(_timingsPath.c_str());
+    }
+
+    static SessionRecording::Frame frame(int i) {
+        SessionRecording::Frame f;
+        f.simulationTime = 1000.0 + i;
+        f.simulationDeltaTime = 2.0 * i;
+        f.frameTime = 0.016;
+        f.cameraPosition = glm::dvec3(i, 2.0 * i, -3.0 * i);
+        f.cameraRotation = glm::dquat(0.5, 0.5, -0.5, 0.5);
+        if (i % 2 == 0) {
+            f.scripts.push_back("openspace.time.setDeltaTime(" + std::to_string(i) + ")");
+        }
+        return f;
+    }
+
+    void recordSession(int nFrames) {
+        SessionRecording recording;
+        recording.startRecording(_sessionPath);
+        for (int i = 0; i < nFrames; ++i) {
+            recording.recordFrame(frame(i));
+        }
+        recording.stopRecording();
+    }
+
+    std::string _sessionPath;
+    std::string _timingsPath;
+};
+
+TEST_F(SessionRecordingTest, RoundTrip) {
+    SessionRecording recording;
+    recording.startRecording(_sessionPath);
+    EXPECT_TRUE(recording.isRecording());
+
+    SessionRecording::Frame f = frame(0);
+    f.scripts.push_back("openspace.sessionRecording.stopRecording()");
+    recording.recordFrame(f);
+    recording.recordFrame(frame(1));
+    recording.recordFrame(frame(2));
+    recording.stopRecording();
+    EXPECT_EQ(SessionRecording::State::Idle, recording.state());
+
+    std::vector<SessionRecording::Frame> frames =
+        SessionRecording::loadSession(_sessionPath);
+    ASSERT_EQ(3, frames.size());
+    for (int i = 0; i < 3; ++i) {
+        SessionRecording::Frame expected = frame(i);
+        EXPECT_EQ(expected.simulationTime, frames[i].simulationTime);
+        EXPECT_EQ(expected.simulationDeltaTime, frames[i].simulationDeltaTime);
+        EXPECT_EQ(expected.frameTime, frames[i].frameTime);
+        EXPECT_EQ(expected.cameraPosition, frames[i].cameraPosition);
+        EXPECT_EQ(expected.cameraRotation, frames[i].cameraRotation);
+        // The script controlling the recording itself is not part of the session
+        EXPECT_EQ(expected.scripts, frames[i].scripts);
+    }
+}
+
+TEST_F(SessionRecordingTest, IncompleteFrameIsDropped) {
+    recordSession(2);
+
+    // Remove the last bytes of the second frame as if the recording had crashed
+    std::string content;
+    {
+        std::ifstream file(_sessionPath, std::ifstream::binary);
+        content.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    {
+        std::ofstream file(_sessionPath, std::ofstream::binary);
+        file.write(content.data(), content.size() - 5);
+    }
+
+    std::vector<SessionRecording::Frame> frames =
+        SessionRecording::loadSession(_sessionPath);
+    ASSERT_EQ(1, frames.size());
+    EXPECT_EQ(frame(0).simulationTime, frames[0].simulationTime);
+    EXPECT_EQ(frame(0).scripts, frames[0].scripts);
+}
+
+TEST_F(SessionRecordingTest, InvalidFileThrows) {
+    {
+        std::ofstream file(_sessionPath, std::ofstream::binary);
+        file << "This is not a session file";
+    }
+    EXPECT_THROW(
+        SessionRecording::loadSession(_sessionPath),
+        SessionRecording::SessionRecordingError
+    );
+
+    SessionRecording recording;
+    EXPECT_THROW(
+        recording.startPlayback(absPath("${TEMPORARY}/nonexistingsession.ossr")),
+        SessionRecording::SessionRecordingError
+    );
+    EXPECT_EQ(SessionRecording::State::Idle, recording.state());
+}
+
+TEST_F(SessionRecordingTest, PlaybackIsFrameLocked) {
+    const int nFrames = 4;
+    recordSession(nFrames);
+
+    SessionRecording recording;
+    recording.startPlayback(_sessionPath, _timingsPath);
+    ASSERT_TRUE(recording.isPlayingBack());
+
+    // Ending a frame that was never started has no effect
+    recording.endPlaybackFrame();
+
+    for (int i = 0; i < nFrames; ++i) {
+        ASSERT_TRUE(recording.isPlayingBack());
+        const SessionRecording::Frame& f = recording.beginPlaybackFrame();
+        EXPECT_EQ(i, recording.playbackFrameIndex());
+        EXPECT_EQ(frame(i).simulationTime, f.simulationTime);
+        EXPECT_EQ(frame(i).cameraPosition, f.cameraPosition);
+        {
+            SessionRecording::StageTimer timer(recording, "Update");
+        }
+        // A stage that first appears in a later frame adds a column for all frames
+        if (i >= 2) {
+            recording.addStageTime("Culling", std::chrono::milliseconds(3));
+            recording.addStageTime("Culling", std::chrono::milliseconds(2));
+        }
+        recording.endPlaybackFrame();
+    }
+    // The playback stops by itself after the last recorded frame
+    EXPECT_EQ(SessionRecording::State::Idle, recording.state());
+
+    std::ifstream file(_timingsPath);
+    ASSERT_TRUE(file.good());
+    std::string line;
+    std::getline(file, line);
+    EXPECT_EQ("Frame,SimulationTime,Total,Update,Culling", line);
+
+    std::vector<std::string> rows;
+    while (std::getline(file, line)) {
+        rows.push_back(line);
+    }
+    ASSERT_EQ(nFrames, rows.size());
+    EXPECT_EQ("0,1000,", rows[0].substr(0, 7));
+    EXPECT_EQ(",0", rows[0].substr(rows[0].size() - 2));
+    EXPECT_EQ(",5", rows[3].substr(rows[3].size() - 2));
+}
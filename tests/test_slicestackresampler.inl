@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/rawvolumewriter.h>
+#include <modules/volume/slicestackresampler.h>
+#include <modules/volume/volumesampler.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+class SliceStackResamplerTest : public testing::Test {
+protected:
+    static glm::vec4 texel(int x, int y, int z) {
+        return glm::vec4(
+            static_cast<float>(x * 3 + y) / 7.f,
+            static_cast<float>((x * y + z) % 11),
+            static_cast<float>(z) * 0.25f,
+            1.f / static_cast<float>(1 + x + y + z)
+        );
+    }
+
+    static std::vector<char> readFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        return std::vector<char>(
+            (std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>()
+        );
+    }
+};
+
+TEST_F(SliceStackResamplerTest, IdenticalToSequentialPath) {
+    using namespace openspace;
+
+    const glm::ivec3 inDimensions(16, 12, 40);
+    const glm::ivec3 outDimensions(8, 12, 5);
+
+    const std::string referencePath =
+        absPath("${TEMPORARY}/slicestackresamplertest_reference.rawvolume");
+    const std::string resampledPath =
+        absPath("${TEMPORARY}/slicestackresamplertest_resampled.rawvolume");
+
+    // Reference: the per-voxel sampling through a std::function that the Milky Way
+    // conversion task used to do, on an in-memory copy of the slice stack
+    RawVolume<glm::vec4> stack(inDimensions);
+    for (int z = 0; z < inDimensions.z; ++z) {
+        for (int y = 0; y < inDimensions.y; ++y) {
+            for (int x = 0; x < inDimensions.x; ++x) {
+                stack.set(glm::ivec3(x, y, z), texel(x, y, z));
+            }
+        }
+    }
+
+    RawVolumeWriter<glm::vec4> writer(referencePath);
+    writer.setDimensions(outDimensions);
+    glm::vec3 resolutionRatio =
+        static_cast<glm::vec3>(inDimensions) / static_cast<glm::vec3>(outDimensions);
+    VolumeSampler<RawVolume<glm::vec4>> sampler(stack, resolutionRatio);
+    std::function<glm::vec4(glm::ivec3)> sampleFunction = [&](glm::ivec3 outCoord) {
+        glm::vec3 inCoord = ((glm::vec3(outCoord) + glm::vec3(0.5)) * resolutionRatio) -
+            glm::vec3(0.5);
+        return sampler.sample(inCoord);
+    };
+    writer.write(sampleFunction);
+
+    // Resampled in parallel slabs from slices that are loaded on demand
+    SliceStackResampler<glm::vec4> resampler(
+        [&](size_t sliceIndex) {
+            const int z = static_cast<int>(sliceIndex);
+            auto slice = std::make_unique<RawVolume<glm::vec4>>(
+                glm::ivec3(inDimensions.x, inDimensions.y, 1)
+            );
+            for (int y = 0; y < inDimensions.y; ++y) {
+                for (int x = 0; x < inDimensions.x; ++x) {
+                    slice->set(glm::ivec3(x, y, 0), texel(x, y, z));
+                }
+            }
+            return slice;
+        },
+        glm::ivec2(inDimensions.x, inDimensions.y),
+        inDimensions.z,
+        outDimensions
+    );
+    SliceStackResampler<glm::vec4>::Statistics stats =
+        resampler.resample(resampledPath, 4);
+
+    EXPECT_EQ(
+        static_cast<size_t>(outDimensions.x * outDimensions.y * outDimensions.z),
+        stats.nVoxelsWritten
+    );
+    EXPECT_EQ(static_cast<size_t>(inDimensions.z), stats.nSlicesLoaded);
+
+    std::vector<char> reference = readFile(referencePath);
+    std::vector<char> resampled = readFile(resampledPath);
+    ASSERT_EQ(
+        outDimensions.x * outDimensions.y * outDimensions.z * sizeof(glm::vec4),
+        reference.size()
+    );
+    EXPECT_TRUE(reference == resampled) << "Output differs from the sequential path";
+
+    std::remove(referencePath.c_str());
+    std::remove(resampledPath.c_str());
+}
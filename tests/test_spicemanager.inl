@@ -365,6 +365,46 @@ TEST_F(SpiceManagerTest, getPositionTransformMatrix) {
     }
 }
 
+// Repeated queries for the same frames and time are served from the transform cache
+TEST_F(SpiceManagerTest, positionTransformMatrixCache) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    double et;
+    str2et_c("2004 jun 11 19:32:00", &et);
+    SpiceManager::ref().clearTransformCache();
+
+    const int nTimes = 10;
+    for (int t = 0; t < nTimes; ++t) {
+        double time = et + t * 60.0;
+        double referenceMatrix[3][3];
+        pxform_c("CASSINI_HGA", "J2000", time, referenceMatrix);
+
+        glm::dmat3 first = SpiceManager::ref().positionTransformMatrix(
+            "CASSINI_HGA", "J2000", time
+        );
+        glm::dmat3 second = SpiceManager::ref().positionTransformMatrix(
+            "CASSINI_HGA", "J2000", time
+        );
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                EXPECT_DOUBLE_EQ(referenceMatrix[i][j], first[j][i]);
+                EXPECT_EQ(first[j][i], second[j][i]) << "Cached matrix differs";
+            }
+        }
+    }
+    EXPECT_EQ(nTimes, SpiceManager::ref().numberOfCachedTransforms());
+
+    SpiceManager::ref().clearTransformCache();
+    EXPECT_EQ(0, SpiceManager::ref().numberOfCachedTransforms());
+
+    // Unloading a kernel invalidates the cache as the frames might have changed
+    SpiceManager::ref().positionTransformMatrix("IAU_SATURN", "J2000", et);
+    EXPECT_EQ(1, SpiceManager::ref().numberOfCachedTransforms());
+    SpiceManager::ref().unloadKernel(PCK);
+    EXPECT_EQ(0, SpiceManager::ref().numberOfCachedTransforms());
+}
+
 // Try to get boresight vector and instrument field of view boundary vectors
 TEST_F(SpiceManagerTest, getFieldOfView) {
     using openspace::SpiceManager;
@@ -0,0 +1,141 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/base/rotation/spicerotation.h>
+#include <openspace/util/spicemanager.h>
+
+#include <ghoul/misc/dictionary.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+class SpiceRotationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        openspace::SpiceManager::initialize();
+        loadMetaKernel();
+        str2et_c("2004 jun 11 19:32:00", &et);
+    }
+
+    void TearDown() override {
+        openspace::SpiceManager::deinitialize();
+    }
+
+    static ghoul::Dictionary rotationDictionary(const std::string& sourceFrame,
+        double timeStep = 0.0, double tolerance = 0.0)
+    {
+        ghoul::Dictionary dictionary = {
+            { "SourceFrame", sourceFrame },
+            { "DestinationFrame", std::string("J2000") }
+        };
+        if (timeStep > 0.0) {
+            dictionary.setValue("TimeStep", timeStep);
+            dictionary.setValue("Tolerance", tolerance);
+        }
+        return dictionary;
+    }
+
+    static openspace::UpdateData updateData(double time) {
+        return { { glm::dvec3(0.0), glm::dmat3(1.0), 1.0 }, time, false, 0.0, false };
+    }
+
+    // The angle in radians between the rotation and the direct SPICE query
+    static double angularError(const glm::dmat3& rotation, const std::string& frame,
+        double time)
+    {
+        double referenceMatrix[3][3];
+        pxform_c(frame.c_str(), "J2000", time, referenceMatrix);
+        glm::dmat3 reference;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                reference[j][i] = referenceMatrix[i][j];
+            }
+        }
+        double cosHalfAngle = std::abs(
+            glm::dot(glm::quat_cast(rotation), glm::quat_cast(reference))
+        );
+        return 2.0 * std::acos(std::min(cosHalfAngle, 1.0));
+    }
+
+    double et;
+};
+
+TEST_F(SpiceRotationTest, DirectQuery) {
+    openspace::SpiceRotation rotation(rotationDictionary("CASSINI_HGA"));
+
+    for (int t = 0; t < 100; ++t) {
+        double time = et + t * 10.0;
+        rotation.update(updateData(time));
+
+        double referenceMatrix[3][3];
+        pxform_c("CASSINI_HGA", "J2000", time, referenceMatrix);
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                EXPECT_DOUBLE_EQ(referenceMatrix[i][j], rotation.matrix()[j][i]);
+            }
+        }
+    }
+}
+
+TEST_F(SpiceRotationTest, InterpolationMatchesSamples) {
+    const double timeStep = 600.0;
+    openspace::SpiceRotation rotation(rotationDictionary("CASSINI_HGA", timeStep, 1.0));
+
+    // At the sample times, the interpolated rotation is the queried rotation
+    double start = std::floor(et / timeStep) * timeStep;
+    for (int t = 0; t < 10; ++t) {
+        double time = start + t * timeStep;
+        rotation.update(updateData(time));
+        EXPECT_NEAR(0.0, angularError(rotation.matrix(), "CASSINI_HGA", time), 1e-6);
+    }
+}
+
+TEST_F(SpiceRotationTest, InterpolationTolerance) {
+    using openspace::SpiceManager;
+    const double tolerance = 1e-5;
+    openspace::SpiceRotation rotation(
+        rotationDictionary("IAU_SATURN", 3600.0, tolerance)
+    );
+
+    // Simulate a playback at a high time rate, where each frame advances 10 s
+    SpiceManager::ref().clearTransformCache();
+    const int nFrames = 3600;
+    double maximumError = 0.0;
+    for (int t = 0; t < nFrames; ++t) {
+        double time = et + t * 10.0;
+        rotation.update(updateData(time));
+        maximumError = std::max(
+            maximumError,
+            angularError(rotation.matrix(), "IAU_SATURN", time)
+        );
+    }
+    EXPECT_LT(maximumError, tolerance);
+
+    // Only the samples and the error estimates were queried from SPICE
+    EXPECT_LT(SpiceManager::ref().numberOfCachedTransforms(), nFrames / 10);
+}
@@ -0,0 +1,341 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/engine/downloadmanager.h>
+#include <openspace/network/socket.h>
+#include <openspace/rendering/texturecache.h>
+#include <openspace/util/jobmanager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// A minimal HTTP server on the loopback interface that serves a single body and answers
+// conditional requests with 304 Not Modified if the ETag of the body matches
+class HttpStub {
+public:
+    HttpStub()
+        : _listener(INVALID_SOCKET)
+        , _port(0)
+        , _isRunning(true)
+        , _nRequests(0)
+        , _nNotModified(0)
+        , _version(0)
+    {
+        openspace::network::initializeSocketApi();
+        _listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        bind(_listener, reinterpret_cast<sockaddr*>(&address), length);
+        listen(_listener, 16);
+        getsockname(_listener, reinterpret_cast<sockaddr*>(&address), &length);
+        _port = ntohs(address.sin_port);
+
+        setBody("first");
+        _thread = std::thread([this]() { serve(); });
+    }
+
+    ~HttpStub() {
+        // Wake up the blocking accept with a connection that is closed immediately
+        _isRunning = false;
+        _SOCKET wakeUp = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(_port);
+        connect(wakeUp, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        openspace::network::closeSocket(wakeUp);
+
+        _thread.join();
+        openspace::network::closeSocket(_listener);
+    }
+
+    std::string url(const std::string& path = "/image.test") const {
+        return "http://127.0.0.1:" + std::to_string(_port) + path;
+    }
+
+    // Replaces the served body, which gives it a new ETag and Last-Modified date
+    void setBody(std::string body) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _body = std::move(body);
+        ++_version;
+        _etag = "\"v" + std::to_string(_version) + "\"";
+        _lastModified = "Mon, 0" + std::to_string(_version) + " Jan 2016 00:00:00 GMT";
+    }
+
+    std::string etag() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _etag;
+    }
+
+    int nRequests() const { return _nRequests; }
+    int nNotModified() const { return _nNotModified; }
+
+private:
+    void serve() {
+        while (true) {
+            _SOCKET client = accept(_listener, nullptr, nullptr);
+            if (!_isRunning) {
+                openspace::network::closeSocket(client);
+                return;
+            }
+            if (client != INVALID_SOCKET) {
+                respond(client);
+                openspace::network::closeSocket(client);
+            }
+        }
+    }
+
+    void respond(_SOCKET client) {
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            int n = static_cast<int>(recv(client, buffer, sizeof(buffer), 0));
+            if (n <= 0) {
+                return;
+            }
+            request.append(buffer, n);
+        }
+        ++_nRequests;
+
+        std::string lowerRequest = request;
+        std::transform(
+            lowerRequest.begin(),
+            lowerRequest.end(),
+            lowerRequest.begin(),
+            ::tolower
+        );
+        std::string ifNoneMatch;
+        const std::string Key = "if-none-match:";
+        size_t begin = lowerRequest.find(Key);
+        if (begin != std::string::npos) {
+            begin = request.find_first_not_of(' ', begin + Key.size());
+            ifNoneMatch = request.substr(begin, request.find("\r\n", begin) - begin);
+        }
+
+        std::string response;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!ifNoneMatch.empty() && ifNoneMatch == _etag) {
+                ++_nNotModified;
+                response = "HTTP/1.1 304 Not Modified\r\nETag: " + _etag + "\r\n" +
+                    "Connection: close\r\n\r\n";
+            }
+            else {
+                response = "HTTP/1.1 200 OK\r\n"
+                    "Content-Type: image/test\r\n"
+                    "Content-Length: " + std::to_string(_body.size()) + "\r\n" +
+                    "ETag: " + _etag + "\r\n" +
+                    "Last-Modified: " + _lastModified + "\r\n" +
+                    "Connection: close\r\n\r\n" + _body;
+            }
+        }
+        openspace::network::sendAll(client, response.data(), response.size());
+    }
+
+    _SOCKET _listener;
+    unsigned short _port;
+    std::atomic_bool _isRunning;
+    std::atomic_int _nRequests;
+    std::atomic_int _nNotModified;
+    std::thread _thread;
+
+    mutable std::mutex _mutex;
+    int _version;
+    std::string _body;
+    std::string _etag;
+    std::string _lastModified;
+};
+
+class TextureCacheTest : public testing::Test {
+protected:
+    TextureCacheTest()
+        : jobManager(2)
+        , nDecodes(0)
+    {}
+
+    // A decoder that stores the bytes of the file in a single-channel Image
+    openspace::TextureCache::Decoder countingDecoder() {
+        return [this](const char* data, size_t size, const std::string&) {
+            ++nDecodes;
+            auto image = std::make_unique<openspace::TextureCache::Image>();
+            image->data.reset(new char[size]);
+            std::memcpy(image->data.get(), data, size);
+            image->dimensions = glm::uvec3(static_cast<unsigned int>(size), 1, 1);
+            image->format = ghoul::opengl::Texture::Format::Red;
+            image->internalFormat = GL_R8;
+            image->dataType = GL_UNSIGNED_BYTE;
+            return image;
+        };
+    }
+
+    // Finishes all loads, including their continuations on the main thread
+    void finishLoads() {
+        jobManager.waitForIdle();
+        jobManager.drainMainThreadQueue();
+    }
+
+    static std::string imageContents(const openspace::TextureCache::Image* image) {
+        if (!image) {
+            return "";
+        }
+        return std::string(image->data.get(), image->dimensions.x);
+    }
+
+    openspace::JobManager jobManager;
+    std::atomic_int nDecodes;
+};
+
+TEST_F(TextureCacheTest, ConditionalDownload) {
+    using openspace::DownloadManager;
+
+    HttpStub server;
+
+    DownloadManager::MemoryFile file = DownloadManager::fetchFileBlocking(server.url());
+    ASSERT_FALSE(file.corrupted) << file.errorMessage;
+    EXPECT_TRUE(file.isModified);
+    EXPECT_EQ("first", std::string(file.buffer, file.size));
+    EXPECT_EQ("test", file.format);
+    EXPECT_EQ(server.etag(), file.etag);
+    EXPECT_FALSE(file.lastModified.empty());
+    free(file.buffer);
+
+    DownloadManager::MemoryFile unchanged = DownloadManager::fetchFileBlocking(
+        server.url(),
+        file.etag,
+        file.lastModified
+    );
+    ASSERT_FALSE(unchanged.corrupted) << unchanged.errorMessage;
+    EXPECT_FALSE(unchanged.isModified);
+    EXPECT_EQ(0, unchanged.size);
+    EXPECT_EQ(file.etag, unchanged.etag);
+    EXPECT_EQ(file.lastModified, unchanged.lastModified);
+    free(unchanged.buffer);
+
+    server.setBody("second");
+    DownloadManager::MemoryFile changed = DownloadManager::fetchFileBlocking(
+        server.url(),
+        file.etag,
+        file.lastModified
+    );
+    ASSERT_FALSE(changed.corrupted) << changed.errorMessage;
+    EXPECT_TRUE(changed.isModified);
+    EXPECT_EQ("second", std::string(changed.buffer, changed.size));
+    EXPECT_EQ(server.etag(), changed.etag);
+    free(changed.buffer);
+
+    EXPECT_EQ(3, server.nRequests());
+    EXPECT_EQ(1, server.nNotModified());
+}
+
+TEST_F(TextureCacheTest, SharedSources) {
+    HttpStub server;
+    openspace::TextureCache cache(jobManager, countingDecoder());
+
+    // Both users of the URL share a single download and decode
+    cache.acquire(server.url());
+    cache.acquire(server.url());
+    finishLoads();
+
+    EXPECT_EQ(1, server.nRequests());
+    EXPECT_EQ(1, nDecodes);
+    EXPECT_EQ(1, cache.version(server.url()));
+    EXPECT_EQ("first", imageContents(cache.image(server.url())));
+
+    // The source stays alive until its last user has released it
+    cache.release(server.url());
+    EXPECT_EQ(1, cache.version(server.url()));
+    cache.release(server.url());
+    EXPECT_EQ(0, cache.version(server.url()));
+    EXPECT_EQ(nullptr, cache.image(server.url()));
+
+    // Sources on disk are loaded the same way
+    const std::string path = "texturecache_test.test";
+    {
+        std::ofstream file(path, std::ofstream::binary);
+        file << "on disk";
+    }
+    cache.acquire(path);
+    cache.acquire(path);
+    finishLoads();
+    EXPECT_EQ(2, nDecodes);
+    EXPECT_EQ("on disk", imageContents(cache.image(path)));
+    cache.release(path);
+    cache.release(path);
+    std::remove(path.c_str());
+
+    openspace::TextureCache::Statistics stats = cache.statistics();
+    EXPECT_EQ(2, stats.nLoads);
+    EXPECT_EQ(2, stats.nDecodes);
+    EXPECT_EQ(0, stats.nUploads);
+}
+
+TEST_F(TextureCacheTest, Refresh) {
+    HttpStub server;
+    openspace::TextureCache cache(jobManager, countingDecoder());
+
+    cache.acquire(server.url());
+    finishLoads();
+    ASSERT_EQ(1, cache.version(server.url()));
+
+    // An unchanged image is neither downloaded nor decoded again
+    for (int i = 0; i < 3; ++i) {
+        cache.refresh(server.url());
+        finishLoads();
+    }
+    EXPECT_EQ(4, server.nRequests());
+    EXPECT_EQ(3, server.nNotModified());
+    EXPECT_EQ(1, nDecodes);
+    EXPECT_EQ(1, cache.version(server.url()));
+    EXPECT_EQ(3, cache.statistics().nUnchanged);
+
+    // A changed image replaces the previous one
+    server.setBody("second");
+    cache.refresh(server.url());
+    finishLoads();
+    EXPECT_EQ(2, nDecodes);
+    EXPECT_EQ(2, cache.version(server.url()));
+    EXPECT_EQ("second", imageContents(cache.image(server.url())));
+
+    cache.refresh(server.url());
+    finishLoads();
+    EXPECT_EQ(2, nDecodes);
+    EXPECT_EQ(4, server.nNotModified());
+
+    cache.release(server.url());
+}
@@ -0,0 +1,246 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/tile/tileprovidermanager.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TileProviderManagerTest : public testing::Test {
+protected:
+    // A tile provider without any tiles that only counts how often it is updated
+    class CountingTileProvider : public openspace::TileProvider {
+    public:
+        openspace::Tile getTile(const openspace::ChunkIndex&) override {
+            return openspace::Tile::TileUnavailable;
+        }
+        openspace::Tile getDefaultTile() override {
+            return openspace::Tile::TileUnavailable;
+        }
+        openspace::Tile::Status getTileStatus(const openspace::ChunkIndex&) override {
+            return openspace::Tile::Status::Unavailable;
+        }
+        TileDepthTransform depthTransform() override { return { 1.f, 0.f }; }
+        void update() override { ++nUpdates; }
+        void reset() override {}
+        int maxLevel() override { return 22; }
+
+        int nUpdates = 0;
+    };
+
+    // Creates a group with nLayers providers named "layer<i>" where every other
+    // provider, starting with the first, is active
+    static openspace::TileProviderGroup createGroup(int nLayers) {
+        openspace::TileProviderGroup group;
+        for (int i = 0; i < nLayers; ++i) {
+            group.addTileProvider({
+                "layer" + std::to_string(i),
+                std::make_shared<CountingTileProvider>(),
+                i % 2 == 0
+            });
+        }
+        return group;
+    }
+
+    // Returns the names of the active providers in the order they are returned by the
+    // cached active list
+    static std::vector<std::string> activeNames(const openspace::TileProviderGroup& g) {
+        std::vector<std::string> names;
+        for (openspace::TileProvider* provider : g.getActiveTileProviders()) {
+            for (const openspace::NamedTileProvider& p : g.tileProviders) {
+                if (p.tileProvider.get() == provider) {
+                    names.push_back(p.name);
+                }
+            }
+        }
+        return names;
+    }
+
+    static int nUpdates(const openspace::NamedTileProvider& provider) {
+        return static_cast<CountingTileProvider*>(provider.tileProvider.get())->nUpdates;
+    }
+};
+
+TEST_F(TileProviderManagerTest, ActiveProviders) {
+    openspace::TileProviderGroup group = createGroup(6);
+    std::vector<std::string> expected = { "layer0", "layer2", "layer4" };
+    EXPECT_EQ(expected, activeNames(group));
+
+    group.update();
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(i % 2 == 0 ? 1 : 0, nUpdates(group.tileProviders[i])) << i;
+    }
+}
+
+TEST_F(TileProviderManagerTest, ToggledProvidersAreDetectedOnUpdate) {
+    openspace::TileProviderGroup group = createGroup(6);
+    const std::vector<openspace::TileProvider*>* active =
+        &group.getActiveTileProviders();
+
+    group.tileProviders[1].isActive = true;
+    group.tileProviders[4].isActive = false;
+    std::vector<std::string> expected = { "layer0", "layer2", "layer4" };
+    EXPECT_EQ(expected, activeNames(group)) << "Flags are only read in update";
+
+    group.update();
+    expected = { "layer0", "layer1", "layer2" };
+    EXPECT_EQ(expected, activeNames(group));
+    EXPECT_EQ(active, &group.getActiveTileProviders()) << "List must be reused";
+    EXPECT_EQ(1, nUpdates(group.tileProviders[1]));
+    EXPECT_EQ(0, nUpdates(group.tileProviders[4]));
+}
+
+TEST_F(TileProviderManagerTest, AddRemoveProviders) {
+    openspace::TileProviderGroup group = createGroup(4);
+    unsigned int version = group.layerSetVersion();
+
+    group.addTileProvider({ "added", std::make_shared<CountingTileProvider>(), true });
+    EXPECT_NE(version, group.layerSetVersion());
+    std::vector<std::string> expected = { "layer0", "layer2", "added" };
+    EXPECT_EQ(expected, activeNames(group));
+
+    version = group.layerSetVersion();
+    EXPECT_TRUE(group.removeTileProvider("layer2"));
+    EXPECT_NE(version, group.layerSetVersion());
+    expected = { "layer0", "added" };
+    EXPECT_EQ(expected, activeNames(group));
+
+    version = group.layerSetVersion();
+    EXPECT_FALSE(group.removeTileProvider("layer2"));
+    EXPECT_EQ(version, group.layerSetVersion());
+    EXPECT_EQ(4u, group.tileProviders.size());
+}
+
+TEST_F(TileProviderManagerTest, MoveProviders) {
+    openspace::TileProviderGroup group = createGroup(6);
+    unsigned int version = group.layerSetVersion();
+
+    EXPECT_TRUE(group.moveTileProvider("layer4", 0));
+    EXPECT_NE(version, group.layerSetVersion());
+    std::vector<std::string> expected = { "layer4", "layer0", "layer2" };
+    EXPECT_EQ(expected, activeNames(group));
+
+    EXPECT_TRUE(group.moveTileProvider("layer4", 3));
+    expected = { "layer0", "layer2", "layer4" };
+    EXPECT_EQ(expected, activeNames(group));
+    EXPECT_EQ("layer4", group.tileProviders[3].name);
+
+    EXPECT_TRUE(group.moveTileProvider("layer0", 100));
+    expected = { "layer2", "layer4", "layer0" };
+    EXPECT_EQ(expected, activeNames(group));
+    EXPECT_EQ("layer0", group.tileProviders.back().name);
+
+    version = group.layerSetVersion();
+    EXPECT_FALSE(group.moveTileProvider("missing", 0));
+    EXPECT_EQ(version, group.layerSetVersion());
+}
+
+TEST_F(TileProviderManagerTest, LimitsActiveProviders) {
+    using openspace::LayeredTextures;
+    openspace::TileProviderGroup group = createGroup(10);
+    std::vector<std::string> expected = {
+        "layer0", "layer2", "layer4", "layer6", "layer8"
+    };
+    ASSERT_EQ(LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY, expected.size());
+    EXPECT_EQ(expected, activeNames(group));
+
+    unsigned int version = group.layerSetVersion();
+    EXPECT_FALSE(group.addTileProvider({
+        "active", std::make_shared<CountingTileProvider>(), true
+    }));
+    EXPECT_EQ(version, group.layerSetVersion());
+    EXPECT_TRUE(group.addTileProvider({
+        "inactive", std::make_shared<CountingTileProvider>(), false
+    }));
+    EXPECT_EQ(11u, group.tileProviders.size());
+    EXPECT_EQ(expected, activeNames(group));
+
+    // Enabling a provider past the maximum disables it again
+    version = group.layerSetVersion();
+    group.tileProviders[9].isActive = true;
+    group.update();
+    EXPECT_FALSE(group.tileProviders[9].isActive);
+    EXPECT_NE(version, group.layerSetVersion()) << "The interface must be updated";
+    EXPECT_EQ(expected, activeNames(group));
+    EXPECT_EQ(0, nUpdates(group.tileProviders[9]));
+
+    // Enabled providers are kept if another one is disabled at the same time
+    group.tileProviders[0].isActive = false;
+    group.tileProviders[1].isActive = true;
+    group.update();
+    expected = { "layer1", "layer2", "layer4", "layer6", "layer8" };
+    EXPECT_EQ(expected, activeNames(group));
+
+    // Moving providers reorders the active list but never grows it
+    EXPECT_TRUE(group.moveTileProvider("layer8", 0));
+    expected = { "layer8", "layer1", "layer2", "layer4", "layer6" };
+    EXPECT_EQ(expected, activeNames(group));
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(TileProviderManagerTest, TimingTest) {
+    std::ofstream logFile("TileProviderManagerTest.timing");
+    openspace::TileProviderGroup group = createGroup(
+        2 * openspace::LayeredTextures::MAX_NUM_TEXTURES_PER_CATEGORY
+    );
+    const openspace::ChunkIndex index = { 0, 0, 10 };
+    // Roughly the number of chunks that are rendered or evaluated in a frame
+    const int nChunks = 2000;
+    int nAvailable = 0;
+
+    // The previous implementation built a new list of owning pointers on every access
+    START_TIMER_NO_RESET(perCallList, logFile, 100);
+    for (int i = 0; i < nChunks; ++i) {
+        std::vector<std::shared_ptr<openspace::TileProvider>> activeTileProviders;
+        for (auto tileProviderWithName : group.tileProviders) {
+            if (tileProviderWithName.isActive) {
+                activeTileProviders.push_back(tileProviderWithName.tileProvider);
+            }
+        }
+        for (auto tileProvider : activeTileProviders) {
+            nAvailable += tileProvider->getTileStatus(index) ==
+                openspace::Tile::Status::OK;
+        }
+    }
+    FINISH_TIMER(perCallList, logFile);
+
+    START_TIMER_NO_RESET(cachedList, logFile, 100);
+    group.update();
+    for (int i = 0; i < nChunks; ++i) {
+        for (openspace::TileProvider* tileProvider : group.getActiveTileProviders()) {
+            nAvailable += tileProvider->getTileStatus(index) ==
+                openspace::Tile::Status::OK;
+        }
+    }
+    FINISH_TIMER(cachedList, logFile);
+
+    EXPECT_EQ(0, nAvailable);
+}
+
+#endif // GHL_TIMING_TESTS
@@ -0,0 +1,158 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/multiresvolume/rendering/tsp.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+
+class TSPTest : public testing::Test {
+protected:
+    // Writes a TSP file with cubic bricks that each contain a single value given by
+    // brickValue(bstNode, otNode)
+    static void writeTsp(const std::string& filename, unsigned int numTimesteps,
+                         unsigned int numBricksPerAxis, unsigned int brickDim,
+                         std::function<float(unsigned int, unsigned int)> brickValue)
+    {
+        openspace::TSP::Header header = {
+            0,
+            numTimesteps,
+            numTimesteps,
+            brickDim, brickDim, brickDim,
+            numBricksPerAxis, numBricksPerAxis, numBricksPerAxis
+        };
+
+        unsigned int numOTNodes = 0;
+        for (unsigned int n = 1; n <= numBricksPerAxis; n *= 2) {
+            numOTNodes += n * n * n;
+        }
+        const unsigned int numBSTNodes = 2 * numTimesteps - 1;
+        const unsigned int paddedDim = brickDim + 2;
+
+        std::ofstream file(filename, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<char*>(&header), sizeof(header));
+        std::vector<float> brick(paddedDim * paddedDim * paddedDim);
+        for (unsigned int bst = 0; bst < numBSTNodes; ++bst) {
+            for (unsigned int ot = 0; ot < numOTNodes; ++ot) {
+                std::fill(brick.begin(), brick.end(), brickValue(bst, ot));
+                file.write(
+                    reinterpret_cast<char*>(brick.data()),
+                    brick.size() * sizeof(float)
+                );
+            }
+        }
+    }
+};
+
+TEST_F(TSPTest, KnownErrors) {
+    // Two timesteps and 2x2x2 bricks: 3 BST nodes with 9 octree nodes each. The octree
+    // leaves of the two timesteps hold 0..7 and 2..9, all parents hold the averages
+    const std::string filename = absPath("${TEMPORARY}/tsptest_known.tsp");
+    writeTsp(filename, 2, 2, 2, [](unsigned int bst, unsigned int ot) {
+        const float bstAverage[] = { 1.f, 0.f, 2.f };
+        const float otAverage = 3.5f;
+        return (ot == 0 ? otAverage : static_cast<float>(ot - 1)) + bstAverage[bst];
+    });
+
+    openspace::TSP tsp(filename);
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+    ASSERT_EQ(27, tsp.numTotalNodes());
+    ASSERT_TRUE(tsp.calculateSpatialError());
+    ASSERT_TRUE(tsp.calculateTemporalError());
+
+    // The leaves of 0..7 have a standard deviation of sqrt(5.25) around their average,
+    // which is normalized with another square root
+    const float rootSpatialError = std::pow(5.25f, 0.25f);
+    for (unsigned int brick = 0; brick < tsp.numTotalNodes(); ++brick) {
+        const bool isOctreeRoot = (brick % tsp.numOTNodes()) == 0;
+        EXPECT_FLOAT_EQ(isOctreeRoot ? rootSpatialError : -0.1f,
+            tsp.getSpatialError(brick)) << "Brick " << brick;
+
+        // Every voxel of the two timesteps is one unit away from their average
+        const bool isBstRoot = brick < tsp.numOTNodes();
+        EXPECT_FLOAT_EQ(isBstRoot ? 1.f : -0.1f,
+            tsp.getTemporalError(brick)) << "Brick " << brick;
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST_F(TSPTest, ErrorsOfDeeperTree) {
+    const std::string filename = absPath("${TEMPORARY}/tsptest_deeper.tsp");
+    writeTsp(filename, 4, 4, 4, [](unsigned int bst, unsigned int ot) {
+        return static_cast<float>((bst * 7919 + ot * 104729) % 1000) / 100.f;
+    });
+
+    openspace::TSP tsp(filename);
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+    ASSERT_TRUE(tsp.calculateSpatialError());
+    ASSERT_TRUE(tsp.calculateTemporalError());
+
+    for (unsigned int brick = 0; brick < tsp.numTotalNodes(); ++brick) {
+        // Leaves are marked with -0.1, all other errors are non-negative
+        const float spatial = tsp.getSpatialError(brick);
+        EXPECT_TRUE(spatial == -0.1f || spatial >= 0.f) << "Brick " << brick;
+
+        if (tsp.isBstLeaf(brick)) {
+            EXPECT_FLOAT_EQ(-0.1f, tsp.getTemporalError(brick));
+        }
+        else {
+            EXPECT_GE(tsp.getTemporalError(brick), 0.f);
+        }
+    }
+
+    std::remove(filename.c_str());
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(TSPTest, TimingTest) {
+    std::ofstream logFile("TSPTest.timing");
+    const std::string filename = absPath("${TEMPORARY}/tsptest_timing.tsp");
+    writeTsp(filename, 16, 4, 8, [](unsigned int bst, unsigned int ot) {
+        return static_cast<float>((bst * 7919 + ot * 104729) % 1000) / 100.f;
+    });
+
+    openspace::TSP tsp(filename);
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+
+    START_TIMER_NO_RESET(errorCalculation, logFile, 5);
+    ASSERT_TRUE(tsp.calculateSpatialError());
+    ASSERT_TRUE(tsp.calculateTemporalError());
+    FINISH_TIMER(errorCalculation, logFile);
+
+    std::remove(filename.c_str());
+}
+
+#endif // GHL_TIMING_TESTS